@@ -114,45 +114,20 @@ void AnimatedMeshComponent::update(const world::UpdateParams& update)
 	m_poseTransforms[0].resize(skinJointCount, Transform::identity());
 	m_poseTransforms[1].resize(skinJointCount, Transform::identity());
 
-	// Calculate skinning transforms.
-	if (m_skeletonComponent != nullptr && m_skeletonComponent->getSkeleton() && m_skeletonComponent->getRevision() != m_revision)
-	{
-		// Ensure all transforms are calculated.
+	// Skeletons are updated in an earlier phase thus the first skin picking up its pose
+	// evaluates all pending skeletons together.
+	if (m_skeletonComponent != nullptr)
 		m_skeletonComponent->synchronize();
-
-		const auto& jointTransforms = m_skeletonComponent->getJointTransforms();
-		const auto& poseTransforms = m_skeletonComponent->getPoseTransforms();
-
-		const bool firstPose = bool(m_revision < 0);
-
-		// Step to the other slot before writing; m_index always refer to the most
-		// recent pose and 1 - m_index to the pose of the previous update.
-		m_index = 1 - m_index;
-
-		if (!poseTransforms.empty())
-		{
-			const size_t skeletonJointCount = jointTransforms.size();
-			const size_t skinJointCount = m_mesh->getJointCount();
-			for (size_t i = 0; i < skeletonJointCount; ++i)
-			{
-				const int32_t jointIndex = m_jointRemap[i];
-				if (jointIndex >= 0 && jointIndex < int32_t(skinJointCount))
-					m_poseTransforms[m_index][jointIndex] = poseTransforms[i];
-			}
-
-			// No previous pose to interpolate from on our first update; use the
-			// same pose for both slots so we don't blend out from the bind pose.
-			if (firstPose)
-				m_poseTransforms[1 - m_index] = m_poseTransforms[m_index];
-		}
-
-		m_revision = m_skeletonComponent->getRevision();
-		m_skinModified = true;
-	}
+	updatePoseTransforms();
 
 	mesh::SkinnedMeshComponent::update(update);
 }
 
+world::UpdatePhase AnimatedMeshComponent::getUpdatePhase() const
+{
+	return world::UpdatePhase::Late;
+}
+
 void AnimatedMeshComponent::setupSkin(const world::WorldRenderView& worldRenderView, render::RenderContext* renderContext, int32_t lodRank)
 {
 	// Reset here; the base setupSkin sets it when we actually (re)build the skin, and the
@@ -283,6 +258,42 @@ void AnimatedMeshComponent::build(const world::WorldBuildContext& context, const
 			getParameterCallback());
 }
 
+void AnimatedMeshComponent::updatePoseTransforms()
+{
+	// Calculate skinning transforms.
+	if (m_skeletonComponent != nullptr && m_skeletonComponent->getSkeleton() && m_skeletonComponent->getRevision() != m_revision)
+	{
+		const auto& jointTransforms = m_skeletonComponent->getJointTransforms();
+		const auto& poseTransforms = m_skeletonComponent->getPoseTransforms();
+
+		const bool firstPose = bool(m_revision < 0);
+
+		// Step to the other slot before writing; m_index always refer to the most
+		// recent pose and 1 - m_index to the pose of the previous update.
+		m_index = 1 - m_index;
+
+		if (!poseTransforms.empty())
+		{
+			const size_t skeletonJointCount = jointTransforms.size();
+			const size_t skinJointCount = m_mesh->getJointCount();
+			for (size_t i = 0; i < skeletonJointCount; ++i)
+			{
+				const int32_t jointIndex = m_jointRemap[i];
+				if (jointIndex >= 0 && jointIndex < int32_t(skinJointCount))
+					m_poseTransforms[m_index][jointIndex] = poseTransforms[i];
+			}
+
+			// No previous pose to interpolate from on our first update; use the
+			// same pose for both slots so we don't blend out from the bind pose.
+			if (firstPose)
+				m_poseTransforms[1 - m_index] = m_poseTransforms[m_index];
+		}
+
+		m_revision = m_skeletonComponent->getRevision();
+		m_skinModified = true;
+	}
+}
+
 bool AnimatedMeshComponent::getSkinTransform(render::handle_t jointName, Transform& outTransform) const
 {
 	if (!m_skeletonComponent)
@@ -50,6 +50,8 @@ public:
 
 	virtual void update(const world::UpdateParams& update) override final;
 
+	virtual world::UpdatePhase getUpdatePhase() const override final;
+
 	virtual void setupSkin(const world::WorldRenderView& worldRenderView, render::RenderContext* renderContext, int32_t lodRank) override final;
 
 	virtual void build(const world::WorldBuildContext& context, const world::WorldRenderView& worldRenderView, const world::IWorldRenderPass& worldRenderPass) override final;
@@ -78,6 +80,8 @@ private:
 	bool m_visibleLastFrame = true;
 	int32_t m_updatePeriod = 1;
 	float m_lastDistance = std::numeric_limits< float >::max();
+
+	void updatePoseTransforms();
 };
 
 }
@@ -7,17 +7,19 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Animation/Animation/Animation.h"
+#include "Animation/Animation/CompressedClip.h"
 #include "Animation/SkeletonUtils.h"
 #include "Core/Math/Hermite.h"
 #include "Core/Serialization/AttributeRange.h"
 #include "Core/Serialization/ISerializer.h"
 #include "Core/Serialization/MemberAlignedVector.h"
 #include "Core/Serialization/MemberComposite.h"
+#include "Core/Serialization/MemberRef.h"
 
 namespace traktor::animation
 {
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.Animation", 0, Animation, ISerializable)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.Animation", 1, Animation, ISerializable)
 
 uint32_t Animation::addKeyPose(const KeyPose& pose)
 {
@@ -43,7 +45,7 @@ void Animation::removeKeyPose(uint32_t poseIndex)
 
 bool Animation::empty() const
 {
-	return m_poses.empty();
+	return m_poses.empty() && m_clip == nullptr;
 }
 
 uint32_t Animation::getKeyPoseCount() const
@@ -69,8 +71,39 @@ const Animation::KeyPose& Animation::getLastKeyPose() const
 	return m_poses.back();
 }
 
+float Animation::getStartTime() const
+{
+	if (m_clip)
+		return m_clip->getStartTime();
+	return !m_poses.empty() ? m_poses.front().at : 0.0f;
+}
+
+float Animation::getEndTime() const
+{
+	if (m_clip)
+		return m_clip->getEndTime();
+	return !m_poses.empty() ? m_poses.back().at : 0.0f;
+}
+
+bool Animation::compress(float translationTolerance, float rotationTolerance)
+{
+	Ref< CompressedClip > clip = CompressedClip::compress(this, translationTolerance, rotationTolerance);
+	if (!clip)
+		return false;
+
+	m_clip = clip;
+	m_poses.clear();
+	return true;
+}
+
 bool Animation::getPose(float at, Pose& outPose) const
 {
+	if (m_clip)
+	{
+		m_clip->evaluate(at, outPose);
+		return true;
+	}
+
 	const size_t nposes = m_poses.size();
 	if (nposes > 2)
 	{
@@ -140,6 +173,9 @@ void Animation::serialize(ISerializer& s)
 	s >> MemberAlignedVector< KeyPose, MemberComposite< KeyPose > >(L"poses", m_poses);
 	s >> Member< float >(L"timePerDistance", m_timePerDistance);
 	s >> Member< Vector4 >(L"totalLocomotion", m_totalLocomotion);
+
+	if (s.getVersion< Animation >() >= 1)
+		s >> MemberRef< CompressedClip >(L"clip", m_clip);
 }
 
 void Animation::KeyPose::serialize(ISerializer& s)
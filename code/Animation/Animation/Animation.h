@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Animation/Pose.h"
+#include "Core/Ref.h"
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Serialization/ISerializable.h"
 
@@ -23,8 +24,14 @@
 namespace traktor::animation
 {
 
+class CompressedClip;
+
 /*! Key framed animation poses.
  * \ingroup Animation
+ *
+ * Animations built by the pipeline are normally compressed;
+ * key poses are then replaced by a compressed clip which
+ * is sampled directly.
  */
 class T_DLLCLASS Animation : public ISerializable
 {
@@ -92,6 +99,31 @@ public:
 	 */
 	bool getPose(float at, Pose& outPose) const;
 
+	/*! Get time of first key.
+	 *
+	 * \return Time of first key.
+	 */
+	float getStartTime() const;
+
+	/*! Get time of last key.
+	 *
+	 * \return Time of last key.
+	 */
+	float getEndTime() const;
+
+	/*! Compress key poses.
+	 *
+	 * Key poses are replaced by a compressed clip.
+	 *
+	 * \param translationTolerance Max translation error, in world units.
+	 * \param rotationTolerance Max rotation error, in radians.
+	 * \return True if animation was compressed.
+	 */
+	bool compress(float translationTolerance, float rotationTolerance);
+
+	/*! Get compressed clip, null if animation isn't compressed. */
+	const CompressedClip* getCompressedClip() const { return m_clip; }
+
 	/*!
 	 */
 	void setTimePerDistance(float timePerDistance) { m_timePerDistance = timePerDistance; }
@@ -113,6 +145,7 @@ public:
 
 private:
 	AlignedVector< KeyPose > m_poses;
+	Ref< CompressedClip > m_clip;
 	float m_timePerDistance = 0.0f;
 	Vector4 m_totalLocomotion = Vector4::zero();
 };
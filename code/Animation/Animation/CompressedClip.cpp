@@ -0,0 +1,408 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cmath>
+#include "Animation/BitSet.h"
+#include "Animation/Pose.h"
+#include "Animation/Animation/Animation.h"
+#include "Animation/Animation/CompressedClip.h"
+#include "Core/Math/MathConfig.h"
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/MemberComposite.h"
+
+namespace traktor::animation
+{
+	namespace
+	{
+
+const float c_rotationRange = 0.70710678f;	//!< Range of three smallest components, [-1/sqrt(2), 1/sqrt(2)].
+const float c_rotationSteps = 32767.0f;
+const float c_translationSteps = 65535.0f;
+const uint32_t c_maxFrameCount = 65535;
+const uint32_t c_maxStackJoints = 256;
+
+/*! Load four 16-bit words into vector. */
+T_FORCE_INLINE Vector4 loadKey(const uint16_t* key)
+{
+#if defined(T_MATH_USE_SSE2)
+	const __m128i k = _mm_loadl_epi64((const __m128i*)key);
+	return Vector4(_mm_cvtepi32_ps(_mm_unpacklo_epi16(k, _mm_setzero_si128())));
+#else
+	return Vector4(float(key[0]), float(key[1]), float(key[2]), float(key[3]));
+#endif
+}
+
+T_FORCE_INLINE Quaternion decodeRotation(const uint16_t* key)
+{
+	const static Vector4 c_scale(2.0f * c_rotationRange / c_rotationSteps, 2.0f * c_rotationRange / c_rotationSteps, 2.0f * c_rotationRange / c_rotationSteps, 0.0f);
+	const static Vector4 c_bias(-c_rotationRange, -c_rotationRange, -c_rotationRange, 0.0f);
+
+	// Reconstruct largest component from unit length, placed in w.
+	Vector4 v = loadKey(key) * c_scale + c_bias;
+	const Scalar d = squareRoot(max(1.0_simd - dot3(v, v), 0.0_simd));
+	v += Vector4(0.0f, 0.0f, 0.0f, 1.0f) * d;
+
+	switch (key[3])
+	{
+	case 0:
+		return Quaternion(v.shuffle< 3, 0, 1, 2 >());
+	case 1:
+		return Quaternion(v.shuffle< 0, 3, 1, 2 >());
+	case 2:
+		return Quaternion(v.shuffle< 0, 1, 3, 2 >());
+	default:
+		return Quaternion(v);
+	}
+}
+
+void encodeRotation(const Quaternion& rotation, uint16_t* outKey)
+{
+	float T_MATH_ALIGN16 e[4];
+	rotation.normalized().e.storeAligned(e);
+
+	int32_t largest = 0;
+	for (int32_t i = 1; i < 4; ++i)
+	{
+		if (std::abs(e[i]) > std::abs(e[largest]))
+			largest = i;
+	}
+
+	// Largest component is implicitly positive; q and -q represent same rotation.
+	const float sign = (e[largest] < 0.0f) ? -1.0f : 1.0f;
+	for (int32_t i = 0, j = 0; i < 4; ++i)
+	{
+		if (i == largest)
+			continue;
+		const float v = clamp(sign * e[i] / c_rotationRange, -1.0f, 1.0f);
+		outKey[j++] = (uint16_t)std::lround((v * 0.5f + 0.5f) * c_rotationSteps);
+	}
+	outKey[3] = (uint16_t)largest;
+}
+
+T_FORCE_INLINE Vector4 decodeTranslation(const uint16_t* key, const Vector4& translationMin, const Vector4& translationRange)
+{
+	return translationMin + loadKey(key) * translationRange;
+}
+
+void encodeTranslation(const Vector4& translation, const Vector4& translationMin, const Vector4& translationRange, uint16_t* outKey)
+{
+	float T_MATH_ALIGN16 t[4], mn[4], rn[4];
+	translation.storeAligned(t);
+	translationMin.storeAligned(mn);
+	translationRange.storeAligned(rn);
+
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		const float v = (rn[i] > 0.0f) ? (t[i] - mn[i]) / rn[i] : 0.0f;
+		outKey[i] = (uint16_t)clamp< long >(std::lround(v), 0, 65535);
+	}
+	outKey[3] = 0;
+}
+
+/*! Interpolate rotations, same as sampler does at runtime. */
+T_FORCE_INLINE Quaternion interpolateRotation(const Quaternion& q0, const Quaternion& q1, const Scalar& k)
+{
+	// Quaternions double cover rotations; interpolate towards nearest.
+	const Vector4 e1 = (dot4(q0.e, q1.e) >= 0.0_simd) ? q1.e : -q1.e;
+	return Quaternion(lerp(q0.e, e1, k)).normalized();
+}
+
+/*! Angle of rotation between quaternions.
+ *
+ * Measured from chord length since acos of dot product
+ * is too imprecise for small angles.
+ */
+float rotationError(const Quaternion& a, const Quaternion& b)
+{
+	const Vector4 eb = (dot4(a.e, b.e) >= 0.0_simd) ? b.e : -b.e;
+	const float c = std::min((float)(a.e - eb).length(), 2.0f);
+	return 4.0f * std::asin(c * 0.5f);
+}
+
+float translationError(const Vector4& a, const Vector4& b)
+{
+	return (a - b).absolute().max();
+}
+
+/*! Select keys which, interpolated, reconstruct all frames within tolerance.
+ *
+ * Keys are greedily extended from previous key as long as
+ * all frames in between are within tolerance.
+ */
+template < typename ValueType, typename InterpolateFn, typename ErrorFn >
+void selectKeys(
+	const AlignedVector< float >& times,
+	const AlignedVector< ValueType >& original,
+	const AlignedVector< ValueType >& decoded,
+	float tolerance,
+	const InterpolateFn& interpolate,
+	const ErrorFn& error,
+	AlignedVector< uint16_t >& outFrames
+)
+{
+	const uint32_t frameCount = (uint32_t)original.size();
+
+	// Constant track; single key is enough.
+	bool constant = true;
+	for (uint32_t i = 0; i < frameCount && constant; ++i)
+		constant &= (error(original[i], decoded[0]) <= tolerance);
+	if (constant)
+	{
+		outFrames.push_back(0);
+		return;
+	}
+
+	auto fits = [&](uint32_t a, uint32_t b) {
+		const float ta = times[a];
+		const float tb = times[b];
+		for (uint32_t i = a + 1; i < b; ++i)
+		{
+			const Scalar k((times[i] - ta) / (tb - ta));
+			if (error(original[i], interpolate(decoded[a], decoded[b], k)) > tolerance)
+				return false;
+		}
+		return true;
+	};
+
+	uint32_t a = 0;
+	outFrames.push_back(0);
+	while (a < frameCount - 1)
+	{
+		uint32_t b = a + 1;
+		while (b + 1 < frameCount && fits(a, b + 1))
+			++b;
+		outFrames.push_back((uint16_t)b);
+		a = b;
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.CompressedClip", 0, CompressedClip, ISerializable)
+
+Ref< CompressedClip > CompressedClip::compress(const Animation* animation, float translationTolerance, float rotationTolerance)
+{
+	const uint32_t frameCount = animation->getKeyPoseCount();
+	if (frameCount == 0 || frameCount > c_maxFrameCount)
+		return nullptr;
+
+	// Determine which joints are animated.
+	BitSet indices;
+	for (uint32_t i = 0; i < frameCount; ++i)
+		animation->getKeyPose(i).pose.getIndexMask(indices);
+
+	int32_t minIndex, maxIndex;
+	indices.range(minIndex, maxIndex);
+	const uint32_t jointCount = (uint32_t)std::max(maxIndex, 0);
+
+	Ref< CompressedClip > clip = new CompressedClip();
+	clip->m_tracks.resize(jointCount);
+	for (uint32_t i = 0; i < frameCount; ++i)
+		clip->m_times.push_back(animation->getKeyPose(i).at);
+
+	AlignedVector< Quaternion > rotations(frameCount), decodedRotations(frameCount);
+	AlignedVector< Vector4 > translations(frameCount), decodedTranslations(frameCount);
+	AlignedVector< uint16_t > rotationKeys(frameCount * 4), translationKeys(frameCount * 4);
+	AlignedVector< uint16_t > frames;
+
+	for (uint32_t joint = 0; joint < jointCount; ++joint)
+	{
+		if (!indices(joint))
+			continue;
+
+		Track& track = clip->m_tracks[joint];
+
+		for (uint32_t i = 0; i < frameCount; ++i)
+		{
+			const Transform T = animation->getKeyPose(i).pose.getJointTransform(joint);
+			rotations[i] = T.rotation().normalized();
+			translations[i] = T.translation().xyz0();
+		}
+
+		// Rotation track.
+		for (uint32_t i = 0; i < frameCount; ++i)
+		{
+			encodeRotation(rotations[i], &rotationKeys[i * 4]);
+			decodedRotations[i] = decodeRotation(&rotationKeys[i * 4]);
+		}
+
+		frames.resize(0);
+		selectKeys(clip->m_times, rotations, decodedRotations, rotationTolerance, interpolateRotation, rotationError, frames);
+
+		track.rotationOffset = (uint32_t)clip->m_rotationFrames.size();
+		track.rotationCount = (uint32_t)frames.size();
+		for (auto frame : frames)
+		{
+			clip->m_rotationFrames.push_back(frame);
+			clip->m_rotationKeys.insert(clip->m_rotationKeys.end(), &rotationKeys[frame * 4], &rotationKeys[frame * 4] + 4);
+		}
+
+		// Translation track; quantized within range of track.
+		Vector4 translationMin = translations[0];
+		Vector4 translationMax = translations[0];
+		for (uint32_t i = 1; i < frameCount; ++i)
+		{
+			translationMin = min(translationMin, translations[i]);
+			translationMax = max(translationMax, translations[i]);
+		}
+
+		track.translationMin = translationMin.xyz0();
+		track.translationRange = ((translationMax - translationMin) / Scalar(c_translationSteps)).xyz0();
+
+		for (uint32_t i = 0; i < frameCount; ++i)
+		{
+			encodeTranslation(translations[i], track.translationMin, track.translationRange, &translationKeys[i * 4]);
+			decodedTranslations[i] = decodeTranslation(&translationKeys[i * 4], track.translationMin, track.translationRange);
+		}
+
+		frames.resize(0);
+		selectKeys(clip->m_times, translations, decodedTranslations, translationTolerance, [](const Vector4& a, const Vector4& b, const Scalar& k) { return lerp(a, b, k); }, translationError, frames);
+
+		track.translationOffset = (uint32_t)clip->m_translationFrames.size();
+		track.translationCount = (uint32_t)frames.size();
+		for (auto frame : frames)
+		{
+			clip->m_translationFrames.push_back(frame);
+			clip->m_translationKeys.insert(clip->m_translationKeys.end(), &translationKeys[frame * 4], &translationKeys[frame * 4] + 4);
+		}
+	}
+
+	return clip;
+}
+
+void CompressedClip::evaluate(float at, Transform* outJointTransforms) const
+{
+	const uint32_t frameCount = (uint32_t)m_times.size();
+	if (frameCount == 0)
+	{
+		for (uint32_t i = 0; i < (uint32_t)m_tracks.size(); ++i)
+			outJointTransforms[i] = Transform::identity();
+		return;
+	}
+
+	at = clamp(at, m_times.front(), m_times.back());
+
+	// Find frame once; each track then only need to search it's own keys.
+	const uint32_t frame = (uint32_t)std::max< ptrdiff_t >(std::upper_bound(m_times.begin(), m_times.end(), at) - m_times.begin() - 1, 0);
+
+	for (uint32_t i = 0; i < (uint32_t)m_tracks.size(); ++i)
+	{
+		const Track& track = m_tracks[i];
+		if (track.rotationCount == 0)
+		{
+			outJointTransforms[i] = Transform::identity();
+			continue;
+		}
+
+		Quaternion rotation;
+		{
+			const uint16_t* frames = &m_rotationFrames[track.rotationOffset];
+			const uint16_t* keys = &m_rotationKeys[track.rotationOffset * 4];
+			const uint32_t k0 = findKey(frames, track.rotationCount, frame);
+			const uint32_t k1 = std::min(k0 + 1, track.rotationCount - 1);
+			if (k0 != k1)
+			{
+				const float t0 = m_times[frames[k0]];
+				const float t1 = m_times[frames[k1]];
+				rotation = interpolateRotation(
+					decodeRotation(keys + k0 * 4),
+					decodeRotation(keys + k1 * 4),
+					Scalar((at - t0) / (t1 - t0))
+				);
+			}
+			else
+				rotation = decodeRotation(keys + k0 * 4);
+		}
+
+		Vector4 translation;
+		{
+			const uint16_t* frames = &m_translationFrames[track.translationOffset];
+			const uint16_t* keys = &m_translationKeys[track.translationOffset * 4];
+			const uint32_t k0 = findKey(frames, track.translationCount, frame);
+			const uint32_t k1 = std::min(k0 + 1, track.translationCount - 1);
+			if (k0 != k1)
+			{
+				const float t0 = m_times[frames[k0]];
+				const float t1 = m_times[frames[k1]];
+				translation = lerp(
+					decodeTranslation(keys + k0 * 4, track.translationMin, track.translationRange),
+					decodeTranslation(keys + k1 * 4, track.translationMin, track.translationRange),
+					Scalar((at - t0) / (t1 - t0))
+				);
+			}
+			else
+				translation = decodeTranslation(keys + k0 * 4, track.translationMin, track.translationRange);
+		}
+
+		outJointTransforms[i] = Transform(translation, rotation);
+	}
+}
+
+void CompressedClip::evaluate(float at, Pose& outPose) const
+{
+	const uint32_t jointCount = (uint32_t)m_tracks.size();
+
+	Transform stackTransforms[c_maxStackJoints];
+	AlignedVector< Transform > heapTransforms;
+	Transform* transforms = stackTransforms;
+	if (jointCount > c_maxStackJoints)
+	{
+		heapTransforms.resize(jointCount);
+		transforms = heapTransforms.ptr();
+	}
+
+	evaluate(at, transforms);
+
+	outPose.reset();
+	outPose.reserve(jointCount);
+	for (uint32_t i = 0; i < jointCount; ++i)
+	{
+		if (m_tracks[i].rotationCount > 0)
+			outPose.setJointTransform(i, transforms[i]);
+	}
+}
+
+uint32_t CompressedClip::getDataSize() const
+{
+	return (uint32_t)(
+		m_times.size() * sizeof(float) +
+		m_tracks.size() * sizeof(Track) +
+		(m_rotationFrames.size() + m_rotationKeys.size() + m_translationFrames.size() + m_translationKeys.size()) * sizeof(uint16_t)
+	);
+}
+
+void CompressedClip::serialize(ISerializer& s)
+{
+	s >> MemberAlignedVector< float >(L"times", m_times);
+	s >> MemberAlignedVector< Track, MemberComposite< Track > >(L"tracks", m_tracks);
+	s >> MemberAlignedVector< uint16_t >(L"rotationFrames", m_rotationFrames);
+	s >> MemberAlignedVector< uint16_t >(L"rotationKeys", m_rotationKeys);
+	s >> MemberAlignedVector< uint16_t >(L"translationFrames", m_translationFrames);
+	s >> MemberAlignedVector< uint16_t >(L"translationKeys", m_translationKeys);
+}
+
+uint32_t CompressedClip::findKey(const uint16_t* frames, uint32_t count, uint32_t frame) const
+{
+	// Last key at or before frame.
+	const uint16_t* it = std::upper_bound(frames, frames + count, frame);
+	return (uint32_t)std::max< ptrdiff_t >(it - frames - 1, 0);
+}
+
+void CompressedClip::Track::serialize(ISerializer& s)
+{
+	s >> Member< uint32_t >(L"rotationOffset", rotationOffset);
+	s >> Member< uint32_t >(L"rotationCount", rotationCount);
+	s >> Member< uint32_t >(L"translationOffset", translationOffset);
+	s >> Member< uint32_t >(L"translationCount", translationCount);
+	s >> Member< Vector4 >(L"translationMin", translationMin);
+	s >> Member< Vector4 >(L"translationRange", translationRange);
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Transform.h"
+#include "Core/Serialization/ISerializable.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_ANIMATION_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::animation
+{
+
+class Animation;
+class Pose;
+
+/*! Compressed animation clip.
+ * \ingroup Animation
+ *
+ * Each joint's rotation and translation is stored as a
+ * separate track of quantized keys. Rotations are stored
+ * as the three smallest components in 15 bits each and
+ * translations as 16 bits per component within the
+ * track's range.
+ *
+ * Keys which can be reconstructed, within tolerance,
+ * by interpolating their neighbours are removed and
+ * tracks which doesn't change are reduced to a
+ * single key.
+ */
+class T_DLLCLASS CompressedClip : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	/*! Compress key poses of animation.
+	 *
+	 * \param animation Uncompressed animation.
+	 * \param translationTolerance Max translation error, in world units.
+	 * \param rotationTolerance Max rotation error, in radians.
+	 * \return Compressed clip, null if animation cannot be compressed.
+	 */
+	static Ref< CompressedClip > compress(const Animation* animation, float translationTolerance, float rotationTolerance);
+
+	/*! Sample clip into joint transforms.
+	 *
+	 * \param at Time.
+	 * \param outJointTransforms Joint transforms, must have room for getJointCount transforms.
+	 */
+	void evaluate(float at, Transform* outJointTransforms) const;
+
+	/*! Sample clip into pose.
+	 *
+	 * \param at Time.
+	 * \param outPose Output pose.
+	 */
+	void evaluate(float at, Pose& outPose) const;
+
+	/*! Number of joints in clip. */
+	uint32_t getJointCount() const { return (uint32_t)m_tracks.size(); }
+
+	/*! Time of first key. */
+	float getStartTime() const { return !m_times.empty() ? m_times.front() : 0.0f; }
+
+	/*! Time of last key. */
+	float getEndTime() const { return !m_times.empty() ? m_times.back() : 0.0f; }
+
+	/*! Number of bytes used by keys and tracks. */
+	uint32_t getDataSize() const;
+
+	virtual void serialize(ISerializer& s) override final;
+
+private:
+	struct Track
+	{
+		uint32_t rotationOffset = 0;	//!< First key in rotation keys.
+		uint32_t rotationCount = 0;		//!< Number of rotation keys, zero if joint isn't animated.
+		uint32_t translationOffset = 0;
+		uint32_t translationCount = 0;
+		Vector4 translationMin = Vector4::zero();
+		Vector4 translationRange = Vector4::zero();
+
+		void serialize(ISerializer& s);
+	};
+
+	AlignedVector< float > m_times;
+	AlignedVector< Track > m_tracks;
+	AlignedVector< uint16_t > m_rotationFrames;
+	AlignedVector< uint16_t > m_rotationKeys;	//!< Four words per key.
+	AlignedVector< uint16_t > m_translationFrames;
+	AlignedVector< uint16_t > m_translationKeys;	//!< Four words per key.
+
+	uint32_t findKey(const uint16_t* frames, uint32_t count, uint32_t frame) const;
+};
+
+}
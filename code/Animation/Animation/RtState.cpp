@@ -34,11 +34,10 @@ bool RtState::prepare(StateContext& outContext) const
 {
 	if (m_animation)
 	{
-		const uint32_t poseCount = m_animation->getKeyPoseCount();
-		if (poseCount < 1)
+		if (m_animation->empty())
 			return false;
 
-		const float duration = m_animation->getKeyPose(poseCount - 1).at;
+		const float duration = m_animation->getEndTime();
 
 		outContext.setTime(0.0f);
 		outContext.setDuration(duration);
@@ -35,7 +35,7 @@ SimpleAnimationController::SimpleAnimationController(
 	, m_transformTime(transformTime)
 	, m_lastTime(std::numeric_limits< float >::max())
 {
-	m_timeOffset = s_random.nextFloat() * m_animation->getLastKeyPose().at;
+	m_timeOffset = s_random.nextFloat() * m_animation->getEndTime();
 }
 
 void SimpleAnimationController::destroy()
@@ -65,7 +65,7 @@ bool SimpleAnimationController::evaluate(
 		m_transformTime->calculateTime(m_animation, worldTransform, time, deltaTime);
 
 	// Calculate pose from animation.
-	const float poseTime = std::fmod(m_timeOffset + time, m_animation->getLastKeyPose().at);
+	const float poseTime = std::fmod(m_timeOffset + time, m_animation->getEndTime());
 
 	m_animation->getPose(poseTime, m_evaluationPose);
 	calculatePoseTransforms(
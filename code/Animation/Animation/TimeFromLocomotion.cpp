@@ -34,7 +34,7 @@ void TimeFromLocomotion::calculateTime(const Animation* animation, const Transfo
 	m_time += outDeltaTime;
 
 	// Ensure time is always positive.
-	const float duration = animation->getLastKeyPose().at - animation->getKeyPose(0).at;
+	const float duration = animation->getEndTime() - animation->getStartTime();
 	if (duration > 0.0f)
 	{
 		while (m_time < 0.0f)
@@ -23,7 +23,13 @@ class BitSet
 public:
 	T_FORCE_INLINE BitSet()
 	{
-		for (int i = 0; i < sizeof_array(m_bits); ++i)
+		for (int i = 0; i < (int)sizeof_array(m_bits); ++i)
+			m_bits[i] = 0x00000000;
+	}
+
+	T_FORCE_INLINE void clear()
+	{
+		for (int i = 0; i < (int)sizeof_array(m_bits); ++i)
 			m_bits[i] = 0x00000000;
 	}
 
@@ -34,7 +40,7 @@ public:
 
 	T_FORCE_INLINE void insert(const BitSet& set)
 	{
-		for (int i = 0; i < sizeof_array(m_bits); ++i)
+		for (int i = 0; i < (int)sizeof_array(m_bits); ++i)
 			m_bits[i] |= set.m_bits[i];
 	}
 
@@ -43,7 +49,7 @@ public:
 		outMin = 0;
 		outMax = sizeof_array(m_bits) * 32;
 
-		for (int i = 0; i < sizeof_array(m_bits); ++i)
+		for (int i = 0; i < (int)sizeof_array(m_bits); ++i)
 		{
 			if (m_bits[i])
 			{
@@ -126,6 +132,25 @@ public:
 		}
 	}
 
+	/*! Call function with index of each set bit, in increasing order.
+	 *
+	 * Iteration of each word stops at it's highest set bit thus
+	 * iterating sparse sets is cheap.
+	 */
+	template < typename FunctionType >
+	T_FORCE_INLINE void forEach(const FunctionType& fn) const
+	{
+		for (int i = 0; i < (int)sizeof_array(m_bits); ++i)
+		{
+			uint32_t bits = m_bits[i];
+			for (int j = 0; bits != 0; ++j, bits >>= 1)
+			{
+				if (bits & 1)
+					fn((i << 5) + j);
+			}
+		}
+	}
+
 	T_FORCE_INLINE bool operator () (int index) const
 	{
 		return (m_bits[index >> 5] & (1 << (index & 31))) != 0;
@@ -18,7 +18,7 @@
 namespace traktor::animation
 {
 
-T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.animation.AnimationAsset", 10, AnimationAsset, editor::Asset)
+T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.animation.AnimationAsset", 11, AnimationAsset, editor::Asset)
 
 void AnimationAsset::serialize(ISerializer& s)
 {
@@ -53,6 +53,9 @@ void AnimationAsset::serialize(ISerializer& s)
 
 	if (s.getVersion() >= 9)
 		s >> Member< float >(L"maxDuration", m_maxDuration, AttributeRange(0.0f) | AttributeUnit(UnitType::Seconds));
+
+	if (s.getVersion() >= 11)
+		s >> Member< bool >(L"compress", m_compress);
 }
 
 }
@@ -49,6 +49,8 @@ public:
 
 	float getMaxDuration() const { return m_maxDuration; }
 
+	bool getCompress() const { return m_compress; }
+
 private:
 	Guid m_targetSkeleton;					//!< Target skeleton onto animation are retargeted; if no skeleton provided then assuming to be same as animation skeleton.
 	std::wstring m_take = L"";
@@ -57,6 +59,7 @@ private:
 	bool m_removeLocomotion = true;
 	std::wstring m_removeLocomotionJoint = L"";
 	float m_maxDuration = 0.0f;				//!< Cut animation at this many seconds from its first key frame; 0 keeps the entire take.
+	bool m_compress = true;					//!< Compress key poses into quantized tracks.
 };
 
 }
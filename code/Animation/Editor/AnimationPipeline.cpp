@@ -11,6 +11,7 @@
 #include "Animation/Skeleton.h"
 #include "Animation/SkeletonUtils.h"
 #include "Animation/Animation/Animation.h"
+#include "Animation/Animation/CompressedClip.h"
 #include "Animation/Editor/AnimationAsset.h"
 #include "Animation/Editor/AnimationPipeline.h"
 #include "Animation/Editor/SkeletonAsset.h"
@@ -33,8 +34,15 @@
 
 namespace traktor::animation
 {
+	namespace
+	{
+
+const float c_compressTranslationTolerance = 0.0005f;
+const float c_compressRotationTolerance = 0.0005f;
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.AnimationPipeline", 18, AnimationPipeline, editor::IPipeline)
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.AnimationPipeline", 19, AnimationPipeline, editor::IPipeline)
 
 bool AnimationPipeline::create(const editor::IPipelineSettings* settings, db::Database* database)
 {
@@ -379,6 +387,19 @@ bool AnimationPipeline::buildOutput(
 		log::info << L"Removed " << (uncompressedCount - anim->getKeyPoseCount()) << L" redundant key poses in animation; was " << uncompressedCount << L", now " << anim->getKeyPoseCount() << Endl;
 	*/
 
+	// Compress key poses into quantized tracks.
+	if (animationAsset->getCompress())
+	{
+		const uint32_t keyPoseCount = anim->getKeyPoseCount();
+		if (anim->compress(c_compressTranslationTolerance, c_compressRotationTolerance))
+		{
+			const CompressedClip* clip = anim->getCompressedClip();
+			log::info << L"Compressed " << keyPoseCount << L" key poses of " << clip->getJointCount() << L" joint(s) into " << clip->getDataSize() << L" byte(s)." << Endl;
+		}
+		else
+			log::warning << L"Unable to compress animation; key poses kept uncompressed." << Endl;
+	}
+
 	Ref< db::Instance > instance = pipelineBuilder->createOutputInstance(outputPath, outputGuid);
 	if (!instance)
 	{
@@ -11,16 +11,24 @@
 #include "Animation/AnimatedMeshComponent.h"
 #include "Animation/SkeletonComponent.h"
 #include "Core/Containers/StaticVector.h"
+#include "Heightfield/Heightfield.h"
 #include "Physics/PhysicsManager.h"
 #include "World/Entity.h"
 
 namespace traktor::animation
 {
+	namespace
+	{
+
+const uint32_t c_maxFeet = 8;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.animation.FootPlacementComponent", FootPlacementComponent, world::IEntityComponent)
 
 FootPlacementComponent::FootPlacementComponent(
 	physics::PhysicsManager* physicsManager,
+	const resource::Proxy< hf::Heightfield >& heightfield,
 	const AlignedVector< render::handle_t >& footJoints,
 	uint32_t traceInclude,
 	uint32_t traceIgnore,
@@ -28,6 +36,7 @@ FootPlacementComponent::FootPlacementComponent(
 	float range
 )
 	: m_physicsManager(physicsManager)
+	, m_heightfield(heightfield)
 	, m_footJoints(footJoints)
 	, m_traceInclude(traceInclude)
 	, m_traceIgnore(traceIgnore)
@@ -71,36 +80,78 @@ void FootPlacementComponent::update(const world::UpdateParams& update)
 
 	const Transform ownerTransform = m_owner->getTransform();
 	const Transform ownerTransformInv = ownerTransform.inverse();
-	Transform footTransform;
 
+	// Gather feet first so heights can be sampled in a single batch.
+	StaticVector< render::handle_t, c_maxFeet > joints;
+	StaticVector< Transform, c_maxFeet > footTransforms;
+	StaticVector< Vector4, c_maxFeet > footPositions;
 	for (const auto footJoint : m_footJoints)
 	{
+		Transform footTransform;
 		if (!skeletonComponent->getPoseTransform(footJoint, footTransform))
 			continue;
 
-		const Vector4 footPosition = ownerTransform * footTransform.translation().xyz1();
-
-		physics::QueryResult result;
-		if (m_physicsManager->queryRay(
-			footPosition + Vector4(0.0f, m_range - m_offset, 0.0f),
-			Vector4(0.0f, -1.0f, 0.0f),
-			2.0f * m_range,
-			physics::QueryFilter(m_traceInclude, m_traceIgnore),
-			false,
-			result
-		))
+		joints.push_back(footJoint);
+		footTransforms.push_back(footTransform);
+		footPositions.push_back(ownerTransform * footTransform.translation().xyz1());
+
+		if (joints.full())
+			break;
+	}
+	if (joints.empty())
+		return;
+
+	if (m_heightfield)
+	{
+		float heights[c_maxFeet];
+		m_heightfield->getWorldHeights(footPositions.c_ptr(), (uint32_t)footPositions.size(), heights);
+
+		for (uint32_t i = 0; i < joints.size(); ++i)
 		{
-			const Vector4 hit = (result.position + Vector4(0.0f, m_offset, 0.0f)).xyz1();
+			const Vector4& footPosition = footPositions[i];
+
+			// Same range as traced ray, i.e. within range of foot bottom; also ignore holes.
+			const float bottom = footPosition.y() - m_offset;
+			if (abs(heights[i] - bottom) > m_range || !m_heightfield->getWorldCut(footPosition.x(), footPosition.z()))
+				continue;
+
+			const Vector4 hit(footPosition.x(), heights[i] + m_offset, footPosition.z(), 1.0f);
 			skeletonComponent->setPoseTransform(
-				footJoint,
+				joints[i],
 				Transform(
 					ownerTransformInv * hit,
-					footTransform.rotation()
+					footTransforms[i].rotation()
 				),
 				true
 			);
 		}
 	}
+	else
+	{
+		for (uint32_t i = 0; i < joints.size(); ++i)
+		{
+			physics::QueryResult result;
+			if (m_physicsManager->queryRay(
+				footPositions[i] + Vector4(0.0f, m_range - m_offset, 0.0f),
+				Vector4(0.0f, -1.0f, 0.0f),
+				2.0f * m_range,
+				physics::QueryFilter(m_traceInclude, m_traceIgnore),
+				false,
+				result
+			))
+			{
+				const Vector4 hit = (result.position + Vector4(0.0f, m_offset, 0.0f)).xyz1();
+				skeletonComponent->setPoseTransform(
+					joints[i],
+					Transform(
+						ownerTransformInv * hit,
+						footTransforms[i].rotation()
+					),
+					true
+				);
+			}
+		}
+	}
 }
 
 }
@@ -10,6 +10,7 @@
 
 #include "Core/Containers/AlignedVector.h"
 #include "Render/Types.h"
+#include "Resource/Proxy.h"
 #include "World/IEntityComponent.h"
 
 // import/export mechanism.
@@ -20,6 +21,13 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor::hf
+{
+
+class Heightfield;
+
+}
+
 namespace traktor::physics
 {
 
@@ -40,6 +48,7 @@ class T_DLLCLASS FootPlacementComponent : public world::IEntityComponent
 public:
 	explicit FootPlacementComponent(
 		physics::PhysicsManager* physicsManager,
+		const resource::Proxy< hf::Heightfield >& heightfield,
 		const AlignedVector< render::handle_t >& footJoints,
 		uint32_t traceInclude,
 		uint32_t traceIgnore,
@@ -60,6 +69,7 @@ public:
 private:
 	world::Entity* m_owner = nullptr;
 	Ref< physics::PhysicsManager > m_physicsManager;
+	resource::Proxy< hf::Heightfield > m_heightfield;
 	AlignedVector< render::handle_t > m_footJoints;
 	uint32_t m_traceInclude;
 	uint32_t m_traceIgnore;
@@ -21,7 +21,7 @@
 namespace traktor::animation
 {
 
-T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.animation.FootPlacementComponentData", 0, FootPlacementComponentData, world::IEntityComponentData)
+T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.animation.FootPlacementComponentData", 1, FootPlacementComponentData, world::IEntityComponentData)
 
 Ref< FootPlacementComponent > FootPlacementComponentData::createComponent(
 	resource::IResourceManager* resourceManager,
@@ -46,6 +46,13 @@ Ref< FootPlacementComponent > FootPlacementComponentData::createComponent(
 		traceIgnore |= traceGroup->getBitMask();
 	}
 
+	resource::Proxy< hf::Heightfield > heightfield;
+	if (m_heightfield)
+	{
+		if (!resourceManager->bind(m_heightfield, heightfield))
+			return nullptr;
+	}
+
 	AlignedVector< render::handle_t > footJoints;
 	footJoints.reserve(m_footJoints.size());
 	for (const auto& footJoint : m_footJoints)
@@ -53,6 +60,7 @@ Ref< FootPlacementComponent > FootPlacementComponentData::createComponent(
 
 	return new FootPlacementComponent(
 		physicsManager,
+		heightfield,
 		footJoints,
 		traceInclude,
 		traceIgnore,
@@ -74,6 +82,10 @@ void FootPlacementComponentData::serialize(ISerializer& s)
 {
 	s >> MemberSmallSet< resource::Id< physics::CollisionSpecification >, resource::Member< physics::CollisionSpecification > >(L"traceInclude", m_traceInclude);
 	s >> MemberSmallSet< resource::Id< physics::CollisionSpecification >, resource::Member< physics::CollisionSpecification > >(L"traceIgnore", m_traceIgnore);
+
+	if (s.getVersion< FootPlacementComponentData >() >= 1)
+		s >> resource::Member< hf::Heightfield >(L"heightfield", m_heightfield);
+
 	s >> MemberAlignedVector< std::wstring >(L"footJoints", m_footJoints);
 	s >> Member< float >(L"offset", m_offset, AttributeUnit(UnitType::Metres));
 	s >> Member< float >(L"range", m_range, AttributeUnit(UnitType::Metres) | AttributeRange(0.0f));
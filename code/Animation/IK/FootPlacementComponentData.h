@@ -10,6 +10,7 @@
 
 #include "Core/Ref.h"
 #include "Core/Containers/SmallSet.h"
+#include "Heightfield/Heightfield.h"
 #include "Physics/CollisionSpecification.h"
 #include "Resource/Id.h"
 #include "World/IEntityComponentData.h"
@@ -63,6 +64,7 @@ public:
 private:
 	SmallSet< resource::Id< physics::CollisionSpecification > > m_traceInclude;
 	SmallSet< resource::Id< physics::CollisionSpecification > > m_traceIgnore;
+	resource::Id< hf::Heightfield > m_heightfield;	//!< Sample heights from heightfield instead of tracing physics, if set.
 	AlignedVector< std::wstring > m_footJoints;
 	float m_offset = 0.1f;	//!< Foot joint offset from actual bottom of foot.
 	float m_range = 0.2f;	//!< Trace range up/down from foot.
@@ -78,6 +78,19 @@ Aabb3 JointBindingComponent::getBoundingBox() const
 	return worldBoundingBox.transform(m_transform.inverse());
 }
 
+bool JointBindingComponent::allowConcurrentUpdate() const
+{
+	// Bound entities are moved by this component, thus cannot be
+	// updated concurrently with their own components.
+	return false;
+}
+
+world::UpdatePhase JointBindingComponent::getUpdatePhase() const
+{
+	// Bound entities follow skeleton pose, thus update after skeleton has been updated.
+	return world::UpdatePhase::Late;
+}
+
 void JointBindingComponent::update(const world::UpdateParams& update)
 {
 	auto skeletonComponent = m_owner->getComponent< SkeletonComponent >();
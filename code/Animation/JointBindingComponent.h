@@ -49,6 +49,10 @@ public:
 
 	virtual Aabb3 getBoundingBox() const override final;
 
+	virtual bool allowConcurrentUpdate() const override final;
+
+	virtual world::UpdatePhase getUpdatePhase() const override final;
+
 	virtual void update(const world::UpdateParams& update) override final;
 
 	world::Entity* getEntity(const std::wstring& name, int32_t index) const;
@@ -18,81 +18,95 @@ T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.Pose", 0, Pose, ISerializable
 
 void Pose::reset()
 {
-	m_joints.resize(0);
+	m_mask.clear();
+	m_translations.resize(0);
+	m_rotations.resize(0);
 }
 
 void Pose::reserve(uint32_t jointCapacity)
 {
-	m_joints.reserve(jointCapacity);
+	m_translations.reserve(jointCapacity);
+	m_rotations.reserve(jointCapacity);
 }
 
 void Pose::setJointTransform(uint32_t jointIndex, const Transform& jointTransform)
 {
-	Joint& joint = getEditJoint(jointIndex);
-	joint.transform = jointTransform;
+	T_ASSERT(jointIndex < 256);
+	if (jointIndex >= getJointCount())
+		resize(jointIndex + 1);
+	m_translations[jointIndex] = jointTransform.translation();
+	m_rotations[jointIndex] = jointTransform.rotation();
+	m_mask.set(jointIndex);
 }
 
 Transform Pose::getJointTransform(uint32_t jointIndex) const
 {
-	const Joint* joint = getJoint(jointIndex);
-	return joint ? joint->transform : Transform::identity();
+	if (jointIndex < getJointCount())
+		return Transform(m_translations[jointIndex], m_rotations[jointIndex]);
+	else
+		return Transform::identity();
 }
 
 uint32_t Pose::getMaxIndex() const
 {
-	uint32_t maxIndex =  0;
-	for (const auto& joint : m_joints)
-		maxIndex = max(maxIndex, joint.index);
-	return maxIndex;
+	// Dense arrays only grow when a joint is set, thus last entry is always set.
+	return !m_translations.empty() ? getJointCount() - 1 : 0;
 }
 
 void Pose::getIndexMask(BitSet& outIndices) const
 {
-	for (const auto& joint : m_joints)
-		outIndices.set(joint.index);
+	outIndices.insert(m_mask);
 }
 
-const Pose::Joint* Pose::getJoint(uint32_t jointIndex) const
+void Pose::blend(const Pose& pose1, const Pose& pose2, const Scalar& blend)
 {
-	size_t s = 0;
-	size_t e = m_joints.size();
+	T_ASSERT(&pose1 != this);
+	T_ASSERT(&pose2 != this);
+
+	const uint32_t jointCount1 = pose1.getJointCount();
+	const uint32_t jointCount2 = pose2.getJointCount();
+
+	reset();
+	resize(max(jointCount1, jointCount2));
+
+	m_mask.insert(pose1.m_mask);
+	m_mask.insert(pose2.m_mask);
+	m_mask.forEach([&](int32_t i) {
+		const Transform t1 = pose1.getJointTransform(i);
+		const Transform t2 = pose2.getJointTransform(i);
+		const Transform t = lerp(t1, t2, blend);
+		m_translations[i] = t.translation();
+		m_rotations[i] = t.rotation();
+	});
+}
 
-	while (s < e)
+void Pose::serialize(ISerializer& s)
+{
+	// Serialized as sparse joints to keep format compatible.
+	AlignedVector< Joint > joints;
+	if (s.getDirection() == ISerializer::Direction::Write)
 	{
-		const size_t m = s + (e - s) / 2;
-		if (jointIndex == m_joints[m].index)
-			return &m_joints[m];
-		else if (jointIndex < m_joints[m].index)
-			e = m;
-		else if (jointIndex > m_joints[m].index)
-			s = m + 1;
+		m_mask.forEach([&](int32_t i) {
+			Joint& joint = joints.push_back();
+			joint.index = i;
+			joint.transform = getJointTransform(i);
+		});
 	}
 
-	return nullptr;
-}
-
-Pose::Joint& Pose::getEditJoint(uint32_t jointIndex)
-{
-	size_t s = 0;
-	size_t e = m_joints.size();
+	s >> MemberAlignedVector< Joint, MemberComposite< Joint > >(L"joints", joints);
 
-	while (s < e)
+	if (s.getDirection() == ISerializer::Direction::Read)
 	{
-		const size_t m = s + (e - s) / 2;
-		if (jointIndex == m_joints[m].index)
-			return m_joints[m];
-		else if (jointIndex < m_joints[m].index)
-			e = m;
-		else if (jointIndex > m_joints[m].index)
-			s = m + 1;
+		reset();
+		for (const auto& joint : joints)
+			setJointTransform(joint.index, joint.transform);
 	}
-
-	return *m_joints.insert(m_joints.begin() + s, Joint(jointIndex));
 }
 
-void Pose::serialize(ISerializer& s)
+void Pose::resize(uint32_t jointCount)
 {
-	s >> MemberAlignedVector< Joint, MemberComposite< Joint > >(L"joints", m_joints);
+	m_translations.resize(jointCount, Vector4::zero());
+	m_rotations.resize(jointCount, Quaternion::identity());
 }
 
 void Pose::Joint::serialize(ISerializer& s)
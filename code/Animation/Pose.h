@@ -26,6 +26,11 @@ namespace traktor::animation
 
 /*! Skeleton pose.
  * \ingroup Animation
+ *
+ * Joint transforms are stored densely, indexed by joint,
+ * as separate arrays of translations and rotations. Joints
+ * not set in the pose are identity and a mask keep track
+ * of which joints have been set.
  */
 class T_DLLCLASS Pose : public ISerializable
 {
@@ -44,6 +49,26 @@ public:
 
 	void getIndexMask(BitSet& outIndices) const;
 
+	/*! Mask of joints set in pose. */
+	const BitSet& getIndexMask() const { return m_mask; }
+
+	/*! Number of joints stored in dense arrays, i.e. max index + 1. */
+	uint32_t getJointCount() const { return (uint32_t)m_translations.size(); }
+
+	/*! Joint translations, getJointCount number of entries. */
+	const Vector4* getTranslations() const { return m_translations.c_ptr(); }
+
+	/*! Joint rotations, getJointCount number of entries. */
+	const Quaternion* getRotations() const { return m_rotations.c_ptr(); }
+
+	/*! Blend between two poses.
+	 *
+	 * Only joints set in either pose are blended,
+	 * joints missing in one of the poses are blended
+	 * with identity.
+	 */
+	void blend(const Pose& pose1, const Pose& pose2, const Scalar& blend);
+
 	virtual void serialize(ISerializer& s) override final;
 
 private:
@@ -61,11 +86,11 @@ private:
 		void serialize(ISerializer& s);
 	};
 
-	AlignedVector< Joint > m_joints;
-
-	const Joint* getJoint(uint32_t jointIndex) const;
+	BitSet m_mask;
+	AlignedVector< Vector4 > m_translations;
+	AlignedVector< Quaternion > m_rotations;
 
-	Joint& getEditJoint(uint32_t jointIndex);
+	void resize(uint32_t jointCount);
 };
 
 }
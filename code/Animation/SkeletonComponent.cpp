@@ -12,16 +12,33 @@
 #include "Animation/Skeleton.h"
 #include "Animation/SkeletonUtils.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/JobManager.h"
+#include "Core/Thread/Semaphore.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
 #include "World/Entity.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
-//#define T_USE_UPDATE_JOBS
-
 namespace traktor::animation
 {
+namespace
+{
+
+/*! Number of skeletons evaluated by each job. */
+const uint32_t c_evaluationBatchSize = 8;
+
+/*! Skeletons updated but not yet evaluated. */
+Semaphore s_pendingLock;
+AlignedVector< SkeletonComponent* > s_pending;
+
+/*! Held by the thread evaluating a batch of pending skeletons. */
+Semaphore s_evaluationLock;
+
+}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.animation.SkeletonComponent", SkeletonComponent, world::IEntityComponent)
 
@@ -51,6 +68,16 @@ SkeletonComponent::SkeletonComponent(
 void SkeletonComponent::destroy()
 {
 	synchronize();
+
+	// Wait until any batch, which might still refer to us, has been evaluated.
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_evaluationLock);
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_pendingLock);
+		auto it = std::find(s_pending.begin(), s_pending.end(), this);
+		if (it != s_pending.end())
+			s_pending.erase(it);
+	}
+
 	safeDestroy(m_poseController);
 }
 
@@ -139,24 +166,83 @@ void SkeletonComponent::update(const world::UpdateParams& update)
 	const double deltaTime = m_deferredDeltaTime;
 	m_deferredDeltaTime = 0.0;
 
-#if defined(T_USE_UPDATE_JOBS)
-	m_updatePoseControllerJob = JobManager::getInstance().add([=, this]() {
-		updatePoseController(update.alternateTime, deltaTime);
-	});
-#else
-	updatePoseController(update.alternateTime, deltaTime);
-#endif
+	// Defer evaluation until pose is needed so all skeletons can be evaluated together.
+	m_evaluationTime = update.alternateTime;
+	m_evaluationDeltaTime = deltaTime;
+	m_evaluationState = EvaluationState::Pending;
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_pendingLock);
+	s_pending.push_back(this);
 }
 
 void SkeletonComponent::synchronize() const
 {
-#if defined(T_USE_UPDATE_JOBS)
-	if (m_updatePoseControllerJob)
+	if (m_evaluationState == EvaluationState::Idle)
+		return;
+
+	// Evaluate all pending skeletons unless another thread is already evaluating
+	// a batch; then evaluate only ourself instead of waiting for the whole batch.
+	if (s_evaluationLock.wait(0))
+	{
+		evaluatePending();
+		s_evaluationLock.release();
+	}
+
+	const_cast< SkeletonComponent* >(this)->evaluate();
+
+	// Another thread might be evaluating this skeleton right now.
+	while (m_evaluationState != EvaluationState::Idle)
+		ThreadManager::getInstance().getCurrentThread()->yield();
+}
+
+void SkeletonComponent::synchronizeAll()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_evaluationLock);
+	evaluatePending();
+}
+
+void SkeletonComponent::evaluatePending()
+{
+	AlignedVector< SkeletonComponent* > pending;
 	{
-		m_updatePoseControllerJob->wait();
-		m_updatePoseControllerJob = nullptr;
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(s_pendingLock);
+		pending.swap(s_pending);
 	}
-#endif
+
+	const uint32_t count = (uint32_t)pending.size();
+	if (count > c_evaluationBatchSize)
+	{
+		AlignedVector< Job::task_t > jobs;
+		jobs.reserve((count + c_evaluationBatchSize - 1) / c_evaluationBatchSize);
+		for (uint32_t i = 0; i < count; i += c_evaluationBatchSize)
+		{
+			SkeletonComponent* const* components = pending.c_ptr() + i;
+			const uint32_t batchCount = std::min(c_evaluationBatchSize, count - i);
+			jobs.push_back([=]() {
+				for (uint32_t j = 0; j < batchCount; ++j)
+					components[j]->evaluate();
+			});
+		}
+
+		// Fork run jobs not yet started by a worker on this thread, thus
+		// it's safe to evaluate from within a world update job.
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+	}
+	else
+	{
+		for (auto component : pending)
+			component->evaluate();
+	}
+}
+
+void SkeletonComponent::evaluate()
+{
+	int32_t expected = EvaluationState::Pending;
+	if (!m_evaluationState.compare_exchange_strong(expected, EvaluationState::Evaluating))
+		return;
+
+	updatePoseController(m_evaluationTime, m_evaluationDeltaTime);
+	m_evaluationState = EvaluationState::Idle;
 }
 
 bool SkeletonComponent::getJointTransform(render::handle_t jointName, Transform& outTransform) const
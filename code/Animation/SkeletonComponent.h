@@ -11,11 +11,12 @@
 #include "Animation/Pose.h"
 #include "Core/Containers/AlignedVector.h"
 #include "Core/RefArray.h"
-#include "Core/Thread/Job.h"
 #include "Render/Types.h"
 #include "Resource/Proxy.h"
 #include "World/IEntityComponent.h"
 
+#include <atomic>
+
 // import/export mechanism.
 #undef T_DLLCLASS
 #if defined(T_ANIMATION_EXPORT)
@@ -32,6 +33,12 @@ class IPoseController;
 
 /*! Skeleton entity component.
  * \ingroup Animation
+ *
+ * Pose evaluation is deferred from update until the pose
+ * is first needed, such as when the animated mesh is updated.
+ * All skeletons updated until then are evaluated together,
+ * a batch of skeletons per job, thus crowds of characters
+ * are evaluated in parallel across all cores.
  */
 class T_DLLCLASS SkeletonComponent : public world::IEntityComponent
 {
@@ -61,8 +68,19 @@ public:
 
 	virtual void update(const world::UpdateParams& update) override final;
 
+	/*! Ensure pose of this skeleton has been evaluated.
+	 *
+	 * Evaluates all pending skeletons if this skeleton
+	 * has a pending evaluation.
+	 */
 	void synchronize() const;
 
+	/*! Evaluate all pending skeletons. */
+	static void synchronizeAll();
+
+	/*! Check if evaluation of pose is pending. */
+	bool isEvaluationPending() const { return m_evaluationState != EvaluationState::Idle; }
+
 	/*! Get base transform of joint. */
 	bool getJointTransform(render::handle_t jointName, Transform& outTransform) const;
 
@@ -95,11 +113,16 @@ public:
 	const AlignedVector< Transform >& getJointTransforms() const { return m_jointTransforms; }
 
 	/*! Get all joint pose transforms. */
-	const AlignedVector< Transform >& getPoseTransforms() const { return m_poseTransforms; }
+	const AlignedVector< Transform >& getPoseTransforms() const
+	{
+		synchronize();
+		return m_poseTransforms;
+	}
 
 	/*! Set all joint pose transforms. */
 	void setPoseTransforms(const AlignedVector< Transform >& poseTransforms)
 	{
+		synchronize();
 		m_poseTransforms = poseTransforms;
 		m_revision++;
 	}
@@ -123,12 +146,24 @@ public:
 	int32_t getUpdatePeriod() const { return m_updatePeriod; }
 
 private:
+	struct EvaluationState
+	{
+		enum
+		{
+			Idle,
+			Pending,
+			Evaluating
+		};
+	};
+
 	Transform m_transform;
 	resource::Proxy< Skeleton > m_skeleton;
 	Ref< IPoseController > m_poseController;
 	AlignedVector< Transform > m_jointTransforms;
 	AlignedVector< Transform > m_poseTransforms;
-	mutable Ref< Job > m_updatePoseControllerJob;
+	std::atomic< int32_t > m_evaluationState = EvaluationState::Idle;
+	double m_evaluationTime = 0.0;
+	double m_evaluationDeltaTime = 0.0;
 	std::atomic< int32_t > m_revision;
 	mutable Aabb3 m_boundingBox;
 	mutable int32_t m_boundingBoxRevision = -1;
@@ -137,6 +172,10 @@ private:
 	int32_t m_updateCount = 0;
 	double m_deferredDeltaTime = 0.0;
 
+	static void evaluatePending();
+
+	void evaluate();
+
 	void updatePoseController(double time, double deltaTime);
 };
 
@@ -54,9 +54,16 @@ void calculatePoseLocalTransforms(
 	T_ASSERT(skeleton);
 	T_ASSERT(pose);
 
-	outJointLocalTransforms.resize(skeleton->getJointCount());
-	for (uint32_t i = 0; i < skeleton->getJointCount(); ++i)
-		outJointLocalTransforms[i] = pose->getJointTransform(i);
+	const uint32_t jointCount = skeleton->getJointCount();
+	const uint32_t poseJointCount = std::min(pose->getJointCount(), jointCount);
+	const Vector4* translations = pose->getTranslations();
+	const Quaternion* rotations = pose->getRotations();
+
+	outJointLocalTransforms.resize(jointCount);
+	for (uint32_t i = 0; i < poseJointCount; ++i)
+		outJointLocalTransforms[i] = Transform(translations[i], rotations[i]);
+	for (uint32_t i = poseJointCount; i < jointCount; ++i)
+		outJointLocalTransforms[i] = Transform::identity();
 }
 
 void calculatePoseTransforms(
@@ -68,15 +75,40 @@ void calculatePoseTransforms(
 	T_ASSERT(skeleton);
 	T_ASSERT(pose);
 
+	calculatePoseLocalTransforms(skeleton, pose, outJointTransforms);
+
+	// Parents are usually stored before their children, in which case each joint
+	// is concatenated with it's parent's already concatenated transform; else fall
+	// back to walking the chain of parents from a copy of the local transforms.
+	const uint32_t jointCount = skeleton->getJointCount();
 	AlignedVector< Transform > localPoseTransforms;
-	calculatePoseLocalTransforms(skeleton, pose, localPoseTransforms);
+	for (uint32_t i = 0; i < jointCount; ++i)
+	{
+		const int32_t parent = skeleton->getJoint(i)->getParent();
+		if (parent >= (int32_t)i)
+		{
+			localPoseTransforms = outJointTransforms;
+			break;
+		}
+	}
 
-	outJointTransforms.resize(skeleton->getJointCount());
-	for (uint32_t i = 0; i < skeleton->getJointCount(); ++i)
+	if (localPoseTransforms.empty())
 	{
-		outJointTransforms[i] = localPoseTransforms[i];
-		for (int32_t parentIndex = skeleton->getJoint(i)->getParent(); parentIndex >= 0; parentIndex = skeleton->getJoint(parentIndex)->getParent())
-			outJointTransforms[i] = localPoseTransforms[parentIndex] * outJointTransforms[i];
+		for (uint32_t i = 0; i < jointCount; ++i)
+		{
+			const int32_t parent = skeleton->getJoint(i)->getParent();
+			if (parent >= 0)
+				outJointTransforms[i] = outJointTransforms[parent] * outJointTransforms[i];
+		}
+	}
+	else
+	{
+		for (uint32_t i = 0; i < jointCount; ++i)
+		{
+			outJointTransforms[i] = localPoseTransforms[i];
+			for (int32_t parentIndex = skeleton->getJoint(i)->getParent(); parentIndex >= 0; parentIndex = skeleton->getJoint(parentIndex)->getParent())
+				outJointTransforms[i] = localPoseTransforms[parentIndex] * outJointTransforms[i];
+		}
 	}
 }
 
@@ -133,25 +165,7 @@ void blendPoses(
 	T_ASSERT(pose2);
 	T_ASSERT(outPose);
 
-	// Build mask of all used joint indices.
-	BitSet indices;
-	pose1->getIndexMask(indices);
-	pose2->getIndexMask(indices);
-
-	int minRange, maxRange;
-	indices.range(minRange, maxRange);
-
-	outPose->reset();
-	outPose->reserve(maxRange - minRange);
-	for (int i = minRange; i < maxRange; ++i)
-	{
-		if (!indices(i))
-			continue;
-
-		const Transform t1 = pose1->getJointTransform(i);
-		const Transform t2 = pose2->getJointTransform(i);
-		outPose->setJointTransform(i, lerp(t1, t2, blend));
-	}
+	outPose->blend(*pose1, *pose2, blend);
 }
 
 }
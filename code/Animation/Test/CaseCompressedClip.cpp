@@ -0,0 +1,138 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include "Animation/Pose.h"
+#include "Animation/Animation/Animation.h"
+#include "Animation/Animation/CompressedClip.h"
+#include "Animation/Test/CaseCompressedClip.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Math/Const.h"
+#include "Core/Serialization/BinarySerializer.h"
+
+namespace traktor::animation::test
+{
+	namespace
+	{
+
+const uint32_t c_jointCount = 64;
+const uint32_t c_frameCount = 241;
+const float c_frameRate = 30.0f;
+const float c_translationTolerance = 0.0005f;
+const float c_rotationTolerance = 0.0005f;
+const uint32_t c_samples = 100;
+
+Ref< Animation > createAnimation()
+{
+	Ref< Animation > animation = new Animation();
+	for (uint32_t i = 0; i < c_frameCount; ++i)
+	{
+		const float at = i / c_frameRate;
+
+		Animation::KeyPose kp;
+		kp.at = at;
+
+		for (uint32_t j = 0; j < c_jointCount; ++j)
+		{
+			const Vector4 axis = Vector4(std::sin(j * 1.3f), std::cos(j * 0.7f), 0.5f).normalized();
+			const Quaternion bind = Quaternion::fromAxisAngle(axis, j * 0.1f);
+
+			// Every fourth joint is not animated, others swing at various frequencies.
+			Quaternion rotation = bind;
+			if ((j & 3) != 0)
+				rotation = bind * Quaternion::fromAxisAngle(axis.shuffle< 1, 2, 0, 3 >().normalized(), 0.6f * std::sin(TWO_PI * (0.2f + j * 0.01f) * at + j));
+
+			// Root moves forward, other joints have fixed offset from parent.
+			Vector4 translation(0.0f, 0.25f, 0.0f, 0.0f);
+			if (j == 0)
+				translation = Vector4(at * 1.5f, 1.0f + 0.05f * std::sin(TWO_PI * 2.0f * at), 0.0f, 0.0f);
+
+			kp.pose.setJointTransform(j, Transform(translation, rotation));
+		}
+
+		animation->addKeyPose(kp);
+	}
+	return animation;
+}
+
+uint32_t serializedSize(const Animation* animation)
+{
+	DynamicMemoryStream ms(false, true);
+	BinarySerializer(&ms).writeObject(animation);
+	return (uint32_t)ms.getBuffer().size();
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.test.CaseCompressedClip", 0, CaseCompressedClip, traktor::test::Case)
+
+void CaseCompressedClip::run()
+{
+	Ref< Animation > reference = createAnimation();
+	Ref< Animation > compressed = createAnimation();
+	CASE_ASSERT(compressed->compress(c_translationTolerance, c_rotationTolerance));
+
+	const CompressedClip* clip = compressed->getCompressedClip();
+	CASE_ASSERT(clip != nullptr);
+	if (!clip)
+		return;
+
+	CASE_ASSERT_EQUAL(clip->getJointCount(), c_jointCount);
+	CASE_ASSERT_EQUAL(compressed->getStartTime(), reference->getStartTime());
+	CASE_ASSERT_EQUAL(compressed->getEndTime(), reference->getEndTime());
+
+	// Error, sampled in between key poses as well.
+	const float duration = reference->getEndTime();
+	float maxTranslationError = 0.0f;
+	float maxRotationError = 0.0f;
+	Pose referencePose, compressedPose;
+	for (uint32_t i = 0; i <= 4 * c_frameCount; ++i)
+	{
+		const float at = (i * duration) / (4 * c_frameCount);
+		reference->getPose(at, referencePose);
+		compressed->getPose(at, compressedPose);
+
+		for (uint32_t j = 0; j < c_jointCount; ++j)
+		{
+			const Transform Tr = referencePose.getJointTransform(j);
+			const Transform Tc = compressedPose.getJointTransform(j);
+			maxTranslationError = std::max< float >(maxTranslationError, (Tr.translation() - Tc.translation()).absolute().max());
+
+			const Vector4 ec = (dot4(Tr.rotation().e, Tc.rotation().e) >= 0.0_simd) ? Tc.rotation().e : -Tc.rotation().e;
+			const float c = std::min((float)(Tr.rotation().e - ec).length(), 2.0f);
+			maxRotationError = std::max(maxRotationError, 4.0f * std::asin(c * 0.5f));
+		}
+	}
+
+	CASE_ASSERT(maxTranslationError < 2.0f * c_translationTolerance);
+	CASE_ASSERT(maxRotationError < 2.0f * c_rotationTolerance);
+
+	// Size.
+	const uint32_t referenceSize = serializedSize(reference);
+	const uint32_t compressedSize = serializedSize(compressed);
+	CASE_ASSERT(compressedSize * 4 < referenceSize);
+
+	// Evaluating transforms directly match evaluated pose.
+	AlignedVector< Transform > transforms(c_jointCount);
+	bool match = true;
+	for (uint32_t i = 0; i < c_samples; ++i)
+	{
+		const float at = (i * duration) / c_samples;
+		compressed->getPose(at, compressedPose);
+		clip->evaluate(at, transforms.ptr());
+		for (uint32_t j = 0; j < c_jointCount; ++j)
+		{
+			const Transform T = compressedPose.getJointTransform(j);
+			match &= (T.translation() - transforms[j].translation()).absolute().max() < 1e-5f;
+			match &= (T.rotation().e - transforms[j].rotation().e).absolute().max() < 1e-5f;
+		}
+	}
+	CASE_ASSERT(match);
+}
+
+}
@@ -0,0 +1,114 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Animation/Pose.h"
+#include "Animation/SkeletonUtils.h"
+#include "Animation/Test/CasePose.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::animation::test
+{
+	namespace
+	{
+
+const uint32_t c_jointCount = 64;
+const uint32_t c_blends = 20000;
+
+Transform jointTransform(uint32_t joint, float phase)
+{
+	return Transform(
+		Vector4(joint * 0.1f, phase, 0.0f, 0.0f),
+		Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), joint * 0.05f + phase)
+	);
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.animation.test.CasePose", 0, CasePose, traktor::test::Case)
+
+void CasePose::run()
+{
+	// Joints not set are identity and not part of mask.
+	Pose pose;
+	pose.setJointTransform(7, jointTransform(7, 0.0f));
+	pose.setJointTransform(2, jointTransform(2, 0.0f));
+	CASE_ASSERT_EQUAL(pose.getMaxIndex(), (uint32_t)7);
+	CASE_ASSERT_EQUAL(pose.getJointCount(), (uint32_t)8);
+	CASE_ASSERT(pose.getIndexMask()(2));
+	CASE_ASSERT(pose.getIndexMask()(7));
+	CASE_ASSERT(!pose.getIndexMask()(3));
+	CASE_ASSERT(fuzzyEqual(pose.getJointTransform(7), jointTransform(7, 0.0f)));
+	CASE_ASSERT(fuzzyEqual(pose.getJointTransform(3), Transform::identity()));
+	CASE_ASSERT(fuzzyEqual(pose.getJointTransform(100), Transform::identity()));
+
+	// Serialized as sparse joints.
+	{
+		DynamicMemoryStream ms(false, true);
+		CASE_ASSERT(BinarySerializer(&ms).writeObject(&pose));
+
+		DynamicMemoryStream rs(ms.getBuffer(), true, false);
+		Ref< Pose > readPose = BinarySerializer(&rs).readObject< Pose >();
+		CASE_ASSERT(readPose != nullptr);
+		if (readPose)
+		{
+			CASE_ASSERT_EQUAL(readPose->getJointCount(), (uint32_t)8);
+			CASE_ASSERT(!readPose->getIndexMask()(3));
+			CASE_ASSERT(fuzzyEqual(readPose->getJointTransform(2), jointTransform(2, 0.0f)));
+			CASE_ASSERT(fuzzyEqual(readPose->getJointTransform(7), jointTransform(7, 0.0f)));
+		}
+	}
+
+	// Blend union of joints; joints missing in one pose are blended with identity.
+	Pose pose1, pose2, blendPose;
+	for (uint32_t i = 0; i < c_jointCount; ++i)
+	{
+		if ((i & 1) == 0)
+			pose1.setJointTransform(i, jointTransform(i, 0.0f));
+		if (i < c_jointCount - 8)
+			pose2.setJointTransform(i, jointTransform(i, 0.5f));
+	}
+
+	blendPoses(&pose1, &pose2, 0.25_simd, &blendPose);
+	CASE_ASSERT_EQUAL(blendPose.getJointCount(), c_jointCount - 1);
+
+	int32_t errors = 0;
+	for (uint32_t i = 0; i < c_jointCount; ++i)
+	{
+		const bool set = ((i & 1) == 0) || (i < c_jointCount - 8);
+		if (blendPose.getIndexMask()(i) != set)
+			++errors;
+
+		const Transform expected = lerp(pose1.getJointTransform(i), pose2.getJointTransform(i), 0.25_simd);
+		if (!fuzzyEqual(blendPose.getJointTransform(i), expected))
+			++errors;
+	}
+	CASE_ASSERT_EQUAL(errors, 0);
+
+	// Speed.
+	Timer timer;
+	for (uint32_t i = 0; i < c_blends; ++i)
+		blendPoses(&pose1, &pose2, Scalar(float(i) / c_blends), &blendPose);
+	const double blendTime = timer.getElapsedTime();
+
+	timer.reset();
+	Transform sum = Transform::identity();
+	for (uint32_t i = 0; i < c_blends; ++i)
+	{
+		for (uint32_t j = 0; j < c_jointCount; ++j)
+			sum = Transform(sum.translation() + blendPose.getJointTransform(j).translation(), sum.rotation());
+	}
+	const double readTime = timer.getElapsedTime();
+
+	log::info << L"Pose, " << c_jointCount << L" joints" << Endl;
+	log::info << L"  blend " << int32_t(blendTime * 1e9 / c_blends) << L" ns, read all joints " << int32_t(readTime * 1e9 / c_blends) << L" ns (" << sum.translation().x() << L")" << Endl;
+}
+
+}
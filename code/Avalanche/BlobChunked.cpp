@@ -0,0 +1,234 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Avalanche/BlobChunked.h"
+#include "Avalanche/ChunkStore.h"
+#include "Core/Io/BufferedStream.h"
+#include "Core/Io/File.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+
+namespace traktor::avalanche
+{
+	namespace
+	{
+
+const uint32_t c_manifestMagic = 0x4d4e4354;	// "TCNM"
+
+/*! Read stream concatenating all chunks of a blob. */
+class ChunkedReadStream : public IStream
+{
+public:
+	explicit ChunkedReadStream(ChunkStore* store, const AlignedVector< BlobChunked::ChunkRef >& chunks, int64_t size)
+	:	m_store(store)
+	,	m_chunks(chunks)
+	,	m_size(size)
+	{
+	}
+
+	virtual void close() override final
+	{
+		m_chunk = nullptr;
+		m_store = nullptr;
+	}
+
+	virtual bool canRead() const override final { return true; }
+
+	virtual bool canWrite() const override final { return false; }
+
+	virtual bool canSeek() const override final { return false; }
+
+	virtual int64_t tell() const override final { return m_position; }
+
+	virtual int64_t available() const override final { return m_size - m_position; }
+
+	virtual int64_t seek(SeekOriginType origin, int64_t offset) override final { return -1; }
+
+	virtual int64_t read(void* block, int64_t nbytes) override final
+	{
+		uint8_t* ptr = (uint8_t*)block;
+		int64_t nread = 0;
+
+		while (nread < nbytes)
+		{
+			if (!m_chunk)
+			{
+				if (!m_store || m_current >= m_chunks.size())
+					break;
+				if ((m_chunk = m_store->read(m_chunks[m_current].key)) == nullptr)
+					return -1;
+				m_chunkRemaining = m_chunks[m_current].size;
+				m_current++;
+			}
+
+			const int64_t request = std::min< int64_t >(nbytes - nread, m_chunkRemaining);
+			const int64_t result = request > 0 ? m_chunk->read(ptr + nread, request) : 0;
+			if (result < 0 || (result == 0 && request > 0))
+				return -1;
+
+			nread += result;
+			m_position += result;
+			m_chunkRemaining -= result;
+
+			if (m_chunkRemaining <= 0)
+			{
+				m_chunk->close();
+				m_chunk = nullptr;
+			}
+		}
+
+		return nread;
+	}
+
+	virtual int64_t write(const void* block, int64_t nbytes) override final { return -1; }
+
+	virtual void flush() override final {}
+
+private:
+	Ref< ChunkStore > m_store;
+	AlignedVector< BlobChunked::ChunkRef > m_chunks;
+	int64_t m_size;
+	int64_t m_position = 0;
+	uint32_t m_current = 0;
+	Ref< IStream > m_chunk;
+	int64_t m_chunkRemaining = 0;
+};
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.avalanche.BlobChunked", BlobChunked, IBlob)
+
+BlobChunked::BlobChunked(ChunkStore* store, const DateTime& lastAccessed)
+:	m_store(store)
+,	m_lastAccessed(lastAccessed)
+{
+}
+
+BlobChunked::~BlobChunked()
+{
+	if (!m_manifestPath.empty())
+		FileSystem::getInstance().modify(m_manifestPath, nullptr, &m_lastAccessed, nullptr);
+}
+
+Ref< BlobChunked > BlobChunked::load(ChunkStore* store, const Path& manifestPath, const DateTime& lastAccessed)
+{
+	Ref< IStream > file = FileSystem::getInstance().open(manifestPath, File::FmRead);
+	if (!file)
+		return nullptr;
+
+	BufferedStream stream(file);
+
+	uint32_t header[2];
+	if (stream.read(header, sizeof(header)) != sizeof(header) || header[0] != c_manifestMagic)
+		return nullptr;
+
+	Ref< BlobChunked > blob = new BlobChunked(store, lastAccessed);
+	for (uint32_t i = 0; i < header[1]; ++i)
+	{
+		const Key key = Key::read(&stream);
+		uint32_t size = 0;
+		if (!key.valid() || stream.read(&size, sizeof(uint32_t)) != sizeof(uint32_t) || !store->acquire(key))
+		{
+			blob->remove();
+			return nullptr;
+		}
+		blob->addChunk(key, size);
+	}
+
+	stream.close();
+	blob->m_manifestPath = manifestPath;
+	return blob;
+}
+
+void BlobChunked::addChunk(const Key& key, uint32_t size)
+{
+	m_chunks.push_back({ key, size });
+	m_size += size;
+}
+
+bool BlobChunked::writeManifest(const Path& manifestPath)
+{
+	Ref< IStream > file = FileSystem::getInstance().open(manifestPath, File::FmWrite);
+	if (!file)
+		return false;
+
+	BufferedStream stream(file);
+
+	const uint32_t header[] = { c_manifestMagic, (uint32_t)m_chunks.size() };
+	if (stream.write(header, sizeof(header)) != sizeof(header))
+		return false;
+
+	for (const auto& chunk : m_chunks)
+	{
+		if (!chunk.key.write(&stream))
+			return false;
+		if (stream.write(&chunk.size, sizeof(uint32_t)) != sizeof(uint32_t))
+			return false;
+	}
+
+	stream.close();
+	m_manifestPath = manifestPath;
+	return true;
+}
+
+bool BlobChunked::moveManifest(const Path& manifestPath)
+{
+	if (m_manifestPath.empty())
+		return false;
+	if (!FileSystem::getInstance().move(manifestPath, m_manifestPath, true))
+		return false;
+	m_manifestPath = manifestPath;
+	return true;
+}
+
+int64_t BlobChunked::size() const
+{
+	return m_size;
+}
+
+Ref< IStream > BlobChunked::append()
+{
+	return nullptr;
+}
+
+Ref< IStream > BlobChunked::read() const
+{
+	m_lastAccessed = DateTime::now();
+	return new ChunkedReadStream(m_store, m_chunks, m_size);
+}
+
+bool BlobChunked::remove()
+{
+	for (const auto& chunk : m_chunks)
+		m_store->release(chunk.key);
+	m_chunks.clear();
+	m_size = 0;
+
+	if (!m_manifestPath.empty())
+	{
+		const bool result = FileSystem::getInstance().remove(m_manifestPath);
+		m_manifestPath = Path();
+		return result;
+	}
+
+	return true;
+}
+
+bool BlobChunked::touch()
+{
+	m_lastAccessed = DateTime::now();
+	return true;
+}
+
+DateTime BlobChunked::lastAccessed() const
+{
+	return m_lastAccessed;
+}
+
+}
@@ -0,0 +1,88 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Avalanche/IBlob.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/Path.h"
+#include "Core/Misc/Key.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_AVALANCHE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::avalanche
+{
+
+class ChunkStore;
+
+/*! Blob composed of chunks in a chunk store.
+ * \ingroup Avalanche
+ *
+ * Blob only keep a manifest of it's chunks, content is
+ * read from the chunk store. A blob hold a reference
+ * to each of it's chunks until removed.
+ */
+class T_DLLCLASS BlobChunked : public IBlob
+{
+	T_RTTI_CLASS;
+
+public:
+	struct ChunkRef
+	{
+		Key key;
+		uint32_t size;
+	};
+
+	explicit BlobChunked(ChunkStore* store, const DateTime& lastAccessed);
+
+	virtual ~BlobChunked();
+
+	/*! Load blob from manifest file, referencing all chunks.
+	 *
+	 * \return Blob, null if manifest is invalid or chunks are missing.
+	 */
+	static Ref< BlobChunked > load(ChunkStore* store, const Path& manifestPath, const DateTime& lastAccessed);
+
+	/*! Add chunk to end of blob, chunk must already be referenced. */
+	void addChunk(const Key& key, uint32_t size);
+
+	/*! Write manifest file, blob remove manifest when removed. */
+	bool writeManifest(const Path& manifestPath);
+
+	/*! Move written manifest file to new path. */
+	bool moveManifest(const Path& manifestPath);
+
+	const AlignedVector< ChunkRef >& getChunks() const { return m_chunks; }
+
+	virtual int64_t size() const override final;
+
+	virtual Ref< IStream > append() override final;
+
+	virtual Ref< IStream > read() const override final;
+
+	virtual bool remove() override final;
+
+	virtual bool touch() override final;
+
+	virtual DateTime lastAccessed() const override final;
+
+private:
+	Ref< ChunkStore > m_store;
+	AlignedVector< ChunkRef > m_chunks;
+	int64_t m_size = 0;
+	Path m_manifestPath;
+	mutable DateTime m_lastAccessed;
+};
+
+}
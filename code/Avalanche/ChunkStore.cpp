@@ -0,0 +1,190 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Avalanche/BlobFile.h"
+#include "Avalanche/BlobMemory.h"
+#include "Avalanche/ChunkStore.h"
+#include "Core/Guid.h"
+#include "Core/Io/File.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Thread/Acquire.h"
+
+namespace traktor::avalanche
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.avalanche.ChunkStore", ChunkStore, Object)
+
+bool ChunkStore::create(const Path& chunksPath)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	if (!chunksPath.empty())
+	{
+		if (!FileSystem::getInstance().makeAllDirectories(chunksPath))
+			return false;
+
+		// Remove chunks which wasn't completely written.
+		RefArray< File > putFiles = FileSystem::getInstance().find(chunksPath.getPathName() + L"/*.put");
+		for (auto putFile : putFiles)
+			FileSystem::getInstance().remove(putFile->getPath());
+
+		// Chunks are unreferenced until blobs referencing them are loaded.
+		RefArray< File > chunkFiles = FileSystem::getInstance().find(chunksPath.getPathName() + L"/*.chunk");
+		for (auto chunkFile : chunkFiles)
+		{
+			const Key chunkKey = Key::parse(chunkFile->getPath().getFileNameNoExtension());
+			if (!chunkKey.valid())
+				continue;
+
+			Chunk& chunk = m_chunks[chunkKey];
+			chunk.blob = new BlobFile(chunkFile->getPath(), chunkFile->getSize(), chunkFile->getLastAccessTime());
+			m_chunkUsage += chunkFile->getSize();
+		}
+
+		log::info << L"Loaded " << (uint32_t)m_chunks.size() << L" chunks." << Endl;
+	}
+
+	m_chunksPath = chunksPath;
+	return true;
+}
+
+bool ChunkStore::acquire(const Key& key)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	auto it = m_chunks.find(key);
+	if (it == m_chunks.end())
+		return false;
+	it->second.references++;
+	return true;
+}
+
+bool ChunkStore::put(const Key& key, const void* data, uint32_t size)
+{
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		auto it = m_chunks.find(key);
+		if (it != m_chunks.end())
+		{
+			it->second.references++;
+			return true;
+		}
+	}
+
+	// Write chunk outside of lock, to a unique file so concurrent puts of same chunk don't collide.
+	Ref< IBlob > blob;
+	Path temporaryPath;
+	if (!m_chunksPath.empty())
+	{
+		temporaryPath = m_chunksPath.getPathName() + L"/" + key.format() + L"." + Guid::create().format() + L".put";
+		Ref< BlobFile > bf = new BlobFile(temporaryPath, size, DateTime::now());
+		Ref< MemoryStream > source = new MemoryStream(data, size);
+		if (!bf->create(source))
+		{
+			log::error << L"[CHUNK " << key.format() << L"] Unable to write chunk to disk." << Endl;
+			return false;
+		}
+		blob = bf;
+	}
+	else
+	{
+		blob = new BlobMemory();
+		Ref< IStream > stream = blob->append();
+		if (!stream || stream->write(data, size) != size)
+			return false;
+		stream->close();
+	}
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	// Chunk might have been added by another put while writing.
+	auto it = m_chunks.find(key);
+	if (it != m_chunks.end())
+	{
+		it->second.references++;
+		blob->remove();
+		return true;
+	}
+
+	if (!temporaryPath.empty())
+	{
+		const Path chunkPath = m_chunksPath.getPathName() + L"/" + key.format() + L".chunk";
+		if (!FileSystem::getInstance().move(chunkPath, temporaryPath, true))
+		{
+			log::error << L"[CHUNK " << key.format() << L"] Unable to move chunk into place." << Endl;
+			blob->remove();
+			return false;
+		}
+		blob = new BlobFile(chunkPath, size, DateTime::now());
+	}
+
+	Chunk& chunk = m_chunks[key];
+	chunk.blob = blob;
+	chunk.references = 1;
+	m_chunkUsage += size;
+	return true;
+}
+
+void ChunkStore::release(const Key& key)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	auto it = m_chunks.find(key);
+	if (it == m_chunks.end())
+		return;
+
+	if (--it->second.references > 0)
+		return;
+
+	m_chunkUsage -= it->second.blob->size();
+	it->second.blob->remove();
+	m_chunks.erase(it);
+}
+
+Ref< IStream > ChunkStore::read(const Key& key) const
+{
+	Ref< IBlob > blob;
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		auto it = m_chunks.find(key);
+		if (it == m_chunks.end())
+			return nullptr;
+		blob = it->second.blob;
+	}
+	return blob->read();
+}
+
+uint32_t ChunkStore::collect()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	uint32_t removed = 0;
+	for (auto it = m_chunks.begin(); it != m_chunks.end(); )
+	{
+		if (it->second.references <= 0)
+		{
+			m_chunkUsage -= it->second.blob->size();
+			it->second.blob->remove();
+			it = m_chunks.erase(it);
+			removed++;
+		}
+		else
+			++it;
+	}
+	return removed;
+}
+
+void ChunkStore::getStats(uint32_t& outChunkCount, uint64_t& outChunkUsage) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	outChunkCount = (uint32_t)m_chunks.size();
+	outChunkUsage = m_chunkUsage;
+}
+
+}
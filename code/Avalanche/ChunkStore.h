@@ -0,0 +1,92 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <map>
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Io/Path.h"
+#include "Core/Misc/Key.h"
+#include "Core/Thread/Semaphore.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_AVALANCHE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class IStream;
+
+}
+
+namespace traktor::avalanche
+{
+
+class IBlob;
+
+/*! Reference counted store of content defined chunks.
+ * \ingroup Avalanche
+ *
+ * Each unique chunk is only stored once, shared by
+ * all chunked blobs referencing it. A chunk is removed
+ * when the last blob referencing it is removed.
+ */
+class T_DLLCLASS ChunkStore : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	/*! Create chunk store.
+	 *
+	 * \param chunksPath Path to chunk files, if empty then chunks are only kept in memory.
+	 * \return True if store created.
+	 */
+	bool create(const Path& chunksPath);
+
+	/*! Add reference to existing chunk.
+	 *
+	 * \return False if chunk doesn't exist.
+	 */
+	bool acquire(const Key& key);
+
+	/*! Add chunk, or reference to chunk if already stored. */
+	bool put(const Key& key, const void* data, uint32_t size);
+
+	/*! Release reference to chunk, chunk is removed when no longer referenced. */
+	void release(const Key& key);
+
+	Ref< IStream > read(const Key& key) const;
+
+	/*! Remove chunks not referenced by any blob.
+	 *
+	 * \return Number of chunks removed.
+	 */
+	uint32_t collect();
+
+	void getStats(uint32_t& outChunkCount, uint64_t& outChunkUsage) const;
+
+private:
+	struct Chunk
+	{
+		Ref< IBlob > blob;
+		int32_t references = 0;
+	};
+
+	mutable Semaphore m_lock;
+	Path m_chunksPath;
+	std::map< Key, Chunk > m_chunks;
+	uint64_t m_chunkUsage = 0;
+};
+
+}
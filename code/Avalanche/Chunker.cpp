@@ -0,0 +1,82 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Avalanche/Chunker.h"
+#include "Core/Misc/MD5.h"
+
+namespace traktor::avalanche
+{
+	namespace
+	{
+
+// Normalized chunking; harder to find a boundary before average size and easier after.
+const uint64_t c_maskSmall = 0x0003590703530000ULL;	// 15 bits set.
+const uint64_t c_maskLarge = 0x0000d90003530000ULL;	// 11 bits set.
+
+struct GearTable
+{
+	uint64_t gear[256];
+
+	GearTable()
+	{
+		// Table must be identical on all clients and servers, thus generated from a fixed seed.
+		uint64_t x = 0x9e3779b97f4a7c15ULL;
+		for (int32_t i = 0; i < 256; ++i)
+		{
+			x += 0x9e3779b97f4a7c15ULL;
+			uint64_t z = x;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			gear[i] = z ^ (z >> 31);
+		}
+	}
+};
+
+const GearTable c_gearTable;
+
+	}
+
+uint32_t Chunker::next(const uint8_t* data, uint32_t size)
+{
+	if (size <= c_minSize)
+		return size;
+
+	const uint32_t limit = std::min(size, c_maxSize);
+	const uint32_t normal = std::min(limit, c_avgSize);
+	const uint64_t* gear = c_gearTable.gear;
+	uint64_t h = 0;
+	uint32_t i = c_minSize;
+
+	for (; i < normal; ++i)
+	{
+		h = (h << 1) + gear[data[i]];
+		if ((h & c_maskSmall) == 0)
+			return i;
+	}
+	for (; i < limit; ++i)
+	{
+		h = (h << 1) + gear[data[i]];
+		if ((h & c_maskLarge) == 0)
+			return i;
+	}
+
+	return limit;
+}
+
+Key Chunker::hash(const uint8_t* data, uint32_t size)
+{
+	MD5 md5;
+	md5.begin();
+	md5.feedBuffer(data, size);
+	md5.end();
+	const uint32_t* h = md5.get();
+	return Key(h[0], h[1], h[2], h[3]);
+}
+
+}
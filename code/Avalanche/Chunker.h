@@ -0,0 +1,52 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Config.h"
+#include "Core/Misc/Key.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_AVALANCHE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::avalanche
+{
+
+/*! Content defined chunking.
+ * \ingroup Avalanche
+ *
+ * Blobs are split at positions determined by a rolling
+ * gear hash of the content, so an insertion or removal
+ * only affect chunks near the modification while the
+ * remaining chunks keep their keys.
+ */
+class T_DLLCLASS Chunker
+{
+public:
+	constexpr static uint32_t c_minSize = 2 * 1024;
+	constexpr static uint32_t c_avgSize = 8 * 1024;
+	constexpr static uint32_t c_maxSize = 64 * 1024;
+
+	/*! Find end of first chunk.
+	 *
+	 * \param data Pointer to data.
+	 * \param size Size of data in bytes.
+	 * \return Size of first chunk, equal to size if no boundary is found within data.
+	 */
+	static uint32_t next(const uint8_t* data, uint32_t size);
+
+	/*! Calculate key of chunk from it's content. */
+	static Key hash(const uint8_t* data, uint32_t size);
+};
+
+}
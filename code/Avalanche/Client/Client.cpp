@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Io/DynamicMemoryStream.h"
 #include "Core/Log/Log.h"
 #include "Core/Thread/Acquire.h"
 #include "Avalanche/Protocol.h"
@@ -17,6 +18,12 @@
 
 namespace traktor::avalanche
 {
+	namespace
+	{
+
+const uint32_t c_maxBatchesInFlight = 4;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.avalanche.Client", Client, Object)
 
@@ -89,6 +96,54 @@ bool Client::have(const Key& key)
 	return reply == c_replyOk;
 }
 
+bool Client::stat(const AlignedVector< Key >& keys, AlignedVector< int64_t >& outSizes)
+{
+	outSizes.resize(keys.size(), -1);
+	if (keys.empty())
+		return true;
+
+	Ref< net::SocketStream > stream = establish(c_commandStatBatch);
+	if (!stream)
+		return false;
+
+	const uint32_t batchCount = (uint32_t)((keys.size() + c_maxBatchKeys - 1) / c_maxBatchKeys);
+	uint32_t sent = 0;
+
+	for (uint32_t received = 0; received < batchCount; ++received)
+	{
+		// Keep several batches in flight so server always have requests queued.
+		for (; sent < batchCount && sent < received + c_maxBatchesInFlight; ++sent)
+		{
+			if (!writeBatch(stream, sent > 0 ? c_commandStatBatch : 0, keys, sent))
+			{
+				log::error << L"Unable to write keys to server (stat)." << Endl;
+				return false;
+			}
+		}
+
+		uint8_t reply = 0;
+		if (stream->read(&reply, sizeof(uint8_t)) != sizeof(uint8_t) || reply != c_replyOk)
+		{
+			log::error << L"Unable to read reply from server (stat)." << Endl;
+			return false;
+		}
+
+		const uint32_t offset = received * c_maxBatchKeys;
+		const uint32_t count = std::min< uint32_t >((uint32_t)keys.size() - offset, c_maxBatchKeys);
+		if (stream->read(&outSizes[offset], count * sizeof(int64_t)) != (int64_t)(count * sizeof(int64_t)))
+		{
+			log::error << L"Unable to read blob sizes from server (stat)." << Endl;
+			return false;
+		}
+	}
+
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		m_streams.push_back(stream);
+	}
+	return true;
+}
+
 bool Client::touch(const AlignedVector< Key >& keys)
 {
 	Ref< net::SocketStream > stream  = establish(c_commandTouch);
@@ -206,6 +261,75 @@ Ref< IStream > Client::get(const Key& key)
 	return new ClientGetStream(this, stream, blobSize);
 }
 
+bool Client::get(const AlignedVector< Key >& keys, const std::function< void (uint32_t index, IStream* stream) >& fn)
+{
+	if (keys.empty())
+		return true;
+
+	Ref< net::SocketStream > stream = establish(c_commandGetBatch);
+	if (!stream)
+		return false;
+
+	const uint32_t batchCount = (uint32_t)((keys.size() + c_maxBatchKeys - 1) / c_maxBatchKeys);
+	uint32_t sent = 0;
+
+	for (uint32_t received = 0; received < batchCount; ++received)
+	{
+		// Keep several batches in flight so server always have requests queued.
+		for (; sent < batchCount && sent < received + c_maxBatchesInFlight; ++sent)
+		{
+			if (!writeBatch(stream, sent > 0 ? c_commandGetBatch : 0, keys, sent))
+			{
+				log::error << L"Unable to write keys to server (get)." << Endl;
+				return false;
+			}
+		}
+
+		const uint32_t offset = received * c_maxBatchKeys;
+		const uint32_t count = std::min< uint32_t >((uint32_t)keys.size() - offset, c_maxBatchKeys);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			uint8_t reply = 0;
+			if (stream->read(&reply, sizeof(uint8_t)) != sizeof(uint8_t))
+			{
+				log::error << L"Unable to read reply from server (get)." << Endl;
+				return false;
+			}
+
+			if (reply != c_replyOk)
+			{
+				fn(offset + i, nullptr);
+				continue;
+			}
+
+			int64_t blobSize = 0;
+			if (stream->read(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
+			{
+				log::error << L"Unable to read blob size from server (get)." << Endl;
+				return false;
+			}
+
+			// Blob stream doesn't return connection; ensure entire blob
+			// is consumed so next reply can be read.
+			Ref< ClientGetStream > blobStream = new ClientGetStream(nullptr, stream, blobSize);
+			fn(offset + i, blobStream);
+			blobStream->close();
+
+			if (blobStream->available() > 0)
+			{
+				log::error << L"Unable to read blob from server (get)." << Endl;
+				return false;
+			}
+		}
+	}
+
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		m_streams.push_back(stream);
+	}
+	return true;
+}
+
 Ref< IStream > Client::put(const Key& key)
 {
 	Ref< net::SocketStream > stream = establish(c_commandPut);
@@ -248,6 +372,20 @@ bool Client::stats(Dictionary::Stats& outStats)
 		return false;
 	if (stream->read(&outStats.memoryUsage, sizeof(uint64_t)) != sizeof(uint64_t))
 		return false;
+	if (stream->read(&outStats.residentUsage, sizeof(uint64_t)) != sizeof(uint64_t))
+		return false;
+	if (stream->read(&outStats.hits, sizeof(uint64_t)) != sizeof(uint64_t))
+		return false;
+	if (stream->read(&outStats.misses, sizeof(uint64_t)) != sizeof(uint64_t))
+		return false;
+	if (stream->read(&outStats.evictions, sizeof(uint64_t)) != sizeof(uint64_t))
+		return false;
+	if (stream->read(&outStats.spills, sizeof(uint64_t)) != sizeof(uint64_t))
+		return false;
+	if (stream->read(&outStats.chunkCount, sizeof(uint32_t)) != sizeof(uint32_t))
+		return false;
+	if (stream->read(&outStats.chunkUsage, sizeof(uint64_t)) != sizeof(uint64_t))
+		return false;
 
 	{
 		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
@@ -306,6 +444,9 @@ Ref< net::SocketStream > Client::establish(uint8_t command)
 		return nullptr;
 	}
 
+	// Requests are written in several small writes, do not delay sending those.
+	socket->setNoDelay(true);
+
 	Ref< net::SocketStream > stream = new net::SocketStream(socket, true, true, 5000);
 	if (stream->write(&command, sizeof(uint8_t)) != sizeof(uint8_t))
 	{
@@ -316,4 +457,22 @@ Ref< net::SocketStream > Client::establish(uint8_t command)
 	return stream;
 }
 
+bool Client::writeBatch(net::SocketStream* stream, uint8_t command, const AlignedVector< Key >& keys, uint32_t batch) const
+{
+	const uint32_t offset = batch * c_maxBatchKeys;
+	const uint32_t count = std::min< uint32_t >((uint32_t)keys.size() - offset, c_maxBatchKeys);
+
+	// Gather entire request so it's sent using a single write.
+	AlignedVector< uint8_t > request;
+	DynamicMemoryStream ms(request, false, true);
+
+	if (command != 0)
+		ms.write(&command, sizeof(uint8_t));
+	ms.write(&count, sizeof(uint32_t));
+	for (uint32_t i = 0; i < count; ++i)
+		keys[offset + i].write(&ms);
+
+	return stream->write(request.c_ptr(), request.size()) == (int64_t)request.size();
+}
+
 }
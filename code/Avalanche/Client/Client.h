@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <functional>
 #include "Avalanche/Dictionary.h"
 #include "Core/Object.h"
 #include "Core/Ref.h"
@@ -46,12 +47,34 @@ public:
 
 	bool have(const Key& key);
 
+	/*! Get size of multiple blobs.
+	 *
+	 * Keys are sent in batches, several batches are in
+	 * flight on the connection at the same time.
+	 *
+	 * \param keys Blob keys.
+	 * \param outSizes Size of each blob, -1 if blob doesn't exist.
+	 * \return True if sizes received.
+	 */
+	bool stat(const AlignedVector< Key >& keys, AlignedVector< int64_t >& outSizes);
+
 	bool touch(const AlignedVector< Key >& keys);
 
 	bool evict(const AlignedVector< Key >& keys);
 
 	Ref< IStream > get(const Key& key);
 
+	/*! Get multiple blobs.
+	 *
+	 * Keys are sent in batches, several batches are in
+	 * flight on the connection at the same time.
+	 *
+	 * \param keys Blob keys.
+	 * \param fn Called, in key order, with stream of blob or null if blob doesn't exist; stream is only valid during call.
+	 * \return True if all replies received.
+	 */
+	bool get(const AlignedVector< Key >& keys, const std::function< void (uint32_t index, IStream* stream) >& fn);
+
 	Ref< IStream > put(const Key& key);
 
 	bool stats(Dictionary::Stats& outStats);
@@ -69,6 +92,8 @@ private:
 	Semaphore m_lock;
 
 	Ref< net::SocketStream > establish(uint8_t command);
+
+	bool writeBatch(net::SocketStream* stream, uint8_t command, const AlignedVector< Key >& keys, uint32_t batch) const;
 };
 
 }
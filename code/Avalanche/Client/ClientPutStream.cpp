@@ -6,9 +6,12 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include "Avalanche/Chunker.h"
 #include "Avalanche/Protocol.h"
 #include "Avalanche/Client/Client.h"
 #include "Avalanche/Client/ClientPutStream.h"
+#include "Core/Io/DynamicMemoryStream.h"
 #include "Core/Io/Reader.h"
 #include "Core/Io/Writer.h"
 #include "Core/Thread/Acquire.h"
@@ -16,6 +19,12 @@
 
 namespace traktor::avalanche
 {
+	namespace
+	{
+
+const size_t c_flushSize = 1 * 1024 * 1024;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.avalanche.ClientPutStream", ClientPutStream, IStream)
 
@@ -30,6 +39,12 @@ void ClientPutStream::close()
 	if (!m_stream)
 		return;
 
+	if (!sendChunks(true))
+	{
+		m_stream = nullptr;
+		return;
+	}
+
 	const uint8_t cmd = c_subCommandPutCommit;
 	if (m_stream->write(&cmd, sizeof(uint8_t)) != sizeof(uint8_t))
 	{
@@ -96,21 +111,14 @@ int64_t ClientPutStream::write(const void* block, int64_t nbytes)
 	if (nbytes <= 0)
 		return 0;
 
-	const uint8_t cmd = c_subCommandPutAppend;
-	if (m_stream->write(&cmd, sizeof(uint8_t)) != sizeof(uint8_t))
-	{
-		m_stream = nullptr;
-		return -1;
-	}
-	if (m_stream->write(&nbytes, sizeof(int64_t)) != sizeof(int64_t))
-	{
-		m_stream = nullptr;
-		return -1;
-	}
-	if (m_stream->write(block, nbytes) != nbytes)
+	m_buffer.insert(m_buffer.end(), (const uint8_t*)block, (const uint8_t*)block + nbytes);
+	if (m_buffer.size() >= c_flushSize)
 	{
-		m_stream = nullptr;
-		return -1;
+		if (!sendChunks(false))
+		{
+			m_stream = nullptr;
+			return -1;
+		}
 	}
 
 	return nbytes;
@@ -120,4 +128,74 @@ void ClientPutStream::flush()
 {
 }
 
+bool ClientPutStream::sendChunks(bool final)
+{
+	const uint8_t* data = m_buffer.c_ptr();
+	const uint32_t size = (uint32_t)m_buffer.size();
+
+	// Split buffered data into chunks; unless final, keep tail which
+	// might be extended by further writes.
+	AlignedVector< uint32_t > offsets;
+	uint32_t offset = 0;
+	while (offset < size)
+	{
+		const uint32_t remaining = size - offset;
+		if (!final && remaining < Chunker::c_maxSize)
+			break;
+		offsets.push_back(offset);
+		offset += Chunker::next(data + offset, remaining);
+	}
+	offsets.push_back(offset);
+
+	const uint32_t nchunks = (uint32_t)offsets.size() - 1;
+	for (uint32_t batch = 0; batch < nchunks; batch += c_maxBatchKeys)
+	{
+		const uint32_t count = std::min(nchunks - batch, c_maxBatchKeys);
+
+		// Gather manifest of chunks, each chunk is key followed by size, so it's sent using a single write.
+		AlignedVector< uint8_t > request;
+		DynamicMemoryStream ms(request, false, true);
+
+		ms.write(&c_subCommandPutChunks, sizeof(uint8_t));
+		ms.write(&count, sizeof(uint32_t));
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t chunkOffset = offsets[batch + i];
+			const uint32_t chunkSize = offsets[batch + i + 1] - chunkOffset;
+			Chunker::hash(data + chunkOffset, chunkSize).write(&ms);
+			ms.write(&chunkSize, sizeof(uint32_t));
+		}
+
+		if (m_stream->write(request.c_ptr(), request.size()) != (int64_t)request.size())
+			return false;
+
+		// Server reply with index of chunks it doesn't have.
+		uint8_t reply = 0;
+		if (m_stream->read(&reply, sizeof(uint8_t)) != sizeof(uint8_t) || reply != c_replyOk)
+			return false;
+
+		uint32_t nmissing = 0;
+		if (m_stream->read(&nmissing, sizeof(uint32_t)) != sizeof(uint32_t) || nmissing > count)
+			return false;
+
+		AlignedVector< uint32_t > missing(nmissing);
+		if (nmissing > 0 && m_stream->read(missing.ptr(), nmissing * sizeof(uint32_t)) != (int64_t)(nmissing * sizeof(uint32_t)))
+			return false;
+
+		for (auto index : missing)
+		{
+			if (index >= count)
+				return false;
+
+			const uint32_t chunkOffset = offsets[batch + index];
+			const uint32_t chunkSize = offsets[batch + index + 1] - chunkOffset;
+			if (m_stream->write(data + chunkOffset, chunkSize) != chunkSize)
+				return false;
+		}
+	}
+
+	m_buffer.erase(m_buffer.begin(), m_buffer.begin() + offset);
+	return true;
+}
+
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Io/IStream.h"
 
 namespace traktor::net
@@ -23,6 +24,12 @@ namespace traktor::avalanche
 
 class Client;
 
+/*! Put stream, splitting blob into content defined chunks.
+ * \ingroup Avalanche
+ *
+ * Written data is buffered and split into chunks; only
+ * chunks which the server doesn't already have are sent.
+ */
 class ClientPutStream : public IStream
 {
 	T_RTTI_CLASS;
@@ -53,6 +60,9 @@ public:
 private:
 	Ref< Client > m_client;
 	Ref< net::SocketStream > m_stream;
+	AlignedVector< uint8_t > m_buffer;
+
+	bool sendChunks(bool final);
 };
 
 }
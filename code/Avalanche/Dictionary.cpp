@@ -7,11 +7,17 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <algorithm>
+#include "Avalanche/BlobChunked.h"
 #include "Avalanche/BlobFile.h"
 #include "Avalanche/BlobMemory.h"
+#include "Avalanche/ChunkStore.h"
 #include "Avalanche/Dictionary.h"
+#include "Core/Guid.h"
+#include "Core/Io/File.h"
 #include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
 #include "Core/Log/Log.h"
+#include "Core/Misc/String.h"
 #include "Core/Thread/Acquire.h"
 
 namespace traktor::avalanche
@@ -19,7 +25,12 @@ namespace traktor::avalanche
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.avalanche.Dictionary", Dictionary, Object)
 
-bool Dictionary::create(const Path& blobsPath)
+Dictionary::Dictionary()
+:	m_chunkStore(new ChunkStore())
+{
+}
+
+bool Dictionary::create(const Path& blobsPath, uint64_t residentBudget)
 {
 	if (!blobsPath.empty())
 	{
@@ -28,7 +39,22 @@ bool Dictionary::create(const Path& blobsPath)
 		if (!FileSystem::getInstance().makeAllDirectories(blobsPath))
 			return false;
 
+		if (!m_chunkStore->create(blobsPath.getPathName() + L"/Chunks"))
+			return false;
+
+		// Remove blobs from puts which never completed.
+		RefArray< File > putFiles = FileSystem::getInstance().find(blobsPath.getPathName() + L"/*.put");
+		for (auto putFile : putFiles)
+			FileSystem::getInstance().remove(putFile->getPath());
+
 		RefArray< File > blobFiles = FileSystem::getInstance().find(blobsPath.getPathName() + L"/*.blob");
+		RefArray< File > manifestFiles = FileSystem::getInstance().find(blobsPath.getPathName() + L"/*.manifest");
+		blobFiles.insert(blobFiles.end(), manifestFiles.begin(), manifestFiles.end());
+
+		// Most recently accessed first, so blobs are inserted into LRU in order.
+		blobFiles.sort([](const File* lh, const File* rh) {
+			return lh->getLastAccessTime() > rh->getLastAccessTime();
+		});
 
 		log::info << L"Loading " << blobFiles.size() << L" blobs..." << Endl;
 		for (auto blobFile : blobFiles)
@@ -39,31 +65,95 @@ bool Dictionary::create(const Path& blobsPath)
 			if (!blobKey.valid())
 				continue;
 
-			Ref< BlobFile > blob = new BlobFile(blobFile->getPath(), blobFile->getSize(), blobFile->getLastAccessTime());
-			m_blobs[blobKey] = blob;
-			m_stats.blobCount++;
-			m_stats.memoryUsage += blob->size();
+			Shard& shard = getShard(blobKey);
+			if (shard.blobs.find(blobKey) != shard.blobs.end())
+				continue;
+
+			Ref< IBlob > blob;
+			if (compareIgnoreCase(blobFile->getPath().getExtension(), L"manifest") == 0)
+			{
+				if ((blob = BlobChunked::load(m_chunkStore, blobFile->getPath(), blobFile->getLastAccessTime())) == nullptr)
+				{
+					log::warning << L"Unable to load manifest of blob " << blobFileName << L"; blob removed." << Endl;
+					FileSystem::getInstance().remove(blobFile->getPath());
+					continue;
+				}
+			}
+			else
+				blob = new BlobFile(blobFile->getPath(), blobFile->getSize(), blobFile->getLastAccessTime());
+
+			Entry& entry = shard.blobs[blobKey];
+			entry.blob = blob;
+			entry.resident = false;
+			entry.lru = shard.spilledLru.insert(shard.spilledLru.end(), blobKey);
+
+			shard.stats.blobCount++;
+			shard.stats.memoryUsage += entry.blob->size();
+			m_memoryUsage += entry.blob->size();
 		}
+
+		// Remove chunks no longer referenced by any blob, e.g. from an interrupted put.
+		const uint32_t collected = m_chunkStore->collect();
+		if (collected > 0)
+			log::info << L"Removed " << collected << L" unreferenced chunks." << Endl;
 	}
 
 	m_blobsPath = blobsPath;
+	m_residentBudget = residentBudget;
 	return true;
 }
 
+void Dictionary::flush()
+{
+	if (m_blobsPath.empty())
+		return;
+
+	for (auto& shard : m_shards)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard.lock);
+		while (!shard.residentLru.empty())
+		{
+			const Key key = shard.residentLru.back();
+			spill(shard, shard.blobs[key], key);
+		}
+	}
+}
+
 Ref< IBlob > Dictionary::create() const
 {
 	return new BlobMemory();
 }
 
+Ref< BlobChunked > Dictionary::createChunked() const
+{
+	return new BlobChunked(m_chunkStore, DateTime::now());
+}
+
 Ref< IBlob > Dictionary::get(const Key& key, bool raw) const
 {
+	Shard& shard = getShard(key);
 	Ref< IBlob > blob;
 	{
-		T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lockBlobs);
-		auto it = m_blobs.find(key);
-		if (it == m_blobs.end())
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard.lock);
+		auto it = shard.blobs.find(key);
+		if (it == shard.blobs.end())
+		{
+			if (!raw)
+				shard.stats.misses++;
 			return nullptr;
-		blob = it->second;
+		}
+
+		// Raw access doesn't affect eviction order.
+		Entry& entry = it->second;
+		if (!raw)
+		{
+			lru_t& lru = entry.resident ? shard.residentLru : shard.spilledLru;
+			lru.splice(lru.begin(), lru, entry.lru);
+			entry.lastUsed = ++m_clock;
+			shard.stats.hits++;
+		}
+
+		blob = entry.blob;
 	}
 	if (!raw)
 	{
@@ -76,56 +166,160 @@ Ref< IBlob > Dictionary::get(const Key& key, bool raw) const
 
 bool Dictionary::put(const Key& key, IBlob* blob, bool raw)
 {
-	Ref< IBlob > dictionaryBlob;
+	Shard& shard = getShard(key);
+	const uint64_t size = blob->size();
 
-	// Create dictionary blob.
+	// Write blob, or manifest of chunked blob, through to disk before put return, thus an
+	// acknowledged put survive the server being terminated. It's written to a unique file
+	// first so concurrent puts of same key don't collide, and so removing the replaced
+	// blob doesn't remove it; it's moved into place when entry is replaced.
+	// Chunked blobs are already stored in chunk store, only manifest need to be written.
+	bool resident = true;
+	Ref< BlobChunked > chunked = dynamic_type_cast< BlobChunked* >(blob);
+	Ref< BlobFile > file;
+	Path temporaryPath;
 	if (!m_blobsPath.empty())
+		temporaryPath = m_blobsPath.getPathName() + L"/" + key.format() + L"." + Guid::create().format() + L".put";
+
+	if (chunked)
+	{
+		if (!temporaryPath.empty())
+		{
+			if (!chunked->writeManifest(temporaryPath))
+			{
+				log::error << L"[PUT " << key.format() << L"] Unable to write manifest to disk." << Endl;
+				FileSystem::getInstance().remove(temporaryPath);
+				return false;
+			}
+			resident = false;
+		}
+	}
+	else if (!temporaryPath.empty())
 	{
-		const Path blobPath = m_blobsPath.getPathName() + L"/" + key.format() + L".blob";
-		Ref< BlobFile > bf = new BlobFile(blobPath, blob->size(), DateTime::now());
-		if (!bf->create(blob->read()))
+		file = new BlobFile(temporaryPath, size, DateTime::now());
+
+		Ref< IStream > source = blob->read();
+		if (!source || !file->create(source))
+		{
+			log::error << L"[PUT " << key.format() << L"] Unable to write blob to disk." << Endl;
 			return false;
-		dictionaryBlob = bf;
+		}
+		source->close();
+		source = nullptr;
 	}
-	else
-		dictionaryBlob = blob;
 
-	// Store blob into dictionary.
+	// Store blob into dictionary, blob is kept in memory until spilled.
 	{
-		T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lockBlobs);
-		m_blobs[key] = dictionaryBlob;
-		m_stats.blobCount++;
-		m_stats.memoryUsage += dictionaryBlob->size();
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard.lock);
+
+		auto it = shard.blobs.find(key);
+		if (it != shard.blobs.end())
+		{
+			Entry& entry = it->second;
+			const uint64_t replacedSize = entry.blob->size();
+
+			entry.blob->remove();
+			if (entry.file)
+				entry.file->remove();
+
+			shard.stats.blobCount--;
+			shard.stats.memoryUsage -= replacedSize;
+			m_memoryUsage -= replacedSize;
+			if (entry.resident)
+			{
+				shard.stats.residentUsage -= replacedSize;
+				m_residentUsage -= replacedSize;
+				shard.residentLru.erase(entry.lru);
+			}
+			else
+				shard.spilledLru.erase(entry.lru);
+
+			shard.blobs.erase(it);
+		}
+
+		if (file)
+		{
+			const Path blobPath = m_blobsPath.getPathName() + L"/" + key.format() + L".blob";
+			if (!FileSystem::getInstance().move(blobPath, temporaryPath, true))
+			{
+				log::error << L"[PUT " << key.format() << L"] Unable to move blob into place." << Endl;
+				file->remove();
+				return false;
+			}
+			file = new BlobFile(blobPath, size, blob->lastAccessed());
+		}
+		else if (chunked && !temporaryPath.empty())
+		{
+			const Path manifestPath = m_blobsPath.getPathName() + L"/" + key.format() + L".manifest";
+			if (!chunked->moveManifest(manifestPath))
+			{
+				log::error << L"[PUT " << key.format() << L"] Unable to move manifest into place." << Endl;
+				chunked->remove();
+				return false;
+			}
+		}
+
+		Entry& entry = shard.blobs[key];
+		entry.blob = blob;
+		entry.file = file;
+		entry.resident = resident;
+		entry.lru = resident ? shard.residentLru.insert(shard.residentLru.begin(), key) : shard.spilledLru.insert(shard.spilledLru.begin(), key);
+		entry.lastUsed = ++m_clock;
+
+		shard.stats.blobCount++;
+		shard.stats.memoryUsage += size;
+		m_memoryUsage += size;
+		if (resident)
+		{
+			shard.stats.residentUsage += size;
+			m_residentUsage += size;
+		}
 	}
 
+	// Spill least recently used blobs if all shards together exceed resident budget.
+	spill(m_residentBudget);
+
 	// Invoke listeners.
 	if (!raw)
 	{
 		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lockListeners);
 		for (auto listener : m_listeners)
-			listener->dictionaryPut(key, dictionaryBlob);
+			listener->dictionaryPut(key, blob);
 	}
 	return true;
 }
 
 bool Dictionary::remove(const Key& key)
 {
+	Shard& shard = getShard(key);
 	{
-		T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lockBlobs);
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard.lock);
 
-		auto it = m_blobs.find(key);
-		if (it == m_blobs.end())
+		auto it = shard.blobs.find(key);
+		if (it == shard.blobs.end())
 			return false;
 
-		const uint64_t size = it->second->size();
+		Entry& entry = it->second;
+		const uint64_t size = entry.blob->size();
 
-		if (!it->second->remove())
+		if (!entry.blob->remove())
 			return false;
+		if (entry.file)
+			entry.file->remove();
 
-		m_stats.blobCount--;
-		m_stats.memoryUsage -= size;
+		shard.stats.blobCount--;
+		shard.stats.memoryUsage -= size;
+		m_memoryUsage -= size;
+		if (entry.resident)
+		{
+			shard.stats.residentUsage -= size;
+			m_residentUsage -= size;
+			shard.residentLru.erase(entry.lru);
+		}
+		else
+			shard.spilledLru.erase(entry.lru);
 
-		m_blobs.erase(it);
+		shard.blobs.erase(it);
 	}
 	{
 		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lockListeners);
@@ -135,12 +329,34 @@ bool Dictionary::remove(const Key& key)
 	return true;
 }
 
+uint32_t Dictionary::evict(uint64_t maxMemoryUsage)
+{
+	uint32_t evicted = 0;
+	while (m_memoryUsage > maxMemoryUsage)
+	{
+		Key key;
+		Shard* shard = findLeastRecentlyUsed(false, key);
+		if (!shard || !remove(key))
+			break;
+
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard->lock);
+			shard->stats.evictions++;
+		}
+		evicted++;
+	}
+	return evicted;
+}
+
 void Dictionary::snapshotKeys(AlignedVector< Key >& outKeys) const
 {
-	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lockBlobs);
-	outKeys.reserve(m_blobs.size());
-	for (auto it : m_blobs)
-		outKeys.push_back(it.first);
+	for (auto& shard : m_shards)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard.lock);
+		outKeys.reserve(outKeys.size() + shard.blobs.size());
+		for (const auto& it : shard.blobs)
+			outKeys.push_back(it.first);
+	}
 }
 
 void Dictionary::addListener(IListener* listener)
@@ -158,9 +374,94 @@ void Dictionary::removeListener(IListener* listener)
 
 bool Dictionary::getStats(Stats& outStats) const
 {
-	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lockBlobs);
-	outStats = m_stats;
+	outStats = Stats();
+	for (auto& shard : m_shards)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard.lock);
+		outStats.blobCount += shard.stats.blobCount;
+		outStats.memoryUsage += shard.stats.memoryUsage;
+		outStats.residentUsage += shard.stats.residentUsage;
+		outStats.hits += shard.stats.hits;
+		outStats.misses += shard.stats.misses;
+		outStats.evictions += shard.stats.evictions;
+		outStats.spills += shard.stats.spills;
+	}
+	m_chunkStore->getStats(outStats.chunkCount, outStats.chunkUsage);
 	return true;
 }
 
+Dictionary::Shard* Dictionary::findLeastRecentlyUsed(bool residentOnly, Key& outKey) const
+{
+	Shard* leastShard = nullptr;
+	uint64_t leastUsed = ~0ULL;
+
+	for (auto& shard : m_shards)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard.lock);
+		if (!shard.residentLru.empty())
+		{
+			const Key& key = shard.residentLru.back();
+			const uint64_t lastUsed = shard.blobs[key].lastUsed;
+			if (lastUsed < leastUsed)
+			{
+				leastShard = &shard;
+				leastUsed = lastUsed;
+				outKey = key;
+			}
+		}
+		if (!residentOnly && !shard.spilledLru.empty())
+		{
+			const Key& key = shard.spilledLru.back();
+			const uint64_t lastUsed = shard.blobs[key].lastUsed;
+			if (lastUsed < leastUsed)
+			{
+				leastShard = &shard;
+				leastUsed = lastUsed;
+				outKey = key;
+			}
+		}
+	}
+
+	return leastShard;
+}
+
+void Dictionary::spill(uint64_t maxResidentUsage)
+{
+	if (m_blobsPath.empty())
+		return;
+
+	// A shard may use more than it's share of resident budget as long
+	// as all shards together are within budget.
+	while (m_residentUsage > maxResidentUsage)
+	{
+		Key key;
+		Shard* shard = findLeastRecentlyUsed(true, key);
+		if (!shard)
+			break;
+
+		// Blob might have been touched, removed or spilled since it was found.
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(shard->lock);
+		auto it = shard->blobs.find(key);
+		if (it != shard->blobs.end() && it->second.resident)
+			spill(*shard, it->second, key);
+	}
+}
+
+void Dictionary::spill(Shard& shard, Entry& entry, const Key& key)
+{
+	// Resident blobs are already written to disk on put, spilling only drop the memory copy.
+	T_FATAL_ASSERT(entry.resident);
+	T_FATAL_ASSERT(entry.file);
+
+	shard.residentLru.erase(entry.lru);
+	shard.stats.residentUsage -= entry.blob->size();
+	shard.stats.spills++;
+	m_residentUsage -= entry.blob->size();
+
+	entry.blob = entry.file;
+	entry.file = nullptr;
+	entry.resident = false;
+	entry.lru = shard.spilledLru.insert(shard.spilledLru.begin(), key);
+}
+
 }
@@ -8,12 +8,13 @@
  */
 #pragma once
 
+#include <atomic>
+#include <list>
 #include "Core/Object.h"
 #include "Core/Ref.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Io/Path.h"
 #include "Core/Misc/Key.h"
-#include "Core/Thread/ReaderWriterLock.h"
 #include "Core/Thread/Semaphore.h"
 
 // import/export mechanism.
@@ -27,17 +28,45 @@
 namespace traktor::avalanche
 {
 
+class BlobChunked;
+class ChunkStore;
 class IBlob;
 
+/*! Blob dictionary.
+ * \ingroup Avalanche
+ *
+ * Blobs are distributed into shards by key hash, each
+ * shard with it's own lock and LRU lists.
+ *
+ * New blobs are written to disk before put return, so
+ * an acknowledged put survive the server being terminated,
+ * and also kept in memory to serve reads; when memory held
+ * by all shards exceed the resident budget the memory copy
+ * of least recently used blobs, of any shard, are dropped.
+ * Blob files are not synchronized to storage, thus blobs
+ * written shortly before an OS crash or power loss may be lost.
+ *
+ * Chunked blobs only keep a manifest of their chunks,
+ * the chunks are shared between blobs in a chunk store.
+ */
 class T_DLLCLASS Dictionary : public Object
 {
 	T_RTTI_CLASS;
 
 public:
+	constexpr static int32_t c_shardCount = 16;
+
 	struct Stats
 	{
 		uint32_t blobCount = 0;
-		uint64_t memoryUsage = 0;
+		uint64_t memoryUsage = 0;		//!< Size of all blobs.
+		uint64_t residentUsage = 0;		//!< Size of blobs kept in memory.
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;			//!< Blobs removed to meet budget.
+		uint64_t spills = 0;			//!< Blobs dropped from memory to meet resident budget.
+		uint32_t chunkCount = 0;		//!< Unique chunks in chunk store.
+		uint64_t chunkUsage = 0;		//!< Size of unique chunks.
 	};
 
 	struct IListener
@@ -49,16 +78,39 @@ public:
 		virtual void dictionaryRemove(const Key& key) = 0;
 	};
 
-	bool create(const Path& blobsPath);
+	Dictionary();
+
+	/*! Create dictionary.
+	 *
+	 * \param blobsPath Path to blob files, if empty then blobs are only kept in memory.
+	 * \param residentBudget Max number of bytes kept in memory, blobs beyond budget are only read from disk.
+	 * \return True if dictionary created.
+	 */
+	bool create(const Path& blobsPath, uint64_t residentBudget = ~0ULL);
+
+	/*! Drop memory copy of all blobs, blobs are only read from disk after flush. */
+	void flush();
 
 	Ref< IBlob > create() const;
 
+	/*! Create empty chunked blob, chunks are added from chunk store. */
+	Ref< BlobChunked > createChunked() const;
+
+	ChunkStore* getChunkStore() const { return m_chunkStore; }
+
 	Ref< IBlob > get(const Key& key, bool raw) const;
 
 	bool put(const Key& key, IBlob* blob, bool raw);
 
 	bool remove(const Key& key);
 
+	/*! Remove least recently used blobs until size of all blobs is below budget.
+	 *
+	 * \param maxMemoryUsage Max size of all blobs.
+	 * \return Number of blobs removed.
+	 */
+	uint32_t evict(uint64_t maxMemoryUsage);
+
 	void snapshotKeys(AlignedVector< Key >& outKeys) const;
 
 	void addListener(IListener* listener);
@@ -68,12 +120,46 @@ public:
 	bool getStats(Stats& outStats) const;
 
 private:
-	mutable ReaderWriterLock m_lockBlobs;
+	typedef std::list< Key > lru_t;
+
+	struct Entry
+	{
+		Ref< IBlob > blob;
+		Ref< IBlob > file;	//!< Blob written to disk, while resident blob is kept in memory.
+		bool resident = false;
+		lru_t::iterator lru;
+		uint64_t lastUsed = 0;
+	};
+
+	struct Shard
+	{
+		Semaphore lock;
+		SmallMap< Key, Entry > blobs;
+		lru_t residentLru;	//!< Blobs in memory, most recently used first.
+		lru_t spilledLru;	//!< Blobs on disk, most recently used first.
+		Stats stats;
+	};
+
 	mutable Semaphore m_lockListeners;
 	Path m_blobsPath;
-	SmallMap< Key, Ref< IBlob > > m_blobs;
+	Ref< ChunkStore > m_chunkStore;
+	uint64_t m_residentBudget = ~0ULL;
+	mutable std::atomic< uint64_t > m_clock = 0;	//!< Incremented on each use, to compare recency across shards and lists.
+	std::atomic< uint64_t > m_memoryUsage = 0;
+	std::atomic< uint64_t > m_residentUsage = 0;
+	mutable Shard m_shards[c_shardCount];
 	AlignedVector< IListener* > m_listeners;
-	Stats m_stats;
+
+	Shard& getShard(const Key& key) const { return m_shards[key.hash() & (c_shardCount - 1)]; }
+
+	/*! Find least recently used blob of all shards. */
+	Shard* findLeastRecentlyUsed(bool residentOnly, Key& outKey) const;
+
+	/*! Drop memory copy of least recently used blobs until resident usage of all shards is within budget. */
+	void spill(uint64_t maxResidentUsage);
+
+	/*! Drop memory copy of blob, shard must be locked. */
+	void spill(Shard& shard, Entry& entry, const Key& key);
 };
 
 }
@@ -25,9 +25,14 @@ constexpr static uint8_t c_commandStats			= 0x05;
 constexpr static uint8_t c_commandKeys			= 0x06;
 constexpr static uint8_t c_commandTouch			= 0x07;
 constexpr static uint8_t c_commandEvict			= 0x08;
+constexpr static uint8_t c_commandStatBatch		= 0x09;
+constexpr static uint8_t c_commandGetBatch		= 0x0a;
 
 constexpr static uint8_t c_subCommandPutAppend	= 0x41;
 constexpr static uint8_t c_subCommandPutCommit	= 0x42;
 constexpr static uint8_t c_subCommandPutDiscard	= 0x43;
+constexpr static uint8_t c_subCommandPutChunks	= 0x44;
+
+constexpr static uint32_t c_maxBatchKeys		= 1024;		//!< Max number of keys in a single batched command.
 
 }
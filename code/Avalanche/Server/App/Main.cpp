@@ -105,6 +105,8 @@ void WINAPI serviceMain(DWORD argc, TCHAR* argv[])
 		settings->setProperty< PropertyBoolean >(L"Avalanche.Master", cmdLine.hasOption('m', L"master"));
 		settings->setProperty< PropertyString >(L"Avalanche.Path", cmdLine.getOption('d', L"dictionary-path").getString());
 		settings->setProperty< PropertyInteger >(L"Avalanche.MemoryBudget", cmdLine.getOption('b', L"memory-budget").getInteger());
+		if (cmdLine.hasOption('r', L"resident-budget"))
+			settings->setProperty< PropertyInteger >(L"Avalanche.ResidentBudget", cmdLine.getOption('r', L"resident-budget").getInteger());
 
 		if (!net::Network::initialize())
 		{
@@ -276,6 +278,7 @@ int main(int argc, const char** argv)
 		log::info << L"    -p, --port             Port number (default 40001)." << Endl;
 		log::info << L"    -d, --dictionary-path  Path to dictionary blobs." << Endl;
 		log::info << L"    -b, --memory-budget    Memory budget in GiB (default 8)." << Endl;
+		log::info << L"    -r, --resident-budget  Resident memory budget in MiB (default 1024)." << Endl;
 #if defined(_WIN32)
 		log::info << L"    --install-service      Install as NT service." << Endl;
 		log::info << L"    --uninstall-service    Uninstall as NT service." << Endl;
@@ -368,6 +371,8 @@ int main(int argc, const char** argv)
 	settings->setProperty< PropertyBoolean >(L"Avalanche.Master", cmdLine.hasOption('m', L"master"));
 	settings->setProperty< PropertyString >(L"Avalanche.Path", cmdLine.getOption('d', L"dictionary-path").getString());
 	settings->setProperty< PropertyInteger >(L"Avalanche.MemoryBudget", cmdLine.getOption('b', L"memory-budget").getInteger());
+	if (cmdLine.hasOption('r', L"resident-budget"))
+		settings->setProperty< PropertyInteger >(L"Avalanche.ResidentBudget", cmdLine.getOption('r', L"resident-budget").getInteger());
 	if (!net::Network::initialize())
 	{
 		log::error << L"Unable to initialize networking." << Endl;
@@ -6,6 +6,10 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstring>
+#include "Avalanche/BlobChunked.h"
+#include "Avalanche/Chunker.h"
+#include "Avalanche/ChunkStore.h"
 #include "Avalanche/Dictionary.h"
 #include "Avalanche/IBlob.h"
 #include "Avalanche/Protocol.h"
@@ -19,6 +23,24 @@
 
 namespace traktor::avalanche
 {
+	namespace
+	{
+
+const size_t c_replyBufferSize = 64 * 1024;
+
+/*! Remove uncommitted blob when put is aborted, releasing any chunks referenced by blob. */
+struct UncommittedBlob
+{
+	Ref< IBlob > blob;
+
+	~UncommittedBlob()
+	{
+		if (blob)
+			blob->remove();
+	}
+};
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.avalanche.Connection", Connection, Object)
 
@@ -49,6 +71,7 @@ bool Connection::create(net::TcpSocket* clientSocket)
 		name = remoteAddress->getHostName();
 
 	clientSocket->setQuickAck(true);
+	clientSocket->setNoDelay(true);
 
 	auto fn = [=]()
 	{
@@ -185,17 +208,50 @@ bool Connection::process()
 				return true;
 			}
 
+			UncommittedBlob uncommitted;
 			Ref< IBlob > blob = m_dictionary->create();
 			if (blob)
 			{
 				if (m_clientStream->write(&c_replyOk, sizeof(uint8_t)) != sizeof(uint8_t))
 					return false;
 
+				uint32_t chunksTotal = 0;
+				uint32_t chunksReceived = 0;
+
 				for (;;)
 				{
 					const int32_t subcmd = m_clientSocket->recv();
-					if (subcmd == c_subCommandPutAppend)
+					if (subcmd == c_subCommandPutChunks)
 					{
+						// Blob is chunked, cannot be mixed with appended data.
+						if (!uncommitted.blob)
+						{
+							if (blob->size() > 0)
+							{
+								log::error << L"[PUT " << key.format() << L"] Cannot mix chunks and appended data; terminating connection." << Endl;
+								return false;
+							}
+							uncommitted.blob = blob = m_dictionary->createChunked();
+						}
+
+						uint32_t received = 0;
+						if (!readChunks(mandatory_non_null_type_cast< BlobChunked* >(blob), received))
+						{
+							log::error << L"[PUT " << key.format() << L"] Unable to receive chunks from client; terminating connection." << Endl;
+							return false;
+						}
+
+						chunksTotal = (uint32_t)mandatory_non_null_type_cast< BlobChunked* >(blob)->getChunks().size();
+						chunksReceived += received;
+					}
+					else if (subcmd == c_subCommandPutAppend)
+					{
+						if (uncommitted.blob)
+						{
+							log::error << L"[PUT " << key.format() << L"] Cannot mix chunks and appended data; terminating connection." << Endl;
+							return false;
+						}
+
 						int64_t chunkSize;
 						if (m_clientStream->read(&chunkSize, sizeof(int64_t)) != sizeof(int64_t))
 							return false;
@@ -219,7 +275,11 @@ bool Connection::process()
 					{
 						if (m_dictionary->put(key, blob, false))
 						{
-							log::info << L"[PUT " << key.format() << L"] Committed " << blob->size() << L" byte(s)." << Endl;
+							uncommitted.blob = nullptr;
+							if (chunksTotal > 0)
+								log::info << L"[PUT " << key.format() << L"] Committed " << blob->size() << L" byte(s), received " << chunksReceived << L" of " << chunksTotal << L" chunk(s)." << Endl;
+							else
+								log::info << L"[PUT " << key.format() << L"] Committed " << blob->size() << L" byte(s)." << Endl;
 							if (m_clientStream->write(&c_replyOk, sizeof(uint8_t)) != sizeof(uint8_t))
 								return false;
 						}
@@ -262,6 +322,20 @@ bool Connection::process()
 				return false;
 			if (m_clientStream->write(&stats.memoryUsage, sizeof(uint64_t)) != sizeof(uint64_t))
 				return false;
+			if (m_clientStream->write(&stats.residentUsage, sizeof(uint64_t)) != sizeof(uint64_t))
+				return false;
+			if (m_clientStream->write(&stats.hits, sizeof(uint64_t)) != sizeof(uint64_t))
+				return false;
+			if (m_clientStream->write(&stats.misses, sizeof(uint64_t)) != sizeof(uint64_t))
+				return false;
+			if (m_clientStream->write(&stats.evictions, sizeof(uint64_t)) != sizeof(uint64_t))
+				return false;
+			if (m_clientStream->write(&stats.spills, sizeof(uint64_t)) != sizeof(uint64_t))
+				return false;
+			if (m_clientStream->write(&stats.chunkCount, sizeof(uint32_t)) != sizeof(uint32_t))
+				return false;
+			if (m_clientStream->write(&stats.chunkUsage, sizeof(uint64_t)) != sizeof(uint64_t))
+				return false;
 		}
 		break;
 
@@ -363,6 +437,91 @@ bool Connection::process()
 		}
 		break;
 
+	case c_commandStatBatch:
+		{
+			AlignedVector< Key > keys;
+			if (!readKeys(keys))
+				return false;
+
+			// Reply with size of each blob, -1 if blob doesn't exist.
+			AlignedVector< uint8_t > reply(sizeof(uint8_t) + keys.size() * sizeof(int64_t));
+			reply[0] = c_replyOk;
+
+			int64_t* blobSizes = (int64_t*)&reply[sizeof(uint8_t)];
+			for (uint32_t i = 0; i < keys.size(); ++i)
+			{
+				Ref< const IBlob > blob = m_dictionary->get(keys[i], true);
+				const int64_t blobSize = blob ? blob->size() : -1;
+				std::memcpy(&blobSizes[i], &blobSize, sizeof(int64_t));
+			}
+
+			if (m_clientStream->write(reply.c_ptr(), reply.size()) != (int64_t)reply.size())
+				return false;
+		}
+		break;
+
+	case c_commandGetBatch:
+		{
+			AlignedVector< Key > keys;
+			if (!readKeys(keys))
+				return false;
+
+			// Small blobs are gathered into a single reply buffer to reduce number of sends.
+			AlignedVector< uint8_t > reply;
+			reply.reserve(c_replyBufferSize);
+
+			uint32_t nsent = 0;
+			for (const auto& key : keys)
+			{
+				Ref< const IBlob > blob = m_dictionary->get(key, false);
+				Ref< IStream > readStream = blob ? blob->read() : nullptr;
+				if (!readStream)
+				{
+					reply.push_back(c_replyFailure);
+					continue;
+				}
+
+				const int64_t blobSize = blob->size();
+				reply.push_back(c_replyOk);
+				reply.insert(reply.end(), (const uint8_t*)&blobSize, (const uint8_t*)&blobSize + sizeof(int64_t));
+
+				if (reply.size() + blobSize <= c_replyBufferSize)
+				{
+					const size_t offset = reply.size();
+					reply.resize(offset + (size_t)blobSize);
+					if (readStream->read(&reply[offset], blobSize) != blobSize)
+					{
+						log::error << L"[GET " << key.format() << L"] Unable to read " << blobSize << L" byte(s) from blob; terminating connection." << Endl;
+						return false;
+					}
+				}
+				else
+				{
+					if (m_clientStream->write(reply.c_ptr(), reply.size()) != (int64_t)reply.size())
+						return false;
+					reply.resize(0);
+
+					if (!StreamCopy(m_clientStream, readStream).execute(blobSize))
+					{
+						log::error << L"[GET " << key.format() << L"] Unable to send " << blobSize << L" byte(s) to client; terminating connection." << Endl;
+						return false;
+					}
+				}
+
+				readStream->close();
+				nsent++;
+			}
+
+			if (!reply.empty())
+			{
+				if (m_clientStream->write(reply.c_ptr(), reply.size()) != (int64_t)reply.size())
+					return false;
+			}
+
+			log::debug << L"[GET] Sent " << nsent << L" of " << (uint32_t)keys.size() << L" blobs." << Endl;
+		}
+		break;
+
 	default:
 		log::error << L"Invalid command from client; terminating connection." << Endl;
 		return false;
@@ -371,4 +530,130 @@ bool Connection::process()
 	return true;
 }
 
+bool Connection::readKeys(AlignedVector< Key >& outKeys)
+{
+	uint32_t nkeys;
+	if (m_clientStream->read(&nkeys, sizeof(uint32_t)) != sizeof(uint32_t))
+		return false;
+
+	if (nkeys > c_maxBatchKeys)
+	{
+		log::warning << L"Too many keys in batch; terminating connection." << Endl;
+		return false;
+	}
+
+	// Read all keys in one go, each key is four 32-bit words.
+	AlignedVector< uint32_t > kv(nkeys * 4);
+	if (nkeys > 0 && m_clientStream->read(kv.ptr(), kv.size() * sizeof(uint32_t)) != (int64_t)(kv.size() * sizeof(uint32_t)))
+		return false;
+
+	outKeys.resize(nkeys);
+	for (uint32_t i = 0; i < nkeys; ++i)
+	{
+		outKeys[i] = Key(kv[i * 4 + 0], kv[i * 4 + 1], kv[i * 4 + 2], kv[i * 4 + 3]);
+		if (!outKeys[i].valid())
+		{
+			log::warning << L"Failed to read key; terminating connection." << Endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Connection::readChunks(BlobChunked* blob, uint32_t& outReceived)
+{
+	ChunkStore* chunkStore = m_dictionary->getChunkStore();
+
+	uint32_t nchunks;
+	if (m_clientStream->read(&nchunks, sizeof(uint32_t)) != sizeof(uint32_t))
+		return false;
+
+	if (nchunks > c_maxBatchKeys)
+	{
+		log::warning << L"Too many chunks in batch." << Endl;
+		return false;
+	}
+
+	// Read manifest of chunks, each chunk is key followed by size.
+	AlignedVector< uint32_t > cv(nchunks * 5);
+	if (nchunks > 0 && m_clientStream->read(cv.ptr(), cv.size() * sizeof(uint32_t)) != (int64_t)(cv.size() * sizeof(uint32_t)))
+		return false;
+
+	// Reference chunks already in store, reply with index of those missing.
+	AlignedVector< BlobChunked::ChunkRef > chunks(nchunks);
+	AlignedVector< uint8_t > referenced(nchunks, 0);
+	AlignedVector< uint32_t > reply;
+	reply.reserve(1 + nchunks);
+	reply.push_back(0);
+
+	bool result = true;
+	for (uint32_t i = 0; i < nchunks; ++i)
+	{
+		const Key key(cv[i * 5 + 0], cv[i * 5 + 1], cv[i * 5 + 2], cv[i * 5 + 3]);
+		const uint32_t size = cv[i * 5 + 4];
+		if (!key.valid() || size == 0 || size > Chunker::c_maxSize)
+		{
+			log::warning << L"Invalid chunk in batch." << Endl;
+			result = false;
+			break;
+		}
+		chunks[i] = { key, size };
+		if (chunkStore->acquire(key))
+			referenced[i] = 1;
+		else
+			reply.push_back(i);
+	}
+	reply[0] = (uint32_t)reply.size() - 1;
+
+	if (result)
+	{
+		result &= (m_clientStream->write(&c_replyOk, sizeof(uint8_t)) == sizeof(uint8_t));
+		result &= (m_clientStream->write(reply.c_ptr(), reply.size() * sizeof(uint32_t)) == (int64_t)(reply.size() * sizeof(uint32_t)));
+	}
+
+	// Receive missing chunks in order, content is verified before chunk is stored.
+	AlignedVector< uint8_t > data(Chunker::c_maxSize);
+	for (uint32_t i = 1; result && i < reply.size(); ++i)
+	{
+		const BlobChunked::ChunkRef& chunk = chunks[reply[i]];
+		if (m_clientStream->read(data.ptr(), chunk.size) != (int64_t)chunk.size)
+		{
+			result = false;
+			break;
+		}
+
+		if (!(Chunker::hash(data.c_ptr(), chunk.size) == chunk.key))
+		{
+			log::warning << L"[CHUNK " << chunk.key.format() << L"] Content mismatch." << Endl;
+			result = false;
+			break;
+		}
+
+		if (!chunkStore->put(chunk.key, data.c_ptr(), chunk.size))
+		{
+			result = false;
+			break;
+		}
+		referenced[reply[i]] = 1;
+	}
+
+	// Only add chunks to blob once all are referenced, blob release it's chunks if put is aborted.
+	for (uint32_t i = 0; i < nchunks; ++i)
+	{
+		if (!result)
+		{
+			if (referenced[i])
+				chunkStore->release(chunks[i].key);
+		}
+		else
+			blob->addChunk(chunks[i].key, chunks[i].size);
+	}
+	if (!result)
+		return false;
+
+	outReceived = (uint32_t)reply.size() - 1;
+	return true;
+}
+
 }
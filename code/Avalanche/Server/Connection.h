@@ -8,8 +8,11 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Misc/Key.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -37,6 +40,7 @@ class TcpSocket;
 namespace traktor::avalanche
 {
 
+class BlobChunked;
 class Dictionary;
 
 class T_DLLCLASS Connection : public Object
@@ -60,6 +64,10 @@ private:
 	std::atomic< bool > m_finished;
 
 	bool process();
+
+	bool readKeys(AlignedVector< Key >& outKeys);
+
+	bool readChunks(BlobChunked* blob, uint32_t& outReceived);
 };
 
 }
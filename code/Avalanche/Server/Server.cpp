@@ -60,9 +60,12 @@ bool Server::create(const PropertyGroup* settings)
 	}
 
 	// Create our dictionary.
+	const uint64_t residentBudget = (uint64_t)settings->getProperty< int32_t >(L"Avalanche.ResidentBudget", 1024) * 1024UL * 1024UL;
+
 	m_dictionary = new Dictionary();
 	if (!m_dictionary->create(
-		settings->getProperty< std::wstring >(L"Avalanche.Path", L"")
+		settings->getProperty< std::wstring >(L"Avalanche.Path", L""),
+		residentBudget
 	))
 	{
 		log::error << L"Unable to create dictionary." << Endl;
@@ -205,48 +208,9 @@ bool Server::update()
 	if (m_master)
 	{
 		const uint64_t maxMemoryUsage = (uint64_t)m_memoryBudget * 1024UL * 1024UL * 1024UL;
-
-		Dictionary::Stats stats;
-		if (m_dictionary->getStats(stats))
-		{
-			if (stats.memoryUsage >= maxMemoryUsage)
-			{
-				AlignedVector< std::pair< Key, DateTime > > queue;
-
-				// Get snapshot of keys and last access time stamps.
-				AlignedVector< Key > keys;
-				m_dictionary->snapshotKeys(keys);
-				for (const auto& key : keys)
-				{
-					Ref< IBlob > blob = m_dictionary->get(key, true);
-					if (!blob)
-						continue;
-					queue.push_back({
-						key,
-						blob->lastAccessed()
-					});
-				}
-
-				// Sort eviction candidates on longest since access first.
-				std::sort(queue.begin(), queue.end(), [](const std::pair< Key, DateTime >& lh, const std::pair< Key, DateTime >& rh) {
-					return lh.second < rh.second;
-				});
-
-				// Evict blobs until memory budget is meet.
-				auto it = queue.begin();
-				while (it != queue.end() && stats.memoryUsage >= maxMemoryUsage)
-				{
-					Ref< IBlob > blob = m_dictionary->get(it->first, true);
-					if (!blob)
-						continue;
-
-					stats.memoryUsage -= blob->size();
-					m_dictionary->remove(it->first);
-
-					++it;
-				}
-			}
-		}
+		const uint32_t evicted = m_dictionary->evict(maxMemoryUsage);
+		if (evicted > 0)
+			log::info << L"Evicted " << evicted << L" blobs to meet memory budget." << Endl;
 	}
 
 	return true;
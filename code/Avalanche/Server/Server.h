@@ -48,7 +48,7 @@ class T_DLLCLASS Server : public Object
 	T_RTTI_CLASS;
 
 public:
-	constexpr static int32_t c_majorVersion = 7;
+	constexpr static int32_t c_majorVersion = 9;
 	constexpr static int32_t c_minorVersion = 0;
 
 	bool create(const PropertyGroup* settings);
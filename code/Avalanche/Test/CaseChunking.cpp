@@ -0,0 +1,188 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Avalanche/Chunker.h"
+#include "Avalanche/Client/Client.h"
+#include "Avalanche/Server/Server.h"
+#include "Avalanche/Test/CaseChunking.h"
+#include "Core/Guid.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+#include "Core/Settings/PropertyGroup.h"
+#include "Core/Settings/PropertyInteger.h"
+#include "Core/Settings/PropertyString.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Net/SocketAddressIPv4.h"
+
+namespace traktor::avalanche::test
+{
+	namespace
+	{
+
+const int32_t c_port = 20003;
+const uint32_t c_blobSize = 3 * 1024 * 1024;
+
+Ref< Server > createServer(const std::wstring& blobsPath, Thread*& outServerThread)
+{
+	Ref< PropertyGroup > settings = new PropertyGroup();
+	settings->setProperty< PropertyInteger >(L"Avalanche.Port", c_port);
+	settings->setProperty< PropertyString >(L"Avalanche.Path", blobsPath);
+
+	Ref< Server > server = new Server();
+	if (!server->create(settings))
+		return nullptr;
+
+	outServerThread = ThreadManager::getInstance().create([server, &outServerThread](){
+		while (!outServerThread->stopped())
+			server->update();
+	});
+	outServerThread->start();
+	return server;
+}
+
+void destroyServer(Ref< Server >& server, Thread* serverThread)
+{
+	serverThread->stop();
+	ThreadManager::getInstance().destroy(serverThread);
+	server->destroy();
+	server = nullptr;
+}
+
+bool putBlob(Client* client, const Key& key, const AlignedVector< uint8_t >& data)
+{
+	Ref< IStream > s = client->put(key);
+	if (!s)
+		return false;
+
+	// Write in small pieces, put stream must buffer across chunk boundaries.
+	for (uint32_t offset = 0; offset < data.size(); offset += 4096)
+	{
+		const int64_t nbytes = std::min< int64_t >(4096, data.size() - offset);
+		if (s->write(&data[offset], nbytes) != nbytes)
+			return false;
+	}
+
+	s->close();
+	return true;
+}
+
+bool verifyBlob(Client* client, const Key& key, const AlignedVector< uint8_t >& data)
+{
+	Ref< IStream > s = client->get(key);
+	if (!s || s->available() != (int64_t)data.size())
+		return false;
+
+	AlignedVector< uint8_t > received(data.size());
+	for (uint32_t offset = 0; offset < received.size(); )
+	{
+		const int64_t nread = s->read(&received[offset], received.size() - offset);
+		if (nread <= 0)
+			return false;
+		offset += (uint32_t)nread;
+	}
+
+	s->close();
+	return std::memcmp(received.c_ptr(), data.c_ptr(), data.size()) == 0;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.avalanche.test.CaseChunking", 0, CaseChunking, traktor::test::Case)
+
+void CaseChunking::run()
+{
+	const std::wstring blobsPath = OS::getInstance().getWritableFolderPath() + L"/Traktor/Avalanche/Test/" + Guid::create().format();
+
+	// Chunk boundaries are determined by content, not position.
+	AlignedVector< uint8_t > original(c_blobSize);
+	uint32_t seed = 1234;
+	for (auto& b : original)
+	{
+		seed = seed * 1664525 + 1013904223;
+		b = (uint8_t)(seed >> 24);
+	}
+
+	AlignedVector< uint8_t > modified = original;
+	const uint8_t insertion[100] = { 0xaa };
+	modified.insert(modified.begin() + c_blobSize / 2, insertion, insertion + sizeof(insertion));
+
+	Thread* serverThread = nullptr;
+	Ref< Server > server = createServer(blobsPath, serverThread);
+	CASE_ASSERT(server != nullptr);
+	if (!server)
+		return;
+
+	Ref< Client > client = new Client(net::SocketAddressIPv4(L"localhost", c_port));
+
+	const Key originalKey(1, 2, 3, 4);
+	const Key modifiedKey(5, 6, 7, 8);
+	const Key duplicateKey(9, 10, 11, 12);
+
+	Dictionary::Stats stats;
+
+	CASE_ASSERT(putBlob(client, originalKey, original));
+	CASE_ASSERT(client->stats(stats));
+	CASE_ASSERT_EQUAL(stats.chunkUsage, (uint64_t)c_blobSize);
+	CASE_ASSERT(stats.chunkCount >= c_blobSize / Chunker::c_maxSize);
+	const uint64_t originalUsage = stats.chunkUsage;
+
+	// Only chunks around insertion should be stored.
+	CASE_ASSERT(putBlob(client, modifiedKey, modified));
+	CASE_ASSERT(client->stats(stats));
+	CASE_ASSERT(stats.chunkUsage - originalUsage < 2 * Chunker::c_maxSize);
+
+	// Identical blob doesn't store any new chunks.
+	const uint64_t modifiedUsage = stats.chunkUsage;
+	CASE_ASSERT(putBlob(client, duplicateKey, original));
+	CASE_ASSERT(client->stats(stats));
+	CASE_ASSERT_EQUAL(stats.chunkUsage, modifiedUsage);
+	CASE_ASSERT_EQUAL(stats.memoryUsage, (uint64_t)(3 * c_blobSize + 100));
+
+	CASE_ASSERT(verifyBlob(client, originalKey, original));
+	CASE_ASSERT(verifyBlob(client, modifiedKey, modified));
+	CASE_ASSERT(verifyBlob(client, duplicateKey, original));
+
+	// Shared chunks remain until last blob referencing them is removed.
+	CASE_ASSERT(client->evict({ originalKey, duplicateKey }));
+	CASE_ASSERT(client->stats(stats));
+	CASE_ASSERT(stats.chunkUsage >= (uint64_t)modified.size());
+	CASE_ASSERT(stats.chunkUsage < modifiedUsage);
+	CASE_ASSERT(verifyBlob(client, modifiedKey, modified));
+
+	client->destroy();
+	client = nullptr;
+
+	destroyServer(server, serverThread);
+
+	// Chunked blobs are loaded from manifests when server is restarted.
+	server = createServer(blobsPath, serverThread);
+	CASE_ASSERT(server != nullptr);
+	if (server)
+	{
+		client = new Client(net::SocketAddressIPv4(L"localhost", c_port));
+		CASE_ASSERT(verifyBlob(client, modifiedKey, modified));
+
+		CASE_ASSERT(client->evict({ modifiedKey }));
+		CASE_ASSERT(client->stats(stats));
+		CASE_ASSERT_EQUAL(stats.chunkCount, (uint32_t)0);
+		CASE_ASSERT_EQUAL(stats.chunkUsage, (uint64_t)0);
+
+		client->destroy();
+		client = nullptr;
+
+		destroyServer(server, serverThread);
+	}
+
+	FileSystem::getInstance().removeDirectory(blobsPath + L"/Chunks");
+	FileSystem::getInstance().removeDirectory(blobsPath);
+}
+
+}
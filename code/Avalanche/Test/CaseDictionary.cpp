@@ -0,0 +1,225 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Avalanche/BlobChunked.h"
+#include "Avalanche/ChunkStore.h"
+#include "Avalanche/Dictionary.h"
+#include "Avalanche/IBlob.h"
+#include "Avalanche/Test/CaseDictionary.h"
+#include "Core/Guid.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+#include "Core/System/OS.h"
+
+namespace traktor::avalanche::test
+{
+	namespace
+	{
+
+const int32_t c_blobCount = 256;
+const int32_t c_blobSize = 1024;
+
+Key getKey(int32_t index)
+{
+	return Key(index + 1, index * 7 + 3, index * 13 + 5, 0x1234);
+}
+
+void fillBlob(IBlob* blob, int32_t index)
+{
+	uint8_t data[c_blobSize];
+	for (int32_t i = 0; i < c_blobSize; ++i)
+		data[i] = (uint8_t)(index + i);
+
+	Ref< IStream > stream = blob->append();
+	stream->write(data, sizeof(data));
+	stream->close();
+}
+
+Ref< BlobChunked > createChunkedBlob(Dictionary* dictionary, int32_t index)
+{
+	uint8_t data[c_blobSize];
+	for (int32_t i = 0; i < c_blobSize; ++i)
+		data[i] = (uint8_t)(index + i);
+
+	const Key chunkKey(index, 0, 0, 0x5678);
+	if (!dictionary->getChunkStore()->put(chunkKey, data, sizeof(data)))
+		return nullptr;
+
+	Ref< BlobChunked > blob = dictionary->createChunked();
+	blob->addChunk(chunkKey, sizeof(data));
+	return blob;
+}
+
+bool verifyBlob(const IBlob* blob, int32_t index)
+{
+	if (!blob || blob->size() != c_blobSize)
+		return false;
+
+	Ref< IStream > stream = blob->read();
+	if (!stream)
+		return false;
+
+	uint8_t data[c_blobSize];
+	const bool result = (stream->read(data, sizeof(data)) == sizeof(data));
+	stream->close();
+
+	for (int32_t i = 0; result && i < c_blobSize; ++i)
+	{
+		if (data[i] != (uint8_t)(index + i))
+			return false;
+	}
+	return result;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.avalanche.test.CaseDictionary", 0, CaseDictionary, traktor::test::Case)
+
+void CaseDictionary::run()
+{
+	const std::wstring blobsPath = OS::getInstance().getWritableFolderPath() + L"/Traktor/Avalanche/Test/" + Guid::create().format();
+
+	// Resident budget only fit a quarter of all blobs.
+	const uint64_t residentBudget = c_blobCount * c_blobSize / 4;
+
+	Ref< Dictionary > dictionary = new Dictionary();
+	CASE_ASSERT(dictionary->create(blobsPath, residentBudget));
+
+	for (int32_t i = 0; i < c_blobCount; ++i)
+	{
+		Ref< IBlob > blob = dictionary->create();
+		fillBlob(blob, i);
+		CASE_ASSERT(dictionary->put(getKey(i), blob, true));
+	}
+
+	Dictionary::Stats stats;
+	CASE_ASSERT(dictionary->getStats(stats));
+	CASE_ASSERT_EQUAL(stats.blobCount, (uint32_t)c_blobCount);
+	CASE_ASSERT_EQUAL(stats.memoryUsage, (uint64_t)(c_blobCount * c_blobSize));
+	CASE_ASSERT(stats.residentUsage <= residentBudget);
+	CASE_ASSERT(stats.spills > 0);
+
+	// Both resident and spilled blobs are intact; raw access isn't counted.
+	bool intact = true;
+	for (int32_t i = 0; i < c_blobCount; ++i)
+		intact &= verifyBlob(dictionary->get(getKey(i), true), i);
+	CASE_ASSERT(intact);
+
+	CASE_ASSERT(dictionary->get(getKey(c_blobCount), false) == nullptr);
+	CASE_ASSERT(dictionary->get(getKey(0), false) != nullptr);
+
+	CASE_ASSERT(dictionary->getStats(stats));
+	CASE_ASSERT_EQUAL(stats.hits, (uint64_t)1);
+	CASE_ASSERT_EQUAL(stats.misses, (uint64_t)1);
+
+	// Touch first half so second half become least recently used.
+	for (int32_t i = 0; i < c_blobCount / 2; ++i)
+		dictionary->get(getKey(i), false);
+
+	const uint32_t evicted = dictionary->evict(c_blobCount * c_blobSize / 2);
+	CASE_ASSERT(evicted > 0);
+
+	CASE_ASSERT(dictionary->getStats(stats));
+	CASE_ASSERT(stats.memoryUsage <= (uint64_t)(c_blobCount * c_blobSize / 2));
+	CASE_ASSERT_EQUAL(stats.evictions, (uint64_t)evicted);
+	CASE_ASSERT_EQUAL(stats.blobCount, (uint32_t)c_blobCount - evicted);
+
+	// Evicted blobs are the least recently used.
+	int32_t recentEvicted = 0;
+	for (int32_t i = 0; i < c_blobCount / 2; ++i)
+	{
+		if (dictionary->get(getKey(i), true) == nullptr)
+			recentEvicted++;
+	}
+	CASE_ASSERT_EQUAL(recentEvicted, 0);
+
+	// Flush drop memory copy of remaining resident blobs.
+	dictionary->flush();
+	CASE_ASSERT(dictionary->getStats(stats));
+	CASE_ASSERT_EQUAL(stats.residentUsage, (uint64_t)0);
+
+	// Put blobs which stay resident then reopen dictionary without flushing,
+	// acknowledged puts must survive.
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		Ref< IBlob > blob = dictionary->create();
+		fillBlob(blob, c_blobCount + i);
+		CASE_ASSERT(dictionary->put(getKey(c_blobCount + i), blob, true));
+	}
+	CASE_ASSERT(dictionary->getStats(stats));
+	CASE_ASSERT(stats.residentUsage > 0);
+	const uint32_t blobCount = stats.blobCount;
+
+	dictionary = new Dictionary();
+	CASE_ASSERT(dictionary->create(blobsPath, residentBudget));
+	CASE_ASSERT(dictionary->getStats(stats));
+	CASE_ASSERT_EQUAL(stats.blobCount, blobCount);
+
+	intact = true;
+	for (int32_t i = 0; i < 4; ++i)
+		intact &= verifyBlob(dictionary->get(getKey(c_blobCount + i), true), c_blobCount + i);
+	CASE_ASSERT(intact);
+
+	// Replacing a blob must keep the new blob.
+	{
+		Ref< IBlob > blob = dictionary->create();
+		fillBlob(blob, 1000);
+		CASE_ASSERT(dictionary->put(getKey(c_blobCount), blob, true));
+		CASE_ASSERT(verifyBlob(dictionary->get(getKey(c_blobCount), true), 1000));
+	}
+
+	// Replacing a chunked blob must keep the new manifest when dictionary is reopened.
+	for (int32_t i = 0; i < 2; ++i)
+	{
+		Ref< BlobChunked > blob = createChunkedBlob(dictionary, 2000 + i);
+		CASE_ASSERT(blob != nullptr);
+		if (blob)
+			CASE_ASSERT(dictionary->put(getKey(2000), blob, true));
+	}
+
+	dictionary = new Dictionary();
+	CASE_ASSERT(dictionary->create(blobsPath, residentBudget));
+	CASE_ASSERT(verifyBlob(dictionary->get(getKey(2000), true), 2001));
+
+	// Blobs of a single shard may use entire resident budget.
+	{
+		dictionary->flush();
+
+		int32_t count = 0;
+		for (int32_t i = 3000; count < c_blobCount / 8; ++i)
+		{
+			const Key key = getKey(i);
+			if ((key.hash() & (Dictionary::c_shardCount - 1)) != 0)
+				continue;
+
+			Ref< IBlob > blob = dictionary->create();
+			fillBlob(blob, i);
+			CASE_ASSERT(dictionary->put(key, blob, true));
+			count++;
+		}
+
+		CASE_ASSERT(dictionary->getStats(stats));
+		CASE_ASSERT_EQUAL(stats.residentUsage, (uint64_t)(c_blobCount / 8 * c_blobSize));
+	}
+
+	// Cleanup.
+	AlignedVector< Key > keys;
+	dictionary->snapshotKeys(keys);
+	for (const auto& key : keys)
+		dictionary->remove(key);
+
+	CASE_ASSERT(dictionary->getStats(stats));
+	CASE_ASSERT_EQUAL(stats.blobCount, (uint32_t)0);
+
+	dictionary = nullptr;
+	FileSystem::getInstance().removeDirectory(blobsPath + L"/Chunks");
+	FileSystem::getInstance().removeDirectory(blobsPath);
+}
+
+}
@@ -0,0 +1,178 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Avalanche/Client/Client.h"
+#include "Avalanche/Server/Server.h"
+#include "Avalanche/Test/CaseThroughput.h"
+#include "Core/Io/IStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Settings/PropertyGroup.h"
+#include "Core/Settings/PropertyInteger.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+#include "Net/SocketAddressIPv4.h"
+
+namespace traktor::avalanche::test
+{
+	namespace
+	{
+
+const int32_t c_port = 20002;
+const int32_t c_blobCount = 2000;
+const int32_t c_blobSize = 256;
+
+Key getKey(int32_t index)
+{
+	return Key(0x1000 + index, index * 31 + 1, index * 17 + 2, 0xbeef);
+}
+
+void fillData(uint8_t* data, int32_t index)
+{
+	for (int32_t i = 0; i < c_blobSize; ++i)
+		data[i] = (uint8_t)(index * 3 + i);
+}
+
+bool verifyStream(IStream* stream, int32_t index)
+{
+	uint8_t expected[c_blobSize];
+	uint8_t data[c_blobSize];
+	fillData(expected, index);
+	return
+		stream->available() == c_blobSize &&
+		stream->read(data, c_blobSize) == c_blobSize &&
+		std::memcmp(data, expected, c_blobSize) == 0;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.avalanche.test.CaseThroughput", 0, CaseThroughput, traktor::test::Case)
+
+void CaseThroughput::run()
+{
+	Ref< PropertyGroup > settings = new PropertyGroup();
+	settings->setProperty< PropertyInteger >(L"Avalanche.Port", c_port);
+
+	Ref< Server > server = new Server();
+	CASE_ASSERT(server->create(settings));
+
+	Thread* serverThread = ThreadManager::getInstance().create([&](){
+		while (!serverThread->stopped())
+			server->update();
+	});
+	CASE_ASSERT(serverThread != nullptr);
+	if (serverThread == nullptr)
+		return;
+
+	serverThread->start();
+
+	Ref< Client > client = new Client(net::SocketAddressIPv4(L"localhost", c_port));
+
+	AlignedVector< Key > keys;
+	for (int32_t i = 0; i < c_blobCount; ++i)
+	{
+		keys.push_back(getKey(i));
+
+		uint8_t data[c_blobSize];
+		fillData(data, i);
+
+		Ref< IStream > s = client->put(keys.back());
+		CASE_ASSERT(s != nullptr);
+		if (s)
+		{
+			CASE_ASSERT(s->write(data, c_blobSize) == c_blobSize);
+			s->close();
+		}
+	}
+
+	// One key not in dictionary.
+	keys.push_back(getKey(c_blobCount));
+
+	// Stat, one request per key.
+	{
+		Timer timer;
+		int32_t found = 0;
+		for (const auto& key : keys)
+			found += client->have(key) ? 1 : 0;
+		const double duration = timer.getElapsedTime();
+
+		CASE_ASSERT_EQUAL(found, c_blobCount);
+		log::info << L"Avalanche STAT, single " << int32_t(keys.size() / duration) << L" requests/s" << Endl;
+	}
+
+	// Stat, batched and pipelined.
+	{
+		AlignedVector< int64_t > sizes;
+
+		Timer timer;
+		CASE_ASSERT(client->stat(keys, sizes));
+		const double duration = timer.getElapsedTime();
+
+		CASE_ASSERT_EQUAL(sizes.size(), keys.size());
+		bool correct = true;
+		for (int32_t i = 0; i < c_blobCount; ++i)
+			correct &= (sizes[i] == c_blobSize);
+		CASE_ASSERT(correct);
+		CASE_ASSERT_EQUAL(sizes.back(), -1);
+
+		log::info << L"Avalanche STAT, batched " << int32_t(keys.size() / duration) << L" requests/s" << Endl;
+	}
+
+	// Get, one request per key.
+	{
+		Timer timer;
+		bool correct = true;
+		for (int32_t i = 0; i < c_blobCount; ++i)
+		{
+			Ref< IStream > s = client->get(keys[i]);
+			correct &= (s != nullptr && verifyStream(s, i));
+			if (s)
+				s->close();
+		}
+		const double duration = timer.getElapsedTime();
+
+		CASE_ASSERT(correct);
+		log::info << L"Avalanche GET, single " << int32_t(c_blobCount / duration) << L" requests/s" << Endl;
+	}
+
+	// Get, batched and pipelined.
+	{
+		int32_t received = 0;
+		bool correct = true;
+
+		Timer timer;
+		CASE_ASSERT(client->get(keys, [&](uint32_t index, IStream* stream) {
+			correct &= ((int32_t)index == received);
+			if (index < c_blobCount)
+				correct &= (stream != nullptr && verifyStream(stream, index));
+			else
+				correct &= (stream == nullptr);
+			received++;
+		}));
+		const double duration = timer.getElapsedTime();
+
+		CASE_ASSERT(correct);
+		CASE_ASSERT_EQUAL(received, (int32_t)keys.size());
+		log::info << L"Avalanche GET, batched " << int32_t(keys.size() / duration) << L" requests/s" << Endl;
+	}
+
+	// Connection still usable after batches.
+	CASE_ASSERT(client->ping());
+
+	client->destroy();
+	client = nullptr;
+
+	serverThread->stop();
+	ThreadManager::getInstance().destroy(serverThread);
+
+	server->destroy();
+	server = nullptr;
+}
+
+}
@@ -0,0 +1,121 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include "Core/Config.h"
+
+namespace traktor
+{
+
+/*! Bounded lock-free work stealing deque.
+ * \ingroup Core
+ *
+ * Chase-Lev deque; the owning thread push and pop
+ * items at the bottom while any other thread can
+ * steal items from the top.
+ *
+ * Capacity must be a power of two and the deque never
+ * grow, thus push fails when the deque is full.
+ */
+template < typename ItemType, int64_t Capacity >
+class WorkStealingDeque
+{
+public:
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	WorkStealingDeque()
+	:	m_top(0)
+	,	m_bottom(0)
+	{
+		for (int64_t i = 0; i < Capacity; ++i)
+			m_items[i].store(ItemType(), std::memory_order_relaxed);
+	}
+
+	/*! Push item at bottom, only called by owner thread.
+	 *
+	 * \return False if deque is full.
+	 */
+	bool push(const ItemType& item)
+	{
+		const int64_t b = m_bottom.load(std::memory_order_relaxed);
+		const int64_t t = m_top.load(std::memory_order_acquire);
+		if (b - t >= Capacity)
+			return false;
+		m_items[b & (Capacity - 1)].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/*! Pop item from bottom, only called by owner thread.
+	 *
+	 * \return False if deque is empty.
+	 */
+	bool pop(ItemType& outItem)
+	{
+		const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = m_top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		outItem = m_items[b & (Capacity - 1)].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// Last item; race against thieves.
+			const bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+
+		return true;
+	}
+
+	/*! Steal item from top, can be called by any thread.
+	 *
+	 * \return False if deque is empty or if another thread won the race.
+	 */
+	bool steal(ItemType& outItem)
+	{
+		int64_t t = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t b = m_bottom.load(std::memory_order_acquire);
+		if (t >= b)
+			return false;
+
+		outItem = m_items[t & (Capacity - 1)].load(std::memory_order_relaxed);
+		return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	/*! Approximate number of items in deque. */
+	int64_t size() const
+	{
+		const int64_t b = m_bottom.load(std::memory_order_relaxed);
+		const int64_t t = m_top.load(std::memory_order_relaxed);
+		return b > t ? b - t : 0;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+private:
+	alignas(64) std::atomic< int64_t > m_top;
+	alignas(64) std::atomic< int64_t > m_bottom;
+	alignas(64) std::atomic< ItemType > m_items[Capacity];
+};
+
+}
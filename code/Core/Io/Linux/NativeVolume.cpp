@@ -187,6 +187,10 @@ Ref< IStream > NativeVolume::open(const Path& fileName, uint32_t mode)
 		m = "wb";
 	else if (mrw == (File::FmRead | File::FmWrite))
 		m = "w+b";
+
+	// Append always write at end of file, existing content is kept.
+	if ((mode & File::FmAppend) != 0)
+		m = (mode & File::FmRead) ? "a+b" : "ab";
 	
 	if (!m)
 		return nullptr;
@@ -213,7 +217,7 @@ Ref< IMappedFile > NativeVolume::map(const Path& fileName)
 	const int64_t size = st.st_size;
 
 	void* ptr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
-	if (!ptr)
+	if (ptr == MAP_FAILED)
 	{
 		close(fd);
 		return nullptr;
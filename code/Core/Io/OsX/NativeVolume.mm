@@ -179,6 +179,10 @@ Ref< IStream > NativeVolume::open(const Path& filename, uint32_t mode)
 		m = "wb";
 	else if (mrw == (File::FmRead | File::FmWrite))
 		m = "w+b";
+
+	// Append always write at end of file, existing content is kept.
+	if ((mode & File::FmAppend) != 0)
+		m = (mode & File::FmRead) ? "a+b" : "ab";
 	
 	if (!m)
 		return nullptr;
@@ -250,6 +250,10 @@ Ref< IStream > NativeVolume::open(const Path& fileName, uint32_t mode)
 		return 0;
 	}
 
+	// Append always start writing at end of file.
+	if (mode & File::FmAppend)
+		SetFilePointer(hFile, 0, NULL, FILE_END);
+
 	// Try to map file if open for reading.
 	if ((mode & (File::FmRead | File::FmMapped)) == (File::FmRead | File::FmMapped))
 	{
@@ -45,6 +45,15 @@ std::wstring Key::format() const
 	return str(L"%08x_%08x_%08x_%08x", std::get< 0 >(m_kv), std::get< 1 >(m_kv), std::get< 2 >(m_kv), std::get< 3 >(m_kv));
 }
 
+uint32_t Key::hash() const
+{
+	uint32_t h = std::get< 0 >(m_kv);
+	h = h * 31 + std::get< 1 >(m_kv);
+	h = h * 31 + std::get< 2 >(m_kv);
+	h = h * 31 + std::get< 3 >(m_kv);
+	return h ^ (h >> 16);
+}
+
 Key Key::read(IStream* stream)
 {
 	uint32_t kv[4];
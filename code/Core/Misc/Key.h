@@ -41,6 +41,9 @@ public:
 
 	std::wstring format() const;
 
+	/*! Get 32-bit hash of key, suitable for bucketing. */
+	uint32_t hash() const;
+
 	static Key read(IStream* stream);
 
 	bool write(IStream* stream) const;
@@ -25,6 +25,7 @@
 #include "Core/Serialization/MemberArray.h"
 #include "Core/Serialization/MemberComplex.h"
 #include "Core/Serialization/MemberEnum.h"
+#include "Core/Serialization/SerializationPlan.h"
 
 #include <algorithm>
 #include <cstdlib>
@@ -659,6 +660,15 @@ void BinarySerializer::operator>>(const Member< ISerializable* >& m)
 		{
 			if (!reference)
 			{
+				// Identifiers are assigned in order when written.
+				if (!ensure(hash <= m_readCache.size() + 1))
+				{
+					log::error << L"Unable to read \"" << m.getName() << L"\"; unexpected object identifier." << Endl;
+					return;
+				}
+				if (hash > m_readCache.size())
+					m_readCache.resize((size_t)hash);
+
 				uint32_t typeHashOrLen;
 				const TypeInfo* type;
 				int16_t version;
@@ -757,13 +767,14 @@ void BinarySerializer::operator>>(const Member< ISerializable* >& m)
 					dataVersions.insert(std::make_pair(baseType, version));
 				}
 
-				serialize(object, dataVersions);
+				serializeObject(object, dataVersions);
 
-				m_readCache[hash] = object;
+				m_readCache[(size_t)hash - 1] = object;
 			}
 			else
 			{
-				object = static_cast< ISerializable* >(m_readCache[hash]);
+				if (hash <= m_readCache.size())
+					object = m_readCache[(size_t)hash - 1];
 				if (!ensure(object != nullptr))
 				{
 					log::error << L"Unable to read \"" << m.getName() << L"\"; no such reference." << Endl;
@@ -843,7 +854,12 @@ void BinarySerializer::operator>>(const Member< ISerializable* >& m)
 				}
 
 				m_writeCache[object] = hash;
-				serialize(object);
+
+				Serializer::dataVersionMap_t dataVersions;
+				for (const TypeInfo* ti = &type; ti != nullptr; ti = ti->getSuper())
+					dataVersions.insert(std::make_pair(ti, ti->getVersion()));
+
+				serializeObject(object, dataVersions);
 			}
 		}
 		else
@@ -887,12 +903,24 @@ void BinarySerializer::operator>>(const MemberArray& m)
 {
 	T_CHECK_STATUS;
 
+	// Arrays of plain data are read or written as a single block.
+	void* container = nullptr;
+	const MemberArray::PlainData* plainData = m.getPlainData(container);
+
 	if (m_direction == Direction::Read)
 	{
 		uint32_t size;
 		if (!ensure(read_primitive< uint32_t >(m_stream, size)))
 			return;
 
+		if (plainData)
+		{
+			void* data = plainData->resize(container, size);
+			const int32_t count = (int32_t)(size * plainData->elementSize / plainData->componentSize);
+			ensure(size == 0 || read_block(m_stream, data, count, plainData->componentSize));
+			return;
+		}
+
 		m.reserve(size, size);
 		m.read(*this, size);
 	}
@@ -902,6 +930,14 @@ void BinarySerializer::operator>>(const MemberArray& m)
 		if (!ensure(write_primitive< uint32_t >(m_stream, size)))
 			return;
 
+		if (plainData)
+		{
+			const void* data = plainData->data(container);
+			const int32_t count = (int32_t)(size * plainData->elementSize / plainData->componentSize);
+			ensure(size == 0 || write_block(m_stream, data, count, plainData->componentSize));
+			return;
+		}
+
 		T_CHECK_STATUS;
 		m.write(*this, size);
 	}
@@ -919,6 +955,32 @@ void BinarySerializer::operator>>(const MemberEnumBase& m)
 	m.serialize(*this);
 }
 
+void BinarySerializer::serializeObject(ISerializable* object, const dataVersionMap_t& dataVersions)
+{
+	// All objects of a type in a stream have same versions, thus plan is cached by type.
+	const TypeInfo* type = &type_of(object);
+	const SerializationPlan* plan;
+
+	auto it = m_plans.find(type);
+	if (it != m_plans.end())
+		plan = it->second;
+	else
+	{
+		plan = SerializationPlan::get(object, m_direction, cloning(), dataVersions);
+		m_plans.insert(std::make_pair(type, plan));
+	}
+
+	if (plan)
+	{
+		if (m_direction == Direction::Read)
+			ensure(plan->read(m_stream, object));
+		else
+			ensure(plan->write(m_stream, object));
+	}
+	else
+		serialize(object, dataVersions);
+}
+
 /*lint -restore*/
 
 }
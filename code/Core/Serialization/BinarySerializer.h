@@ -8,6 +8,8 @@
  */
 #pragma once
 
+#include <map>
+#include "Core/RefArray.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Ref.h"
 #include "Core/Serialization/Serializer.h"
@@ -24,9 +26,14 @@ namespace traktor
 {
 
 class IStream;
+class SerializationPlan;
 
 /*! Binary serializer.
  * \ingroup Core
+ *
+ * Objects of types registered with T_IMPLEMENT_SERIALIZATION_PLAN
+ * are read and written using compiled plans instead of
+ * walking each member through the serializer.
  */
 class T_DLLCLASS BinarySerializer : public Serializer
 {
@@ -96,12 +103,15 @@ public:
 private:
 	Ref< IStream > m_stream;
 	Direction m_direction;
-	SmallMap< uint64_t, Ref< ISerializable > > m_readCache;
-	SmallMap< ISerializable*, uint64_t > m_writeCache;
+	RefArray< ISerializable > m_readCache;
+	std::map< const ISerializable*, uint64_t > m_writeCache;
 	uint64_t m_nextCacheId;
 	AlignedVector< const TypeInfo* > m_typeReadCache;
 	SmallMap< const TypeInfo*, uint32_t > m_typeWriteCache;
 	uint32_t m_nextTypeCacheId;
+	SmallMap< const TypeInfo*, const SerializationPlan* > m_plans;
+
+	void serializeObject(ISerializable* object, const dataVersionMap_t& dataVersions);
 };
 
 }
@@ -90,6 +90,17 @@ public:
 		return true;
 	}
 
+	virtual const PlainData* getPlainData(void*& outContainer) const override final
+	{
+		if constexpr (IsPlainData< ValueType, ValueMember >::value)
+		{
+			outContainer = &m_ref;
+			return traktor::getPlainData< value_type >();
+		}
+		else
+			return nullptr;
+	}
+
 private:
 	value_type& m_ref;
 	mutable size_t m_index;
@@ -11,6 +11,7 @@
 #include "Core/Config.h"
 
 #include <string>
+#include <type_traits>
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -24,8 +25,14 @@ namespace traktor
 {
 
 class Attribute;
+class Color4f;
+class Matrix44;
+class Quaternion;
 class TypeInfo;
 class ISerializer;
+class Vector4;
+
+template < typename T > class Member;
 
 /*! Array member base.
  * \ingroup Core
@@ -33,6 +40,21 @@ class ISerializer;
 class T_DLLCLASS MemberArray
 {
 public:
+	/*! Contiguous storage of plain data elements.
+	 *
+	 * Elements are serialized as their memory representation,
+	 * thus an entire array can be read or written with a
+	 * single stream access.
+	 */
+	struct PlainData
+	{
+		uint32_t elementSize;	//!< Size of each element in bytes.
+		uint32_t componentSize;	//!< Size of each primitive component of an element, for byte swapping.
+		size_t (*size)(const void* container);
+		void* (*resize)(void* container, size_t size);
+		const void* (*data)(const void* container);
+	};
+
 	explicit MemberArray(const wchar_t* const name, const Attribute* attributes);
 
 	virtual ~MemberArray() {}
@@ -70,6 +92,13 @@ public:
 	/*! Insert default element, used by property list to add new elements. */
 	virtual bool insert() const = 0;
 
+	/*! Get contiguous storage if elements are plain data.
+	 *
+	 * \param outContainer Container of elements.
+	 * \return Plain data accessors, null if elements aren't plain data.
+	 */
+	virtual const PlainData* getPlainData(void*& outContainer) const { return nullptr; }
+
 protected:
 	/*! Set attributes member. */
 	void setAttributes(const Attribute* attributes);
@@ -79,4 +108,40 @@ private:
 	const Attribute* m_attributes;
 };
 
+/*! Check if element type is serialized as it's memory representation.
+ * \ingroup Core
+ */
+template < typename ValueType, typename ValueMember >
+struct IsPlainData
+{
+	constexpr static bool value =
+		std::is_same_v< ValueMember, Member< ValueType > > && (
+			(std::is_arithmetic_v< ValueType > && !std::is_same_v< ValueType, bool >) ||
+			std::is_same_v< ValueType, Vector4 > ||
+			std::is_same_v< ValueType, Matrix44 > ||
+			std::is_same_v< ValueType, Quaternion > ||
+			std::is_same_v< ValueType, Color4f >
+		);
+
+	constexpr static uint32_t componentSize = std::is_arithmetic_v< ValueType > ? sizeof(ValueType) : sizeof(float);
+};
+
+/*! Get plain data accessors of container.
+ * \ingroup Core
+ */
+template < typename ContainerType >
+const MemberArray::PlainData* getPlainData()
+{
+	typedef typename ContainerType::value_type value_type;
+	static const MemberArray::PlainData s_plainData =
+	{
+		(uint32_t)sizeof(value_type),
+		IsPlainData< value_type, Member< value_type > >::componentSize,
+		[](const void* container) -> size_t { return static_cast< const ContainerType* >(container)->size(); },
+		[](void* container, size_t size) -> void* { ContainerType& c = *static_cast< ContainerType* >(container); c.resize(size); return !c.empty() ? &c[0] : nullptr; },
+		[](const void* container) -> const void* { const ContainerType& c = *static_cast< const ContainerType* >(container); return !c.empty() ? &c[0] : nullptr; }
+	};
+	return &s_plainData;
+}
+
 }
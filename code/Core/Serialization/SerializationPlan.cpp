@@ -0,0 +1,389 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include <map>
+#include "Core/Containers/SmallSet.h"
+#include "Core/Io/IStream.h"
+#include "Core/Math/Color4f.h"
+#include "Core/Math/Color4ub.h"
+#include "Core/Math/Matrix33.h"
+#include "Core/Math/Matrix44.h"
+#include "Core/Math/Quaternion.h"
+#include "Core/Serialization/ISerializable.h"
+#include "Core/Serialization/MemberComplex.h"
+#include "Core/Serialization/SerializationPlan.h"
+#include "Core/Thread/ReaderWriterLock.h"
+
+namespace traktor
+{
+	namespace
+	{
+
+struct PlanKey
+{
+	const TypeInfo* type;
+	ISerializer::Direction direction;
+	bool cloning;
+	AlignedVector< int32_t > versions;
+
+	bool operator < (const PlanKey& rh) const
+	{
+		if (type != rh.type)
+			return type < rh.type;
+		if (direction != rh.direction)
+			return direction < rh.direction;
+		if (cloning != rh.cloning)
+			return cloning < rh.cloning;
+		return std::lexicographical_compare(versions.begin(), versions.end(), rh.versions.begin(), rh.versions.end());
+	}
+};
+
+struct PlanCache
+{
+	ReaderWriterLock lock;
+	SmallSet< const TypeInfo* > types;
+	std::map< PlanKey, Ref< SerializationPlan > > plans;
+};
+
+PlanCache& getPlanCache()
+{
+	// Cache is never destroyed; plans would otherwise be released after the allocator at exit.
+	static PlanCache* s_cache = new PlanCache();
+	return *s_cache;
+}
+
+/*! Record members visited by serialize method, without touching data. */
+class PlanRecorder : public Serializer
+{
+public:
+	explicit PlanRecorder(ISerializer::Direction direction, bool cloning, const uint8_t* base, uint32_t size)
+	:	m_direction(direction)
+	,	m_cloning(cloning)
+	,	m_base(base)
+	,	m_size(size)
+	{
+	}
+
+	bool record(ISerializable* object, const dataVersionMap_t& dataVersions)
+	{
+		serialize(object, dataVersions);
+		return !failed();
+	}
+
+	const AlignedVector< SerializationPlan::Op >& getOps() const { return m_ops; }
+
+	virtual Direction getDirection() const override final { return m_direction; }
+
+	virtual bool cloning() const override final { return m_cloning; }
+
+	virtual void operator >> (const Member< bool >& m) override final { add(SerializationPlan::OpType::Bool, &(*m), sizeof(bool), 1); }
+
+	virtual void operator >> (const Member< int8_t >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< uint8_t >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< int16_t >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< uint16_t >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< int32_t >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< uint32_t >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< int64_t >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< uint64_t >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< float >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< double >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< std::string >& m) override final { failure(); }
+
+	virtual void operator >> (const Member< std::wstring >& m) override final { failure(); }
+
+	virtual void operator >> (const Member< Guid >& m) override final { failure(); }
+
+	virtual void operator >> (const Member< Path >& m) override final { failure(); }
+
+	virtual void operator >> (const Member< Color4ub >& m) override final { add(SerializationPlan::OpType::Copy, m->e, sizeof(m->e), sizeof(m->e)); }
+
+	virtual void operator >> (const Member< Color4f >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< Scalar >& m) override final { add(SerializationPlan::OpType::Scalar, &(*m), sizeof(Scalar), sizeof(float)); }
+
+	virtual void operator >> (const Member< Vector2 >& m) override final { add(SerializationPlan::OpType::Copy, m->e, sizeof(m->e), sizeof(m->e)); }
+
+	virtual void operator >> (const Member< Vector4 >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< Matrix33 >& m) override final { add(SerializationPlan::OpType::Copy, m->m, sizeof(m->m), sizeof(m->m)); }
+
+	virtual void operator >> (const Member< Matrix44 >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< Quaternion >& m) override final { copy(m); }
+
+	virtual void operator >> (const Member< ISerializable* >& m) override final { failure(); }
+
+	virtual void operator >> (const Member< void* >& m) override final { failure(); }
+
+	virtual void operator >> (const MemberArray& m) override final
+	{
+		void* container = nullptr;
+		const MemberArray::PlainData* plainData = m.getPlainData(container);
+		if (plainData)
+			add(SerializationPlan::OpType::Array, container, 1, sizeof(uint32_t), plainData);
+		else
+			failure();
+	}
+
+	virtual void operator >> (const MemberComplex& m) override final
+	{
+		// Compounds are serialized inline, still plain data if all members are.
+		if (!failed())
+			m.serialize(*this);
+	}
+
+	virtual void operator >> (const MemberEnumBase& m) override final { failure(); }
+
+private:
+	ISerializer::Direction m_direction;
+	bool m_cloning;
+	const uint8_t* m_base;
+	uint32_t m_size;
+	AlignedVector< SerializationPlan::Op > m_ops;
+
+	template < typename T >
+	void copy(const Member< T >& m)
+	{
+		static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8 || sizeof(T) == 16 || sizeof(T) == 64);
+		add(SerializationPlan::OpType::Copy, &(*m), sizeof(T), sizeof(T));
+	}
+
+	void add(SerializationPlan::OpType type, const void* ptr, uint32_t size, uint32_t streamSize, const MemberArray::PlainData* array = nullptr)
+	{
+		// Only members inside object can be part of plan; not temporaries or globals.
+		const uint8_t* p = (const uint8_t*)ptr;
+		if (p < m_base || p + size > m_base + m_size)
+		{
+			failure();
+			return;
+		}
+
+		const uint32_t offset = (uint32_t)(p - m_base);
+
+		// Merge adjacent copies into a single run.
+		if (type == SerializationPlan::OpType::Copy && !m_ops.empty())
+		{
+			SerializationPlan::Op& last = m_ops.back();
+			if (last.type == SerializationPlan::OpType::Copy && last.offset + last.size == offset)
+			{
+				last.size += streamSize;
+				return;
+			}
+		}
+
+		m_ops.push_back({ type, offset, streamSize, array });
+	}
+};
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.SerializationPlan", SerializationPlan, Object)
+
+void SerializationPlan::registerType(const TypeInfo* type)
+{
+	PlanCache& cache = getPlanCache();
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(cache.lock);
+	cache.types.insert(type);
+}
+
+const SerializationPlan* SerializationPlan::get(ISerializable* object, ISerializer::Direction direction, bool cloning, const Serializer::dataVersionMap_t& dataVersions)
+{
+#if defined(T_LITTLE_ENDIAN)
+	PlanCache& cache = getPlanCache();
+	const TypeInfo& type = type_of(object);
+
+	PlanKey key;
+	key.type = &type;
+	key.direction = direction;
+	key.cloning = cloning;
+	for (const TypeInfo* ti = &type; ti != nullptr; ti = ti->getSuper())
+	{
+		auto it = dataVersions.find(ti);
+		key.versions.push_back(it != dataVersions.end() ? it->second : 0);
+	}
+
+	{
+		T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(cache.lock);
+		if (cache.types.find(&type) == cache.types.end())
+			return nullptr;
+
+		auto it = cache.plans.find(key);
+		if (it != cache.plans.end())
+			return it->second;
+	}
+
+	// Compile plan by recording members of this object, offsets are relative to
+	// start of object so plan is valid for all objects of the same type.
+	Ref< SerializationPlan > plan;
+	PlanRecorder recorder(direction, cloning, (const uint8_t*)dynamic_cast< void* >(object), type.getSize());
+	if (recorder.record(object, dataVersions) && !recorder.getOps().empty())
+		plan = new SerializationPlan(recorder.getOps());
+
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(cache.lock);
+	cache.plans[key] = plan;
+	return plan;
+#else
+	return nullptr;
+#endif
+}
+
+bool SerializationPlan::read(IStream* stream, ISerializable* object) const
+{
+	uint8_t stackBuffer[1024];
+	AlignedVector< uint8_t > heapBuffer;
+	uint8_t* buffer = stackBuffer;
+	if (m_streamSize > sizeof(stackBuffer))
+	{
+		heapBuffer.resize(m_streamSize);
+		buffer = heapBuffer.ptr();
+	}
+
+	uint8_t* base = (uint8_t*)dynamic_cast< void* >(object);
+	for (size_t i = 0; i < m_ops.size(); )
+	{
+		// Read members up to, and including, count of next array with a single stream access.
+		const size_t from = i;
+		uint32_t runSize = 0;
+		while (i < m_ops.size())
+		{
+			runSize += m_ops[i].size;
+			if (m_ops[i++].type == OpType::Array)
+				break;
+		}
+
+		if (stream->read(buffer, runSize) != runSize)
+			return false;
+
+		const uint8_t* ptr = buffer;
+		for (size_t j = from; j < i; ++j)
+		{
+			const Op& op = m_ops[j];
+			switch (op.type)
+			{
+			case OpType::Copy:
+				std::memcpy(base + op.offset, ptr, op.size);
+				break;
+
+			case OpType::Bool:
+				*(bool*)(base + op.offset) = (*ptr != 0);
+				break;
+
+			case OpType::Scalar:
+				{
+					float tmp;
+					std::memcpy(&tmp, ptr, sizeof(float));
+					*(Scalar*)(base + op.offset) = Scalar(tmp);
+				}
+				break;
+
+			case OpType::Array:
+				{
+					uint32_t count;
+					std::memcpy(&count, ptr, sizeof(uint32_t));
+
+					// Elements are read directly into array.
+					void* data = op.array->resize(base + op.offset, count);
+					const int64_t dataSize = (int64_t)count * op.array->elementSize;
+					if (dataSize > 0 && stream->read(data, dataSize) != dataSize)
+						return false;
+				}
+				break;
+			}
+			ptr += op.size;
+		}
+	}
+
+	return true;
+}
+
+bool SerializationPlan::write(IStream* stream, const ISerializable* object) const
+{
+	uint8_t stackBuffer[1024];
+	AlignedVector< uint8_t > heapBuffer;
+	uint8_t* buffer = stackBuffer;
+	if (m_streamSize > sizeof(stackBuffer))
+	{
+		heapBuffer.resize(m_streamSize);
+		buffer = heapBuffer.ptr();
+	}
+
+	const uint8_t* base = (const uint8_t*)dynamic_cast< const void* >(object);
+	for (size_t i = 0; i < m_ops.size(); )
+	{
+		// Write members up to, and including, count of next array with a single stream access.
+		uint8_t* ptr = buffer;
+		const Op* array = nullptr;
+		while (i < m_ops.size() && !array)
+		{
+			const Op& op = m_ops[i++];
+			switch (op.type)
+			{
+			case OpType::Copy:
+				std::memcpy(ptr, base + op.offset, op.size);
+				break;
+
+			case OpType::Bool:
+				// Same encoding as BinarySerializer.
+				*ptr = *(const bool*)(base + op.offset) ? 0xff : 0x00;
+				break;
+
+			case OpType::Scalar:
+				{
+					const float tmp = float(*(const Scalar*)(base + op.offset));
+					std::memcpy(ptr, &tmp, sizeof(float));
+				}
+				break;
+
+			case OpType::Array:
+				{
+					const uint32_t count = (uint32_t)op.array->size(base + op.offset);
+					std::memcpy(ptr, &count, sizeof(uint32_t));
+					array = &op;
+				}
+				break;
+			}
+			ptr += op.size;
+		}
+
+		const int64_t runSize = (int64_t)(ptr - buffer);
+		if (stream->write(buffer, runSize) != runSize)
+			return false;
+
+		// Elements are written directly from array.
+		if (array)
+		{
+			const void* container = base + array->offset;
+			const int64_t dataSize = (int64_t)array->array->size(container) * array->array->elementSize;
+			if (dataSize > 0 && stream->write(array->array->data(container), dataSize) != dataSize)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+SerializationPlan::SerializationPlan(const AlignedVector< Op >& ops)
+:	m_ops(ops)
+{
+	for (const auto& op : m_ops)
+		m_streamSize += op.size;
+}
+
+}
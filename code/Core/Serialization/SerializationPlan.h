@@ -0,0 +1,103 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Serialization/MemberArray.h"
+#include "Core/Serialization/Serializer.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_CORE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class IStream;
+class ISerializable;
+
+/*! Compiled serialization plan.
+ * \ingroup Core
+ *
+ * A plan is compiled once per type, direction and data
+ * versions by recording the members visited by the
+ * type's serialize method. Members adjacent in memory are
+ * merged into runs, so an object is read or written with
+ * a few stream accesses and bulk copies instead of
+ * dispatching each member through the serializer. Arrays
+ * of plain data are read or written as element count
+ * followed by a single run of all elements.
+ *
+ * Only types registered with T_IMPLEMENT_SERIALIZATION_PLAN
+ * are compiled; such type's serialize method must always visit
+ * the same members for a given version, not branch on member
+ * values and not have side effects. Types visiting any member
+ * which isn't plain data, such as strings, references or
+ * arrays of such, are serialized as usual.
+ */
+class T_DLLCLASS SerializationPlan : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	enum class OpType : uint8_t
+	{
+		Copy,
+		Bool,
+		Scalar,
+		Array
+	};
+
+	struct Op
+	{
+		OpType type;
+		uint32_t offset;	//!< Offset in object.
+		uint32_t size;		//!< Size in stream, excluding elements of arrays.
+		const MemberArray::PlainData* array;	//!< Array accessors, only for array operations.
+	};
+
+	/*! Register type to be serialized using plans. */
+	static void registerType(const TypeInfo* type);
+
+	/*! Get plan for serializing object.
+	 *
+	 * \param object Object to serialize.
+	 * \param direction Serialization direction.
+	 * \param cloning If object is serialized for cloning.
+	 * \param dataVersions Versions of object's type and it's base types.
+	 * \return Plan, null if type isn't registered or cannot be serialized using a plan.
+	 */
+	static const SerializationPlan* get(ISerializable* object, ISerializer::Direction direction, bool cloning, const Serializer::dataVersionMap_t& dataVersions);
+
+	bool read(IStream* stream, ISerializable* object) const;
+
+	bool write(IStream* stream, const ISerializable* object) const;
+
+	/*! Number of bytes read or written from stream, excluding elements of arrays. */
+	uint32_t getStreamSize() const { return m_streamSize; }
+
+private:
+	AlignedVector< Op > m_ops;
+	uint32_t m_streamSize = 0;
+
+	explicit SerializationPlan(const AlignedVector< Op >& ops);
+};
+
+}
+
+/*! Register type to be serialized using compiled plans.
+ * \ingroup Core
+ */
+#define T_IMPLEMENT_SERIALIZATION_PLAN(CLASS) \
+	static T_ANONYMOUS_VAR(const bool) = (traktor::SerializationPlan::registerType(&traktor::type_of< CLASS >()), true);
@@ -9,11 +9,13 @@
 #include "Core/Settings/PropertyBoolean.h"
 
 #include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/SerializationPlan.h"
 
 namespace traktor
 {
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.PropertyBoolean", 0, PropertyBoolean, IPropertyValue)
+T_IMPLEMENT_SERIALIZATION_PLAN(PropertyBoolean)
 
 PropertyBoolean::PropertyBoolean(value_type_t value)
 	: m_value(value)
@@ -9,11 +9,13 @@
 #include "Core/Settings/PropertyFloat.h"
 
 #include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/SerializationPlan.h"
 
 namespace traktor
 {
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.PropertyFloat", 0, PropertyFloat, IPropertyValue)
+T_IMPLEMENT_SERIALIZATION_PLAN(PropertyFloat)
 
 PropertyFloat::PropertyFloat(value_type_t value)
 	: m_value(value)
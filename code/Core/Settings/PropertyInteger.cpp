@@ -9,11 +9,13 @@
 #include "Core/Settings/PropertyInteger.h"
 
 #include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/SerializationPlan.h"
 
 namespace traktor
 {
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.PropertyInteger", 0, PropertyInteger, IPropertyValue)
+T_IMPLEMENT_SERIALIZATION_PLAN(PropertyInteger)
 
 PropertyInteger::PropertyInteger(value_type_t value)
 	: m_value(value)
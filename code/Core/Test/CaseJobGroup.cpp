@@ -0,0 +1,114 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Test/CaseJobGroup.h"
+#include "Core/Thread/JobGroup.h"
+#include "Core/Thread/JobQueue.h"
+
+namespace traktor::test
+{
+	namespace
+	{
+
+const int32_t c_stageCount = 8;
+const int32_t c_stageJobCount = 64;
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseJobGroup", 0, CaseJobGroup, Case)
+
+void CaseJobGroup::run()
+{
+	const JobQueue::Scheduling schedulings[] = { JobQueue::Scheduling::Shared, JobQueue::Scheduling::Stealing };
+	for (auto scheduling : schedulings)
+	{
+		JobQueue queue;
+		CASE_ASSERT(queue.create(4, Thread::Normal, scheduling));
+
+		// Chain of dependent jobs must execute in order.
+		{
+			Ref< JobGroup > group = new JobGroup(queue);
+			std::atomic< int32_t > sequence(0);
+			bool ordered = true;
+
+			Ref< Job > previous;
+			for (int32_t i = 0; i < 100; ++i)
+			{
+				RefArray< Job > predecessors;
+				if (previous)
+					predecessors.push_back(previous);
+				previous = group->add([&, i](){ ordered &= (sequence++ == i); }, predecessors);
+			}
+
+			CASE_ASSERT(group->wait());
+			CASE_ASSERT_EQUAL(group->getPending(), 0);
+			CASE_ASSERT_EQUAL((int32_t)sequence, 100);
+			CASE_ASSERT(ordered);
+		}
+
+		// Diamond; join job must see result of both branches.
+		{
+			Ref< JobGroup > group = new JobGroup(queue);
+			std::atomic< int32_t > left(0), right(0), joined(0);
+
+			Ref< Job > root = group->add([&](){ left = 1; right = 1; });
+			Ref< Job > a = group->add([&](){ left += 1; }, { root });
+			Ref< Job > b = group->add([&](){ right += 2; }, { root });
+			group->add([&](){ joined = left + right; }, { a, b });
+
+			CASE_ASSERT(group->wait());
+			CASE_ASSERT_EQUAL((int32_t)joined, 5);
+		}
+
+		// Overlapping stages chained through continuations, each stage
+		// waited upon through it's own group.
+		{
+			Ref< JobGroup > stages[c_stageCount];
+			std::atomic< int32_t > counts[c_stageCount];
+			bool ordered = true;
+
+			for (int32_t i = 0; i < c_stageCount; ++i)
+			{
+				stages[i] = new JobGroup(queue);
+				counts[i] = 0;
+			}
+
+			for (int32_t i = 0; i < c_stageJobCount; ++i)
+				stages[0]->add([&](){ counts[0]++; });
+
+			for (int32_t i = 1; i < c_stageCount; ++i)
+			{
+				JobGroup* stage = stages[i];
+				stages[i - 1]->then([&, stage, i](){
+					ordered &= (counts[i - 1] == c_stageJobCount);
+					for (int32_t j = 0; j < c_stageJobCount; ++j)
+						stage->add([&, i](){ counts[i]++; });
+				}, stage);
+			}
+
+			CASE_ASSERT(stages[c_stageCount - 1]->wait());
+			CASE_ASSERT(ordered);
+			for (int32_t i = 0; i < c_stageCount; ++i)
+				CASE_ASSERT_EQUAL((int32_t)counts[i], c_stageJobCount);
+		}
+
+		// Continuation on already finished group is scheduled immediately.
+		{
+			Ref< JobGroup > group = new JobGroup(queue);
+			std::atomic< bool > executed(false);
+			Ref< Job > continuation = group->then([&](){ executed = true; });
+			CASE_ASSERT(continuation->wait());
+			CASE_ASSERT(executed);
+		}
+
+		CASE_ASSERT(queue.wait());
+		queue.destroy();
+	}
+}
+
+}
@@ -0,0 +1,172 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Log/Log.h"
+#include "Core/System/OS.h"
+#include "Core/Test/CaseJobQueue.h"
+#include "Core/Thread/Event.h"
+#include "Core/Thread/JobManager.h"
+#include "Core/Thread/JobQueue.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+	namespace
+	{
+
+const int32_t c_jobCount = 10000;
+const int32_t c_nestedCount = 32;
+
+std::atomic< int32_t > g_job;
+std::atomic< int32_t > g_counts[c_jobCount];
+
+const wchar_t* getSchedulingName(JobQueue::Scheduling scheduling)
+{
+	return scheduling == JobQueue::Scheduling::Stealing ? L"stealing" : L"shared";
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseJobQueue", 0, CaseJobQueue, Case)
+
+void CaseJobQueue::run()
+{
+	const uint32_t workerCount = (uint32_t)std::max< int32_t >(OS::getInstance().getCPUCoreCount() - 1, 1);
+	const JobQueue::Scheduling schedulings[] = { JobQueue::Scheduling::Shared, JobQueue::Scheduling::Stealing };
+
+	for (auto scheduling : schedulings)
+	{
+		JobQueue queue;
+		CASE_ASSERT(queue.create(workerCount, Thread::Normal, scheduling));
+		CASE_ASSERT(queue.getScheduling() == scheduling);
+
+		// Fork many small jobs, each must run exactly once; measure throughput.
+		{
+			g_job = 0;
+
+			AlignedVector< Job::task_t > tasks(c_jobCount);
+			for (int32_t i = 0; i < c_jobCount; ++i)
+			{
+				g_counts[i] = 0;
+				tasks[i] = [=](){ g_counts[i]++; g_job++; };
+			}
+
+			Timer timer;
+			queue.fork(tasks.c_ptr(), tasks.size());
+			const double duration = timer.getElapsedTime();
+
+			CASE_ASSERT_EQUAL((int32_t)g_job, c_jobCount);
+
+			bool correct = true;
+			for (int32_t i = 0; i < c_jobCount; ++i)
+				correct &= (g_counts[i] == 1);
+			CASE_ASSERT(correct);
+
+			log::info << L"Job queue (" << getSchedulingName(scheduling) << L"), fork throughput " << int32_t(c_jobCount / duration) << L" jobs/s" << Endl;
+		}
+
+		// Add jobs one by one and wait for all; measure throughput.
+		{
+			g_job = 0;
+
+			Timer timer;
+			for (int32_t i = 0; i < c_jobCount; ++i)
+				queue.add([=](){ g_job++; });
+
+			CASE_ASSERT(queue.wait());
+			const double duration = timer.getElapsedTime();
+
+			CASE_ASSERT_EQUAL((int32_t)g_job, c_jobCount);
+
+			log::info << L"Job queue (" << getSchedulingName(scheduling) << L"), add throughput " << int32_t(c_jobCount / duration) << L" jobs/s" << Endl;
+		}
+
+		// Nested fork from within jobs; only safe with work stealing since
+		// shared scheduling block workers waiting for inner jobs.
+		if (scheduling == JobQueue::Scheduling::Stealing)
+		{
+			g_job = 0;
+
+			AlignedVector< Job::task_t > outer(c_nestedCount);
+			for (int32_t i = 0; i < c_nestedCount; ++i)
+			{
+				outer[i] = [&](){
+					Job::task_t inner[c_nestedCount];
+					for (int32_t j = 0; j < c_nestedCount; ++j)
+						inner[j] = [](){ g_job++; };
+					queue.fork(inner, c_nestedCount);
+				};
+			}
+			queue.fork(outer.c_ptr(), outer.size());
+
+			CASE_ASSERT_EQUAL((int32_t)g_job, c_nestedCount * c_nestedCount);
+		}
+
+		// Each added job must be finished when wait returns; measure
+		// latency from add until job has finished on caller thread.
+		{
+			double total = 0.0;
+			double worst = 0.0;
+
+			g_job = 0;
+			for (int32_t i = 0; i < 1000; ++i)
+			{
+				Timer timer;
+				Ref< Job > job = queue.add([](){ g_job++; });
+				CASE_ASSERT(job->wait());
+				const double latency = timer.getElapsedTime();
+				CASE_ASSERT_EQUAL((int32_t)g_job, i + 1);
+				total += latency;
+				worst = std::max(worst, latency);
+			}
+
+			log::info << L"Job queue (" << getSchedulingName(scheduling) << L"), latency avg " << int32_t(total * 1000000.0 / 1000.0) << L" us, worst " << int32_t(worst * 1000000.0) << L" us" << Endl;
+		}
+
+		queue.destroy();
+	}
+
+	// Thread which fork only run jobs of it's own fork, never unrelated queued jobs.
+	{
+		JobQueue queue;
+		CASE_ASSERT(queue.create(1, Thread::Normal, JobQueue::Scheduling::Stealing));
+
+		Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+		Event blockWorker;
+		std::atomic< bool > blocking(false);
+		std::atomic< Thread* > unrelatedThread(nullptr);
+
+		// Occupy only worker and queue an unrelated job behind it.
+		queue.add([&](){ blocking = true; blockWorker.wait(); });
+		while (!blocking)
+			currentThread->yield();
+		queue.add([&](){ unrelatedThread = ThreadManager::getInstance().getCurrentThread(); });
+
+		g_job = 0;
+		Job::task_t tasks[16];
+		for (int32_t i = 0; i < 16; ++i)
+			tasks[i] = [](){ g_job++; };
+		queue.fork(tasks, 16);
+
+		CASE_ASSERT_EQUAL((int32_t)g_job, 16);
+		CASE_ASSERT(unrelatedThread == nullptr);
+
+		blockWorker.broadcast();
+		CASE_ASSERT(queue.wait());
+		CASE_ASSERT(unrelatedThread != nullptr);
+		CASE_ASSERT(unrelatedThread != currentThread);
+
+		queue.destroy();
+	}
+
+	// Global job manager use shared scheduling unless work stealing is opted in.
+	CASE_ASSERT(JobManager::getInstance().getQueue().getScheduling() == JobQueue::Scheduling::Shared);
+}
+
+}
@@ -0,0 +1,310 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Core/RefArray.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Color4ub.h"
+#include "Core/Math/Matrix44.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Core/Serialization/ISerializable.h"
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/Member.h"
+#include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/MemberRefArray.h"
+#include "Core/Serialization/SerializationPlan.h"
+#include "Core/Test/CaseSerializer.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+	namespace
+	{
+
+const int32_t c_objectCount = 64;
+const int32_t c_benchmarkObjectCount = 20000;
+const int32_t c_benchmarkIterations = 4;
+
+/*! Array element member which isn't recognized as plain data, thus serialized one element at a time. */
+template < typename ValueType >
+class Serializer_Element : public Member< ValueType >
+{
+public:
+	explicit Serializer_Element(const wchar_t* const name, ValueType& ref)
+	:	Member< ValueType >(name, ref)
+	{
+	}
+};
+
+/*! Object with plain data members, same members for both types. */
+class Serializer_Base : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	bool m_enable = false;
+	int32_t m_id = 0;
+	uint32_t m_flags = 0;
+	float m_weight = 0.0f;
+	Scalar m_radius = 0.0_simd;
+	Vector4 m_position = Vector4::zero();
+	Matrix44 m_transform = Matrix44::identity();
+	Color4ub m_color;
+	AlignedVector< float > m_weights;
+	AlignedVector< Vector4 > m_points;
+
+	void set(int32_t index)
+	{
+		m_enable = (index & 1) != 0;
+		m_id = index;
+		m_flags = index * 3;
+		m_weight = index * 0.5f;
+		m_radius = Scalar(index * 0.25f);
+		m_position = Vector4(float(index), 1.0f, 2.0f, 1.0f);
+		m_transform = translate(float(index), 2.0f, 3.0f);
+		m_color = Color4ub(index & 255, 1, 2, 3);
+		m_weights.resize(index % 5);
+		for (size_t i = 0; i < m_weights.size(); ++i)
+			m_weights[i] = index + i * 0.5f;
+		m_points.resize(index % 3);
+		for (size_t i = 0; i < m_points.size(); ++i)
+			m_points[i] = Vector4(float(index), float(i), 0.0f, 1.0f);
+	}
+
+	bool equal(int32_t index) const
+	{
+		return
+			m_enable == ((index & 1) != 0) &&
+			m_id == index &&
+			m_flags == (uint32_t)(index * 3) &&
+			m_weight == index * 0.5f &&
+			m_radius == Scalar(index * 0.25f) &&
+			m_position == Vector4(float(index), 1.0f, 2.0f, 1.0f) &&
+			m_transform == translate(float(index), 2.0f, 3.0f) &&
+			m_color == Color4ub(index & 255, 1, 2, 3) &&
+			equalArrays(index);
+	}
+
+	bool equalArrays(int32_t index) const
+	{
+		if (m_weights.size() != (size_t)(index % 5) || m_points.size() != (size_t)(index % 3))
+			return false;
+		for (size_t i = 0; i < m_weights.size(); ++i)
+		{
+			if (m_weights[i] != index + i * 0.5f)
+				return false;
+		}
+		for (size_t i = 0; i < m_points.size(); ++i)
+		{
+			if (m_points[i] != Vector4(float(index), float(i), 0.0f, 1.0f))
+				return false;
+		}
+		return true;
+	}
+
+	virtual void serialize(ISerializer& s) override
+	{
+		s >> Member< bool >(L"enable", m_enable);
+		s >> Member< int32_t >(L"id", m_id);
+		s >> Member< uint32_t >(L"flags", m_flags);
+		s >> Member< float >(L"weight", m_weight);
+		s >> Member< Scalar >(L"radius", m_radius);
+		s >> Member< Vector4 >(L"position", m_position);
+		s >> Member< Matrix44 >(L"transform", m_transform);
+		s >> Member< Color4ub >(L"color", m_color);
+		serializeArrays(s);
+	}
+
+	virtual void serializeArrays(ISerializer& s)
+	{
+		s >> MemberAlignedVector< float >(L"weights", m_weights);
+		s >> MemberAlignedVector< Vector4 >(L"points", m_points);
+	}
+};
+
+/*! Serialized using compiled plan. */
+class Serializer_Plan : public Serializer_Base
+{
+	T_RTTI_CLASS;
+};
+
+/*! Serialized by walking members, arrays one element at a time. */
+class Serializer_Walk : public Serializer_Base
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void serializeArrays(ISerializer& s) override final
+	{
+		s >> MemberAlignedVector< float, Serializer_Element< float > >(L"weights", m_weights);
+		s >> MemberAlignedVector< Vector4, Serializer_Element< Vector4 > >(L"points", m_points);
+	}
+};
+
+class Serializer_Container : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	RefArray< Serializer_Base > m_objects;
+
+	virtual void serialize(ISerializer& s) override
+	{
+		s >> MemberRefArray< Serializer_Base >(L"objects", m_objects);
+	}
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseSerializer.Serializer_Base", Serializer_Base, ISerializable)
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseSerializer.Serializer_Plan", 0, Serializer_Plan, Serializer_Base)
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseSerializer.Serializer_Walk", 0, Serializer_Walk, Serializer_Base)
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseSerializer.Serializer_Container", 0, Serializer_Container, ISerializable)
+
+T_IMPLEMENT_SERIALIZATION_PLAN(Serializer_Plan)
+
+template < typename ObjectType >
+Ref< Serializer_Container > createContainer(int32_t objectCount = c_objectCount)
+{
+	Ref< Serializer_Container > container = new Serializer_Container();
+	for (int32_t i = 0; i < objectCount; ++i)
+	{
+		Ref< ObjectType > object = new ObjectType();
+		object->set(i);
+		container->m_objects.push_back(object);
+	}
+	return container;
+}
+
+template < typename ObjectType >
+bool verifyContainer(const Serializer_Container* container)
+{
+	if (!container || container->m_objects.size() != c_objectCount)
+		return false;
+	for (int32_t i = 0; i < c_objectCount; ++i)
+	{
+		if (!is_a< ObjectType >(container->m_objects[i]) || !container->m_objects[i]->equal(i))
+			return false;
+	}
+	return true;
+}
+
+void renameType(AlignedVector< uint8_t >& buffer, const char* from, const char* to)
+{
+	const size_t length = std::strlen(from);
+	for (size_t i = 0; i + length <= buffer.size(); ++i)
+	{
+		if (std::memcmp(&buffer[i], from, length) == 0)
+			std::memcpy(&buffer[i], to, length);
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseSerializer", 0, CaseSerializer, Case)
+
+void CaseSerializer::run()
+{
+	Ref< Serializer_Container > planContainer = createContainer< Serializer_Plan >();
+	Ref< Serializer_Container > walkContainer = createContainer< Serializer_Walk >();
+
+	// Only registered type get a plan.
+	CASE_ASSERT(SerializationPlan::get(planContainer->m_objects[1], ISerializer::Direction::Write, false, Serializer::dataVersionMap_t()) != nullptr);
+	CASE_ASSERT(SerializationPlan::get(walkContainer->m_objects[1], ISerializer::Direction::Write, false, Serializer::dataVersionMap_t()) == nullptr);
+
+	DynamicMemoryStream planStream(false, true);
+	CASE_ASSERT(BinarySerializer(&planStream).writeObject(planContainer));
+
+	DynamicMemoryStream walkStream(false, true);
+	CASE_ASSERT(BinarySerializer(&walkStream).writeObject(walkContainer));
+
+	// Plan must produce same data as walking members; type names are same length so only differ in name.
+	AlignedVector< uint8_t > planBuffer = planStream.getBuffer();
+	AlignedVector< uint8_t > walkBuffer = walkStream.getBuffer();
+	CASE_ASSERT_EQUAL(planBuffer.size(), walkBuffer.size());
+	if (planBuffer.size() != walkBuffer.size())
+		return;
+
+	renameType(planBuffer, "Serializer_Plan", "Serializer_Walk");
+	CASE_ASSERT(std::memcmp(planBuffer.c_ptr(), walkBuffer.c_ptr(), walkBuffer.size()) == 0);
+
+	// Data written by plan is read by walking members, with true booleans.
+	{
+		DynamicMemoryStream readStream(planBuffer, true, false);
+		Ref< Serializer_Container > result = BinarySerializer(&readStream).readObject< Serializer_Container >();
+		CASE_ASSERT(verifyContainer< Serializer_Walk >(result));
+	}
+
+	// Data written by walking members is read by plan.
+	renameType(walkBuffer, "Serializer_Walk", "Serializer_Plan");
+	{
+		DynamicMemoryStream readStream(walkBuffer, true, false);
+		Ref< Serializer_Container > result = BinarySerializer(&readStream).readObject< Serializer_Container >();
+		CASE_ASSERT(verifyContainer< Serializer_Plan >(result));
+	}
+
+	// Round trip through plan.
+	{
+		DynamicMemoryStream readStream(planStream.getBuffer(), true, false);
+		Ref< Serializer_Container > result = BinarySerializer(&readStream).readObject< Serializer_Container >();
+		CASE_ASSERT(verifyContainer< Serializer_Plan >(result));
+	}
+
+	// Benchmark plan against walking members.
+	{
+		planContainer = createContainer< Serializer_Plan >(c_benchmarkObjectCount);
+		walkContainer = createContainer< Serializer_Walk >(c_benchmarkObjectCount);
+
+		// Reserve stream buffers up front so growing buffers isn't measured.
+		DynamicMemoryStream planStream(false, true);
+		DynamicMemoryStream walkStream(false, true);
+		planStream.getBuffer().reserve(c_benchmarkObjectCount * 256);
+		walkStream.getBuffer().reserve(c_benchmarkObjectCount * 256);
+
+		double planWrite = 0.0;
+		double walkWrite = 0.0;
+		for (int32_t i = 0; i < c_benchmarkIterations; ++i)
+		{
+			planStream.getBuffer().resize(0);
+			planStream.seek(IStream::SeekSet, 0);
+			Timer planTimer;
+			CASE_ASSERT(BinarySerializer(&planStream).writeObject(planContainer));
+			planWrite += planTimer.getElapsedTime();
+
+			walkStream.getBuffer().resize(0);
+			walkStream.seek(IStream::SeekSet, 0);
+			Timer walkTimer;
+			CASE_ASSERT(BinarySerializer(&walkStream).writeObject(walkContainer));
+			walkWrite += walkTimer.getElapsedTime();
+		}
+
+		double planRead = 0.0;
+		double walkRead = 0.0;
+		for (int32_t i = 0; i < c_benchmarkIterations; ++i)
+		{
+			DynamicMemoryStream planReadStream(planStream.getBuffer(), true, false);
+			Timer planTimer;
+			Ref< Serializer_Container > planResult = BinarySerializer(&planReadStream).readObject< Serializer_Container >();
+			planRead += planTimer.getElapsedTime();
+			CASE_ASSERT(planResult && planResult->m_objects.size() == c_benchmarkObjectCount);
+
+			DynamicMemoryStream walkReadStream(walkStream.getBuffer(), true, false);
+			Timer walkTimer;
+			Ref< Serializer_Container > walkResult = BinarySerializer(&walkReadStream).readObject< Serializer_Container >();
+			walkRead += walkTimer.getElapsedTime();
+			CASE_ASSERT(walkResult && walkResult->m_objects.size() == c_benchmarkObjectCount);
+		}
+
+		log::info << L"BinarySerializer write, " << c_benchmarkObjectCount << L" objects; plan " << int32_t(planWrite * 1000000.0 / c_benchmarkIterations) << L" us, walk " << int32_t(walkWrite * 1000000.0 / c_benchmarkIterations) << L" us" << Endl;
+		log::info << L"BinarySerializer read, " << c_benchmarkObjectCount << L" objects; plan " << int32_t(planRead * 1000000.0 / c_benchmarkIterations) << L" us, walk " << int32_t(walkRead * 1000000.0 / c_benchmarkIterations) << L" us" << Endl;
+	}
+}
+
+}
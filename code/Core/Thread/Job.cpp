@@ -1,6 +1,6 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022-2023 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -127,6 +127,8 @@ Job::Job(Event& jobFinishedEvent, const std::function< void() >& task)
 :	m_jobFinishedEvent(jobFinishedEvent)
 ,	m_task(task)
 ,	m_finished(false)
+,	m_claimed(false)
+,	m_grouped(false)
 {
 }
 
@@ -1,6 +1,6 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -48,11 +48,14 @@ public:
 	void operator delete (void* ptr);
 
 private:
+	friend class JobGroup;
 	friend class JobQueue;
 
 	Event& m_jobFinishedEvent;
 	task_t m_task;
 	std::atomic< bool > m_finished;
+	std::atomic< bool > m_claimed;
+	bool m_grouped;	//!< Job is part of a JobGroup, dependency state is kept by the group.
 
 	explicit Job(Event& jobFinishedEvent, const task_t& task);
 
@@ -0,0 +1,178 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <map>
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobGroup.h"
+#include "Core/Thread/JobManager.h"
+#include "Core/Thread/JobQueue.h"
+
+namespace traktor
+{
+	namespace
+	{
+
+/*! Dependency state of an unfinished group job. */
+struct Node
+{
+	Job* job = nullptr;
+	Ref< JobGroup > group;
+	std::atomic< int32_t > dependencies = 0;
+	AlignedVector< Node* > successors;
+};
+
+/*! Nodes of all unfinished group jobs; a job without node is finished. */
+SpinLock s_nodesLock;
+std::map< const Job*, Node* > s_nodes;
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.JobGroup", JobGroup, Object)
+
+JobGroup::JobGroup()
+:	m_queue(JobManager::getInstance().getQueue())
+,	m_pending(0)
+{
+}
+
+JobGroup::JobGroup(JobQueue& queue)
+:	m_queue(queue)
+,	m_pending(0)
+{
+}
+
+Ref< Job > JobGroup::add(const Job::task_t& task, const RefArray< Job >& predecessors)
+{
+	Job* job = createGrouped(task);
+	Ref< Job > result = job;
+
+	Node* node = new Node();
+	node->job = job;
+	node->group = this;
+
+	// Hold an extra dependency while registering so job
+	// isn't scheduled until all predecessors are registered.
+	node->dependencies = 1;
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(s_nodesLock);
+		s_nodes[job] = node;
+		for (auto predecessor : predecessors)
+		{
+			auto it = s_nodes.find(predecessor);
+			if (it != s_nodes.end())
+			{
+				node->dependencies++;
+				it->second->successors.push_back(node);
+			}
+		}
+	}
+
+	if (--node->dependencies == 0)
+		m_queue.schedule(job);
+	return result;
+}
+
+Ref< Job > JobGroup::then(const Job::task_t& task, JobGroup* group)
+{
+	Job* job = group ? group->createGrouped(task) : create(task);
+	Ref< Job > result = job;
+
+	// Continuation in another group can be used as predecessor
+	// thus need to be registered before it's scheduled.
+	if (group)
+	{
+		Node* node = new Node();
+		node->job = job;
+		node->group = group;
+
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(s_nodesLock);
+		s_nodes[job] = node;
+	}
+
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_continuationsLock);
+		if (m_pending > 0)
+		{
+			m_continuations.push_back(job);
+			return result;
+		}
+	}
+
+	// Group already finished; schedule continuation immediately.
+	m_queue.schedule(job);
+	return result;
+}
+
+bool JobGroup::wait(int32_t timeout)
+{
+	while (m_pending > 0)
+	{
+		if (!m_queue.m_jobFinishedEvent.wait(timeout))
+			return false;
+	}
+	return true;
+}
+
+Job* JobGroup::create(const Job::task_t& task)
+{
+	Job* job = new Job(m_queue.m_jobFinishedEvent, task);
+	T_SAFE_ADDREF(job);
+	m_queue.m_pending++;
+	return job;
+}
+
+Job* JobGroup::createGrouped(const Job::task_t& task)
+{
+	Job* job = create(task);
+	job->m_grouped = true;
+	m_pending++;
+	return job;
+}
+
+void JobGroup::jobFinished()
+{
+	if (--m_pending > 0)
+		return;
+
+	AlignedVector< Job* > continuations;
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_continuationsLock);
+		continuations.swap(m_continuations);
+	}
+	for (auto continuation : continuations)
+		m_queue.schedule(continuation);
+}
+
+void JobGroup::groupedJobFinished(Job* job)
+{
+	// Unregister node and mark job finished atomically, so a job added after this
+	// point doesn't register as successor of an already finished predecessor.
+	Node* node = nullptr;
+	{
+		T_ANONYMOUS_VAR(Acquire< SpinLock >)(s_nodesLock);
+		auto it = s_nodes.find(job);
+		T_FATAL_ASSERT(it != s_nodes.end());
+		node = it->second;
+		s_nodes.erase(it);
+		job->m_finished = true;
+	}
+
+	// Schedule successors which have no more unfinished predecessors.
+	for (auto successor : node->successors)
+	{
+		if (--successor->dependencies == 0)
+			successor->group->m_queue.schedule(successor->job);
+	}
+
+	Ref< JobGroup > group = node->group;
+	delete node;
+
+	group->jobFinished();
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include "Core/Object.h"
+#include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Thread/Job.h"
+#include "Core/Thread/SpinLock.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_CORE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class JobQueue;
+
+/*! Group of dependent jobs.
+ * \ingroup Core
+ *
+ * Jobs added to a group can declare predecessor jobs, a job
+ * is not scheduled until all of it's predecessors has finished.
+ * Continuations are scheduled as soon as the group has
+ * no unfinished jobs.
+ *
+ * Waiting on a group only wait for jobs in the group, unlike
+ * JobQueue::wait which wait for every job in the queue.
+ *
+ * Dependency state of group jobs is allocated by the group
+ * and released as soon as the job has finished; thus plain
+ * jobs do not carry any of this state.
+ *
+ * \code
+ * Ref< JobGroup > group = new JobGroup();
+ * Ref< Job > a = group->add(taskA);
+ * Ref< Job > b = group->add(taskB, { a });
+ * Ref< Job > c = group->then(taskC);
+ * group->wait();
+ * \endcode
+ */
+class T_DLLCLASS JobGroup : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	/*! Create group of jobs scheduled on job manager queue. */
+	JobGroup();
+
+	/*! Create group of jobs scheduled on given queue. */
+	explicit JobGroup(JobQueue& queue);
+
+	/*! Add job to group.
+	 *
+	 * \param task Job task.
+	 * \param predecessors Jobs, from any group on same queue, which must finish before this job is scheduled; jobs not part of a group are not waited for.
+	 * \return Job handle.
+	 */
+	Ref< Job > add(const Job::task_t& task, const RefArray< Job >& predecessors = RefArray< Job >());
+
+	/*! Add continuation.
+	 *
+	 * Continuation job is scheduled when all jobs in
+	 * this group has finished. Continuation is not part of
+	 * this group but can be added to another group.
+	 *
+	 * \param task Continuation task.
+	 * \param group Optional group which continuation job is part of.
+	 * \return Continuation job handle, can be used as predecessor.
+	 */
+	Ref< Job > then(const Job::task_t& task, JobGroup* group = nullptr);
+
+	/*! Wait until all jobs in group are finished.
+	 *
+	 * \param timeout Timeout in milliseconds; -1 if infinite timeout.
+	 * \return True if jobs have finished, false if timeout.
+	 */
+	bool wait(int32_t timeout = -1);
+
+	/*! Get number of unfinished jobs in group. */
+	int32_t getPending() const { return m_pending; }
+
+private:
+	friend class JobQueue;
+
+	JobQueue& m_queue;
+	std::atomic< int32_t > m_pending;
+	SpinLock m_continuationsLock;
+	AlignedVector< Job* > m_continuations;
+
+	Job* create(const Job::task_t& task);
+
+	Job* createGrouped(const Job::task_t& task);
+
+	void jobFinished();
+
+	/*! Called by queue when a job, which is part of a group, has finished. */
+	static void groupedJobFinished(Job* job);
+};
+
+}
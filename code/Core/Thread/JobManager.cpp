@@ -1,6 +1,6 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,10 +13,16 @@
 
 namespace traktor
 {
+	namespace
+	{
+
+JobManager* s_instance = nullptr;
+JobQueue::Scheduling s_scheduling = JobQueue::Scheduling::Shared;
+
+	}
 
 JobManager& JobManager::getInstance()
 {
-	static JobManager* s_instance = nullptr;
 	if (!s_instance)
 	{
 		s_instance = new JobManager();
@@ -31,15 +37,26 @@ JobManager& JobManager::getInstance()
 
 		s_instance->m_queue.create(
 			coreCount,
-			Thread::Normal
+			Thread::Normal,
+			s_scheduling
 		);
 	}
 	return *s_instance;
 }
 
+bool JobManager::setScheduling(JobQueue::Scheduling scheduling)
+{
+	if (s_instance)
+		return false;
+
+	s_scheduling = scheduling;
+	return true;
+}
+
 void JobManager::destroy()
 {
 	m_queue.destroy();
+	s_instance = nullptr;
 	delete this;
 }
 
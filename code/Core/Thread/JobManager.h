@@ -36,6 +36,19 @@ class T_DLLCLASS JobManager : public ISingleton
 public:
 	static JobManager& getInstance();
 
+	/*! Set job scheduling mode.
+	 *
+	 * Must be called before the job manager is
+	 * created, i.e. before first call to getInstance.
+	 * Default is shared FIFO scheduling; work stealing
+	 * is opt-in and required if jobs fork nested jobs
+	 * since shared scheduling blocks forking workers
+	 * until inner jobs finish.
+	 *
+	 * \return False if job manager has already been created.
+	 */
+	static bool setScheduling(JobQueue::Scheduling scheduling);
+
 	/*! Enqueue job.
 	 *
 	 * Add job to internal worker queue, as soon as
@@ -1,22 +1,34 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022-2023 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Core/RefArray.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobGroup.h"
 #include "Core/Thread/JobQueue.h"
 #include "Core/Thread/ThreadManager.h"
 
 namespace traktor
 {
+	namespace
+	{
+
+/*! Number of attempts an idle worker spin before going to sleep. */
+const int32_t c_spinCount = 64;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.JobQueue", JobQueue, Object)
 
 JobQueue::JobQueue()
-:	m_pending(0)
+:	m_scheduling(Scheduling::Shared)
+,	m_pending(0)
+,	m_sleeping(0)
+,	m_victim(0)
 {
 }
 
@@ -25,15 +37,35 @@ JobQueue::~JobQueue()
 	destroy();
 }
 
-bool JobQueue::create(uint32_t workerThreads, Thread::Priority priority)
+bool JobQueue::create(uint32_t workerThreads, Thread::Priority priority, Scheduling scheduling)
 {
+	m_scheduling = scheduling;
+
+	// All workers must exist before any thread is started since
+	// workers immediately start to steal from each other.
+	if (m_scheduling == Scheduling::Stealing)
+	{
+		m_workers.resize(workerThreads);
+		for (uint32_t i = 0; i < workerThreads; ++i)
+		{
+			m_workers[i] = new Worker();
+			m_workers[i]->victim = i + 1;
+		}
+	}
+
 	m_workerThreads.resize(workerThreads);
 	for (uint32_t i = 0; i < uint32_t(m_workerThreads.size()); ++i)
 	{
-		m_workerThreads[i] = ThreadManager::getInstance().create(
-			[=, this]() { threadWorker(); },
-			L"Job queue, worker thread"
-		);
+		if (m_scheduling == Scheduling::Stealing)
+			m_workerThreads[i] = ThreadManager::getInstance().create(
+				[=, this]() { threadWorkerStealing(m_workers[i]); },
+				L"Job queue, worker thread"
+			);
+		else
+			m_workerThreads[i] = ThreadManager::getInstance().create(
+				[=, this]() { threadWorker(); },
+				L"Job queue, worker thread"
+			);
 		if (m_workerThreads[i])
 			m_workerThreads[i]->start(priority);
 		else
@@ -53,15 +85,28 @@ void JobQueue::destroy()
 		ThreadManager::getInstance().destroy(m_workerThreads[i]);
 
 	m_workerThreads.clear();
+
+	// Release jobs which never got a chance to execute.
+	Job* job;
+	for (auto worker : m_workers)
+	{
+		while (worker->deque.steal(job))
+			T_SAFE_RELEASE(job);
+		delete worker;
+	}
+	while (m_jobQueue.get(job))
+		T_SAFE_RELEASE(job);
+
+	m_workers.clear();
+	m_pending = 0;
 }
 
 Ref< Job > JobQueue::add(const Job::task_t& task)
 {
 	Ref< Job > job = new Job(m_jobFinishedEvent, task);
 	T_SAFE_ADDREF(job);
-	m_jobQueue.put(job);
 	m_pending++;
-	m_jobQueuedEvent.pulse();
+	schedule(job);
 	return job;
 }
 
@@ -76,6 +121,17 @@ void JobQueue::fork(const Job::task_t* tasks, size_t ntasks)
 	if (ntasks > 1)
 	{
 		jobs.resize(ntasks);
+		if (m_scheduling == Scheduling::Stealing)
+		{
+			m_pending += (int32_t)(ntasks - 1);
+			for (size_t i = 1; i < ntasks; ++i)
+			{
+				jobs[i] = new Job(m_jobFinishedEvent, tasks[i]);
+				T_SAFE_ADDREF(jobs[i]);
+				enqueue(jobs[i]);
+			}
+		}
+		else
 		{
 			for (size_t i = 1; i < ntasks; ++i)
 			{
@@ -83,14 +139,22 @@ void JobQueue::fork(const Job::task_t* tasks, size_t ntasks)
 				T_SAFE_ADDREF(jobs[i]);
 				m_jobQueue.put(jobs[i]);
 			}
+			m_pending += (int32_t)(ntasks - 1);
+			m_jobQueuedEvent.pulse((int32_t)(ntasks - 1));
 		}
-		m_pending += (int32_t)(ntasks - 1);
-		m_jobQueuedEvent.pulse((int32_t)(ntasks - 1));
 	}
 
 	// Execute first functor on caller thread.
 	tasks[0]();
 
+	// Run forked jobs which no worker has started yet on caller thread; only
+	// jobs of this fork are run so caller never get stuck in unrelated jobs.
+	if (m_scheduling == Scheduling::Stealing)
+	{
+		for (uint32_t i = 1; i < jobs.size(); ++i)
+			run(jobs[i]);
+	}
+
 	// Wait until all jobs has finished.
 	for (uint32_t i = 1; i < jobs.size(); )
 	{
@@ -122,6 +186,85 @@ void JobQueue::stop()
 		m_workerThreads[i]->stop();
 }
 
+void JobQueue::schedule(Job* job)
+{
+	if (m_scheduling == Scheduling::Stealing)
+		enqueue(job);
+	else
+	{
+		m_jobQueue.put(job);
+		m_jobQueuedEvent.pulse();
+	}
+}
+
+void JobQueue::enqueue(Job* job)
+{
+	// Jobs added from a worker thread are pushed onto it's own deque,
+	// from any other thread the job is put into the shared queue.
+	Worker* worker = (Worker*)m_currentWorker.get();
+	if (!worker || !worker->deque.push(job))
+		m_jobQueue.put(job);
+
+	// Only wake a worker through the kernel if there are sleeping workers;
+	// sleeping counter and queues are ordered so a wakeup cannot be missed.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_sleeping > 0)
+		m_jobQueuedEvent.pulse();
+}
+
+bool JobQueue::dequeue(Worker* worker, Job*& outJob)
+{
+	// Newest job from own deque first since it's most likely still in cache.
+	if (worker && worker->deque.pop(outJob))
+		return true;
+
+	// Jobs added from outside of worker threads.
+	if (m_jobQueue.get(outJob))
+		return true;
+
+	// Steal oldest job from any sibling, start at a rotating victim
+	// to spread thieves across workers.
+	const uint32_t nworkers = (uint32_t)m_workers.size();
+	const uint32_t start = worker ? worker->victim++ : m_victim++;
+	for (uint32_t i = 0; i < nworkers; ++i)
+	{
+		Worker* victim = m_workers[(start + i) % nworkers];
+		if (victim != worker && victim->deque.steal(outJob))
+			return true;
+	}
+
+	return false;
+}
+
+void JobQueue::execute(Job* job)
+{
+	run(job);
+	T_SAFE_RELEASE(job);
+}
+
+bool JobQueue::run(Job* job)
+{
+	// Job might already have been run by thread which forked it.
+	if (job->m_claimed.exchange(true))
+		return false;
+
+	auto task = job->m_task;
+	if (task)
+		task();
+
+	// Group jobs are marked finished by their group, which
+	// also schedule successors and continuations.
+	if (job->m_grouped)
+		JobGroup::groupedJobFinished(job);
+	else
+		job->m_finished = true;
+
+	// Decrement number of pending jobs and signal anyone waiting for jobs to finish.
+	m_pending--;
+	m_jobFinishedEvent.broadcast();
+	return true;
+}
+
 void JobQueue::threadWorker()
 {
 	Thread* thread = ThreadManager::getInstance().getCurrentThread();
@@ -136,17 +279,44 @@ void JobQueue::threadWorker()
 			continue;			
 		}
 
-		// Execute job.
-		auto task = job->m_task;
-		if (task)
-			task();
-		job->m_finished = true;
-		T_SAFE_RELEASE(job);
+		execute(job);
+	}
+}
+
+void JobQueue::threadWorkerStealing(Worker* worker)
+{
+	Thread* thread = ThreadManager::getInstance().getCurrentThread();
+	Job* job;
+
+	m_currentWorker.set(worker);
 
-		// Decrement number of pending jobs and signal anyone waiting for jobs to finish.
-		m_pending--;
-		m_jobFinishedEvent.broadcast();
+	while (!thread->stopped())
+	{
+		// Spin for a while before going to sleep, jobs tend to arrive in bursts.
+		bool found = false;
+		for (int32_t i = 0; i < c_spinCount && !found; ++i)
+		{
+			if (!(found = dequeue(worker, job)))
+				thread->yield();
+		}
+
+		if (!found)
+		{
+			// Announce sleep before checking queues a final time, any
+			// job enqueued after this point will pulse the event.
+			m_sleeping++;
+			found = dequeue(worker, job);
+			if (!found)
+				m_jobQueuedEvent.wait(100);
+			m_sleeping--;
+			if (!found)
+				continue;
+		}
+
+		execute(job);
 	}
+
+	m_currentWorker.set(nullptr);
 }
 
 }
@@ -12,11 +12,13 @@
 #include "Core/Object.h"
 #include "Core/Containers/AlignedVector.h"
 #include "Core/Containers/ThreadsafeFifo.h"
+#include "Core/Containers/WorkStealingDeque.h"
 #include "Core/Thread/Event.h"
 #include "Core/Thread/Job.h"
 #include "Core/Thread/Semaphore.h"
 #include "Core/Thread/Signal.h"
 #include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadLocal.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -37,6 +39,13 @@ class T_DLLCLASS JobQueue : public Object
 	T_RTTI_CLASS;
 
 public:
+	/*! Job scheduling mode. */
+	enum class Scheduling
+	{
+		Shared,		//!< All workers fetch jobs from a single shared queue.
+		Stealing	//!< Each worker own a deque; idle workers steal jobs from siblings.
+	};
+
 	JobQueue();
 
 	virtual ~JobQueue();
@@ -44,9 +53,11 @@ public:
 	/*! Create queue.
 	 *
 	 * \param workerThreads Number of worker threads.
+	 * \param priority Priority of worker threads.
+	 * \param scheduling Job scheduling mode.
 	 * \return True if successfully created.
 	 */
-	bool create(uint32_t workerThreads, Thread::Priority priority);
+	bool create(uint32_t workerThreads, Thread::Priority priority, Scheduling scheduling = Scheduling::Shared);
 
 	/*! Destroy queue. */
 	void destroy();
@@ -64,6 +75,10 @@ public:
 	 * Add jobs to internal worker queue, one job
 	 * is always run on the caller thread to reduce
 	 * work for kernel scheduler.
+	 *
+	 * When using work stealing the caller thread also
+	 * run forked jobs which no worker has started yet
+	 * instead of blocking until all forked jobs has finished.
 	 */
 	void fork(const Job::task_t* tasks, size_t ntasks);
 
@@ -84,14 +99,43 @@ public:
 	/*! Stop all worker threads. */
 	void stop();
 
+	/*! Get job scheduling mode. */
+	Scheduling getScheduling() const { return m_scheduling; }
+
 private:
+	friend class JobGroup;
+
+	struct Worker
+	{
+		WorkStealingDeque< Job*, 4096 > deque;
+		uint32_t victim = 0;
+	};
+
+	Scheduling m_scheduling;
 	AlignedVector< Thread* > m_workerThreads;
+	AlignedVector< Worker* > m_workers;
+	ThreadLocal m_currentWorker;
 	ThreadsafeFifo< Job* > m_jobQueue;
 	Event m_jobQueuedEvent;
 	Event m_jobFinishedEvent;
 	std::atomic< int32_t > m_pending;
+	std::atomic< int32_t > m_sleeping;
+	std::atomic< uint32_t > m_victim;
+
+	void schedule(Job* job);
+
+	void enqueue(Job* job);
+
+	bool dequeue(Worker* worker, Job*& outJob);
+
+	void execute(Job* job);
+
+	/*! Run job unless it has already been run, job reference is not released. */
+	bool run(Job* job);
 
 	void threadWorker();
+
+	void threadWorkerStealing(Worker* worker);
 };
 
 }
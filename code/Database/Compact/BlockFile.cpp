@@ -9,11 +9,13 @@
 #include <limits>
 #include "Core/Log/Log.h"
 #include "Core/Io/FileSystem.h"
+#include "Core/Io/IMappedFile.h"
 #include "Core/Io/Reader.h"
 #include "Core/Io/StreamStream.h"
 #include "Core/Io/Writer.h"
 #include "Core/Thread/Acquire.h"
 #include "Database/Compact/BlockFile.h"
+#include "Database/Compact/BlockMappedStream.h"
 #include "Database/Compact/BlockReadStream.h"
 #include "Database/Compact/BlockWriteStream.h"
 
@@ -88,6 +90,12 @@ bool BlockFile::open(const Path& fileName, bool readOnly, bool flushAlways)
 			return false;
 	}
 
+	// Keep blocks sorted by id so they can be found quickly; new
+	// blocks always get highest id thus order is maintained.
+	std::sort(m_blocks.begin(), m_blocks.end(), [](const Block& lh, const Block& rh) {
+		return lh.id < rh.id;
+	});
+
 #if defined(_DEBUG)
 	int64_t last = 0;
 	int64_t size = 0;
@@ -101,6 +109,24 @@ bool BlockFile::open(const Path& fileName, bool readOnly, bool flushAlways)
 
 	m_stream->seek(IStream::SeekSet, c_dataOffset);
 
+	// Map read-only files into memory so concurrent readers don't need to share streams.
+	if (readOnly)
+	{
+		m_mappedFile = FileSystem::getInstance().map(fileName);
+		if (m_mappedFile)
+		{
+			for (const auto& block : m_blocks)
+			{
+				if (block.offset + block.size > m_mappedFile->getSize())
+				{
+					log::error << L"Unable to open block file; block " << block.id << L" outside of file." << Endl;
+					m_mappedFile = nullptr;
+					return false;
+				}
+			}
+		}
+	}
+
 	m_fileName = fileName;
 	m_flushAlways = flushAlways;
 	m_unusedReadStreams.push_back(m_stream);
@@ -120,15 +146,15 @@ void BlockFile::close()
 		m_stream->close();
 
 		m_unusedReadStreams.clear();
+		m_mappedFile = nullptr;
 		m_stream = nullptr;
 	}
 }
 
 uint32_t BlockFile::allocBlockId()
 {
-	uint32_t maxBlockId = 0;
-	for (const auto& block : m_blocks)
-		maxBlockId = std::max(maxBlockId, block.id);
+	// Blocks are sorted by id, thus last block has highest id.
+	const uint32_t maxBlockId = !m_blocks.empty() ? m_blocks.back().id : 0;
 
 	Block block;
 	block.id = maxBlockId + 1;
@@ -141,11 +167,9 @@ uint32_t BlockFile::allocBlockId()
 
 void BlockFile::freeBlockId(uint32_t blockId)
 {
-	auto it = std::find_if(m_blocks.begin(), m_blocks.end(), [=](const Block& b) {
-		return b.id == blockId;
-	});
-	if (it != m_blocks.end())
-		m_blocks.erase(it);
+	Block* block = findBlock(blockId);
+	if (block != nullptr)
+		m_blocks.erase(m_blocks.begin() + int32_t(block - m_blocks.ptr()));
 	else
 		log::warning << L"Unable to free block " << blockId << L", no such block allocated." << Endl;
 }
@@ -209,10 +233,14 @@ int64_t BlockFile::allocateRegion(int64_t size)
 
 Ref< IStream > BlockFile::readBlock(uint32_t blockId)
 {
-	auto it = std::find_if(m_blocks.begin(), m_blocks.end(), [=](const Block& block) { return block.id == blockId; });
-	if (it == m_blocks.end())
+	const Block* block = findBlock(blockId);
+	if (!block)
 		return nullptr;
 
+	// Read-only files are mapped; return view of block's memory region.
+	if (m_mappedFile)
+		return new BlockMappedStream(m_mappedFile, block->offset, block->size);
+
 	Ref< IStream > stream;
 
 	// Pop unused read streams from cache.
@@ -233,19 +261,19 @@ Ref< IStream > BlockFile::readBlock(uint32_t blockId)
 			return nullptr;
 	}
 
-	if (stream->seek(IStream::SeekSet, it->offset) < 0)
+	if (stream->seek(IStream::SeekSet, block->offset) < 0)
 		return nullptr;
 
-	return new BlockReadStream(this, stream, it->offset + it->size);
+	return new BlockReadStream(this, stream, block->offset + block->size);
 }
 
 Ref< IStream > BlockFile::writeBlock(uint32_t blockId)
 {
-	auto it = std::find_if(m_blocks.begin(), m_blocks.end(), [=](const Block& block) { return block.id == blockId; });
-	if (it == m_blocks.end())
+	Block* block = findBlock(blockId);
+	if (!block)
 		return nullptr;
 
-	return new BlockWriteStream(this, m_stream, *it);
+	return new BlockWriteStream(this, m_stream, *block);
 }
 
 void BlockFile::needFlushTOC()
@@ -291,4 +319,12 @@ void BlockFile::returnReadStream(IStream* readStream)
 	m_unusedReadStreams.push_back(readStream);
 }
 
+BlockFile::Block* BlockFile::findBlock(uint32_t blockId)
+{
+	auto it = std::lower_bound(m_blocks.begin(), m_blocks.end(), blockId, [](const Block& block, uint32_t id) {
+		return block.id < id;
+	});
+	return (it != m_blocks.end() && it->id == blockId) ? &(*it) : nullptr;
+}
+
 }
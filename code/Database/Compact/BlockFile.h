@@ -18,6 +18,7 @@
 namespace traktor
 {
 
+class IMappedFile;
 class IStream;
 
 }
@@ -27,6 +28,10 @@ namespace traktor::db
 
 /*! Block file
  * \ingroup Database
+ *
+ * Block files opened as read-only are memory mapped, if
+ * possible, and blocks are read directly from mapped
+ * memory without any locking.
  */
 class BlockFile : public Object
 {
@@ -68,10 +73,13 @@ private:
 	Path m_fileName;
 	Semaphore m_lock;
 	Ref< IStream > m_stream;
+	Ref< IMappedFile > m_mappedFile;
 	RefArray< IStream > m_unusedReadStreams;
-	AlignedVector< Block > m_blocks;
+	AlignedVector< Block > m_blocks;	//!< Sorted by block id.
 	bool m_flushAlways = false;
 	bool m_needFlushTOC = false;
+
+	Block* findBlock(uint32_t blockId);
 };
 
 }
@@ -0,0 +1,29 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Io/IMappedFile.h"
+#include "Database/Compact/BlockMappedStream.h"
+
+namespace traktor::db
+{
+
+BlockMappedStream::BlockMappedStream(IMappedFile* mappedFile, int64_t offset, int64_t size)
+:	MemoryStream((const uint8_t*)mappedFile->getBase() + offset, size)
+,	m_mappedFile(mappedFile)
+{
+}
+
+void BlockMappedStream::close()
+{
+	MemoryStream::close();
+	m_buffer = m_bufferPtr = nullptr;
+	m_bufferSize = 0;
+	m_mappedFile = nullptr;
+}
+
+}
@@ -0,0 +1,41 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Core/Io/MemoryStream.h"
+
+namespace traktor
+{
+
+class IMappedFile;
+
+}
+
+namespace traktor::db
+{
+
+/*! Read stream of block in memory mapped block file.
+ * \ingroup Database
+ *
+ * Reads directly from mapped memory, stream keeps
+ * mapping alive until it's released.
+ */
+class BlockMappedStream : public MemoryStream
+{
+public:
+	explicit BlockMappedStream(IMappedFile* mappedFile, int64_t offset, int64_t size);
+
+	virtual void close() override final;
+
+private:
+	Ref< IMappedFile > m_mappedFile;
+};
+
+}
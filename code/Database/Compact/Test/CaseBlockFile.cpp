@@ -0,0 +1,152 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <atomic>
+#include "Core/Guid.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Database/Compact/BlockFile.h"
+#include "Database/Compact/Test/CaseBlockFile.h"
+
+namespace traktor::db::test
+{
+	namespace
+	{
+
+const uint32_t c_blockCount = 500;
+const uint32_t c_threadCount = 4;
+const uint32_t c_iterations = 2;
+
+uint32_t blockSize(uint32_t index)
+{
+	return 64 + (index * 7919) % 4096;
+}
+
+uint8_t blockData(uint32_t index, uint32_t offset)
+{
+	return (uint8_t)((index * 31 + offset * 17) >> 2);
+}
+
+bool verifyBlock(BlockFile* blockFile, uint32_t blockId, uint32_t index)
+{
+	Ref< IStream > stream = blockFile->readBlock(blockId);
+	if (!stream)
+		return false;
+
+	uint8_t buffer[4096 + 64];
+	const uint32_t size = blockSize(index);
+	const bool result = (stream->read(buffer, sizeof(buffer)) == size);
+	stream->close();
+
+	if (!result)
+		return false;
+
+	for (uint32_t i = 0; i < size; ++i)
+	{
+		if (buffer[i] != blockData(index, i))
+			return false;
+	}
+	return true;
+}
+
+/*! Read all blocks from multiple threads concurrently. */
+void readConcurrent(BlockFile* blockFile, const AlignedVector< uint32_t >& blockIds, std::atomic< int32_t >& outErrors)
+{
+	Thread* threads[c_threadCount] = { nullptr };
+
+	for (uint32_t i = 0; i < c_threadCount; ++i)
+	{
+		threads[i] = ThreadManager::getInstance().create([&, i]() {
+			for (uint32_t j = 0; j < c_iterations; ++j)
+			{
+				for (uint32_t k = 0; k < (uint32_t)blockIds.size(); ++k)
+				{
+					const uint32_t index = (k + i * 97) % (uint32_t)blockIds.size();
+					if (!verifyBlock(blockFile, blockIds[index], index))
+						outErrors++;
+				}
+			}
+		}, L"Block file test");
+		threads[i]->start();
+	}
+
+	for (uint32_t i = 0; i < c_threadCount; ++i)
+	{
+		threads[i]->wait();
+		ThreadManager::getInstance().destroy(threads[i]);
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.test.CaseBlockFile", 0, CaseBlockFile, traktor::test::Case)
+
+void CaseBlockFile::run()
+{
+	const std::wstring testPath = OS::getInstance().getWritableFolderPath() + L"/Traktor/Database/Test/" + Guid::create().format();
+	FileSystem::getInstance().makeAllDirectories(testPath);
+
+	const Path fileName = testPath + L"/Blocks.compact";
+
+	// Create block file with blocks of various sizes.
+	AlignedVector< uint32_t > blockIds;
+	{
+		Ref< BlockFile > blockFile = new BlockFile();
+		CASE_ASSERT(blockFile->create(fileName, false));
+
+		uint8_t buffer[4096 + 64];
+		for (uint32_t i = 0; i < c_blockCount; ++i)
+		{
+			const uint32_t blockId = blockFile->allocBlockId();
+			blockIds.push_back(blockId);
+
+			const uint32_t size = blockSize(i);
+			for (uint32_t j = 0; j < size; ++j)
+				buffer[j] = blockData(i, j);
+
+			Ref< IStream > stream = blockFile->writeBlock(blockId);
+			CASE_ASSERT(stream != nullptr);
+			if (!stream)
+				break;
+
+			stream->write(buffer, size);
+			stream->close();
+		}
+		blockFile->flushTOC();
+
+		// Read blocks through shared, recycled, file streams as file is writable.
+		std::atomic< int32_t > errors(0);
+		readConcurrent(blockFile, blockIds, errors);
+		CASE_ASSERT_EQUAL((int32_t)errors, 0);
+
+		blockFile->close();
+	}
+
+	// Read blocks from memory mapped file.
+	{
+		Ref< BlockFile > blockFile = new BlockFile();
+		CASE_ASSERT(blockFile->open(fileName, true, false));
+
+		std::atomic< int32_t > errors(0);
+		readConcurrent(blockFile, blockIds, errors);
+		CASE_ASSERT_EQUAL((int32_t)errors, 0);
+
+		// Unknown blocks must not be found.
+		CASE_ASSERT(blockFile->readBlock(blockIds.back() + 1) == nullptr);
+
+		blockFile->close();
+	}
+
+	FileSystem::getInstance().remove(fileName);
+	FileSystem::getInstance().removeDirectory(testPath);
+}
+
+}
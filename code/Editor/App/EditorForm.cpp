@@ -1846,6 +1846,7 @@ void EditorForm::buildAssetsThread(AlignedVector< Guid > assetGuids, bool rebuil
 		}
 
 		// Build output.
+		const int32_t buildThreads = m_mergedSettings->getProperty< bool >(L"Pipeline.BuildThreads", false) ? m_mergedSettings->getProperty< int32_t >(L"Pipeline.BuildThreads.Count", 1) : 1;
 		Ref< IPipelineBuilder > pipelineBuilder = new PipelineBuilder(
 			&pipelineFactory,
 			m_sourceDatabase,
@@ -1854,7 +1855,8 @@ void EditorForm::buildAssetsThread(AlignedVector< Guid > assetGuids, bool rebuil
 			m_pipelineDb,
 			&instanceCache,
 			this,
-			verbose);
+			verbose,
+			buildThreads);
 
 		if (rebuild)
 			log::info << L"Rebuilding " << dependencySet.size() << L" asset(s)..." << Endl;
@@ -42,6 +42,8 @@ public:
 private:
 	Ref< ui::CheckBox > m_checkVerbose;
 	Ref< ui::CheckBox > m_checkDependsThreads;
+	Ref< ui::CheckBox > m_checkBuildThreads;
+	Ref< ui::Edit > m_editBuildThreadsCount;
 	Ref< ui::CheckBox > m_checkUseAvalanche;
 	Ref< ui::Edit > m_editAvalancheHost;
 	Ref< ui::Edit > m_editAvalanchePort;
@@ -55,6 +57,8 @@ private:
 	Ref< ui::Edit > m_editModelCachePath;
 	Ref< ui::Edit > m_editAssetPath;
 
+	void eventBuildThreadsClick(ui::ButtonClickEvent* event);
+
 	void eventUseCacheClick(ui::ButtonClickEvent* event);
 };
 
@@ -13,4 +13,8 @@ namespace traktor::editor
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.editor.IPipelineCache", IPipelineCache, Object)
 
+void IPipelineCache::prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries)
+{
+}
+
 }
@@ -8,9 +8,11 @@
  */
 #pragma once
 
+#include <utility>
 #include "Core/Guid.h"
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Misc/Key.h"
 #include "Editor/PipelineTypes.h"
 
@@ -47,6 +49,14 @@ public:
 	 */
 	virtual void destroy() = 0;
 
+	/*! Prefetch multiple entries.
+	 *
+	 * Let cache query multiple entries at once, subsequent
+	 * get of prefetched entries might not need to query
+	 * cache individually. Default implementation does nothing.
+	 */
+	virtual void prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries);
+
 	/*!
 	 */
 	virtual Ref< IStream > get(const Guid& guid, const PipelineDependencyHash& hash) = 0;
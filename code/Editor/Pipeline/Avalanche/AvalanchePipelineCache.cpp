@@ -10,19 +10,37 @@
 #include "Compress/Lzf/DeflateStreamLzf.h"
 #include "Compress/Lzf/InflateStreamLzf.h"
 #include "Core/Io/BufferedStream.h"
+#include "Core/Io/DynamicMemoryStream.h"
 #include "Core/Io/OutputStream.h"
+#include "Core/Io/StreamCopy.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Misc/String.h"
 #include "Core/Settings/PropertyBoolean.h"
 #include "Core/Settings/PropertyGroup.h"
 #include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/JobManager.h"
 #include "Editor/Pipeline/Avalanche/AvalanchePipelineCache.h"
 #include "Net/Network.h"
 
 namespace traktor::editor
 {
+	namespace
+	{
+
+const int64_t c_maxPrefetchBlobSize = 1 * 1024 * 1024;	//!< Only prefetch blobs smaller than this.
+const int64_t c_maxPrefetchSize = 64 * 1024 * 1024;		//!< Max total size of prefetched blobs.
+
+/*! Combine guid and hash to generate 128-bit storage key. */
+Key getStorageKey(const Guid& guid, const PipelineDependencyHash& hash)
+{
+	const Guid gk = guid.permutation(Guid((const uint8_t*)&hash));
+	const uint32_t* kv = (const uint32_t*)(const uint8_t*)gk;
+	return Key(kv[0], kv[1], kv[2], kv[3]);
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.editor.AvalanchePipelineCache", AvalanchePipelineCache, IPipelineCache)
 
@@ -60,18 +78,84 @@ void AvalanchePipelineCache::destroy()
 		m_statsJob->wait();
 		m_statsJob = nullptr;
 	}
+	m_prefetchMissing.clear();
+	m_prefetched.clear();
 	safeDestroy(m_client);
 }
 
+void AvalanchePipelineCache::prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries)
+{
+	if (!m_accessRead || entries.empty())
+		return;
+
+	AlignedVector< Key > keys;
+	keys.reserve(entries.size());
+	for (const auto& entry : entries)
+		keys.push_back(getStorageKey(entry.first, entry.second));
+
+	// Query size of all entries in batches, missing entries are thus known without further requests.
+	AlignedVector< int64_t > sizes;
+	if (!m_client->stat(keys, sizes) || sizes.size() != keys.size())
+		return;
+
+	AlignedVector< Key > fetchKeys;
+	int64_t fetchSize = 0;
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_prefetchLock);
+		m_prefetchMissing.clear();
+		m_prefetched.clear();
+		for (uint32_t i = 0; i < (uint32_t)keys.size(); ++i)
+		{
+			if (sizes[i] < 0)
+				m_prefetchMissing.insert(keys[i]);
+			else if (sizes[i] <= c_maxPrefetchBlobSize && fetchSize + sizes[i] <= c_maxPrefetchSize)
+			{
+				fetchKeys.push_back(keys[i]);
+				fetchSize += sizes[i];
+			}
+		}
+	}
+
+	// Get small blobs in batches, kept in memory until requested.
+	m_client->get(fetchKeys, [&](uint32_t index, IStream* stream) {
+		if (!stream)
+			return;
+
+		Ref< DynamicMemoryStream > blob = new DynamicMemoryStream(true, true);
+		if (!StreamCopy(blob, stream).execute())
+			return;
+
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_prefetchLock);
+		m_prefetched[fetchKeys[index]] = blob;
+	});
+}
+
 Ref< IStream > AvalanchePipelineCache::get(const Guid& guid, const PipelineDependencyHash& hash)
 {
 	if (!m_accessRead)
 		return nullptr;
 
-	// Combine guid and hash to generate 128-bit storage key.
-	const Guid gk = guid.permutation(Guid((const uint8_t*)&hash));
-	const uint32_t* kv = (const uint32_t*)(const uint8_t*)gk;
-	const Key key(kv[0], kv[1], kv[2], kv[3]);
+	const Key key = getStorageKey(guid, hash);
+
+	// Check prefetched entries first.
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_prefetchLock);
+		if (m_prefetchMissing.find(key) != m_prefetchMissing.end())
+		{
+			m_misses++;
+			return nullptr;
+		}
+
+		auto it = m_prefetched.find(key);
+		if (it != m_prefetched.end())
+		{
+			Ref< DynamicMemoryStream > blob = it->second;
+			m_prefetched.erase(it);
+			blob->seek(IStream::SeekSet, 0);
+			m_hits++;
+			return new compress::InflateStreamLzf(blob);
+		}
+	}
 
 	Ref< IStream > stream = m_client->get(key);
 	if (!stream)
@@ -89,10 +173,13 @@ Ref< IStream > AvalanchePipelineCache::put(const Guid& guid, const PipelineDepen
 	if (!m_accessWrite)
 		return nullptr;
 
-	// Combine guid and hash to generate 128-bit storage key.
-	const Guid gk = guid.permutation(Guid((const uint8_t*)&hash));
-	const uint32_t* kv = (const uint32_t*)(const uint8_t*)gk;
-	const Key key(kv[0], kv[1], kv[2], kv[3]);
+	const Key key = getStorageKey(guid, hash);
+
+	// Entry is no longer missing once it's been put.
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_prefetchLock);
+		m_prefetchMissing.erase(key);
+	}
 
 	Ref< IStream > stream = m_client->put(key);
 	if (!stream)
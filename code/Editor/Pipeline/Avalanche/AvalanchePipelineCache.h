@@ -8,7 +8,11 @@
  */
 #pragma once
 
+#include <atomic>
+#include <map>
+#include <set>
 #include "Avalanche/Dictionary.h"
+#include "Core/Thread/Semaphore.h"
 #include "Editor/IPipelineCache.h"
 
 // import/export mechanism.
@@ -22,6 +26,7 @@
 namespace traktor
 {
 
+class DynamicMemoryStream;
 class Job;
 
 }
@@ -47,6 +52,8 @@ public:
 
 	virtual void destroy() override final;
 
+	virtual void prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries) override final;
+
 	virtual Ref< IStream > get(const Guid& guid, const PipelineDependencyHash& hash) override final;
 
 	virtual Ref< IStream > put(const Guid& guid, const PipelineDependencyHash& hash) override final;
@@ -63,8 +70,11 @@ private:
 	Ref< avalanche::Client > m_client;
 	bool m_accessRead = true;
 	bool m_accessWrite = true;
-	uint32_t m_hits = 0;
-	uint32_t m_misses = 0;
+	std::atomic< uint32_t > m_hits = 0;
+	std::atomic< uint32_t > m_misses = 0;
+	Semaphore m_prefetchLock;
+	std::set< Key > m_prefetchMissing;
+	std::map< Key, Ref< DynamicMemoryStream > > m_prefetched;
 	Ref< Job > m_statsJob;
 	avalanche::Dictionary::Stats m_stats;
 };
@@ -19,6 +19,8 @@
 #include "Core/Settings/PropertyInteger.h"
 #include "Core/System/OS.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobGroup.h"
+#include "Core/Thread/JobQueue.h"
 #include "Core/Thread/Thread.h"
 #include "Core/Thread/ThreadManager.h"
 #include "Core/Timer/Timer.h"
@@ -116,7 +118,8 @@ PipelineBuilder::PipelineBuilder(
 	IPipelineDb* pipelineDb,
 	IPipelineInstanceCache* instanceCache,
 	IListener* listener,
-	bool verbose)
+	bool verbose,
+	int32_t buildThreads)
 	: m_pipelineFactory(pipelineFactory)
 	, m_sourceDatabase(sourceDatabase)
 	, m_outputDatabase(outputDatabase)
@@ -125,10 +128,10 @@ PipelineBuilder::PipelineBuilder(
 	, m_instanceCache(instanceCache)
 	, m_listener(listener)
 	, m_verbose(verbose)
+	, m_buildThreads(buildThreads)
 	, m_rebuild(false)
 	, m_profiler(new PipelineProfiler())
 	, m_dependencySet(nullptr)
-	, m_adHocDepth(0)
 	, m_progressEnd(0)
 	, m_progress(0)
 	, m_succeeded(0)
@@ -146,6 +149,96 @@ PipelineBuilder::PipelineBuilder(
 	m_dataAccessCache = new DataAccessCache(m_profiler, m_cache);
 }
 
+void PipelineBuilder::calculateBuildGraph(
+	const PipelineDependencySet* dependencySet,
+	const AlignedVector< uint32_t >& work,
+	AlignedVector< AlignedVector< uint32_t > >& outPredecessors,
+	AlignedVector< uint32_t >& outOrder
+)
+{
+	AlignedVector< int32_t > workIndices(dependencySet->size(), -1);
+	for (uint32_t i = 0; i < (uint32_t)work.size(); ++i)
+		workIndices[work[i]] = (int32_t)i;
+
+	// Each work item must wait for nearest work items reachable through used children,
+	// work items further down are implicitly waited upon through those.
+	outPredecessors.resize(0);
+	outPredecessors.resize(work.size());
+	for (uint32_t i = 0; i < (uint32_t)work.size(); ++i)
+	{
+		const PipelineDependency* dependency = dependencySet->get(work[i]);
+		T_ASSERT(dependency);
+
+		SmallSet< uint32_t > visited;
+		visited.insert(work[i]);
+
+		AlignedVector< uint32_t > children;
+		children.insert(children.end(), dependency->children.begin(), dependency->children.end());
+
+		while (!children.empty())
+		{
+			const uint32_t child = children.back();
+			children.pop_back();
+
+			if (!visited.insert(child))
+				continue;
+
+			const PipelineDependency* childDependency = dependencySet->get(child);
+			T_ASSERT(childDependency);
+
+			if ((childDependency->flags & PdfUse) == 0)
+				continue;
+
+			if (workIndices[child] >= 0)
+				outPredecessors[i].push_back((uint32_t)workIndices[child]);
+			else
+				children.insert(children.end(), childDependency->children.begin(), childDependency->children.end());
+		}
+	}
+
+	// Depth first traversal to get a topological order, edges closing a cycle are
+	// dropped so graph is acyclic. Traversal is in work set order so result is deterministic.
+	outOrder.resize(0);
+	AlignedVector< uint8_t > visit(work.size(), 0);
+	for (uint32_t i = 0; i < (uint32_t)work.size(); ++i)
+	{
+		if (visit[i] != 0)
+			continue;
+
+		AlignedVector< std::pair< uint32_t, uint32_t > > stack;
+		stack.push_back({ i, 0 });
+		visit[i] = 1;
+
+		while (!stack.empty())
+		{
+			const uint32_t current = stack.back().first;
+			auto& edges = outPredecessors[current];
+
+			if (stack.back().second < edges.size())
+			{
+				const uint32_t next = edges[stack.back().second];
+				if (visit[next] == 1)
+				{
+					edges.erase(edges.begin() + stack.back().second);
+					continue;
+				}
+				stack.back().second++;
+				if (visit[next] == 0)
+				{
+					visit[next] = 1;
+					stack.push_back({ next, 0 });
+				}
+			}
+			else
+			{
+				visit[current] = 2;
+				outOrder.push_back(current);
+				stack.pop_back();
+			}
+		}
+	}
+}
+
 bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool rebuild)
 {
 	T_ANONYMOUS_VAR(ScopeIndent)(log::info);
@@ -155,6 +248,7 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 
 	struct Work
 	{
+		uint32_t index;
 		Ref< const PipelineDependency > dependency;
 		Ref< const Object > buildParams;
 		uint32_t reason;
@@ -318,11 +412,40 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 		}
 
 		if (reasons[i] != 0)
-			workSet.push_back({ dependency, nullptr, reasons[i] });
+			workSet.push_back({ i, dependency, nullptr, reasons[i] });
 	}
 
 	T_DEBUG(L"Pipeline build; analyzed build reasons in " << formatDuration(timer.getDeltaTime()) << L".");
 
+	// Let cache prefetch entire work set at once rather than being queried for each output.
+	if (m_cache && !workSet.empty())
+	{
+		AlignedVector< std::pair< Guid, PipelineDependencyHash > > entries;
+		for (const auto& w : workSet)
+		{
+			if ((w.dependency->flags & PdfBuild) == 0 || !w.dependency->pipelineType)
+				continue;
+
+			Ref< IPipeline > pipeline = m_pipelineFactory->findPipeline(*w.dependency->pipelineType);
+			if (!pipeline || !pipeline->shouldCache())
+				continue;
+
+			PipelineDependencyHash hash;
+			calculateGlobalHash(
+				dependencySet,
+				w.dependency,
+				hash.pipelineHash,
+				hash.sourceAssetHash,
+				hash.sourceDataHash,
+				hash.filesHash);
+
+			entries.push_back({ w.dependency->outputGuid, hash });
+		}
+		m_cache->prefetch(entries);
+
+		T_DEBUG(L"Pipeline build; prefetched cache in " << formatDuration(timer.getDeltaTime()) << L".");
+	}
+
 	if (m_verbose && !workSet.empty())
 		log::info << L"Dispatching " << (int32_t)workSet.size() << L" build(s)..." << Endl;
 
@@ -337,31 +460,61 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 	m_cacheVoid = 0; // No hash on source asset will result in a void.
 	m_dependencySet = dependencySet;
 
-	for (const auto& w : workSet)
+	if (m_buildThreads <= 1 || workSet.size() <= 1)
 	{
-		if (ThreadManager::getInstance().getCurrentThread()->stopped())
-			break;
-
-		if (m_listener)
-			m_listener->beginBuild(
-				m_progress,
-				m_progressEnd,
-				w.dependency);
-
-		const BuildResult result = performBuild(dependencySet, w.dependency, w.buildParams, w.reason);
-		if (result == BuildResult::Succeeded || result == BuildResult::SucceededWithWarnings)
-			m_succeeded++;
-		else
-			m_failed++;
+		for (const auto& w : workSet)
+		{
+			if (ThreadManager::getInstance().getCurrentThread()->stopped())
+				break;
 
-		if (m_listener)
-			m_listener->endBuild(
-				m_progress,
-				m_progressEnd,
-				w.dependency,
-				result);
+			buildWork(dependencySet, w.dependency, w.buildParams, w.reason);
+		}
+	}
+	else
+	{
+		AlignedVector< uint32_t > work(workSet.size());
+		for (uint32_t i = 0; i < (uint32_t)workSet.size(); ++i)
+			work[i] = workSet[i].index;
+
+		AlignedVector< AlignedVector< uint32_t > > predecessors;
+		AlignedVector< uint32_t > order;
+		calculateBuildGraph(dependencySet, work, predecessors, order);
+
+		T_DEBUG(L"Pipeline build; scheduled build graph in " << formatDuration(timer.getDeltaTime()) << L".");
 
-		m_progress++;
+		if (m_verbose)
+			log::info << L"Building using " << m_buildThreads << L" thread(s)..." << Endl;
+
+		JobQueue queue;
+		if (!queue.create(m_buildThreads, Thread::Normal))
+		{
+			log::error << L"Unable to create build threads." << Endl;
+			return false;
+		}
+
+		Thread* buildThread = ThreadManager::getInstance().getCurrentThread();
+		Ref< JobGroup > group = new JobGroup(queue);
+		RefArray< Job > jobs(workSet.size());
+
+		for (const uint32_t i : order)
+		{
+			RefArray< Job > waitFor;
+			for (const uint32_t predecessor : predecessors[i])
+				waitFor.push_back(jobs[predecessor]);
+
+			jobs[i] = group->add([&, i]() {
+				if (buildThread->stopped())
+					return;
+
+				BuildContext context;
+				m_currentContext.set(&context);
+				buildWork(dependencySet, workSet[i].dependency, workSet[i].buildParams, workSet[i].reason);
+				m_currentContext.set(nullptr);
+			}, waitFor);
+		}
+
+		group->wait();
+		queue.destroy();
 	}
 
 	// Log cache performance.
@@ -413,16 +566,19 @@ Ref< ISerializable > PipelineBuilder::buildProduct(const db::Instance* sourceIns
 	if (const ISerializable* sbp = dynamic_type_cast< const ISerializable* >(buildParams))
 		sourceHash += DeepHash(sbp).get();
 
-	auto it = m_builtCache.find(sourceHash);
-	if (it != m_builtCache.end())
 	{
-		built_cache_list_t& bcl = it->second;
-		T_ASSERT(!bcl.empty());
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_builtCacheLock);
+		auto it = m_builtCache.find(sourceHash);
+		if (it != m_builtCache.end())
+		{
+			built_cache_list_t& bcl = it->second;
+			T_ASSERT(!bcl.empty());
 
-		// Return same instance as before if pointer and hash match.
-		for (built_cache_list_t::const_iterator j = bcl.begin(); j != bcl.end(); ++j)
-			if (j->sourceAsset == sourceAsset)
-				return j->product;
+			// Return same instance as before if pointer and hash match.
+			for (built_cache_list_t::const_iterator j = bcl.begin(); j != bcl.end(); ++j)
+				if (j->sourceAsset == sourceAsset)
+					return j->product;
+		}
 	}
 
 	m_profiler->begin(*pipelineType);
@@ -431,12 +587,14 @@ Ref< ISerializable > PipelineBuilder::buildProduct(const db::Instance* sourceIns
 	if (!product)
 		return nullptr;
 
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_builtCacheLock);
 	m_builtCache[sourceHash].push_back({ sourceAsset, product });
 	return product;
 }
 
 bool PipelineBuilder::buildAdHocOutput(const Guid& outputGuid)
 {
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_adHocLock);
 	m_adHocBuilds.insert(outputGuid);
 	return true;
 }
@@ -449,6 +607,7 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const G
 
 bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const std::wstring& outputPath, const Guid& outputGuid, const Object* buildParams)
 {
+	BuildContext& context = getContext();
 	PipelineDependencySet dependencySet;
 
 	// Exclude filtering; already added dependencies and built ad-hocs should be excluded from further ad-hoc builds.
@@ -456,10 +615,8 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 		if (m_dependencySet->get(id) != PipelineDependencySet::DiInvalid)
 			return false;
 
-		if (m_adHocBuilds.find(id) != m_adHocBuilds.end())
-			return false;
-
-		return true;
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_adHocLock);
+		return m_adHocBuilds.find(id) == m_adHocBuilds.end();
 	};
 
 	// Scan dependencies of source asset; exclude dependencies already in work set.
@@ -495,8 +652,13 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 		if ((dependency->flags & PdfBuild) == 0)
 			continue;
 
-		if (m_adHocBuilds.find(dependency->outputGuid) != m_adHocBuilds.end())
-			continue;
+		// Claim output before building; multiple outputs might request same ad-hoc
+		// output concurrently and only the first request should build it.
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_adHocLock);
+			if (!m_adHocBuilds.insert(dependency->outputGuid).second)
+				continue;
+		}
 
 		// Calculate hash entry.
 		PipelineDependencyHash dependencyHash;
@@ -525,9 +687,9 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 		// Build output instances; keep an array of written instances as we
 		// need them to update the cache for this specific build.
 		RefArray< db::Instance > previousBuiltInstances;
-		m_builtInstances.swap(previousBuiltInstances);
+		context.builtInstances.swap(previousBuiltInstances);
 		AlignedVector< CacheKey > previousBuiltAdHocKeys;
-		m_builtAdHocKeys.swap(previousBuiltAdHocKeys);
+		context.builtAdHocKeys.swap(previousBuiltAdHocKeys);
 
 		// Get output instances from memory cache.
 		if (m_cache && pipeline->shouldCache() && cachePermitted)
@@ -535,10 +697,10 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 			if (getInstancesFromCache(
 					m_cache,
 					{ dependency->outputGuid, dependencyHash },
-					&m_builtInstances,
-					&m_builtAdHocKeys) == 0)
+					&context.builtInstances,
+					&context.builtAdHocKeys) == 0)
 			{
-				for (const auto& child : m_builtAdHocKeys)
+				for (const auto& child : context.builtAdHocKeys)
 				{
 					const int32_t result = getInstancesFromCache(
 						m_cache,
@@ -555,12 +717,10 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 				m_pipelineDb->setDependency(dependency->outputGuid, dependencyHash);
 
 				previousBuiltAdHocKeys.push_back({ dependency->outputGuid, dependencyHash });
-				previousBuiltAdHocKeys.insert(previousBuiltAdHocKeys.end(), m_builtAdHocKeys.begin(), m_builtAdHocKeys.end());
-
-				m_builtInstances.swap(previousBuiltInstances);
-				m_builtAdHocKeys.swap(previousBuiltAdHocKeys);
+				previousBuiltAdHocKeys.insert(previousBuiltAdHocKeys.end(), context.builtAdHocKeys.begin(), context.builtAdHocKeys.end());
 
-				m_adHocBuilds.insert(dependency->outputGuid);
+				context.builtInstances.swap(previousBuiltInstances);
+				context.builtAdHocKeys.swap(previousBuiltAdHocKeys);
 
 				m_cacheHit++;
 				continue;
@@ -572,10 +732,10 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 			m_cacheVoid++;
 
 		if (m_verbose)
-			log::info << L"Building \"" << dependency->outputPath << L"\" (ad-hoc " << m_adHocDepth << L")..." << Endl;
+			log::info << L"Building \"" << dependency->outputPath << L"\" (ad-hoc " << context.adHocDepth << L")..." << Endl;
 		log::info << IncreaseIndent;
 
-		m_adHocDepth++;
+		context.adHocDepth++;
 		m_profiler->begin(*dependency->pipelineType);
 		result &= pipeline->buildOutput(
 			this,
@@ -588,19 +748,19 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 			(index == i) ? buildParams : nullptr,
 			PbrSourceModified);
 		m_profiler->end();
-		m_adHocDepth--;
+		context.adHocDepth--;
 
 		if (result && m_cache && pipeline->shouldCache() && cachePermitted)
 		{
 			const int32_t result = putInstancesInCache(
 				m_cache,
 				{ dependency->outputGuid, dependencyHash },
-				m_builtInstances,
-				m_builtAdHocKeys);
+				context.builtInstances,
+				context.builtAdHocKeys);
 			if (result == 0)
 			{
 				previousBuiltAdHocKeys.push_back({ dependency->outputGuid, dependencyHash });
-				previousBuiltAdHocKeys.insert(previousBuiltAdHocKeys.end(), m_builtAdHocKeys.begin(), m_builtAdHocKeys.end());
+				previousBuiltAdHocKeys.insert(previousBuiltAdHocKeys.end(), context.builtAdHocKeys.begin(), context.builtAdHocKeys.end());
 			}
 			else
 			{
@@ -616,10 +776,8 @@ bool PipelineBuilder::buildAdHocOutput(const ISerializable* sourceAsset, const s
 
 		// Restore previous set but also insert built instances from synthesized build;
 		// when caching is enabled then synthesized built instances should be included in parent build as well.
-		m_builtInstances.swap(previousBuiltInstances);
-		m_builtAdHocKeys.swap(previousBuiltAdHocKeys);
-
-		m_adHocBuilds.insert(dependency->outputGuid);
+		context.builtInstances.swap(previousBuiltInstances);
+		context.builtAdHocKeys.swap(previousBuiltAdHocKeys);
 
 		log::info << DecreaseIndent;
 		if (m_verbose)
@@ -680,6 +838,7 @@ Ref< ISerializable > PipelineBuilder::getBuildProduct(const ISerializable* sourc
 
 	const uint32_t sourceHash = DeepHash(sourceAsset).get();
 
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_builtCacheLock);
 	const auto it = m_builtCache.find(sourceHash);
 	if (it == m_builtCache.end())
 		return nullptr;
@@ -692,6 +851,7 @@ Ref< ISerializable > PipelineBuilder::getBuildProduct(const ISerializable* sourc
 
 Ref< db::Instance > PipelineBuilder::createOutputInstance(const std::wstring& instancePath, const Guid& instanceGuid)
 {
+	BuildContext& context = getContext();
 	Ref< db::Instance > instance;
 
 	if (instanceGuid.isNull() || !instanceGuid.isValid())
@@ -724,7 +884,7 @@ Ref< db::Instance > PipelineBuilder::createOutputInstance(const std::wstring& in
 		&instanceGuid);
 	if (instance)
 	{
-		m_builtInstances.push_back(instance);
+		context.builtInstances.push_back(instance);
 		return instance;
 	}
 	else
@@ -766,6 +926,46 @@ PipelineProfiler* PipelineBuilder::getProfiler() const
 	return m_profiler;
 }
 
+PipelineBuilder::BuildContext& PipelineBuilder::getContext()
+{
+	BuildContext* context = (BuildContext*)m_currentContext.get();
+	return context ? *context : m_context;
+}
+
+void PipelineBuilder::buildWork(
+	const PipelineDependencySet* dependencySet,
+	const PipelineDependency* dependency,
+	const Object* buildParams,
+	uint32_t reason)
+{
+	if (m_listener)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_listenerLock);
+		m_listener->beginBuild(
+			m_progress,
+			m_progressEnd,
+			dependency);
+	}
+
+	const BuildResult result = performBuild(dependencySet, dependency, buildParams, reason);
+	if (result == BuildResult::Succeeded || result == BuildResult::SucceededWithWarnings)
+		m_succeeded++;
+	else
+		m_failed++;
+
+	if (m_listener)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_listenerLock);
+		m_listener->endBuild(
+			m_progress,
+			m_progressEnd,
+			dependency,
+			result);
+	}
+
+	m_progress++;
+}
+
 IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 	const PipelineDependencySet* dependencySet,
 	const PipelineDependency* dependency,
@@ -800,8 +1000,10 @@ IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 	Ref< IPipeline > pipeline = m_pipelineFactory->findPipeline(*dependency->pipelineType);
 	T_ASSERT(pipeline);
 
-	m_builtInstances.resize(0);
-	m_builtAdHocKeys.resize(0);
+	BuildContext& context = getContext();
+
+	context.builtInstances.resize(0);
+	context.builtAdHocKeys.resize(0);
 
 	// Get output instances from cache.
 	if (m_cache && pipeline->shouldCache())
@@ -809,10 +1011,10 @@ IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 		if (getInstancesFromCache(
 				m_cache,
 				{ dependency->outputGuid, currentDependencyHash },
-				&m_builtInstances,
-				&m_builtAdHocKeys) == 0)
+				&context.builtInstances,
+				&context.builtAdHocKeys) == 0)
 		{
-			for (const auto& child : m_builtAdHocKeys)
+			for (const auto& child : context.builtAdHocKeys)
 			{
 				const int32_t result = getInstancesFromCache(
 						m_cache,
@@ -879,8 +1081,8 @@ IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 		const int32_t pr = putInstancesInCache(
 			m_cache,
 			{ dependency->outputGuid, currentDependencyHash },
-			m_builtInstances,
-			m_builtAdHocKeys);
+			context.builtInstances,
+			context.builtAdHocKeys);
 		if (pr != 0)
 		{
 			log::error << L"Failed to add instances to pipeline cache (result " << pr << L")." << Endl;
@@ -901,8 +1103,8 @@ IPipelineBuilder::BuildResult PipelineBuilder::performBuild(
 			log::info << L"Build \"" << dependency->outputPath << L"\" failed (" << type_name(pipeline) << L")." << Endl;
 	}
 
-	m_builtInstances.resize(0);
-	m_builtAdHocKeys.resize(0);
+	context.builtInstances.resize(0);
+	context.builtAdHocKeys.resize(0);
 
 	if (result)
 		return (warningTarget.getCount() + errorTarget.getCount()) > 0 ? BuildResult::SucceededWithWarnings : BuildResult::Succeeded;
@@ -1,6 +1,6 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,12 +8,15 @@
  */
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Io/Path.h"
 #include "Core/Thread/Semaphore.h"
+#include "Core/Thread/ThreadLocal.h"
 #include "Editor/IPipelineBuilder.h"
 #include "Editor/PipelineTypes.h"
 
@@ -50,6 +53,10 @@ class PipelineProfiler;
 
 /*! Pipeline manager.
  * \ingroup Editor
+ *
+ * If more than one build thread is used then the work set
+ * is scheduled as a dependency graph, an output is only built
+ * after all of it's used dependencies have been built.
  */
 class T_DLLCLASS PipelineBuilder : public IPipelineBuilder
 {
@@ -64,7 +71,8 @@ public:
 		IPipelineDb* db,
 		IPipelineInstanceCache* instanceCache,
 		IListener* listener,
-		bool verbose
+		bool verbose,
+		int32_t buildThreads = 1
 	);
 
 	virtual bool build(const PipelineDependencySet* dependencySet, bool rebuild) override final;
@@ -93,6 +101,20 @@ public:
 
 	virtual PipelineProfiler* getProfiler() const override final;
 
+	/*! Calculate build graph of work set.
+	 *
+	 * \param dependencySet Dependency set.
+	 * \param work Indices into dependency set of outputs to build.
+	 * \param outPredecessors Per work item, indices into work of items which must be built first.
+	 * \param outOrder Topological order of work items, predecessors always come first.
+	 */
+	static void calculateBuildGraph(
+		const PipelineDependencySet* dependencySet,
+		const AlignedVector< uint32_t >& work,
+		AlignedVector< AlignedVector< uint32_t > >& outPredecessors,
+		AlignedVector< uint32_t >& outOrder
+	);
+
 private:
 	struct CacheKey
 	{
@@ -108,6 +130,14 @@ private:
 
 	typedef std::list< BuiltCacheEntry > built_cache_list_t;
 
+	/*! Per thread build state. */
+	struct BuildContext
+	{
+		RefArray< db::Instance > builtInstances;
+		AlignedVector< CacheKey > builtAdHocKeys;
+		int32_t adHocDepth = 0;
+	};
+
 	Ref< PipelineFactory > m_pipelineFactory;
 	Ref< db::Database > m_sourceDatabase;
 	Ref< db::Database > m_outputDatabase;
@@ -117,25 +147,34 @@ private:
 	Ref< DataAccessCache > m_dataAccessCache;
 	IListener* m_listener;
 	bool m_verbose;
+	int32_t m_buildThreads;
 	bool m_rebuild;
 	Ref< PipelineProfiler > m_profiler;
 	const PipelineDependencySet* m_dependencySet;
 	std::map< Guid, Ref< ISerializable > > m_readCache;
+	Semaphore m_builtCacheLock;
 	std::map< uint32_t, built_cache_list_t > m_builtCache;
 	mutable Semaphore m_inclusiveHashCacheLock;
 	mutable SmallMap< uint32_t, uint32_t > m_inclusiveHashCache;
+	Semaphore m_adHocLock;
 	std::set< Guid > m_adHocBuilds;
-	RefArray< db::Instance > m_builtInstances;
-	AlignedVector< CacheKey > m_builtAdHocKeys;
-	int32_t m_adHocDepth;
+	BuildContext m_context;
+	ThreadLocal m_currentContext;
+	Semaphore m_listenerLock;
 	int32_t m_progressEnd;
-	int32_t m_progress;
-	int32_t m_succeeded;
-	int32_t m_succeededBuilt;
-	int32_t m_failed;
-	int32_t m_cacheHit;
-	int32_t m_cacheMiss;
-	int32_t m_cacheVoid;
+	std::atomic< int32_t > m_progress;
+	std::atomic< int32_t > m_succeeded;
+	std::atomic< int32_t > m_succeededBuilt;
+	std::atomic< int32_t > m_failed;
+	std::atomic< int32_t > m_cacheHit;
+	std::atomic< int32_t > m_cacheMiss;
+	std::atomic< int32_t > m_cacheVoid;
+
+	/*! Get build state of calling thread. */
+	BuildContext& getContext();
+
+	/*! Build work item and report progress to listener. */
+	void buildWork(const PipelineDependencySet* dependencySet, const PipelineDependency* dependency, const Object* buildParams, uint32_t reason);
 
 	/*! Perform build. */
 	BuildResult performBuild(const PipelineDependencySet* dependencySet, const PipelineDependency* dependency, const Object* buildParams, uint32_t reason);
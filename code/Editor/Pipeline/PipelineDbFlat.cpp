@@ -6,14 +6,17 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstddef>
+#include <cstring>
 #include "Core/Io/FileSystem.h"
-#include "Core/Io/BufferedStream.h"
+#include "Core/Io/IMappedFile.h"
+#include "Core/Io/IStream.h"
+#include "Core/Io/Utf8Encoding.h"
 #include "Core/Log/Log.h"
+#include "Core/Misc/Murmur3.h"
 #include "Core/Misc/Split.h"
 #include "Core/Misc/String.h"
-#include "Core/Serialization/BinarySerializer.h"
-#include "Core/Serialization/MemberComposite.h"
-#include "Core/Serialization/MemberSmallMap.h"
+#include "Core/Misc/TString.h"
 #include "Core/Thread/Acquire.h"
 #include "Editor/Pipeline/PipelineDbFlat.h"
 
@@ -22,52 +25,166 @@ namespace traktor::editor
 	namespace
 	{
 
-const uint32_t c_version = 3;
+const uint32_t c_indexMagic = 0x42445054;	//!< "TPDB"
+const uint32_t c_journalMagic = 0x4a445054;	//!< "TPDJ"
+const uint32_t c_version = 5;
 const uint32_t c_flushAfterChanges = 100;	//!< Flush pipeline after N changes.
+const uint32_t c_compactAfterRecords = 4096;	//!< Merge journal into index when journal contain at least N records...
+const uint32_t c_compactAfterRatio = 4;	//!< ...and more than 1/N of indexed records.
 
-class MemberPipelineDependencyHash : public MemberComplex
+enum JournalRecordType : uint8_t
 {
-public:
-	MemberPipelineDependencyHash(const wchar_t* const name, PipelineDependencyHash& ref)
-	:	MemberComplex(name, true)
-	,	m_ref(ref)
-	{
-	}
+	JrtDependency = 1,
+	JrtFile = 2
+};
 
-	void serialize(ISerializer& s) const
-	{
-		s >> Member< uint32_t >(L"pipelineHash", m_ref.pipelineHash);
-		s >> Member< uint32_t >(L"sourceAssetHash", m_ref.sourceAssetHash);
-		s >> Member< uint32_t >(L"sourceDataHash", m_ref.sourceDataHash);
-		s >> Member< uint32_t >(L"filesHash", m_ref.filesHash);
-	}
+struct DependencyRecord
+{
+	uint8_t guid[16];
+	uint32_t pipelineHash;
+	uint32_t sourceAssetHash;
+	uint32_t sourceDataHash;
+	uint32_t filesHash;
+};
 
-private:
-	PipelineDependencyHash& m_ref;
+struct FileRecord
+{
+	uint64_t size;
+	uint64_t lastWriteTime;
+	uint32_t hash;
+	uint32_t pathHash;
+	uint32_t pathOffset;
+	uint32_t pathLength;
 };
 
-class MemberPipelineFileHash : public MemberComplex
+static_assert(sizeof(DependencyRecord) == 32, "Incorrect dependency record size");
+static_assert(sizeof(FileRecord) == 32, "Incorrect file record size");
+
+uint32_t hashKey(const void* data, uint32_t size)
+{
+	Murmur3 h;
+	h.begin();
+	h.feedBuffer(data, size);
+	h.end();
+	return h.get();
+}
+
+uint32_t hashKey(const Guid& guid)
+{
+	return hashKey((const uint8_t*)guid, 16);
+}
+
+uint32_t hashKey(const std::string& path)
+{
+	return hashKey(path.c_str(), (uint32_t)path.length());
+}
+
+/*! Number of hash slots, keep load factor below 0.5 and slot tables 8 byte aligned. */
+uint32_t getSlotCount(uint32_t count)
+{
+	uint32_t slotCount = 16;
+	while (slotCount < count * 2)
+		slotCount <<= 1;
+	return slotCount;
+}
+
+template < typename ValueType >
+void writeJournal(AlignedVector< uint8_t >& journal, const ValueType& value)
+{
+	const size_t offset = journal.size();
+	journal.resize(offset + sizeof(ValueType));
+	std::memcpy(&journal[offset], &value, sizeof(ValueType));
+}
+
+template < typename ValueType >
+bool readJournal(const uint8_t*& ptr, const uint8_t* end, ValueType& outValue)
 {
-public:
-	MemberPipelineFileHash(const wchar_t* const name, PipelineFileHash& ref)
-	:	MemberComplex(name, true)
-	,	m_ref(ref)
+	if (ptr + sizeof(ValueType) > end)
+		return false;
+	std::memcpy(&outValue, ptr, sizeof(ValueType));
+	ptr += sizeof(ValueType);
+	return true;
+}
+
+	}
+
+/*! Index file layout.
+ *
+ * header | dependency records | dependency slots | file records | file slots | UTF-8 paths
+ *
+ * Slots contain record index + 1, 0 denote empty slot; collisions are resolved
+ * using linear probing. Only header is validated when index is opened, slots and
+ * records are validated when accessed and invalid entries are ignored.
+ */
+struct PipelineDbFlat::IndexHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t dependencyCount;
+	uint32_t dependencySlotCount;
+	uint32_t fileCount;
+	uint32_t fileSlotCount;
+	uint32_t stringsSize;
+	uint32_t checksum;
+
+	static uint64_t getSize(uint32_t dependencyCount, uint32_t dependencySlotCount, uint32_t fileCount, uint32_t fileSlotCount, uint32_t stringsSize)
 	{
+		return
+			sizeof(IndexHeader) +
+			(uint64_t)dependencyCount * sizeof(DependencyRecord) +
+			(uint64_t)dependencySlotCount * sizeof(uint32_t) +
+			(uint64_t)fileCount * sizeof(FileRecord) +
+			(uint64_t)fileSlotCount * sizeof(uint32_t) +
+			stringsSize;
 	}
 
-	void serialize(ISerializer& s) const
+	uint64_t getSize() const { return getSize(dependencyCount, dependencySlotCount, fileCount, fileSlotCount, stringsSize); }
+
+	/*! Calculate checksum of header fields. */
+	uint32_t calculateChecksum() const
 	{
-		s >> Member< uint64_t >(L"size", m_ref.size);
-		s >> MemberComposite< DateTime >(L"lastWriteTime", m_ref.lastWriteTime);
-		s >> Member< uint32_t >(L"hash", m_ref.hash);
+		return hashKey(this, (uint32_t)offsetof(IndexHeader, checksum));
 	}
 
-private:
-	PipelineFileHash& m_ref;
-};
+	/*! Validate header against file size; records and slots are checked when accessed. */
+	bool validate(int64_t size) const
+	{
+		if (
+			size < (int64_t)sizeof(IndexHeader) ||
+			magic != c_indexMagic ||
+			version != c_version ||
+			checksum != calculateChecksum() ||
+			(uint64_t)size < getSize()
+		)
+			return false;
+
+		// Slot counts must be power of two and larger than record count so probing always reach an empty slot.
+		if (
+			dependencySlotCount == 0 || (dependencySlotCount & (dependencySlotCount - 1)) != 0 || dependencySlotCount <= dependencyCount ||
+			fileSlotCount == 0 || (fileSlotCount & (fileSlotCount - 1)) != 0 || fileSlotCount <= fileCount
+		)
+			return false;
 
+		return true;
 	}
 
+	/*! Check if file record's path is inside of string blob. */
+	bool validPath(const FileRecord& record) const
+	{
+		return (uint64_t)record.pathOffset + record.pathLength <= stringsSize;
+	}
+
+	DependencyRecord* dependencies() const { return (DependencyRecord*)(this + 1); }
+
+	uint32_t* dependencySlots() const { return (uint32_t*)(dependencies() + dependencyCount); }
+
+	FileRecord* files() const { return (FileRecord*)(dependencySlots() + dependencySlotCount); }
+
+	uint32_t* fileSlots() const { return (uint32_t*)(files() + fileCount); }
+
+	char* strings() const { return (char*)(fileSlots() + fileSlotCount); }
+};
+
 T_IMPLEMENT_RTTI_CLASS(L"traktor.editor.PipelineDbFlat", PipelineDbFlat, IPipelineDb)
 
 bool PipelineDbFlat::open(const std::wstring& connectionString)
@@ -94,47 +211,32 @@ bool PipelineDbFlat::open(const std::wstring& connectionString)
 	}
 
 	m_file = cs[L"fileName"];
+	m_journalFile = m_file + L".journal";
 
 	// If flat database file doesn't exist we assume this is the first run; ie. don't fail.
-	if (!FileSystem::getInstance().exist(m_file))
+	const bool indexExist = FileSystem::getInstance().exist(m_file);
+	const bool journalExist = FileSystem::getInstance().exist(m_journalFile);
+	if (!indexExist && !journalExist)
 	{
 		// But ensure full path is created first.
 		return FileSystem::getInstance().makeAllDirectories(Path(m_file).getPathOnly());
 	}
 
-	Ref< IStream > f = FileSystem::getInstance().open(m_file, File::FmRead);
-	if (!f)
+	if (indexExist && !mapIndex())
 	{
-		log::error << L"Unable to open pipeline db; failed to open file." << Endl;
-		return false;
+		log::warning << L"Pipeline database version mismatch or corrupt; database purged and rebuild is required." << Endl;
+		FileSystem::getInstance().remove(m_file);
+		FileSystem::getInstance().remove(m_journalFile);
+		return true;
 	}
 
-	BinarySerializer s(f);
-
-	uint32_t version = 0;
-	s >> Member< uint32_t >(L"version", version);
-
-	if (version == c_version)
+	if (journalExist && !replayJournal())
 	{
-		s >> MemberSmallMap<
-			Guid,
-			PipelineDependencyHash,
-			Member< Guid >,
-			MemberPipelineDependencyHash
-		>(L"dependencies", m_dependencies);
-
-		s >> MemberSmallMap<
-			std::wstring,
-			PipelineFileHash,
-			Member< std::wstring >,
-			MemberPipelineFileHash
-		>(L"files", m_files);
+		// Journal has an incomplete tail, merge valid records into a new
+		// index so further records are not appended after garbage.
+		if (!compact())
+			return false;
 	}
-	else
-		log::warning << L"Pipeline database version mismatch; database purged and rebuild is required." << Endl;
-
-	f->close();
-	f = nullptr;
 
 	return true;
 }
@@ -143,6 +245,13 @@ void PipelineDbFlat::close()
 {
 	if (m_transaction)
 		endTransaction();
+
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+	unmapIndex();
+	m_dependencies.clear();
+	m_files.clear();
+	m_addedDependencies.clear();
+	m_addedFiles.clear();
 }
 
 void PipelineDbFlat::beginTransaction()
@@ -154,40 +263,10 @@ void PipelineDbFlat::beginTransaction()
 
 void PipelineDbFlat::endTransaction()
 {
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
 	T_FATAL_ASSERT(m_transaction);
-	if (m_changes > 0)
-	{
-		Ref< IStream > f = FileSystem::getInstance().open(m_file, File::FmWrite);
-		if (f)
-		{
-			BufferedStream bs(f);
-			BinarySerializer s(&bs);
-
-			uint32_t version = c_version;
-			s >> Member< uint32_t >(L"version", version);
-
-			s >> MemberSmallMap<
-				Guid,
-				PipelineDependencyHash,
-				Member< Guid >,
-				MemberPipelineDependencyHash
-			>(L"dependencies", m_dependencies);
-
-			s >> MemberSmallMap<
-				std::wstring,
-				PipelineFileHash,
-				Member< std::wstring >,
-				MemberPipelineFileHash
-			>(L"files", m_files);
-
-			bs.close();
-			f = nullptr;
-
-			m_changes = 0;
-		}
-		else
-			log::error << L"Unable to flush pipeline db; failed to write latest changes." << Endl;
-	}
+	flush();
+	m_changes = 0;
 	m_transaction = false;
 }
 
@@ -195,21 +274,44 @@ void PipelineDbFlat::setDependency(const Guid& guid, const PipelineDependencyHas
 {
 	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
 	T_FATAL_ASSERT(m_transaction);
-	m_dependencies[guid] = hash;
+
+	updateDependency(guid, hash);
+
+	writeJournal< uint8_t >(m_journal, JrtDependency);
+	m_journal.insert(m_journal.end(), (const uint8_t*)guid, (const uint8_t*)guid + 16);
+	writeJournal(m_journal, hash.pipelineHash);
+	writeJournal(m_journal, hash.sourceAssetHash);
+	writeJournal(m_journal, hash.sourceDataHash);
+	writeJournal(m_journal, hash.filesHash);
+	m_journalRecords++;
+
 	if (++m_changes >= c_flushAfterChanges)
 	{
-		endTransaction();
-		beginTransaction();
+		flush();
+		m_changes = 0;
 	}
 }
 
 bool PipelineDbFlat::getDependency(const Guid& guid, PipelineDependencyHash& outHash) const
 {
 	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
+
 	auto it = m_dependencies.find(guid);
-	if (it == m_dependencies.end())
+	if (it != m_dependencies.end())
+	{
+		outHash = it->second;
+		return true;
+	}
+
+	const int32_t index = findIndexedDependency(guid);
+	if (index < 0)
 		return false;
-	outHash = it->second;
+
+	const DependencyRecord& record = m_header->dependencies()[index];
+	outHash.pipelineHash = record.pipelineHash;
+	outHash.sourceAssetHash = record.sourceAssetHash;
+	outHash.sourceDataHash = record.sourceDataHash;
+	outHash.filesHash = record.filesHash;
 	return true;
 }
 
@@ -217,11 +319,22 @@ void PipelineDbFlat::setFile(const Path& path, const PipelineFileHash& file)
 {
 	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
 	T_FATAL_ASSERT(m_transaction);
-	m_files[path.getPathName()] = file;
+
+	const std::string key = wstombs(Utf8Encoding(), path.getPathName());
+	updateFile(key, file);
+
+	writeJournal< uint8_t >(m_journal, JrtFile);
+	writeJournal(m_journal, (uint32_t)key.length());
+	m_journal.insert(m_journal.end(), (const uint8_t*)key.c_str(), (const uint8_t*)key.c_str() + key.length());
+	writeJournal(m_journal, file.size);
+	writeJournal(m_journal, file.lastWriteTime.getSecondsSinceEpoch());
+	writeJournal(m_journal, file.hash);
+	m_journalRecords++;
+
 	if (++m_changes >= c_flushAfterChanges)
 	{
-		endTransaction();
-		beginTransaction();
+		flush();
+		m_changes = 0;
 	}
 }
 
@@ -229,54 +342,512 @@ bool PipelineDbFlat::getFile(const Path& path, PipelineFileHash& outFile) const
 {
 	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
 
-	auto it = m_files.find(path.getPathName());
-	if (it == m_files.end())
+	const std::string key = wstombs(Utf8Encoding(), path.getPathName());
+
+	auto it = m_files.find(key);
+	if (it != m_files.end())
+	{
+		outFile = it->second;
+		return true;
+	}
+
+	const int32_t index = findIndexedFile(key);
+	if (index < 0)
 		return false;
 
-	outFile = it->second;
+	const FileRecord& record = m_header->files()[index];
+	outFile.size = record.size;
+	outFile.lastWriteTime = DateTime(record.lastWriteTime);
+	outFile.hash = record.hash;
 	return true;
 }
 
 uint32_t PipelineDbFlat::getDependencyCount() const
 {
 	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
-	return (uint32_t)m_dependencies.size();
+	return (m_header ? m_header->dependencyCount : 0) + (uint32_t)m_addedDependencies.size();
 }
 
 bool PipelineDbFlat::getDependencyByIndex(uint32_t index, Guid& outGuid, PipelineDependencyHash& outHash) const
 {
 	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
 
-	if (index >= m_dependencies.size())
-		return false;
+	const uint32_t indexedCount = m_header ? m_header->dependencyCount : 0;
+	if (index < indexedCount)
+	{
+		const DependencyRecord& record = m_header->dependencies()[index];
+		outGuid = Guid(record.guid);
 
-	auto it = m_dependencies.begin();
-	std::advance(it, index);
+		auto it = m_dependencies.find(outGuid);
+		if (it != m_dependencies.end())
+			outHash = it->second;
+		else
+		{
+			outHash.pipelineHash = record.pipelineHash;
+			outHash.sourceAssetHash = record.sourceAssetHash;
+			outHash.sourceDataHash = record.sourceDataHash;
+			outHash.filesHash = record.filesHash;
+		}
+		return true;
+	}
 
-	outGuid = it->first;
-	outHash = it->second;
+	index -= indexedCount;
+	if (index >= m_addedDependencies.size())
+		return false;
+
+	outGuid = m_addedDependencies[index];
+	outHash = m_dependencies.find(outGuid)->second;
 	return true;
 }
 
 uint32_t PipelineDbFlat::getFileCount() const
 {
 	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
-	return (uint32_t)m_files.size();
+	return (m_header ? m_header->fileCount : 0) + (uint32_t)m_addedFiles.size();
 }
 
 bool PipelineDbFlat::getFileByIndex(uint32_t index, Path& outPath, PipelineFileHash& outFile) const
 {
 	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
 
-	if (index >= m_dependencies.size())
+	const uint32_t indexedCount = m_header ? m_header->fileCount : 0;
+	if (index < indexedCount)
+	{
+		const FileRecord& record = m_header->files()[index];
+		if (!m_header->validPath(record))
+			return false;
+
+		const std::string key(m_header->strings() + record.pathOffset, record.pathLength);
+		outPath = Path(mbstows(Utf8Encoding(), key));
+
+		auto it = m_files.find(key);
+		if (it != m_files.end())
+			outFile = it->second;
+		else
+		{
+			outFile.size = record.size;
+			outFile.lastWriteTime = DateTime(record.lastWriteTime);
+			outFile.hash = record.hash;
+		}
+		return true;
+	}
+
+	index -= indexedCount;
+	if (index >= m_addedFiles.size())
+		return false;
+
+	const std::string& key = m_addedFiles[index];
+	outPath = Path(mbstows(Utf8Encoding(), key));
+	outFile = m_files.find(key)->second;
+	return true;
+}
+
+bool PipelineDbFlat::mapIndex()
+{
+	const uint8_t* base = nullptr;
+	int64_t size = 0;
+
+	m_index = FileSystem::getInstance().map(m_file);
+	if (m_index)
+	{
+		base = (const uint8_t*)m_index->getBase();
+		size = m_index->getSize();
+	}
+	else
+	{
+		// Volume doesn't support mapping, read entire index into memory instead.
+		Ref< IStream > f = FileSystem::getInstance().open(m_file, File::FmRead);
+		if (!f)
+			return false;
+
+		m_indexBuffer.resize((size_t)f->available());
+		const int64_t nread = f->read(m_indexBuffer.ptr(), m_indexBuffer.size());
+		f->close();
+
+		if (nread != (int64_t)m_indexBuffer.size())
+		{
+			m_indexBuffer.clear();
+			return false;
+		}
+
+		base = m_indexBuffer.c_ptr();
+		size = (int64_t)m_indexBuffer.size();
+	}
+
+	const IndexHeader* header = (const IndexHeader*)base;
+	if (!header || !header->validate(size))
+	{
+		unmapIndex();
+		return false;
+	}
+
+	m_header = header;
+	return true;
+}
+
+void PipelineDbFlat::unmapIndex()
+{
+	m_header = nullptr;
+	m_index = nullptr;
+	m_indexBuffer.clear();
+}
+
+bool PipelineDbFlat::replayJournal()
+{
+	AlignedVector< uint8_t > buffer;
+	const uint8_t* ptr = nullptr;
+	const uint8_t* end = nullptr;
+
+	Ref< IMappedFile > journal = FileSystem::getInstance().map(m_journalFile);
+	if (journal)
+	{
+		ptr = (const uint8_t*)journal->getBase();
+		end = ptr + journal->getSize();
+	}
+	else
+	{
+		Ref< IStream > f = FileSystem::getInstance().open(m_journalFile, File::FmRead);
+		if (!f)
+			return false;
+
+		buffer.resize((size_t)f->available());
+		buffer.resize((size_t)std::max< int64_t >(f->read(buffer.ptr(), buffer.size()), 0));
+		f->close();
+
+		ptr = buffer.c_ptr();
+		end = ptr + buffer.size();
+	}
+
+	uint32_t magic = 0, version = 0;
+	if (!readJournal(ptr, end, magic) || !readJournal(ptr, end, version) || magic != c_journalMagic || version != c_version)
+	{
+		log::warning << L"Pipeline database journal corrupt or version mismatch; journal discarded." << Endl;
+		return false;
+	}
+
+	// Replay records until end of journal; a partial record at end is expected
+	// if a previous session terminated while appending to journal.
+	while (ptr < end)
+	{
+		uint8_t type = 0;
+		readJournal(ptr, end, type);
+
+		if (type == JrtDependency)
+		{
+			uint8_t guid[16];
+			PipelineDependencyHash hash;
+			if (
+				!readJournal(ptr, end, guid) ||
+				!readJournal(ptr, end, hash.pipelineHash) ||
+				!readJournal(ptr, end, hash.sourceAssetHash) ||
+				!readJournal(ptr, end, hash.sourceDataHash) ||
+				!readJournal(ptr, end, hash.filesHash)
+			)
+				return false;
+			updateDependency(Guid(guid), hash);
+		}
+		else if (type == JrtFile)
+		{
+			uint32_t length = 0;
+			if (!readJournal(ptr, end, length) || (size_t)length > (size_t)(end - ptr))
+				return false;
+
+			const std::string key((const char*)ptr, length);
+			ptr += length;
+
+			PipelineFileHash file;
+			uint64_t lastWriteTime = 0;
+			if (
+				!readJournal(ptr, end, file.size) ||
+				!readJournal(ptr, end, lastWriteTime) ||
+				!readJournal(ptr, end, file.hash)
+			)
+				return false;
+			file.lastWriteTime = DateTime(lastWriteTime);
+			updateFile(key, file);
+		}
+		else
+			return false;
+
+		m_journaled++;
+	}
+
+	return true;
+}
+
+void PipelineDbFlat::flush()
+{
+	if (m_journal.empty())
+		return;
+
+	const bool created = !FileSystem::getInstance().exist(m_journalFile);
+
+	Ref< IStream > f = FileSystem::getInstance().open(m_journalFile, File::FmAppend);
+	if (!f)
+	{
+		log::error << L"Unable to flush pipeline db; failed to write latest changes." << Endl;
+		return;
+	}
+
+	if (created)
+	{
+		const uint32_t header[] = { c_journalMagic, c_version };
+		f->write(header, sizeof(header));
+	}
+
+	const bool written = (f->write(m_journal.c_ptr(), m_journal.size()) == (int64_t)m_journal.size());
+	f->close();
+
+	if (!written)
+	{
+		log::error << L"Unable to flush pipeline db; failed to write latest changes." << Endl;
+		return;
+	}
+
+	m_journaled += m_journalRecords;
+	m_journalRecords = 0;
+	m_journal.resize(0);
+
+	// Merge journal into index when replaying it on open become noticeable.
+	const uint32_t indexedCount = m_header ? m_header->dependencyCount + m_header->fileCount : 0;
+	if (m_journaled >= c_compactAfterRecords && m_journaled > indexedCount / c_compactAfterRatio)
+		compact();
+}
+
+bool PipelineDbFlat::compact()
+{
+	const uint32_t indexedDependencyCount = m_header ? m_header->dependencyCount : 0;
+	const uint32_t indexedFileCount = m_header ? m_header->fileCount : 0;
+	const uint32_t indexedStringsSize = m_header ? m_header->stringsSize : 0;
+
+	const uint32_t dependencyCount = indexedDependencyCount + (uint32_t)m_addedDependencies.size();
+	const uint32_t dependencySlotCount = getSlotCount(dependencyCount);
+	const uint32_t fileCount = indexedFileCount + (uint32_t)m_addedFiles.size();
+	const uint32_t fileSlotCount = getSlotCount(fileCount);
+
+	uint32_t stringsSize = indexedStringsSize;
+	for (const auto& key : m_addedFiles)
+		stringsSize += (uint32_t)key.length();
+
+	AlignedVector< uint8_t > buffer;
+	buffer.resize((size_t)IndexHeader::getSize(dependencyCount, dependencySlotCount, fileCount, fileSlotCount, stringsSize), 0);
+
+	IndexHeader* header = (IndexHeader*)buffer.ptr();
+	header->magic = c_indexMagic;
+	header->version = c_version;
+	header->dependencyCount = dependencyCount;
+	header->dependencySlotCount = dependencySlotCount;
+	header->fileCount = fileCount;
+	header->fileSlotCount = fileSlotCount;
+	header->stringsSize = stringsSize;
+	header->checksum = header->calculateChecksum();
+
+	// Existing records keep their index, modified records are patched in place
+	// and added records are appended.
+	if (m_header)
+	{
+		std::memcpy(header->dependencies(), m_header->dependencies(), indexedDependencyCount * sizeof(DependencyRecord));
+		std::memcpy(header->files(), m_header->files(), indexedFileCount * sizeof(FileRecord));
+		std::memcpy(header->strings(), m_header->strings(), indexedStringsSize);
+	}
+
+	for (const auto& it : m_dependencies)
+	{
+		const int32_t index = findIndexedDependency(it.first);
+		if (index >= 0)
+		{
+			DependencyRecord& record = header->dependencies()[index];
+			record.pipelineHash = it.second.pipelineHash;
+			record.sourceAssetHash = it.second.sourceAssetHash;
+			record.sourceDataHash = it.second.sourceDataHash;
+			record.filesHash = it.second.filesHash;
+		}
+	}
+
+	uint32_t addedDependency = indexedDependencyCount;
+	for (const auto& guid : m_addedDependencies)
+	{
+		const PipelineDependencyHash& hash = m_dependencies.find(guid)->second;
+		DependencyRecord& record = header->dependencies()[addedDependency++];
+		std::memcpy(record.guid, (const uint8_t*)guid, 16);
+		record.pipelineHash = hash.pipelineHash;
+		record.sourceAssetHash = hash.sourceAssetHash;
+		record.sourceDataHash = hash.sourceDataHash;
+		record.filesHash = hash.filesHash;
+	}
+
+	for (const auto& it : m_files)
+	{
+		const int32_t index = findIndexedFile(it.first);
+		if (index >= 0)
+		{
+			FileRecord& record = header->files()[index];
+			record.size = it.second.size;
+			record.lastWriteTime = it.second.lastWriteTime.getSecondsSinceEpoch();
+			record.hash = it.second.hash;
+		}
+	}
+
+	uint32_t addedFile = indexedFileCount;
+	uint32_t stringsOffset = indexedStringsSize;
+	for (const auto& key : m_addedFiles)
+	{
+		const PipelineFileHash& file = m_files.find(key)->second;
+		FileRecord& record = header->files()[addedFile++];
+		record.size = file.size;
+		record.lastWriteTime = file.lastWriteTime.getSecondsSinceEpoch();
+		record.hash = file.hash;
+		record.pathHash = hashKey(key);
+		record.pathOffset = stringsOffset;
+		record.pathLength = (uint32_t)key.length();
+		std::memcpy(header->strings() + stringsOffset, key.c_str(), key.length());
+		stringsOffset += (uint32_t)key.length();
+	}
+
+	// Build hash slots.
+	for (uint32_t i = 0; i < dependencyCount; ++i)
+	{
+		uint32_t slot = hashKey(header->dependencies()[i].guid, 16) & (dependencySlotCount - 1);
+		while (header->dependencySlots()[slot] != 0)
+			slot = (slot + 1) & (dependencySlotCount - 1);
+		header->dependencySlots()[slot] = i + 1;
+	}
+	for (uint32_t i = 0; i < fileCount; ++i)
+	{
+		uint32_t slot = header->files()[i].pathHash & (fileSlotCount - 1);
+		while (header->fileSlots()[slot] != 0)
+			slot = (slot + 1) & (fileSlotCount - 1);
+		header->fileSlots()[slot] = i + 1;
+	}
+
+	// Write new index beside current, then replace current; index must be
+	// unmapped before it can be replaced.
+	const std::wstring temporaryFile = m_file + L"~";
+	{
+		Ref< IStream > f = FileSystem::getInstance().open(temporaryFile, File::FmWrite);
+		if (!f)
+		{
+			log::error << L"Unable to compact pipeline db; failed to create index." << Endl;
+			return false;
+		}
+		const bool written = (f->write(buffer.c_ptr(), buffer.size()) == (int64_t)buffer.size());
+		f->close();
+		if (!written)
+		{
+			log::error << L"Unable to compact pipeline db; failed to write index." << Endl;
+			FileSystem::getInstance().remove(temporaryFile);
+			return false;
+		}
+	}
+
+	unmapIndex();
+
+	if (!FileSystem::getInstance().move(m_file, temporaryFile, true))
+	{
+		log::error << L"Unable to compact pipeline db; failed to replace index." << Endl;
+		FileSystem::getInstance().remove(temporaryFile);
+		mapIndex();
 		return false;
+	}
+
+	// Journal is fully merged into index; crash before journal is removed only
+	// cause records to be replayed again.
+	FileSystem::getInstance().remove(m_journalFile);
 
-	auto it = m_files.begin();
-	std::advance(it, index);
+	m_dependencies.clear();
+	m_files.clear();
+	m_addedDependencies.clear();
+	m_addedFiles.clear();
+	m_journal.resize(0);
+	m_journalRecords = 0;
+	m_journaled = 0;
+
+	if (!mapIndex())
+	{
+		log::error << L"Unable to compact pipeline db; failed to map index." << Endl;
+		return false;
+	}
 
-	outPath = it->first;
-	outFile = it->second;
 	return true;
 }
 
+void PipelineDbFlat::updateDependency(const Guid& guid, const PipelineDependencyHash& hash)
+{
+	auto it = m_dependencies.find(guid);
+	if (it == m_dependencies.end())
+	{
+		if (findIndexedDependency(guid) < 0)
+			m_addedDependencies.push_back(guid);
+		m_dependencies.insert(std::make_pair(guid, hash));
+	}
+	else
+		it->second = hash;
+}
+
+void PipelineDbFlat::updateFile(const std::string& path, const PipelineFileHash& file)
+{
+	auto it = m_files.find(path);
+	if (it == m_files.end())
+	{
+		if (findIndexedFile(path) < 0)
+			m_addedFiles.push_back(path);
+		m_files.insert(std::make_pair(path, file));
+	}
+	else
+		it->second = file;
+}
+
+int32_t PipelineDbFlat::findIndexedDependency(const Guid& guid) const
+{
+	if (!m_header || m_header->dependencyCount == 0)
+		return -1;
+
+	const DependencyRecord* records = m_header->dependencies();
+	const uint32_t* slots = m_header->dependencySlots();
+	const uint32_t mask = m_header->dependencySlotCount - 1;
+
+	uint32_t slot = hashKey(guid) & mask;
+	for (uint32_t i = 0; i <= mask && slots[slot] != 0; ++i, slot = (slot + 1) & mask)
+	{
+		const uint32_t index = slots[slot] - 1;
+		if (index >= m_header->dependencyCount)
+			continue;
+		if (std::memcmp(records[index].guid, (const uint8_t*)guid, 16) == 0)
+			return (int32_t)index;
+	}
+
+	return -1;
+}
+
+int32_t PipelineDbFlat::findIndexedFile(const std::string& path) const
+{
+	if (!m_header || m_header->fileCount == 0)
+		return -1;
+
+	const FileRecord* records = m_header->files();
+	const uint32_t* slots = m_header->fileSlots();
+	const char* strings = m_header->strings();
+	const uint32_t mask = m_header->fileSlotCount - 1;
+	const uint32_t pathHash = hashKey(path);
+
+	uint32_t slot = pathHash & mask;
+	for (uint32_t i = 0; i <= mask && slots[slot] != 0; ++i, slot = (slot + 1) & mask)
+	{
+		const uint32_t index = slots[slot] - 1;
+		if (index >= m_header->fileCount)
+			continue;
+
+		const FileRecord& record = records[index];
+		if (
+			record.pathHash == pathHash &&
+			record.pathLength == (uint32_t)path.length() &&
+			m_header->validPath(record) &&
+			std::memcmp(strings + record.pathOffset, path.c_str(), path.length()) == 0
+		)
+			return (int32_t)index;
+	}
+
+	return -1;
+}
+
 }
@@ -8,8 +8,8 @@
  */
 #pragma once
 
-#include "Core/Containers/SmallMap.h"
-#include "Core/Io/StringOutputStream.h"
+#include <map>
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Thread/ReaderWriterLock.h"
 #include "Editor/IPipelineDb.h"
 
@@ -21,9 +21,28 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class IMappedFile;
+
+}
+
 namespace traktor::editor
 {
 
+/*! Pipeline database stored in flat files.
+ * \ingroup Editor
+ *
+ * Records are stored in a hashed index file which is
+ * memory mapped when database is opened, thus no records
+ * are read until they are queried.
+ *
+ * Modified records are kept in memory and appended
+ * to a journal file when flushed; the journal is
+ * replayed when database is opened and merged
+ * into a new index once it has grown too large.
+ */
 class T_DLLCLASS PipelineDbFlat : public IPipelineDb
 {
 	T_RTTI_CLASS;
@@ -56,10 +75,46 @@ public:
 private:
 	mutable ReaderWriterLock m_lock;
 	std::wstring m_file;
-	SmallMap< Guid, PipelineDependencyHash > m_dependencies;
-	SmallMap< std::wstring, PipelineFileHash > m_files;
+	std::wstring m_journalFile;
+
+	struct IndexHeader;
+
+	// Memory mapped index; read into memory if volume cannot map files.
+	Ref< IMappedFile > m_index;
+	AlignedVector< uint8_t > m_indexBuffer;
+	const IndexHeader* m_header = nullptr;
+
+	// Records modified since index was written, either replayed from journal or set during this session.
+	std::map< Guid, PipelineDependencyHash > m_dependencies;
+	std::map< std::string, PipelineFileHash > m_files;
+	AlignedVector< Guid > m_addedDependencies;
+	AlignedVector< std::string > m_addedFiles;
+
+	// Journal records not yet written to disk.
+	AlignedVector< uint8_t > m_journal;
+	uint32_t m_journalRecords = 0;
+	uint32_t m_journaled = 0;
+
 	uint32_t m_changes = 0;
 	bool m_transaction = false;
+
+	bool mapIndex();
+
+	void unmapIndex();
+
+	bool replayJournal();
+
+	void flush();
+
+	bool compact();
+
+	void updateDependency(const Guid& guid, const PipelineDependencyHash& hash);
+
+	void updateFile(const std::string& path, const PipelineFileHash& file);
+
+	int32_t findIndexedDependency(const Guid& guid) const;
+
+	int32_t findIndexedFile(const std::string& path) const;
 };
 
 }
@@ -0,0 +1,139 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Avalanche/Dictionary.h"
+#include "Avalanche/Client/Client.h"
+#include "Avalanche/Server/Server.h"
+#include "Core/Io/IStream.h"
+#include "Core/Settings/PropertyGroup.h"
+#include "Core/Settings/PropertyInteger.h"
+#include "Core/Settings/PropertyString.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Editor/Pipeline/Avalanche/AvalanchePipelineCache.h"
+#include "Editor/Test/CaseAvalanchePipelineCache.h"
+#include "Net/Network.h"
+#include "Net/SocketAddressIPv4.h"
+
+namespace traktor::editor::test
+{
+	namespace
+	{
+
+const int32_t c_port = 20003;
+const int32_t c_entryCount = 16;
+const int32_t c_entrySize = 4096;
+
+std::pair< Guid, PipelineDependencyHash > getEntry(int32_t index)
+{
+	const uint8_t data[16] = { (uint8_t)index, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+	PipelineDependencyHash hash;
+	hash.pipelineHash = index;
+	hash.sourceAssetHash = index * 3;
+	return { Guid(data), hash };
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.editor.test.CaseAvalanchePipelineCache", 0, CaseAvalanchePipelineCache, traktor::test::Case)
+
+void CaseAvalanchePipelineCache::run()
+{
+	CASE_ASSERT(net::Network::initialize());
+
+	Ref< PropertyGroup > serverSettings = new PropertyGroup();
+	serverSettings->setProperty< PropertyInteger >(L"Avalanche.Port", c_port);
+
+	Ref< avalanche::Server > server = new avalanche::Server();
+	CASE_ASSERT(server->create(serverSettings));
+
+	Thread* serverThread = ThreadManager::getInstance().create([&](){
+		while (!serverThread->stopped())
+			server->update();
+	});
+	CASE_ASSERT(serverThread != nullptr);
+	if (serverThread == nullptr)
+		return;
+
+	serverThread->start();
+
+	Ref< PropertyGroup > settings = new PropertyGroup();
+	settings->setProperty< PropertyString >(L"Pipeline.AvalancheCache.Host", L"localhost");
+	settings->setProperty< PropertyInteger >(L"Pipeline.AvalancheCache.Port", c_port);
+
+	Ref< AvalanchePipelineCache > cache = new AvalanchePipelineCache();
+	CASE_ASSERT(cache->create(settings));
+
+	// Put half of the entries.
+	for (int32_t i = 0; i < c_entryCount / 2; ++i)
+	{
+		const auto entry = getEntry(i);
+		Ref< IStream > stream = cache->put(entry.first, entry.second);
+		CASE_ASSERT(stream != nullptr);
+		if (!stream)
+			continue;
+
+		uint8_t data[c_entrySize];
+		for (int32_t j = 0; j < c_entrySize; ++j)
+			data[j] = (uint8_t)(i + j);
+		CASE_ASSERT_EQUAL(stream->write(data, sizeof(data)), (int64_t)sizeof(data));
+		stream->close();
+		CASE_ASSERT(cache->commit(entry.first, entry.second));
+	}
+
+	// Prefetch all entries then get each of them, missing entries must not be requested individually.
+	AlignedVector< std::pair< Guid, PipelineDependencyHash > > entries;
+	for (int32_t i = 0; i < c_entryCount; ++i)
+		entries.push_back(getEntry(i));
+	cache->prefetch(entries);
+
+	bool correct = true;
+	for (int32_t i = 0; i < c_entryCount; ++i)
+	{
+		Ref< IStream > stream = cache->get(entries[i].first, entries[i].second);
+		if (i >= c_entryCount / 2)
+		{
+			correct &= (stream == nullptr);
+			continue;
+		}
+
+		if (!stream)
+		{
+			correct = false;
+			continue;
+		}
+
+		uint8_t data[c_entrySize];
+		correct &= (stream->read(data, sizeof(data)) == sizeof(data));
+		for (int32_t j = 0; j < c_entrySize; ++j)
+			correct &= (data[j] == (uint8_t)(i + j));
+		stream->close();
+	}
+	CASE_ASSERT(correct);
+
+	// Each existing entry fetched exactly once, in batch, and no missing entry requested.
+	Ref< avalanche::Client > client = new avalanche::Client(net::SocketAddressIPv4(L"localhost", c_port));
+	avalanche::Dictionary::Stats stats;
+	CASE_ASSERT(client->stats(stats));
+	CASE_ASSERT_EQUAL(stats.hits, (uint64_t)(c_entryCount / 2));
+	CASE_ASSERT_EQUAL(stats.misses, (uint64_t)0);
+	client->destroy();
+
+	cache->destroy();
+	cache = nullptr;
+
+	serverThread->stop();
+	ThreadManager::getInstance().destroy(serverThread);
+
+	server->destroy();
+	server = nullptr;
+
+	net::Network::finalize();
+}
+
+}
@@ -0,0 +1,105 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Editor/Pipeline/PipelineBuilder.h"
+#include "Editor/PipelineDependency.h"
+#include "Editor/PipelineDependencySet.h"
+#include "Editor/Test/CasePipelineBuildGraph.h"
+
+namespace traktor::editor::test
+{
+	namespace
+	{
+
+Ref< PipelineDependency > createDependency(uint32_t flags, std::initializer_list< uint32_t > children)
+{
+	Ref< PipelineDependency > dependency = new PipelineDependency();
+	dependency->outputGuid = Guid::create();
+	dependency->flags = flags;
+	for (auto child : children)
+		dependency->children.insert(child);
+	return dependency;
+}
+
+bool isOrdered(const AlignedVector< AlignedVector< uint32_t > >& predecessors, const AlignedVector< uint32_t >& order)
+{
+	if (order.size() != predecessors.size())
+		return false;
+
+	AlignedVector< int32_t > position(order.size(), -1);
+	for (uint32_t i = 0; i < (uint32_t)order.size(); ++i)
+	{
+		if (order[i] >= order.size() || position[order[i]] >= 0)
+			return false;
+		position[order[i]] = (int32_t)i;
+	}
+
+	for (uint32_t i = 0; i < (uint32_t)predecessors.size(); ++i)
+	{
+		for (auto predecessor : predecessors[i])
+		{
+			if (position[predecessor] >= position[i])
+				return false;
+		}
+	}
+
+	return true;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.editor.test.CasePipelineBuildGraph", 0, CasePipelineBuildGraph, traktor::test::Case)
+
+void CasePipelineBuildGraph::run()
+{
+	// 0 builds from 1 (used), 2 (not used) and 3 (used but not rebuilt) which in turn use 4.
+	// 5 and 6 use each other.
+	Ref< PipelineDependencySet > dependencySet = new PipelineDependencySet();
+	dependencySet->add(createDependency(PdfBuild, { 1, 2, 3 }));
+	dependencySet->add(createDependency(PdfBuild | PdfUse, { }));
+	dependencySet->add(createDependency(PdfBuild, { }));
+	dependencySet->add(createDependency(PdfBuild | PdfUse, { 4 }));
+	dependencySet->add(createDependency(PdfBuild | PdfUse, { }));
+	dependencySet->add(createDependency(PdfBuild | PdfUse, { 6 }));
+	dependencySet->add(createDependency(PdfBuild | PdfUse, { 5 }));
+
+	const AlignedVector< uint32_t > work = { 0, 1, 2, 4, 5, 6 };
+
+	AlignedVector< AlignedVector< uint32_t > > predecessors;
+	AlignedVector< uint32_t > order;
+	PipelineBuilder::calculateBuildGraph(dependencySet, work, predecessors, order);
+
+	CASE_ASSERT_EQUAL(predecessors.size(), work.size());
+	CASE_ASSERT(isOrdered(predecessors, order));
+
+	// Nearest used work items, through intermediate dependencies not being built.
+	AlignedVector< uint32_t > p0 = predecessors[0];
+	std::sort(p0.begin(), p0.end());
+	CASE_ASSERT_EQUAL((int32_t)p0.size(), 2);
+	if (p0.size() == 2)
+	{
+		CASE_ASSERT_EQUAL((int32_t)p0[0], 1);
+		CASE_ASSERT_EQUAL((int32_t)p0[1], 3);
+	}
+
+	CASE_ASSERT(predecessors[1].empty());
+	CASE_ASSERT(predecessors[2].empty());
+	CASE_ASSERT(predecessors[3].empty());
+
+	// Cycle must be broken, exactly one of the edges remain.
+	CASE_ASSERT_EQUAL((int32_t)(predecessors[4].size() + predecessors[5].size()), 1);
+
+	// Same input must give same graph.
+	AlignedVector< AlignedVector< uint32_t > > predecessors2;
+	AlignedVector< uint32_t > order2;
+	PipelineBuilder::calculateBuildGraph(dependencySet, work, predecessors2, order2);
+	CASE_ASSERT(std::equal(order.begin(), order.end(), order2.begin(), order2.end()));
+}
+
+}
@@ -0,0 +1,266 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+#include "Core/Misc/String.h"
+#include "Core/System/OS.h"
+#include "Editor/Pipeline/PipelineDbFlat.h"
+#include "Editor/Test/CasePipelineDbFlat.h"
+
+namespace traktor::editor::test
+{
+	namespace
+	{
+
+Guid getGuid(uint32_t index)
+{
+	uint8_t data[16] = { 0 };
+	std::memcpy(data, &index, sizeof(index));
+	data[15] = 0x5a;
+	return Guid(data);
+}
+
+PipelineDependencyHash getDependencyHash(uint32_t index, uint32_t generation)
+{
+	PipelineDependencyHash hash;
+	hash.pipelineHash = index;
+	hash.sourceAssetHash = index * 3 + generation;
+	hash.sourceDataHash = index * 5;
+	hash.filesHash = generation;
+	return hash;
+}
+
+Path getFilePath(uint32_t index)
+{
+	return Path(L"C:/Assets/Textures/" + toString(index) + L".png");
+}
+
+PipelineFileHash getFileHash(uint32_t index)
+{
+	PipelineFileHash file;
+	file.size = 1000 + index;
+	file.lastWriteTime = DateTime((uint64_t)(1700000000 + index));
+	file.hash = index * 7;
+	return file;
+}
+
+bool readFile(const std::wstring& fileName, AlignedVector< uint8_t >& outData)
+{
+	Ref< IStream > f = FileSystem::getInstance().open(fileName, File::FmRead);
+	if (!f)
+		return false;
+	outData.resize((size_t)f->available());
+	const bool result = (f->read(outData.ptr(), outData.size()) == (int64_t)outData.size());
+	f->close();
+	return result;
+}
+
+bool writeFile(const std::wstring& fileName, const uint8_t* data, size_t size)
+{
+	Ref< IStream > f = FileSystem::getInstance().open(fileName, File::FmWrite);
+	if (!f)
+		return false;
+	const bool result = (f->write(data, size) == (int64_t)size);
+	f->close();
+	return result;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.editor.test.CasePipelineDbFlat", 0, CasePipelineDbFlat, traktor::test::Case)
+
+void CasePipelineDbFlat::run()
+{
+	const std::wstring path = OS::getInstance().getWritableFolderPath() + L"/Traktor/Editor/Test/" + Guid::create().format();
+	const std::wstring fileName = path + L"/Pipeline.db";
+	const std::wstring connectionString = L"fileName=" + fileName;
+
+	// Records in journal only, must be replayed when reopened.
+	{
+		Ref< PipelineDbFlat > db = new PipelineDbFlat();
+		CASE_ASSERT(db->open(connectionString));
+
+		db->beginTransaction();
+		for (uint32_t i = 0; i < 50; ++i)
+		{
+			db->setDependency(getGuid(i), getDependencyHash(i, 0));
+			db->setFile(getFilePath(i), getFileHash(i));
+		}
+		db->endTransaction();
+		db->close();
+
+		CASE_ASSERT(!FileSystem::getInstance().exist(fileName));
+		CASE_ASSERT(FileSystem::getInstance().exist(fileName + L".journal"));
+
+		CASE_ASSERT(db->open(connectionString));
+		CASE_ASSERT_EQUAL(db->getDependencyCount(), (uint32_t)50);
+		CASE_ASSERT_EQUAL(db->getFileCount(), (uint32_t)50);
+
+		bool correct = true;
+		for (uint32_t i = 0; i < 50; ++i)
+		{
+			PipelineDependencyHash hash;
+			correct &= db->getDependency(getGuid(i), hash) && hash == getDependencyHash(i, 0);
+
+			PipelineFileHash file;
+			correct &= db->getFile(getFilePath(i), file) && file.size == getFileHash(i).size && file.hash == getFileHash(i).hash && file.lastWriteTime == getFileHash(i).lastWriteTime;
+		}
+		CASE_ASSERT(correct);
+
+		db->close();
+	}
+
+	// Partial record at end of journal is ignored, valid records are merged into index.
+	{
+		AlignedVector< uint8_t > journal;
+		CASE_ASSERT(readFile(fileName + L".journal", journal));
+		journal.push_back(1);
+		journal.push_back(0x12);
+		CASE_ASSERT(writeFile(fileName + L".journal", journal.c_ptr(), journal.size()));
+
+		Ref< PipelineDbFlat > db = new PipelineDbFlat();
+		CASE_ASSERT(db->open(connectionString));
+		CASE_ASSERT(FileSystem::getInstance().exist(fileName));
+		CASE_ASSERT_EQUAL(db->getDependencyCount(), (uint32_t)50);
+		CASE_ASSERT_EQUAL(db->getFileCount(), (uint32_t)50);
+
+		PipelineDependencyHash hash;
+		CASE_ASSERT(db->getDependency(getGuid(49), hash));
+		CASE_ASSERT(hash == getDependencyHash(49, 0));
+
+		db->close();
+	}
+
+	// Enough journal records merge into index; modified records override indexed.
+	{
+		Ref< PipelineDbFlat > db = new PipelineDbFlat();
+		CASE_ASSERT(db->open(connectionString));
+
+		db->beginTransaction();
+		for (uint32_t i = 0; i < 5000; ++i)
+			db->setDependency(getGuid(i), getDependencyHash(i, 1));
+		for (uint32_t i = 50; i < 60; ++i)
+			db->setFile(getFilePath(i), getFileHash(i));
+		db->endTransaction();
+		db->close();
+
+		CASE_ASSERT(db->open(connectionString));
+		CASE_ASSERT_EQUAL(db->getDependencyCount(), (uint32_t)5000);
+		CASE_ASSERT_EQUAL(db->getFileCount(), (uint32_t)60);
+
+		bool correct = true;
+		for (uint32_t i = 0; i < 5000; ++i)
+		{
+			PipelineDependencyHash hash;
+			correct &= db->getDependency(getGuid(i), hash) && hash == getDependencyHash(i, 1);
+		}
+		for (uint32_t i = 0; i < 60; ++i)
+		{
+			PipelineFileHash file;
+			correct &= db->getFile(getFilePath(i), file) && file.hash == getFileHash(i).hash;
+		}
+		CASE_ASSERT(correct);
+
+		PipelineDependencyHash hash;
+		CASE_ASSERT(!db->getDependency(getGuid(5000), hash));
+
+		db->close();
+	}
+
+	AlignedVector< uint8_t > index;
+	CASE_ASSERT(readFile(fileName, index));
+	CASE_ASSERT(index.size() > 32);
+	if (index.size() <= 32)
+		return;
+
+	// Path outside of string blob must only reject that record.
+	{
+		AlignedVector< uint8_t > corrupt = index;
+		uint32_t header[8];
+		std::memcpy(header, corrupt.c_ptr(), sizeof(header));
+
+		const size_t fileRecordsOffset = sizeof(header) + header[2] * 32 + header[3] * 4;
+		const uint32_t pathOffset = 0xffffff00;
+		std::memcpy(&corrupt[fileRecordsOffset + 24], &pathOffset, sizeof(pathOffset));
+		CASE_ASSERT(writeFile(fileName, corrupt.c_ptr(), corrupt.size()));
+
+		Ref< PipelineDbFlat > db = new PipelineDbFlat();
+		CASE_ASSERT(db->open(connectionString));
+		CASE_ASSERT_EQUAL(db->getFileCount(), (uint32_t)60);
+
+		PipelineFileHash file;
+		CASE_ASSERT(!db->getFile(getFilePath(0), file));
+		CASE_ASSERT(db->getFile(getFilePath(1), file));
+
+		Path filePath;
+		CASE_ASSERT(!db->getFileByIndex(0, filePath, file));
+		CASE_ASSERT(db->getFileByIndex(1, filePath, file));
+		db->close();
+	}
+
+	// Modified header must be rejected and database purged.
+	{
+		AlignedVector< uint8_t > corrupt = index;
+		const uint32_t stringsSize = 0xffff;
+		std::memcpy(&corrupt[24], &stringsSize, sizeof(stringsSize));
+		CASE_ASSERT(writeFile(fileName, corrupt.c_ptr(), corrupt.size()));
+
+		Ref< PipelineDbFlat > db = new PipelineDbFlat();
+		CASE_ASSERT(db->open(connectionString));
+		CASE_ASSERT_EQUAL(db->getDependencyCount(), (uint32_t)0);
+		CASE_ASSERT_EQUAL(db->getFileCount(), (uint32_t)0);
+		db->close();
+
+		CASE_ASSERT(!FileSystem::getInstance().exist(fileName));
+	}
+
+	// Truncated index must be rejected and database purged.
+	{
+		CASE_ASSERT(writeFile(fileName, index.c_ptr(), index.size() / 2));
+
+		Ref< PipelineDbFlat > db = new PipelineDbFlat();
+		CASE_ASSERT(db->open(connectionString));
+		CASE_ASSERT_EQUAL(db->getDependencyCount(), (uint32_t)0);
+		CASE_ASSERT_EQUAL(db->getFileCount(), (uint32_t)0);
+		db->close();
+
+		CASE_ASSERT(!FileSystem::getInstance().exist(fileName));
+	}
+
+	// Slot referencing outside of records must be ignored.
+	{
+		AlignedVector< uint8_t > corrupt = index;
+		uint32_t header[8];
+		std::memcpy(header, corrupt.c_ptr(), sizeof(header));
+
+		const size_t dependencySlotsOffset = sizeof(header) + header[2] * 32;
+		for (uint32_t i = 0; i < header[3]; ++i)
+		{
+			const uint32_t slot = header[2] + 10;
+			std::memcpy(&corrupt[dependencySlotsOffset + i * 4], &slot, sizeof(slot));
+		}
+		CASE_ASSERT(writeFile(fileName, corrupt.c_ptr(), corrupt.size()));
+
+		Ref< PipelineDbFlat > db = new PipelineDbFlat();
+		CASE_ASSERT(db->open(connectionString));
+		CASE_ASSERT_EQUAL(db->getDependencyCount(), header[2]);
+
+		PipelineDependencyHash hash;
+		CASE_ASSERT(!db->getDependency(getGuid(0), hash));
+		db->close();
+	}
+
+	FileSystem::getInstance().remove(fileName);
+	FileSystem::getInstance().remove(fileName + L".journal");
+	FileSystem::getInstance().removeDirectory(path);
+}
+
+}
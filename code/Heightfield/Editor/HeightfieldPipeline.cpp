@@ -24,8 +24,15 @@
 
 namespace traktor::hf
 {
+	namespace
+	{
+
+const int32_t c_tileSize = 256;
+const int32_t c_minTiledSize = 4096;	//!< Heightfields of this size, or smaller, are not tiled.
+
+	}
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldPipeline", 2, HeightfieldPipeline, editor::IPipeline)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldPipeline", 4, HeightfieldPipeline, editor::IPipeline)
 
 bool HeightfieldPipeline::create(const editor::IPipelineSettings* settings, db::Database* database)
 {
@@ -123,12 +130,33 @@ bool HeightfieldPipeline::buildOutput(
 		return false;
 	}
 
-	HeightfieldFormat().write(outputData, heightfield);
+	// Only large heightfields are tiled, tiles are streamed on demand
+	// which make every query slower when data isn't resident.
+	const int32_t tileSize = (heightfield->getSize() > c_minTiledSize) ? c_tileSize : 0;
+	if (tileSize > 0)
+	{
+		if (!HeightfieldFormat().writeTiled(outputData, heightfield, tileSize))
+		{
+			log::error << L"Heightfield pipeline failed; unable to write tiled heights." << Endl;
+			instance->revert();
+			return false;
+		}
+	}
+	else
+	{
+		if (!HeightfieldFormat().write(outputData, heightfield))
+		{
+			log::error << L"Heightfield pipeline failed; unable to write heights." << Endl;
+			instance->revert();
+			return false;
+		}
+	}
 
 	outputData->close();
 	outputData = nullptr;
 
 	resource->m_worldExtent = heightfieldAsset->getWorldExtent();
+	resource->m_tileSize = tileSize;
 
 	instance->setObject(resource);
 
@@ -8,7 +8,7 @@
  */
 #include "Heightfield/Heightfield.h"
 
-#include "Core/Math/Winding3.h"
+#include "Core/Misc/Align.h"
 
 #include <algorithm>
 #include <cmath>
@@ -21,6 +21,77 @@ namespace
 
 constexpr int32_t c_cellSize = 64;
 constexpr int32_t c_skip = 1;
+constexpr int32_t c_maxPrefetchLoads = 4;
+constexpr uint32_t c_batchSize = 64;
+constexpr float c_normalDistance = 0.5f;
+const float c_normalDirections[][2] =
+{
+	{ -c_normalDistance, -c_normalDistance },
+	{ 0.0f, -c_normalDistance },
+	{ c_normalDistance, -c_normalDistance },
+	{ c_normalDistance, 0.0f },
+	{ c_normalDistance, c_normalDistance },
+	{ 0.0f, 0.0f },
+	{ -c_normalDistance, c_normalDistance },
+	{ -c_normalDistance, 0.0f }
+};
+constexpr int32_t c_normalSampleCount = (int32_t)sizeof_array(c_normalDirections) + 1;
+
+Vector4 normalFromHeights(float h0, const float* h, float sx, float sy, float sz)
+{
+	Vector4 N = Vector4::zero();
+
+	for (uint32_t i = 0; i < sizeof_array(c_normalDirections); ++i)
+	{
+		const uint32_t j = (i + 1) % sizeof_array(c_normalDirections);
+
+		const float dx1 = c_normalDirections[i][0] * sx * c_normalDistance;
+		const float dy1 = (h[i] - h0) * sy;
+		const float dz1 = c_normalDirections[i][1] * sz * c_normalDistance;
+
+		const float dx2 = c_normalDirections[j][0] * sx * c_normalDistance;
+		const float dy2 = (h[j] - h0) * sy;
+		const float dz2 = c_normalDirections[j][1] * sz * c_normalDistance;
+
+		const Vector4 n = cross(
+			Vector4(dx2, dy2, dz2),
+			Vector4(dx1, dy1, dz1));
+
+		N += n;
+	}
+
+	return N.normalized();
+}
+
+bool intersectTriangle(const Vector4& origin, const Vector4& direction, const Vector4& v0, const Vector4& v1, const Vector4& v2, float& outK)
+{
+	const Vector4 e1 = v1 - v0;
+	const Vector4 e2 = v2 - v0;
+	const Vector4 p = cross(direction, e2);
+
+	const float det = dot3(e1, p);
+	if (std::abs(det) < 1e-12f)
+		return false;
+
+	const float invDet = 1.0f / det;
+	const Vector4 s = origin - v0;
+
+	const float u = dot3(s, p) * invDet;
+	if (u < 0.0f || u > 1.0f)
+		return false;
+
+	const Vector4 q = cross(s, e1);
+	const float v = dot3(direction, q) * invDet;
+	if (v < 0.0f || u + v > 1.0f)
+		return false;
+
+	const float k = dot3(e2, q) * invDet;
+	if (k <= 0.0f)
+		return false;
+
+	outK = k;
+	return true;
+}
 
 }
 
@@ -40,10 +111,78 @@ Heightfield::Heightfield(
 	m_cellBounds.reset(new Aabb3[m_cellBoundsPitch * m_cellBoundsPitch]);
 
 	m_worldExtent.storeUnaligned(m_worldExtentFloats);
+
+	createRanges();
+}
+
+Heightfield::Heightfield(
+	HeightfieldTileCache* tiles,
+	const Vector4& worldExtent)
+	: m_size(tiles->getSize())
+	, m_worldExtent(worldExtent)
+	, m_tiles(tiles)
+{
+	m_cellBoundsPitch = (m_size + c_cellSize - 1) / c_cellSize;
+	m_cellBounds.reset(new Aabb3[m_cellBoundsPitch * m_cellBoundsPitch]);
+
+	m_worldExtent.storeUnaligned(m_worldExtentFloats);
+
+	createRanges();
+
+	// Cell bounds are calculated from height ranges stored
+	// in the tiled data thus no tile is read here.
+	updateCellBounds();
+}
+
+void Heightfield::makeResident()
+{
+	if (!m_tiles)
+		return;
+
+	const int32_t tileSize = m_tiles->getTileSize();
+	const int32_t tileCount = (m_size + tileSize - 1) / tileSize;
+
+	AutoArrayPtr< height_t > heights(new height_t[m_size * m_size]);
+	AutoArrayPtr< uint8_t > cuts(new uint8_t[(m_size * m_size) / 8]);
+	AutoArrayPtr< uint8_t > attributes(new uint8_t[m_size * m_size]);
+
+	for (int32_t i = 0; i < (m_size * m_size) / 8; ++i)
+		cuts[i] = 0;
+
+	// Copy tile by tile so each tile is only read once.
+	for (int32_t tz = 0; tz < tileCount; ++tz)
+	{
+		for (int32_t tx = 0; tx < tileCount; ++tx)
+		{
+			const int32_t z1 = std::min((tz + 1) * tileSize, m_size);
+			const int32_t x1 = std::min((tx + 1) * tileSize, m_size);
+			for (int32_t z = tz * tileSize; z < z1; ++z)
+			{
+				for (int32_t x = tx * tileSize; x < x1; ++x)
+				{
+					const int32_t offset = x + z * m_size;
+					heights[offset] = m_tiles->getHeight(x, z);
+					attributes[offset] = m_tiles->getAttribute(x, z);
+					if (m_tiles->getCut(x, z))
+						cuts[offset / 8] |= (1 << (offset & 7));
+				}
+			}
+		}
+	}
+
+	m_heights.move(heights);
+	m_cuts.move(cuts);
+	m_attributes.move(attributes);
+
+	// Cell bounds already match since ranges in tiled
+	// data are calculated from the same samples.
+	m_tiles = nullptr;
 }
 
 void Heightfield::setGridHeight(int32_t gridX, int32_t gridZ, float unitY)
 {
+	if (m_tiles)
+		return;
 	if (gridX < 0 || gridX >= (int32_t)m_size)
 		return;
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
@@ -53,6 +192,8 @@ void Heightfield::setGridHeight(int32_t gridX, int32_t gridZ, float unitY)
 
 void Heightfield::setGridCut(int32_t gridX, int32_t gridZ, bool cut)
 {
+	if (m_tiles)
+		return;
 	if (gridX < 0 || gridX >= (int32_t)m_size)
 		return;
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
@@ -67,6 +208,8 @@ void Heightfield::setGridCut(int32_t gridX, int32_t gridZ, bool cut)
 
 void Heightfield::setGridAttribute(int32_t gridX, int32_t gridZ, uint8_t attribute)
 {
+	if (m_tiles)
+		return;
 	if (gridX < 0 || gridX >= (int32_t)m_size)
 		return;
 	if (gridZ < 0 || gridZ >= (int32_t)m_size)
@@ -88,7 +231,7 @@ float Heightfield::getGridHeightNearest(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
-	return m_heights[gridX + gridZ * m_size] / 65535.0f;
+	return getGridHeightNearestUnsafe(gridX, gridZ);
 }
 
 float Heightfield::getGridHeightBilinear(float gridX, float gridZ) const
@@ -106,18 +249,24 @@ float Heightfield::getGridHeightBilinear(float gridX, float gridZ) const
 	else if (igridZ >= (int32_t)m_size - 1)
 		igridZ = (int32_t)m_size - 2;
 
-	const int32_t offset = igridX + igridZ * m_size;
-
-	height_t hts[] = {
-		m_heights[offset],
-		m_heights[offset + 1],
-		m_heights[offset + m_size],
-		m_heights[offset + 1 + m_size]
-	};
+	height_t hts[4];
+	if (!m_tiles)
+	{
+		const int32_t offset = igridX + igridZ * m_size;
+		hts[0] = m_heights[offset];
+		hts[1] = m_heights[offset + 1];
+		hts[2] = m_heights[offset + m_size];
+		hts[3] = m_heights[offset + 1 + m_size];
+	}
+	else
+		m_tiles->getHeightQuad(igridX, igridZ, hts);
 
 	const float fgridX = gridX - igridX;
 	const float fgridZ = gridZ - igridZ;
 
+	// Extrapolated corner may be outside of height range thus cannot be stored as height_t.
+	float h[] = { float(hts[0]), float(hts[1]), float(hts[2]), float(hts[3]) };
+
 #if 0
 /*
 0,1(2)  1,1(3)
@@ -133,12 +282,12 @@ float Heightfield::getGridHeightBilinear(float gridX, float gridZ) const
 	if (k >= 0.0f)
 	{
 		// Left
-		hts[3] = hts[2] + (hts[1] - hts[0]);
+		h[3] = h[2] + (h[1] - h[0]);
 	}
 	else
 	{
 		// Right
-		hts[0] = hts[1] + (hts[2] - hts[3]);
+		h[0] = h[1] + (h[2] - h[3]);
 	}
 #else
 	/*
@@ -155,17 +304,17 @@ float Heightfield::getGridHeightBilinear(float gridX, float gridZ) const
 	if (k < 0.0f)
 	{
 		// Left
-		hts[1] = hts[0] + (hts[3] - hts[2]);
+		h[1] = h[0] + (h[3] - h[2]);
 	}
 	else
 	{
 		// Right
-		hts[2] = hts[3] + (hts[0] - hts[1]);
+		h[2] = h[3] + (h[0] - h[1]);
 	}
 #endif
 
-	const float hl = hts[0] + (hts[2] - hts[0]) * fgridZ;
-	const float hr = hts[1] + (hts[3] - hts[1]) * fgridZ;
+	const float hl = h[0] + (h[2] - h[0]) * fgridZ;
+	const float hr = h[1] + (h[3] - h[1]) * fgridZ;
 
 	return (hl + (hr - hl) * fgridX) / 65535.0f;
 }
@@ -190,6 +339,9 @@ bool Heightfield::getGridCut(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
+	if (m_tiles)
+		return m_tiles->getCut(gridX, gridZ);
+
 	const int32_t offset = gridX + gridZ * m_size;
 	return (m_cuts[offset / 8] & (1 << (offset & 7))) != 0;
 }
@@ -213,6 +365,9 @@ uint8_t Heightfield::getGridAttribute(int32_t gridX, int32_t gridZ) const
 	else if (gridZ >= (int32_t)m_size)
 		gridZ = (int32_t)m_size - 1;
 
+	if (m_tiles)
+		return m_tiles->getAttribute(gridX, gridZ);
+
 	const int32_t offset = gridX + gridZ * m_size;
 	return m_attributes[offset];
 }
@@ -274,135 +429,510 @@ float Heightfield::worldToUnit(float worldY) const
 
 Vector4 Heightfield::normalAt(float gridX, float gridZ) const
 {
-	const float c_distance = 0.5f;
-	const float directions[][2] = {
-		{ -c_distance, -c_distance },
-		{ 0.0f, -c_distance },
-		{ c_distance, -c_distance },
-		{ c_distance, 0.0f },
-		{ c_distance, c_distance },
-		{ 0.0f, 0.0f },
-		{ -c_distance, c_distance },
-		{ -c_distance, 0.0f }
+	const float h0 = getGridHeightBilinear(gridX, gridZ);
+
+	float h[sizeof_array(c_normalDirections)];
+	for (uint32_t i = 0; i < sizeof_array(c_normalDirections); ++i)
+		h[i] = getGridHeightBilinear(gridX + c_normalDirections[i][0], gridZ + c_normalDirections[i][1]);
+
+	return normalFromHeights(
+		h0,
+		h,
+		m_worldExtentFloats[0] / m_size,
+		m_worldExtentFloats[1],
+		m_worldExtentFloats[2] / m_size
+	);
+}
+
+bool Heightfield::queryRay(const Vector4& worldRayOrigin, const Vector4& worldRayDirection, Scalar& outDistance) const
+{
+	struct Node
+	{
+		int32_t level;
+		int32_t x;
+		int32_t z;
+		float k;
 	};
 
-	const float h0 = getGridHeightBilinear(gridX, gridZ);
+	Scalar kIn, kOut;
 
-	float h[sizeof_array(directions)];
-	for (uint32_t i = 0; i < sizeof_array(directions); ++i)
-		h[i] = getGridHeightBilinear(gridX + directions[i][0], gridZ + directions[i][1]);
+	const Aabb3 boundingBox(-m_worldExtent * 0.5_simd, m_worldExtent * 0.5_simd);
+	if (!boundingBox.intersectRay(worldRayOrigin, worldRayDirection, kIn, kOut))
+		return false;
 
-	const Vector4& worldExtent = getWorldExtent();
-	const float sx = worldExtent.x() / getSize();
-	const float sy = worldExtent.y();
-	const float sz = worldExtent.z() / getSize();
+	// Traverse min/max pyramid front to back, nodes further
+	// away than closest intersection found are skipped.
+	float distance = std::numeric_limits< float >::max();
 
-	Vector4 N = Vector4::zero();
+	Node stack[64];
+	int32_t depth = 0;
+	stack[depth++] = { (int32_t)m_rangeOffsets.size() - 1, 0, 0, kIn };
 
-	for (uint32_t i = 0; i < sizeof_array(directions); ++i)
+	while (depth > 0)
 	{
-		const uint32_t j = (i + 1) % sizeof_array(directions);
+		const Node node = stack[--depth];
+		if (node.k >= distance)
+			continue;
 
-		const float dx1 = directions[i][0] * sx * c_distance;
-		const float dy1 = (h[i] - h0) * sy;
-		const float dz1 = directions[i][1] * sz * c_distance;
+		if (node.level == 0)
+		{
+			queryCellRay(node.x, node.z, worldRayOrigin, worldRayDirection, distance);
+			continue;
+		}
 
-		const float dx2 = directions[j][0] * sx * c_distance;
-		const float dy2 = (h[j] - h0) * sy;
-		const float dz2 = directions[j][1] * sz * c_distance;
+		const int32_t level = node.level - 1;
+		const int32_t span = 1 << level;
+		const int32_t pitch = (m_cellBoundsPitch + span - 1) / span;
 
-		const Vector4 n = cross(
-			Vector4(dx2, dy2, dz2),
-			Vector4(dx1, dy1, dz1));
+		Node children[4];
+		int32_t childCount = 0;
 
-		N += n;
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			const int32_t x = node.x * 2 + (i & 1);
+			const int32_t z = node.z * 2 + (i >> 1);
+			if (x >= pitch || z >= pitch)
+				continue;
+
+			const float* range = &m_ranges[m_rangeOffsets[level] + (x + z * pitch) * 2];
+			if (range[0] > range[1])
+				continue;
+
+			// Horizontal extent of node from first and last cell.
+			const int32_t cx0 = x * span;
+			const int32_t cz0 = z * span;
+			const int32_t cx1 = std::min((x + 1) * span, m_cellBoundsPitch) - 1;
+			const int32_t cz1 = std::min((z + 1) * span, m_cellBoundsPitch) - 1;
+
+			const Vector4& mn = m_cellBounds[cx0 + cz0 * m_cellBoundsPitch].mn;
+			const Vector4& mx = m_cellBounds[cx1 + cz1 * m_cellBoundsPitch].mx;
+
+			const Aabb3 bb(
+				Vector4(mn.x(), range[0], mn.z(), 1.0f),
+				Vector4(mx.x(), range[1], mx.z(), 1.0f)
+			);
+			if (!bb.intersectRay(worldRayOrigin, worldRayDirection, kIn, kOut) || kIn >= distance)
+				continue;
+
+			children[childCount++] = { level, x, z, kIn };
+		}
+
+		// Push furthest first so closest child is traversed first.
+		std::sort(children, children + childCount, [](const Node& lh, const Node& rh) {
+			return lh.k > rh.k;
+		});
+		for (int32_t i = 0; i < childCount; ++i)
+			stack[depth++] = children[i];
 	}
 
-	return N.normalized();
+	if (distance >= std::numeric_limits< float >::max())
+		return false;
+
+	outDistance = Scalar(distance);
+	return true;
 }
 
-bool Heightfield::queryRay(const Vector4& worldRayOrigin, const Vector4& worldRayDirection, Scalar& outDistance) const
+void Heightfield::getGridHeightsBilinear(const float* gridX, const float* gridZ, uint32_t count, float* outUnitHeights) const
 {
-	Scalar k;
-	Scalar kIn, kOut;
-	Winding3 w;
+	float T_MATH_ALIGN16 gx[c_batchSize];
+	float T_MATH_ALIGN16 gz[c_batchSize];
+	float T_MATH_ALIGN16 hs[c_batchSize];
+	int32_t ix[c_batchSize];
+	int32_t iz[c_batchSize];
+	height_t hts[c_batchSize * 4];
+
+	for (uint32_t offset = 0; offset < count; offset += c_batchSize)
+	{
+		const uint32_t n = std::min(count - offset, c_batchSize);
+		const uint32_t n4 = alignUp(n, 4);
 
-	const Aabb3 boundingBox(-m_worldExtent * 0.5_simd, m_worldExtent * 0.5_simd);
-	if (!boundingBox.intersectRay(worldRayOrigin, worldRayDirection, kIn, kOut))
-		return false;
+		// Calculate quad of each position; pad with last position.
+		for (uint32_t i = 0; i < n4; ++i)
+		{
+			gx[i] = gridX[offset + std::min(i, n - 1)];
+			gz[i] = gridZ[offset + std::min(i, n - 1)];
+			ix[i] = clamp((int32_t)gx[i], 0, m_size - 2);
+			iz[i] = clamp((int32_t)gz[i], 0, m_size - 2);
+		}
 
-	bool foundIntersection = false;
+		// Gather heights of each quad.
+		if (!m_tiles)
+		{
+			for (uint32_t i = 0; i < n4; ++i)
+			{
+				const int32_t o = ix[i] + iz[i] * m_size;
+				hts[i * 4 + 0] = m_heights[o];
+				hts[i * 4 + 1] = m_heights[o + 1];
+				hts[i * 4 + 2] = m_heights[o + m_size];
+				hts[i * 4 + 3] = m_heights[o + 1 + m_size];
+			}
+		}
+		else
+			m_tiles->getHeightQuads(ix, iz, n4, hts);
 
-	outDistance = Scalar(std::numeric_limits< float >::max());
-	w.resize(3);
+		// Interpolate four positions at a time, same triangulation as getGridHeightBilinear.
+		for (uint32_t i = 0; i < n4; i += 4)
+		{
+			const height_t* q = &hts[i * 4];
 
-	for (int32_t cz = 0; cz < m_size; cz += c_cellSize)
+			const Vector4 fx = Vector4::loadAligned(&gx[i]) - Vector4(float(ix[i]), float(ix[i + 1]), float(ix[i + 2]), float(ix[i + 3]));
+			const Vector4 fz = Vector4::loadAligned(&gz[i]) - Vector4(float(iz[i]), float(iz[i + 1]), float(iz[i + 2]), float(iz[i + 3]));
+
+			const Vector4 h0(q[0], q[4], q[8], q[12]);
+			Vector4 h1(q[1], q[5], q[9], q[13]);
+			Vector4 h2(q[2], q[6], q[10], q[14]);
+			const Vector4 h3(q[3], q[7], q[11], q[15]);
+
+			const Vector4 k = fx - fz;
+			h1 = select(k, h0 + (h3 - h2), h1);
+			h2 = select(k, h2, h3 + (h0 - h1));
+
+			const Vector4 hl = h0 + (h2 - h0) * fz;
+			const Vector4 hr = h1 + (h3 - h1) * fz;
+			const Vector4 h = (hl + (hr - hl) * fx) / Scalar(65535.0f);
+
+			h.storeAligned(&hs[i]);
+		}
+
+		for (uint32_t i = 0; i < n; ++i)
+			outUnitHeights[offset + i] = hs[i];
+	}
+}
+
+void Heightfield::getWorldHeights(const Vector4* worldPositions, uint32_t count, float* outWorldHeights) const
+{
+	float gx[c_batchSize];
+	float gz[c_batchSize];
+
+	for (uint32_t offset = 0; offset < count; offset += c_batchSize)
 	{
-		for (int32_t cx = 0; cx < m_size; cx += c_cellSize)
+		const uint32_t n = std::min(count - offset, c_batchSize);
+
+		for (uint32_t i = 0; i < n; ++i)
+			worldToGrid(worldPositions[offset + i].x(), worldPositions[offset + i].z(), gx[i], gz[i]);
+
+		getGridHeightsBilinear(gx, gz, n, &outWorldHeights[offset]);
+
+		for (uint32_t i = 0; i < n; ++i)
+			outWorldHeights[offset + i] = -m_worldExtentFloats[1] * 0.5f + outWorldHeights[offset + i] * m_worldExtentFloats[1];
+	}
+}
+
+void Heightfield::normalsAt(const float* gridX, const float* gridZ, uint32_t count, Vector4* outNormals) const
+{
+	const uint32_t c_normalBatchSize = c_batchSize / c_normalSampleCount;
+
+	float gx[c_normalBatchSize * c_normalSampleCount];
+	float gz[c_normalBatchSize * c_normalSampleCount];
+	float h[c_normalBatchSize * c_normalSampleCount];
+
+	const float sx = m_worldExtentFloats[0] / m_size;
+	const float sy = m_worldExtentFloats[1];
+	const float sz = m_worldExtentFloats[2] / m_size;
+
+	for (uint32_t offset = 0; offset < count; offset += c_normalBatchSize)
+	{
+		const uint32_t n = std::min(count - offset, c_normalBatchSize);
+
+		// Center sample first, followed by surrounding samples.
+		for (uint32_t i = 0; i < n; ++i)
 		{
-			// First check cell bounding box before finding more refined intersection.
-			const int32_t icx = gridToCell(cx);
-			const int32_t icz = gridToCell(cz);
-			const Aabb3& bb = m_cellBounds[icx + icz * m_cellBoundsPitch];
+			float* px = &gx[i * c_normalSampleCount];
+			float* pz = &gz[i * c_normalSampleCount];
+			px[0] = gridX[offset + i];
+			pz[0] = gridZ[offset + i];
+			for (uint32_t j = 0; j < sizeof_array(c_normalDirections); ++j)
+			{
+				px[j + 1] = gridX[offset + i] + c_normalDirections[j][0];
+				pz[j + 1] = gridZ[offset + i] + c_normalDirections[j][1];
+			}
+		}
 
-			// Check if ray intersect bounding box; skip tracing triangles if not.
-			if (!bb.intersectRay(worldRayOrigin, worldRayDirection, kIn, kOut))
-				continue;
+		getGridHeightsBilinear(gx, gz, n * c_normalSampleCount, h);
 
-			// Construct and trace triangles.
-			for (int32_t iz = cz; iz <= cz + c_cellSize; iz += c_skip)
+		// Sum triangle normals of four positions at a time, same as normalFromHeights.
+		uint32_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			const float* ph[] = {
+				&h[i * c_normalSampleCount],
+				&h[(i + 1) * c_normalSampleCount],
+				&h[(i + 2) * c_normalSampleCount],
+				&h[(i + 3) * c_normalSampleCount]
+			};
+
+			const Vector4 h0(ph[0][0], ph[1][0], ph[2][0], ph[3][0]);
+			Vector4 dy[sizeof_array(c_normalDirections)];
+			for (uint32_t j = 0; j < sizeof_array(c_normalDirections); ++j)
+				dy[j] = (Vector4(ph[0][j + 1], ph[1][j + 1], ph[2][j + 1], ph[3][j + 1]) - h0) * Scalar(sy);
+
+			Vector4 nx = Vector4::zero();
+			Vector4 ny = Vector4::zero();
+			Vector4 nz = Vector4::zero();
+			for (uint32_t j = 0; j < sizeof_array(c_normalDirections); ++j)
 			{
-				for (int32_t ix = cx; ix <= cx + c_cellSize; ix += c_skip)
-				{
-					float x1w, z1w;
-					float x2w, z2w;
-
-					gridToWorld(float(ix), float(iz), x1w, z1w);
-					gridToWorld(float(ix + c_skip), float(iz + c_skip), x2w, z2w);
-
-					const float yw[] = {
-						unitToWorld(getGridHeightNearest(ix, iz)),
-						unitToWorld(getGridHeightNearest(ix + c_skip, iz)),
-						unitToWorld(getGridHeightNearest(ix, iz + c_skip)),
-						unitToWorld(getGridHeightNearest(ix + c_skip, iz + c_skip))
-					};
-
-					const Vector4 vw[] = {
-						Vector4(x1w, yw[0], z1w, 1.0f),
-						Vector4(x2w, yw[1], z1w, 1.0f),
-						Vector4(x1w, yw[2], z2w, 1.0f),
-						Vector4(x2w, yw[3], z2w, 1.0f)
-					};
-
-					w[0] = vw[0];
-					w[1] = vw[1];
-					w[2] = vw[2];
-					if (w.rayIntersection(worldRayOrigin, worldRayDirection, k))
-					{
-						if (k < outDistance)
-						{
-							outDistance = k;
-							foundIntersection = true;
-						}
-					}
-
-					w[0] = vw[1];
-					w[1] = vw[3];
-					w[2] = vw[2];
-					if (w.rayIntersection(worldRayOrigin, worldRayDirection, k))
-					{
-						if (k < outDistance)
-						{
-							outDistance = k;
-							foundIntersection = true;
-						}
-					}
-				}
+				const uint32_t k = (j + 1) % sizeof_array(c_normalDirections);
+
+				const Scalar dx1(c_normalDirections[j][0] * sx * c_normalDistance);
+				const Scalar dz1(c_normalDirections[j][1] * sz * c_normalDistance);
+				const Scalar dx2(c_normalDirections[k][0] * sx * c_normalDistance);
+				const Scalar dz2(c_normalDirections[k][1] * sz * c_normalDistance);
+
+				nx += dy[k] * dz1 - dy[j] * dz2;
+				ny += Vector4(dz2 * dx1 - dx2 * dz1);
+				nz += dy[j] * dx2 - dy[k] * dx1;
 			}
+
+			float T_MATH_ALIGN16 nxs[4], nys[4], nzs[4];
+			nx.storeAligned(nxs);
+			ny.storeAligned(nys);
+			nz.storeAligned(nzs);
+			for (uint32_t j = 0; j < 4; ++j)
+				outNormals[offset + i + j] = Vector4(nxs[j], nys[j], nzs[j], 0.0f).normalized();
+		}
+		for (; i < n; ++i)
+		{
+			const float* ph = &h[i * c_normalSampleCount];
+			outNormals[offset + i] = normalFromHeights(ph[0], ph + 1, sx, sy, sz);
+		}
+	}
+}
+
+uint32_t Heightfield::queryRays(const Vector4* worldRayOrigins, const Vector4* worldRayDirections, uint32_t count, float* outDistances) const
+{
+	uint32_t hits = 0;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		Scalar distance;
+		if (queryRay(worldRayOrigins[i], worldRayDirections[i], distance))
+		{
+			outDistances[i] = distance;
+			++hits;
+		}
+		else
+			outDistances[i] = -1.0f;
+	}
+	return hits;
+}
+
+void Heightfield::prefetch(const Vector4& worldPosition, float worldRadius) const
+{
+	if (!m_tiles)
+		return;
+
+	int32_t gridX0, gridZ0;
+	int32_t gridX1, gridZ1;
+	worldToGrid(worldPosition.x() - worldRadius, worldPosition.z() - worldRadius, gridX0, gridZ0);
+	worldToGrid(worldPosition.x() + worldRadius, worldPosition.z() + worldRadius, gridX1, gridZ1);
+
+	m_tiles->prefetch(gridX0, gridZ0, gridX1, gridZ1, c_maxPrefetchLoads);
+}
+
+bool Heightfield::haveCuts() const
+{
+	if (m_tiles)
+		return m_tiles->haveCuts();
+
+	// A set bit means sample is not cut.
+	const uint8_t* cuts = m_cuts.c_ptr();
+	for (int32_t i = 0; i < (m_size * m_size) / 8; ++i)
+	{
+		if (cuts[i] != 0xff)
+			return true;
+	}
+	return false;
+}
+
+void Heightfield::createRanges()
+{
+	m_rangeOffsets.resize(0);
+
+	int32_t count = 0;
+	for (int32_t pitch = m_cellBoundsPitch; ; pitch = (pitch + 1) / 2)
+	{
+		m_rangeOffsets.push_back(count);
+		count += pitch * pitch * 2;
+		if (pitch <= 1)
+			break;
+	}
+
+	// Initialize as empty ranges until cell bounds are updated.
+	m_ranges.resize(count);
+	for (int32_t i = 0; i < count; i += 2)
+	{
+		m_ranges[i] = std::numeric_limits< float >::max();
+		m_ranges[i + 1] = -std::numeric_limits< float >::max();
+	}
+}
+
+void Heightfield::updateRanges(int32_t cellX, int32_t cellZ)
+{
+	const Aabb3& bb = m_cellBounds[cellX + cellZ * m_cellBoundsPitch];
+	m_ranges[(cellX + cellZ * m_cellBoundsPitch) * 2] = bb.mn.y();
+	m_ranges[(cellX + cellZ * m_cellBoundsPitch) * 2 + 1] = bb.mx.y();
+
+	// Propagate to parent levels.
+	int32_t x = cellX;
+	int32_t z = cellZ;
+	int32_t pitch = m_cellBoundsPitch;
+	for (int32_t level = 1; level < (int32_t)m_rangeOffsets.size(); ++level)
+	{
+		const int32_t parentPitch = (pitch + 1) / 2;
+		const int32_t px = x / 2;
+		const int32_t pz = z / 2;
+
+		float mn = std::numeric_limits< float >::max();
+		float mx = -std::numeric_limits< float >::max();
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			const int32_t cx = px * 2 + (i & 1);
+			const int32_t cz = pz * 2 + (i >> 1);
+			if (cx >= pitch || cz >= pitch)
+				continue;
+
+			const float* range = &m_ranges[m_rangeOffsets[level - 1] + (cx + cz * pitch) * 2];
+			mn = std::min(mn, range[0]);
+			mx = std::max(mx, range[1]);
+		}
+
+		float* range = &m_ranges[m_rangeOffsets[level] + (px + pz * parentPitch) * 2];
+		range[0] = mn;
+		range[1] = mx;
+
+		x = px;
+		z = pz;
+		pitch = parentPitch;
+	}
+}
+
+void Heightfield::getQuadHeights(int32_t gridX, int32_t gridZ, height_t outHeights[4]) const
+{
+	if (m_tiles)
+	{
+		m_tiles->getHeightQuad(gridX, gridZ, outHeights);
+		return;
+	}
+
+	const int32_t offset = gridX + gridZ * m_size;
+	outHeights[0] = m_heights[offset];
+	outHeights[1] = m_heights[offset + 1];
+	outHeights[2] = m_heights[offset + m_size];
+	outHeights[3] = m_heights[offset + 1 + m_size];
+}
+
+bool Heightfield::queryCellRay(int32_t cellX, int32_t cellZ, const Vector4& worldRayOrigin, const Vector4& worldRayDirection, float& inOutDistance) const
+{
+	// Quads of cell, each quad is between grid samples x and x+1.
+	const int32_t x0 = cellX * c_cellSize;
+	const int32_t z0 = cellZ * c_cellSize;
+	const int32_t x1 = std::min(x0 + c_cellSize, m_size - 1);
+	const int32_t z1 = std::min(z0 + c_cellSize, m_size - 1);
+	if (x0 >= x1 || z0 >= z1)
+		return false;
+
+	// Ray in grid space.
+	const float scaleX = m_size / m_worldExtentFloats[0];
+	const float scaleZ = m_size / m_worldExtentFloats[2];
+	const float ox = (worldRayOrigin.x() - 0.5f + m_worldExtentFloats[0] * 0.5f) * scaleX;
+	const float oz = (worldRayOrigin.z() - 0.5f + m_worldExtentFloats[2] * 0.5f) * scaleZ;
+	const float dx = worldRayDirection.x() * scaleX;
+	const float dz = worldRayDirection.z() * scaleZ;
+
+	// Clip ray to cell rectangle.
+	float tEnter = 0.0f;
+	float tExit = inOutDistance;
+	const float o[] = { ox, oz };
+	const float d[] = { dx, dz };
+	const float mn[] = { float(x0), float(z0) };
+	const float mx[] = { float(x1), float(z1) };
+	for (int32_t i = 0; i < 2; ++i)
+	{
+		if (std::abs(d[i]) < 1e-12f)
+		{
+			if (o[i] < mn[i] || o[i] > mx[i])
+				return false;
+			continue;
+		}
+		float ta = (mn[i] - o[i]) / d[i];
+		float tb = (mx[i] - o[i]) / d[i];
+		if (ta > tb)
+			std::swap(ta, tb);
+		tEnter = std::max(tEnter, ta);
+		tExit = std::min(tExit, tb);
+	}
+	if (tEnter > tExit)
+		return false;
+
+	// Walk quads along ray, in order of distance; first
+	// intersection is thus closest within this cell.
+	int32_t ix = clamp((int32_t)std::floor(ox + dx * tEnter), x0, x1 - 1);
+	int32_t iz = clamp((int32_t)std::floor(oz + dz * tEnter), z0, z1 - 1);
+
+	const int32_t stepX = dx >= 0.0f ? 1 : -1;
+	const int32_t stepZ = dz >= 0.0f ? 1 : -1;
+	const float tDeltaX = std::abs(dx) > 1e-12f ? std::abs(1.0f / dx) : std::numeric_limits< float >::max();
+	const float tDeltaZ = std::abs(dz) > 1e-12f ? std::abs(1.0f / dz) : std::numeric_limits< float >::max();
+	float tMaxX = std::abs(dx) > 1e-12f ? (float(ix + (stepX > 0 ? 1 : 0)) - ox) / dx : std::numeric_limits< float >::max();
+	float tMaxZ = std::abs(dz) > 1e-12f ? (float(iz + (stepZ > 0 ? 1 : 0)) - oz) / dz : std::numeric_limits< float >::max();
+
+	for (;;)
+	{
+		height_t hts[4];
+		getQuadHeights(ix, iz, hts);
+
+		float x1w, z1w;
+		float x2w, z2w;
+		gridToWorld(float(ix), float(iz), x1w, z1w);
+		gridToWorld(float(ix + 1), float(iz + 1), x2w, z2w);
+
+		const Vector4 vw[] = {
+			Vector4(x1w, unitToWorld(hts[0] / 65535.0f), z1w, 1.0f),
+			Vector4(x2w, unitToWorld(hts[1] / 65535.0f), z1w, 1.0f),
+			Vector4(x1w, unitToWorld(hts[2] / 65535.0f), z2w, 1.0f),
+			Vector4(x2w, unitToWorld(hts[3] / 65535.0f), z2w, 1.0f)
+		};
+
+		bool hit = false;
+		float k;
+		if (intersectTriangle(worldRayOrigin, worldRayDirection, vw[0], vw[1], vw[2], k) && k < inOutDistance)
+		{
+			inOutDistance = k;
+			hit = true;
+		}
+		if (intersectTriangle(worldRayOrigin, worldRayDirection, vw[1], vw[3], vw[2], k) && k < inOutDistance)
+		{
+			inOutDistance = k;
+			hit = true;
 		}
+		if (hit)
+			return true;
+
+		// Step to next quad.
+		if (tMaxX < tMaxZ)
+		{
+			if (tMaxX > tExit)
+				break;
+			ix += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			if (tMaxZ > tExit)
+				break;
+			iz += stepZ;
+			tMaxZ += tDeltaZ;
+		}
+
+		if (ix < x0 || ix >= x1 || iz < z0 || iz >= z1)
+			break;
 	}
 
-	return foundIntersection;
+	return false;
+}
+
+int32_t Heightfield::getCellSize() const
+{
+	return c_cellSize;
 }
 
 int32_t Heightfield::gridToCell(int32_t grid) const
@@ -438,19 +968,31 @@ void Heightfield::updateCellBounds(int32_t gridX, int32_t gridZ)
 	float cy1w = std::numeric_limits< float >::max();
 	float cy2w = -std::numeric_limits< float >::max();
 
-	for (int32_t iz = cz; iz <= cz + c_cellSize; iz += c_skip)
+	if (m_tiles)
+	{
+		height_t mn, mx;
+		m_tiles->getCellRange(icx, icz, mn, mx);
+		cy1w = unitToWorld(mn / 65535.0f);
+		cy2w = unitToWorld(mx / 65535.0f);
+	}
+	else
 	{
-		for (int32_t ix = cx; ix <= cx + c_cellSize; ix += c_skip)
+		for (int32_t iz = cz; iz <= cz + c_cellSize; iz += c_skip)
 		{
-			const float wy = unitToWorld(getGridHeightNearest(ix, iz));
-			cy1w = std::min(cy1w, wy);
-			cy2w = std::max(cy2w, wy);
+			for (int32_t ix = cx; ix <= cx + c_cellSize; ix += c_skip)
+			{
+				const float wy = unitToWorld(getGridHeightNearest(ix, iz));
+				cy1w = std::min(cy1w, wy);
+				cy2w = std::max(cy2w, wy);
+			}
 		}
 	}
 
 	Aabb3& bb = m_cellBounds[icx + icz * m_cellBoundsPitch];
 	bb.mn = Vector4(cx1w, cy1w, cz1w, 1.0f);
 	bb.mx = Vector4(cx2w, cy2w, cz2w, 1.0f);
+
+	updateRanges(icx, icz);
 }
 
 void Heightfield::updateCellBounds(int32_t gridX0, int32_t gridY0, int32_t gridX1, int32_t gridY1)
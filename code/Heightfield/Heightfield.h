@@ -8,9 +8,12 @@
  */
 #pragma once
 
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Aabb3.h"
 #include "Core/Misc/AutoPtr.h"
 #include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Heightfield/HeightfieldTileCache.h"
 #include "Heightfield/HeightfieldTypes.h"
 
 // import/export mechanism.
@@ -26,6 +29,11 @@ namespace traktor::hf
 
 /*!
  * \ingroup Heightfield
+ *
+ * Heightfield samples are either kept in memory as whole
+ * arrays or, when tiled, streamed through a tile cache.
+ * A tiled heightfield is read-only and do not expose
+ * any arrays until made resident.
  */
 class T_DLLCLASS Heightfield : public Object
 {
@@ -36,6 +44,10 @@ public:
 		int32_t size,
 		const Vector4& worldExtent);
 
+	explicit Heightfield(
+		HeightfieldTileCache* tiles,
+		const Vector4& worldExtent);
+
 	void setGridHeight(int32_t gridX, int32_t gridZ, float unitY);
 
 	void setGridCut(int32_t gridX, int32_t gridZ, bool cut);
@@ -44,7 +56,7 @@ public:
 
 	float getGridHeightNearest(int32_t gridX, int32_t gridZ) const;
 
-	float getGridHeightNearestUnsafe(int32_t gridX, int32_t gridZ) const { return m_heights[gridX + gridZ * m_size] / 65535.0f; }
+	float getGridHeightNearestUnsafe(int32_t gridX, int32_t gridZ) const { return (m_heights.c_ptr() ? m_heights[gridX + gridZ * m_size] : m_tiles->getHeight(gridX, gridZ)) / 65535.0f; }
 
 	float getGridHeightBilinear(float gridX, float gridZ) const;
 
@@ -76,6 +88,55 @@ public:
 
 	bool queryRay(const Vector4& worldRayOrigin, const Vector4& worldRayDirection, Scalar& outDistance) const;
 
+	/*! Get bilinear filtered heights of multiple grid positions.
+	 *
+	 * Same result as getGridHeightBilinear but four
+	 * positions are interpolated at once.
+	 *
+	 * \param gridX Grid X positions.
+	 * \param gridZ Grid Z positions.
+	 * \param count Number of positions.
+	 * \param outUnitHeights Heights in unit range, one per position.
+	 */
+	void getGridHeightsBilinear(const float* gridX, const float* gridZ, uint32_t count, float* outUnitHeights) const;
+
+	/*! Get heights of multiple world positions, only X and Z of each position are used.
+	 *
+	 * \param worldPositions World positions.
+	 * \param count Number of positions.
+	 * \param outWorldHeights World heights, one per position.
+	 */
+	void getWorldHeights(const Vector4* worldPositions, uint32_t count, float* outWorldHeights) const;
+
+	/*! Get normals of multiple grid positions.
+	 *
+	 * \param gridX Grid X positions.
+	 * \param gridZ Grid Z positions.
+	 * \param count Number of positions.
+	 * \param outNormals Normals, one per position.
+	 */
+	void normalsAt(const float* gridX, const float* gridZ, uint32_t count, Vector4* outNormals) const;
+
+	/*! Query multiple rays for intersection.
+	 *
+	 * \param worldRayOrigins Ray origins.
+	 * \param worldRayDirections Ray directions.
+	 * \param count Number of rays.
+	 * \param outDistances Distance to intersection, -1 if ray doesn't intersect.
+	 * \return Number of intersecting rays.
+	 */
+	uint32_t queryRays(const Vector4* worldRayOrigins, const Vector4* worldRayDirections, uint32_t count, float* outDistances) const;
+
+	/*! Ensure tiles around a world position are resident, only applicable to tiled heightfields.
+	 *
+	 * \param worldPosition Position, typically of the viewer.
+	 * \param worldRadius Radius around position.
+	 */
+	void prefetch(const Vector4& worldPosition, float worldRadius) const;
+
+	/*! Check if any grid sample is cut. */
+	bool haveCuts() const;
+
 	int32_t getSize() const { return m_size; }
 
 	const Vector4& getWorldExtent() const { return m_worldExtent; }
@@ -92,6 +153,19 @@ public:
 
 	const uint8_t* getAttributes() const { return m_attributes.c_ptr(); }
 
+	/*! Get tile cache, null if heightfield isn't tiled. */
+	HeightfieldTileCache* getTileCache() const { return m_tiles; }
+
+	/*! Read all tiles into memory and release tile cache.
+	 *
+	 * Heightfield is writable and expose arrays afterwards,
+	 * as required by editors. Must not be called while
+	 * heightfield is queried from other threads.
+	 */
+	void makeResident();
+
+	int32_t getCellSize() const;
+
 	int32_t gridToCell(int32_t grid) const;
 
 	void updateCellBounds();
@@ -109,6 +183,17 @@ private:
 	AutoArrayPtr< uint8_t > m_cuts;
 	AutoArrayPtr< uint8_t > m_attributes;
 	AutoArrayPtr< Aabb3 > m_cellBounds;
+	AlignedVector< int32_t > m_rangeOffsets;	//!< Offset of each level in range pyramid.
+	AlignedVector< float > m_ranges;			//!< Pyramid of min and max world heights, first level is cells.
+	Ref< HeightfieldTileCache > m_tiles;
+
+	void createRanges();
+
+	void updateRanges(int32_t cellX, int32_t cellZ);
+
+	void getQuadHeights(int32_t gridX, int32_t gridZ, height_t outHeights[4]) const;
+
+	bool queryCellRay(int32_t cellX, int32_t cellZ, const Vector4& worldRayOrigin, const Vector4& worldRayDirection, float& inOutDistance) const;
 };
 
 }
@@ -15,6 +15,12 @@
 
 namespace traktor::hf
 {
+	namespace
+	{
+
+const int32_t c_residentTiles = 64;
+
+	}
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldFactory", 0, HeightfieldFactory, resource::IResourceFactory)
 
@@ -48,6 +54,10 @@ Ref< Object > HeightfieldFactory::create(resource::IResourceManager* resourceMan
 	if (!stream)
 		return nullptr;
 
+	// Tiled heightfields keep stream open to read tiles on demand.
+	if (resource->getTileSize() > 0)
+		return HeightfieldFormat().readTiled(stream, resource->getWorldExtent(), c_residentTiles);
+
 	Ref< Heightfield > heightfield = HeightfieldFormat().read(stream, resource->getWorldExtent());
 
 	stream->close();
@@ -6,12 +6,17 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Io/IStream.h"
 #include "Core/Io/Reader.h"
 #include "Core/Io/Writer.h"
+#include "Core/Math/MathUtils.h"
 #include "Heightfield/Heightfield.h"
 #include "Heightfield/HeightfieldFormat.h"
+#include "Heightfield/HeightfieldTileCache.h"
 
 namespace traktor::hf
 {
@@ -19,6 +24,7 @@ namespace traktor::hf
 	{
 
 const int32_t c_version = 2;
+const int32_t c_tiledVersion = 3;
 
 	}
 
@@ -63,6 +69,10 @@ Ref< Heightfield > HeightfieldFormat::read(IStream* stream, const Vector4& world
 
 bool HeightfieldFormat::write(IStream* stream, const Heightfield* heightfield) const
 {
+	// Tiled heightfields must be made resident before written.
+	if (!heightfield->getHeights() || !heightfield->getCuts() || !heightfield->getAttributes())
+		return false;
+
 	Writer(stream) << int32_t(c_version);
 	Writer(stream) << int32_t(heightfield->getSize());
 
@@ -87,4 +97,95 @@ bool HeightfieldFormat::write(IStream* stream, const Heightfield* heightfield) c
 	return true;
 }
 
+Ref< Heightfield > HeightfieldFormat::readTiled(IStream* stream, const Vector4& worldExtent, int32_t residentTiles) const
+{
+	Ref< HeightfieldTileCache > tiles = new HeightfieldTileCache();
+	if (!tiles->create(stream, residentTiles))
+		return nullptr;
+
+	Ref< Heightfield > heightfield = new Heightfield(tiles, worldExtent);
+	if (tiles->getCellSize() != heightfield->getCellSize())
+		return nullptr;
+
+	return heightfield;
+}
+
+bool HeightfieldFormat::writeTiled(IStream* stream, const Heightfield* heightfield, int32_t tileSize) const
+{
+	if (!heightfield->getHeights() || !heightfield->getCuts() || !heightfield->getAttributes() || tileSize <= 0 || (tileSize & 7) != 0)
+		return false;
+
+	const int32_t size = heightfield->getSize();
+	const int32_t cellSize = heightfield->getCellSize();
+	const int32_t cellPitch = (size + cellSize - 1) / cellSize;
+	const int32_t tileCount = (size + tileSize - 1) / tileSize;
+
+	Writer w(stream);
+	w << int32_t(c_tiledVersion);
+	w << int32_t(size);
+	w << int32_t(tileSize);
+	w << int32_t(cellSize);
+	w << uint8_t(heightfield->haveCuts() ? 1 : 0);
+
+	// Height range of each cell, so cell bounds can be
+	// calculated without reading any tile.
+	AlignedVector< height_t > cellRanges(cellPitch * cellPitch * 2);
+	for (int32_t icz = 0; icz < cellPitch; ++icz)
+	{
+		for (int32_t icx = 0; icx < cellPitch; ++icx)
+		{
+			height_t mn = std::numeric_limits< height_t >::max();
+			height_t mx = 0;
+			for (int32_t iz = icz * cellSize; iz <= (icz + 1) * cellSize; ++iz)
+			{
+				for (int32_t ix = icx * cellSize; ix <= (icx + 1) * cellSize; ++ix)
+				{
+					const height_t h = heightfield->getHeights()[clamp(ix, 0, size - 1) + clamp(iz, 0, size - 1) * size];
+					mn = std::min(mn, h);
+					mx = std::max(mx, h);
+				}
+			}
+			cellRanges[(icx + icz * cellPitch) * 2] = mn;
+			cellRanges[(icx + icz * cellPitch) * 2 + 1] = mx;
+		}
+	}
+	w.write(cellRanges.c_ptr(), (int64_t)cellRanges.size(), sizeof(height_t));
+
+	// Write tiles, samples outside of heightfield replicate edge.
+	const int32_t tileSamples = tileSize * tileSize;
+	AlignedVector< height_t > heights(tileSamples);
+	AlignedVector< uint8_t > cuts(tileSamples / 8);
+	AlignedVector< uint8_t > attributes(tileSamples);
+
+	for (int32_t tz = 0; tz < tileCount; ++tz)
+	{
+		for (int32_t tx = 0; tx < tileCount; ++tx)
+		{
+			for (int32_t i = 0; i < tileSamples / 8; ++i)
+				cuts[i] = 0;
+
+			for (int32_t lz = 0; lz < tileSize; ++lz)
+			{
+				for (int32_t lx = 0; lx < tileSize; ++lx)
+				{
+					const int32_t gridX = tx * tileSize + lx;
+					const int32_t gridZ = tz * tileSize + lz;
+					const int32_t offset = lx + lz * tileSize;
+
+					heights[offset] = heightfield->getHeights()[clamp(gridX, 0, size - 1) + clamp(gridZ, 0, size - 1) * size];
+					attributes[offset] = heightfield->getGridAttribute(gridX, gridZ);
+					if (heightfield->getGridCut(gridX, gridZ))
+						cuts[offset / 8] |= (1 << (offset & 7));
+				}
+			}
+
+			w.write(heights.c_ptr(), tileSamples, sizeof(height_t));
+			w.write(cuts.c_ptr(), tileSamples / 8, sizeof(uint8_t));
+			w.write(attributes.c_ptr(), tileSamples, sizeof(uint8_t));
+		}
+	}
+
+	return true;
+}
+
 }
@@ -25,8 +25,12 @@ namespace traktor::hf
 
 class Heightfield;
 
-/*!
+/*! Heightfield data format.
  * \ingroup Heightfield
+ *
+ * Heightfields are either stored as whole arrays, which
+ * is what editor and tools use, or as fixed size tiles
+ * which are streamed at runtime through a tile cache.
  */
 class T_DLLCLASS HeightfieldFormat : public Object
 {
@@ -36,6 +40,27 @@ public:
 	Ref< Heightfield > read(IStream* stream, const Vector4& worldExtent) const;
 
 	bool write(IStream* stream, const Heightfield* heightfield) const;
+
+	/*! Read tiled heightfield.
+	 *
+	 * Stream is kept open by the heightfield and
+	 * tiles are read on demand.
+	 *
+	 * \param stream Seekable stream with tiled data.
+	 * \param worldExtent Heightfield world extent.
+	 * \param residentTiles Maximum number of resident tiles.
+	 * \return Tiled heightfield.
+	 */
+	Ref< Heightfield > readTiled(IStream* stream, const Vector4& worldExtent, int32_t residentTiles) const;
+
+	/*! Write heightfield as tiles.
+	 *
+	 * \param stream Output stream.
+	 * \param heightfield Heightfield, must not be tiled.
+	 * \param tileSize Number of grid samples along each side of a tile, must be a multiple of 8.
+	 * \return True if successfully written.
+	 */
+	bool writeTiled(IStream* stream, const Heightfield* heightfield, int32_t tileSize) const;
 };
 
 }
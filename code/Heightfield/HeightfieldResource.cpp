@@ -8,17 +8,22 @@
  */
 #include "Core/Serialization/ISerializer.h"
 #include "Core/Serialization/Member.h"
+#include "Core/Serialization/SerializationPlan.h"
 #include "Heightfield/HeightfieldResource.h"
 
 namespace traktor::hf
 {
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldResource", 1, HeightfieldResource, ISerializable)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.HeightfieldResource", 2, HeightfieldResource, ISerializable)
+T_IMPLEMENT_SERIALIZATION_PLAN(HeightfieldResource)
 
 void HeightfieldResource::serialize(ISerializer& s)
 {
 	T_ASSERT(s.getVersion() >= 1);
 	s >> Member< Vector4 >(L"worldExtent", m_worldExtent);
+
+	if (s.getVersion< HeightfieldResource >() >= 2)
+		s >> Member< int32_t >(L"tileSize", m_tileSize);
 }
 
 }
@@ -35,10 +35,14 @@ public:
 
 	const Vector4& getWorldExtent() const { return m_worldExtent; }
 
+	/*! Size of tiles in data, 0 if data isn't tiled. */
+	int32_t getTileSize() const { return m_tileSize; }
+
 private:
 	friend class HeightfieldPipeline;
 
 	Vector4 m_worldExtent = Vector4::zero();
+	int32_t m_tileSize = 0;
 };
 
 }
@@ -0,0 +1,282 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Io/IStream.h"
+#include "Core/Io/Reader.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/MathUtils.h"
+#include "Core/Thread/Acquire.h"
+#include "Heightfield/HeightfieldTileCache.h"
+
+namespace traktor::hf
+{
+	namespace
+	{
+
+const int32_t c_tiledVersion = 3;
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.hf.HeightfieldTileCache", HeightfieldTileCache, Object)
+
+HeightfieldTileCache::~HeightfieldTileCache()
+{
+	destroy();
+}
+
+bool HeightfieldTileCache::create(IStream* stream, int32_t residentTiles)
+{
+	if (!stream || !stream->canSeek())
+	{
+		log::error << L"Unable to create heightfield tile cache; stream must be seekable." << Endl;
+		return false;
+	}
+
+	Reader r(stream);
+
+	int32_t version;
+	r >> version;
+	if (version != c_tiledVersion)
+		return false;
+
+	uint8_t haveCuts;
+	r >> m_size;
+	r >> m_tileSize;
+	r >> m_cellSize;
+	r >> haveCuts;
+
+	if (m_size <= 0 || m_tileSize <= 0 || (m_tileSize & 7) != 0 || m_cellSize <= 0)
+		return false;
+
+	m_haveCuts = (haveCuts != 0);
+	m_tileCount = (m_size + m_tileSize - 1) / m_tileSize;
+	m_cellPitch = (m_size + m_cellSize - 1) / m_cellSize;
+
+	m_cellRanges.resize(m_cellPitch * m_cellPitch * 2);
+	if (r.read(m_cellRanges.ptr(), (int64_t)m_cellRanges.size(), sizeof(height_t)) != (int64_t)(m_cellRanges.size() * sizeof(height_t)))
+		return false;
+
+	m_dataOffset = stream->tell();
+	m_stream = stream;
+
+	const int32_t tileSamples = m_tileSize * m_tileSize;
+	const int32_t slotCount = clamp(residentTiles, 1, m_tileCount * m_tileCount);
+
+	m_heights.reset(new height_t[slotCount * tileSamples]);
+	m_cuts.reset(new uint8_t[slotCount * tileSamples / 8]);
+	m_attributes.reset(new uint8_t[slotCount * tileSamples]);
+
+	m_slots.resize(slotCount);
+	for (int32_t i = 0; i < slotCount; ++i)
+	{
+		m_slots[i].heights = m_heights.ptr() + i * tileSamples;
+		m_slots[i].cuts = m_cuts.ptr() + i * tileSamples / 8;
+		m_slots[i].attributes = m_attributes.ptr() + i * tileSamples;
+	}
+
+	m_tileSlots.resize(m_tileCount * m_tileCount, -1);
+	return true;
+}
+
+void HeightfieldTileCache::destroy()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	if (m_stream)
+	{
+		m_stream->close();
+		m_stream = nullptr;
+	}
+	m_slots.clear();
+	m_tileSlots.clear();
+	m_heights.release();
+	m_cuts.release();
+	m_attributes.release();
+}
+
+int32_t HeightfieldTileCache::prefetch(int32_t gridX0, int32_t gridZ0, int32_t gridX1, int32_t gridZ1, int32_t maxLoads)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	const int32_t tx0 = clamp(gridX0, 0, m_size - 1) / m_tileSize;
+	const int32_t tz0 = clamp(gridZ0, 0, m_size - 1) / m_tileSize;
+	const int32_t tx1 = clamp(gridX1, 0, m_size - 1) / m_tileSize;
+	const int32_t tz1 = clamp(gridZ1, 0, m_size - 1) / m_tileSize;
+
+	// Never prefetch more than half of the slots, else
+	// prefetched tiles would evict each other.
+	int32_t budget = (int32_t)m_slots.size() / 2;
+	int32_t loads = 0;
+
+	for (int32_t tz = tz0; tz <= tz1; ++tz)
+	{
+		for (int32_t tx = tx0; tx <= tx1; ++tx)
+		{
+			if (budget-- <= 0)
+				return loads;
+
+			const int32_t tile = tx + tz * m_tileCount;
+			if (m_tileSlots[tile] >= 0)
+			{
+				m_slots[m_tileSlots[tile]].lastUsed = ++m_counter;
+				continue;
+			}
+
+			if (loads >= maxLoads)
+				continue;
+
+			acquire(tx, tz);
+			++loads;
+		}
+	}
+
+	return loads;
+}
+
+height_t HeightfieldTileCache::getHeight(int32_t gridX, int32_t gridZ) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	const Slot& slot = acquire(gridX / m_tileSize, gridZ / m_tileSize);
+	return slot.heights[(gridX % m_tileSize) + (gridZ % m_tileSize) * m_tileSize];
+}
+
+void HeightfieldTileCache::getHeightQuad(int32_t gridX, int32_t gridZ, height_t outHeights[4]) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	getHeightQuadUnlocked(gridX, gridZ, outHeights);
+}
+
+void HeightfieldTileCache::getHeightQuads(const int32_t* gridX, const int32_t* gridZ, uint32_t count, height_t* outHeights) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	for (uint32_t i = 0; i < count; ++i)
+		getHeightQuadUnlocked(gridX[i], gridZ[i], &outHeights[i * 4]);
+}
+
+bool HeightfieldTileCache::getCut(int32_t gridX, int32_t gridZ) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	const Slot& slot = acquire(gridX / m_tileSize, gridZ / m_tileSize);
+	const int32_t offset = (gridX % m_tileSize) + (gridZ % m_tileSize) * m_tileSize;
+	return (slot.cuts[offset / 8] & (1 << (offset & 7))) != 0;
+}
+
+uint8_t HeightfieldTileCache::getAttribute(int32_t gridX, int32_t gridZ) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	const Slot& slot = acquire(gridX / m_tileSize, gridZ / m_tileSize);
+	return slot.attributes[(gridX % m_tileSize) + (gridZ % m_tileSize) * m_tileSize];
+}
+
+void HeightfieldTileCache::getCellRange(int32_t cellX, int32_t cellZ, height_t& outMin, height_t& outMax) const
+{
+	const int32_t offset = (cellX + cellZ * m_cellPitch) * 2;
+	outMin = m_cellRanges[offset];
+	outMax = m_cellRanges[offset + 1];
+}
+
+int32_t HeightfieldTileCache::getResidentCount() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	int32_t count = 0;
+	for (const auto& slot : m_slots)
+	{
+		if (slot.tile >= 0)
+			++count;
+	}
+	return count;
+}
+
+HeightfieldTileCache::Slot& HeightfieldTileCache::acquire(int32_t tileX, int32_t tileZ) const
+{
+	const int32_t tile = tileX + tileZ * m_tileCount;
+
+	const int32_t resident = m_tileSlots[tile];
+	if (resident >= 0)
+	{
+		Slot& slot = m_slots[resident];
+		slot.lastUsed = ++m_counter;
+		return slot;
+	}
+
+	// Evict least recently used tile.
+	int32_t victim = 0;
+	for (int32_t i = 1; i < (int32_t)m_slots.size(); ++i)
+	{
+		if (m_slots[i].lastUsed < m_slots[victim].lastUsed)
+			victim = i;
+	}
+
+	Slot& slot = m_slots[victim];
+	if (slot.tile >= 0)
+		m_tileSlots[slot.tile] = -1;
+
+	if (!load(slot, tile))
+	{
+		log::error << L"Unable to read heightfield tile " << tileX << L", " << tileZ << L"." << Endl;
+		const int32_t tileSamples = m_tileSize * m_tileSize;
+		for (int32_t i = 0; i < tileSamples; ++i)
+			slot.heights[i] = 0;
+		for (int32_t i = 0; i < tileSamples / 8; ++i)
+			slot.cuts[i] = 0xff;
+		for (int32_t i = 0; i < tileSamples; ++i)
+			slot.attributes[i] = 0;
+	}
+
+	slot.tile = tile;
+	slot.lastUsed = ++m_counter;
+	m_tileSlots[tile] = victim;
+	return slot;
+}
+
+void HeightfieldTileCache::getHeightQuadUnlocked(int32_t gridX, int32_t gridZ, height_t outHeights[4]) const
+{
+	const int32_t lx = gridX % m_tileSize;
+	const int32_t lz = gridZ % m_tileSize;
+
+	// Fast path; entire quad within a single tile.
+	if (lx < m_tileSize - 1 && lz < m_tileSize - 1)
+	{
+		const Slot& slot = acquire(gridX / m_tileSize, gridZ / m_tileSize);
+		const height_t* heights = &slot.heights[lx + lz * m_tileSize];
+		outHeights[0] = heights[0];
+		outHeights[1] = heights[1];
+		outHeights[2] = heights[m_tileSize];
+		outHeights[3] = heights[m_tileSize + 1];
+		return;
+	}
+
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		const int32_t x = min(gridX + (i & 1), m_size - 1);
+		const int32_t z = min(gridZ + (i >> 1), m_size - 1);
+		const Slot& slot = acquire(x / m_tileSize, z / m_tileSize);
+		outHeights[i] = slot.heights[(x % m_tileSize) + (z % m_tileSize) * m_tileSize];
+	}
+}
+
+bool HeightfieldTileCache::load(Slot& slot, int32_t tile) const
+{
+	const int64_t tileSamples = m_tileSize * m_tileSize;
+	const int64_t tileBytes = tileSamples * sizeof(height_t) + tileSamples / 8 + tileSamples;
+
+	if (m_stream->seek(IStream::SeekSet, m_dataOffset + tile * tileBytes) < 0)
+		return false;
+
+	Reader r(m_stream);
+	if (r.read(slot.heights, tileSamples, sizeof(height_t)) != tileSamples * (int64_t)sizeof(height_t))
+		return false;
+	if (r.read(slot.cuts, tileSamples / 8, sizeof(uint8_t)) != tileSamples / 8)
+		return false;
+	if (r.read(slot.attributes, tileSamples, sizeof(uint8_t)) != tileSamples)
+		return false;
+
+	++m_loadCount;
+	return true;
+}
+
+}
@@ -0,0 +1,148 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Misc/AutoPtr.h"
+#include "Core/Thread/Semaphore.h"
+#include "Heightfield/HeightfieldTypes.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_HEIGHTFIELD_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class IStream;
+
+}
+
+namespace traktor::hf
+{
+
+/*! Cache of resident heightfield tiles.
+ * \ingroup Heightfield
+ *
+ * Tiles are read on demand from a seekable stream containing
+ * tiled heightfield data, as written by HeightfieldFormat::writeTiled,
+ * and kept in a fixed number of slots; least recently used tile
+ * is evicted when a new tile is needed.
+ *
+ * Only a small header, with height range of each cell, is
+ * kept in memory for the whole heightfield.
+ *
+ * All methods are thread safe.
+ */
+class T_DLLCLASS HeightfieldTileCache : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual ~HeightfieldTileCache();
+
+	/*! Create cache from tiled heightfield stream.
+	 *
+	 * \param stream Stream positioned at beginning of tiled data, stream is kept open.
+	 * \param residentTiles Maximum number of resident tiles.
+	 * \return True if successfully created.
+	 */
+	bool create(IStream* stream, int32_t residentTiles);
+
+	void destroy();
+
+	/*! Ensure tiles overlapping a grid region are resident.
+	 *
+	 * \param gridX0 Region left.
+	 * \param gridZ0 Region top.
+	 * \param gridX1 Region right, inclusive.
+	 * \param gridZ1 Region bottom, inclusive.
+	 * \param maxLoads Maximum number of tiles to read from stream.
+	 * \return Number of tiles read.
+	 */
+	int32_t prefetch(int32_t gridX0, int32_t gridZ0, int32_t gridX1, int32_t gridZ1, int32_t maxLoads);
+
+	height_t getHeight(int32_t gridX, int32_t gridZ) const;
+
+	/*! Get four heights of a grid quad, [x,z], [x+1,z], [x,z+1] and [x+1,z+1]. */
+	void getHeightQuad(int32_t gridX, int32_t gridZ, height_t outHeights[4]) const;
+
+	/*! Get heights of multiple grid quads, lock is only acquired once.
+	 *
+	 * \param gridX Quad X positions.
+	 * \param gridZ Quad Z positions.
+	 * \param count Number of quads.
+	 * \param outHeights Four heights per quad, same order as getHeightQuad.
+	 */
+	void getHeightQuads(const int32_t* gridX, const int32_t* gridZ, uint32_t count, height_t* outHeights) const;
+
+	bool getCut(int32_t gridX, int32_t gridZ) const;
+
+	uint8_t getAttribute(int32_t gridX, int32_t gridZ) const;
+
+	/*! Get height range of a cell, cell bounds include first samples of neighbour cells. */
+	void getCellRange(int32_t cellX, int32_t cellZ, height_t& outMin, height_t& outMax) const;
+
+	int32_t getSize() const { return m_size; }
+
+	int32_t getTileSize() const { return m_tileSize; }
+
+	int32_t getCellSize() const { return m_cellSize; }
+
+	bool haveCuts() const { return m_haveCuts; }
+
+	/*! Get number of currently resident tiles. */
+	int32_t getResidentCount() const;
+
+	/*! Get number of tiles read from stream since creation. */
+	int32_t getLoadCount() const { return m_loadCount; }
+
+private:
+	struct Slot
+	{
+		int32_t tile = -1;
+		uint32_t lastUsed = 0;
+		height_t* heights = nullptr;
+		uint8_t* cuts = nullptr;
+		uint8_t* attributes = nullptr;
+	};
+
+	mutable Semaphore m_lock;
+	Ref< IStream > m_stream;
+	int64_t m_dataOffset = 0;
+	int32_t m_size = 0;
+	int32_t m_tileSize = 0;
+	int32_t m_tileCount = 0;
+	int32_t m_cellSize = 0;
+	int32_t m_cellPitch = 0;
+	bool m_haveCuts = false;
+	AlignedVector< height_t > m_cellRanges;
+	AutoArrayPtr< height_t > m_heights;
+	AutoArrayPtr< uint8_t > m_cuts;
+	AutoArrayPtr< uint8_t > m_attributes;
+	mutable AlignedVector< Slot > m_slots;
+	mutable AlignedVector< int32_t > m_tileSlots;
+	mutable uint32_t m_counter = 0;
+	mutable int32_t m_loadCount = 0;
+
+	/*! Get slot of resident tile, tile is read into least recently used slot if not resident; lock must be held. */
+	Slot& acquire(int32_t tileX, int32_t tileZ) const;
+
+	void getHeightQuadUnlocked(int32_t gridX, int32_t gridZ, height_t outHeights[4]) const;
+
+	bool load(Slot& slot, int32_t tile) const;
+};
+
+}
@@ -0,0 +1,238 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include <limits>
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+#include "Heightfield/Heightfield.h"
+#include "Heightfield/HeightfieldFormat.h"
+#include "Heightfield/Test/CaseHeightfieldQueries.h"
+
+namespace traktor::hf::test
+{
+	namespace
+	{
+
+const int32_t c_size = 1024;
+const uint32_t c_pointCount = 100000;
+const uint32_t c_rayCount = 32;
+const uint32_t c_benchmarkPointCount = 1000000;
+const uint32_t c_benchmarkRayCount = 10000;
+
+Ref< Heightfield > createHeightfield()
+{
+	Ref< Heightfield > heightfield = new Heightfield(c_size, Vector4(1024.0f, 200.0f, 1024.0f, 0.0f));
+	for (int32_t z = 0; z < c_size; ++z)
+	{
+		for (int32_t x = 0; x < c_size; ++x)
+		{
+			const float h = 0.5f + 0.25f * std::sin(x * 0.013f) * std::cos(z * 0.021f) + 0.1f * std::sin((x + z) * 0.11f);
+			heightfield->setGridHeight(x, z, h);
+			heightfield->setGridCut(x, z, true);
+			heightfield->setGridAttribute(x, z, 0);
+		}
+	}
+	heightfield->updateCellBounds();
+	return heightfield;
+}
+
+/*! Closest intersection by testing every triangle, used as reference. */
+bool queryRayBruteForce(const Heightfield* heightfield, const Vector4& origin, const Vector4& direction, float& outDistance)
+{
+	outDistance = std::numeric_limits< float >::max();
+	for (int32_t iz = 0; iz < c_size - 1; ++iz)
+	{
+		for (int32_t ix = 0; ix < c_size - 1; ++ix)
+		{
+			float x1w, z1w, x2w, z2w;
+			heightfield->gridToWorld(float(ix), float(iz), x1w, z1w);
+			heightfield->gridToWorld(float(ix + 1), float(iz + 1), x2w, z2w);
+
+			const Vector4 vw[] = {
+				Vector4(x1w, heightfield->unitToWorld(heightfield->getGridHeightNearest(ix, iz)), z1w, 1.0f),
+				Vector4(x2w, heightfield->unitToWorld(heightfield->getGridHeightNearest(ix + 1, iz)), z1w, 1.0f),
+				Vector4(x1w, heightfield->unitToWorld(heightfield->getGridHeightNearest(ix, iz + 1)), z2w, 1.0f),
+				Vector4(x2w, heightfield->unitToWorld(heightfield->getGridHeightNearest(ix + 1, iz + 1)), z2w, 1.0f)
+			};
+
+			const int32_t triangles[2][3] = { { 0, 1, 2 }, { 1, 3, 2 } };
+			for (const auto& t : triangles)
+			{
+				const Vector4 e1 = vw[t[1]] - vw[t[0]];
+				const Vector4 e2 = vw[t[2]] - vw[t[0]];
+				const Vector4 p = cross(direction, e2);
+				const float det = dot3(e1, p);
+				if (std::abs(det) < 1e-12f)
+					continue;
+				const Vector4 s = origin - vw[t[0]];
+				const float u = dot3(s, p) / det;
+				const Vector4 q = cross(s, e1);
+				const float v = dot3(direction, q) / det;
+				const float k = dot3(e2, q) / det;
+				if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && k > 0.0f && k < outDistance)
+					outDistance = k;
+			}
+		}
+	}
+	return outDistance < std::numeric_limits< float >::max();
+}
+
+void createRays(Random& random, uint32_t count, AlignedVector< Vector4 >& outOrigins, AlignedVector< Vector4 >& outDirections)
+{
+	outOrigins.resize(count);
+	outDirections.resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		// Mix of steep and grazing rays.
+		const float horizontal = (i & 1) ? 0.3f : 4.0f;
+		outOrigins[i] = Vector4((random.nextFloat() - 0.5f) * 900.0f, 60.0f + random.nextFloat() * 40.0f, (random.nextFloat() - 0.5f) * 900.0f, 1.0f);
+		outDirections[i] = Vector4((random.nextFloat() - 0.5f) * horizontal, -1.0f, (random.nextFloat() - 0.5f) * horizontal, 0.0f).normalized();
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.test.CaseHeightfieldQueries", 0, CaseHeightfieldQueries, traktor::test::Case)
+
+void CaseHeightfieldQueries::run()
+{
+	Ref< Heightfield > heightfield = createHeightfield();
+	Random random;
+
+	// Batched heights and normals must match single queries.
+	AlignedVector< Vector4 > positions(c_pointCount);
+	AlignedVector< float > gridX(c_pointCount), gridZ(c_pointCount);
+	for (uint32_t i = 0; i < c_pointCount; ++i)
+	{
+		positions[i] = Vector4((random.nextFloat() - 0.5f) * 1100.0f, 0.0f, (random.nextFloat() - 0.5f) * 1100.0f, 1.0f);
+		heightfield->worldToGrid(positions[i].x(), positions[i].z(), gridX[i], gridZ[i]);
+	}
+
+	AlignedVector< float > heights(c_pointCount);
+	heightfield->getWorldHeights(positions.c_ptr(), c_pointCount, heights.ptr());
+
+	AlignedVector< Vector4 > normals(c_pointCount);
+	heightfield->normalsAt(gridX.c_ptr(), gridZ.c_ptr(), c_pointCount, normals.ptr());
+
+	int32_t heightMismatches = 0;
+	int32_t normalMismatches = 0;
+	for (uint32_t i = 0; i < c_pointCount; ++i)
+	{
+		if (std::abs(heights[i] - heightfield->getWorldHeight(positions[i].x(), positions[i].z())) > 1e-4f)
+			++heightMismatches;
+		if ((normals[i] - heightfield->normalAt(gridX[i], gridZ[i])).length() > 1e-4f)
+			++normalMismatches;
+	}
+	CASE_ASSERT_EQUAL(heightMismatches, 0);
+	CASE_ASSERT_EQUAL(normalMismatches, 0);
+
+	// Batched queries on tiled heightfield must match in-memory heightfield.
+	Ref< DynamicMemoryStream > stream = new DynamicMemoryStream();
+	CASE_ASSERT(HeightfieldFormat().writeTiled(stream, heightfield, 128));
+	stream->seek(IStream::SeekSet, 0);
+
+	Ref< Heightfield > tiled = HeightfieldFormat().readTiled(stream, heightfield->getWorldExtent(), 16);
+	CASE_ASSERT(tiled != nullptr);
+	if (tiled)
+	{
+		AlignedVector< float > tiledHeights(c_pointCount);
+		tiled->getWorldHeights(positions.c_ptr(), c_pointCount, tiledHeights.ptr());
+
+		int32_t tiledMismatches = 0;
+		for (uint32_t i = 0; i < c_pointCount; ++i)
+		{
+			if (tiledHeights[i] != heights[i])
+				++tiledMismatches;
+		}
+		CASE_ASSERT_EQUAL(tiledMismatches, 0);
+	}
+
+	// Ray queries must find same intersection as testing every triangle.
+	AlignedVector< Vector4 > origins, directions;
+	createRays(random, c_rayCount, origins, directions);
+
+	AlignedVector< float > distances(c_rayCount);
+	const uint32_t hits = heightfield->queryRays(origins.c_ptr(), directions.c_ptr(), c_rayCount, distances.ptr());
+	CASE_ASSERT(hits > 0);
+
+	int32_t rayMismatches = 0;
+	for (uint32_t i = 0; i < c_rayCount; ++i)
+	{
+		float reference;
+		const bool referenceHit = queryRayBruteForce(heightfield, origins[i], directions[i], reference);
+		if (referenceHit != (distances[i] >= 0.0f))
+			++rayMismatches;
+		else if (referenceHit && std::abs(reference - distances[i]) > 1e-3f * reference)
+			++rayMismatches;
+	}
+	CASE_ASSERT_EQUAL(rayMismatches, 0);
+
+	// Benchmark.
+	Timer timer;
+	float sum = 0.0f;
+
+	AlignedVector< Vector4 > benchmarkPositions(c_benchmarkPointCount);
+	AlignedVector< float > benchmarkGridX(c_benchmarkPointCount), benchmarkGridZ(c_benchmarkPointCount);
+	for (uint32_t i = 0; i < c_benchmarkPointCount; ++i)
+	{
+		benchmarkPositions[i] = Vector4((random.nextFloat() - 0.5f) * 1000.0f, 0.0f, (random.nextFloat() - 0.5f) * 1000.0f, 1.0f);
+		heightfield->worldToGrid(benchmarkPositions[i].x(), benchmarkPositions[i].z(), benchmarkGridX[i], benchmarkGridZ[i]);
+	}
+	AlignedVector< float > benchmarkHeights(c_benchmarkPointCount);
+	AlignedVector< Vector4 > benchmarkNormals(c_benchmarkPointCount);
+
+	double start = timer.getElapsedTime();
+	for (uint32_t i = 0; i < c_benchmarkPointCount; ++i)
+		sum += heightfield->getWorldHeight(benchmarkPositions[i].x(), benchmarkPositions[i].z());
+	const double heightSingle = timer.getElapsedTime() - start;
+
+	start = timer.getElapsedTime();
+	heightfield->getWorldHeights(benchmarkPositions.c_ptr(), c_benchmarkPointCount, benchmarkHeights.ptr());
+	const double heightBatch = timer.getElapsedTime() - start;
+	sum += benchmarkHeights[c_benchmarkPointCount / 2];
+
+	start = timer.getElapsedTime();
+	for (uint32_t i = 0; i < c_benchmarkPointCount; ++i)
+		sum += heightfield->normalAt(benchmarkGridX[i], benchmarkGridZ[i]).y();
+	const double normalSingle = timer.getElapsedTime() - start;
+
+	start = timer.getElapsedTime();
+	heightfield->normalsAt(benchmarkGridX.c_ptr(), benchmarkGridZ.c_ptr(), c_benchmarkPointCount, benchmarkNormals.ptr());
+	const double normalBatch = timer.getElapsedTime() - start;
+	sum += benchmarkNormals[c_benchmarkPointCount / 2].y();
+
+	AlignedVector< Vector4 > benchmarkOrigins, benchmarkDirections;
+	createRays(random, c_benchmarkRayCount, benchmarkOrigins, benchmarkDirections);
+	AlignedVector< float > benchmarkDistances(c_benchmarkRayCount);
+
+	start = timer.getElapsedTime();
+	heightfield->queryRays(benchmarkOrigins.c_ptr(), benchmarkDirections.c_ptr(), c_benchmarkRayCount, benchmarkDistances.ptr());
+	const double rays = timer.getElapsedTime() - start;
+
+	start = timer.getElapsedTime();
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		float distance;
+		queryRayBruteForce(heightfield, benchmarkOrigins[i], benchmarkDirections[i], distance);
+		sum += distance;
+	}
+	const double raysBruteForce = (timer.getElapsedTime() - start) / 4.0;
+
+	log::info << L"Heightfield queries, " << c_size << L"x" << c_size << Endl;
+	log::info << L"  heights, single " << (c_benchmarkPointCount / heightSingle) / 1e6 << L" M/s, batched " << (c_benchmarkPointCount / heightBatch) / 1e6 << L" M/s" << Endl;
+	log::info << L"  normals, single " << (c_benchmarkPointCount / normalSingle) / 1e6 << L" M/s, batched " << (c_benchmarkPointCount / normalBatch) / 1e6 << L" M/s" << Endl;
+	log::info << L"  rays, " << c_benchmarkRayCount / rays << L" /s, every triangle " << 1.0 / raysBruteForce << L" /s" << Endl;
+
+	CASE_ASSERT(sum != 0.0f);
+}
+
+}
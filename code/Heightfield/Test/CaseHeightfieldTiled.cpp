@@ -0,0 +1,158 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cmath>
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Math/Random.h"
+#include "Heightfield/Heightfield.h"
+#include "Heightfield/HeightfieldFormat.h"
+#include "Heightfield/HeightfieldTileCache.h"
+#include "Heightfield/Test/CaseHeightfieldTiled.h"
+
+namespace traktor::hf::test
+{
+	namespace
+	{
+
+const int32_t c_size = 1024;
+const int32_t c_tileSize = 128;
+const int32_t c_residentTiles = 16;
+const int32_t c_sampleCount = 100000;
+const int32_t c_rayCount = 32;
+
+Ref< Heightfield > createHeightfield()
+{
+	Ref< Heightfield > heightfield = new Heightfield(c_size, Vector4(1024.0f, 200.0f, 1024.0f, 0.0f));
+	for (int32_t z = 0; z < c_size; ++z)
+	{
+		for (int32_t x = 0; x < c_size; ++x)
+		{
+			const float h = 0.5f + 0.25f * std::sin(x * 0.013f) * std::cos(z * 0.021f) + 0.1f * std::sin((x + z) * 0.11f);
+			heightfield->setGridHeight(x, z, h);
+			heightfield->setGridCut(x, z, !(x > 300 && x < 340 && z > 500 && z < 530));
+			heightfield->setGridAttribute(x, z, uint8_t((x / 17 + z / 13) & 7));
+		}
+	}
+	heightfield->updateCellBounds();
+	return heightfield;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.hf.test.CaseHeightfieldTiled", 0, CaseHeightfieldTiled, traktor::test::Case)
+
+void CaseHeightfieldTiled::run()
+{
+	Ref< Heightfield > reference = createHeightfield();
+
+	Ref< DynamicMemoryStream > stream = new DynamicMemoryStream();
+	CASE_ASSERT(HeightfieldFormat().writeTiled(stream, reference, c_tileSize));
+	stream->seek(IStream::SeekSet, 0);
+
+	Ref< Heightfield > tiled = HeightfieldFormat().readTiled(stream, reference->getWorldExtent(), c_residentTiles);
+	CASE_ASSERT(tiled != nullptr);
+	if (!tiled)
+		return;
+
+	HeightfieldTileCache* tiles = tiled->getTileCache();
+	CASE_ASSERT(tiles != nullptr);
+	CASE_ASSERT_EQUAL(tiled->getSize(), c_size);
+	CASE_ASSERT_EQUAL(tiled->haveCuts(), reference->haveCuts());
+	CASE_ASSERT(tiled->haveCuts());
+	CASE_ASSERT(tiled->getHeights() == nullptr);
+
+	// Opening tiled heightfield must not read any tile.
+	CASE_ASSERT_EQUAL(tiles->getLoadCount(), 0);
+
+	// Point queries must be identical to in-memory heightfield.
+	Random random;
+	int32_t heightMismatches = 0;
+	int32_t cutMismatches = 0;
+	int32_t attributeMismatches = 0;
+	int32_t normalMismatches = 0;
+	for (int32_t i = 0; i < c_sampleCount; ++i)
+	{
+		const float worldX = (random.nextFloat() - 0.5f) * 1024.0f;
+		const float worldZ = (random.nextFloat() - 0.5f) * 1024.0f;
+
+		if (tiled->getWorldHeight(worldX, worldZ) != reference->getWorldHeight(worldX, worldZ))
+			++heightMismatches;
+		if (tiled->getWorldCut(worldX, worldZ) != reference->getWorldCut(worldX, worldZ))
+			++cutMismatches;
+		if (tiled->getWorldAttribute(worldX, worldZ) != reference->getWorldAttribute(worldX, worldZ))
+			++attributeMismatches;
+
+		float gridX, gridZ;
+		reference->worldToGrid(worldX, worldZ, gridX, gridZ);
+		if (tiled->normalAt(gridX, gridZ) != reference->normalAt(gridX, gridZ))
+			++normalMismatches;
+	}
+	CASE_ASSERT_EQUAL(heightMismatches, 0);
+	CASE_ASSERT_EQUAL(cutMismatches, 0);
+	CASE_ASSERT_EQUAL(attributeMismatches, 0);
+	CASE_ASSERT_EQUAL(normalMismatches, 0);
+
+	// Never more tiles resident than requested.
+	CASE_ASSERT(tiles->getResidentCount() <= c_residentTiles);
+
+	// Ray queries, cell bounds come from header and
+	// triangles from tiles.
+	int32_t rayMismatches = 0;
+	for (int32_t i = 0; i < c_rayCount; ++i)
+	{
+		const Vector4 origin((random.nextFloat() - 0.5f) * 800.0f, 150.0f, (random.nextFloat() - 0.5f) * 800.0f, 1.0f);
+		const Vector4 direction = Vector4((random.nextFloat() - 0.5f) * 0.5f, -1.0f, (random.nextFloat() - 0.5f) * 0.5f, 0.0f).normalized();
+
+		Scalar referenceDistance, tiledDistance;
+		const bool referenceHit = reference->queryRay(origin, direction, referenceDistance);
+		const bool tiledHit = tiled->queryRay(origin, direction, tiledDistance);
+		if (referenceHit != tiledHit || (referenceHit && referenceDistance != tiledDistance))
+			++rayMismatches;
+	}
+	CASE_ASSERT_EQUAL(rayMismatches, 0);
+
+	// Tiles around viewer are resident after prefetch.
+	const Vector4 viewer(100.0f, 0.0f, -200.0f, 1.0f);
+	for (int32_t i = 0; i < 4; ++i)
+		tiled->prefetch(viewer, 64.0f);
+
+	const int32_t loadsBefore = tiles->getLoadCount();
+	for (int32_t i = 0; i < c_sampleCount; ++i)
+		tiled->getWorldHeight(viewer.x() + (random.nextFloat() - 0.5f) * 120.0f, viewer.z() + (random.nextFloat() - 0.5f) * 120.0f);
+	CASE_ASSERT_EQUAL(tiles->getLoadCount(), loadsBefore);
+
+	// Tiled heightfield cannot be written as whole arrays.
+	Ref< DynamicMemoryStream > tiledOutput = new DynamicMemoryStream();
+	CASE_ASSERT(!HeightfieldFormat().write(tiledOutput, tiled));
+
+	// Resident heightfield is identical and writable.
+	tiled->makeResident();
+	CASE_ASSERT(tiled->getTileCache() == nullptr);
+	CASE_ASSERT(tiled->getHeights() != nullptr);
+	CASE_ASSERT(tiled->getCuts() != nullptr);
+	CASE_ASSERT(tiled->getAttributes() != nullptr);
+
+	Ref< DynamicMemoryStream > referenceOutput = new DynamicMemoryStream();
+	Ref< DynamicMemoryStream > residentOutput = new DynamicMemoryStream();
+	CASE_ASSERT(HeightfieldFormat().write(referenceOutput, reference));
+	CASE_ASSERT(HeightfieldFormat().write(residentOutput, tiled));
+	const auto& referenceBuffer = referenceOutput->getBuffer();
+	const auto& residentBuffer = residentOutput->getBuffer();
+	CASE_ASSERT_EQUAL(residentBuffer.size(), referenceBuffer.size());
+	CASE_ASSERT(std::equal(residentBuffer.begin(), residentBuffer.end(), referenceBuffer.begin()));
+
+	tiled->setGridHeight(10, 20, 0.0f);
+	tiled->setGridCut(10, 20, false);
+	tiled->setGridAttribute(10, 20, 9);
+	CASE_ASSERT_EQUAL(tiled->getGridHeightNearest(10, 20), 0.0f);
+	CASE_ASSERT(!tiled->getGridCut(10, 20));
+	CASE_ASSERT_EQUAL(tiled->getGridAttribute(10, 20), (uint8_t)9);
+}
+
+}
@@ -86,6 +86,14 @@ public:
 
 	float getTimeUntilTxPing() const { return m_configuration.timeUntilTxPing; }
 
+	void setInterestFar(float interestFar) { m_configuration.interestFar = interestFar; }
+
+	float getInterestFar() const { return m_configuration.interestFar; }
+
+	void setTxStateBandwidth(float txStateBandwidth) { m_configuration.txStateBandwidth = txStateBandwidth; }
+
+	float getTxStateBandwidth() const { return m_configuration.txStateBandwidth; }
+
 	const Replicator::Configuration& getConfiguration() const { return m_configuration; }
 
 private:
@@ -271,6 +279,7 @@ void JungleClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 
 	auto classTransformTemplate = new AutoRuntimeClass< TransformTemplate >();
 	classTransformTemplate->addConstructor< const std::wstring& >();
+	classTransformTemplate->addConstructor< const std::wstring&, float, float, int32_t >();
 	registrar->registerClass(classTransformTemplate);
 
 	auto classVectorValue = new AutoRuntimeClass< VectorValue >();
@@ -280,6 +289,7 @@ void JungleClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 
 	auto classVectorTemplate = new AutoRuntimeClass< VectorTemplate >();
 	classVectorTemplate->addConstructor< const std::wstring& >();
+	classVectorTemplate->addConstructor< const std::wstring&, float, float, int32_t >();
 	registrar->registerClass(classVectorTemplate);
 
 	auto classIValue = new AutoRuntimeClass< IValue >();
@@ -318,6 +328,8 @@ void JungleClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	classMeasureP2PProvider->addConstructor< IPeer2PeerProvider* >();
 	classMeasureP2PProvider->addProperty("sendBitsPerSecond", &MeasureP2PProvider::getSendBitsPerSecond);
 	classMeasureP2PProvider->addProperty("recvBitsPerSecond", &MeasureP2PProvider::getRecvBitsPerSecond);
+	classMeasureP2PProvider->addProperty("sentBytes", &MeasureP2PProvider::getSentBytes);
+	classMeasureP2PProvider->addProperty("recvBytes", &MeasureP2PProvider::getRecvBytes);
 	registrar->registerClass(classMeasureP2PProvider);
 
 	auto classPeer2PeerTopology = new AutoRuntimeClass< Peer2PeerTopology >();
@@ -344,6 +356,14 @@ void JungleClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	classReplicatorProxy->addProperty("origin", &ReplicatorProxy::setOrigin, &ReplicatorProxy::getOrigin);
 	classReplicatorProxy->addProperty("stateTemplate", &ReplicatorProxy::setStateTemplate, &ReplicatorProxy::getStateTemplate);
 	classReplicatorProxy->addProperty("sendState", &ReplicatorProxy::setSendState, &ReplicatorProxy::getSendState);
+	classReplicatorProxy->addProperty("interest", &ReplicatorProxy::getInterest);
+	classReplicatorProxy->addProperty("txBytes", &ReplicatorProxy::getTxBytes);
+	classReplicatorProxy->addProperty("rxBytes", &ReplicatorProxy::getRxBytes);
+	classReplicatorProxy->addProperty("txStateBytes", &ReplicatorProxy::getTxStateBytes);
+	classReplicatorProxy->addProperty("txStateCount", &ReplicatorProxy::getTxStateCount);
+	classReplicatorProxy->addProperty("txDeltaStateCount", &ReplicatorProxy::getTxDeltaStateCount);
+	classReplicatorProxy->addProperty("txBitsPerSecond", &ReplicatorProxy::getTxBitsPerSecond);
+	classReplicatorProxy->addProperty("rxBitsPerSecond", &ReplicatorProxy::getRxBitsPerSecond);
 	classReplicatorProxy->addMethod("getState", &ReplicatorProxy::getState);
 	classReplicatorProxy->addMethod("getFilteredState", &ReplicatorProxy::getFilteredState);
 	classReplicatorProxy->addMethod("setPrimary", &ReplicatorProxy::setPrimary);
@@ -367,6 +387,8 @@ void JungleClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	classReplicatorConfiguration->addProperty("timeUntilTxStateNear", &ReplicatorConfiguration::setTimeUntilTxStateNear, &ReplicatorConfiguration::getTimeUntilTxStateNear);
 	classReplicatorConfiguration->addProperty("timeUntilTxStateFar", &ReplicatorConfiguration::setTimeUntilTxStateFar, &ReplicatorConfiguration::getTimeUntilTxStateFar);
 	classReplicatorConfiguration->addProperty("timeUntilTxPing", &ReplicatorConfiguration::setTimeUntilTxPing, &ReplicatorConfiguration::getTimeUntilTxPing);
+	classReplicatorConfiguration->addProperty("interestFar", &ReplicatorConfiguration::setInterestFar, &ReplicatorConfiguration::getInterestFar);
+	classReplicatorConfiguration->addProperty("txStateBandwidth", &ReplicatorConfiguration::setTxStateBandwidth, &ReplicatorConfiguration::getTxStateBandwidth);
 	registrar->registerClass(classReplicatorConfiguration);
 
 	auto classReplicator = new AutoRuntimeClass< Replicator >();
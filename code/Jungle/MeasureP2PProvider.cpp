@@ -35,6 +35,8 @@ bool MeasureP2PProvider::update()
 {
 	const double time = s_timer.getElapsedTime();
 	const double duration = time - m_time;
+	if (duration <= 0.0)
+		return m_provider->update();
 
 	const double sentBps = (m_sentBytes * 8.0) / duration;
 	const double recvBps = (m_recvBytes * 8.0) / duration;
@@ -50,6 +52,8 @@ bool MeasureP2PProvider::update()
 		m_recvBps = recvBps;
 
 	m_time = time;
+	m_sentBytes = 0;
+	m_recvBytes = 0;
 
 	return m_provider->update();
 }
@@ -92,6 +96,7 @@ net_handle_t MeasureP2PProvider::getPrimaryPeerHandle() const
 bool MeasureP2PProvider::send(net_handle_t node, const void* data, int32_t size)
 {
 	m_sentBytes += size;
+	m_totalSentBytes += size;
 	return m_provider->send(node, data, size);
 }
 
@@ -99,7 +104,10 @@ int32_t MeasureP2PProvider::recv(void* data, int32_t size, net_handle_t& outNode
 {
 	const int32_t nbytes = m_provider->recv(data, size, outNode);
 	if (nbytes > 0)
+	{
 		m_recvBytes += nbytes;
+		m_totalRecvBytes += nbytes;
+	}
 
 	return nbytes;
 }
@@ -54,6 +54,12 @@ public:
 
 	float getRecvBitsPerSecond() const;
 
+	/*! Get total number of bytes sent through provider. */
+	uint32_t getSentBytes() const { return m_totalSentBytes; }
+
+	/*! Get total number of bytes received through provider. */
+	uint32_t getRecvBytes() const { return m_totalRecvBytes; }
+
 private:
 	Ref< IPeer2PeerProvider > m_provider;
 	double m_time;
@@ -61,6 +67,8 @@ private:
 	int32_t m_recvBytes;
 	double m_sentBps;
 	double m_recvBps;
+	uint32_t m_totalSentBytes = 0;
+	uint32_t m_totalRecvBytes = 0;
 };
 
 }
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <cstring>
 #include "Core/Io/MemoryStream.h"
 #include "Core/Log/Log.h"
@@ -32,6 +33,9 @@ namespace traktor::jungle
 const double c_catastrophicDeltaTime = 30.0;
 const double c_maxDeltaTime = 0.1;
 const uint32_t c_maxDeltaTimeCount = 10;
+const double c_maxTxStateBudgetTime = 0.1;
+const double c_criticalStateRecency = 1.0;
+const float c_furthestInterestScale = 0.25f;
 
 	}
 
@@ -144,7 +148,7 @@ bool Replicator::update()
 		{
 			if ((proxy->m_timeUntilTxPing -= dT) <= 0.0)
 			{
-				m_topology->send(proxy->m_handle, &msg, RmiPing_NetSize());
+				proxy->send(&msg, RmiPing_NetSize());
 				proxy->m_timeUntilTxPing = m_configuration.timeUntilTxPing;
 			}
 		}
@@ -152,35 +156,7 @@ bool Replicator::update()
 
 	// Send our state to proxies.
 	if (m_sendState && m_stateTemplate && m_state)
-	{
-		msg.id = RmiState;
-		msg.time = time2net(m_time);
-
-		const uint32_t stateDataSize = m_stateTemplate->pack(
-			m_state,
-			msg.state.data,
-			RmiState_MaxStateSize()
-		);
-
-		if (stateDataSize > 0)
-		{
-			for (auto proxy : m_proxies)
-			{
-				if (proxy->m_sendState && (proxy->m_timeUntilTxState -= dT) <= 0.0)
-				{
-					m_topology->send(proxy->m_handle, &msg, RmiState_NetSize(stateDataSize));
-
-					const Vector4 direction = proxy->m_origin.translation() - m_origin.translation();
-					const Scalar distance = direction.length();
-
-					const float t = clamp((distance - m_configuration.nearDistance) / (m_configuration.farDistance - m_configuration.nearDistance), 0.0f, 1.0f);
-
-					proxy->m_distance = distance;
-					proxy->m_timeUntilTxState = lerp(m_configuration.timeUntilTxStateNear, m_configuration.timeUntilTxStateFar, t);
-				}
-			}
-		}
-	}
+		sendStates(dT);
 
 	double timeOffset = 0.0;
 	bool timeOffsetReceived = false;
@@ -212,6 +188,8 @@ bool Replicator::update()
 			continue;
 		}
 
+		fromProxy->received(nrecv);
+
 		if (fromProxy->isPrimary() && fromProxy->isLatencyReliable())
 		{
 			const double latency = fromProxy->getReverseLatency();
@@ -254,7 +232,7 @@ bool Replicator::update()
 			reply.pong.latency = time2net(fromProxy->getLatency());
 			reply.pong.latencySpread = time2net(fromProxy->getLatencySpread());
 
-			m_topology->send(fromProxy->m_handle, &reply, RmiPong_NetSize());
+			fromProxy->send(&reply, RmiPong_NetSize());
 		}
 		else if (msg.id == RmiPong)
 		{
@@ -267,10 +245,21 @@ bool Replicator::update()
 		}
 		else if (msg.id == RmiState)
 		{
-			const bool received = fromProxy->receivedState(m_time, net2time(msg.time), msg.state.data, RmiState_StateSize(nrecv));
+			const bool received = fromProxy->receivedState(m_time, net2time(msg.time), msg.state.sequence, -1, msg.state.data, RmiState_StateSize(nrecv));
+			if (received)
+				fromProxy->m_issueStateListeners = true;
+		}
+		else if (msg.id == RmiStateDelta)
+		{
+			const bool received = fromProxy->receivedState(m_time, net2time(msg.time), msg.stateDelta.sequence, msg.stateDelta.baseline, msg.stateDelta.data, RmiStateDelta_StateSize(nrecv));
 			if (received)
 				fromProxy->m_issueStateListeners = true;
 		}
+		else if (msg.id == RmiStateAck)
+		{
+			// Received a state acknowledge; state can be used as baseline for deltas.
+			fromProxy->receivedStateAcknowledge(msg.stateAck.sequence);
+		}
 		else if (msg.id == RmiEvent0 || msg.id == RmiEvent1)
 		{
 			// Unwrap event object.
@@ -285,7 +274,7 @@ bool Replicator::update()
 					reply.id = (msg.id == RmiEvent0) ? RmiEvent0Ack : RmiEvent1Ack;
 					reply.time = time2net(m_time);
 					reply.eventAck.sequence = msg.event.sequence;
-					m_topology->send(fromProxy->m_handle, &reply, RmiEventAck_NetSize());
+					fromProxy->send(&reply, RmiEventAck_NetSize());
 				}
 				else
 					log::error << getLogPrefix() << L"Unable to enqueue event object." << Endl;
@@ -326,7 +315,9 @@ bool Replicator::update()
 	for (auto proxy : m_proxies)
 	{
 		proxy->updateTxEventQueue();
+		proxy->updateStateAcknowledge(dT);
 		proxy->dispatchRxEvents(m_eventListeners);
+		proxy->updateBandwidth(dT);
 	}
 
 	if (m_timeSynchronization && timeOffsetReceived)
@@ -504,6 +495,12 @@ bool Replicator::isPrimary() const
 
 void Replicator::setStateTemplate(const StateTemplate* stateTemplate)
 {
+	// Baselines packed with previous template cannot be used for deltas.
+	if (stateTemplate != m_stateTemplate)
+	{
+		for (auto proxy : m_proxies)
+			proxy->resetBaselines();
+	}
 	m_stateTemplate = stateTemplate;
 }
 
@@ -516,7 +513,10 @@ void Replicator::setState(const State* state)
 		for (auto proxy : m_proxies)
 		{
 			if (proxy->m_distance < m_configuration.furthestDistance)
+			{
 				proxy->m_timeUntilTxState = 0.0;
+				proxy->m_criticalState = true;
+			}
 		}
 	}
 	m_state = state;
@@ -742,6 +742,73 @@ std::wstring Replicator::getLogPrefix() const
 	return L"Replicator: [" + toString(m_topology->getLocalHandle()) + L"] ";
 }
 
+void Replicator::sendStates(double dT)
+{
+	const bool limited = (m_configuration.txStateBandwidth > 0.0f);
+
+	// Accumulate send budget; unused budget is only kept for a short time
+	// to prevent bursts while overdrawn budget is carried over as debt.
+	if (limited)
+		m_txStateBudget = std::min(
+			m_txStateBudget + m_configuration.txStateBandwidth * dT,
+			m_configuration.txStateBandwidth * c_maxTxStateBudgetTime
+		);
+
+	// Score interest of all proxies which are due for a new state.
+	m_txStateQueue.resize(0);
+	for (auto proxy : m_proxies)
+	{
+		if (!proxy->m_sendState)
+			continue;
+
+		const Vector4 direction = proxy->m_origin.translation() - m_origin.translation();
+		proxy->m_distance = direction.length();
+		proxy->m_timeSinceTxState += dT;
+
+		if ((proxy->m_timeUntilTxState -= dT) > 0.0)
+			continue;
+
+		const double recency = proxy->m_timeSinceTxState + (proxy->m_criticalState ? c_criticalStateRecency : 0.0);
+		proxy->m_interest = float(getInterest(proxy->m_distance) * recency);
+
+		m_txStateQueue.push_back(proxy);
+	}
+
+	std::sort(m_txStateQueue.begin(), m_txStateQueue.end(), [](const ReplicatorProxy* l, const ReplicatorProxy* r) {
+		return l->m_interest > r->m_interest;
+	});
+
+	// Send states in order of interest until budget is exhausted; proxies
+	// which are left remain due and gain interest until next update.
+	for (auto proxy : m_txStateQueue)
+	{
+		if (limited && m_txStateBudget <= 0.0)
+			break;
+
+		const uint32_t sent = proxy->sendState(m_stateTemplate, m_state);
+		if (sent == 0)
+			continue;
+
+		if (limited)
+			m_txStateBudget -= sent;
+
+		const float t = clamp((proxy->m_distance - m_configuration.nearDistance) / (m_configuration.farDistance - m_configuration.nearDistance), 0.0f, 1.0f);
+
+		proxy->m_timeUntilTxState = lerp(m_configuration.timeUntilTxStateNear, m_configuration.timeUntilTxStateFar, t);
+		proxy->m_timeSinceTxState = 0.0;
+		proxy->m_criticalState = false;
+	}
+}
+
+float Replicator::getInterest(float distance) const
+{
+	const float t = clamp((distance - m_configuration.nearDistance) / (m_configuration.farDistance - m_configuration.nearDistance), 0.0f, 1.0f);
+	float interest = lerp(1.0f, m_configuration.interestFar, t);
+	if (distance >= m_configuration.furthestDistance)
+		interest *= c_furthestInterestScale;
+	return interest;
+}
+
 bool Replicator::nodeConnected(INetworkTopology* topology, net_handle_t node)
 {
 	std::wstring name;
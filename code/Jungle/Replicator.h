@@ -10,6 +10,7 @@
 
 #include "Core/Object.h"
 #include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Containers/CircularVector.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Math/Transform.h"
@@ -70,6 +71,8 @@ public:
 		float timeUntilTxStateNear = 0.1f;
 		float timeUntilTxStateFar = 0.3f;
 		float timeUntilTxPing = 1.0f;
+		float interestFar = 0.2f;			/*!< Interest of proxies at far distance relative to proxies within near distance. */
+		float txStateBandwidth = 0.0f;		/*!< Bytes per second available for states to all proxies, 0 means unlimited. */
 	};
 
 	virtual ~Replicator();
@@ -174,7 +177,8 @@ public:
 	/*! Set our origin.
 	 *
 	 * Origin is used to determine which frequency
-	 * of transmission to use to each peer.
+	 * of transmission to use to each peer, and the interest
+	 * of each peer when state bandwidth is limited.
 	 *
 	 * \param origin World origin of caller peer.
 	 */
@@ -293,12 +297,18 @@ private:
 	Ref< const State > m_state;
 	RefArray< ReplicatorProxy > m_proxies;
 	bool m_sendState = false;
+	double m_txStateBudget = 0.0;
+	AlignedVector< ReplicatorProxy* > m_txStateQueue;
 	bool m_timeSynchronization = true;
 	bool m_timeSynchronized = false;
 	uint32_t m_exceededDeltaTimeLimit = 0;
 
 	std::wstring getLogPrefix() const;
 
+	void sendStates(double dT);
+
+	float getInterest(float distance) const;
+
 	virtual bool nodeConnected(INetworkTopology* topology, net_handle_t node) override final;
 
 	virtual bool nodeDisconnected(INetworkTopology* topology, net_handle_t node) override final;
@@ -27,6 +27,9 @@ namespace traktor::jungle
 
 const double c_resendTimeThreshold = 0.5;
 const int32_t c_resendCountThreshold = 16;
+const double c_bandwidthInterval = 0.5;
+const double c_stateAckInterval = 0.25;
+const uint32_t c_stateAckCount = MaxStateBaselines / 4;
 
 	}
 
@@ -156,6 +159,7 @@ void ReplicatorProxy::setStateTemplate(const StateTemplate* stateTemplate)
 	// Old states must be immediately discarded; we cannot keep
 	// states produced from old template.
 	resetStates();
+	resetBaselines();
 }
 
 const StateTemplate* ReplicatorProxy::getStateTemplate() const
@@ -266,7 +270,7 @@ int32_t ReplicatorProxy::updateTxEventQueue()
 	{
 		if (txEvent.count <= 0)
 		{
-			m_replicator->m_topology->send(m_handle, &txEvent.msg, RmiEvent_NetSize(txEvent.size));
+			send(&txEvent.msg, RmiEvent_NetSize(txEvent.size));
 			txEvent.time = m_replicator->m_time0;
 			txEvent.count = 1;
 		}
@@ -279,7 +283,7 @@ int32_t ReplicatorProxy::updateTxEventQueue()
 		{
 			T_DEBUG(L"No ack received, resending event " << int32_t(i->msg.event.sequence) << L"...");
 
-			m_replicator->m_topology->send(m_handle, &i->msg, RmiEvent_NetSize(i->size));
+			send(&i->msg, RmiEvent_NetSize(i->size));
 
 			i->time = m_replicator->m_time0;
 			i->count++;
@@ -433,7 +437,142 @@ void ReplicatorProxy::updateLatency(double localTime, double remoteTime, double
 	m_latencyReverseStandardDeviation = latencyReverseSpread;
 }
 
-bool ReplicatorProxy::receivedState(double localTime, double stateTime, const void* stateData, uint32_t stateDataSize)
+bool ReplicatorProxy::send(const RMessage* msg, int32_t size)
+{
+	if (!m_replicator->m_topology->send(m_handle, msg, size))
+		return false;
+
+	m_txBytes += size;
+	m_txBytesWindow += size;
+	return true;
+}
+
+void ReplicatorProxy::received(int32_t size)
+{
+	m_rxBytes += size;
+	m_rxBytesWindow += size;
+}
+
+void ReplicatorProxy::updateBandwidth(double dT)
+{
+	if ((m_bandwidthTime += dT) < c_bandwidthInterval)
+		return;
+
+	const double txBps = (m_txBytesWindow * 8.0) / m_bandwidthTime;
+	const double rxBps = (m_rxBytesWindow * 8.0) / m_bandwidthTime;
+
+	m_txBps = (m_txBps > 0.0) ? (m_txBps * 0.5 + txBps * 0.5) : txBps;
+	m_rxBps = (m_rxBps > 0.0) ? (m_rxBps * 0.5 + rxBps * 0.5) : rxBps;
+
+	m_txBytesWindow = 0;
+	m_rxBytesWindow = 0;
+	m_bandwidthTime = 0.0;
+}
+
+uint32_t ReplicatorProxy::sendState(const StateTemplate* stateTemplate, const State* state)
+{
+	RMessage msg;
+	msg.time = time2net(m_replicator->m_time);
+
+	const uint8_t sequence = m_txStateSequence;
+	int32_t netSize = 0;
+	bool delta = false;
+
+	// Pack as delta against last acknowledged state, as long as
+	// baseline is still within the receiver's window.
+	if (m_txBaseline.state && uint8_t(sequence - m_txBaseline.sequence) < MaxStateBaselines)
+	{
+		msg.id = RmiStateDelta;
+		msg.stateDelta.sequence = sequence;
+		msg.stateDelta.baseline = m_txBaseline.sequence;
+
+		const uint32_t stateDataSize = stateTemplate->packDelta(
+			m_txBaseline.state,
+			state,
+			msg.stateDelta.data,
+			RmiStateDelta_MaxStateSize()
+		);
+		if (stateDataSize > 0)
+		{
+			netSize = RmiStateDelta_NetSize(stateDataSize);
+			delta = true;
+		}
+	}
+	else
+		m_txBaseline.state = nullptr;
+
+	if (netSize <= 0)
+	{
+		msg.id = RmiState;
+		msg.state.sequence = sequence;
+
+		const uint32_t stateDataSize = stateTemplate->pack(
+			state,
+			msg.state.data,
+			RmiState_MaxStateSize()
+		);
+		if (stateDataSize <= 0)
+			return 0;
+
+		netSize = RmiState_NetSize(stateDataSize);
+	}
+
+	// State which isn't sent must not become a baseline
+	// nor consume a sequence number.
+	if (!send(&msg, netSize))
+		return 0;
+
+	// Keep sent state until acknowledged, or window has passed.
+	StateBaseline& txState = m_txStates[sequence % MaxStateBaselines];
+	txState.sequence = sequence;
+	txState.state = state;
+
+	m_txStateSequence++;
+	m_txStateBytes += netSize;
+	m_txStateCount++;
+	if (delta)
+		m_txDeltaStateCount++;
+
+	return netSize;
+}
+
+void ReplicatorProxy::updateStateAcknowledge(double dT)
+{
+	// Acknowledge at least every few states so baseline is kept well within window.
+	m_timeUntilTxStateAck = std::max(m_timeUntilTxStateAck - dT, 0.0);
+	if (!m_rxStateAckPending || (m_timeUntilTxStateAck > 0.0 && m_rxStateAckCount < c_stateAckCount))
+		return;
+
+	RMessage ack;
+	ack.id = RmiStateAck;
+	ack.time = time2net(m_replicator->m_time);
+	ack.stateAck.sequence = m_rxStateAckSequence;
+	send(&ack, RmiStateAck_NetSize());
+
+	m_rxStateAckPending = false;
+	m_rxStateAckCount = 0;
+	m_timeUntilTxStateAck = c_stateAckInterval;
+}
+
+bool ReplicatorProxy::receivedStateAcknowledge(uint8_t sequence)
+{
+	// Ignore acknowledges of states which are outside of window.
+	if (uint8_t(m_txStateSequence - sequence) > MaxStateBaselines)
+		return false;
+
+	const StateBaseline& txState = m_txStates[sequence % MaxStateBaselines];
+	if (txState.sequence != sequence || !txState.state)
+		return false;
+
+	// Only move baseline forward; acknowledges might arrive out of order.
+	if (m_txBaseline.state && int8_t(sequence - m_txBaseline.sequence) <= 0)
+		return true;
+
+	m_txBaseline = txState;
+	return true;
+}
+
+bool ReplicatorProxy::receivedState(double localTime, double stateTime, uint8_t sequence, int32_t baseline, const void* stateData, uint32_t stateDataSize)
 {
 	if (!m_stateTemplate)
 	{
@@ -441,13 +580,40 @@ bool ReplicatorProxy::receivedState(double localTime, double stateTime, const vo
 		return false;
 	}
 
-	Ref< const State > state = m_stateTemplate->unpack(stateData, stateDataSize);
+	Ref< const State > state;
+	if (baseline >= 0)
+	{
+		// Baseline might be unknown if we've recently reset our baselines, sender
+		// will fall back to full states once baseline falls out of window.
+		const StateBaseline& rxBaseline = m_rxStates[baseline % MaxStateBaselines];
+		if (rxBaseline.sequence != baseline || !rxBaseline.state)
+			return false;
+
+		state = m_stateTemplate->unpackDelta(rxBaseline.state, stateData, stateDataSize);
+	}
+	else
+		state = m_stateTemplate->unpack(stateData, stateDataSize);
+
 	if (!state)
 	{
 		log::info << m_replicator->getLogPrefix() << L"Failed to unpack state (" << stateDataSize << L" byte(s)) from " << getLogIdentifier() << L"; state ignored." << Endl;
 		return false;
 	}
 
+	// Keep state as baseline for future deltas and acknowledge it to sender.
+	StateBaseline& rxState = m_rxStates[sequence % MaxStateBaselines];
+	rxState.sequence = sequence;
+	rxState.state = state;
+
+	// Acknowledges are throttled, only most recent state is acknowledged
+	// since sender only ever moves its baseline forward.
+	if (!m_rxStateAckPending || int8_t(sequence - m_rxStateAckSequence) > 0)
+	{
+		m_rxStateAckSequence = sequence;
+		m_rxStateAckPending = true;
+	}
+	m_rxStateAckCount++;
+
 	m_stateReceivedTime = localTime;
 
 	if (stateTime >= m_stateTime0)
@@ -492,6 +658,9 @@ void ReplicatorProxy::disconnect()
 	m_issueStateListeners = false;
 	m_timeUntilTxPing = 0.0;
 	m_timeUntilTxState = 0.0;
+	m_timeSinceTxState = 0.0;
+	m_interest = 0.0f;
+	m_criticalState = false;
 	m_latency = 0.0;
 	m_latencyStandardDeviation = 0.0;
 	m_latencyReverse = 0.0;
@@ -508,6 +677,20 @@ void ReplicatorProxy::disconnect()
 	}
 	m_rxEventsInOrderSequence = 0;
 	m_rxEvents.clear();
+
+	resetBaselines();
+}
+
+void ReplicatorProxy::resetBaselines()
+{
+	for (uint32_t i = 0; i < MaxStateBaselines; ++i)
+	{
+		m_txStates[i].state = nullptr;
+		m_rxStates[i].state = nullptr;
+	}
+	m_txBaseline.state = nullptr;
+	m_rxStateAckPending = false;
+	m_rxStateAckCount = 0;
 }
 
 std::wstring ReplicatorProxy::getLogIdentifier() const
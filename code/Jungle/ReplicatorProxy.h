@@ -152,6 +152,41 @@ public:
 	 */
 	void sendEvent(const ISerializable* eventObject, bool inOrder);
 
+	/*! Get interest of this proxy, as last scored by send scheduler.
+	 *
+	 * Interest grows with time since last state was sent
+	 * and is scaled by distance to our origin.
+	 */
+	float getInterest() const { return m_interest; }
+
+	/*! Get total number of bytes sent to this proxy.
+	 */
+	uint32_t getTxBytes() const { return m_txBytes; }
+
+	/*! Get total number of bytes received from this proxy.
+	 */
+	uint32_t getRxBytes() const { return m_rxBytes; }
+
+	/*! Get number of bytes of state messages sent to this proxy.
+	 */
+	uint32_t getTxStateBytes() const { return m_txStateBytes; }
+
+	/*! Get number of states sent to this proxy.
+	 */
+	uint32_t getTxStateCount() const { return m_txStateCount; }
+
+	/*! Get number of states sent to this proxy as delta against an acknowledged baseline.
+	 */
+	uint32_t getTxDeltaStateCount() const { return m_txDeltaStateCount; }
+
+	/*! Get measured send rate to this proxy in bits per second.
+	 */
+	float getTxBitsPerSecond() const { return float(m_txBps); }
+
+	/*! Get measured receive rate from this proxy in bits per second.
+	 */
+	float getRxBitsPerSecond() const { return float(m_rxBps); }
+
 private:
 	friend class Replicator;
 
@@ -170,6 +205,12 @@ private:
 		Ref< const ISerializable > eventObject;
 	};
 
+	struct StateBaseline
+	{
+		uint8_t sequence = 0;
+		Ref< const State > state;
+	};
+
 	Replicator* m_replicator;
 	net_handle_t m_handle;
 
@@ -201,6 +242,20 @@ private:
 
 	//@}
 
+	/*! \group State baselines. */
+	//@{
+
+	uint8_t m_txStateSequence = 0;
+	StateBaseline m_txStates[MaxStateBaselines];
+	StateBaseline m_txBaseline;
+	StateBaseline m_rxStates[MaxStateBaselines];
+	uint8_t m_rxStateAckSequence = 0;
+	bool m_rxStateAckPending = false;
+	uint32_t m_rxStateAckCount = 0;
+	double m_timeUntilTxStateAck = 0.0;
+
+	//@}
+
 	/*! \group Event management. */
 	//@{
 
@@ -220,6 +275,9 @@ private:
 
 	double m_timeUntilTxPing;
 	double m_timeUntilTxState;
+	double m_timeSinceTxState = 0.0;
+	float m_interest = 0.0f;
+	bool m_criticalState = false;
 	CircularVector< std::pair< double, double >, 33 > m_remoteTimes;
 	CircularVector< double, 33 > m_roundTrips;
 	double m_timeRate;
@@ -230,6 +288,28 @@ private:
 	
 	// @}
 
+	/*! \group Bandwidth accounting. */
+	//@{
+
+	uint32_t m_txBytes = 0;
+	uint32_t m_rxBytes = 0;
+	uint32_t m_txStateBytes = 0;
+	uint32_t m_txStateCount = 0;
+	uint32_t m_txDeltaStateCount = 0;
+	uint32_t m_txBytesWindow = 0;
+	uint32_t m_rxBytesWindow = 0;
+	double m_bandwidthTime = 0.0;
+	double m_txBps = 0.0;
+	double m_rxBps = 0.0;
+
+	//@}
+
+	bool send(const RMessage* msg, int32_t size);
+
+	void received(int32_t size);
+
+	void updateBandwidth(double dT);
+
 	int32_t updateTxEventQueue();
 
 	bool receivedTxEventAcknowledge(const ReplicatorProxy* from, uint8_t sequence, bool inOrder);
@@ -240,7 +320,15 @@ private:
 
 	void updateLatency(double localTime, double remoteTime, double roundTrip, double latencyReverse, double latencyReverseSpread);
 
-	bool receivedState(double localTime, double stateTime, const void* stateData, uint32_t stateDataSize);
+	uint32_t sendState(const StateTemplate* stateTemplate, const State* state);
+
+	void updateStateAcknowledge(double dT);
+
+	bool receivedStateAcknowledge(uint8_t sequence);
+
+	bool receivedState(double localTime, double stateTime, uint8_t sequence, int32_t baseline, const void* stateData, uint32_t stateDataSize);
+
+	void resetBaselines();
 
 	void disconnect();
 
@@ -6,11 +6,108 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstring>
+#include "Core/Io/BitReader.h"
+#include "Core/Io/BitWriter.h"
+#include "Core/Io/MemoryStream.h"
 #include "Jungle/State/IValueTemplate.h"
 
 namespace traktor::jungle
 {
+	namespace
+	{
+
+const int32_t c_smallDeltaBits = 8;
+const int32_t c_maxScratchSize = 64;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.jungle.IValueTemplate", IValueTemplate, Object)
 
+uint32_t IValueTemplate::getMaxPackedDeltaSize() const
+{
+	return 1 + getMaxPackedDataSize();
+}
+
+void IValueTemplate::packDelta(BitWriter& writer, const IValue* Vb, const IValue* V) const
+{
+	const uint32_t maxPackedSize = (getMaxPackedDataSize() + 7) / 8;
+	if (maxPackedSize <= c_maxScratchSize)
+	{
+		uint8_t scratch[2][c_maxScratchSize] = { 0 };
+		int64_t scratchSize[2];
+
+		for (int32_t i = 0; i < 2; ++i)
+		{
+			MemoryStream stream(scratch[i], c_maxScratchSize, false, true);
+			BitWriter scratchWriter(&stream);
+			pack(scratchWriter, i == 0 ? Vb : V);
+			scratchWriter.flush();
+			scratchSize[i] = stream.tell();
+		}
+
+		if (scratchSize[0] == scratchSize[1] && std::memcmp(scratch[0], scratch[1], scratchSize[0]) == 0)
+		{
+			writer.writeBit(false);
+			return;
+		}
+	}
+
+	writer.writeBit(true);
+	pack(writer, V);
+}
+
+Ref< const IValue > IValueTemplate::unpackDelta(BitReader& reader, const IValue* Vb) const
+{
+	if (!reader.readBit())
+		return Vb;
+	else
+		return unpack(reader);
+}
+
+void IValueTemplate::packDeltaInteger(BitWriter& writer, int32_t base, int32_t value, int32_t nbits, bool isSigned)
+{
+	const int32_t delta = value - base;
+	if (delta == 0)
+	{
+		writer.writeBit(false);
+		return;
+	}
+
+	writer.writeBit(true);
+
+	const int32_t smallLimit = 1 << (c_smallDeltaBits - 1);
+	if (delta >= -smallLimit && delta < smallLimit && nbits > c_smallDeltaBits)
+	{
+		writer.writeBit(true);
+		writer.writeSigned(c_smallDeltaBits, delta);
+	}
+	else
+	{
+		writer.writeBit(false);
+		if (isSigned)
+			writer.writeSigned(nbits, value);
+		else
+			writer.writeUnsigned(nbits, (uint32_t)value);
+	}
+}
+
+int32_t IValueTemplate::unpackDeltaInteger(BitReader& reader, int32_t base, int32_t nbits, bool isSigned)
+{
+	if (!reader.readBit())
+		return base;
+
+	if (reader.readBit())
+		return base + reader.readSigned(c_smallDeltaBits);
+	else if (isSigned)
+		return reader.readSigned(nbits);
+	else
+		return (int32_t)reader.readUnsigned(nbits);
+}
+
+uint32_t IValueTemplate::getMaxPackedDeltaIntegerSize(int32_t nbits)
+{
+	return 2 + nbits;
+}
+
 }
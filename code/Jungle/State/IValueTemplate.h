@@ -45,9 +45,44 @@ public:
 
 	virtual Ref< const IValue > unpack(BitReader& reader) const = 0;
 
+	/*! Get maximum number of bits of a delta packed value. */
+	virtual uint32_t getMaxPackedDeltaSize() const;
+
+	/*! Pack value as delta against a baseline value.
+	 *
+	 * Default implementation writes a single bit if quantized
+	 * value is equal to quantized baseline, else the entire value.
+	 *
+	 * \param writer Bit writer.
+	 * \param Vb Baseline value, same baseline must be known by receiver.
+	 * \param V Value to pack.
+	 */
+	virtual void packDelta(BitWriter& writer, const IValue* Vb, const IValue* V) const;
+
+	/*! Unpack value from delta against a baseline value.
+	 *
+	 * \param reader Bit reader.
+	 * \param Vb Baseline value, as unpacked by receiver.
+	 * \return Unpacked value.
+	 */
+	virtual Ref< const IValue > unpackDelta(BitReader& reader, const IValue* Vb) const;
+
 	virtual Ref< const IValue > extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const = 0;
 
 	virtual bool threshold(const IValue* Vn1, const IValue* V) const = 0;
+
+protected:
+	/*! Pack quantized integer as delta against quantized baseline.
+	 *
+	 * Unchanged integers are packed as a single bit, small
+	 * changes as a short signed delta.
+	 */
+	static void packDeltaInteger(BitWriter& writer, int32_t base, int32_t value, int32_t nbits, bool isSigned);
+
+	static int32_t unpackDeltaInteger(BitReader& reader, int32_t base, int32_t nbits, bool isSigned);
+
+	/*! Maximum number of bits of a delta packed integer. */
+	static uint32_t getMaxPackedDeltaIntegerSize(int32_t nbits);
 };
 
 }
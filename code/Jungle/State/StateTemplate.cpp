@@ -216,58 +216,103 @@ uint32_t StateTemplate::pack(const State* S, void* buffer, uint32_t bufferSize)
 {
 	T_FATAL_ASSERT (S);
 
-	// Number of values of state must match template.
-	const RefArray< const IValue >& V = S->getValues();
-	if (V.size() != m_valueTemplates.size())
+	uint32_t maxPackedSize = 0;
+	if (!checkValues(S, false, maxPackedSize))
+		return 0;
+
+	// Ensure all values fit within output buffer.
+	if ((maxPackedSize + 7) / 8 > bufferSize)
 	{
-		log::error << L"State values mismatch template definition." << Endl;
+		log::error << L"Not enough size in packed buffer to pack all values; state discarded." << Endl;
 		return 0;
 	}
 
-	// Ensure all values have correct type.
-	uint32_t maxPackedSize = 0;
+	// Pack all values into buffer.
+	MemoryStream stream(buffer, bufferSize, false, true);
+	BitWriter writer(&stream);
+
+	const RefArray< const IValue >& V = S->getValues();
 	for (uint32_t i = 0; i < m_valueTemplates.size(); ++i)
 	{
 		const IValueTemplate* valueTemplate = m_valueTemplates[i];
 		T_ASSERT(valueTemplate);
 
-		const TypeInfo& valueType = valueTemplate->getValueType();
-		if (!is_type_a(valueType, type_of(V[i])))
-		{
-			log::error << L"Value types mismatch template definition" << Endl;
-			log::error << L"\tDefinition \"" << valueType.getName() << L"\"" << Endl;
-			log::error << L"\tV \"" << type_of(V[i]).getName() << L"\"" << Endl;
-			return 0;
-		}
+		valueTemplate->pack(writer, V[i]);
+	}
+
+	writer.flush();
+	return stream.tell();
+}
+
+Ref< const State > StateTemplate::unpack(const void* buffer, uint32_t bufferSize) const
+{
+	MemoryStream stream(buffer, bufferSize);
+	BitReader reader(&stream);
+
+	RefArray< const IValue > V(m_valueTemplates.size());
+	for (uint32_t i = 0; i < m_valueTemplates.size(); ++i)
+	{
+		const IValueTemplate* valueTemplate = m_valueTemplates[i];
+		T_ASSERT(valueTemplate);
 
-		maxPackedSize += valueTemplate->getMaxPackedDataSize();
+		if ((V[i] = valueTemplate->unpack(reader)) == 0)
+			return 0;
 	}
 
-	// Ensure all values fit within output buffer.
-	if ((maxPackedSize + 7) / 8 > bufferSize)
+	// Must have read all data from buffer.
+	if (stream.available() > 0)
 	{
-		log::error << L"Not enough size in packed buffer to pack all values; state discarded." << Endl;
+		log::error << L"Not all state data has been unpacked; entire state discarded." << Endl;
 		return 0;
 	}
 
-	// Pack all values into buffer.
+	return new State(V);
+}
+
+uint32_t StateTemplate::packDelta(const State* Sb, const State* S, void* buffer, uint32_t bufferSize) const
+{
+	T_FATAL_ASSERT (Sb);
+	T_FATAL_ASSERT (S);
+
+	uint32_t maxPackedSize = 0;
+	if (!checkValues(Sb, true, maxPackedSize) || !checkValues(S, true, maxPackedSize))
+		return 0;
+
+	// Worst case delta might not fit even if full state does; not an
+	// error since caller is expected to fall back to full state.
+	if ((maxPackedSize + 7) / 8 > bufferSize)
+		return 0;
+
+	// Pack all values, as delta to baseline, into buffer.
 	MemoryStream stream(buffer, bufferSize, false, true);
 	BitWriter writer(&stream);
 
+	const RefArray< const IValue >& Vb = Sb->getValues();
+	const RefArray< const IValue >& V = S->getValues();
 	for (uint32_t i = 0; i < m_valueTemplates.size(); ++i)
 	{
 		const IValueTemplate* valueTemplate = m_valueTemplates[i];
 		T_ASSERT(valueTemplate);
 
-		valueTemplate->pack(writer, V[i]);
+		valueTemplate->packDelta(writer, Vb[i], V[i]);
 	}
 
 	writer.flush();
 	return stream.tell();
 }
 
-Ref< const State > StateTemplate::unpack(const void* buffer, uint32_t bufferSize) const
+Ref< const State > StateTemplate::unpackDelta(const State* Sb, const void* buffer, uint32_t bufferSize) const
 {
+	if (!Sb)
+		return 0;
+
+	const RefArray< const IValue >& Vb = Sb->getValues();
+	if (Vb.size() != m_valueTemplates.size())
+	{
+		log::error << L"Baseline state values mismatch template definition; delta state discarded." << Endl;
+		return 0;
+	}
+
 	MemoryStream stream(buffer, bufferSize);
 	BitReader reader(&stream);
 
@@ -277,18 +322,50 @@ Ref< const State > StateTemplate::unpack(const void* buffer, uint32_t bufferSize
 		const IValueTemplate* valueTemplate = m_valueTemplates[i];
 		T_ASSERT(valueTemplate);
 
-		if ((V[i] = valueTemplate->unpack(reader)) == 0)
+		if ((V[i] = valueTemplate->unpackDelta(reader, Vb[i])) == 0)
 			return 0;
 	}
 
 	// Must have read all data from buffer.
 	if (stream.available() > 0)
 	{
-		log::error << L"Not all state data has been unpacked; entire state discarded." << Endl;
+		log::error << L"Not all delta state data has been unpacked; entire state discarded." << Endl;
 		return 0;
 	}
 
 	return new State(V);
 }
 
+bool StateTemplate::checkValues(const State* S, bool delta, uint32_t& outMaxPackedSize) const
+{
+	// Number of values of state must match template.
+	const RefArray< const IValue >& V = S->getValues();
+	if (V.size() != m_valueTemplates.size())
+	{
+		log::error << L"State values mismatch template definition." << Endl;
+		return false;
+	}
+
+	// Ensure all values have correct type.
+	outMaxPackedSize = 0;
+	for (uint32_t i = 0; i < m_valueTemplates.size(); ++i)
+	{
+		const IValueTemplate* valueTemplate = m_valueTemplates[i];
+		T_ASSERT(valueTemplate);
+
+		const TypeInfo& valueType = valueTemplate->getValueType();
+		if (!is_type_a(valueType, type_of(V[i])))
+		{
+			log::error << L"Value types mismatch template definition" << Endl;
+			log::error << L"\tDefinition \"" << valueType.getName() << L"\"" << Endl;
+			log::error << L"\tV \"" << type_of(V[i]).getName() << L"\"" << Endl;
+			return false;
+		}
+
+		outMaxPackedSize += delta ? valueTemplate->getMaxPackedDeltaSize() : valueTemplate->getMaxPackedDataSize();
+	}
+
+	return true;
+}
+
 }
@@ -34,8 +34,29 @@ public:
 
 	Ref< const State > unpack(const void* buffer, uint32_t bufferSize) const;
 
+	/*! Pack state as delta against a baseline state.
+	 *
+	 * \param Sb Baseline state, must be known by receiver.
+	 * \param S State to pack.
+	 * \param buffer Output buffer.
+	 * \param bufferSize Size of output buffer in bytes.
+	 * \return Number of bytes packed, 0 if failed or delta might not fit in buffer.
+	 */
+	uint32_t packDelta(const State* Sb, const State* S, void* buffer, uint32_t bufferSize) const;
+
+	/*! Unpack state from delta against a baseline state.
+	 *
+	 * \param Sb Baseline state, as unpacked by receiver.
+	 * \param buffer Packed delta.
+	 * \param bufferSize Size of packed delta in bytes.
+	 * \return Unpacked state, null if failed.
+	 */
+	Ref< const State > unpackDelta(const State* Sb, const void* buffer, uint32_t bufferSize) const;
+
 private:
 	RefArray< const IValueTemplate > m_valueTemplates;
+
+	bool checkValues(const State* S, bool delta, uint32_t& outMaxPackedSize) const;
 };
 
 }
@@ -61,6 +61,10 @@ private:
 	int32_t m_v;
 };
 
+const int32_t c_fixedPointBits = 13 + 11;
+const int32_t c_axisBits = 16;
+const int32_t c_angleBits = 4 + 11;
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.jungle.TransformTemplate", TransformTemplate, IValueTemplate)
@@ -70,6 +74,15 @@ TransformTemplate::TransformTemplate(const std::wstring& tag)
 {
 }
 
+TransformTemplate::TransformTemplate(const std::wstring& tag, float min, float max, int32_t nbits)
+:	m_tag(tag)
+,	m_min(min)
+,	m_max(max)
+,	m_nbits(clamp(nbits, 1, 20))
+{
+	T_ASSERT(m_min < m_max);
+}
+
 const TypeInfo& TransformTemplate::getValueType() const
 {
 	return type_of< TransformValue >();
@@ -77,53 +90,114 @@ const TypeInfo& TransformTemplate::getValueType() const
 
 uint32_t TransformTemplate::getMaxPackedDataSize() const
 {
-	return 3 * (13 + 11) + 16 + (4 + 11);
+	return 3 * getTranslationBits() + c_axisBits + c_angleBits;
 }
 
 void TransformTemplate::pack(BitWriter& writer, const IValue* V) const
 {
-	const Transform v = *mandatory_non_null_type_cast< const TransformValue* >(V);
-	float T_MATH_ALIGN16 e[4];
+	Quantized q;
+	quantize(V, q);
 
-	// 3 * (13+11)
-	v.translation().storeAligned(e);
 	for (uint32_t i = 0; i < 3; ++i)
-		writer.writeSigned(13 + 11, GenericFixedPoint< 13, 11 >(e[i]).raw());
-
-	// 16 + (4+11)
-	Vector4 R = v.rotation().toAxisAngle();
-	const Scalar a = R.length();
-	if (abs(a) > FUZZY_EPSILON)
-		R /= a;
+	{
+		if (m_nbits > 0)
+			writer.writeUnsigned(m_nbits, (uint32_t)q.translation[i]);
+		else
+			writer.writeSigned(c_fixedPointBits, q.translation[i]);
+	}
 
-	writer.writeUnsigned(16, PackedUnitVector(R).raw());
-	writer.writeSigned(4 + 11, GenericFixedPoint< 4, 11 >(a).raw());
+	writer.writeUnsigned(c_axisBits, q.axis);
+	writer.writeSigned(c_angleBits, q.angle);
 }
 
 Ref< const IValue > TransformTemplate::unpack(BitReader& reader) const
 {
-	float T_MATH_ALIGN16 f[4];
-	uint16_t u;
+	Quantized q;
 
 	for (uint32_t i = 0; i < 3; ++i)
 	{
-		f[i] = GenericFixedPoint< 13, 11 >(reader.readSigned(13 + 11));
-		T_ASSERT(!isNanOrInfinite(f[i]));
+		if (m_nbits > 0)
+			q.translation[i] = (int32_t)reader.readUnsigned(m_nbits);
+		else
+			q.translation[i] = reader.readSigned(c_fixedPointBits);
 	}
-	f[3] = 1.0f;
 
-	u = reader.readUnsigned(16);
-	const Vector4 R = PackedUnitVector(u).unpack();
-	const float Ra = GenericFixedPoint< 4, 11 >(reader.readSigned(4 + 11));
+	q.axis = reader.readUnsigned(c_axisBits);
+	q.angle = reader.readSigned(c_angleBits);
 
-	Transform v(
-		Vector4::loadAligned(f),
-		(abs(Ra) > FUZZY_EPSILON && R.length() > FUZZY_EPSILON) ?
-			Quaternion::fromAxisAngle(R, Ra).normalized() :
-			Quaternion::identity()
-	);
+	return new TransformValue(Transform(
+		dequantizeTranslation(q),
+		dequantizeRotation(q)
+	));
+}
+
+uint32_t TransformTemplate::getMaxPackedDeltaSize() const
+{
+	return 1 + 3 * getMaxPackedDeltaIntegerSize(getTranslationBits()) + 1 + c_axisBits + c_angleBits;
+}
+
+void TransformTemplate::packDelta(BitWriter& writer, const IValue* Vb, const IValue* V) const
+{
+	Quantized qb, q;
+	quantize(Vb, qb);
+	quantize(V, q);
+
+	const bool rotationChanged = (qb.axis != q.axis || qb.angle != q.angle);
+	if (
+		!rotationChanged &&
+		qb.translation[0] == q.translation[0] &&
+		qb.translation[1] == q.translation[1] &&
+		qb.translation[2] == q.translation[2]
+	)
+	{
+		writer.writeBit(false);
+		return;
+	}
+
+	writer.writeBit(true);
+
+	for (uint32_t i = 0; i < 3; ++i)
+		packDeltaInteger(writer, qb.translation[i], q.translation[i], getTranslationBits(), m_nbits <= 0);
+
+	// Rotation is either unchanged or sent in full.
+	writer.writeBit(rotationChanged);
+	if (rotationChanged)
+	{
+		writer.writeUnsigned(c_axisBits, q.axis);
+		writer.writeSigned(c_angleBits, q.angle);
+	}
+}
+
+Ref< const IValue > TransformTemplate::unpackDelta(BitReader& reader, const IValue* Vb) const
+{
+	if (!reader.readBit())
+		return Vb;
+
+	Quantized qb, q;
+	quantize(Vb, qb);
+
+	for (uint32_t i = 0; i < 3; ++i)
+		q.translation[i] = unpackDeltaInteger(reader, qb.translation[i], getTranslationBits(), m_nbits <= 0);
+
+	// Unchanged rotation is copied from baseline to prevent
+	// precision loss from being quantized once more.
+	Quaternion rotation;
+	if (reader.readBit())
+	{
+		q.axis = reader.readUnsigned(c_axisBits);
+		q.angle = reader.readSigned(c_angleBits);
+		rotation = dequantizeRotation(q);
+	}
+	else
+	{
+		const Transform vb = *mandatory_non_null_type_cast< const TransformValue* >(Vb);
+		rotation = vb.rotation();
+	}
 
-	return new TransformValue(v);
+	return new TransformValue(Transform(
+		dequantizeTranslation(q),
+		rotation
+	));
 }
 
 Ref< const IValue > TransformTemplate::extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const
@@ -163,4 +237,69 @@ bool TransformTemplate::threshold(const IValue* Vn1, const IValue* V) const
 	return false;
 }
 
+int32_t TransformTemplate::getTranslationBits() const
+{
+	return m_nbits > 0 ? m_nbits : c_fixedPointBits;
+}
+
+void TransformTemplate::quantize(const IValue* V, Quantized& outQ) const
+{
+	const Transform v = *mandatory_non_null_type_cast< const TransformValue* >(V);
+
+	float T_MATH_ALIGN16 e[4];
+	v.translation().storeAligned(e);
+
+	if (m_nbits > 0)
+	{
+		const float steps = float((1 << m_nbits) - 1);
+		for (uint32_t i = 0; i < 3; ++i)
+			outQ.translation[i] = int32_t(clamp((e[i] - m_min) / (m_max - m_min), 0.0f, 1.0f) * steps + 0.5f);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < 3; ++i)
+			outQ.translation[i] = GenericFixedPoint< 13, 11 >(e[i]).raw();
+	}
+
+	Vector4 R = v.rotation().toAxisAngle();
+	const Scalar a = R.length();
+	if (abs(a) > FUZZY_EPSILON)
+		R /= a;
+
+	outQ.axis = PackedUnitVector(R).raw();
+	outQ.angle = GenericFixedPoint< 4, 11 >(a).raw();
+}
+
+Vector4 TransformTemplate::dequantizeTranslation(const Quantized& q) const
+{
+	float T_MATH_ALIGN16 f[4];
+
+	if (m_nbits > 0)
+	{
+		const float steps = float((1 << m_nbits) - 1);
+		for (uint32_t i = 0; i < 3; ++i)
+			f[i] = (q.translation[i] / steps) * (m_max - m_min) + m_min;
+	}
+	else
+	{
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			f[i] = GenericFixedPoint< 13, 11 >(q.translation[i]);
+			T_ASSERT(!isNanOrInfinite(f[i]));
+		}
+	}
+	f[3] = 1.0f;
+
+	return Vector4::loadAligned(f);
+}
+
+Quaternion TransformTemplate::dequantizeRotation(const Quantized& q) const
+{
+	const Vector4 R = PackedUnitVector((uint16_t)q.axis).unpack();
+	const float Ra = GenericFixedPoint< 4, 11 >(q.angle);
+	return (abs(Ra) > FUZZY_EPSILON && R.length() > FUZZY_EPSILON) ?
+		Quaternion::fromAxisAngle(R, Ra).normalized() :
+		Quaternion::identity();
+}
+
 }
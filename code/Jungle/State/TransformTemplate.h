@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include "Core/Math/Transform.h"
 #include "Jungle/State/IValueTemplate.h"
 
 // import/export mechanism.
@@ -29,6 +30,15 @@ class T_DLLCLASS TransformTemplate : public IValueTemplate
 public:
 	explicit TransformTemplate(const std::wstring& tag);
 
+	/*! Transform template with quantized translation.
+	 *
+	 * \param tag Value tag.
+	 * \param min Minimum value of each translation component.
+	 * \param max Maximum value of each translation component.
+	 * \param nbits Number of bits of each quantized translation component, 1 to 20.
+	 */
+	explicit TransformTemplate(const std::wstring& tag, float min, float max, int32_t nbits);
+
 	virtual const TypeInfo& getValueType() const override final;
 
 	virtual uint32_t getMaxPackedDataSize() const override final;
@@ -37,12 +47,36 @@ public:
 
 	virtual Ref< const IValue > unpack(BitReader& reader) const override final;
 
+	virtual uint32_t getMaxPackedDeltaSize() const override final;
+
+	virtual void packDelta(BitWriter& writer, const IValue* Vb, const IValue* V) const override final;
+
+	virtual Ref< const IValue > unpackDelta(BitReader& reader, const IValue* Vb) const override final;
+
 	virtual Ref< const IValue > extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const override final;
 
 	virtual bool threshold(const IValue* Vn1, const IValue* V) const override final;
 
 private:
+	struct Quantized
+	{
+		int32_t translation[3];
+		uint32_t axis;
+		int32_t angle;
+	};
+
 	std::wstring m_tag;
+	float m_min = 0.0f;
+	float m_max = 0.0f;
+	int32_t m_nbits = 0;
+
+	int32_t getTranslationBits() const;
+
+	void quantize(const IValue* V, Quantized& outQ) const;
+
+	Vector4 dequantizeTranslation(const Quantized& q) const;
+
+	Quaternion dequantizeRotation(const Quantized& q) const;
 };
 
 }
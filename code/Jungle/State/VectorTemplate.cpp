@@ -61,6 +61,10 @@ private:
 	int32_t m_v;
 };
 
+typedef GenericFixedPoint< 13, 11 > fixed_point_t;
+
+const int32_t c_fixedPointBits = 13 + 11;
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.jungle.VectorTemplate", VectorTemplate, IValueTemplate)
@@ -70,6 +74,15 @@ VectorTemplate::VectorTemplate(const std::wstring& tag)
 {
 }
 
+VectorTemplate::VectorTemplate(const std::wstring& tag, float min, float max, int32_t nbits)
+:	m_tag(tag)
+,	m_min(min)
+,	m_max(max)
+,	m_nbits(clamp(nbits, 1, 20))
+{
+	T_ASSERT(m_min < m_max);
+}
+
 const TypeInfo& VectorTemplate::getValueType() const
 {
 	return type_of< VectorValue >();
@@ -77,29 +90,70 @@ const TypeInfo& VectorTemplate::getValueType() const
 
 uint32_t VectorTemplate::getMaxPackedDataSize() const
 {
-	return 4 * (13+11);
+	return 4 * getComponentBits();
 }
 
 void VectorTemplate::pack(BitWriter& writer, const IValue* V) const
 {
-	const Vector4 v = *mandatory_non_null_type_cast< const VectorValue* >(V);
-	float T_MATH_ALIGN16 e[4];
+	int32_t q[4];
+	quantize(V, q);
 
-	// 4 * (13+11)
-	v.storeAligned(e);
 	for (uint32_t i = 0; i < 4; ++i)
-		writer.writeSigned(13+11, GenericFixedPoint< 13, 11 >(e[i]).raw());
+	{
+		if (m_nbits > 0)
+			writer.writeUnsigned(m_nbits, (uint32_t)q[i]);
+		else
+			writer.writeSigned(c_fixedPointBits, q[i]);
+	}
 }
 
 Ref< const IValue > VectorTemplate::unpack(BitReader& reader) const
 {
-	float T_MATH_ALIGN16 f[4];
+	int32_t q[4];
 	for (uint32_t i = 0; i < 4; ++i)
 	{
-		f[i] = GenericFixedPoint< 13, 11 >(reader.readSigned(13+11));
-		T_ASSERT(!isNanOrInfinite(f[i]));
+		if (m_nbits > 0)
+			q[i] = (int32_t)reader.readUnsigned(m_nbits);
+		else
+			q[i] = reader.readSigned(c_fixedPointBits);
 	}
-	return new VectorValue(Vector4::loadAligned(f));
+	return dequantize(q);
+}
+
+uint32_t VectorTemplate::getMaxPackedDeltaSize() const
+{
+	return 1 + 4 * getMaxPackedDeltaIntegerSize(getComponentBits());
+}
+
+void VectorTemplate::packDelta(BitWriter& writer, const IValue* Vb, const IValue* V) const
+{
+	int32_t qb[4], q[4];
+	quantize(Vb, qb);
+	quantize(V, q);
+
+	if (qb[0] == q[0] && qb[1] == q[1] && qb[2] == q[2] && qb[3] == q[3])
+	{
+		writer.writeBit(false);
+		return;
+	}
+
+	writer.writeBit(true);
+	for (uint32_t i = 0; i < 4; ++i)
+		packDeltaInteger(writer, qb[i], q[i], getComponentBits(), m_nbits <= 0);
+}
+
+Ref< const IValue > VectorTemplate::unpackDelta(BitReader& reader, const IValue* Vb) const
+{
+	if (!reader.readBit())
+		return Vb;
+
+	int32_t qb[4], q[4];
+	quantize(Vb, qb);
+
+	for (uint32_t i = 0; i < 4; ++i)
+		q[i] = unpackDeltaInteger(reader, qb[i], getComponentBits(), m_nbits <= 0);
+
+	return dequantize(q);
 }
 
 Ref< const IValue > VectorTemplate::extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const
@@ -139,4 +193,51 @@ bool VectorTemplate::threshold(const IValue* Vn1, const IValue* V) const
 	return false;
 }
 
+int32_t VectorTemplate::getComponentBits() const
+{
+	return m_nbits > 0 ? m_nbits : c_fixedPointBits;
+}
+
+void VectorTemplate::quantize(const IValue* V, int32_t outQ[4]) const
+{
+	const Vector4 v = *mandatory_non_null_type_cast< const VectorValue* >(V);
+
+	float T_MATH_ALIGN16 e[4];
+	v.storeAligned(e);
+
+	if (m_nbits > 0)
+	{
+		const float steps = float((1 << m_nbits) - 1);
+		for (uint32_t i = 0; i < 4; ++i)
+			outQ[i] = int32_t(clamp((e[i] - m_min) / (m_max - m_min), 0.0f, 1.0f) * steps + 0.5f);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < 4; ++i)
+			outQ[i] = fixed_point_t(e[i]).raw();
+	}
+}
+
+Ref< const IValue > VectorTemplate::dequantize(const int32_t q[4]) const
+{
+	float T_MATH_ALIGN16 f[4];
+
+	if (m_nbits > 0)
+	{
+		const float steps = float((1 << m_nbits) - 1);
+		for (uint32_t i = 0; i < 4; ++i)
+			f[i] = (q[i] / steps) * (m_max - m_min) + m_min;
+	}
+	else
+	{
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			f[i] = fixed_point_t(q[i]);
+			T_ASSERT(!isNanOrInfinite(f[i]));
+		}
+	}
+
+	return new VectorValue(Vector4::loadAligned(f));
+}
+
 }
@@ -29,6 +29,15 @@ class T_DLLCLASS VectorTemplate : public IValueTemplate
 public:
 	explicit VectorTemplate(const std::wstring& tag);
 
+	/*! Vector template with quantized components.
+	 *
+	 * \param tag Value tag.
+	 * \param min Minimum value of each component.
+	 * \param max Maximum value of each component.
+	 * \param nbits Number of bits of each quantized component, 1 to 20.
+	 */
+	explicit VectorTemplate(const std::wstring& tag, float min, float max, int32_t nbits);
+
 	virtual const TypeInfo& getValueType() const override final;
 
 	virtual uint32_t getMaxPackedDataSize() const override final;
@@ -37,12 +46,27 @@ public:
 
 	virtual Ref< const IValue > unpack(BitReader& reader) const override final;
 
+	virtual uint32_t getMaxPackedDeltaSize() const override final;
+
+	virtual void packDelta(BitWriter& writer, const IValue* Vb, const IValue* V) const override final;
+
+	virtual Ref< const IValue > unpackDelta(BitReader& reader, const IValue* Vb) const override final;
+
 	virtual Ref< const IValue > extrapolate(const IValue* Vn2, float Tn2, const IValue* Vn1, float Tn1, const IValue* V0, float T0, float T) const override final;
 
 	virtual bool threshold(const IValue* Vn1, const IValue* V) const override final;
 
 private:
 	std::wstring m_tag;
+	float m_min = 0.0f;
+	float m_max = 0.0f;
+	int32_t m_nbits = 0;
+
+	int32_t getComponentBits() const;
+
+	void quantize(const IValue* V, int32_t outQ[4]) const;
+
+	Ref< const IValue > dequantize(const int32_t q[4]) const;
 };
 
 }
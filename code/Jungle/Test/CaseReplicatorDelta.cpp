@@ -0,0 +1,212 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Core/Math/Random.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Jungle/MeasureP2PProvider.h"
+#include "Jungle/Replicator.h"
+#include "Jungle/ReplicatorProxy.h"
+#include "Jungle/ReplicatorTypes.h"
+#include "Jungle/State/BooleanTemplate.h"
+#include "Jungle/State/BooleanValue.h"
+#include "Jungle/State/FloatTemplate.h"
+#include "Jungle/State/FloatValue.h"
+#include "Jungle/State/State.h"
+#include "Jungle/State/StateTemplate.h"
+#include "Jungle/State/TransformTemplate.h"
+#include "Jungle/State/TransformValue.h"
+#include "Jungle/State/VectorTemplate.h"
+#include "Jungle/State/VectorValue.h"
+#include "Jungle/Test/CaseReplicatorDelta.h"
+#include "Jungle/Test/LoopbackTopology.h"
+
+namespace traktor::jungle::test
+{
+	namespace
+	{
+
+Ref< StateTemplate > createStateTemplate()
+{
+	Ref< StateTemplate > stateTemplate = new StateTemplate();
+	stateTemplate->declare(new TransformTemplate(L"transform"));
+	stateTemplate->declare(new VectorTemplate(L"velocity", -16.0f, 16.0f, 12));
+	stateTemplate->declare(new FloatTemplate(L"health", 1.0f, 0.0f, 100.0f, Ftp8, false));
+	stateTemplate->declare(new BooleanTemplate(L"crouch", 0.5f));
+	return stateTemplate;
+}
+
+/*! Simulated player; moving only part of the time as most players in a session are idle or slow. */
+Ref< const State > simulate(Random& random, Vector4& position, float& health, bool& crouch)
+{
+	Vector4 velocity = Vector4::zero();
+	if (random.nextFloat() < 0.25f)
+	{
+		velocity = Vector4(random.nextFloat() * 8.0f - 4.0f, 0.0f, random.nextFloat() * 8.0f - 4.0f, 0.0f);
+		position += velocity * Scalar(1.0f / 30.0f);
+	}
+	if (random.nextFloat() < 0.02f)
+		health = clamp(health - random.nextFloat() * 10.0f, 0.0f, 100.0f);
+	if (random.nextFloat() < 0.01f)
+		crouch = !crouch;
+
+	Ref< State > state = new State();
+	state->pack< TransformValue >(Transform(position.xyz1(), Quaternion::fromEulerAngles(position.x(), 0.0f, 0.0f)));
+	state->pack< VectorValue >(velocity);
+	state->pack< FloatValue >(health);
+	state->pack< BooleanValue >(crouch);
+	return state;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.jungle.test.CaseReplicatorDelta", 0, CaseReplicatorDelta, traktor::test::Case)
+
+void CaseReplicatorDelta::run()
+{
+	Ref< StateTemplate > stateTemplate = createStateTemplate();
+
+	// Delta unpacked state must be identical to fully unpacked state.
+	{
+		Random random;
+		Vector4 position = Vector4::zero();
+		float health = 100.0f;
+		bool crouch = false;
+
+		Ref< const State > senderBaseline = simulate(random, position, health, crouch);
+
+		uint8_t buffer[1024];
+		uint32_t size = stateTemplate->pack(senderBaseline, buffer, sizeof(buffer));
+		Ref< const State > receiverBaseline = stateTemplate->unpack(buffer, size);
+		CASE_ASSERT(receiverBaseline != nullptr);
+
+		uint32_t fullBytes = 0;
+		uint32_t deltaBytes = 0;
+		uint32_t mismatches = 0;
+
+		for (int32_t i = 0; i < 1000; ++i)
+		{
+			Ref< const State > state = simulate(random, position, health, crouch);
+
+			const uint32_t fullSize = stateTemplate->pack(state, buffer, sizeof(buffer));
+			Ref< const State > fullState = stateTemplate->unpack(buffer, fullSize);
+
+			uint8_t deltaBuffer[1024];
+			const uint32_t deltaSize = stateTemplate->packDelta(senderBaseline, state, deltaBuffer, sizeof(deltaBuffer));
+			Ref< const State > deltaState = stateTemplate->unpackDelta(receiverBaseline, deltaBuffer, deltaSize);
+
+			if (!fullState || !deltaState)
+			{
+				++mismatches;
+				continue;
+			}
+
+			// Compare quantized, packed, representation.
+			uint8_t repacked[2][1024];
+			const uint32_t repackedFullSize = stateTemplate->pack(fullState, repacked[0], sizeof(repacked[0]));
+			const uint32_t repackedDeltaSize = stateTemplate->pack(deltaState, repacked[1], sizeof(repacked[1]));
+			if (repackedFullSize != repackedDeltaSize || std::memcmp(repacked[0], repacked[1], repackedFullSize) != 0)
+				++mismatches;
+
+			fullBytes += fullSize;
+			deltaBytes += deltaSize;
+
+			// Baseline is acknowledged every fourth state.
+			if ((i & 3) == 3)
+			{
+				senderBaseline = state;
+				receiverBaseline = deltaState;
+			}
+		}
+
+		CASE_ASSERT_EQUAL(mismatches, 0);
+		CASE_ASSERT(deltaBytes < fullBytes);
+	}
+
+	// Replicate state between two peers over loopback network.
+	{
+		const AlignedVector< net_handle_t > handles = { 1, 2 };
+		Ref< LoopbackNetwork > network = new LoopbackNetwork();
+		Ref< MeasureP2PProvider > measure = new MeasureP2PProvider(new LoopbackProvider(network, 1, handles));
+
+		Replicator::Configuration configuration;
+		configuration.timeUntilTxStateNear = 0.0f;
+		configuration.timeUntilTxStateFar = 0.0f;
+
+		Ref< Replicator > sender = new Replicator();
+		sender->create(new LoopbackTopology(measure), configuration);
+		sender->setStateTemplate(stateTemplate);
+		sender->setSendState(true);
+
+		Ref< Replicator > receiver = new Replicator();
+		receiver->create(new LoopbackTopology(new LoopbackProvider(network, 2, handles)), configuration);
+
+		sender->update();
+		receiver->update();
+
+		CASE_ASSERT_EQUAL(sender->getProxyCount(), 1);
+		CASE_ASSERT_EQUAL(receiver->getProxyCount(), 1);
+		if (sender->getProxyCount() != 1 || receiver->getProxyCount() != 1)
+			return;
+
+		ReplicatorProxy* senderProxy = sender->getProxy(0);
+		senderProxy->setSendState(true);
+
+		ReplicatorProxy* receiverProxy = receiver->getProxy(0);
+		receiverProxy->setStateTemplate(stateTemplate);
+
+		Random random;
+		Vector4 position = Vector4::zero();
+		float health = 100.0f;
+		bool crouch = false;
+		Ref< const State > state;
+
+		Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+		for (int32_t i = 0; i < 200; ++i)
+		{
+			// Keep last states static so received state doesn't depend on extrapolation.
+			if (i < 190)
+				state = simulate(random, position, health, crouch);
+
+			sender->setState(state);
+			sender->update();
+			receiver->update();
+			currentThread->sleep(2);
+		}
+
+		CASE_ASSERT_EQUAL(senderProxy->getTxStateCount(), 200);
+		CASE_ASSERT(senderProxy->getTxDeltaStateCount() > 150);
+		CASE_ASSERT(senderProxy->getTxBytes() <= measure->getSentBytes());
+		CASE_ASSERT_EQUAL(receiverProxy->getRxBytes(), measure->getSentBytes());
+
+		// Acknowledges are throttled thus receiver mustn't acknowledge each state.
+		CASE_ASSERT(receiverProxy->getTxBytes() < 200 * RmiStateAck_NetSize() / 4);
+
+		// Received state must be equal to quantized last sent state.
+		Ref< const State > received = receiverProxy->getState(receiver->getTime(), 1.0);
+		CASE_ASSERT(received != nullptr);
+		if (received)
+		{
+			uint8_t expected[1024], actual[1024];
+			const uint32_t expectedSize = stateTemplate->pack(state, expected, sizeof(expected));
+			const uint32_t actualSize = stateTemplate->pack(received, actual, sizeof(actual));
+			CASE_ASSERT_EQUAL(expectedSize, actualSize);
+			CASE_ASSERT(std::memcmp(expected, actual, expectedSize) == 0);
+		}
+
+		uint8_t buffer[1024];
+		const uint32_t fullStateBytes = senderProxy->getTxStateCount() * RmiState_NetSize(stateTemplate->pack(state, buffer, sizeof(buffer)));
+		CASE_ASSERT(senderProxy->getTxStateBytes() < fullStateBytes);
+
+		receiver->destroy();
+		sender->destroy();
+	}
+}
+
+}
@@ -0,0 +1,205 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Math/Random.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Jungle/Replicator.h"
+#include "Jungle/ReplicatorProxy.h"
+#include "Jungle/State/State.h"
+#include "Jungle/State/StateTemplate.h"
+#include "Jungle/State/TransformTemplate.h"
+#include "Jungle/State/TransformValue.h"
+#include "Jungle/Test/CaseReplicatorInterest.h"
+#include "Jungle/Test/LoopbackTopology.h"
+
+namespace traktor::jungle::test
+{
+	namespace
+	{
+
+const int32_t c_receiverCount = 16;
+
+struct Result
+{
+	double duration = 0.0;
+	uint32_t stateBytes = 0;
+	uint32_t stateCounts[c_receiverCount] = { 0 };
+};
+
+/*! Replicate a moving state from one sender to receivers at increasing distances. */
+Result replicate(float txStateBandwidth, int32_t ticks)
+{
+	Ref< StateTemplate > stateTemplate = new StateTemplate();
+	stateTemplate->declare(new TransformTemplate(L"transform"));
+
+	AlignedVector< net_handle_t > handles;
+	for (int32_t i = 0; i <= c_receiverCount; ++i)
+		handles.push_back(net_handle_t(i + 1));
+
+	Ref< LoopbackNetwork > network = new LoopbackNetwork();
+
+	Replicator::Configuration configuration;
+	configuration.timeUntilTxStateNear = 0.0f;
+	configuration.timeUntilTxStateFar = 0.0f;
+	configuration.txStateBandwidth = txStateBandwidth;
+
+	RefArray< Replicator > replicators;
+	for (auto handle : handles)
+	{
+		Ref< Replicator > replicator = new Replicator();
+		replicator->create(new LoopbackTopology(new LoopbackProvider(network, handle, handles)), configuration);
+		replicators.push_back(replicator);
+	}
+
+	for (auto replicator : replicators)
+		replicator->update();
+
+	Replicator* sender = replicators[0];
+	sender->setStateTemplate(stateTemplate);
+	sender->setSendState(true);
+
+	// Place receivers at increasing distance from sender, from near to beyond furthest.
+	for (uint32_t i = 0; i < sender->getProxyCount(); ++i)
+	{
+		ReplicatorProxy* proxy = sender->getProxy(i);
+		const float distance = float(proxy->getHandle() - 2) * 10.0f;
+		proxy->setOrigin(Transform(Vector4(distance, 0.0f, 0.0f, 1.0f)));
+		proxy->setSendState(true);
+	}
+
+	for (int32_t i = 1; i < (int32_t)replicators.size(); ++i)
+	{
+		for (uint32_t j = 0; j < replicators[i]->getProxyCount(); ++j)
+			replicators[i]->getProxy(j)->setStateTemplate(stateTemplate);
+	}
+
+	Random random;
+	Vector4 position = Vector4::origo();
+	Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+	const double startTime = sender->getTime();
+
+	for (int32_t i = 0; i < ticks; ++i)
+	{
+		position += Vector4(random.nextFloat() - 0.5f, 0.0f, random.nextFloat() - 0.5f, 0.0f);
+
+		Ref< State > state = new State();
+		state->pack< TransformValue >(Transform(position));
+		sender->setState(state);
+
+		for (auto replicator : replicators)
+			replicator->update();
+
+		currentThread->sleep(5);
+	}
+
+	Result result;
+	result.duration = sender->getTime() - startTime;
+
+	for (uint32_t i = 0; i < sender->getProxyCount(); ++i)
+	{
+		const ReplicatorProxy* proxy = sender->getProxy(i);
+		result.stateBytes += proxy->getTxStateBytes();
+		result.stateCounts[proxy->getHandle() - 2] = proxy->getTxStateCount();
+	}
+
+	for (auto replicator : replicators)
+		replicator->destroy();
+
+	return result;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.jungle.test.CaseReplicatorInterest", 0, CaseReplicatorInterest, traktor::test::Case)
+
+void CaseReplicatorInterest::run()
+{
+	const float c_bandwidth = 4000.0f;
+
+	const Result unlimited = replicate(0.0f, 100);
+	const Result limited = replicate(c_bandwidth, 100);
+
+	// Without budget every proxy get a state each tick.
+	for (int32_t i = 0; i < c_receiverCount; ++i)
+		CASE_ASSERT_EQUAL(unlimited.stateCounts[i], 100);
+
+	// Bandwidth must be within budget, allow for a short burst and one state of overdraft.
+	const double limitedBps = limited.stateBytes / limited.duration;
+	CASE_ASSERT(limitedBps <= c_bandwidth * 1.1);
+	CASE_ASSERT(limited.stateBytes < unlimited.stateBytes);
+
+	// Near proxies must get more states than distant proxies, yet no proxy is starved.
+	CASE_ASSERT(limited.stateCounts[0] > limited.stateCounts[c_receiverCount - 1]);
+	for (int32_t i = 0; i < c_receiverCount; ++i)
+		CASE_ASSERT(limited.stateCounts[i] > 0);
+
+	// State which fails to send must not be counted; replication
+	// resumes with a full state once states can be sent again.
+	{
+		const AlignedVector< net_handle_t > handles = { 1, 2 };
+		Ref< LoopbackNetwork > network = new LoopbackNetwork();
+
+		Ref< StateTemplate > stateTemplate = new StateTemplate();
+		stateTemplate->declare(new TransformTemplate(L"transform"));
+
+		Replicator::Configuration configuration;
+		configuration.timeUntilTxStateNear = 0.0f;
+		configuration.timeUntilTxStateFar = 0.0f;
+		configuration.txStateBandwidth = c_bandwidth;
+
+		Ref< Replicator > sender = new Replicator();
+		sender->create(new LoopbackTopology(new LoopbackProvider(network, 1, handles)), configuration);
+		sender->setStateTemplate(stateTemplate);
+		sender->setSendState(true);
+
+		Ref< Replicator > receiver = new Replicator();
+		receiver->create(new LoopbackTopology(new LoopbackProvider(network, 2, handles)), configuration);
+
+		sender->update();
+		receiver->update();
+
+		CASE_ASSERT_EQUAL(sender->getProxyCount(), 1);
+		CASE_ASSERT_EQUAL(receiver->getProxyCount(), 1);
+		if (sender->getProxyCount() != 1 || receiver->getProxyCount() != 1)
+			return;
+
+		ReplicatorProxy* senderProxy = sender->getProxy(0);
+		senderProxy->setSendState(true);
+		receiver->getProxy(0)->setStateTemplate(stateTemplate);
+
+		Ref< State > state = new State();
+		state->pack< TransformValue >(Transform(Vector4(1.0f, 2.0f, 3.0f, 1.0f)));
+		sender->setState(state);
+
+		Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+
+		const uint32_t txBytes = senderProxy->getTxBytes();
+		network->failSend = true;
+		for (int32_t i = 0; i < 10; ++i)
+		{
+			sender->update();
+			currentThread->sleep(5);
+		}
+		CASE_ASSERT_EQUAL(senderProxy->getTxStateCount(), (uint32_t)0);
+		CASE_ASSERT_EQUAL(senderProxy->getTxStateBytes(), (uint32_t)0);
+		CASE_ASSERT_EQUAL(senderProxy->getTxBytes(), txBytes);
+
+		network->failSend = false;
+		sender->update();
+		receiver->update();
+		CASE_ASSERT_EQUAL(senderProxy->getTxStateCount(), (uint32_t)1);
+		CASE_ASSERT_EQUAL(senderProxy->getTxDeltaStateCount(), (uint32_t)0);
+		CASE_ASSERT(receiver->getProxy(0)->getState(receiver->getTime(), 1.0) != nullptr);
+
+		receiver->destroy();
+		sender->destroy();
+	}
+}
+
+}
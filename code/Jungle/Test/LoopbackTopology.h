@@ -0,0 +1,151 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include "Core/Containers/AlignedVector.h"
+#include "Jungle/INetworkTopology.h"
+#include "Jungle/IPeer2PeerProvider.h"
+
+namespace traktor::jungle::test
+{
+
+/*! In-memory network shared by loopback providers. */
+class LoopbackNetwork : public Object
+{
+public:
+	struct Packet
+	{
+		net_handle_t from;
+		net_handle_t to;
+		int32_t size;
+		uint8_t data[MaxDataSize];
+	};
+
+	std::list< Packet > packets;
+	bool failSend = false;	//!< Fail every send, as if no packet can be sent.
+};
+
+/*! Peer provider sending packets through an in-memory network, first handle is primary. */
+class LoopbackProvider : public IPeer2PeerProvider
+{
+public:
+	explicit LoopbackProvider(LoopbackNetwork* network, net_handle_t local, const AlignedVector< net_handle_t >& peers)
+	:	m_network(network)
+	,	m_local(local)
+	{
+		for (auto peer : peers)
+		{
+			if (peer != local)
+				m_peers.push_back(peer);
+		}
+	}
+
+	virtual bool update() override final { return true; }
+
+	virtual net_handle_t getLocalHandle() const override final { return m_local; }
+
+	virtual int32_t getPeerCount() const override final { return (int32_t)m_peers.size(); }
+
+	virtual net_handle_t getPeerHandle(int32_t index) const override final { return m_peers[index]; }
+
+	virtual std::wstring getPeerName(int32_t index) const override final { return L"Remote"; }
+
+	virtual Object* getPeerUser(int32_t index) const override final { return nullptr; }
+
+	virtual bool setPrimaryPeerHandle(net_handle_t node) override final { return false; }
+
+	virtual net_handle_t getPrimaryPeerHandle() const override final { return 1; }
+
+	virtual bool send(net_handle_t node, const void* data, int32_t size) override final
+	{
+		if (m_network->failSend)
+			return false;
+
+		LoopbackNetwork::Packet& packet = m_network->packets.emplace_back();
+		packet.from = m_local;
+		packet.to = node;
+		packet.size = size;
+		std::memcpy(packet.data, data, size);
+		return true;
+	}
+
+	virtual int32_t recv(void* data, int32_t size, net_handle_t& outNode) override final
+	{
+		for (auto it = m_network->packets.begin(); it != m_network->packets.end(); ++it)
+		{
+			if (it->to != m_local)
+				continue;
+
+			const int32_t nrecv = std::min(size, it->size);
+			std::memcpy(data, it->data, nrecv);
+			outNode = it->from;
+			m_network->packets.erase(it);
+			return nrecv;
+		}
+		return 0;
+	}
+
+private:
+	Ref< LoopbackNetwork > m_network;
+	net_handle_t m_local;
+	AlignedVector< net_handle_t > m_peers;
+};
+
+/*! Direct topology; every provider peer is a directly connected node. */
+class LoopbackTopology : public INetworkTopology
+{
+public:
+	explicit LoopbackTopology(IPeer2PeerProvider* provider)
+	:	m_provider(provider)
+	{
+	}
+
+	virtual void setCallback(INetworkCallback* callback) override final { m_callback = callback; }
+
+	virtual net_handle_t getLocalHandle() const override final { return m_provider->getLocalHandle(); }
+
+	virtual bool setPrimaryHandle(net_handle_t node) override final { return m_provider->setPrimaryPeerHandle(node); }
+
+	virtual net_handle_t getPrimaryHandle() const override final { return m_provider->getPrimaryPeerHandle(); }
+
+	virtual int32_t getNodeCount() const override final { return 1 + m_provider->getPeerCount(); }
+
+	virtual net_handle_t getNodeHandle(int32_t index) const override final { return index > 0 ? m_provider->getPeerHandle(index - 1) : m_provider->getLocalHandle(); }
+
+	virtual std::wstring getNodeName(int32_t index) const override final { return index > 0 ? m_provider->getPeerName(index - 1) : L"Local"; }
+
+	virtual Object* getNodeUser(int32_t index) const override final { return nullptr; }
+
+	virtual bool isNodeRelayed(int32_t index) const override final { return false; }
+
+	virtual bool send(net_handle_t node, const void* data, int32_t size) override final { return m_provider->send(node, data, size); }
+
+	virtual int32_t recv(void* data, int32_t size, net_handle_t& outNode) override final { return m_provider->recv(data, size, outNode); }
+
+	virtual bool update(double dT) override final
+	{
+		if (!m_connected && m_callback)
+		{
+			for (int32_t i = 0; i < getNodeCount(); ++i)
+				m_callback->nodeConnected(this, getNodeHandle(i));
+			m_connected = true;
+		}
+		return m_provider->update();
+	}
+
+private:
+	Ref< IPeer2PeerProvider > m_provider;
+	INetworkCallback* m_callback = nullptr;
+	bool m_connected = false;
+};
+
+}
@@ -20,6 +20,7 @@ namespace traktor::physics
 	{
 
 const int32_t c_maximumStep = 32;
+const int32_t c_blockSize = 15;	//!< Cells along each axis of a block, heights of all corners in a block are sampled in one batch.
 
 float quantizeMin(float v)
 {
@@ -42,15 +43,7 @@ HeightfieldShapeBullet::HeightfieldShapeBullet(const resource::Proxy< hf::Height
 
 	// Check if we need to account for cuts in the heightfield;
 	// heightfields with no cuts are slightly faster to check.
-	const uint8_t* cuts = m_heightfield->getCuts();
-	for (int32_t i = 0; i < m_heightfield->getSize() * m_heightfield->getSize() / 8; ++i)
-	{
-		if (cuts[i] != 0xff)
-		{
-			m_haveCuts = true;
-			break;
-		}
-	}
+	m_haveCuts = m_heightfield->haveCuts();
 }
 
 HeightfieldShapeBullet::~HeightfieldShapeBullet()
@@ -91,15 +84,10 @@ void HeightfieldShapeBullet::getAabb(const btTransform& t, btVector3& aabbMin, b
 
 void HeightfieldShapeBullet::processAllTriangles(btTriangleCallback* callback, const btVector3& aabbMin, const btVector3& aabbMax) const
 {
-	float mnx = quantizeMin(aabbMin.x());
-	float mxx = quantizeMax(aabbMax.x());
-	float mnz = quantizeMin(aabbMin.z());
-	float mxz = quantizeMax(aabbMax.z());
-
-	const int32_t imnx = int32_t(mnx);
-	const int32_t imxx = int32_t(mxx);
-	const int32_t imnz = int32_t(mnz);
-	const int32_t imxz = int32_t(mxz);
+	const int32_t imnx = int32_t(quantizeMin(aabbMin.x()));
+	const int32_t imxx = int32_t(quantizeMax(aabbMax.x()));
+	const int32_t imnz = int32_t(quantizeMin(aabbMin.z()));
+	const int32_t imxz = int32_t(quantizeMax(aabbMax.z()));
 
 	if (imnx >= imxx || imnz >= imxz)
 		return;
@@ -110,70 +98,73 @@ void HeightfieldShapeBullet::processAllTriangles(btTriangleCallback* callback, c
 	cx = min(cx, c_maximumStep);
 	cz = min(cz, c_maximumStep);
 
-	const float cxf = float(cx);
-	const float czf = float(cz);
-
-	mnx = float(imnx);
-	mxx = mnx + cxf;
+	const int32_t nu = (imxx - imnx + cx - 1) / cx;
+	const int32_t nv = (imxz - imnz + cz - 1) / cz;
 
+	Vector4 positions[(c_blockSize + 1) * (c_blockSize + 1)];
+	float heights[(c_blockSize + 1) * (c_blockSize + 1)];
+	bool cuts[(c_blockSize + 1) * (c_blockSize + 1)];
 	btVector3 triangles[2][3];
 
-	for (int32_t u = imnx; u < imxx; u += cx)
+	for (int32_t bv = 0; bv < nv; bv += c_blockSize)
 	{
-		mnz = float(imnz);
-		mxz = mnz + czf;
-
-		bool cp0 = m_heightfield->getWorldCut(mnx, mnz);
-		bool cp1 = m_heightfield->getWorldCut(mxx, mnz);
-		float hp0 = m_heightfield->getWorldHeight(mnx, mnz);
-		float hp1 = m_heightfield->getWorldHeight(mxx, mnz);
-
-		for (int32_t v = imnz; v < imxz; v += cz)
+		const int32_t sv = min(c_blockSize, nv - bv);
+		for (int32_t bu = 0; bu < nu; bu += c_blockSize)
 		{
-			const bool c[] =
-			{
-				cp0,
-				cp1,
-				m_heightfield->getWorldCut(mxx, mxz),
-				m_heightfield->getWorldCut(mnx, mxz)
-			};
+			const int32_t su = min(c_blockSize, nu - bu);
+			const int32_t pitch = su + 1;
 
-			cp0 = c[3];
-			cp1 = c[2];
-
-			const float h[] =
+			uint32_t count = 0;
+			for (int32_t v = 0; v <= sv; ++v)
 			{
-				hp0,
-				hp1,
-				m_heightfield->getWorldHeight(mxx, mxz),
-				m_heightfield->getWorldHeight(mnx, mxz)
-			};
-
-			hp0 = h[3];
-			hp1 = h[2];
+				for (int32_t u = 0; u <= su; ++u)
+				{
+					const float x = float(imnx + (bu + u) * cx);
+					const float z = float(imnz + (bv + v) * cz);
+					positions[count] = Vector4(x, 0.0f, z, 1.0f);
+					cuts[count] = m_heightfield->getWorldCut(x, z);
+					++count;
+				}
+			}
+			m_heightfield->getWorldHeights(positions, count, heights);
 
-			if (c[0] && c[2])
+			for (int32_t v = 0; v < sv; ++v)
 			{
-				triangles[0][0] = btVector3(mnx, h[0], mnz);
-				triangles[0][1] = btVector3(mnx, h[3], mxz);
-				triangles[0][2] = btVector3(mxx, h[2], mxz);
-
-				triangles[1][0] = btVector3(mxx, h[2], mxz);
-				triangles[1][1] = btVector3(mxx, h[1], mnz);
-				triangles[1][2] = btVector3(mnx, h[0], mnz);
-
-				if (c[3])
-					callback->processTriangle(triangles[0], 0, 0);
-				if (c[1])
-					callback->processTriangle(triangles[1], 0, 1);
+				for (int32_t u = 0; u < su; ++u)
+				{
+					const int32_t i[] =
+					{
+						u + v * pitch,
+						(u + 1) + v * pitch,
+						(u + 1) + (v + 1) * pitch,
+						u + (v + 1) * pitch
+					};
+
+					const bool c[] = { cuts[i[0]], cuts[i[1]], cuts[i[2]], cuts[i[3]] };
+					if (!(c[0] && c[2]))
+						continue;
+
+					const float h[] = { heights[i[0]], heights[i[1]], heights[i[2]], heights[i[3]] };
+					const float mnx = positions[i[0]].x();
+					const float mnz = positions[i[0]].z();
+					const float mxx = positions[i[2]].x();
+					const float mxz = positions[i[2]].z();
+
+					triangles[0][0] = btVector3(mnx, h[0], mnz);
+					triangles[0][1] = btVector3(mnx, h[3], mxz);
+					triangles[0][2] = btVector3(mxx, h[2], mxz);
+
+					triangles[1][0] = btVector3(mxx, h[2], mxz);
+					triangles[1][1] = btVector3(mxx, h[1], mnz);
+					triangles[1][2] = btVector3(mnx, h[0], mnz);
+
+					if (c[3])
+						callback->processTriangle(triangles[0], 0, 0);
+					if (c[1])
+						callback->processTriangle(triangles[1], 0, 1);
+				}
 			}
-
-			mnz += czf;
-			mxz += czf;
 		}
-
-		mnx += cxf;
-		mxx += cxf;
 	}
 }
 
@@ -11,6 +11,7 @@
 #include "Core/Log/Log.h"
 #include "Core/Math/Aabb3.h"
 #include "Heightfield/Heightfield.h"
+#include "Heightfield/HeightfieldTileCache.h"
 #include "Physics/AxisJoint.h"
 #include "Physics/AxisJointDesc.h"
 #include "Physics/BallJoint.h"
@@ -867,14 +868,25 @@ Ref< Body > PhysicsManagerJolt::createBody(resource::IResourceManager* resourceM
 
 		const int32_t size = heightfield->getSize();
 		AlignedVector< float > samples(size * size);
-		for (int32_t y = 0; y < size; ++y)
-			for (int32_t x = 0; x < size; ++x)
+
+		// Copy samples tile by tile so each tile of a tiled heightfield is read
+		// only once, walking rows of whole terrain would thrash the tile cache.
+		const hf::HeightfieldTileCache* tiles = heightfield->getTileCache();
+		const int32_t tileSize = tiles ? tiles->getTileSize() : size;
+		for (int32_t tileY = 0; tileY < size; tileY += tileSize)
+			for (int32_t tileX = 0; tileX < size; tileX += tileSize)
 			{
-				// Cut samples are flagged as "no collision"; Jolt discards triangles
-				// sharing such samples, same as the Bullet heightfield shape.
-				samples[x + y * size] = heightfield->getGridCut(x, y)
-					? heightfield->getGridHeightNearest(x, y)
-					: JPH::HeightFieldShapeConstants::cNoCollisionValue;
+				const int32_t endY = std::min(tileY + tileSize, size);
+				const int32_t endX = std::min(tileX + tileSize, size);
+				for (int32_t y = tileY; y < endY; ++y)
+					for (int32_t x = tileX; x < endX; ++x)
+					{
+						// Cut samples are flagged as "no collision"; Jolt discards triangles
+						// sharing such samples, same as the Bullet heightfield shape.
+						samples[x + y * size] = heightfield->getGridCut(x, y)
+							? heightfield->getGridHeightNearest(x, y)
+							: JPH::HeightFieldShapeConstants::cNoCollisionValue;
+					}
 			}
 
 		const Vector4& worldExtent = heightfield->getWorldExtent();
@@ -473,6 +473,7 @@ bool perform(const PipelineParameters& params)
 		statusListener.reset(new StatusListener());
 
 	// Build output.
+	const int32_t buildThreads = settings->getProperty< bool >(L"Pipeline.BuildThreads", false) ? settings->getProperty< int32_t >(L"Pipeline.BuildThreads.Count", 1) : 1;
 	editor::PipelineBuilder pipelineBuilder(
 		&pipelineFactory,
 		sourceDatabaseAndCache.database,
@@ -481,7 +482,8 @@ bool perform(const PipelineParameters& params)
 		pipelineDb,
 		sourceDatabaseAndCache.cache,
 		statusListener.ptr(),
-		params.getVerbose()
+		params.getVerbose(),
+		buildThreads
 	);
 
 	if (params.getRebuild())
@@ -9,6 +9,7 @@
 #include "Core/Math/Polar.h"
 #include "Core/Serialization/ISerializer.h"
 #include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/SerializationPlan.h"
 #include "Render/SH/SHCoeffs.h"
 #include "Render/SH/SHMatrix.h"
 
@@ -22,6 +23,7 @@ namespace traktor::render
 	}
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.render.SHCoeffs", 0, SHCoeffs, ISerializable)
+T_IMPLEMENT_SERIALIZATION_PLAN(SHCoeffs)
 
 void SHCoeffs::resize(int32_t bandCount)
 {
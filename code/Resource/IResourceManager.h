@@ -36,6 +36,10 @@ struct ResourceManagerStatistics
 {
 	uint32_t residentCount = 0;		//!< Number of resident resources.
 	uint32_t exclusiveCount = 0;	//!< Number of exclusive (non-shareable) resources.
+	uint32_t pendingCount = 0;		//!< Number of asynchronous loads waiting in queue.
+	uint32_t asyncLoadedCount = 0;	//!< Number of asynchronous loads completed.
+	double averageLoadLatency = 0.0;	//!< Average time, in seconds, from asynchronous bind until product is ready.
+	double maxLoadLatency = 0.0;	//!< Longest time, in seconds, from asynchronous bind until product is ready.
 };
 
 /*! Resource manager interface.
@@ -78,6 +82,26 @@ public:
 	 */
 	virtual Ref< ResourceHandle > bind(const TypeInfo& productType, const Guid& guid) = 0;
 
+	/*! Bind handle to resource identifier, load asynchronously.
+	 *
+	 * Handle is returned immediately and product is
+	 * swapped into handle by a background loader
+	 * once it has been completely created.
+	 *
+	 * \param productType Type of product.
+	 * \param guid Resource identifier.
+	 * \param priority Load priority, lower values are loaded first (e.g. distance to camera).
+	 * \return Resource handle.
+	 */
+	virtual Ref< ResourceHandle > bindAsync(const TypeInfo& productType, const Guid& guid, float priority) = 0;
+
+	/*! Change priority of pending asynchronous loads.
+	 *
+	 * \param guid Resource identifier.
+	 * \param priority Load priority, lower values are loaded first.
+	 */
+	virtual void setPriority(const Guid& guid, float priority) = 0;
+
 	/*! Reload resource.
 	 *
 	 * \param guid Resource identifier.
@@ -144,6 +168,27 @@ public:
 		outProxy.replace(handle);
 		return bool(handle->get() != nullptr);
 	}
+
+	/*! Bind handle to resource identifier, load asynchronously.
+	 *
+	 * \param id Resource identifier.
+	 * \param outProxy Resource proxy, resolves once product has been loaded.
+	 * \param priority Load priority, lower values are loaded first.
+	 * \return True if handle was bound.
+	 */
+	template <
+		typename ResourceType,
+		typename ProductType
+	>
+	bool bindAsync(const Id< ResourceType >& id, Proxy< ProductType >& outProxy, float priority)
+	{
+		Ref< ResourceHandle > handle = bindAsync(type_of< ProductType >(), id, priority);
+		if (!handle)
+			return false;
+
+		outProxy = Proxy< ProductType >(handle);
+		return true;
+	}
 };
 
 }
@@ -21,6 +21,12 @@
 
 namespace traktor::resource
 {
+	namespace
+	{
+
+const uint32_t c_loadBatchSize = 4;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.resource.ResourceManager", ResourceManager, IResourceManager)
 
@@ -37,6 +43,20 @@ ResourceManager::~ResourceManager()
 
 void ResourceManager::destroy()
 {
+	if (m_loaderThread)
+	{
+		m_loaderThread->stop();
+		ThreadManager::getInstance().destroy(m_loaderThread);
+		m_loaderThread = nullptr;
+	}
+
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+		m_pending.clear();
+		m_pendingIndices.clear();
+		m_pendingSignal.reset();
+	}
+
 	for (auto& residentHandle : m_residentHandles)
 		residentHandle.second->replace(nullptr);
 
@@ -142,83 +162,65 @@ bool ResourceManager::load(const ResourceBundle* bundle)
 
 Ref< ResourceHandle > ResourceManager::bind(const TypeInfo& productType, const Guid& guid)
 {
-	Ref< ResourceHandle > handle;
+	Ref< db::Instance > instance;
+	const IResourceFactory* factory = nullptr;
 
-	if (guid.isNull() || !guid.isValid())
-	{
-		if (!guid.isNull())
-			log::error << L"Unable to bind a " << productType.getName() << L" resource; invalid id." << Endl;
+	Ref< ResourceHandle > handle = bindHandle(productType, guid, instance, factory);
+	if (!handle)
 		return nullptr;
-	}
 
-	// Get resource instance from database.
-	Ref< db::Instance > instance = m_database->getInstance(guid);
-	if (!instance)
-	{
-		log::error << L"Unable to bind a " << productType.getName() << L" resource; no such instance (" << guid.format() << L")." << Endl;
-		return nullptr;
-	}
+	// If no resource loaded into handle then load resource through factory.
+	if (!handle->get())
+		load(instance, factory, productType, handle);
 
-	// Get type of resource.
-	const TypeInfo* resourceType = instance->getPrimaryType();
-	if (!resourceType)
-	{
-		log::error << L"Unable to bind a " << productType.getName() << L" resource; unable to read resource type (" << guid.format() << L")." << Endl;
-		return nullptr;
-	}
+	return handle;
+}
 
-	// Find factory which can create products from resource.
-	const IResourceFactory* factory = findFactory(*resourceType);
-	if (!factory)
+Ref< ResourceHandle > ResourceManager::bindAsync(const TypeInfo& productType, const Guid& guid, float priority)
+{
+	Ref< db::Instance > instance;
+	const IResourceFactory* factory = nullptr;
+
+	Ref< ResourceHandle > handle = bindHandle(productType, guid, instance, factory);
+	if (!handle || handle->get() != nullptr)
+		return handle;
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+
+	// Handle might already be queued by another bind; keep most urgent priority.
+	auto it = m_pendingIndices.find(handle);
+	if (it != m_pendingIndices.end())
 	{
-		log::error << L"Unable to bind a " << productType.getName() << L" resource; no factory for instance type \"" << resourceType->getName() << L"\" (" << guid.format() << L")." << Endl;
-		return nullptr;
+		LoadRequest& request = m_pending[it->second];
+		request.priority = std::min(request.priority, priority);
+		return handle;
 	}
 
-	// Create resource handle.
-	const bool cacheable = factory->isCacheable(productType);
-	if (cacheable)
+	if (!m_loaderThread)
 	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-		auto it = m_residentHandles.find(guid);
-		if (it != m_residentHandles.end())
-			handle = it->second;
-		else
+		m_loaderThread = ThreadManager::getInstance().create([=, this](){ threadLoader(); }, L"Resource loader");
+		if (!m_loaderThread)
 		{
-			Ref< ResidentResourceHandle > residentHandle = new ResidentResourceHandle(productType, false);
-			m_residentHandles[guid] = residentHandle;
-			handle = residentHandle;
+			log::error << L"Unable to bind a " << productType.getName() << L" resource; failed to create loader thread." << Endl;
+			return nullptr;
 		}
+		m_loaderThread->start(Thread::Below);
 	}
-	else
-	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-		RefArray< ExclusiveResourceHandle >& handles = m_exclusiveHandles[guid];
 
-		// First try to reuse handles which are no longer in use.
-		for (auto h : handles)
-		{
-			if (!h->get())
-			{
-				handle = h;
-				break;
-			}
-		}
+	m_pendingIndices[handle] = (uint32_t)m_pending.size();
+	m_pending.push_back({ guid, instance, factory, &productType, handle, priority, m_timer.getElapsedTime() });
+	m_pendingSignal.set();
+	return handle;
+}
 
-		if (!handle)
-		{
-			Ref< ExclusiveResourceHandle > exclusiveHandle = new ExclusiveResourceHandle(productType);
-			handles.push_back(exclusiveHandle);
-			handle = exclusiveHandle;
-		}
+void ResourceManager::setPriority(const Guid& guid, float priority)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+	for (auto& request : m_pending)
+	{
+		if (request.guid == guid)
+			request.priority = priority;
 	}
-	T_ASSERT(handle);
-
-	// If no resource loaded into handle then load resource through factory.
-	if (!handle->get())
-		load(instance, factory, productType, handle);
-
-	return handle;
 }
 
 bool ResourceManager::reload(const Guid& guid, bool flushedOnly)
@@ -374,27 +376,35 @@ void ResourceManager::unloadUnusedResident()
 
 void ResourceManager::getStatistics(ResourceManagerStatistics& outStatistics) const
 {
-	if (!m_lock.wait(0))
-		return;
-
-	outStatistics.residentCount = 0;
-	for (auto i = m_residentHandles.begin(); i != m_residentHandles.end(); ++i)
 	{
-		if (i->second->get() != nullptr)
-			++outStatistics.residentCount;
-	}
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 
-	outStatistics.exclusiveCount = 0;
-	for (auto i = m_exclusiveHandles.begin(); i != m_exclusiveHandles.end(); ++i)
-	{
-		for (auto handle : i->second)
+		outStatistics.residentCount = 0;
+		for (auto i = m_residentHandles.begin(); i != m_residentHandles.end(); ++i)
 		{
-			if (handle)
-				++outStatistics.exclusiveCount;
+			if (i->second->get() != nullptr)
+				++outStatistics.residentCount;
+		}
+
+		outStatistics.exclusiveCount = 0;
+		for (auto i = m_exclusiveHandles.begin(); i != m_exclusiveHandles.end(); ++i)
+		{
+			for (auto handle : i->second)
+			{
+				if (handle)
+					++outStatistics.exclusiveCount;
+			}
 		}
 	}
 
-	m_lock.release();
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+
+		outStatistics.pendingCount = (uint32_t)m_pending.size();
+		outStatistics.asyncLoadedCount = m_asyncLoadedCount;
+		outStatistics.averageLoadLatency = m_asyncLoadedCount > 0 ? m_totalLoadLatency / m_asyncLoadedCount : 0.0;
+		outStatistics.maxLoadLatency = m_maxLoadLatency;
+	}
 }
 
 const IResourceFactory* ResourceManager::findFactory(const TypeInfo& resourceType) const
@@ -407,6 +417,87 @@ const IResourceFactory* ResourceManager::findFactory(const TypeInfo& resourceTyp
 	return nullptr;
 }
 
+Ref< ResourceHandle > ResourceManager::bindHandle(const TypeInfo& productType, const Guid& guid, Ref< db::Instance >& outInstance, const IResourceFactory*& outFactory)
+{
+	Ref< ResourceHandle > handle;
+
+	if (guid.isNull() || !guid.isValid())
+	{
+		if (!guid.isNull())
+			log::error << L"Unable to bind a " << productType.getName() << L" resource; invalid id." << Endl;
+		return nullptr;
+	}
+
+	// Get resource instance from database.
+	Ref< db::Instance > instance = m_database->getInstance(guid);
+	if (!instance)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; no such instance (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
+
+	// Get type of resource.
+	const TypeInfo* resourceType = instance->getPrimaryType();
+	if (!resourceType)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; unable to read resource type (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
+
+	// Find factory which can create products from resource.
+	const IResourceFactory* factory = findFactory(*resourceType);
+	if (!factory)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; no factory for instance type \"" << resourceType->getName() << L"\" (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
+
+	// Create resource handle.
+	const bool cacheable = factory->isCacheable(productType);
+	if (cacheable)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		auto it = m_residentHandles.find(guid);
+		if (it != m_residentHandles.end())
+			handle = it->second;
+		else
+		{
+			Ref< ResidentResourceHandle > residentHandle = new ResidentResourceHandle(productType, false);
+			m_residentHandles[guid] = residentHandle;
+			handle = residentHandle;
+		}
+	}
+	else
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		RefArray< ExclusiveResourceHandle >& handles = m_exclusiveHandles[guid];
+
+		// First try to reuse handles which are no longer in use; handles
+		// still referenced might be waiting for an asynchronous load.
+		for (auto h : handles)
+		{
+			if (!h->get() && h->getReferenceCount() <= 1)
+			{
+				handle = h;
+				break;
+			}
+		}
+
+		if (!handle)
+		{
+			Ref< ExclusiveResourceHandle > exclusiveHandle = new ExclusiveResourceHandle(productType);
+			handles.push_back(exclusiveHandle);
+			handle = exclusiveHandle;
+		}
+	}
+	T_ASSERT(handle);
+
+	outInstance = instance;
+	outFactory = factory;
+	return handle;
+}
+
+
 void ResourceManager::load(const db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle)
 {
 	Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
@@ -426,12 +517,14 @@ void ResourceManager::load(const db::Instance* instance, const IResourceFactory*
 		if (m_verbose)
 			log::info << L"Resource \"" << instance->getGuid().format() << L"\" (" << type_name(object) << L") created." << Endl;
 
-		// In case resource gets reloaded; call factory to do specialized cleanup of old resource before
-		// replacing resource in handle.
-		if (handle->get() != nullptr)
-			factory->destroy(handle->get());
-
-		handle->replace(object);
+		// In case resource gets reloaded, or loaded by loader thread meanwhile; call factory to do
+		// specialized cleanup of old resource before replacing resource in handle.
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+			if (handle->get() != nullptr)
+				factory->destroy(handle->get());
+			handle->replace(object);
+		}
 
 		// Yield current thread; we want other threads to get some periodic CPU time to
 		// render loading screens etc.
@@ -441,4 +534,76 @@ void ResourceManager::load(const db::Instance* instance, const IResourceFactory*
 		log::error << L"Unable to create resource \"" << instance->getGuid().format() << L"\" (" << productType.getName() << L") using factory \"" << type_name(factory) << L"\"." << Endl;
 }
 
+void ResourceManager::threadLoader()
+{
+	AlignedVector< LoadRequest > batch;
+
+	while (!m_loaderThread->stopped())
+	{
+		if (!m_pendingSignal.wait(100))
+			continue;
+
+		// Dequeue a batch of most urgent requests, requests are dequeued in
+		// batches to keep contention with binding threads low.
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+
+			const uint32_t count = std::min< uint32_t >((uint32_t)m_pending.size(), c_loadBatchSize);
+			std::partial_sort(m_pending.begin(), m_pending.begin() + count, m_pending.end(), [](const LoadRequest& lh, const LoadRequest& rh) {
+				return lh.priority < rh.priority;
+			});
+
+			batch.insert(batch.end(), m_pending.begin(), m_pending.begin() + count);
+			m_pending.erase(m_pending.begin(), m_pending.begin() + count);
+
+			// Remaining requests have been reordered.
+			m_pendingIndices.clear();
+			for (uint32_t i = 0; i < (uint32_t)m_pending.size(); ++i)
+				m_pendingIndices[m_pending[i].handle] = i;
+
+			if (m_pending.empty())
+				m_pendingSignal.reset();
+		}
+
+		for (const auto& request : batch)
+		{
+			if (m_loaderThread->stopped())
+				break;
+
+			// Product might already have been loaded by a synchronous bind, or
+			// exclusive handle released before it was loaded; only referenced
+			// by handle map and this request.
+			if (request.handle->get() != nullptr)
+				continue;
+			if (is_a< ExclusiveResourceHandle >(request.handle) && request.handle->getReferenceCount() <= 2)
+				continue;
+
+			Ref< Object > object = request.factory->create(this, m_database, request.instance, *request.productType, nullptr);
+			if (!object)
+			{
+				log::error << L"Unable to create resource \"" << request.guid.format() << L"\" (" << request.productType->getName() << L") using factory \"" << type_name(request.factory) << L"\"." << Endl;
+				continue;
+			}
+
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_pendingLock);
+			if (request.handle->get() == nullptr)
+			{
+				request.handle->replace(object);
+
+				const double latency = m_timer.getElapsedTime() - request.queued;
+				m_totalLoadLatency += latency;
+				m_maxLoadLatency = std::max(m_maxLoadLatency, latency);
+				m_asyncLoadedCount++;
+
+				if (m_verbose)
+					log::info << L"Resource \"" << request.guid.format() << L"\" (" << type_name(object) << L") created asynchronously, " << int32_t(latency * 1000.0) << L" ms after bind." << Endl;
+			}
+			else
+				request.factory->destroy(object);
+		}
+
+		batch.resize(0);
+	}
+}
+
 }
@@ -8,10 +8,13 @@
  */
 #pragma once
 
+#include <map>
 #include <utility>
 #include "Core/RefArray.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Thread/Semaphore.h"
+#include "Core/Thread/Signal.h"
+#include "Core/Timer/Timer.h"
 #include "Resource/IResourceManager.h"
 
 // import/export mechanism.
@@ -22,6 +25,13 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class Thread;
+
+}
+
 namespace traktor::db
 {
 
@@ -39,6 +49,11 @@ class ResourceHandle;
 
 /*! Resource manager.
  * \ingroup Resource
+ *
+ * Asynchronously bound resources are queued and
+ * created by a background loader thread, in order
+ * of priority, and swapped into their handles once
+ * completely created.
  */
 class T_DLLCLASS ResourceManager : public IResourceManager
 {
@@ -61,6 +76,10 @@ public:
 
 	virtual Ref< ResourceHandle > bind(const TypeInfo& productType, const Guid& guid) override final;
 
+	virtual Ref< ResourceHandle > bindAsync(const TypeInfo& productType, const Guid& guid, float priority) override final;
+
+	virtual void setPriority(const Guid& guid, float priority) override final;
+
 	virtual bool reload(const Guid& guid, bool flushedOnly) override final;
 
 	virtual void reload(const TypeInfo& productType, bool flushedOnly) override final;
@@ -72,6 +91,17 @@ public:
 	virtual void getStatistics(ResourceManagerStatistics& outStatistics) const override final;
 
 private:
+	struct LoadRequest
+	{
+		Guid guid;
+		Ref< const db::Instance > instance;
+		Ref< const IResourceFactory > factory;
+		const TypeInfo* productType;
+		Ref< ResourceHandle > handle;
+		float priority;
+		double queued;
+	};
+
 	Ref< db::Database > m_database;
 	AlignedVector< std::pair< const TypeInfo*, Ref< const IResourceFactory > > > m_resourceFactories;
 	SmallMap< Guid, Ref< ResidentResourceHandle > > m_residentHandles;
@@ -79,8 +109,23 @@ private:
 	mutable Semaphore m_lock;
 	bool m_verbose;
 
+	// Asynchronous loading.
+	Thread* m_loaderThread = nullptr;
+	mutable Semaphore m_pendingLock;	//!< Also serialize replacing products in handles.
+	Signal m_pendingSignal;
+	AlignedVector< LoadRequest > m_pending;
+	std::map< const ResourceHandle*, uint32_t > m_pendingIndices;	//!< Index of handle's request in pending.
+	Timer m_timer;
+	uint32_t m_asyncLoadedCount = 0;
+	double m_totalLoadLatency = 0.0;
+	double m_maxLoadLatency = 0.0;
+
 	const IResourceFactory* findFactory(const TypeInfo& resourceType) const;
 
+	Ref< ResourceHandle > bindHandle(const TypeInfo& productType, const Guid& guid, Ref< db::Instance >& outInstance, const IResourceFactory*& outFactory);
+
+	void threadLoader();
+
 	void load(const db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle);
 };
 
@@ -0,0 +1,191 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <atomic>
+#include "Core/Guid.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Misc/String.h"
+#include "Core/Serialization/ISerializable.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Database/Database.h"
+#include "Database/Instance.h"
+#include "Resource/IResourceFactory.h"
+#include "Resource/ResourceHandle.h"
+#include "Resource/ResourceManager.h"
+#include "Resource/Test/CaseResourceManager.h"
+
+namespace traktor::resource::test
+{
+	namespace
+	{
+
+const int32_t c_resourceCount = 32;
+
+class ResourceManager_Resource : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void serialize(ISerializer& s) override final {}
+};
+
+class ResourceManager_Product : public Object
+{
+	T_RTTI_CLASS;
+};
+
+class ResourceManager_ExclusiveProduct : public Object
+{
+	T_RTTI_CLASS;
+};
+
+/*! Factory counting created and destroyed products. */
+class ResourceManager_Factory : public IResourceFactory
+{
+	T_RTTI_CLASS;
+
+public:
+	mutable std::atomic< int32_t > created = 0;
+	mutable std::atomic< int32_t > destroyed = 0;
+
+	virtual bool initialize(const ObjectStore& objectStore) override final { return true; }
+
+	virtual const TypeInfoSet getResourceTypes() const override final
+	{
+		return makeTypeInfoSet(type_of< ResourceManager_Resource >());
+	}
+
+	virtual const TypeInfoSet getProductTypes(const TypeInfo& resourceType) const override final
+	{
+		return makeTypeInfoSet(type_of< ResourceManager_Product >(), type_of< ResourceManager_ExclusiveProduct >());
+	}
+
+	virtual bool isCacheable(const TypeInfo& productType) const override final
+	{
+		return &productType == &type_of< ResourceManager_Product >();
+	}
+
+	virtual Ref< Object > create(IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const override final
+	{
+		// Take some time so synchronous and asynchronous loads overlap.
+		ThreadManager::getInstance().getCurrentThread()->sleep(1);
+		created++;
+		if (isCacheable(productType))
+			return new ResourceManager_Product();
+		else
+			return new ResourceManager_ExclusiveProduct();
+	}
+
+	virtual void destroy(Object* resource) const override final
+	{
+		destroyed++;
+	}
+};
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.resource.test.CaseResourceManager.ResourceManager_Resource", 0, ResourceManager_Resource, ISerializable)
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.resource.test.CaseResourceManager.ResourceManager_Product", ResourceManager_Product, Object)
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.resource.test.CaseResourceManager.ResourceManager_ExclusiveProduct", ResourceManager_ExclusiveProduct, Object)
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.resource.test.CaseResourceManager.ResourceManager_Factory", ResourceManager_Factory, IResourceFactory)
+
+/*! Wait until all queued loads has been processed and each product is either in a handle or destroyed. */
+bool waitUntilSettled(ResourceManager* resourceManager, const ResourceManager_Factory* factory, int32_t live)
+{
+	for (int32_t i = 0; i < 500; ++i)
+	{
+		ResourceManagerStatistics statistics;
+		resourceManager->getStatistics(statistics);
+		if (statistics.pendingCount == 0 && factory->created == factory->destroyed + live)
+			return true;
+		ThreadManager::getInstance().getCurrentThread()->sleep(10);
+	}
+	return false;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.resource.test.CaseResourceManager", 0, CaseResourceManager, traktor::test::Case)
+
+void CaseResourceManager::run()
+{
+	const std::wstring databasePath = OS::getInstance().getWritableFolderPath() + L"/Traktor/Resource/Test/" + Guid::create().format();
+	CASE_ASSERT(FileSystem::getInstance().makeAllDirectories(databasePath));
+
+	Ref< db::Database > database = new db::Database();
+	const bool created = database->create(db::ConnectionString(L"provider=traktor.db.CompactDatabase;fileName=" + databasePath + L"/Test.compact"));
+	CASE_ASSERT(created);
+	if (!created)
+		return;
+
+	Guid guids[c_resourceCount];
+	for (int32_t i = 0; i < c_resourceCount; ++i)
+	{
+		guids[i] = Guid::create();
+		Ref< db::Instance > instance = database->createInstance(L"Resource" + toString(i), db::CifDefault, &guids[i]);
+		CASE_ASSERT(instance != nullptr);
+		if (!instance)
+			return;
+		CASE_ASSERT(instance->setObject(new ResourceManager_Resource()));
+		CASE_ASSERT(instance->commit());
+	}
+
+	Ref< ResourceManager_Factory > factory = new ResourceManager_Factory();
+	Ref< ResourceManager > resourceManager = new ResourceManager(database, false);
+	resourceManager->addFactory(factory);
+
+	// Bind both asynchronously and synchronously; products created by
+	// the loader thread which lose the race must be destroyed, not leaked.
+	RefArray< ResourceHandle > handles;
+	for (int32_t i = 0; i < c_resourceCount; ++i)
+	{
+		CASE_ASSERT(resourceManager->bindAsync(type_of< ResourceManager_Product >(), guids[i], float(i)) != nullptr);
+		handles.push_back(resourceManager->bind(type_of< ResourceManager_Product >(), guids[i]));
+	}
+
+	CASE_ASSERT(waitUntilSettled(resourceManager, factory, c_resourceCount));
+	for (auto handle : handles)
+		CASE_ASSERT(handle != nullptr && is_a< ResourceManager_Product >(handle->get()));
+
+	// Exclusive handles released before their load runs; queued loads must not
+	// touch released handles.
+	const int32_t createdBefore = factory->created;
+	for (int32_t i = 0; i < c_resourceCount; ++i)
+		resourceManager->bindAsync(type_of< ResourceManager_ExclusiveProduct >(), guids[i], 0.0f);
+
+	ResourceManagerStatistics statistics;
+	for (int32_t i = 0; i < 500; ++i)
+	{
+		resourceManager->getStatistics(statistics);
+		if (statistics.pendingCount == 0)
+			break;
+		ThreadManager::getInstance().getCurrentThread()->sleep(10);
+	}
+	CASE_ASSERT_EQUAL(statistics.pendingCount, (uint32_t)0);
+	CASE_ASSERT(factory->created - createdBefore < c_resourceCount);
+
+	Ref< ResourceHandle > exclusiveHandle = resourceManager->bind(type_of< ResourceManager_ExclusiveProduct >(), guids[0]);
+	CASE_ASSERT(exclusiveHandle != nullptr && is_a< ResourceManager_ExclusiveProduct >(exclusiveHandle->get()));
+
+	exclusiveHandle = nullptr;
+	handles.clear();
+
+	resourceManager->destroy();
+	resourceManager = nullptr;
+
+	database->close();
+	database = nullptr;
+
+	FileSystem::getInstance().remove(databasePath + L"/Test.compact");
+	FileSystem::getInstance().removeDirectory(databasePath);
+}
+
+}
@@ -191,6 +191,10 @@ bool BuildTargetAction::execute(IProgressListener* progressListener)
 	// Merge threaded build configuration from global configuration.
 	const bool dependsThreads = m_globalSettings->getProperty< bool >(L"Pipeline.DependsThreads", true);
 	pipelineConfiguration->setProperty< PropertyBoolean >(L"Pipeline.DependsThreads", dependsThreads);
+	const bool buildThreads = m_globalSettings->getProperty< bool >(L"Pipeline.BuildThreads", false);
+	pipelineConfiguration->setProperty< PropertyBoolean >(L"Pipeline.BuildThreads", buildThreads);
+	const int32_t buildThreadsCount = m_globalSettings->getProperty< int32_t >(L"Pipeline.BuildThreads.Count", 1);
+	pipelineConfiguration->setProperty< PropertyInteger >(L"Pipeline.BuildThreads.Count", buildThreadsCount);
 
 	// Set database connection strings.
 	db::ConnectionString sourceDatabaseCs = m_globalSettings->getProperty< std::wstring >(L"Editor.SourceDatabase");
@@ -34,6 +34,7 @@ namespace traktor::runtime
  *
  * "Script.Library"	- Script library.
  * "Script.Type"	- Script manager type.
+ * "Script.CollectBudget"	- Garbage collection budget per frame in microseconds, 0 let scripting language pace collection.
  */
 class T_DLLCLASS IScriptServer : public IServer
 {
@@ -13,6 +13,7 @@
 #include "Core/Log/Log.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Settings/PropertyGroup.h"
+#include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
 #include "Core/Thread/Acquire.h"
 #include "Core/Thread/ThreadManager.h"
@@ -68,6 +69,7 @@ bool ScriptServer::create(
 			runtimeClassFactory->createClasses(&registrar);
 	}
 	registrar.registerClassesInOrder(m_scriptManager);
+	m_scriptManager->setCollectBudget(settings->getProperty< int32_t >(L"Script.CollectBudget", 0));
 
 	// Complete registration of all classes (register members, methods, properties, etc.)
 	// This is needed for script backends that require two-phase registration (e.g., AngelScript).
@@ -165,6 +167,7 @@ void ScriptServer::createResourceFactories(IEnvironment* environment)
 
 int32_t ScriptServer::reconfigure(const PropertyGroup* settings)
 {
+	m_scriptManager->setCollectBudget(settings->getProperty< int32_t >(L"Script.CollectBudget", 0));
 	return CrUnaffected;
 }
 
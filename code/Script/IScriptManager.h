@@ -108,6 +108,16 @@ public:
 	 */
 	virtual void collectGarbage(bool full) = 0;
 
+	/*! Set time budget of partial garbage collection.
+	 *
+	 * When a budget is set each partial collection is
+	 * paced against amount of memory allocated since
+	 * last collection but try not to exceed budget.
+	 *
+	 * \param budget Budget in microseconds, 0 let scripting language pace collection.
+	 */
+	virtual void setCollectBudget(uint32_t budget) = 0;
+
 	/*! */
 	virtual void getStatistics(ScriptStatistics& outStatistics) const = 0;
 };
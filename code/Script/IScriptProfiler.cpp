@@ -8,9 +8,20 @@
  */
 #include "Script/IScriptProfiler.h"
 
+#include <cstring>
+
 namespace traktor::script
 {
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.script.IScriptProfiler", IScriptProfiler, Object)
 
+void IScriptProfiler::getCollectStatistics(CollectStatistics& outStatistics) const
+{
+	std::memset(&outStatistics, 0, sizeof(outStatistics));
+}
+
+void IScriptProfiler::resetCollectStatistics()
+{
+}
+
 }
@@ -44,9 +44,31 @@ public:
 		virtual void callMeasured(const Guid& scriptId, const std::wstring& function, uint32_t callCount, double inclusiveDuration, double exclusiveDuration) = 0;
 	};
 
+	/*! Garbage collection pause statistics. */
+	struct CollectStatistics
+	{
+		enum { HistogramBins = 14 };
+
+		uint32_t histogram[HistogramBins];	//!< Number of pauses; first bin is below 1 us, then doubling until last bin which is 4096 us and above.
+		uint32_t pauseCount;
+		uint32_t overBudgetCount;			//!< Number of pauses which exceeded budget.
+		double totalDuration;
+		double maxDuration;
+	};
+
 	virtual void addListener(IListener* listener) = 0;
 
 	virtual void removeListener(IListener* listener) = 0;
+
+	/*! Get garbage collection pause statistics since last reset.
+	 *
+	 * Profilers which doesn't measure collection return
+	 * empty statistics.
+	 */
+	virtual void getCollectStatistics(CollectStatistics& outStatistics) const;
+
+	/*! Reset garbage collection pause statistics. */
+	virtual void resetCollectStatistics();
 };
 
 }
@@ -0,0 +1,234 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "Core/Memory/IAllocator.h"
+#include "Core/Memory/MemoryConfig.h"
+#include "Core/Misc/Align.h"
+#include "Script/Lua/ScriptAllocatorLua.h"
+
+namespace traktor::script
+{
+	namespace
+	{
+
+// Step between classes grow with size to keep internal fragmentation below 25%.
+const uint32_t c_sizeClasses[] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512 };
+
+// Number of empty pages retained by each class.
+const uint32_t c_maxEmptyPages = 1;
+
+	}
+
+ScriptAllocatorLua::ScriptAllocatorLua()
+{
+	static_assert(sizeof_array(c_sizeClasses) == c_sizeClassCount);
+
+	uint32_t sc = 0;
+	for (uint32_t i = 0; i < c_sizeClassCount; ++i)
+	{
+		m_classes[i].size = c_sizeClasses[i];
+		m_classes[i].pageBlocks = (c_pageSize - alignUp(sizeof(Page), 16)) / c_sizeClasses[i];
+		for (; sc * 16 <= c_sizeClasses[i]; ++sc)
+			m_classOf[sc] = (uint8_t)i;
+	}
+	T_FATAL_ASSERT(sc == sizeof_array(m_classOf));
+}
+
+ScriptAllocatorLua::~ScriptAllocatorLua()
+{
+	IAllocator* allocator = getAllocator();
+	for (auto& sizeClass : m_classes)
+	{
+		for (auto page : sizeClass.pages)
+			allocator->free(page);
+	}
+}
+
+void* ScriptAllocatorLua::reallocate(void* ptr, size_t osize, size_t nsize)
+{
+	// LUA pass type of object in osize when ptr is null.
+	if (!ptr)
+		return nsize > 0 ? allocate(nsize) : nullptr;
+
+	if (nsize == 0)
+	{
+		release(ptr, osize);
+		return nullptr;
+	}
+
+	// Keep block if it's still in the same class; large blocks
+	// are also kept when shrinking a little.
+	const int32_t oc = classOf(osize);
+	const int32_t nc = classOf(nsize);
+	if (oc == nc && (oc >= 0 || (osize >= nsize && osize - nsize < 512)))
+		return ptr;
+
+	void* nptr = allocate(nsize);
+	if (!nptr)
+		return nullptr;
+
+	std::memcpy(nptr, ptr, std::min(osize, nsize));
+	release(ptr, osize);
+	return nptr;
+}
+
+void ScriptAllocatorLua::getStatistics(AlignedVector< SizeClassStatistics >& outStatistics) const
+{
+	outStatistics.resize(c_sizeClassCount + 1);
+	for (uint32_t i = 0; i < c_sizeClassCount; ++i)
+	{
+		const SizeClass& sizeClass = m_classes[i];
+		auto& st = outStatistics[i];
+		st.size = sizeClass.size;
+		st.pages = (uint32_t)sizeClass.pages.size();
+		st.liveBlocks = sizeClass.liveBlocks;
+		st.peakBlocks = sizeClass.peakBlocks;
+		st.allocations = sizeClass.allocations;
+	}
+
+	auto& st = outStatistics.back();
+	st.size = 0;
+	st.pages = 0;
+	st.liveBlocks = m_largeBlocks;
+	st.peakBlocks = m_largePeakBlocks;
+	st.allocations = m_largeAllocations;
+}
+
+void* ScriptAllocatorLua::allocate(size_t size)
+{
+	const int32_t c = classOf(size);
+	if (c < 0)
+	{
+		void* ptr = getAllocator()->alloc(size, 16, T_FILE_LINE);
+		if (!ptr)
+			return nullptr;
+
+		m_largeBlocks++;
+		m_largePeakBlocks = std::max(m_largePeakBlocks, m_largeBlocks);
+		m_largeAllocations++;
+		return ptr;
+	}
+
+	SizeClass& sizeClass = m_classes[c];
+	Page* page = sizeClass.available;
+	if (!page)
+	{
+		// No page with free blocks; allocate new page.
+		void* memory = getAllocator()->alloc(c_pageSize, 16, T_FILE_LINE);
+		if (!memory)
+			return nullptr;
+
+		page = new (memory) Page();
+		sizeClass.pages.insert(std::upper_bound(sizeClass.pages.begin(), sizeClass.pages.end(), page), page);
+		sizeClass.emptyPages++;
+		linkFirst(sizeClass, page);
+	}
+
+	// Take released block, or carve next never used block.
+	void* ptr = page->free;
+	if (ptr)
+		page->free = *(void**)ptr;
+	else
+		ptr = (uint8_t*)page + alignUp(sizeof(Page), 16) + page->carved++ * sizeClass.size;
+
+	if (page->liveBlocks++ == 0)
+		sizeClass.emptyPages--;
+	if (page->liveBlocks >= sizeClass.pageBlocks)
+		unlink(sizeClass, page);
+
+	sizeClass.liveBlocks++;
+	sizeClass.peakBlocks = std::max(sizeClass.peakBlocks, sizeClass.liveBlocks);
+	sizeClass.allocations++;
+	return ptr;
+}
+
+void ScriptAllocatorLua::release(void* ptr, size_t size)
+{
+	const int32_t c = classOf(size);
+	if (c < 0)
+	{
+		T_ASSERT(m_largeBlocks > 0);
+		getAllocator()->free(ptr);
+		m_largeBlocks--;
+		return;
+	}
+
+	SizeClass& sizeClass = m_classes[c];
+	T_ASSERT(sizeClass.liveBlocks > 0);
+	sizeClass.liveBlocks--;
+
+	// Find page containing block, last page starting before block.
+	auto it = std::upper_bound(sizeClass.pages.begin(), sizeClass.pages.end(), ptr, [](const void* ptr, const Page* page) {
+		return ptr < (const void*)page;
+	});
+	T_ASSERT(it != sizeClass.pages.begin());
+	Page* page = *(--it);
+
+	*(void**)ptr = page->free;
+	page->free = ptr;
+
+	// Page with free blocks are available for allocation, empty pages are
+	// linked last so blocks are allocated from partially used pages first.
+	if (page->liveBlocks-- >= sizeClass.pageBlocks)
+		linkFirst(sizeClass, page);
+	if (page->liveBlocks > 0)
+		return;
+
+	unlink(sizeClass, page);
+	if (sizeClass.emptyPages < c_maxEmptyPages)
+	{
+		linkLast(sizeClass, page);
+		sizeClass.emptyPages++;
+	}
+	else
+	{
+		sizeClass.pages.erase(it);
+		page->~Page();
+		getAllocator()->free(page);
+	}
+}
+
+void ScriptAllocatorLua::linkFirst(SizeClass& sizeClass, Page* page)
+{
+	page->prev = nullptr;
+	page->next = sizeClass.available;
+	if (sizeClass.available)
+		sizeClass.available->prev = page;
+	else
+		sizeClass.availableLast = page;
+	sizeClass.available = page;
+}
+
+void ScriptAllocatorLua::linkLast(SizeClass& sizeClass, Page* page)
+{
+	page->prev = sizeClass.availableLast;
+	page->next = nullptr;
+	if (sizeClass.availableLast)
+		sizeClass.availableLast->next = page;
+	else
+		sizeClass.available = page;
+	sizeClass.availableLast = page;
+}
+
+void ScriptAllocatorLua::unlink(SizeClass& sizeClass, Page* page)
+{
+	if (page->prev)
+		page->prev->next = page->next;
+	else
+		sizeClass.available = page->next;
+	if (page->next)
+		page->next->prev = page->prev;
+	else
+		sizeClass.availableLast = page->prev;
+	page->prev = page->next = nullptr;
+}
+
+}
@@ -0,0 +1,115 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Containers/AlignedVector.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_SCRIPT_LUA_EXPORT) || defined(T_SCRIPT_LUAJIT_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::script
+{
+
+/*! Small object allocator for a LUA state.
+ * \ingroup Script
+ *
+ * Blocks up to 512 bytes are served from per size class
+ * slabs; each page keep an intrusive free list, same as
+ * BlockAllocator, and pages with free blocks are linked
+ * per class thus allocating is O(1).
+ * Since LUA always pass the old size when resizing or
+ * freeing a block the class is known without any lookup,
+ * the page is found by a binary search of the class' pages.
+ * Larger blocks are forwarded to the global allocator.
+ *
+ * Pages are released as soon as they become empty, except
+ * one which is retained per class to prevent allocating
+ * and releasing a page repeatedly at a page boundary.
+ *
+ * The allocator isn't thread safe; LUA state must be
+ * locked by caller.
+ */
+class T_DLLCLASS ScriptAllocatorLua
+{
+public:
+	struct SizeClassStatistics
+	{
+		uint32_t size = 0;			//!< Block size in bytes, 0 for large blocks.
+		uint32_t pages = 0;			//!< Number of pages allocated.
+		uint32_t liveBlocks = 0;	//!< Number of blocks currently in use.
+		uint32_t peakBlocks = 0;	//!< Peak number of blocks in use.
+		uint64_t allocations = 0;	//!< Total number of allocations.
+	};
+
+	ScriptAllocatorLua();
+
+	~ScriptAllocatorLua();
+
+	ScriptAllocatorLua(const ScriptAllocatorLua&) = delete;
+
+	ScriptAllocatorLua& operator = (const ScriptAllocatorLua&) = delete;
+
+	/*! Allocate, resize or free block; semantic as lua_Alloc. */
+	void* reallocate(void* ptr, size_t osize, size_t nsize);
+
+	/*! Get statistics of each size class, large blocks are last. */
+	void getStatistics(AlignedVector< SizeClassStatistics >& outStatistics) const;
+
+private:
+	static constexpr uint32_t c_pageSize = 16 * 1024;
+	static constexpr uint32_t c_maxSmallSize = 512;
+	static constexpr uint32_t c_sizeClassCount = 16;
+
+	struct Page
+	{
+		Page* prev = nullptr;		//!< Previous page with free blocks.
+		Page* next = nullptr;		//!< Next page with free blocks.
+		void* free = nullptr;		//!< Free list of released blocks.
+		uint32_t carved = 0;		//!< Number of blocks carved from page.
+		uint32_t liveBlocks = 0;
+	};
+
+	struct SizeClass
+	{
+		uint32_t size = 0;
+		uint32_t pageBlocks = 0;	//!< Number of blocks in each page.
+		Page* available = nullptr;	//!< Pages with free blocks, empty pages last.
+		Page* availableLast = nullptr;
+		AlignedVector< Page* > pages;	//!< All pages, sorted by address.
+		uint32_t emptyPages = 0;
+		uint32_t liveBlocks = 0;
+		uint32_t peakBlocks = 0;
+		uint64_t allocations = 0;
+	};
+
+	SizeClass m_classes[c_sizeClassCount];
+	uint8_t m_classOf[c_maxSmallSize / 16 + 1];
+	uint32_t m_largeBlocks = 0;
+	uint32_t m_largePeakBlocks = 0;
+	uint64_t m_largeAllocations = 0;
+
+	int32_t classOf(size_t size) const { return size <= c_maxSmallSize ? (int32_t)m_classOf[(size + 15) >> 4] : -1; }
+
+	void* allocate(size_t size);
+
+	void release(void* ptr, size_t size);
+
+	static void linkFirst(SizeClass& sizeClass, Page* page);
+
+	static void linkLast(SizeClass& sizeClass, Page* page);
+
+	static void unlink(SizeClass& sizeClass, Page* page);
+};
+
+}
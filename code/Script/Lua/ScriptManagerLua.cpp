@@ -11,6 +11,7 @@
 #include "Core/Class/Boxes/BoxedTypeInfo.h"
 #include "Core/Class/IRuntimeClass.h"
 #include "Core/Class/IRuntimeDispatch.h"
+#include "Core/Math/Float.h"
 #include "Core/Math/MathUtils.h"
 #include "Core/Misc/Save.h"
 #include "Core/Misc/Split.h"
@@ -128,6 +129,13 @@ ScriptManagerLua::ScriptManagerLua()
 ,	m_collectTargetSteps(0.0f)
 ,	m_totalMemoryUse(0)
 ,	m_lastMemoryUse(0)
+,	m_allocatedMemory(0)
+,	m_collectAllocatedMemory(0)
+,	m_collectBudget(0)
+,	m_collectDebt(0.0)
+,	m_collectMinorMultiplier(0.0)
+,	m_collectStepSize(0.0)
+,	m_collectCostPerStep(0.0)
 {
 	T_FATAL_ASSERT(ms_instance == nullptr);
 	ms_instance = this;
@@ -564,6 +572,37 @@ void ScriptManagerLua::collectGarbage(bool full)
 		collectGarbageFull();
 }
 
+void ScriptManagerLua::setCollectBudget(uint32_t budget)
+{
+#if defined(T_SCRIPT_LUA_USE_MT_LOCK)
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+#endif
+	if (budget == m_collectBudget)
+		return;
+
+	if (budget > 0 && m_collectBudget == 0)
+	{
+		// Budgeted collection keeps generational collector but stop Lua from
+		// collecting by itself, instead collector is stepped explicitly.
+		lua_gc(m_luaState, LUA_GCSTOP);
+		m_collectAllocatedMemory = m_allocatedMemory;
+		m_collectDebt = 0.0;
+
+		// Lua perform a minor collection when heap has grown by it's minor multiplier
+		// percentage, and each incremental step of a major collection is credited with
+		// it's step size.
+		m_collectMinorMultiplier = (double)std::max(lua_gc(m_luaState, LUA_GCPARAM, LUA_GCPMINORMUL, -1), 1) / 100.0;
+		m_collectStepSize = (double)std::max(lua_gc(m_luaState, LUA_GCPARAM, LUA_GCPSTEPSIZE, -1), 1024);
+	}
+	else if (budget == 0)
+	{
+		lua_gc(m_luaState, LUA_GCRESTART);
+		m_collectSteps = -1;
+	}
+
+	m_collectBudget = budget;
+}
+
 void ScriptManagerLua::getStatistics(ScriptStatistics& outStatistics) const
 {
 	outStatistics.memoryUsage = uint32_t(m_totalMemoryUse);
@@ -947,6 +986,8 @@ void ScriptManagerLua::collectGarbageFullNoLock()
 	if (!m_luaState)
 		return;
 
+	const double T0 = s_timer.getElapsedTime();
+
 	// Repeat GC while it keeps freeing memory, then a few more times to be sure.
 	//
 	// Each pass is a full mark and sweep of the whole heap, so the patience is what this
@@ -969,10 +1010,20 @@ void ScriptManagerLua::collectGarbageFullNoLock()
 	}
 
 	m_lastMemoryUse = m_totalMemoryUse;
+	m_collectDebt = 0.0;
+
+	if (m_profiler)
+		m_profiler->measureCollect(s_timer.getElapsedTime() - T0, 0.0);
 }
 
 void ScriptManagerLua::collectGarbagePartial()
 {
+	if (m_collectBudget > 0)
+	{
+		collectGarbageBudget();
+		return;
+	}
+
 #if defined(T_SCRIPT_LUA_USE_GENERATIONAL_COLLECTOR)
 
 	// Nothing to do, deliberately: the generational collector enabled in the constructor
@@ -1012,7 +1063,7 @@ void ScriptManagerLua::collectGarbagePartial()
 			// 128 KiB of allocation credited per step. Expressed in bytes because that is
 			// what LUA_GCSTEP takes as of Lua 5.5; it took Kbytes up to 5.4, so the bare
 			// 128 this once was became 1024x too little work per step after the upgrade.
-			lua_gc(m_luaState, LUA_GCSTEP, 128 * 1024);
+			lua_gc(m_luaState, LUA_GCSTEP, (size_t)128 * 1024);
 			++m_collectSteps;
 		}
 		m_collectSteps = targetSteps;
@@ -1044,6 +1095,55 @@ void ScriptManagerLua::collectGarbagePartial()
 #endif
 }
 
+void ScriptManagerLua::collectGarbageBudget()
+{
+#if defined(T_SCRIPT_LUA_USE_MT_LOCK)
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+#endif
+	const double budget = m_collectBudget * 1e-6;
+	const double T0 = s_timer.getElapsedTime();
+
+	// Credit collector with memory allocated since last frame.
+	m_collectDebt += double(m_allocatedMemory - m_collectAllocatedMemory);
+	m_collectAllocatedMemory = m_allocatedMemory;
+
+	// Nothing is collected until young generation has grown by the minor multiplier
+	// of the heap, same as when Lua pace collection itself.
+	const double heapSize = double(m_totalMemoryUse);
+	const bool due = (m_collectDebt >= heapSize * m_collectMinorMultiplier);
+
+	double T = T0;
+	while (due && m_collectDebt > 0.0)
+	{
+		// Stop before a step which is expected to overshoot budget; always take
+		// first step as a single slow step would otherwise stall collector until
+		// estimate recovers. Budget is exceeded only when collector has fallen
+		// behind by more than the entire heap, else heap would grow without bound.
+		const double remaining = budget - (T - T0);
+		if (T > T0 && remaining < m_collectCostPerStep && m_collectDebt <= heapSize)
+			break;
+
+		// Step size argument is in bytes as of Lua 5.5 and is read as a size_t, zero
+		// performs a single step. In generational mode a step is a minor collection of
+		// all young objects, or an incremental step of a major collection.
+		const size_t memoryUseBefore = m_totalMemoryUse;
+		lua_gc(m_luaState, LUA_GCSTEP, (size_t)0);
+
+		const double Tn = s_timer.getElapsedTime();
+		m_collectCostPerStep = (m_collectCostPerStep > 0.0) ? lerp(m_collectCostPerStep, Tn - T, 0.2) : (Tn - T);
+		T = Tn;
+
+		// Credit step with work done; at least what Lua credit an incremental step with.
+		const double freed = (m_totalMemoryUse < memoryUseBefore) ? double(memoryUseBefore - m_totalMemoryUse) : 0.0;
+		m_collectDebt -= std::max(freed, m_collectStepSize);
+	}
+
+	m_lastMemoryUse = m_totalMemoryUse;
+
+	if (m_profiler)
+		m_profiler->measureCollect(T - T0, budget);
+}
+
 void ScriptManagerLua::breakDebugger(lua_State* luaState)
 {
 	if (!m_debugger)
@@ -1595,53 +1695,27 @@ void* ScriptManagerLua::luaAlloc(void* ud, void* ptr, size_t osize, size_t nsize
 	ScriptManagerLua* this_ = reinterpret_cast< ScriptManagerLua* >(ud);
 	T_ASSERT(this_);
 
-	IAllocator* allocator = getAllocator();
+	// LUA pass type of object in osize when allocating a new block.
 	size_t& totalMemoryUse = this_->m_totalMemoryUse;
-	if (nsize > 0)
-	{
-		totalMemoryUse += nsize;
-
-#if defined(T_USE_ALLOCATOR)
-		if (osize >= nsize && osize - nsize < 512)
-		{
-			T_ASSERT(ptr);
-			totalMemoryUse -= osize;
-			return ptr;
-		}
-
-		void* nptr = allocator->alloc(nsize, 16, T_FILE_LINE);
-		if (!nptr)
-			return nullptr;
-#endif
+	const size_t usedSize = ptr ? osize : 0;
+	if (nsize > usedSize)
+		this_->m_allocatedMemory += nsize - usedSize;
 
-		if (ptr && osize > 0)
-		{
 #if defined(T_USE_ALLOCATOR)
-			std::memcpy(nptr, ptr, std::min(osize, nsize));
-			allocator->free(ptr);
+	void* nptr = this_->m_allocator.reallocate(ptr, osize, nsize);
+#else
+	void* nptr = ((lua_Alloc)(this_->m_defaultAllocFn))(this_->m_defaultAllocOpaque, ptr, osize, nsize);
 #endif
-			T_ASSERT(osize <= totalMemoryUse);
-			totalMemoryUse -= osize;
-		}
 
-#if defined(T_USE_ALLOCATOR)
-		return nptr;
-#endif
-	}
-	else if (ptr)
+	// Failing to grow leave original block intact.
+	if (nptr || nsize == 0)
 	{
-#if defined(T_USE_ALLOCATOR)
-		allocator->free(ptr);
-#endif
-		T_ASSERT(osize <= totalMemoryUse);
-		totalMemoryUse -= osize;
+		T_ASSERT(usedSize <= totalMemoryUse);
+		totalMemoryUse += nsize;
+		totalMemoryUse -= usedSize;
 	}
 
-#if defined(T_USE_ALLOCATOR)
-	return nullptr;
-#else
-	return ((lua_Alloc)(this_->m_defaultAllocFn))(this_->m_defaultAllocOpaque, ptr, osize, nsize);
-#endif
+	return nptr;
 }
 
 int ScriptManagerLua::luaAllocatedMemory(lua_State* luaState)
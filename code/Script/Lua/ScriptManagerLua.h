@@ -13,6 +13,7 @@
 #include "Core/RefArray.h"
 #include "Core/Containers/AlignedVector.h"
 #include "Script/IScriptManager.h"
+#include "Script/Lua/ScriptAllocatorLua.h"
 
 #if defined(T_SCRIPT_LUA_USE_MT_LOCK)
 #	include "Core/Thread/Semaphore.h"
@@ -69,8 +70,13 @@ public:
 
 	virtual void collectGarbage(bool full) override final;
 
+	virtual void setCollectBudget(uint32_t budget) override final;
+
 	virtual void getStatistics(ScriptStatistics& outStatistics) const override final;
 
+	/*! Get allocator of LUA state, only valid with lock held. */
+	const ScriptAllocatorLua& getScriptAllocator() const { return m_allocator; }
+
 	void pushObject(ITypedObject* object);
 
 	void pushAny(const Any& any);
@@ -108,6 +114,7 @@ private:
 		bool isValueType;
 	};
 
+	ScriptAllocatorLua m_allocator;
 	lua_State* m_luaState;
 	void* m_defaultAllocFn;
 	void* m_defaultAllocOpaque;
@@ -126,6 +133,13 @@ private:
 	float m_collectTargetSteps;
 	size_t m_totalMemoryUse;
 	size_t m_lastMemoryUse;
+	uint64_t m_allocatedMemory;			//!< Total number of bytes allocated, never decrease.
+	uint64_t m_collectAllocatedMemory;	//!< Total number of bytes allocated at last budgeted collection.
+	uint32_t m_collectBudget;			//!< Budget of partial collection in microseconds.
+	double m_collectDebt;				//!< Bytes of allocation not yet credited to collector.
+	double m_collectMinorMultiplier;	//!< Fraction of heap allocated before a minor collection is due.
+	double m_collectStepSize;			//!< Bytes of allocation credited by one incremental step.
+	double m_collectCostPerStep;		//!< Measured collection time per step.
 
 	void destroyContext(ScriptContextLua* context);
 
@@ -135,6 +149,8 @@ private:
 
 	void collectGarbagePartial();
 
+	void collectGarbageBudget();
+
 	void breakDebugger(lua_State* luaState);
 
 	static int classGc(lua_State* luaState);
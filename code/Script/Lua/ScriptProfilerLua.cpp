@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include <cstring>
 #include "Core/Log/Log.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/TString.h"
@@ -24,6 +26,7 @@ ScriptProfilerLua::ScriptProfilerLua(ScriptManagerLua* scriptManager, lua_State*
 ,	m_luaState(luaState)
 {
 	m_timer.reset();
+	resetCollectStatistics();
 }
 
 void ScriptProfilerLua::addListener(IListener* listener)
@@ -52,6 +55,32 @@ void ScriptProfilerLua::notifyCallLeave()
 		listener->callLeave(scriptId, name);
 }
 
+void ScriptProfilerLua::getCollectStatistics(CollectStatistics& outStatistics) const
+{
+	outStatistics = m_collectStatistics;
+}
+
+void ScriptProfilerLua::resetCollectStatistics()
+{
+	std::memset(&m_collectStatistics, 0, sizeof(m_collectStatistics));
+}
+
+void ScriptProfilerLua::measureCollect(double duration, double budget)
+{
+	const double us = duration * 1e6;
+
+	int32_t bin = 0;
+	for (double limit = 1.0; us >= limit && bin < CollectStatistics::HistogramBins - 1; limit *= 2.0)
+		++bin;
+
+	m_collectStatistics.histogram[bin]++;
+	m_collectStatistics.pauseCount++;
+	if (budget > 0.0 && duration > budget)
+		m_collectStatistics.overBudgetCount++;
+	m_collectStatistics.totalDuration += duration;
+	m_collectStatistics.maxDuration = std::max(m_collectStatistics.maxDuration, duration);
+}
+
 void ScriptProfilerLua::hookCallback(lua_State* L, lua_Debug* ar)
 {
 	if (ar->event == LUA_HOOKLINE)
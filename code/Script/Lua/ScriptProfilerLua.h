@@ -38,6 +38,10 @@ public:
 
 	void notifyCallLeave();
 
+	virtual void getCollectStatistics(CollectStatistics& outStatistics) const override final;
+
+	virtual void resetCollectStatistics() override final;
+
 private:
 	friend class ScriptManagerLua;
 
@@ -52,6 +56,9 @@ private:
 	AlignedVector< ProfileStack > m_stack;
 	SmallSet< IListener* > m_listeners;
 	Timer m_timer;
+	CollectStatistics m_collectStatistics;
+
+	void measureCollect(double duration, double budget);
 
 	void hookCallback(lua_State* L, lua_Debug* ar);
 };
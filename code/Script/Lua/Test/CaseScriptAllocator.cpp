@@ -0,0 +1,178 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Core/Class/Any.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Random.h"
+#include "Core/Misc/SafeDestroy.h"
+#include "Script/IScriptBlob.h"
+#include "Script/IScriptContext.h"
+#include "Script/Lua/ScriptAllocatorLua.h"
+#include "Script/Lua/ScriptCompilerLua.h"
+#include "Script/Lua/ScriptManagerLua.h"
+#include "Script/Lua/Test/CaseScriptAllocator.h"
+
+namespace traktor::script::test
+{
+	namespace
+	{
+
+const uint32_t c_slots = 4096;
+const uint32_t c_operations = 200000;
+const uint32_t c_frames = 10;
+const int32_t c_entitiesPerFrame = 2000;
+
+const wchar_t* c_script =
+	L"function update(n)\n"
+	L"	local list = {}\n"
+	L"	for i = 1, n do\n"
+	L"		local e = { x = i, y = i * 2, name = \"entity\" .. i }\n"
+	L"		e.sum = function() return e.x + e.y end\n"
+	L"		list[#list + 1] = e\n"
+	L"	end\n"
+	L"	local sum = 0\n"
+	L"	for _, e in ipairs(list) do sum = sum + e.sum() end\n"
+	L"	return sum\n"
+	L"end\n";
+
+struct Operation
+{
+	uint32_t slot;
+	uint32_t size;	//!< New size of slot, 0 to free.
+};
+
+// Mostly tiny blocks as tables, closures and short strings, few arrays and large strings.
+uint32_t randomSize(Random& random)
+{
+	const double r = random.nextDouble();
+	if (r < 0.7)
+		return 16 + random.next() % 48;
+	else if (r < 0.9)
+		return 64 + random.next() % 192;
+	else if (r < 0.98)
+		return 256 + random.next() % 256;
+	else
+		return 512 + random.next() % 3584;
+}
+
+void createTrace(AlignedVector< Operation >& outOperations)
+{
+	Random random;
+	AlignedVector< uint32_t > sizes(c_slots);
+
+	outOperations.reserve(c_operations + c_slots);
+	for (uint32_t i = 0; i < c_operations; ++i)
+	{
+		const uint32_t slot = random.next() % c_slots;
+		uint32_t size = 0;
+		if (sizes[slot] == 0)
+			size = randomSize(random);
+		else if (random.nextDouble() < 0.3)
+			size = (random.next() & 1) ? std::min< uint32_t >(sizes[slot] * 2, 8192) : randomSize(random);
+		outOperations.push_back({ slot, size });
+		sizes[slot] = size;
+	}
+
+	// Free remaining blocks.
+	for (uint32_t slot = 0; slot < c_slots; ++slot)
+	{
+		if (sizes[slot] != 0)
+			outOperations.push_back({ slot, 0 });
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.script.test.CaseScriptAllocator", 0, CaseScriptAllocator, traktor::test::Case)
+
+void CaseScriptAllocator::run()
+{
+	AlignedVector< Operation > operations;
+	createTrace(operations);
+
+	// Content of blocks must survive being resized, and no blocks may overlap.
+	{
+		ScriptAllocatorLua allocator;
+		AlignedVector< uint8_t* > ptrs(c_slots, nullptr);
+		AlignedVector< uint32_t > sizes(c_slots);
+		uint32_t corruptBlocks = 0;
+		uint32_t misalignedBlocks = 0;
+
+		for (const auto& op : operations)
+		{
+			uint8_t*& ptr = ptrs[op.slot];
+			const uint32_t osize = sizes[op.slot];
+			const uint8_t tag = uint8_t(op.slot * 13 + 1);
+
+			if (ptr)
+			{
+				for (uint32_t i = 0; i < osize; ++i)
+				{
+					if (ptr[i] != tag)
+					{
+						++corruptBlocks;
+						break;
+					}
+				}
+			}
+
+			ptr = (uint8_t*)allocator.reallocate(ptr, osize, op.size);
+			if (ptr)
+			{
+				misalignedBlocks += ((intptr_t)ptr & 15) != 0 ? 1 : 0;
+				std::memset(ptr, tag, op.size);
+			}
+			sizes[op.slot] = op.size;
+		}
+
+		CASE_ASSERT_EQUAL(corruptBlocks, 0u);
+		CASE_ASSERT_EQUAL(misalignedBlocks, 0u);
+
+		// Empty pages are released, only one page is retained per class.
+		AlignedVector< ScriptAllocatorLua::SizeClassStatistics > statistics;
+		allocator.getStatistics(statistics);
+		uint32_t liveBlocks = 0;
+		uint32_t pages = 0;
+		for (const auto& st : statistics)
+		{
+			liveBlocks += st.liveBlocks;
+			pages = std::max(pages, st.pages);
+		}
+		CASE_ASSERT_EQUAL(liveBlocks, 0u);
+		CASE_ASSERT_EQUAL(pages, 1u);
+	}
+
+	// Run script allocating tiny short lived objects each frame.
+	Ref< ScriptCompilerLua > compiler = new ScriptCompilerLua();
+	Ref< ScriptManagerLua > manager = new ScriptManagerLua();
+
+	Ref< IScriptBlob > blob = compiler->compile(L"CaseScriptAllocator", c_script, nullptr);
+	CASE_ASSERT(blob != nullptr);
+
+	Ref< IScriptContext > context = manager->createContext(false);
+	CASE_ASSERT(context != nullptr);
+
+	if (blob && context && context->load(blob))
+	{
+		const Any argv[] = { Any::fromInt32(c_entitiesPerFrame) };
+		for (uint32_t i = 0; i < c_frames; ++i)
+		{
+			const Any sum = context->executeFunction("update", 1, argv);
+			CASE_ASSERT_EQUAL(sum.getInt64(), (int64_t)3 * c_entitiesPerFrame * (c_entitiesPerFrame + 1) / 2);
+			manager->collectGarbage(false);
+		}
+		manager->collectGarbage(true);
+	}
+
+	safeDestroy(context);
+	safeDestroy(manager);
+}
+
+}
@@ -0,0 +1,115 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Core/Class/Any.h"
+#include "Core/Io/StringOutputStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/SafeDestroy.h"
+#include "Script/IScriptBlob.h"
+#include "Script/IScriptContext.h"
+#include "Script/IScriptProfiler.h"
+#include "Script/Lua/ScriptCompilerLua.h"
+#include "Script/Lua/ScriptManagerLua.h"
+#include "Script/Lua/Test/CaseScriptCollect.h"
+
+namespace traktor::script::test
+{
+	namespace
+	{
+
+const uint32_t c_frames = 600;
+const int32_t c_entitiesPerFrame = 2000;
+const uint32_t c_budget = 500;
+
+// Keep a window of recent entities alive so heap has both live data and garbage.
+const wchar_t* c_script =
+	L"local window = {}\n"
+	L"local frame = 0\n"
+	L"function update(n)\n"
+	L"	local list = {}\n"
+	L"	for i = 1, n do\n"
+	L"		local e = { x = i, y = i * 2, name = \"entity\" .. i }\n"
+	L"		e.sum = function() return e.x + e.y end\n"
+	L"		list[#list + 1] = e\n"
+	L"	end\n"
+	L"	frame = frame + 1\n"
+	L"	window[frame % 8] = list\n"
+	L"	return #list\n"
+	L"end\n";
+
+void logCollectStatistics(const wchar_t* title, const IScriptProfiler::CollectStatistics& cs, uint32_t memoryUsage)
+{
+	log::info << L"  " << title << L", " << cs.pauseCount << L" pauses, " << int32_t(cs.totalDuration * 1e6 / std::max< uint32_t >(cs.pauseCount, 1)) << L" us average, " << int32_t(cs.maxDuration * 1e6) << L" us max, " << cs.overBudgetCount << L" over budget, " << (memoryUsage / 1024) << L" KiB heap" << Endl;
+
+	StringOutputStream ss;
+	for (int32_t i = 0; i < IScriptProfiler::CollectStatistics::HistogramBins; ++i)
+		ss << (i > 0 ? L" " : L"") << cs.histogram[i];
+	log::info << L"    histogram " << ss.str() << Endl;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.script.test.CaseScriptCollect", 0, CaseScriptCollect, traktor::test::Case)
+
+void CaseScriptCollect::run()
+{
+	Ref< ScriptCompilerLua > compiler = new ScriptCompilerLua();
+	Ref< IScriptBlob > blob = compiler->compile(L"CaseScriptCollect", c_script, nullptr);
+	CASE_ASSERT(blob != nullptr);
+	if (!blob)
+		return;
+
+	log::info << L"ScriptCollect, " << c_frames << L" frames, budget " << c_budget << L" us" << Endl;
+
+	// First let LUA pace collection, then with budget.
+	for (uint32_t budget : { 0u, c_budget })
+	{
+		Ref< ScriptManagerLua > manager = new ScriptManagerLua();
+		Ref< IScriptProfiler > profiler = manager->createProfiler();
+		CASE_ASSERT(profiler != nullptr);
+
+		manager->setCollectBudget(budget);
+
+		Ref< IScriptContext > context = manager->createContext(false);
+		CASE_ASSERT(context != nullptr);
+
+		if (profiler && context && context->load(blob))
+		{
+			const Any argv[] = { Any::fromInt32(c_entitiesPerFrame) };
+			for (uint32_t i = 0; i < c_frames; ++i)
+			{
+				context->executeFunction("update", 1, argv);
+				manager->collectGarbage(false);
+			}
+
+			ScriptStatistics statistics;
+			manager->getStatistics(statistics);
+
+			IScriptProfiler::CollectStatistics cs;
+			profiler->getCollectStatistics(cs);
+			logCollectStatistics(budget > 0 ? L"budget" : L"generational", cs, statistics.memoryUsage);
+
+			// Generational collector collects while script is running, no pauses recorded.
+			if (budget > 0)
+			{
+				CASE_ASSERT_EQUAL(cs.pauseCount, c_frames);
+
+				// Collector must keep up with allocation; window is roughly 8 x 2000 entities.
+				CASE_ASSERT(statistics.memoryUsage < 64 * 1024 * 1024);
+			}
+			else
+				CASE_ASSERT_EQUAL(cs.pauseCount, (uint32_t)0);
+		}
+
+		safeDestroy(context);
+		safeDestroy(manager);
+	}
+}
+
+}
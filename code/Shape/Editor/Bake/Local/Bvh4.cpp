@@ -0,0 +1,853 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Shape/Editor/Bake/Local/Bvh4.h"
+
+#include "Core/Math/Plane.h"
+#include "Core/Thread/Atomic.h"
+#include "Core/Thread/Job.h"
+#include "Core/Thread/JobManager.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace traktor::shape
+{
+	namespace
+	{
+
+const int32_t c_maxLeafSize = 4;
+const int32_t c_binCount = 16;
+const int32_t c_parallelDepth = 2;		//!< Subtrees below this depth are built in parallel.
+const int32_t c_minParallelCount = 1024;	//!< Subtrees with fewer triangles are built inline.
+const int32_t c_maxStackDepth = 256;
+const int32_t c_maxDepth = (c_maxStackDepth - 4) / 3;	//!< Traversal stack hold at most three siblings per level and four children of deepest node.
+const int32_t c_medianSplitDepth = c_maxDepth - 16;		//!< Median split quarter range at each level thus 16 levels are enough for any 32 bit count.
+const float c_epsilon = 0.00001f;
+const float c_detEpsilon = 1e-12f;
+const float c_maxReciprocal = 1e30f;
+const float c_minPacketCoherence = 0.9f;	//!< Minimum cosine between rays in packet to trace as packet.
+
+/*! Four rays, one in each lane; a single ray is splatted into all lanes. */
+struct Ray4
+{
+	Vector4 ox, oy, oz;
+	Vector4 dx, dy, dz;
+	Vector4 idx, idy, idz;
+};
+
+/*! Four triangles, one in each lane; a single triangle is splatted into all lanes. */
+struct Triangle4
+{
+	Vector4 v0x, v0y, v0z;
+	Vector4 e1x, e1y, e1z;
+	Vector4 e2x, e2y, e2z;
+};
+
+float safeReciprocal(float d)
+{
+	if (std::abs(d) < 1.0f / c_maxReciprocal)
+		return d >= 0.0f ? c_maxReciprocal : -c_maxReciprocal;
+	return 1.0f / d;
+}
+
+Ray4 splatRay(const Vector4& origin, const Vector4& direction)
+{
+	return {
+		Vector4(origin.x()), Vector4(origin.y()), Vector4(origin.z()),
+		Vector4(direction.x()), Vector4(direction.y()), Vector4(direction.z()),
+		Vector4(Scalar(safeReciprocal(direction.x()))), Vector4(Scalar(safeReciprocal(direction.y()))), Vector4(Scalar(safeReciprocal(direction.z())))
+	};
+}
+
+Ray4 transposeRays(const Vector4 origins[4], const Vector4 directions[4])
+{
+	T_MATH_ALIGN16 float o[3][4];
+	T_MATH_ALIGN16 float d[3][4];
+	T_MATH_ALIGN16 float id[3][4];
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		for (int32_t j = 0; j < 3; ++j)
+		{
+			o[j][i] = origins[i][j];
+			d[j][i] = directions[i][j];
+			id[j][i] = safeReciprocal(d[j][i]);
+		}
+	}
+	return {
+		Vector4::loadAligned(o[0]), Vector4::loadAligned(o[1]), Vector4::loadAligned(o[2]),
+		Vector4::loadAligned(d[0]), Vector4::loadAligned(d[1]), Vector4::loadAligned(d[2]),
+		Vector4::loadAligned(id[0]), Vector4::loadAligned(id[1]), Vector4::loadAligned(id[2])
+	};
+}
+
+Triangle4 loadTriangles(const float v0[3][4], const float e1[3][4], const float e2[3][4])
+{
+	return {
+		Vector4::loadAligned(v0[0]), Vector4::loadAligned(v0[1]), Vector4::loadAligned(v0[2]),
+		Vector4::loadAligned(e1[0]), Vector4::loadAligned(e1[1]), Vector4::loadAligned(e1[2]),
+		Vector4::loadAligned(e2[0]), Vector4::loadAligned(e2[1]), Vector4::loadAligned(e2[2])
+	};
+}
+
+Triangle4 splatTriangle(const float v0[3][4], const float e1[3][4], const float e2[3][4], int32_t lane)
+{
+	return {
+		Vector4(Scalar(v0[0][lane])), Vector4(Scalar(v0[1][lane])), Vector4(Scalar(v0[2][lane])),
+		Vector4(Scalar(e1[0][lane])), Vector4(Scalar(e1[1][lane])), Vector4(Scalar(e1[2][lane])),
+		Vector4(Scalar(e2[0][lane])), Vector4(Scalar(e2[1][lane])), Vector4(Scalar(e2[2][lane]))
+	};
+}
+
+/*! Slab test of one ray against all four children; return margin which is negative for children missed. */
+Vector4 intersectChildren(const float bounds[6][4], const Ray4& ray, const Vector4& farT, Vector4& outNearT)
+{
+	const Vector4 t0x = (Vector4::loadAligned(bounds[0]) - ray.ox) * ray.idx;
+	const Vector4 t0y = (Vector4::loadAligned(bounds[1]) - ray.oy) * ray.idy;
+	const Vector4 t0z = (Vector4::loadAligned(bounds[2]) - ray.oz) * ray.idz;
+	const Vector4 t1x = (Vector4::loadAligned(bounds[3]) - ray.ox) * ray.idx;
+	const Vector4 t1y = (Vector4::loadAligned(bounds[4]) - ray.oy) * ray.idy;
+	const Vector4 t1z = (Vector4::loadAligned(bounds[5]) - ray.oz) * ray.idz;
+	outNearT = max(max(min(t0x, t1x), min(t0y, t1y)), max(min(t0z, t1z), Vector4::zero()));
+	return min(min(max(t0x, t1x), max(t0y, t1y)), min(max(t0z, t1z), farT)) - outNearT;
+}
+
+/*! Conservative bounds of four rays, all having same direction signs. */
+struct RayInterval
+{
+	int32_t nearRow[3];
+	int32_t farRow[3];
+	Vector4 nearOrigin[3];
+	Vector4 farOrigin[3];
+	Vector4 minReciprocal[3];
+	Vector4 maxReciprocal[3];
+};
+
+/*! Calculate interval of packet; return false if packet isn't coherent, it must then be traced ray by ray. */
+bool calculateInterval(const Ray4& ray, RayInterval& outInterval)
+{
+	// Interval of diverging rays is too loose to be worth traversing.
+	const Vector4 cosAngle = ray.dx * Vector4(ray.dx.x()) + ray.dy * Vector4(ray.dy.x()) + ray.dz * Vector4(ray.dz.x());
+	if (cosAngle.min() < c_minPacketCoherence)
+		return false;
+
+	const Vector4* origins[] = { &ray.ox, &ray.oy, &ray.oz };
+	const Vector4* directions[] = { &ray.dx, &ray.dy, &ray.dz };
+	const Vector4* reciprocals[] = { &ray.idx, &ray.idy, &ray.idz };
+
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		const Vector4 originMin = Vector4(origins[i]->min());
+		const Vector4 originMax = Vector4(origins[i]->max());
+		if (directions[i]->min() >= 0.0f)
+		{
+			outInterval.nearRow[i] = i;
+			outInterval.farRow[i] = i + 3;
+			outInterval.nearOrigin[i] = originMax;
+			outInterval.farOrigin[i] = originMin;
+		}
+		else if (directions[i]->max() < 0.0f)
+		{
+			outInterval.nearRow[i] = i + 3;
+			outInterval.farRow[i] = i;
+			outInterval.nearOrigin[i] = originMin;
+			outInterval.farOrigin[i] = originMax;
+		}
+		else
+			return false;
+
+		outInterval.minReciprocal[i] = Vector4(reciprocals[i]->min());
+		outInterval.maxReciprocal[i] = Vector4(reciprocals[i]->max());
+	}
+
+	return true;
+}
+
+/*! Slab test of packet interval against all four children; return margin which is negative for children missed by all rays. */
+Vector4 intersectChildren(const float bounds[6][4], const RayInterval& interval, const Vector4& farT, Vector4& outNearT)
+{
+	Vector4 nearT = Vector4::zero();
+	Vector4 childFarT = farT;
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		const Vector4 nearPlane = Vector4::loadAligned(bounds[interval.nearRow[i]]) - interval.nearOrigin[i];
+		const Vector4 farPlane = Vector4::loadAligned(bounds[interval.farRow[i]]) - interval.farOrigin[i];
+		nearT = max(nearT, min(nearPlane * interval.minReciprocal[i], nearPlane * interval.maxReciprocal[i]));
+		childFarT = min(childFarT, max(farPlane * interval.minReciprocal[i], farPlane * interval.maxReciprocal[i]));
+	}
+	outNearT = nearT;
+	return childFarT - nearT;
+}
+
+/*! Moller-Trumbore intersection, lane by lane; return margin which is negative for lanes missing. */
+Vector4 intersectTriangles(const Triangle4& tri, const Ray4& ray, const Vector4& farT, Vector4& outT)
+{
+	const Vector4 px = ray.dy * tri.e2z - ray.dz * tri.e2y;
+	const Vector4 py = ray.dz * tri.e2x - ray.dx * tri.e2z;
+	const Vector4 pz = ray.dx * tri.e2y - ray.dy * tri.e2x;
+	const Vector4 det = tri.e1x * px + tri.e1y * py + tri.e1z * pz;
+
+	// Replace determinant of parallel lanes to avoid NaN, they are rejected by margin anyway.
+	const Vector4 detMargin = det.absolute() - Vector4(Scalar(c_detEpsilon));
+	const Vector4 invDet = Vector4::one() / select(detMargin, Vector4(Scalar(c_maxReciprocal)), det);
+
+	const Vector4 tx = ray.ox - tri.v0x;
+	const Vector4 ty = ray.oy - tri.v0y;
+	const Vector4 tz = ray.oz - tri.v0z;
+	const Vector4 u = (tx * px + ty * py + tz * pz) * invDet;
+
+	const Vector4 qx = ty * tri.e1z - tz * tri.e1y;
+	const Vector4 qy = tz * tri.e1x - tx * tri.e1z;
+	const Vector4 qz = tx * tri.e1y - ty * tri.e1x;
+	const Vector4 v = (ray.dx * qx + ray.dy * qy + ray.dz * qz) * invDet;
+
+	outT = (tri.e2x * qx + tri.e2y * qy + tri.e2z * qz) * invDet;
+
+	return min(
+		min(min(detMargin, u), min(v, Vector4::one() - u - v)),
+		min(outT - Vector4(Scalar(c_epsilon)), farT - outT)
+	);
+}
+
+float surfaceArea(const Aabb3& box)
+{
+	if (box.empty())
+		return 0.0f;
+	const Vector4 e = box.mx - box.mn;
+	return 2.0f * (e.x() * e.y() + e.y() * e.z() + e.z() * e.x());
+}
+
+/*! Split range of triangles in two using binned SAH; return index of first triangle in second half. */
+int32_t splitRange(const Aabb3* bounds, const Vector4* centroids, int32_t* indices, int32_t begin, int32_t end)
+{
+	Aabb3 centroidBounds;
+	for (int32_t i = begin; i < end; ++i)
+		centroidBounds.contain(centroids[indices[i]]);
+
+	const Vector4 extent = centroidBounds.mx - centroidBounds.mn;
+	const int32_t count = end - begin;
+
+	float bestCost = std::numeric_limits< float >::max();
+	int32_t bestAxis = -1;
+	int32_t bestBin = -1;
+	float bestScale = 0.0f;
+
+	for (int32_t axis = 0; axis < 3; ++axis)
+	{
+		if (extent[axis] <= FUZZY_EPSILON)
+			continue;
+
+		const float mn = centroidBounds.mn[axis];
+		const float scale = c_binCount / extent[axis];
+
+		Aabb3 binBounds[c_binCount];
+		int32_t binCounts[c_binCount] = { 0 };
+		for (int32_t i = begin; i < end; ++i)
+		{
+			const int32_t bin = std::min< int32_t >((int32_t)((centroids[indices[i]][axis] - mn) * scale), c_binCount - 1);
+			binBounds[bin].contain(bounds[indices[i]]);
+			binCounts[bin]++;
+		}
+
+		// Sweep from right to get cost of each right half.
+		float rightCost[c_binCount];
+		Aabb3 rightBounds;
+		int32_t rightCount = 0;
+		for (int32_t bin = c_binCount - 1; bin > 0; --bin)
+		{
+			rightBounds.contain(binBounds[bin]);
+			rightCount += binCounts[bin];
+			rightCost[bin] = surfaceArea(rightBounds) * rightCount;
+		}
+
+		// Sweep from left, splitting after each bin.
+		Aabb3 leftBounds;
+		int32_t leftCount = 0;
+		for (int32_t bin = 0; bin < c_binCount - 1; ++bin)
+		{
+			leftBounds.contain(binBounds[bin]);
+			leftCount += binCounts[bin];
+			if (leftCount <= 0 || leftCount >= count)
+				continue;
+
+			const float cost = surfaceArea(leftBounds) * leftCount + rightCost[bin + 1];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = bin;
+				bestScale = scale;
+			}
+		}
+	}
+
+	// All centroids are coincident; any split is as good as another.
+	if (bestAxis < 0)
+		return (begin + end) / 2;
+
+	const float mn = centroidBounds.mn[bestAxis];
+	const int32_t* mid = std::partition(indices + begin, indices + end, [&](int32_t index) {
+		return std::min< int32_t >((int32_t)((centroids[index][bestAxis] - mn) * bestScale), c_binCount - 1) <= bestBin;
+	});
+	return (int32_t)(mid - indices);
+}
+
+/*! Split range of triangles in two halves along largest axis of centroids; return index of first triangle in second half. */
+int32_t splitMedian(const Vector4* centroids, int32_t* indices, int32_t begin, int32_t end)
+{
+	Aabb3 centroidBounds;
+	for (int32_t i = begin; i < end; ++i)
+		centroidBounds.contain(centroids[indices[i]]);
+
+	const Vector4 extent = centroidBounds.mx - centroidBounds.mn;
+	const int32_t axis = majorAxis3(extent);
+
+	const int32_t mid = (begin + end) / 2;
+	std::nth_element(indices + begin, indices + mid, indices + end, [&](int32_t lh, int32_t rh) {
+		return centroids[lh][axis] < centroids[rh][axis];
+	});
+	return mid;
+}
+
+	}
+
+struct Bvh4::BuildContext
+{
+	struct Triangle
+	{
+		Vector4 v0;
+		Vector4 e1;
+		Vector4 e2;
+		Vector4 normal;
+		int32_t index;
+	};
+
+	AlignedVector< Triangle > triangles;
+	AlignedVector< Aabb3 > bounds;
+	AlignedVector< Vector4 > centroids;
+	AlignedVector< int32_t > indices;
+};
+
+void Bvh4::build(const AlignedVector< Winding3 >& polygons)
+{
+	BuildContext context;
+
+	// Triangulate polygons as fans.
+	for (uint32_t i = 0; i < polygons.size(); ++i)
+	{
+		const auto& points = polygons[i].get();
+		if (points.size() < 3)
+			continue;
+
+		Plane plane;
+		if (!polygons[i].getPlane(plane))
+			continue;
+
+		for (uint32_t j = 1; j < points.size() - 1; ++j)
+		{
+			auto& triangle = context.triangles.push_back();
+			triangle.v0 = points[0].xyz1();
+			triangle.e1 = (points[j] - points[0]).xyz0();
+			triangle.e2 = (points[j + 1] - points[0]).xyz0();
+			triangle.normal = plane.normal();
+			triangle.index = (int32_t)i;
+
+			auto& box = context.bounds.push_back();
+			box.contain(points[0].xyz1());
+			box.contain(points[j].xyz1());
+			box.contain(points[j + 1].xyz1());
+			context.centroids.push_back(box.getCenter());
+		}
+	}
+
+	const int32_t triangleCount = (int32_t)context.triangles.size();
+
+	m_boundingBox = Aabb3();
+	for (const auto& box : context.bounds)
+		m_boundingBox.contain(box);
+
+	m_nodes.resize(0);
+	m_blocks.resize(0);
+	m_nodeCount = 0;
+	m_blockCount = 0;
+	m_triangleCount = (uint32_t)triangleCount;
+
+	if (triangleCount <= 0)
+		return;
+
+	context.indices.resize(triangleCount);
+	for (int32_t i = 0; i < triangleCount; ++i)
+		context.indices[i] = i;
+
+	// Every node except root has at least two children, and every leaf
+	// at least one triangle, thus there cannot be more nodes nor leaves
+	// than triangles. Allocate up front so subtrees can be built concurrently.
+	m_nodes.resize(triangleCount);
+	m_blocks.resize(triangleCount);
+
+	// Build top levels serially, collecting large subtrees which are
+	// then built in parallel; each subtree own it's range of indices.
+	AlignedVector< Subtree > deferred;
+	buildNode(context, allocNode(), 0, triangleCount, 0, &deferred);
+
+	if (!deferred.empty())
+	{
+		AlignedVector< Job::task_t > jobs;
+		jobs.reserve(deferred.size());
+		for (const auto& subtree : deferred)
+		{
+			jobs.push_back([&, subtree]() {
+				buildNode(context, subtree.node, subtree.begin, subtree.end, c_parallelDepth, nullptr);
+			});
+		}
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+	}
+
+	m_nodes.resize(m_nodeCount);
+	m_blocks.resize(m_blockCount);
+}
+
+bool Bvh4::queryClosestIntersection(const Vector4& origin, const Vector4& direction, float maxDistance, QueryResult& outResult) const
+{
+	struct StackEntry
+	{
+		int32_t node;
+		float nearT;
+	};
+
+	if (m_nodeCount <= 0)
+		return false;
+
+	const Ray4 ray = splatRay(origin, direction);
+
+	StackEntry stack[c_maxStackDepth];
+	int32_t stackCount = 0;
+	stack[stackCount++] = { 0, 0.0f };
+
+	T_MATH_ALIGN16 float margins[4];
+	T_MATH_ALIGN16 float nearTs[4];
+	T_MATH_ALIGN16 float hitMargins[4];
+	T_MATH_ALIGN16 float ts[4];
+	float farT = maxDistance;
+	int32_t hit = -1;
+
+	while (stackCount > 0)
+	{
+		const StackEntry entry = stack[--stackCount];
+		if (entry.nearT > farT)
+			continue;
+
+		const Node& node = m_nodes[entry.node];
+
+		Vector4 nearT;
+		intersectChildren(node.bounds, ray, Vector4(Scalar(farT)), nearT).storeAligned(margins);
+		nearT.storeAligned(nearTs);
+
+		// Intersect leaves immediately, collect nodes sorted farthest first.
+		int32_t order[4];
+		int32_t orderCount = 0;
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			if (margins[i] < 0.0f || node.child[i] < 0)
+				continue;
+
+			if (node.count[i] > 0)
+			{
+				const TriangleBlock& block = m_blocks[node.child[i]];
+
+				Vector4 t;
+				const Vector4 margin = intersectTriangles(loadTriangles(block.v0, block.e1, block.e2), ray, Vector4(Scalar(farT)), t);
+				if (margin.max() < 0.0f)
+					continue;
+
+				margin.storeAligned(hitMargins);
+				t.storeAligned(ts);
+				for (int32_t j = 0; j < node.count[i]; ++j)
+				{
+					if (hitMargins[j] >= 0.0f && ts[j] <= farT)
+					{
+						farT = ts[j];
+						hit = node.child[i] * 4 + j;
+					}
+				}
+				continue;
+			}
+
+			int32_t k = orderCount++;
+			for (; k > 0 && nearTs[order[k - 1]] < nearTs[i]; --k)
+				order[k] = order[k - 1];
+			order[k] = i;
+		}
+
+		T_ASSERT(stackCount + orderCount <= c_maxStackDepth);
+		for (int32_t i = 0; i < orderCount; ++i)
+			stack[stackCount++] = { node.child[order[i]], nearTs[order[i]] };
+	}
+
+	if (hit < 0)
+		return false;
+
+	resolve(origin, direction, hit, farT, outResult);
+	return true;
+}
+
+bool Bvh4::queryAnyIntersection(const Vector4& origin, const Vector4& direction, float maxDistance) const
+{
+	if (m_nodeCount <= 0)
+		return false;
+
+	const Ray4 ray = splatRay(origin, direction);
+	const Vector4 farT = Vector4(Scalar(maxDistance));
+
+	int32_t stack[c_maxStackDepth];
+	int32_t stackCount = 0;
+	stack[stackCount++] = 0;
+
+	T_MATH_ALIGN16 float margins[4];
+
+	while (stackCount > 0)
+	{
+		const Node& node = m_nodes[stack[--stackCount]];
+
+		Vector4 nearT;
+		intersectChildren(node.bounds, ray, farT, nearT).storeAligned(margins);
+
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			if (margins[i] < 0.0f || node.child[i] < 0)
+				continue;
+
+			if (node.count[i] > 0)
+			{
+				const TriangleBlock& block = m_blocks[node.child[i]];
+
+				// Unused lanes are degenerate and never intersected.
+				Vector4 t;
+				if (intersectTriangles(loadTriangles(block.v0, block.e1, block.e2), ray, farT, t).max() >= 0.0f)
+					return true;
+			}
+			else
+			{
+				T_ASSERT(stackCount < c_maxStackDepth);
+				stack[stackCount++] = node.child[i];
+			}
+		}
+	}
+
+	return false;
+}
+
+uint32_t Bvh4::queryClosestIntersection4(const Vector4 origins[4], const Vector4 directions[4], float maxDistance, QueryResult outResults[4]) const
+{
+	struct StackEntry
+	{
+		int32_t node;
+		float nearT;
+	};
+
+	for (int32_t i = 0; i < 4; ++i)
+		outResults[i].index = -1;
+
+	if (m_nodeCount <= 0)
+		return 0;
+
+	const Ray4 ray = transposeRays(origins, directions);
+
+	RayInterval interval;
+	if (!calculateInterval(ray, interval))
+	{
+		uint32_t mask = 0;
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			if (queryClosestIntersection(origins[i], directions[i], maxDistance, outResults[i]))
+				mask |= 1 << i;
+		}
+		return mask;
+	}
+
+	StackEntry stack[c_maxStackDepth];
+	int32_t stackCount = 0;
+	stack[stackCount++] = { 0, 0.0f };
+
+	T_MATH_ALIGN16 float margins[4];
+	T_MATH_ALIGN16 float nearTs[4];
+	T_MATH_ALIGN16 float distances[4];
+	Vector4 farT = Vector4(Scalar(maxDistance));
+	int32_t hits[4] = { -1, -1, -1, -1 };
+
+	while (stackCount > 0)
+	{
+		const StackEntry entry = stack[--stackCount];
+		const Scalar packetFarT = farT.max();
+		if (entry.nearT > packetFarT)
+			continue;
+
+		const Node& node = m_nodes[entry.node];
+
+		Vector4 nearT;
+		intersectChildren(node.bounds, interval, Vector4(packetFarT), nearT).storeAligned(margins);
+		nearT.storeAligned(nearTs);
+
+		int32_t order[4];
+		int32_t orderCount = 0;
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			if (margins[i] < 0.0f || node.child[i] < 0)
+				continue;
+
+			if (node.count[i] > 0)
+			{
+				const TriangleBlock& block = m_blocks[node.child[i]];
+				for (int32_t j = 0; j < node.count[i]; ++j)
+				{
+					Vector4 t;
+					const Vector4 hitMargin = intersectTriangles(splatTriangle(block.v0, block.e1, block.e2, j), ray, farT, t);
+					if (hitMargin.max() < 0.0f)
+						continue;
+
+					farT = select(hitMargin, farT, t);
+
+					T_MATH_ALIGN16 float hitMargins[4];
+					hitMargin.storeAligned(hitMargins);
+					for (int32_t k = 0; k < 4; ++k)
+					{
+						if (hitMargins[k] >= 0.0f)
+							hits[k] = node.child[i] * 4 + j;
+					}
+				}
+				continue;
+			}
+
+			int32_t k = orderCount++;
+			for (; k > 0 && nearTs[order[k - 1]] < nearTs[i]; --k)
+				order[k] = order[k - 1];
+			order[k] = i;
+		}
+
+		T_ASSERT(stackCount + orderCount <= c_maxStackDepth);
+		for (int32_t i = 0; i < orderCount; ++i)
+			stack[stackCount++] = { node.child[order[i]], nearTs[order[i]] };
+	}
+
+	farT.storeAligned(distances);
+
+	uint32_t mask = 0;
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		if (hits[i] < 0)
+			continue;
+
+		resolve(origins[i], directions[i], hits[i], distances[i], outResults[i]);
+		mask |= 1 << i;
+	}
+	return mask;
+}
+
+uint32_t Bvh4::queryAnyIntersection4(const Vector4 origins[4], const Vector4 directions[4], const float maxDistances[4]) const
+{
+	if (m_nodeCount <= 0)
+		return 0;
+
+	const Ray4 ray = transposeRays(origins, directions);
+
+	RayInterval interval;
+	if (!calculateInterval(ray, interval))
+	{
+		uint32_t mask = 0;
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			if (maxDistances[i] > 0.0f && queryAnyIntersection(origins[i], directions[i], maxDistances[i]))
+				mask |= 1 << i;
+		}
+		return mask;
+	}
+
+	int32_t stack[c_maxStackDepth];
+	int32_t stackCount = 0;
+	stack[stackCount++] = 0;
+
+	T_MATH_ALIGN16 float margins[4];
+	Vector4 farT = Vector4::loadUnaligned(maxDistances);
+	uint32_t mask = 0;
+
+	while (stackCount > 0)
+	{
+		const Node& node = m_nodes[stack[--stackCount]];
+
+		Vector4 nearT;
+		intersectChildren(node.bounds, interval, Vector4(farT.max()), nearT).storeAligned(margins);
+
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			if (margins[i] < 0.0f || node.child[i] < 0)
+				continue;
+
+			if (node.count[i] > 0)
+			{
+				const TriangleBlock& block = m_blocks[node.child[i]];
+				for (int32_t j = 0; j < node.count[i]; ++j)
+				{
+					Vector4 t;
+					const Vector4 hitMargin = intersectTriangles(splatTriangle(block.v0, block.e1, block.e2, j), ray, farT, t);
+					if (hitMargin.max() < 0.0f)
+						continue;
+
+					// Rays which has hit anything are disabled by a negative far distance.
+					farT = select(hitMargin, farT, Vector4(Scalar(-1.0f)));
+
+					T_MATH_ALIGN16 float hitMargins[4];
+					hitMargin.storeAligned(hitMargins);
+					for (int32_t k = 0; k < 4; ++k)
+					{
+						if (hitMargins[k] >= 0.0f)
+							mask |= 1 << k;
+					}
+				}
+
+				// Done when all rays has been disabled.
+				if (farT.max() < 0.0f)
+					return mask;
+			}
+			else
+			{
+				T_ASSERT(stackCount < c_maxStackDepth);
+				stack[stackCount++] = node.child[i];
+			}
+		}
+	}
+
+	return mask;
+}
+
+int32_t Bvh4::allocNode()
+{
+	const int32_t index = Atomic::increment(m_nodeCount) - 1;
+	T_FATAL_ASSERT(index < (int32_t)m_nodes.size());
+	return index;
+}
+
+int32_t Bvh4::allocBlock()
+{
+	const int32_t index = Atomic::increment(m_blockCount) - 1;
+	T_FATAL_ASSERT(index < (int32_t)m_blocks.size());
+	return index;
+}
+
+void Bvh4::buildNode(BuildContext& context, int32_t nodeIndex, int32_t begin, int32_t end, int32_t depth, AlignedVector< Subtree >* outDeferred)
+{
+	// Split range into at most four children, always splitting largest remaining range.
+	int32_t ranges[4][2] = { { begin, end } };
+	int32_t rangeCount = 1;
+	while (rangeCount < 4)
+	{
+		int32_t largest = -1;
+		for (int32_t i = 0; i < rangeCount; ++i)
+		{
+			const int32_t count = ranges[i][1] - ranges[i][0];
+			if (count > c_maxLeafSize && (largest < 0 || count > ranges[largest][1] - ranges[largest][0]))
+				largest = i;
+		}
+		if (largest < 0)
+			break;
+
+		// Deep nodes are split at median so depth, and thus traversal stack, is bounded
+		// even if SAH keep splitting off only a few triangles.
+		const int32_t mid = depth < c_medianSplitDepth ?
+			splitRange(
+				context.bounds.c_ptr(),
+				context.centroids.c_ptr(),
+				context.indices.ptr(),
+				ranges[largest][0],
+				ranges[largest][1]
+			) :
+			splitMedian(
+				context.centroids.c_ptr(),
+				context.indices.ptr(),
+				ranges[largest][0],
+				ranges[largest][1]
+			);
+
+		ranges[rangeCount][0] = mid;
+		ranges[rangeCount][1] = ranges[largest][1];
+		ranges[largest][1] = mid;
+		++rangeCount;
+	}
+
+	Node& node = m_nodes[nodeIndex];
+	for (int32_t i = 0; i < 4; ++i)
+	{
+		if (i >= rangeCount)
+		{
+			for (int32_t j = 0; j < 6; ++j)
+				node.bounds[j][i] = 0.0f;
+			node.child[i] = -1;
+			node.count[i] = 0;
+			continue;
+		}
+
+		const int32_t rangeBegin = ranges[i][0];
+		const int32_t rangeEnd = ranges[i][1];
+
+		Aabb3 box;
+		for (int32_t j = rangeBegin; j < rangeEnd; ++j)
+			box.contain(context.bounds[context.indices[j]]);
+
+		for (int32_t j = 0; j < 3; ++j)
+		{
+			node.bounds[j][i] = box.mn[j];
+			node.bounds[j + 3][i] = box.mx[j];
+		}
+
+		const int32_t count = rangeEnd - rangeBegin;
+		if (count <= c_maxLeafSize)
+		{
+			const int32_t blockIndex = allocBlock();
+			TriangleBlock& block = m_blocks[blockIndex];
+			for (int32_t j = 0; j < 4; ++j)
+			{
+				const bool used = (j < count);
+				const BuildContext::Triangle& triangle = context.triangles[context.indices[used ? rangeBegin + j : rangeBegin]];
+				for (int32_t k = 0; k < 3; ++k)
+				{
+					block.v0[k][j] = used ? (float)triangle.v0[k] : 0.0f;
+					block.e1[k][j] = used ? (float)triangle.e1[k] : 0.0f;
+					block.e2[k][j] = used ? (float)triangle.e2[k] : 0.0f;
+					block.normal[k][j] = used ? (float)triangle.normal[k] : 0.0f;
+				}
+				block.index[j] = used ? triangle.index : -1;
+			}
+			node.child[i] = blockIndex;
+			node.count[i] = count;
+			continue;
+		}
+
+		// Traversal stack cannot hold deeper trees; median split guarantee this never happen.
+		T_FATAL_ASSERT(depth + 1 < c_maxDepth);
+
+		const int32_t childIndex = allocNode();
+		node.child[i] = childIndex;
+		node.count[i] = 0;
+
+		if (outDeferred != nullptr && depth + 1 >= c_parallelDepth && count >= c_minParallelCount)
+			outDeferred->push_back({ childIndex, rangeBegin, rangeEnd });
+		else
+			buildNode(context, childIndex, rangeBegin, rangeEnd, depth + 1, outDeferred);
+	}
+}
+
+void Bvh4::resolve(const Vector4& origin, const Vector4& direction, int32_t hit, float distance, QueryResult& outResult) const
+{
+	const TriangleBlock& block = m_blocks[hit / 4];
+	const int32_t lane = hit % 4;
+	outResult.index = block.index[lane];
+	outResult.distance = distance;
+	outResult.position = (origin + direction * Scalar(distance)).xyz1();
+	outResult.normal = Vector4(block.normal[0][lane], block.normal[1][lane], block.normal[2][lane], 0.0f);
+}
+
+}
@@ -0,0 +1,143 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Aabb3.h"
+#include "Core/Math/Winding3.h"
+
+namespace traktor::shape
+{
+
+/*! Four wide bounding volume hierarchy of triangles.
+ * \ingroup Illuminate
+ *
+ * Built using binned "surface area heuristic", subtrees
+ * below the top levels are built in parallel. Each node
+ * keep bounds of all four children as structure-of-arrays
+ * so a ray is tested against all children at once, likewise
+ * each leaf keep up to four triangles.
+ *
+ * Packet queries trace four coherent rays together, each
+ * ray in a lane, thus nodes and triangles are fetched once
+ * per packet instead of once per ray.
+ *
+ * Queries do not modify the tree and are thread safe.
+ */
+class Bvh4
+{
+public:
+	struct QueryResult
+	{
+		int32_t index = -1;		//!< Index of polygon hit, -1 if nothing hit.
+		float distance = 0.0f;
+		Vector4 position;
+		Vector4 normal;
+	};
+
+	/*! Build tree from a set of polygons.
+	 *
+	 * Polygons are triangulated as fans, results
+	 * report index of polygon and not triangle.
+	 *
+	 * \param polygons Polygon set.
+	 */
+	void build(const AlignedVector< Winding3 >& polygons);
+
+	/*! Query for closest intersection.
+	 *
+	 * \param origin Ray origin.
+	 * \param direction Ray direction.
+	 * \param maxDistance Intersection must occur prior to this distance from origin.
+	 * \param outResult Intersection result.
+	 * \return True if any intersection found.
+	 */
+	bool queryClosestIntersection(const Vector4& origin, const Vector4& direction, float maxDistance, QueryResult& outResult) const;
+
+	/*! Query for any intersection.
+	 *
+	 * \param origin Ray origin.
+	 * \param direction Ray direction.
+	 * \param maxDistance Intersection must occur prior to this distance from origin.
+	 * \return True if any intersection found.
+	 */
+	bool queryAnyIntersection(const Vector4& origin, const Vector4& direction, float maxDistance) const;
+
+	/*! Query for closest intersection of a packet of four rays.
+	 *
+	 * \param origins Ray origins.
+	 * \param directions Ray directions.
+	 * \param maxDistance Intersection must occur prior to this distance from origin.
+	 * \param outResults Intersection results, index is -1 for rays not hitting anything.
+	 * \return Mask of rays which hit something, bit N set if ray N hit.
+	 */
+	uint32_t queryClosestIntersection4(const Vector4 origins[4], const Vector4 directions[4], float maxDistance, QueryResult outResults[4]) const;
+
+	/*! Query for any intersection of a packet of four rays.
+	 *
+	 * \param origins Ray origins.
+	 * \param directions Ray directions.
+	 * \param maxDistances Intersection must occur prior to this distance from origin, one per ray.
+	 * \return Mask of rays which hit something, bit N set if ray N hit.
+	 */
+	uint32_t queryAnyIntersection4(const Vector4 origins[4], const Vector4 directions[4], const float maxDistances[4]) const;
+
+	/*! Get bounding box. */
+	const Aabb3& getBoundingBox() const { return m_boundingBox; }
+
+	/*! Get number of nodes. */
+	uint32_t getNodeCount() const { return (uint32_t)m_nodeCount; }
+
+	/*! Get number of triangles. */
+	uint32_t getTriangleCount() const { return m_triangleCount; }
+
+private:
+	struct Node
+	{
+		float bounds[6][4];	//!< Min xyz and max xyz, each row contain all four children.
+		int32_t child[4];	//!< Index of child node, or triangle block if leaf, -1 if unused.
+		int32_t count[4];	//!< Number of triangles in leaf, 0 if child is a node.
+	};
+
+	/*! Triangles of a leaf, as structure-of-arrays; unused lanes are degenerate. */
+	struct TriangleBlock
+	{
+		float v0[3][4];
+		float e1[3][4];
+		float e2[3][4];
+		float normal[3][4];
+		int32_t index[4];
+	};
+
+	struct BuildContext;
+
+	struct Subtree
+	{
+		int32_t node;
+		int32_t begin;
+		int32_t end;
+	};
+
+	AlignedVector< Node > m_nodes;
+	AlignedVector< TriangleBlock > m_blocks;
+	Aabb3 m_boundingBox;
+	int32_t m_nodeCount = 0;
+	int32_t m_blockCount = 0;
+	uint32_t m_triangleCount = 0;
+
+	int32_t allocNode();
+
+	int32_t allocBlock();
+
+	void buildNode(BuildContext& context, int32_t nodeIndex, int32_t begin, int32_t end, int32_t depth, AlignedVector< Subtree >* outDeferred);
+
+	void resolve(const Vector4& origin, const Vector4& direction, int32_t hit, float distance, QueryResult& outResult) const;
+};
+
+}
@@ -1,47 +1,60 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022-2024 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
-#include "Core/Thread/Job.h"
-#include "Core/Thread/JobManager.h"
+#include "Core/Math/Quasirandom.h"
+#include "Core/Misc/Align.h"
 #include "Drawing/Image.h"
 #include "Drawing/PixelFormat.h"
+#include "Render/SH/SHCoeffs.h"
+#include "Render/SH/SHEngine.h"
+#include "Render/SH/SHFunction.h"
 #include "Shape/Editor/Bake/GBuffer.h"
 #include "Shape/Editor/Bake/BakeOperationData.h"
+#include "Shape/Editor/Bake/IProbe.h"
 #include "Shape/Editor/Bake/Local/RayTracerLocal.h"
 
+#include <algorithm>
+#include <functional>
+
 namespace traktor::shape
 {
 	namespace
 	{
 
-const Scalar p(1.0f / (2.0f * PI));
+const Scalar c_emissiveBoost(2.0f);
 const Scalar c_epsilonOffset(0.1f);
 
-// class WrappedSHFunction : public render::SHFunction
-// {
-// public:
-// 	WrappedSHFunction(const RayTracer& tracer, RayTracer::Context* tracerContext, const Vector4& origin)
-// 	:	m_tracer(tracer)
-// 	,	m_tracerContext(tracerContext)
-// 	,	m_origin(origin)
-// 	{
-// 	}
-
-// 	virtual Vector4 evaluate(float phi, float theta, const Vector4& unit) const override final
-// 	{
-// 		return m_tracer.traceIndirect(m_tracerContext, m_origin, unit);
-// 	}
-
-// private:
-// 	const RayTracer& m_tracer;
-// 	Ref< RayTracer::Context > m_tracerContext;
-// 	Vector4 m_origin;
-// };
+class WrappedSHFunction : public render::SHFunction
+{
+public:
+	explicit WrappedSHFunction(const std::function< Vector4(const Vector4&) >& fn)
+	:	m_fn(fn)
+	{
+	}
+
+	virtual Vector4 evaluate(const Polar& direction) const override final
+	{
+		return m_fn(direction.toUnitCartesian());
+	}
+
+private:
+	std::function< Vector4(const Vector4&) > m_fn;
+};
+
+uint32_t part1By1(uint32_t n)
+{
+	n &= 0x0000ffff;
+	n = (n | (n << 8)) & 0x00ff00ff;
+	n = (n | (n << 4)) & 0x0f0f0f0f;
+	n = (n | (n << 2)) & 0x33333333;
+	n = (n | (n << 1)) & 0x55555555;
+	return n;
+}
 
 Scalar attenuation(const Scalar& distance)
 {
@@ -62,21 +75,44 @@ T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.shape.RayTracerLocal", 0, RayTracerLoca
 bool RayTracerLocal::create(const BakeOperationData* configuration)
 {
 	m_configuration = configuration;
-    m_maxDistance = 100.0f;
-    return true;
+	m_maxDistance = 100.0f;
+
+	// Order hemisphere samples along a Morton curve of their Hammersley coordinates;
+	// consecutive samples then have similar directions and trace better as packets.
+	const uint32_t sampleCount = alignUp(m_configuration->getSecondarySampleCount(), 4);
+	AlignedVector< uint32_t > keys(sampleCount);
+	m_sampleOrder.resize(sampleCount);
+	for (uint32_t i = 0; i < sampleCount; ++i)
+	{
+		const Vector2 uv = Quasirandom::hammersley(i, sampleCount);
+		keys[i] = part1By1((uint32_t)(uv.x * 65535.0f)) | (part1By1((uint32_t)(uv.y * 65535.0f)) << 1);
+		m_sampleOrder[i] = i;
+	}
+	std::sort(m_sampleOrder.begin(), m_sampleOrder.end(), [&](uint32_t a, uint32_t b) {
+		return keys[a] < keys[b];
+	});
+
+	// Create SH sampling engine.
+	m_shEngine = new render::SHEngine(3);
+	m_shEngine->generateSamplePoints(100);
+
+	return true;
 }
 
 void RayTracerLocal::destroy()
 {
+	m_shEngine = nullptr;
+	m_environment = nullptr;
 }
 
 void RayTracerLocal::addEnvironment(const IProbe* environment)
 {
+	m_environment = environment;
 }
 
 void RayTracerLocal::addLight(const Light& light)
 {
-    m_lights.push_back(light);
+	m_lights.push_back(light);
 }
 
 void RayTracerLocal::addModel(const model::Model* model, const Transform& transform)
@@ -99,199 +135,109 @@ void RayTracerLocal::addModel(const model::Model* model, const Transform& transf
 		auto& s = m_surfaces.push_back();
 		const auto& material = model->getMaterial(polygon.getMaterial());
 		s.albedo = material.getColor();
+		s.emittance = material.getColor() * c_emissiveBoost * Scalar(material.getEmissive());
 	}
 }
 
 void RayTracerLocal::commit()
 {
-	m_sah.build(m_windings);
+	m_bvh.build(m_windings);
 }
 
 Ref< render::SHCoeffs > RayTracerLocal::traceProbe(const Vector4& position, const Vector4& size) const
 {
-	// // Raytrace IBL probes.
-	// render::SHEngine shEngine(3);
-	// shEngine.generateSamplePoints(20000);
-
-	// RefArray< Job > jobs;
-	// for (uint32_t i = 0; i < lightEntityDatas.size(); ++i)
-	// {
-	// 	auto lightEntityData = lightEntityDatas[i];
-	// 	T_FATAL_ASSERT(lightEntityData != nullptr);
-
-	// 	auto lightComponentData = lightEntityData->getComponent< world::LightComponentData >();
-	// 	T_FATAL_ASSERT(lightComponentData != nullptr);
-
-	// 	if (lightComponentData->getLightType() != world::LtProbe)
-	// 		continue;
-
-	// 	log::info << L"Tracing SH probe \"" << lightEntityData->getName() << L"\" (" << i << L"/" << lightEntityDatas.size() << L")..." << Endl;
-
-	// 	auto position = lightEntityData->getTransform().translation().xyz1();
-
-	// 	auto job = JobManager::getInstance().add([&, lightComponentData]() {
-	// 		Ref< render::SHCoeffs > shCoeffs = new render::SHCoeffs();
-
-	// 		Ref< RayTracer::Context > context = tracer.createContext();
-	// 		WrappedSHFunction shFunction(tracer, context, position);
-	// 		shEngine.generateCoefficients(&shFunction, *shCoeffs);
-
-	// 		lightComponentData->setSHCoeffs(shCoeffs);
-	// 	});
-	// 	if (!job)
-	// 		return false;
-
-	// 	jobs.push_back(job);
-	// }
-	// while (!jobs.empty())
-	// {
-	// 	jobs.back()->wait();
-	// 	jobs.pop_back();
-	// }	
-	return nullptr;
+	RandomGeometry random;
+
+	WrappedSHFunction shFunction([&](const Vector4& unit) -> Vector4 {
+		// Jitter origin within probe volume.
+		const Vector4 jitteredPosition = position + size * random.nextUnit() * 0.5_simd;
+		const Color4f direct = sampleAnalyticalLights(
+			random,
+			m_lights,
+			jitteredPosition,
+			unit,
+			m_configuration->getShadowSampleCount(),
+			m_configuration->getPointLightShadowRadius(),
+			Light::LmDirect
+		);
+		return traceIndirect(random, jitteredPosition, unit) + direct / Scalar(PI);
+	});
+
+	Ref< render::SHCoeffs > shCoeffs = new render::SHCoeffs();
+	m_shEngine->generateCoefficients(&shFunction, false, *shCoeffs);
+	return shCoeffs;
 }
 
 void RayTracerLocal::traceLightmap(const model::Model* model, const GBuffer* gbuffer, drawing::Image* lightmapDiffuse, const int32_t region[4]) const
 {
-}
-
-Color4f RayTracerLocal::traceRay(const Vector4& position, const Vector4& direction) const
-{
-	return Color4f(0.0f, 0.0f, 0.0f, 1.0f);
-}
-
-/*
-Ref< drawing::Image > RayTracerLocal::traceDirect(const GBuffer* gbuffer) const
-{
-    int32_t width = gbuffer->getWidth();
-    int32_t height = gbuffer->getHeight();
+	RandomGeometry random;
 
 	AlignedVector< Light > lights;
 	cullLights(gbuffer, lights);
 
-    Ref< drawing::Image > lightmapDirect = new drawing::Image(drawing::PixelFormat::getRGBAF32(), width, height);
-    lightmapDirect->clear(Color4f(0.0f, 0.0f, 0.0f, 0.0f));
-
-    RefArray< Job > jobs;
-    for (int32_t ty = 0; ty < height; ty += 16)
-    {
-        for (int32_t tx = 0; tx < width; tx += 16)
-        {
-            auto job = JobManager::getInstance().add([&, tx, ty]() {
-                SahTree::QueryCache sahCache;
-                RandomGeometry random;
-
-                for (int32_t y = ty; y < ty + 16; ++y)
-                {
-                    for (int32_t x = tx; x < tx + 16; ++x)
-                    {
-                        const auto& elm = gbuffer->get(x, y);
-                        if (elm.polygon == model::c_InvalidIndex)
-                            continue;
-
-                        Color4f direct = sampleAnalyticalLights(
-                            random,
-                            sahCache,
-							lights,
-                            elm.position,
-                            elm.normal,
-                            m_configuration->getShadowSampleCount(),
-                            m_configuration->getPointLightShadowRadius()
-                        );
-
-                        lightmapDirect->setPixel(x, y, direct.rgb1());
-                    }
-                }
-            });
-            if (!job)
-                return nullptr;
-
-            jobs.push_back(job);
-        }
-    }
-    while (!jobs.empty())
-    {
-        jobs.back()->wait();
-        jobs.pop_back();
-    }
-
-    return lightmapDirect;
+	const auto& polygons = model->getPolygons();
+	const auto& materials = model->getMaterials();
+
+	for (int32_t y = region[1]; y < region[3]; ++y)
+	{
+		for (int32_t x = region[0]; x < region[2]; ++x)
+		{
+			const auto& e = gbuffer->get(x, y);
+			if (e.polygon == model::c_InvalidIndex)
+				continue;
+
+			const auto& originMaterial = materials[polygons[e.polygon].getMaterial()];
+			const Color4f emittance = originMaterial.getColor() * c_emissiveBoost * Scalar(originMaterial.getEmissive());
+
+			const Color4f direct = sampleAnalyticalLights(
+				random,
+				lights,
+				e.position,
+				e.normal,
+				m_configuration->getShadowSampleCount(),
+				m_configuration->getPointLightShadowRadius(),
+				Light::LmDirect
+			);
+
+			const Color4f incoming = traceIndirect(random, e.position, e.normal);
+
+			const Color4f lightmapColor = emittance + incoming + direct / Scalar(PI);
+			lightmapDiffuse->setPixel(x, y, lightmapColor.rgb1());
+		}
+	}
 }
 
-Ref< drawing::Image > RayTracerLocal::traceIndirect(const GBuffer* gbuffer) const
+Color4f RayTracerLocal::traceRay(const Vector4& position, const Vector4& direction) const
 {
-    int32_t width = gbuffer->getWidth();
-    int32_t height = gbuffer->getHeight();
+	RandomGeometry random;
 
-	AlignedVector< Light > lights;
-	cullLights(gbuffer, lights);
+	Bvh4::QueryResult result;
+	if (!m_bvh.queryClosestIntersection(position, direction, m_configuration->getMaxPathDistance(), result))
+	{
+		// Nothing hit, sample sky if available else it's all black.
+		if (m_environment)
+			return m_environment->sampleRadiance(direction);
+		else
+			return Color4f(0.0f, 0.0f, 0.0f, 1.0f);
+	}
 
-    Ref< drawing::Image > lightmapIndirect = new drawing::Image(drawing::PixelFormat::getRGBAF32(), width, height);
-    lightmapIndirect->clear(Color4f(0.0f, 0.0f, 0.0f, 0.0f));
-
-    RefArray< Job > jobs;
-    for (int32_t ty = 0; ty < height; ty += 16)
-    {
-        for (int32_t tx = 0; tx < width; tx += 16)
-        {
-            auto job = JobManager::getInstance().add([&, tx, ty]() {
-                SahTree::QueryResult result;
-                SahTree::QueryCache sahCache;
-                RandomGeometry random;
-
-                for (int32_t y = ty; y < ty + 16; ++y)
-                {
-                    for (int32_t x = tx; x < tx + 16; ++x)
-                    {
-                        const auto& elm = gbuffer->get(x, y);
-                        if (elm.polygon == model::c_InvalidIndex)
-                            continue;
-
-                        Color4f indirect(0.0f, 0.0f, 0.0f, 0.0f);
-                        for (uint32_t i = 0; i < m_configuration->getIndirectSampleCount(); ++i)
-                        {
-                            Vector4 direction = random.nextHemi(elm.normal);
-                            if (m_sah.queryClosestIntersection(elm.position + elm.normal * c_epsilonOffset, direction, m_maxDistance, -1, result, sahCache))
-                            {
-								Scalar f = attenuation(result.distance);
-								if (f <= 0.0f)
-									continue;
-
-                                Scalar ct = dot3(elm.normal, direction);
-                                Color4f brdf = m_surfaces[result.index].albedo / Scalar(PI);
-                                Color4f incoming = sampleAnalyticalLights(
-                                    random,
-                                    sahCache,
-									lights,
-                                    result.position,
-                                    result.normal,
-                                    1,
-                                    0.0f
-                                );
-                                indirect += brdf * incoming * f * ct / p;
-                            }
-                        }
-                        indirect /= Scalar(m_configuration->getIndirectSampleCount());
-
-                        lightmapIndirect->setPixel(x, y, indirect.rgb1());
-                    }
-                }
-            });
-            if (!job)
-                return nullptr;
-
-            jobs.push_back(job);
-        }
-    }
-    while (!jobs.empty())
-    {
-        jobs.back()->wait();
-        jobs.pop_back();
-    }
-
-    return lightmapIndirect;
+	const Surface& surface = m_surfaces[result.index];
+	const Vector4 hitNormal = dot3(result.normal, direction) > 0.0_simd ? -result.normal : result.normal;
+
+	const Color4f direct = sampleAnalyticalLights(
+		random,
+		m_lights,
+		result.position,
+		hitNormal,
+		m_configuration->getShadowSampleCount(),
+		m_configuration->getPointLightShadowRadius(),
+		Light::LmDirect | Light::LmIndirect
+	);
+
+	const Color4f output = surface.emittance + surface.albedo * direct / Scalar(PI);
+	return output.rgb1();
 }
-*/
+
 void RayTracerLocal::cullLights(const GBuffer* gbuffer, AlignedVector< Light >& outLights) const
 {
 	for (auto light : m_lights)
@@ -321,19 +267,140 @@ void RayTracerLocal::cullLights(const GBuffer* gbuffer, AlignedVector< Light >&
 	}
 }
 
+Color4f RayTracerLocal::traceIndirect(
+	RandomGeometry& random,
+	const Vector4& origin,
+	const Vector4& normal
+) const
+{
+	const int32_t sampleCount = (int32_t)m_sampleOrder.size();
+	if (sampleCount <= 0)
+		return Color4f(0.0f, 0.0f, 0.0f, 0.0f);
+
+	const Vector4 offsetOrigin = origin + normal * c_epsilonOffset;
+	const Vector4 origins[4] = { offsetOrigin, offsetOrigin, offsetOrigin, offsetOrigin };
+	Vector4 directions[4];
+	Bvh4::QueryResult results[4];
+
+	// One shift for the entire set of samples; decorrelate this lumel from its
+	// neighbours without breaking the stratification within the set.
+	const Vector2 shift(random.nextFloat(), random.nextFloat());
+
+	Color4f color(0.0f, 0.0f, 0.0f, 0.0f);
+
+	// Sample across hemisphere, consecutive samples are traced as a packet
+	// since they share origin and are ordered to be fairly coherent.
+	for (int32_t i = 0; i < sampleCount; i += 4)
+	{
+		for (int32_t j = 0; j < 4; ++j)
+		{
+			const Vector2 uv = Quasirandom::hammersley(m_sampleOrder[i + j], sampleCount, shift);
+			directions[j] = Quasirandom::uniformHemiSphere(uv, normal);
+		}
+
+		m_bvh.queryClosestIntersection4(origins, directions, m_configuration->getMaxPathDistance(), results);
+
+		for (int32_t j = 0; j < 4; ++j)
+		{
+			const Scalar cosPhi = clamp(dot3(directions[j], normal), 0.0_simd, 1.0_simd);
+
+			if (results[j].index < 0)
+			{
+				// Nothing hit, sample sky if available else it's all black.
+				if (m_environment)
+					color += m_environment->sampleRadiance(directions[j]) * cosPhi;
+				continue;
+			}
+
+			const Surface& surface = m_surfaces[results[j].index];
+			const Vector4 hitNormal = dot3(results[j].normal, directions[j]) > 0.0_simd ? -results[j].normal : results[j].normal;
+
+			const Color4f direct = sampleAnalyticalLights(
+				random,
+				m_lights,
+				results[j].position,
+				hitNormal,
+				1,
+				0.0f,
+				Light::LmIndirect
+			);
+
+			// Radiance leaving the hit surface towards origin.
+			const Color4f radiance = surface.emittance + surface.albedo * direct / Scalar(PI);
+			color += radiance * cosPhi;
+		}
+	}
+
+	// Hemisphere is uniformly sampled, pdf 1/2pi, so irradiance is (2pi/N) * sum;
+	// we accumulate irradiance divided by pi, as expected by the shaders, hence 2/N.
+	return (color * 2.0_simd) / Scalar((float)sampleCount);
+}
+
+Scalar RayTracerLocal::traceShadow(
+	RandomGeometry& random,
+	const Vector4& origin,
+	const Vector4& lightPosition,
+	const Vector4& lightDirection,
+	float lightDistance,
+	uint32_t shadowSampleCount,
+	float shadowRadius
+) const
+{
+	Vector4 u, v;
+	orthogonalFrame(lightDirection, u, v);
+
+	const Vector4 offsetOrigin = origin + lightDirection * c_epsilonOffset;
+	const Vector4 origins[4] = { offsetOrigin, offsetOrigin, offsetOrigin, offsetOrigin };
+	Vector4 directions[4];
+	float distances[4];
+
+	// Shadow rays towards an area light are very coherent; trace them as packets.
+	int32_t shadowCount = 0;
+	for (uint32_t i = 0; i < shadowSampleCount; i += 4)
+	{
+		for (uint32_t j = 0; j < 4; ++j)
+		{
+			float a = 0.0f, b = 0.0f;
+			if (shadowSampleCount > 1)
+			{
+				do
+				{
+					a = random.nextFloat() * 2.0f - 1.0f;
+					b = random.nextFloat() * 2.0f - 1.0f;
+				}
+				while ((a * a) + (b * b) > 1.0f);
+			}
+
+			directions[j] = (lightPosition + u * Scalar(a * shadowRadius) + v * Scalar(b * shadowRadius) - offsetOrigin).xyz0().normalized();
+
+			// Padding rays are disabled by a negative distance.
+			distances[j] = (i + j < shadowSampleCount) ? lightDistance - c_epsilonOffset : -1.0f;
+		}
+
+		const uint32_t occluded = m_bvh.queryAnyIntersection4(origins, directions, distances);
+		for (uint32_t j = 0; j < 4; ++j)
+			shadowCount += (occluded >> j) & 1;
+	}
+
+	return Scalar(1.0f - float(shadowCount) / shadowSampleCount);
+}
+
 Color4f RayTracerLocal::sampleAnalyticalLights(
-    RandomGeometry& random,
-    SahTree::QueryCache& sahCache,
-    const AlignedVector< Light >& lights,
-    const Vector4& origin,
-    const Vector4& normal,
-    uint32_t shadowSampleCount,
-    float pointLightShadowRadius
- ) const
+	RandomGeometry& random,
+	const AlignedVector< Light >& lights,
+	const Vector4& origin,
+	const Vector4& normal,
+	uint32_t shadowSampleCount,
+	float pointLightShadowRadius,
+	uint8_t lightMask
+) const
 {
 	Color4f contribution(0.0f, 0.0f, 0.0f, 0.0f);
 	for (const auto& light : lights)
 	{
+		if ((light.mask & lightMask) == 0)
+			continue;
+
 		switch (light.type)
 		{
 		case Light::LtDirectional:
@@ -341,12 +408,10 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 				Scalar phi = dot3(normal, -light.direction);
 				if (phi > 0.0f)
 				{
-					if (!m_sah.queryAnyIntersection(
+					if (!m_bvh.queryAnyIntersection(
 						origin + normal * c_epsilonOffset,
 						-light.direction,
-						m_maxDistance,
-						-1,
-						sahCache
+						m_maxDistance
 					))
 					{
 						contribution += light.color * phi;
@@ -371,33 +436,8 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 					break;
 
 				Scalar shadowAttenuate(1.0f);
-
 				if (shadowSampleCount > 0)
-				{
-					Vector4 u, v;
-					orthogonalFrame(lightDirection, u, v);
-
-					int32_t shadowCount = 0;
-					for (uint32_t j = 0; j < shadowSampleCount; ++j)
-					{
-						float a = 0.0f, b = 0.0f;
-						if (shadowSampleCount > 1)
-						{
-							do
-							{
-								a = random.nextFloat() * 2.0f - 1.0f;
-								b = random.nextFloat() * 2.0f - 1.0f;
-							}
-							while ((a * a) + (b * b) > 1.0f);
-						}
-
-						Vector4 shadowDirection = (light.position + u * Scalar(a * pointLightShadowRadius) + v * Scalar(b * pointLightShadowRadius) - origin).xyz0();
-
-						if (m_sah.queryAnyIntersection(origin + normal * c_epsilonOffset, shadowDirection.normalized(), lightDistance - c_epsilonOffset, -1, sahCache))
-							shadowCount++;
-					}
-					shadowAttenuate = Scalar(1.0f - float(shadowCount) / shadowSampleCount);
-				}
+					shadowAttenuate = traceShadow(random, origin, light.position, lightDirection, lightDistance, shadowSampleCount, pointLightShadowRadius);
 
 				contribution += light.color * phi * min(f, Scalar(1.0f)) * shadowAttenuate;
 			}
@@ -424,33 +464,8 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 					break;
 
 				Scalar shadowAttenuate(1.0f);
-
 				if (shadowSampleCount > 0)
-				{
-					Vector4 u, v;
-					orthogonalFrame(-lightToPoint, u, v);
-
-					int32_t shadowCount = 0;
-					for (uint32_t j = 0; j < shadowSampleCount; ++j)
-					{
-						float a = 0.0f, b = 0.0f;
-						if (shadowSampleCount > 1)
-						{
-							do
-							{
-								a = random.nextFloat() * 2.0f - 1.0f;
-								b = random.nextFloat() * 2.0f - 1.0f;
-							}
-							while ((a * a) + (b * b) > 1.0f);
-						}
-
-						Vector4 shadowDirection = (light.position + u * Scalar(a * pointLightShadowRadius) + v * Scalar(b * pointLightShadowRadius) - origin).xyz0();
-
-						if (m_sah.queryAnyIntersection(origin + normal * c_epsilonOffset, shadowDirection.normalized(), lightDistance - c_epsilonOffset, -1, sahCache))
-							shadowCount++;
-					}
-					shadowAttenuate = Scalar(1.0f - float(shadowCount) / shadowSampleCount);
-				}
+					shadowAttenuate = traceShadow(random, origin, light.position, -lightToPoint, lightDistance, shadowSampleCount, pointLightShadowRadius);
 
 				contribution += light.color * k0 * k1 * k2 * shadowAttenuate;
 			}
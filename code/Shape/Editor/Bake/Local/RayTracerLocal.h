@@ -1,6 +1,6 @@
 /*
  * TRAKTOR
- * Copyright (c) 2022-2024 Anders Pistol.
+ * Copyright (c) 2022-2026 Anders Pistol.
  *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,61 +9,97 @@
 #pragma once
 
 #include "Core/Math/RandomGeometry.h"
-#include "Core/Math/SahTree.h"
 #include "Shape/Editor/Bake/IRayTracer.h"
+#include "Shape/Editor/Bake/Local/Bvh4.h"
+
+namespace traktor::render
+{
+
+class SHEngine;
+
+}
 
 namespace traktor::shape
 {
 
 class RayTracer;
 
+/*! Ray tracer without external dependencies.
+ * \ingroup Illuminate
+ *
+ * Geometry is traced through a four wide BVH; hemisphere
+ * and shadow samples are traced as packets of four rays.
+ */
 class RayTracerLocal : public IRayTracer
 {
-    T_RTTI_CLASS;
+	T_RTTI_CLASS;
 
 public:
-    virtual bool create(const BakeOperationData* configuration) override final;
+	virtual bool create(const BakeOperationData* configuration) override final;
 
-    virtual void destroy() override final;
+	virtual void destroy() override final;
 
 	virtual void addEnvironment(const IProbe* environment) override final;
 
-    virtual void addLight(const Light& light) override final;
+	virtual void addLight(const Light& light) override final;
 
-    virtual void addModel(const model::Model* model, const Transform& transform) override final;
+	virtual void addModel(const model::Model* model, const Transform& transform) override final;
 
-    virtual void commit() override final;
+	virtual void commit() override final;
 
-    virtual Ref< render::SHCoeffs > traceProbe(const Vector4& position, const Vector4& size) const override final;
+	virtual Ref< render::SHCoeffs > traceProbe(const Vector4& position, const Vector4& size) const override final;
 
-    virtual void traceLightmap(const model::Model* model, const GBuffer* gbuffer, drawing::Image* lightmapDiffuse, const int32_t region[4]) const override final;
+	virtual void traceLightmap(const model::Model* model, const GBuffer* gbuffer, drawing::Image* lightmapDiffuse, const int32_t region[4]) const override final;
 
 	virtual Color4f traceRay(const Vector4& position, const Vector4& direction) const override final;
 
+	/*! Get acceleration structure of committed geometry. */
+	const Bvh4& getBvh() const { return m_bvh; }
+
 private:
 	struct Surface
 	{
 		Color4f albedo;
+		Color4f emittance;
 	};
 
-	const BakeOperationData* m_configuration;
-	SahTree m_sah;
+	const BakeOperationData* m_configuration = nullptr;
+	Ref< const IProbe > m_environment;
+	Ref< render::SHEngine > m_shEngine;
+	Bvh4 m_bvh;
 	AlignedVector< Light > m_lights;
 	AlignedVector< Winding3 > m_windings;
 	AlignedVector< Surface > m_surfaces;
+	AlignedVector< uint32_t > m_sampleOrder;
 	float m_maxDistance = 100.0f;
 
-    void cullLights(const GBuffer* gbuffer, AlignedVector< Light >& outLights) const;
+	void cullLights(const GBuffer* gbuffer, AlignedVector< Light >& outLights) const;
+
+	Color4f traceIndirect(
+		RandomGeometry& random,
+		const Vector4& origin,
+		const Vector4& normal
+	) const;
+
+	Scalar traceShadow(
+		RandomGeometry& random,
+		const Vector4& origin,
+		const Vector4& lightPosition,
+		const Vector4& lightDirection,
+		float lightDistance,
+		uint32_t shadowSampleCount,
+		float shadowRadius
+	) const;
 
 	Color4f sampleAnalyticalLights(
-        RandomGeometry& random,
-        SahTree::QueryCache& sahCache,
-        const AlignedVector< Light >& lights,
-        const Vector4& origin,
-        const Vector4& normal,
-        uint32_t shadowSampleCount,
-        float pointLightShadowRadius
-    ) const;
+		RandomGeometry& random,
+		const AlignedVector< Light >& lights,
+		const Vector4& origin,
+		const Vector4& normal,
+		uint32_t shadowSampleCount,
+		float pointLightShadowRadius,
+		uint8_t lightMask
+	) const;
 };
 
 }
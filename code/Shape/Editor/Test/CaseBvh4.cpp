@@ -0,0 +1,344 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Quasirandom.h"
+#include "Core/Math/RandomGeometry.h"
+#include "Core/Math/SahTree.h"
+#include "Core/Timer/Timer.h"
+#include "Shape/Editor/Bake/Local/Bvh4.h"
+#include "Shape/Editor/Test/CaseBvh4.h"
+
+#include <algorithm>
+
+namespace traktor::shape::test
+{
+	namespace
+	{
+
+const uint32_t c_origins = 2048;
+const uint32_t c_raysPerOrigin = 64;
+const uint32_t c_verifyRays = 16384;
+const float c_maxDistance = 1000.0f;
+const float c_shadowDistance = 4.0f;
+const float c_lightRadius = 0.5f;
+
+uint32_t part1By1(uint32_t n)
+{
+	n &= 0x0000ffff;
+	n = (n | (n << 8)) & 0x00ff00ff;
+	n = (n | (n << 4)) & 0x0f0f0f0f;
+	n = (n | (n << 2)) & 0x33333333;
+	n = (n | (n << 1)) & 0x55555555;
+	return n;
+}
+
+/*! Order hemisphere samples along a Morton curve, same as RayTracerLocal, so packets are coherent. */
+AlignedVector< uint32_t > coherentOrder(uint32_t sampleCount)
+{
+	AlignedVector< uint32_t > keys(sampleCount);
+	AlignedVector< uint32_t > order(sampleCount);
+	for (uint32_t i = 0; i < sampleCount; ++i)
+	{
+		const Vector2 uv = Quasirandom::hammersley(i, sampleCount);
+		keys[i] = part1By1((uint32_t)(uv.x * 65535.0f)) | (part1By1((uint32_t)(uv.y * 65535.0f)) << 1);
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+	return order;
+}
+
+struct Scene
+{
+	const wchar_t* name;
+	Vector4 light;
+	AlignedVector< Winding3 > windings;
+	AlignedVector< Vector4 > origins;
+	AlignedVector< Vector4 > directions;
+};
+
+void addGrid(AlignedVector< Winding3 >& outWindings, const Vector4& corner, const Vector4& u, const Vector4& v, int32_t resolution)
+{
+	const Scalar step(1.0f / resolution);
+	for (int32_t y = 0; y < resolution; ++y)
+	{
+		for (int32_t x = 0; x < resolution; ++x)
+		{
+			const Vector4 p = corner + u * Scalar(float(x)) * step + v * Scalar(float(y)) * step;
+			auto& w = outWindings.push_back();
+			w.push(p);
+			w.push(p + u * step);
+			w.push(p + u * step + v * step);
+			w.push(p + v * step);
+		}
+	}
+}
+
+void addBox(AlignedVector< Winding3 >& outWindings, const Vector4& center, const Vector4& extent, int32_t resolution)
+{
+	const Vector4 ex = extent * Vector4(2.0f, 0.0f, 0.0f, 0.0f);
+	const Vector4 ey = extent * Vector4(0.0f, 2.0f, 0.0f, 0.0f);
+	const Vector4 ez = extent * Vector4(0.0f, 0.0f, 2.0f, 0.0f);
+	const Vector4 mn = (center - extent).xyz1();
+	const Vector4 mx = (center + extent).xyz1();
+	addGrid(outWindings, mn, ex, ey, resolution);
+	addGrid(outWindings, mn, ey, ez, resolution);
+	addGrid(outWindings, mn, ez, ex, resolution);
+	addGrid(outWindings, mx, -ey, -ex, resolution);
+	addGrid(outWindings, mx, -ez, -ey, resolution);
+	addGrid(outWindings, mx, -ex, -ez, resolution);
+}
+
+/*! Closed room with furniture; lightmap like rays, hemisphere samples from floor. */
+void createRoomScene(Scene& outScene)
+{
+	RandomGeometry random;
+
+	outScene.name = L"room";
+	outScene.light = Vector4(0.0f, 9.0f, 0.0f, 1.0f);
+	addBox(outScene.windings, Vector4(0.0f, 5.0f, 0.0f, 1.0f), Vector4(20.0f, 5.0f, 20.0f, 0.0f), 32);
+	for (int32_t i = 0; i < 512; ++i)
+	{
+		const Vector4 center(
+			(random.nextFloat() * 2.0f - 1.0f) * 18.0f,
+			random.nextFloat() * 8.0f + 1.0f,
+			(random.nextFloat() * 2.0f - 1.0f) * 18.0f,
+			1.0f
+		);
+		const Vector4 extent(0.2f + random.nextFloat(), 0.2f + random.nextFloat(), 0.2f + random.nextFloat(), 0.0f);
+		addBox(outScene.windings, center, extent, 2);
+	}
+
+	const Vector4 normal(0.0f, 1.0f, 0.0f, 0.0f);
+	const AlignedVector< uint32_t > order = coherentOrder(c_raysPerOrigin);
+	for (uint32_t i = 0; i < c_origins; ++i)
+	{
+		const Vector4 origin((random.nextFloat() * 2.0f - 1.0f) * 19.0f, 0.01f, (random.nextFloat() * 2.0f - 1.0f) * 19.0f, 1.0f);
+		const Vector2 shift(random.nextFloat(), random.nextFloat());
+		for (uint32_t j = 0; j < c_raysPerOrigin; ++j)
+		{
+			outScene.origins.push_back(origin);
+			outScene.directions.push_back(Quasirandom::uniformHemiSphere(Quasirandom::hammersley(order[j], c_raysPerOrigin, shift), normal));
+		}
+	}
+}
+
+/*! Triangle soup; incoherent rays from random points in all directions. */
+void createSoupScene(Scene& outScene)
+{
+	RandomGeometry random;
+
+	outScene.name = L"soup";
+	outScene.light = Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+	for (int32_t i = 0; i < 20000; ++i)
+	{
+		const Vector4 center(
+			(random.nextFloat() * 2.0f - 1.0f) * 20.0f,
+			(random.nextFloat() * 2.0f - 1.0f) * 20.0f,
+			(random.nextFloat() * 2.0f - 1.0f) * 20.0f,
+			1.0f
+		);
+		outScene.windings.push_back(Winding3(
+			center + random.nextUnit() * 0.5_simd,
+			center + random.nextUnit() * 0.5_simd,
+			center + random.nextUnit() * 0.5_simd
+		));
+	}
+
+	for (uint32_t i = 0; i < c_origins * c_raysPerOrigin; ++i)
+	{
+		outScene.origins.push_back(Vector4(
+			(random.nextFloat() * 2.0f - 1.0f) * 20.0f,
+			(random.nextFloat() * 2.0f - 1.0f) * 20.0f,
+			(random.nextFloat() * 2.0f - 1.0f) * 20.0f,
+			1.0f
+		));
+		outScene.directions.push_back(random.nextUnit());
+	}
+}
+
+/*! Shadow rays from first origin of each set towards an area light, as traced by RayTracerLocal. */
+void createShadowRays(const Scene& scene, AlignedVector< Vector4 >& outOrigins, AlignedVector< Vector4 >& outDirections, AlignedVector< float >& outDistances)
+{
+	RandomGeometry random;
+	for (uint32_t i = 0; i < c_origins; ++i)
+	{
+		const Vector4 origin = scene.origins[i * c_raysPerOrigin];
+		Vector4 lightDirection = (scene.light - origin).xyz0();
+		const float lightDistance = lightDirection.normalize();
+
+		Vector4 u, v;
+		orthogonalFrame(lightDirection, u, v);
+
+		for (uint32_t j = 0; j < c_raysPerOrigin; ++j)
+		{
+			float a, b;
+			do
+			{
+				a = random.nextFloat() * 2.0f - 1.0f;
+				b = random.nextFloat() * 2.0f - 1.0f;
+			}
+			while ((a * a) + (b * b) > 1.0f);
+
+			outOrigins.push_back(origin);
+			outDirections.push_back((scene.light + u * Scalar(a * c_lightRadius) + v * Scalar(b * c_lightRadius) - origin).xyz0().normalized());
+			outDistances.push_back(lightDistance);
+		}
+	}
+}
+
+double mrays(uint32_t rayCount, double time)
+{
+	return time > 0.0 ? (rayCount / time) / 1e6 : 0.0;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.shape.test.CaseBvh4", 0, CaseBvh4, traktor::test::Case)
+
+void CaseBvh4::run()
+{
+	Scene scenes[2];
+	createRoomScene(scenes[0]);
+	createSoupScene(scenes[1]);
+
+	for (const auto& scene : scenes)
+	{
+		const uint32_t rayCount = (uint32_t)scene.origins.size();
+		const Vector4* origins = scene.origins.c_ptr();
+		const Vector4* directions = scene.directions.c_ptr();
+
+		Timer timer;
+		SahTree sah;
+		sah.build(scene.windings);
+		const double sahBuildTime = timer.getElapsedTime();
+
+		timer.reset();
+		Bvh4 bvh;
+		bvh.build(scene.windings);
+		const double bvhBuildTime = timer.getElapsedTime();
+
+		CASE_ASSERT(bvh.getNodeCount() > 0);
+		CASE_ASSERT(bvh.getNodeCount() <= bvh.getTriangleCount());
+
+		// Verify closest and any intersection, both single rays and packets, against SAH tree.
+		SahTree::QueryCache cache;
+		SahTree::QueryResult sahResult;
+		Bvh4::QueryResult result;
+		Bvh4::QueryResult results[4];
+		uint32_t closestMismatches = 0;
+		uint32_t packetMismatches = 0;
+		uint32_t anyMismatches = 0;
+		uint32_t hitCount = 0;
+
+		for (uint32_t i = 0; i < c_verifyRays; i += 4)
+		{
+			bvh.queryClosestIntersection4(&origins[i], &directions[i], c_maxDistance, results);
+
+			const float shadowDistances[4] = { c_shadowDistance, c_shadowDistance, c_shadowDistance, c_shadowDistance };
+			const uint32_t occluded = bvh.queryAnyIntersection4(&origins[i], &directions[i], shadowDistances);
+
+			for (uint32_t j = 0; j < 4; ++j)
+			{
+				const bool sahHit = sah.queryClosestIntersection(origins[i + j], directions[i + j], c_maxDistance, -1, sahResult, cache);
+				const bool hit = bvh.queryClosestIntersection(origins[i + j], directions[i + j], c_maxDistance, result);
+
+				if (sahHit != hit || (hit && std::abs(sahResult.distance - result.distance) > 1e-3f))
+					++closestMismatches;
+				if (hit != (results[j].index >= 0) || (hit && (result.index != results[j].index || std::abs(result.distance - results[j].distance) > 1e-4f)))
+					++packetMismatches;
+
+				const bool any = bvh.queryAnyIntersection(origins[i + j], directions[i + j], c_shadowDistance);
+				if (any != ((occluded & (1 << j)) != 0) || any != (hit && result.distance <= c_shadowDistance))
+					++anyMismatches;
+
+				if (hit)
+					++hitCount;
+			}
+		}
+
+		CASE_ASSERT_EQUAL(closestMismatches, 0u);
+		CASE_ASSERT_EQUAL(packetMismatches, 0u);
+		CASE_ASSERT_EQUAL(anyMismatches, 0u);
+		CASE_ASSERT(hitCount > 0);
+
+		// Benchmark rays per second.
+		uint32_t dummy = 0;
+
+		timer.reset();
+		for (uint32_t i = 0; i < rayCount; ++i)
+			dummy += sah.queryClosestIntersection(origins[i], directions[i], c_maxDistance, -1, sahResult, cache) ? 1 : 0;
+		const double sahTime = timer.getElapsedTime();
+
+		timer.reset();
+		for (uint32_t i = 0; i < rayCount; ++i)
+			dummy += bvh.queryClosestIntersection(origins[i], directions[i], c_maxDistance, result) ? 1 : 0;
+		const double singleTime = timer.getElapsedTime();
+
+		timer.reset();
+		for (uint32_t i = 0; i < rayCount; i += 4)
+			dummy += bvh.queryClosestIntersection4(&origins[i], &directions[i], c_maxDistance, results);
+		const double packetTime = timer.getElapsedTime();
+
+		timer.reset();
+		for (uint32_t i = 0; i < rayCount; ++i)
+			dummy += sah.queryAnyIntersection(origins[i], directions[i], c_shadowDistance, cache) ? 1 : 0;
+		const double sahAnyTime = timer.getElapsedTime();
+
+		timer.reset();
+		for (uint32_t i = 0; i < rayCount; ++i)
+			dummy += bvh.queryAnyIntersection(origins[i], directions[i], c_shadowDistance) ? 1 : 0;
+		const double singleAnyTime = timer.getElapsedTime();
+
+		timer.reset();
+		const float shadowDistances[4] = { c_shadowDistance, c_shadowDistance, c_shadowDistance, c_shadowDistance };
+		for (uint32_t i = 0; i < rayCount; i += 4)
+			dummy += bvh.queryAnyIntersection4(&origins[i], &directions[i], shadowDistances);
+		const double packetAnyTime = timer.getElapsedTime();
+
+		// Shadow rays towards area light; verify packets against single rays, and benchmark.
+		AlignedVector< Vector4 > shadowOrigins;
+		AlignedVector< Vector4 > shadowDirections;
+		AlignedVector< float > shadowLengths;
+		createShadowRays(scene, shadowOrigins, shadowDirections, shadowLengths);
+
+		uint32_t shadowMismatches = 0;
+		for (uint32_t i = 0; i < c_verifyRays; i += 4)
+		{
+			const uint32_t occluded = bvh.queryAnyIntersection4(&shadowOrigins[i], &shadowDirections[i], &shadowLengths[i]);
+			for (uint32_t j = 0; j < 4; ++j)
+			{
+				const bool sahAny = sah.queryAnyIntersection(shadowOrigins[i + j], shadowDirections[i + j], shadowLengths[i + j], cache);
+				const bool any = bvh.queryAnyIntersection(shadowOrigins[i + j], shadowDirections[i + j], shadowLengths[i + j]);
+				if (any != sahAny || any != ((occluded & (1 << j)) != 0))
+					++shadowMismatches;
+			}
+		}
+		CASE_ASSERT_EQUAL(shadowMismatches, 0u);
+
+		timer.reset();
+		for (uint32_t i = 0; i < rayCount; ++i)
+			dummy += bvh.queryAnyIntersection(shadowOrigins[i], shadowDirections[i], shadowLengths[i]) ? 1 : 0;
+		const double singleShadowTime = timer.getElapsedTime();
+
+		timer.reset();
+		for (uint32_t i = 0; i < rayCount; i += 4)
+			dummy += bvh.queryAnyIntersection4(&shadowOrigins[i], &shadowDirections[i], &shadowLengths[i]);
+		const double packetShadowTime = timer.getElapsedTime();
+
+		log::info << L"Bvh4, " << scene.name << L" scene, " << bvh.getTriangleCount() << L" triangles, " << bvh.getNodeCount() << L" nodes, " << rayCount << L" rays (" << dummy << L")" << Endl;
+		log::info << L"  build " << int32_t(sahBuildTime * 1e3) << L" ms SahTree, " << int32_t(bvhBuildTime * 1e3) << L" ms Bvh4" << Endl;
+		log::info << L"  closest " << mrays(rayCount, sahTime) << L" Mrays/s SahTree, " << mrays(rayCount, singleTime) << L" Mrays/s Bvh4, " << mrays(rayCount, packetTime) << L" Mrays/s Bvh4 packets" << Endl;
+		log::info << L"  any " << mrays(rayCount, sahAnyTime) << L" Mrays/s SahTree, " << mrays(rayCount, singleAnyTime) << L" Mrays/s Bvh4, " << mrays(rayCount, packetAnyTime) << L" Mrays/s Bvh4 packets" << Endl;
+		log::info << L"  shadow " << mrays(rayCount, singleShadowTime) << L" Mrays/s Bvh4, " << mrays(rayCount, packetShadowTime) << L" Mrays/s Bvh4 packets" << Endl;
+	}
+}
+
+}
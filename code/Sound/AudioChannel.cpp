@@ -174,15 +174,26 @@ bool AudioChannel::play(
 }
 
 bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
+{
+	prepare();
+	return getPreparedBlock(mixer, outBlock);
+}
+
+const IAudioBuffer* AudioChannel::prepare()
 {
 	StateSound& ss = m_stateSound;
 
 	// Read pending sound state from fifo.
-	{
-		StateSound next;
-		if (m_stateSoundFifo.get(next))
-			ss = next;
-	}
+	StateSound next;
+	if (m_stateSoundFifo.get(next))
+		ss = next;
+
+	return ss.cursor ? ss.buffer.c_ptr() : nullptr;
+}
+
+bool AudioChannel::getPreparedBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
+{
+	StateSound& ss = m_stateSound;
 
 	if (!ss.buffer || !ss.cursor)
 		return false;
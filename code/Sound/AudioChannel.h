@@ -102,6 +102,15 @@ public:
 private:
 	friend class AudioSystem;
 
+	/*! Read pending sound state.
+	 *
+	 * \return Buffer which will be read by next block, null if not playing.
+	 */
+	const IAudioBuffer* prepare();
+
+	/*! Get next block from prepared sound state. */
+	bool getPreparedBlock(const IAudioMixer* mixer, AudioBlock& outBlock);
+
 	struct StateFilter
 	{
 		Ref< const IAudioFilter > filter;
@@ -14,7 +14,9 @@
 #include "Core/Math/Vector4.h"
 #include "Core/Memory/Alloc.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/System/OS.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobQueue.h"
 #include "Core/Thread/ThreadManager.h"
 #include "Core/Timer/Timer.h"
 #include "Sound/AudioChannel.h"
@@ -30,6 +32,12 @@
 
 namespace traktor::sound
 {
+	namespace
+	{
+
+const uint32_t c_maxMixerJobs = 8;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.AudioSystem", AudioSystem, Object)
 
@@ -39,8 +47,11 @@ AudioSystem::AudioSystem(IAudioDriver* driver)
 ,	m_volume(1.0f)
 ,	m_threadMixer(0)
 ,	m_samplesData(0)
+,	m_mixerJobCount(0)
+,	m_mixerJobsData(0)
 ,	m_time(0.0)
 ,	m_mixerThreadTime(0.0)
+,	m_mixerThreadTimeSnapshot(0.0)
 {
 }
 
@@ -83,6 +94,40 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 	for (uint32_t i = 0; i < samplesBlockCount; ++i)
 		m_samplesBlocks.push_back(&m_samplesData[i * samplesPerBlock]);
 
+	// Allocate partial blocks for mixer jobs; first job mix directly into frame block.
+	m_mixerJobCount = m_desc.mixerJobs;
+	if (!m_mixerJobCount)
+		m_mixerJobCount = OS::getInstance().getCPUCoreCount();
+	m_mixerJobCount = clamp< uint32_t >(m_mixerJobCount, 1, min< uint32_t >(c_maxMixerJobs, max< uint32_t >(desc.channels, 1)));
+
+	if (m_mixerJobCount > 1)
+	{
+		m_mixerJobsData = static_cast< float* >(Alloc::acquireAlign(
+			samplesPerBlock * (m_mixerJobCount - 1) * sizeof(float),
+			16,
+			T_FILE_LINE
+		));
+		if (!m_mixerJobsData)
+			return false;
+
+		// Mixer jobs run on a dedicated queue, the mixer thread must not
+		// wait behind, or be blocked by, jobs of the shared queue.
+		m_mixerQueue = new JobQueue();
+		if (!m_mixerQueue->create(m_mixerJobCount - 1, Thread::Above))
+			return false;
+	}
+
+	m_mixerJobSamples.resize(m_mixerJobCount, nullptr);
+	m_mixerJobChannels.resize(m_mixerJobCount);
+	m_mixerJobTasks.resize(m_mixerJobCount);
+	for (uint32_t i = 0; i < m_mixerJobCount; ++i)
+	{
+		if (i > 0)
+			m_mixerJobSamples[i] = &m_mixerJobsData[(i - 1) * samplesPerBlock];
+		m_mixerJobChannels[i].reserve(desc.channels);
+		m_mixerJobTasks[i] = [=, this](){ mixChannels(i); };
+	}
+
 	// Create mixer and submission threads.
 	m_threadMixer = ThreadManager::getInstance().create([=, this](){ threadMixer(); }, L"Sound mixer", 1);
 	if (!m_threadMixer)
@@ -104,6 +149,8 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 
 	// Set play parameters.
 	m_requestBlocks.resize(desc.channels);
+	m_channelTimes.resize(desc.channels, 0.0);
+	m_channelTimesSnapshot.resize(desc.channels, 0.0);
 	m_time = 0.0;
 
 	// Start thread.
@@ -128,6 +175,8 @@ void AudioSystem::destroy()
 		m_threadMixer = nullptr;
 	}
 
+	safeDestroy(m_mixerQueue);
+
 	// Free mixer and memory resources.
 	m_mixer = nullptr;
 	safeDestroy(m_driver);
@@ -137,6 +186,12 @@ void AudioSystem::destroy()
 		Alloc::freeAlign(m_samplesData);
 		m_samplesData = nullptr;
 	}
+
+	if (m_mixerJobsData)
+	{
+		Alloc::freeAlign(m_mixerJobsData);
+		m_mixerJobsData = nullptr;
+	}
 }
 
 bool AudioSystem::reset(IAudioDriver* driver)
@@ -260,98 +315,178 @@ double AudioSystem::getTime() const
 
 void AudioSystem::getThreadPerformances(double& outMixerTime) const
 {
-	outMixerTime = m_mixerThreadTime;
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_performanceLock);
+	outMixerTime = m_mixerThreadTimeSnapshot;
+}
+
+void AudioSystem::getChannelPerformances(AlignedVector< double >& outChannelTimes) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_performanceLock);
+	outChannelTimes = m_channelTimesSnapshot;
 }
 
 void AudioSystem::threadMixer()
 {
 	AudioBlock frameBlock;
 	Timer timerMixer;
-	uint32_t channelsCount;
+
+	const uint32_t frameSamples = m_desc.driverDesc.frameSamples;
+	const uint32_t hwChannels = m_desc.driverDesc.hwChannels;
 
 	timerMixer.reset();
 	while (!m_threadMixer->stopped())
 	{
 		const double startTime = timerMixer.getElapsedTime();
 
-		// Read blocks from channels.
+		// Allocate new frame block.
+		float* samples = m_samplesBlocks.front();
+		m_samplesBlocks.pop_front();
+
+		// Prepare new frame block.
+		m_mixer->mute(samples, frameSamples * hwChannels);
+		for (uint32_t i = 0; i < hwChannels; ++i)
+			frameBlock.samples[i] = samples + frameSamples * i;
+		frameBlock.samplesCount = frameSamples;
+		frameBlock.sampleRate = m_desc.driverDesc.sampleRate;
+		frameBlock.maxChannel = hwChannels;
+
+		uint32_t jobCount = 0;
 		m_channelsLock.wait();
 		{
-			channelsCount = (uint32_t)m_channels.size();
+			// Distribute playing channels onto mixer jobs; channels playing
+			// the same buffer are kept in the same job since buffers might
+			// share decoder state between cursors.
+			for (auto& jobChannels : m_mixerJobChannels)
+				jobChannels.resize(0);
+			m_mixerBufferJobs.reset();
+
+			const uint32_t channelsCount = (uint32_t)m_channels.size();
 			for (uint32_t i = 0; i < channelsCount; ++i)
 			{
-				m_requestBlocks[i].samplesCount = m_desc.driverDesc.frameSamples;
-				m_requestBlocks[i].maxChannel = 0;
-				m_requestBlocks[i].category = 0;
-				m_channels[i]->getBlock(m_mixer, m_requestBlocks[i]);
+				const IAudioBuffer* buffer = m_channels[i]->prepare();
+				if (!buffer)
+				{
+					m_channelTimes[i] = 0.0;
+					continue;
+				}
+
+				uint32_t job;
+				const auto it = m_mixerBufferJobs.find(buffer);
+				if (it != m_mixerBufferJobs.end())
+					job = it->second;
+				else
+				{
+					job = m_mixerBufferJobs.size() % m_mixerJobCount;
+					m_mixerBufferJobs.insert(buffer, job);
+				}
+				m_mixerJobChannels[job].push_back(i);
 			}
+
+			// Decode, filter and mix channels; first job mix directly into frame block.
+			jobCount = min< uint32_t >((uint32_t)m_mixerBufferJobs.size(), m_mixerJobCount);
+			m_mixerJobSamples[0] = samples;
+			if (jobCount > 1)
+				m_mixerQueue->fork(m_mixerJobTasks.c_ptr(), jobCount);
+			else if (jobCount > 0)
+				mixChannels(0);
 		}
 		m_channelsLock.release();
 
-		// Allocate new frame block.
-		float* samples = m_samplesBlocks.front();
-		m_samplesBlocks.pop_front();
-
-		// Prepare new frame block.
-		m_mixer->mute(samples, m_desc.driverDesc.frameSamples * m_desc.driverDesc.hwChannels);
-		for (uint32_t i = 0; i < m_desc.driverDesc.hwChannels; ++i)
-			frameBlock.samples[i] = samples + m_desc.driverDesc.frameSamples * i;
-		frameBlock.samplesCount = m_desc.driverDesc.frameSamples;
-		frameBlock.sampleRate = m_desc.driverDesc.sampleRate;
-		frameBlock.maxChannel = m_desc.driverDesc.hwChannels;
+		// Add partial blocks into frame block.
+		for (uint32_t i = 1; i < jobCount; ++i)
+		{
+			for (uint32_t j = 0; j < hwChannels; ++j)
+			{
+				m_mixer->addMulConst(
+					frameBlock.samples[j],
+					m_mixerJobSamples[i] + frameSamples * j,
+					frameSamples,
+					1.0f
+				);
+			}
+		}
 
 		m_mixer->synchronize();
 
-		// Final combine channels into hardware channels using "combine matrix".
-		for (uint32_t i = 0; i < channelsCount; ++i)
+		m_time += double(frameSamples) / m_desc.driverDesc.sampleRate;
+
+		// Measure mixing only, not including time waiting for driver.
+		const double endTime = timerMixer.getElapsedTime();
+		m_mixerThreadTime = (endTime - startTime) * 0.1 + m_mixerThreadTime * 0.9;
+
+		// Publish measurements; channel times are written by mixer jobs thus cannot be read directly.
 		{
-			if (!m_requestBlocks[i].maxChannel)
-				continue;
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_performanceLock);
+			m_mixerThreadTimeSnapshot = m_mixerThreadTime;
+			m_channelTimesSnapshot = m_channelTimes;
+		}
+
+		if (m_threadMixer->stopped())
+			break;
+
+		// Submit frame block to driver.
+		m_driver->wait();
+		m_driver->submit(frameBlock);
+
+		// Move block back into heap.
+		m_samplesBlocks.push_back(frameBlock.samples[0]);
+	}
+}
+
+void AudioSystem::mixChannels(uint32_t job)
+{
+	const uint32_t frameSamples = m_desc.driverDesc.frameSamples;
+	const uint32_t hwChannels = m_desc.driverDesc.hwChannels;
+	float* samples = m_mixerJobSamples[job];
+	Timer timer;
 
-			T_ASSERT(m_requestBlocks[i].sampleRate == m_desc.driverDesc.sampleRate);
-			T_ASSERT(m_requestBlocks[i].samplesCount == m_desc.driverDesc.frameSamples);
+	if (job > 0)
+		m_mixer->mute(samples, frameSamples * hwChannels);
 
-			const float categoryVolume = getVolume(m_requestBlocks[i].category);
+	for (auto i : m_mixerJobChannels[job])
+	{
+		const double startTime = timer.getElapsedTime();
+
+		AudioBlock& block = m_requestBlocks[i];
+		block.samplesCount = frameSamples;
+		block.maxChannel = 0;
+		block.category = 0;
+
+		if (m_channels[i]->getPreparedBlock(m_mixer, block) && block.maxChannel > 0)
+		{
+			T_ASSERT(block.sampleRate == m_desc.driverDesc.sampleRate);
+			T_ASSERT(block.samplesCount == frameSamples);
+
+			const float categoryVolume = getVolume(block.category);
 			const float finalVolume = m_volume * categoryVolume;
 
-			for (uint32_t k = 0; k < m_requestBlocks[i].maxChannel; ++k)
+			// Combine channel into hardware channels using "combine matrix".
+			for (uint32_t k = 0; k < block.maxChannel; ++k)
 			{
-				if (!m_requestBlocks[i].samples[k])
+				if (!block.samples[k])
 					continue;
 
-				for (uint32_t j = 0; j < m_desc.driverDesc.hwChannels; ++j)
+				for (uint32_t j = 0; j < hwChannels; ++j)
 				{
 					const float strength = m_desc.cm[j][k] * finalVolume;
 					if (abs(strength) >= FUZZY_EPSILON)
 					{
 						m_mixer->addMulConst(
-							frameBlock.samples[j],
-							m_requestBlocks[i].samples[k],
-							m_requestBlocks[i].samplesCount,
+							samples + frameSamples * j,
+							block.samples[k],
+							block.samplesCount,
 							strength
 						);
 					}
 				}
-
-				m_mixer->synchronize();
 			}
 		}
 
-		m_time += double(m_desc.driverDesc.frameSamples) / m_desc.driverDesc.sampleRate;
-
-		if (m_threadMixer->stopped())
-			break;
-
-		// Submit frame block to driver.
-		m_driver->wait();
-		m_driver->submit(frameBlock);
-
-		// Move block back into heap.
-		m_samplesBlocks.push_back(frameBlock.samples[0]);
-
-		const double endTime = timerMixer.getElapsedTime();
-		m_mixerThreadTime = (endTime - startTime) * 0.1 + m_mixerThreadTime * 0.9;
+		const double endTime = timer.getElapsedTime();
+		m_channelTimes[i] = (endTime - startTime) * 0.1 + m_channelTimes[i] * 0.9;
 	}
+
+	m_mixer->synchronize();
 }
 
 }
@@ -14,6 +14,7 @@
 #include "Core/Containers/CircularVector.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Thread/Event.h"
+#include "Core/Thread/Job.h"
 #include "Core/Thread/Semaphore.h"
 #include "Core/Thread/Thread.h"
 #include "Sound/Types.h"
@@ -26,10 +27,18 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class JobQueue;
+
+}
+
 namespace traktor::sound
 {
 
 class AudioChannel;
+class IAudioBuffer;
 class IAudioDriver;
 class IAudioMixer;
 class Sound;
@@ -40,6 +49,10 @@ class Sound;
  * The AudioSystem class manages mixing sounds
  * from virtual channels and feeding them through the
  * submission thread into the audio driver for playback.
+ *
+ * Channels are decoded, filtered and mixed in parallel
+ * jobs; each job mix into it's own partial block which
+ * are finally added together by the mixer thread.
  */
 class T_DLLCLASS AudioSystem : public Object
 {
@@ -121,10 +134,16 @@ public:
 
 	/*! Query performance of each thread.
 	 *
-	 * \param outMixerTime Last mixer thread duration in seconds.
+	 * \param outMixerTime Last mixer thread duration, excluding waiting for driver, in seconds.
 	 */
 	void getThreadPerformances(double& outMixerTime) const;
 
+	/*! Query performance of each virtual channel.
+	 *
+	 * \param outChannelTimes Last decode, filter and mix duration of each channel in seconds.
+	 */
+	void getChannelPerformances(AlignedVector< double >& outChannelTimes) const;
+
 private:
 	Ref< IAudioDriver > m_driver;
 	Ref< IAudioMixer > m_mixer;
@@ -151,10 +170,35 @@ private:
 
 	// \}
 
+	// \name Mixer jobs
+	// \{
+
+	Ref< JobQueue > m_mixerQueue;
+	uint32_t m_mixerJobCount;
+	float* m_mixerJobsData;
+	AlignedVector< float* > m_mixerJobSamples;
+	AlignedVector< AlignedVector< uint32_t > > m_mixerJobChannels;
+	AlignedVector< Job::task_t > m_mixerJobTasks;
+	SmallMap< const IAudioBuffer*, uint32_t > m_mixerBufferJobs;
+
+	// \}
+
 	double m_time;
 	double m_mixerThreadTime;
+	AlignedVector< double > m_channelTimes;
+
+	// \name Performance snapshot, published by mixer thread after each block.
+	// \{
+
+	mutable Semaphore m_performanceLock;
+	double m_mixerThreadTimeSnapshot;
+	AlignedVector< double > m_channelTimesSnapshot;
+
+	// \}
 
 	void threadMixer();
+
+	void mixChannels(uint32_t job);
 };
 
 }
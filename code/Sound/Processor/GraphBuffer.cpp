@@ -10,6 +10,7 @@
 #include "Sound/Processor/Graph.h"
 #include "Sound/Processor/GraphBuffer.h"
 #include "Sound/Processor/GraphEvaluator.h"
+#include "Sound/Processor/GraphPlan.h"
 #include "Sound/Processor/Nodes/Output.h"
 
 namespace traktor::sound
@@ -39,11 +40,15 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.GraphBuffer", GraphBuffer, Object)
 
 GraphBuffer::GraphBuffer(const Graph* graph)
 :	m_graph(graph)
+,	m_plan(GraphPlan::compile(graph))
 {
 }
 
 Ref< IAudioBufferCursor > GraphBuffer::createCursor() const
 {
+	if (m_plan)
+		return m_plan->createCursor();
+
 	Ref< GraphBufferCursor > graphCursor = new GraphBufferCursor();
 
 	graphCursor->m_evaluator = new GraphEvaluator();
@@ -72,6 +77,9 @@ Ref< IAudioBufferCursor > GraphBuffer::createCursor() const
 
 bool GraphBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
+	if (m_plan)
+		return m_plan->getBlock(cursor, mixer, outBlock);
+
 	GraphBufferCursor* graphCursor = static_cast< GraphBufferCursor* >(cursor);
 
 	graphCursor->m_evaluator->flushCachedBlocks();
@@ -23,8 +23,13 @@ namespace traktor::sound
 {
 
 class Graph;
+class GraphPlan;
 
 /*! GraphBuffer instance.
+ *
+ * Graph is compiled into a plan once; graphs which
+ * cannot be compiled are evaluated by walking the
+ * graph for each block.
  */
 class T_DLLCLASS GraphBuffer : public IAudioBuffer
 {
@@ -39,6 +44,7 @@ public:
 
 private:
 	Ref< const Graph > m_graph;
+	Ref< const GraphPlan > m_plan;
 };
 
 }
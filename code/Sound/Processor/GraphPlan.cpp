@@ -0,0 +1,868 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include <cstring>
+#include "Core/RefArray.h"
+#include "Core/Containers/SmallMap.h"
+#include "Core/Containers/SmallSet.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Float.h"
+#include "Core/Math/MathUtils.h"
+#include "Core/Math/Vector4.h"
+#include "Core/Memory/Alloc.h"
+#include "Core/Misc/Align.h"
+#include "Core/Timer/Timer.h"
+#include "Sound/IAudioBuffer.h"
+#include "Sound/IAudioFilter.h"
+#include "Sound/IAudioMixer.h"
+#include "Sound/Sound.h"
+#include "Sound/Processor/Graph.h"
+#include "Sound/Processor/GraphPlan.h"
+#include "Sound/Processor/InputPin.h"
+#include "Sound/Processor/OutputPin.h"
+#include "Sound/Processor/Nodes/Add.h"
+#include "Sound/Processor/Nodes/Blend.h"
+#include "Sound/Processor/Nodes/Divide.h"
+#include "Sound/Processor/Nodes/Filter.h"
+#include "Sound/Processor/Nodes/Multiply.h"
+#include "Sound/Processor/Nodes/Output.h"
+#include "Sound/Processor/Nodes/Parameter.h"
+#include "Sound/Processor/Nodes/Pitch.h"
+#include "Sound/Processor/Nodes/Scalar.h"
+#include "Sound/Processor/Nodes/Sine.h"
+#include "Sound/Processor/Nodes/Source.h"
+#include "Sound/Processor/Nodes/Subtract.h"
+#include "Sound/Processor/Nodes/Time.h"
+
+namespace traktor::sound
+{
+	namespace
+	{
+
+const uint32_t c_maxSamples = 4096;
+const uint32_t c_sineSampleRate = 44100;
+
+class GraphPlanCursor : public RefCountImpl< IAudioBufferCursor >
+{
+public:
+	AlignedVector< float > m_scalars;
+	AlignedVector< uint8_t > m_scalarsValid;
+	AlignedVector< AudioBlock > m_signals;
+	AlignedVector< float* > m_signalStorage;
+	float* m_storage = nullptr;
+	RefArray< const IAudioBuffer > m_sourceBuffers;
+	RefArray< IAudioBufferCursor > m_sourceCursors;
+	RefArray< IAudioFilterInstance > m_filterInstances;
+	AlignedVector< double > m_phases;
+	AlignedVector< std::pair< handle_t, int32_t > > m_parameters;
+	Timer m_timer;
+
+	virtual ~GraphPlanCursor()
+	{
+		if (m_storage)
+			Alloc::freeAlign(m_storage);
+	}
+
+	virtual void setParameter(handle_t id, float parameter) override final
+	{
+		for (const auto& p : m_parameters)
+		{
+			if (p.first == id)
+				m_scalars[p.second] = parameter;
+		}
+		for (auto sourceCursor : m_sourceCursors)
+		{
+			if (sourceCursor)
+				sourceCursor->setParameter(id, parameter);
+		}
+	}
+
+	virtual void disableRepeat() override final
+	{
+		for (auto sourceCursor : m_sourceCursors)
+		{
+			if (sourceCursor)
+				sourceCursor->disableRepeat();
+		}
+	}
+
+	virtual void reset() override final
+	{
+		for (auto sourceCursor : m_sourceCursors)
+		{
+			if (sourceCursor)
+				sourceCursor->reset();
+		}
+	}
+};
+
+void copySamples(float* out, const float* in, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i += 4)
+		Vector4::loadAligned(&in[i]).storeAligned(&out[i]);
+}
+
+void scaleSamples(float* out, const float* in, uint32_t count, float factor)
+{
+	const traktor::Scalar f(factor);
+	for (uint32_t i = 0; i < count; i += 4)
+		(Vector4::loadAligned(&in[i]) * f).storeAligned(&out[i]);
+}
+
+void addSamples(float* out, const float* lh, const float* rh, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i += 4)
+		(Vector4::loadAligned(&lh[i]) + Vector4::loadAligned(&rh[i])).storeAligned(&out[i]);
+}
+
+void mulSamples(float* out, const float* lh, const float* rh, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i += 4)
+		(Vector4::loadAligned(&lh[i]) * Vector4::loadAligned(&rh[i])).storeAligned(&out[i]);
+}
+
+void blendSamples(float* out, const float* lh, const float* rh, uint32_t count, float weight)
+{
+	const traktor::Scalar w(weight);
+	for (uint32_t i = 0; i < count; i += 4)
+	{
+		const Vector4 l = Vector4::loadAligned(&lh[i]);
+		const Vector4 r = Vector4::loadAligned(&rh[i]);
+		(l + (r - l) * w).storeAligned(&out[i]);
+	}
+}
+
+/*! Generate sine by rotating four consecutive samples at a time. */
+void sineSamples(float* out, uint32_t count, double& inoutPhase, double omega, float amplitude)
+{
+	const double phase = inoutPhase;
+	Vector4 s(
+		float(std::sin(phase) * amplitude),
+		float(std::sin(phase + omega) * amplitude),
+		float(std::sin(phase + 2.0 * omega) * amplitude),
+		float(std::sin(phase + 3.0 * omega) * amplitude)
+	);
+	Vector4 c(
+		float(std::cos(phase) * amplitude),
+		float(std::cos(phase + omega) * amplitude),
+		float(std::cos(phase + 2.0 * omega) * amplitude),
+		float(std::cos(phase + 3.0 * omega) * amplitude)
+	);
+	const traktor::Scalar rs(float(std::sin(4.0 * omega)));
+	const traktor::Scalar rc(float(std::cos(4.0 * omega)));
+	for (uint32_t i = 0; i < count; i += 4)
+	{
+		s.storeAligned(&out[i]);
+		const Vector4 ns = s * rc + c * rs;
+		c = c * rc - s * rs;
+		s = ns;
+	}
+	inoutPhase = std::fmod(phase + count * omega, double(TWO_PI));
+}
+
+/*! Combine two, possibly missing, blocks into storage.
+ *
+ * Channels only present in one of the blocks are processed
+ * with "single" while channels present in both are processed
+ * with "both", samples beyond the shorter block are copied
+ * from the longer block.
+ */
+template < typename SingleFn, typename BothFn >
+bool combine(const AudioBlock* lh, const AudioBlock* rh, float* storage, AudioBlock& outBlock, const SingleFn& single, const BothFn& both)
+{
+	if (!lh && !rh)
+		return false;
+
+	const AudioBlock empty = { { 0 }, 0, 0, 0 };
+	const AudioBlock& l = lh ? *lh : empty;
+	const AudioBlock& r = rh ? *rh : empty;
+
+	outBlock.sampleRate = std::max(l.sampleRate, r.sampleRate);
+	outBlock.samplesCount = std::max(l.samplesCount, r.samplesCount);
+	outBlock.maxChannel = std::max(l.maxChannel, r.maxChannel);
+	outBlock.category = 0;
+
+	for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
+	{
+		const float* ls = (i < l.maxChannel) ? l.samples[i] : nullptr;
+		const float* rs = (i < r.maxChannel) ? r.samples[i] : nullptr;
+		float* out = storage + i * c_maxSamples;
+
+		if (ls && rs)
+		{
+			const uint32_t lc = alignUp(l.samplesCount, 4);
+			const uint32_t rc = alignUp(r.samplesCount, 4);
+			both(out, ls, rs, std::min(lc, rc));
+			if (lc > rc)
+				single(out + rc, ls + rc, lc - rc, true);
+			else if (rc > lc)
+				single(out + lc, rs + lc, rc - lc, false);
+			outBlock.samples[i] = out;
+		}
+		else if (ls)
+		{
+			single(out, ls, alignUp(l.samplesCount, 4), true);
+			outBlock.samples[i] = out;
+		}
+		else if (rs)
+		{
+			single(out, rs, alignUp(r.samplesCount, 4), false);
+			outBlock.samples[i] = out;
+		}
+		else
+			outBlock.samples[i] = nullptr;
+	}
+
+	return true;
+}
+
+	}
+
+struct GraphPlan::Compiler
+{
+	struct Signal
+	{
+		uint32_t channels = 0;	//!< Max number of channels of signal.
+		bool storage = false;	//!< If instruction writes into register storage.
+	};
+
+	const Graph* graph;
+	GraphPlan* plan;
+	SmallMap< std::pair< const OutputPin*, bool >, int32_t > registers;
+	SmallSet< const Node* > visiting;
+	AlignedVector< Signal > signals;
+	bool unsupported = false;
+
+	int32_t emitScalar(const Instruction& instruction)
+	{
+		Instruction& emitted = plan->m_instructions.push_back();
+		emitted = instruction;
+		emitted.output = (int32_t)plan->m_scalarCount++;
+		return emitted.output;
+	}
+
+	int32_t emitSignal(const Instruction& instruction, uint32_t channels, bool storage)
+	{
+		Instruction& emitted = plan->m_instructions.push_back();
+		emitted = instruction;
+		emitted.output = (int32_t)signals.size();
+		signals.push_back({ channels, storage });
+		return emitted.output;
+	}
+
+	int32_t scalar(const Node* node, uint32_t index)
+	{
+		const OutputPin* producerPin = graph->findSourcePin(node->getInputPin(index));
+		return producerPin ? compile(producerPin, false) : -1;
+	}
+
+	int32_t signal(const Node* node, uint32_t index)
+	{
+		const OutputPin* producerPin = graph->findSourcePin(node->getInputPin(index));
+		return producerPin ? compile(producerPin, true) : -1;
+	}
+
+	NodePinType pinType(const Node* node, uint32_t index) const
+	{
+		const OutputPin* producerPin = graph->findSourcePin(node->getInputPin(index));
+		return producerPin ? producerPin->getPinType() : NodePinType::Void;
+	}
+
+	int32_t compile(const OutputPin* producerPin, bool signal)
+	{
+		const auto key = std::make_pair(producerPin, signal);
+		const auto it = registers.find(key);
+		if (it != registers.end())
+			return it->second;
+
+		const Node* node = producerPin->getNode();
+		if (!visiting.insert(node))
+		{
+			log::error << L"Unable to compile sound graph; cycle at node \"" << type_name(node) << L"\"." << Endl;
+			unsupported = true;
+			return -1;
+		}
+
+		const int32_t output = signal ? compileSignal(node) : compileScalar(node);
+
+		visiting.erase(node);
+		registers.insert(key, output);
+		return output;
+	}
+
+	int32_t compileScalar(const Node* node)
+	{
+		Instruction i;
+		i.node = node;
+
+		if (auto scalarNode = dynamic_type_cast< const sound::Scalar* >(node))
+		{
+			i.op = OpCode::Scalar;
+			i.value = scalarNode->getValue();
+			return emitScalar(i);
+		}
+		else if (auto parameterNode = dynamic_type_cast< const Parameter* >(node))
+		{
+			i.op = OpCode::Parameter;
+			i.value = parameterNode->getDefaultValue();
+			i.parameter = getParameterHandle(parameterNode->getName());
+			return emitScalar(i);
+		}
+		else if (is_a< Time >(node))
+		{
+			i.op = OpCode::Time;
+			return emitScalar(i);
+		}
+		else if (is_a< Add >(node) || is_a< Subtract >(node) || is_a< Multiply >(node) || is_a< Divide >(node))
+		{
+			if (is_a< Add >(node))
+				i.op = OpCode::AddScalar;
+			else if (is_a< Subtract >(node))
+				i.op = OpCode::SubtractScalar;
+			else if (is_a< Multiply >(node))
+				i.op = OpCode::MultiplyScalar;
+			else
+				i.op = OpCode::DivideScalar;
+
+			if ((i.input[0] = scalar(node, 0)) < 0 || (i.input[1] = scalar(node, 1)) < 0)
+				return -1;
+
+			return emitScalar(i);
+		}
+		else if (is_a< Blend >(node))
+		{
+			i.op = OpCode::BlendScalar;
+			if ((i.input[0] = scalar(node, 0)) < 0 || (i.input[1] = scalar(node, 1)) < 0 || (i.input[2] = scalar(node, 2)) < 0)
+				return -1;
+			return emitScalar(i);
+		}
+		else if (is_a< Sine >(node))
+		{
+			i.op = OpCode::SineScalar;
+			if ((i.input[0] = scalar(node, 0)) < 0 || (i.input[1] = scalar(node, 1)) < 0)
+				return -1;
+			return emitScalar(i);
+		}
+		else if (is_a< Source >(node) || is_a< Filter >(node) || is_a< Pitch >(node))
+		{
+			// Signal only nodes.
+			return -1;
+		}
+
+		log::debug << L"Unable to compile sound graph; node \"" << type_name(node) << L"\" not supported, graph will be interpreted." << Endl;
+		unsupported = true;
+		return -1;
+	}
+
+	int32_t compileSignal(const Node* node)
+	{
+		Instruction i;
+		i.node = node;
+
+		if (is_a< Source >(node))
+		{
+			i.op = OpCode::Source;
+			return emitSignal(i, SbcMaxChannelCount, false);
+		}
+		else if (is_a< Filter >(node))
+		{
+			i.op = OpCode::Filter;
+			if ((i.input[0] = signal(node, 0)) < 0)
+				return -1;
+			return emitSignal(i, signals[i.input[0]].channels, false);
+		}
+		else if (is_a< Pitch >(node))
+		{
+			i.op = OpCode::Pitch;
+			if ((i.input[1] = scalar(node, 1)) < 0 || (i.input[0] = signal(node, 0)) < 0)
+				return -1;
+			return emitSignal(i, signals[i.input[0]].channels, false);
+		}
+		else if (is_a< Add >(node) || (is_a< Multiply >(node) && pinType(node, 0) == NodePinType::Signal && pinType(node, 1) == NodePinType::Signal))
+		{
+			i.op = is_a< Add >(node) ? OpCode::AddSignal : OpCode::MultiplySignal;
+			i.input[0] = signal(node, 0);
+			i.input[1] = signal(node, 1);
+			if (i.input[0] < 0 && i.input[1] < 0)
+				return -1;
+			return emitSignal(i, std::max(channels(i.input[0]), channels(i.input[1])), true);
+		}
+		else if (is_a< Multiply >(node))
+		{
+			const NodePinType pt0 = pinType(node, 0);
+			const NodePinType pt1 = pinType(node, 1);
+
+			uint32_t scalarIndex, signalIndex;
+			if (pt0 == NodePinType::Scalar && pt1 == NodePinType::Signal)
+				scalarIndex = 0, signalIndex = 1;
+			else if (pt0 == NodePinType::Signal && pt1 == NodePinType::Scalar)
+				scalarIndex = 1, signalIndex = 0;
+			else
+				return -1;
+
+			i.op = OpCode::ScaleSignal;
+			if ((i.input[0] = scalar(node, scalarIndex)) < 0 || (i.input[1] = signal(node, signalIndex)) < 0)
+				return -1;
+			return emitSignal(i, signals[i.input[1]].channels, true);
+		}
+		else if (is_a< Blend >(node))
+		{
+			i.op = OpCode::BlendSignal;
+			if ((i.input[2] = scalar(node, 2)) < 0)
+				return -1;
+			i.input[0] = signal(node, 0);
+			i.input[1] = signal(node, 1);
+			if (i.input[0] < 0 && i.input[1] < 0)
+				return -1;
+			return emitSignal(i, std::max(channels(i.input[0]), channels(i.input[1])), true);
+		}
+		else if (is_a< Sine >(node))
+		{
+			i.op = OpCode::SineSignal;
+			if ((i.input[0] = scalar(node, 0)) < 0 || (i.input[1] = scalar(node, 1)) < 0)
+				return -1;
+			return emitSignal(i, 1, true);
+		}
+		else if (is_a< Subtract >(node) || is_a< Divide >(node) || is_a< sound::Scalar >(node) || is_a< Parameter >(node) || is_a< Time >(node))
+		{
+			// Scalar only nodes.
+			return -1;
+		}
+
+		log::debug << L"Unable to compile sound graph; node \"" << type_name(node) << L"\" not supported, graph will be interpreted." << Endl;
+		unsupported = true;
+		return -1;
+	}
+
+	uint32_t channels(int32_t signal) const
+	{
+		return signal >= 0 ? signals[signal].channels : 0;
+	}
+
+	/*! Map virtual signal registers onto as few registers as possible. */
+	void allocateRegisters()
+	{
+		AlignedVector< uint32_t > uses(signals.size(), 0);
+		for (const auto& i : plan->m_instructions)
+		{
+			for (int32_t j = 0; j < 3; ++j)
+			{
+				if (isSignalInput(i.op, j) && i.input[j] >= 0)
+					uses[i.input[j]]++;
+			}
+		}
+		if (plan->m_output >= 0)
+			uses[plan->m_output]++;
+
+		AlignedVector< int32_t > physical(signals.size(), -1);
+		AlignedVector< int32_t > available;
+
+		for (auto& i : plan->m_instructions)
+		{
+			if (!isSignalOutput(i.op))
+				continue;
+
+			const int32_t output = i.output;
+
+			// Filter and pitch modify their input in place if they are the only consumer.
+			bool inPlace = false;
+			if ((i.op == OpCode::Filter || i.op == OpCode::Pitch) && uses[i.input[0]] == 1)
+			{
+				physical[output] = physical[i.input[0]];
+				uses[i.input[0]] = 0;
+				inPlace = true;
+			}
+			else
+			{
+				if (!available.empty())
+				{
+					physical[output] = available.back();
+					available.pop_back();
+				}
+				else
+				{
+					physical[output] = (int32_t)plan->m_signalChannels.size();
+					plan->m_signalChannels.push_back(0);
+				}
+
+				// Filter and pitch copy their input into storage when there are other consumers.
+				const bool storage = signals[output].storage || i.op == OpCode::Filter || i.op == OpCode::Pitch;
+				if (storage)
+					plan->m_signalChannels[physical[output]] = std::max(plan->m_signalChannels[physical[output]], signals[output].channels);
+			}
+
+			for (int32_t j = 0; j < 3; ++j)
+			{
+				if (!isSignalInput(i.op, j) || i.input[j] < 0)
+					continue;
+				const int32_t input = i.input[j];
+				i.input[j] = physical[input];
+				if (!inPlace && --uses[input] == 0)
+					available.push_back(physical[input]);
+			}
+
+			i.output = physical[output];
+		}
+
+		if (plan->m_output >= 0)
+			plan->m_output = physical[plan->m_output];
+	}
+
+	static bool isSignalOutput(OpCode op)
+	{
+		return op >= OpCode::Source;
+	}
+
+	static bool isSignalInput(OpCode op, int32_t index)
+	{
+		switch (op)
+		{
+		case OpCode::Filter:
+			return index == 0;
+		case OpCode::Pitch:
+			return index == 0;
+		case OpCode::AddSignal:
+		case OpCode::MultiplySignal:
+			return index <= 1;
+		case OpCode::ScaleSignal:
+			return index == 1;
+		case OpCode::BlendSignal:
+			return index <= 1;
+		default:
+			return false;
+		}
+	}
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.GraphPlan", GraphPlan, Object)
+
+Ref< GraphPlan > GraphPlan::compile(const Graph* graph)
+{
+	const Node* outputNode = nullptr;
+	for (auto node : graph->getNodes())
+	{
+		if (is_a< Output >(node))
+		{
+			outputNode = node;
+			break;
+		}
+	}
+	if (!outputNode)
+		return nullptr;
+
+	Ref< GraphPlan > plan = new GraphPlan();
+
+	Compiler compiler;
+	compiler.graph = graph;
+	compiler.plan = plan;
+
+	const OutputPin* producerPin = graph->findSourcePin(outputNode->getInputPin(0));
+	if (producerPin)
+		plan->m_output = compiler.compile(producerPin, true);
+
+	if (compiler.unsupported)
+		return nullptr;
+
+	compiler.allocateRegisters();
+	return plan;
+}
+
+Ref< IAudioBufferCursor > GraphPlan::createCursor() const
+{
+	Ref< GraphPlanCursor > cursor = new GraphPlanCursor();
+
+	cursor->m_scalars.resize(m_scalarCount, 0.0f);
+	cursor->m_scalarsValid.resize(m_scalarCount, 0);
+	cursor->m_signals.resize(m_signalChannels.size());
+	cursor->m_signalStorage.resize(m_signalChannels.size(), nullptr);
+	cursor->m_sourceBuffers.resize(m_instructions.size());
+	cursor->m_sourceCursors.resize(m_instructions.size());
+	cursor->m_filterInstances.resize(m_instructions.size());
+	cursor->m_phases.resize(m_instructions.size(), 0.0);
+
+	// Allocate storage of all signal registers.
+	uint32_t storageSize = 0;
+	for (auto channels : m_signalChannels)
+		storageSize += channels * c_maxSamples;
+	if (storageSize > 0)
+	{
+		cursor->m_storage = static_cast< float* >(Alloc::acquireAlign(storageSize * sizeof(float), 16, T_FILE_LINE));
+		if (!cursor->m_storage)
+			return nullptr;
+
+		std::memset(cursor->m_storage, 0, storageSize * sizeof(float));
+
+		float* storage = cursor->m_storage;
+		for (uint32_t i = 0; i < m_signalChannels.size(); ++i)
+		{
+			if (m_signalChannels[i] > 0)
+				cursor->m_signalStorage[i] = storage;
+			storage += m_signalChannels[i] * c_maxSamples;
+		}
+	}
+
+	for (uint32_t i = 0; i < m_instructions.size(); ++i)
+	{
+		const Instruction& in = m_instructions[i];
+		if (in.op == OpCode::Parameter)
+		{
+			cursor->m_scalars[in.output] = in.value;
+			cursor->m_scalarsValid[in.output] = 1;
+			cursor->m_parameters.push_back(std::make_pair(in.parameter, in.output));
+		}
+		else if (in.op == OpCode::Source)
+		{
+			const Sound* sound = static_cast< const Source* >(in.node)->getSound().getResource();
+			if (!sound || !sound->getBuffer())
+				return nullptr;
+
+			cursor->m_sourceBuffers[i] = sound->getBuffer();
+			if ((cursor->m_sourceCursors[i] = sound->getBuffer()->createCursor()) == nullptr)
+				return nullptr;
+		}
+		else if (in.op == OpCode::Filter)
+		{
+			const IAudioFilter* filter = static_cast< const Filter* >(in.node)->getFilter();
+			if (!filter)
+				return nullptr;
+
+			if ((cursor->m_filterInstances[i] = filter->createInstance()) == nullptr)
+				return nullptr;
+		}
+	}
+
+	cursor->m_timer.reset();
+	return cursor;
+}
+
+bool GraphPlan::getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	GraphPlanCursor* planCursor = static_cast< GraphPlanCursor* >(cursor);
+	float* scalars = planCursor->m_scalars.ptr();
+	uint8_t* valid = planCursor->m_scalarsValid.ptr();
+	AudioBlock* signals = planCursor->m_signals.ptr();
+
+	const uint32_t samplesCount = std::min(outBlock.samplesCount, c_maxSamples);
+	const float time = float(planCursor->m_timer.getElapsedTime());
+
+	auto signalOf = [&](int32_t index) -> const AudioBlock* {
+		return (index >= 0 && signals[index].maxChannel > 0) ? &signals[index] : nullptr;
+	};
+
+	// Copy input into storage of output register unless evaluated in place.
+	auto prepareInPlace = [&](const Instruction& in) -> AudioBlock* {
+		const AudioBlock* input = signalOf(in.input[0]);
+		if (!input)
+			return nullptr;
+
+		AudioBlock& output = signals[in.output];
+		if (in.output != in.input[0])
+		{
+			T_ASSERT(alignUp(input->samplesCount, 4) <= c_maxSamples);
+			float* storage = planCursor->m_signalStorage[in.output];
+			output = *input;
+			for (uint32_t i = 0; i < input->maxChannel; ++i)
+			{
+				if (input->samples[i])
+				{
+					output.samples[i] = storage + i * c_maxSamples;
+					copySamples(output.samples[i], input->samples[i], alignUp(input->samplesCount, 4));
+				}
+			}
+		}
+		return &output;
+	};
+
+	for (uint32_t ii = 0; ii < m_instructions.size(); ++ii)
+	{
+		const Instruction& in = m_instructions[ii];
+		switch (in.op)
+		{
+		case OpCode::Scalar:
+			scalars[in.output] = in.value;
+			valid[in.output] = 1;
+			break;
+
+		case OpCode::Parameter:
+			break;
+
+		case OpCode::Time:
+			scalars[in.output] = time;
+			valid[in.output] = 1;
+			break;
+
+		case OpCode::AddScalar:
+			scalars[in.output] = scalars[in.input[0]] + scalars[in.input[1]];
+			valid[in.output] = valid[in.input[0]] & valid[in.input[1]];
+			break;
+
+		case OpCode::SubtractScalar:
+			scalars[in.output] = scalars[in.input[0]] - scalars[in.input[1]];
+			valid[in.output] = valid[in.input[0]] & valid[in.input[1]];
+			break;
+
+		case OpCode::MultiplyScalar:
+			scalars[in.output] = scalars[in.input[0]] * scalars[in.input[1]];
+			valid[in.output] = valid[in.input[0]] & valid[in.input[1]];
+			break;
+
+		case OpCode::DivideScalar:
+			scalars[in.output] = scalars[in.input[0]] / scalars[in.input[1]];
+			valid[in.output] = valid[in.input[0]] & valid[in.input[1]];
+			break;
+
+		case OpCode::BlendScalar:
+			scalars[in.output] = lerp(scalars[in.input[0]], scalars[in.input[1]], scalars[in.input[2]]);
+			valid[in.output] = valid[in.input[0]] & valid[in.input[1]] & valid[in.input[2]];
+			break;
+
+		case OpCode::SineScalar:
+			{
+				const float frequency = scalars[in.input[0]];
+				const float amplitude = scalars[in.input[1]];
+				valid[in.output] = (valid[in.input[0]] & valid[in.input[1]]) && frequency > 0.0f && amplitude > 0.0f;
+				scalars[in.output] = std::sin(time * TWO_PI * frequency) * amplitude;
+			}
+			break;
+
+		case OpCode::Source:
+			{
+				AudioBlock& output = signals[in.output];
+				output = { { 0 }, samplesCount, 0, 0, 0 };
+				if (!planCursor->m_sourceBuffers[ii]->getBlock(planCursor->m_sourceCursors[ii], mixer, output))
+				{
+					output.maxChannel = 0;
+					break;
+				}
+
+				// Register storage cannot hold more samples, excess samples of source block are dropped.
+				output.samplesCount = std::min(output.samplesCount, c_maxSamples);
+
+				const float gain = static_cast< const Source* >(in.node)->getSound().getResource()->getGain();
+				if (gain != 0.0f)
+				{
+					const float linearGain = decibelToLinear(gain);
+					for (uint32_t i = 0; i < output.maxChannel; ++i)
+					{
+						if (output.samples[i])
+							mixer->mulConst(output.samples[i], alignUp(output.samplesCount, 4), linearGain);
+					}
+				}
+			}
+			break;
+
+		case OpCode::Filter:
+			{
+				AudioBlock* output = prepareInPlace(in);
+				if (!output)
+				{
+					signals[in.output].maxChannel = 0;
+					break;
+				}
+				static_cast< const Filter* >(in.node)->getFilter()->apply(planCursor->m_filterInstances[ii], *output);
+			}
+			break;
+
+		case OpCode::Pitch:
+			{
+				const float adjust = scalars[in.input[1]];
+				AudioBlock* output = (valid[in.input[1]] && adjust > 0.0f) ? prepareInPlace(in) : nullptr;
+				if (!output)
+				{
+					signals[in.output].maxChannel = 0;
+					break;
+				}
+				output->sampleRate = uint32_t(output->sampleRate * adjust + 0.5f);
+			}
+			break;
+
+		case OpCode::AddSignal:
+			if (!combine(
+				signalOf(in.input[0]),
+				signalOf(in.input[1]),
+				planCursor->m_signalStorage[in.output],
+				signals[in.output],
+				[](float* out, const float* in, uint32_t count, bool) { copySamples(out, in, count); },
+				[](float* out, const float* lh, const float* rh, uint32_t count) { addSamples(out, lh, rh, count); }
+			))
+				signals[in.output].maxChannel = 0;
+			break;
+
+		case OpCode::MultiplySignal:
+			if (!combine(
+				signalOf(in.input[0]),
+				signalOf(in.input[1]),
+				planCursor->m_signalStorage[in.output],
+				signals[in.output],
+				[](float* out, const float* in, uint32_t count, bool) { copySamples(out, in, count); },
+				[](float* out, const float* lh, const float* rh, uint32_t count) { mulSamples(out, lh, rh, count); }
+			))
+				signals[in.output].maxChannel = 0;
+			break;
+
+		case OpCode::ScaleSignal:
+			{
+				const float factor = scalars[in.input[0]];
+				const AudioBlock* input = valid[in.input[0]] ? signalOf(in.input[1]) : nullptr;
+				if (!combine(
+					input,
+					nullptr,
+					planCursor->m_signalStorage[in.output],
+					signals[in.output],
+					[=](float* out, const float* in, uint32_t count, bool) { scaleSamples(out, in, count, factor); },
+					[](float* out, const float* lh, const float* rh, uint32_t count) {}
+				))
+					signals[in.output].maxChannel = 0;
+			}
+			break;
+
+		case OpCode::BlendSignal:
+			{
+				const float weight = scalars[in.input[2]];
+				if (!valid[in.input[2]] || !combine(
+					signalOf(in.input[0]),
+					signalOf(in.input[1]),
+					planCursor->m_signalStorage[in.output],
+					signals[in.output],
+					[=](float* out, const float* in, uint32_t count, bool first) { scaleSamples(out, in, count, first ? 1.0f - weight : weight); },
+					[=](float* out, const float* lh, const float* rh, uint32_t count) { blendSamples(out, lh, rh, count, weight); }
+				))
+					signals[in.output].maxChannel = 0;
+			}
+			break;
+
+		case OpCode::SineSignal:
+			{
+				const float frequency = scalars[in.input[0]];
+				const float amplitude = scalars[in.input[1]];
+				AudioBlock& output = signals[in.output];
+				if (!(valid[in.input[0]] & valid[in.input[1]]) || frequency <= 0.0f || amplitude <= 0.0f)
+				{
+					output.maxChannel = 0;
+					break;
+				}
+
+				output = { { 0 }, alignUp(samplesCount, 4), c_sineSampleRate, 1, 0 };
+				output.samples[0] = planCursor->m_signalStorage[in.output];
+				sineSamples(output.samples[0], output.samplesCount, planCursor->m_phases[ii], TWO_PI * double(frequency) / c_sineSampleRate, amplitude);
+			}
+			break;
+		}
+	}
+
+	const AudioBlock* output = signalOf(m_output);
+	if (!output)
+		return false;
+
+	outBlock = *output;
+	return true;
+}
+
+}
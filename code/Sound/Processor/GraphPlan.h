@@ -0,0 +1,106 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Sound/Types.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_SOUND_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::sound
+{
+
+class Graph;
+class IAudioBufferCursor;
+class IAudioMixer;
+class Node;
+
+/*! Compiled processor graph.
+ * \ingroup Sound
+ *
+ * Nodes reachable from the graph's output are compiled
+ * once into a flat list of instructions, sorted in
+ * evaluation order, reading and writing registers.
+ * Signal registers are reused as soon as all consumers
+ * have been evaluated and each cursor preallocates all
+ * storage thus evaluating blocks doesn't touch the heap.
+ */
+class T_DLLCLASS GraphPlan : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	/*! Compile graph into plan.
+	 *
+	 * \param graph Processor graph.
+	 * \return Plan, null if graph contain nodes which cannot be compiled.
+	 */
+	static Ref< GraphPlan > compile(const Graph* graph);
+
+	/*! Create cursor with preallocated registers. */
+	Ref< IAudioBufferCursor > createCursor() const;
+
+	/*! Evaluate next block of plan. */
+	bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const;
+
+	/*! Number of instructions. */
+	uint32_t getInstructionCount() const { return (uint32_t)m_instructions.size(); }
+
+	/*! Number of signal registers after reuse. */
+	uint32_t getSignalRegisterCount() const { return (uint32_t)m_signalChannels.size(); }
+
+private:
+	struct Compiler;
+
+	enum class OpCode : uint8_t
+	{
+		Scalar,
+		Parameter,
+		Time,
+		AddScalar,
+		SubtractScalar,
+		MultiplyScalar,
+		DivideScalar,
+		BlendScalar,
+		SineScalar,
+		Source,
+		Filter,
+		Pitch,
+		AddSignal,
+		MultiplySignal,
+		ScaleSignal,
+		BlendSignal,
+		SineSignal
+	};
+
+	struct Instruction
+	{
+		OpCode op;
+		int32_t input[3] = { -1, -1, -1 };	//!< Scalar or signal register of each input, -1 if input is invalid.
+		int32_t output = -1;				//!< Scalar or signal register of output.
+		float value = 0.0f;
+		handle_t parameter = 0;
+		const Node* node = nullptr;
+	};
+
+	AlignedVector< Instruction > m_instructions;
+	AlignedVector< uint32_t > m_signalChannels;	//!< Number of channels with storage in each signal register.
+	uint32_t m_scalarCount = 0;
+	int32_t m_output = -1;
+};
+
+}
@@ -42,6 +42,8 @@ public:
 
 	virtual void serialize(ISerializer& s) override final;
 
+	const IAudioFilter* getFilter() const { return m_filter; }
+
 private:
 	Ref< const IAudioFilter > m_filter;
 };
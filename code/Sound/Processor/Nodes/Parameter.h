@@ -42,6 +42,8 @@ public:
 
 	const std::wstring& getName() const { return m_name; }
 
+	float getDefaultValue() const { return m_defaultValue; }
+
 private:
 	std::wstring m_name;
 	float m_defaultValue = 0.0f;
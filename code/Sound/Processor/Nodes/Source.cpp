@@ -112,11 +112,15 @@ bool Source::getBlock(IAudioBufferCursor* cursor, const GraphEvaluator* evaluato
 	if (m_sound->getGain() != 0.0f)
 	{
 		const float gain = decibelToLinear(m_sound->getGain());
-		mixer->mulConst(
-			outBlock.samples[0],
-			outBlock.samplesCount,
-			gain
-		);
+		for (uint32_t i = 0; i < outBlock.maxChannel; ++i)
+		{
+			if (outBlock.samples[i])
+				mixer->mulConst(
+					outBlock.samples[i],
+					outBlock.samplesCount,
+					gain
+				);
+		}
 	}
 
 	return true;
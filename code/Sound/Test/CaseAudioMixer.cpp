@@ -0,0 +1,225 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Sound/Test/CaseAudioMixer.h"
+
+#include <cmath>
+#include "Core/RefArray.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Thread/Signal.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Sound/AudioChannel.h"
+#include "Sound/AudioDriverNull.h"
+#include "Sound/AudioSystem.h"
+#include "Sound/IAudioDriver.h"
+#include "Sound/StaticAudioBuffer.h"
+#include "Sound/Filters/LowPassFilter.h"
+#include "Sound/Filters/ReverbFilter.h"
+
+namespace traktor::sound::test
+{
+namespace
+{
+
+const uint32_t c_channels = 64;
+const uint32_t c_buffers = 16;
+const uint32_t c_sampleRate = 48000;
+const uint32_t c_frameSamples = 1024;
+const uint32_t c_hwChannels = 2;
+const uint32_t c_capturedBlocks = 8;
+const uint32_t c_measureTime = 1000;
+const uint32_t c_mixerJobs = 4;
+
+/*! Capture mixed blocks; mixer is held in first wait until test has started all channels. */
+class CaptureAudioDriver : public RefCountImpl< IAudioDriver >
+{
+public:
+	Signal m_waiting;
+	Signal m_started;
+	Signal m_captured;
+	AlignedVector< float > m_samples;
+
+	virtual bool create(const SystemApplication& sysapp, const AudioDriverCreateDesc& desc, Ref< IAudioMixer >& outMixer) override final
+	{
+		return true;
+	}
+
+	virtual void destroy() override final
+	{
+	}
+
+	virtual void wait() override final
+	{
+		if (m_first)
+		{
+			m_first = false;
+			m_waiting.set();
+			m_started.wait();
+		}
+	}
+
+	virtual void submit(const AudioBlock& block) override final
+	{
+		// First block is mixed before any channel is started.
+		if (m_blocks++ == 0 || m_samples.size() >= c_capturedBlocks * c_frameSamples * c_hwChannels)
+			return;
+
+		for (uint32_t i = 0; i < c_hwChannels; ++i)
+			m_samples.insert(m_samples.end(), block.samples[i], block.samples[i] + block.samplesCount);
+
+		if (m_samples.size() >= c_capturedBlocks * c_frameSamples * c_hwChannels)
+			m_captured.set();
+	}
+
+private:
+	bool m_first = true;
+	uint32_t m_blocks = 0;
+};
+
+bool mix(uint32_t mixerJobs, const RefArray< StaticAudioBuffer >& buffers, const IAudioFilter* reverb, const IAudioFilter* lowPass, AlignedVector< float >& outSamples)
+{
+	sound::AudioSystemCreateDesc desc;
+	desc.channels = c_channels;
+	desc.mixerJobs = mixerJobs;
+	desc.driverDesc.sampleRate = c_sampleRate;
+	desc.driverDesc.bitsPerSample = 16;
+	desc.driverDesc.hwChannels = c_hwChannels;
+	desc.driverDesc.frameSamples = c_frameSamples;
+
+	Ref< CaptureAudioDriver > driver = new CaptureAudioDriver();
+	Ref< AudioSystem > audioSystem = new AudioSystem(driver);
+	if (!audioSystem->create(desc))
+		return false;
+
+	// Every channel is filtered; each buffer is played on multiple channels.
+	driver->m_waiting.wait();
+	for (uint32_t i = 0; i < c_channels; ++i)
+	{
+		AudioChannel* channel = audioSystem->getChannel(i);
+		channel->setFilter((i & 1) ? lowPass : reverb);
+		channel->play(buffers[i % c_buffers], 0, -12.0f, true, 0);
+	}
+	driver->m_started.set();
+	driver->m_captured.wait();
+
+	audioSystem->destroy();
+
+	outSamples = driver->m_samples;
+	return true;
+}
+
+struct Measurement
+{
+	double mixerTime = 0.0;
+	double channelsTime = 0.0;
+	uint32_t channelsPlaying = 0;
+};
+
+Measurement measure(uint32_t mixerJobs, const RefArray< StaticAudioBuffer >& buffers, const IAudioFilter* reverb, const IAudioFilter* lowPass)
+{
+	Measurement m;
+
+	sound::AudioSystemCreateDesc desc;
+	desc.channels = c_channels;
+	desc.mixerJobs = mixerJobs;
+	desc.driverDesc.sampleRate = c_sampleRate;
+	desc.driverDesc.bitsPerSample = 16;
+	desc.driverDesc.hwChannels = c_hwChannels;
+	desc.driverDesc.frameSamples = c_frameSamples;
+
+	Ref< AudioSystem > audioSystem = new AudioSystem(new AudioDriverNull());
+	if (!audioSystem->create(desc))
+		return m;
+
+	for (uint32_t i = 0; i < c_channels; ++i)
+	{
+		AudioChannel* channel = audioSystem->getChannel(i);
+		channel->setFilter((i & 1) ? lowPass : reverb);
+		channel->play(buffers[i % c_buffers], 0, -12.0f, true, 0);
+	}
+
+	ThreadManager::getInstance().getCurrentThread()->sleep(c_measureTime);
+
+	AlignedVector< double > channelTimes;
+	audioSystem->getThreadPerformances(m.mixerTime);
+	audioSystem->getChannelPerformances(channelTimes);
+	for (auto channelTime : channelTimes)
+	{
+		m.channelsTime += channelTime;
+		m.channelsPlaying += (channelTime > 0.0) ? 1 : 0;
+	}
+
+	audioSystem->destroy();
+	return m;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseAudioMixer", 0, CaseAudioMixer, traktor::test::Case)
+
+void CaseAudioMixer::run()
+{
+	// Create a few seconds long, looping, tones.
+	RefArray< StaticAudioBuffer > buffers;
+	for (uint32_t i = 0; i < c_buffers; ++i)
+	{
+		const uint32_t samplesCount = c_sampleRate * 2;
+		Ref< StaticAudioBuffer > buffer = new StaticAudioBuffer();
+		CASE_ASSERT(buffer->create(c_sampleRate, samplesCount, 2));
+
+		const float frequency = 220.0f + i * 55.0f;
+		for (uint32_t j = 0; j < 2; ++j)
+		{
+			int16_t* samples = buffer->getSamplesData(j);
+			for (uint32_t k = 0; k < samplesCount; ++k)
+				samples[k] = int16_t(std::sin(TWO_PI * frequency * k / c_sampleRate + j) * 16000.0f);
+		}
+
+		buffers.push_back(buffer);
+	}
+
+	Ref< ReverbFilter > reverb = new ReverbFilter();
+	Ref< LowPassFilter > lowPass = new LowPassFilter(2000.0f);
+
+	// Mixing in parallel jobs only change order of summation.
+	AlignedVector< float > serial;
+	AlignedVector< float > parallel;
+	CASE_ASSERT(mix(1, buffers, reverb, lowPass, serial));
+	CASE_ASSERT(mix(c_mixerJobs, buffers, reverb, lowPass, parallel));
+	CASE_ASSERT_EQUAL(serial.size(), parallel.size());
+	if (serial.size() != parallel.size())
+		return;
+
+	float peak = 0.0f;
+	float maxError = 0.0f;
+	for (size_t i = 0; i < serial.size(); ++i)
+	{
+		peak = std::max(peak, std::abs(serial[i]));
+		maxError = std::max(maxError, std::abs(serial[i] - parallel[i]));
+	}
+	CASE_ASSERT(peak > 0.01f);
+	CASE_ASSERT(maxError < 1e-4f);
+
+	// Measure headless, driver doesn't wait thus mixer runs as fast as possible.
+	const Measurement serialTime = measure(1, buffers, reverb, lowPass);
+	const Measurement parallelTime = measure(c_mixerJobs, buffers, reverb, lowPass);
+
+	CASE_ASSERT(serialTime.mixerTime > 0.0);
+	CASE_ASSERT(parallelTime.mixerTime > 0.0);
+	CASE_ASSERT_EQUAL(serialTime.channelsPlaying, c_channels);
+	CASE_ASSERT_EQUAL(parallelTime.channelsPlaying, c_channels);
+
+	const double blockTime = double(c_frameSamples) / c_sampleRate;
+	log::info << L"AudioSystem, " << c_channels << L" channels, " << c_buffers << L" buffers, block " << int32_t(blockTime * 1e6) << L" us" << Endl;
+	log::info << L"  serial mixer " << int32_t(serialTime.mixerTime * 1e6) << L" us (channels " << int32_t(serialTime.channelsTime * 1e6) << L" us)" << Endl;
+	log::info << L"  parallel mixer, " << c_mixerJobs << L" jobs, " << int32_t(parallelTime.mixerTime * 1e6) << L" us (channels " << int32_t(parallelTime.channelsTime * 1e6) << L" us)" << Endl;
+}
+
+}
@@ -0,0 +1,173 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Sound/Test/CaseGraphPlan.h"
+
+#include <cmath>
+#include "Core/Math/Const.h"
+#include "Core/Reflection/Reflection.h"
+#include "Core/Reflection/RfmPrimitive.h"
+#include "Core/Reflection/RfpMemberName.h"
+#include "Sound/AudioMixer.h"
+#include "Sound/IAudioBuffer.h"
+#include "Sound/Processor/Edge.h"
+#include "Sound/Processor/Graph.h"
+#include "Sound/Processor/GraphEvaluator.h"
+#include "Sound/Processor/GraphPlan.h"
+#include "Sound/Processor/Nodes/Add.h"
+#include "Sound/Processor/Nodes/Blend.h"
+#include "Sound/Processor/Nodes/Multiply.h"
+#include "Sound/Processor/Nodes/Output.h"
+#include "Sound/Processor/Nodes/Pitch.h"
+#include "Sound/Processor/Nodes/Scalar.h"
+#include "Sound/Processor/Nodes/Sine.h"
+
+namespace traktor::sound::test
+{
+namespace
+{
+
+const uint32_t c_samplesCount = 1024;
+const uint32_t c_blocks = 16;
+
+Ref< Node > scalar(float value)
+{
+	Ref< sound::Scalar > node = new sound::Scalar();
+	Ref< Reflection > reflection = Reflection::create(node);
+	auto member = dynamic_type_cast< RfmPrimitiveFloat* >(reflection->findMember(RfpMemberName(L"value")));
+	if (!member)
+		return nullptr;
+	member->set(value);
+	reflection->apply(node);
+	return node;
+}
+
+void connect(Graph* graph, Node* source, Node* destination, uint32_t input)
+{
+	graph->addEdge(new Edge(source->getOutputPin(0), destination->getInputPin(input)));
+}
+
+/*! out = pitch(blend(0.8 * (sine(2 * 220, 0.5) + sine(660, 0.25)), sine(2 * 220, 0.5), 0.3), 1.5) */
+Ref< Graph > createGraph()
+{
+	Ref< Graph > graph = new Graph();
+
+	Ref< Node > two = scalar(2.0f);
+	Ref< Node > f0 = scalar(220.0f);
+	Ref< Node > f1 = new Multiply();
+	Ref< Node > a1 = scalar(0.5f);
+	Ref< Node > s1 = new Sine();
+	Ref< Node > f2 = scalar(660.0f);
+	Ref< Node > a2 = scalar(0.25f);
+	Ref< Node > s2 = new Sine();
+	Ref< Node > add = new Add();
+	Ref< Node > k = scalar(0.8f);
+	Ref< Node > mul = new Multiply();
+	Ref< Node > w = scalar(0.3f);
+	Ref< Node > blend = new Blend();
+	Ref< Node > adjust = scalar(1.5f);
+	Ref< Node > pitch = new Pitch();
+	Ref< Node > output = new Output();
+
+	for (auto node : { two, f0, f1, a1, s1, f2, a2, s2, add, k, mul, w, blend, adjust, pitch, output })
+		graph->addNode(node);
+
+	connect(graph, two, f1, 0);
+	connect(graph, f0, f1, 1);
+	connect(graph, f1, s1, 0);
+	connect(graph, a1, s1, 1);
+	connect(graph, f2, s2, 0);
+	connect(graph, a2, s2, 1);
+	connect(graph, s1, add, 0);
+	connect(graph, s2, add, 1);
+	connect(graph, add, mul, 0);
+	connect(graph, k, mul, 1);
+	connect(graph, mul, blend, 0);
+	connect(graph, s1, blend, 1);
+	connect(graph, w, blend, 2);
+	connect(graph, blend, pitch, 0);
+	connect(graph, adjust, pitch, 1);
+	connect(graph, pitch, output, 0);
+
+	return graph;
+}
+
+double expected(uint32_t n)
+{
+	const double t = double(n) / 44100.0;
+	const double s1 = 0.5 * std::sin(TWO_PI * 440.0 * t);
+	const double s2 = 0.25 * std::sin(TWO_PI * 660.0 * t);
+	return 0.7 * (0.8 * (s1 + s2)) + 0.3 * s1;
+}
+
+}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseGraphPlan", 0, CaseGraphPlan, traktor::test::Case)
+
+void CaseGraphPlan::run()
+{
+	Ref< AudioMixer > mixer = new AudioMixer();
+	Ref< Graph > graph = createGraph();
+
+	RefArray< Output > outputs;
+	graph->findNodesOf< Output >(outputs);
+	const InputPin* outputPin = outputs[0]->getInputPin(0);
+
+	Ref< GraphPlan > plan = GraphPlan::compile(graph);
+	CASE_ASSERT(plan != nullptr);
+	if (!plan)
+		return;
+
+	Ref< IAudioBufferCursor > cursor = plan->createCursor();
+	CASE_ASSERT(cursor != nullptr);
+	if (!cursor)
+		return;
+
+	Ref< GraphEvaluator > evaluator = new GraphEvaluator();
+	CASE_ASSERT(evaluator->create(graph));
+
+	// Compare with analytic signal, and first block with interpreted graph.
+	float maxError = 0.0f;
+	float maxInterpretedError = 0.0f;
+	for (uint32_t i = 0; i < c_blocks; ++i)
+	{
+		AudioBlock block = { { 0 }, c_samplesCount, 0, 0, 0 };
+		CASE_ASSERT(plan->getBlock(cursor, mixer, block));
+		CASE_ASSERT_EQUAL(block.samplesCount, c_samplesCount);
+		CASE_ASSERT_EQUAL(block.sampleRate, (uint32_t)66150);
+		CASE_ASSERT_EQUAL(block.maxChannel, (uint32_t)1);
+		if (!block.samples[0])
+			return;
+
+		for (uint32_t j = 0; j < c_samplesCount; ++j)
+			maxError = std::max(maxError, std::abs(block.samples[0][j] - float(expected(i * c_samplesCount + j))));
+
+		if (i == 0)
+		{
+			AudioBlock interpreted = { { 0 }, c_samplesCount, 0, 0, 0 };
+			evaluator->flushCachedBlocks();
+			CASE_ASSERT(evaluator->evaluateBlock(outputPin, mixer, interpreted));
+			CASE_ASSERT_EQUAL(interpreted.sampleRate, block.sampleRate);
+			for (uint32_t j = 0; j < c_samplesCount; ++j)
+				maxInterpretedError = std::max(maxInterpretedError, std::abs(block.samples[0][j] - interpreted.samples[0][j]));
+		}
+	}
+
+	// Interpreted sine accumulate time in single precision thus less accurate.
+	CASE_ASSERT(maxError < 1e-4f);
+	CASE_ASSERT(maxInterpretedError < 1e-3f);
+
+	// Blocks larger than plan storage are clamped.
+	AudioBlock block = { { 0 }, 8192, 0, 0, 0 };
+	CASE_ASSERT(plan->getBlock(cursor, mixer, block));
+	CASE_ASSERT_EQUAL(block.samplesCount, (uint32_t)4096);
+
+	evaluator->flushCachedBlocks();
+}
+
+}
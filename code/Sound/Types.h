@@ -82,11 +82,13 @@ struct AudioSystemCreateDesc
 {
 	SystemApplication sysapp;
 	uint32_t channels;									//!< Number of virtual channels.
+	uint32_t mixerJobs;									//!< Number of parallel mixer jobs, 0 for one per CPU core; default serial mixing.
 	AudioDriverCreateDesc driverDesc;					//!< Driver create description.
 	float cm[SbcMaxChannelCount][SbcMaxChannelCount];	//!< Final combine matrix.
 
 	AudioSystemCreateDesc()
 	:	channels(0)
+	,	mixerJobs(1)
 	{
 		for (int32_t i = 0; i < SbcMaxChannelCount; ++i)
 			for (int32_t j = 0; j < SbcMaxChannelCount; ++j)
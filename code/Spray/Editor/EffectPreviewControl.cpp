@@ -535,8 +535,10 @@ void EffectPreviewControl::eventPaint(ui::PaintEvent* event)
 					auto emitterInstance = dynamic_type_cast< const EmitterInstanceCPU* >(layerInstance->getEmitterInstance());
 					if (emitterInstance)
 					{
-						for (const auto& pnt : emitterInstance->getPoints())
+						const PointBuffer& points = emitterInstance->getPoints();
+						for (uint32_t i = 0; i < points.size(); ++i)
 						{
+							const Point pnt = points.get(i);
 							if (pnt.velocity.length() > FUZZY_EPSILON)
 							{
 								const Vector4 tail = pnt.position + pnt.velocity;
@@ -86,29 +86,29 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 	m_transform = transform;
 
 	// Erase dead particles.
-	size_t size = m_points.size();
+	uint32_t size = m_points.size();
+	float* age = m_points[PointBuffer::Age];
+	const float* maxAge = m_points[PointBuffer::MaxAge];
 	if (!m_emitter->getEffect() || m_effectInstances.size() != m_points.size())
 	{
-		for (size_t i = 0; i < size; )
+		for (uint32_t i = 0; i < size; )
 		{
-			Point& point = m_points[i];
-			if ((point.age += context.deltaTime) < point.maxAge)
+			if ((age[i] += context.deltaTime) < maxAge[i])
 				++i;
 			else if (i < --size)
-				point = m_points[size];
+				m_points.copy(i, size);
 		}
 		m_points.resize(size);
 	}
 	else
 	{
-		for (size_t i = 0; i < size; )
+		for (uint32_t i = 0; i < size; )
 		{
-			Point& point = m_points[i];
-			if ((point.age += context.deltaTime) < point.maxAge)
+			if ((age[i] += context.deltaTime) < maxAge[i])
 				++i;
 			else if (i < --size)
 			{
-				point = m_points[size];
+				m_points.copy(i, size);
 				m_effectInstances[i] = m_effectInstances[size];
 			}
 		}
@@ -122,7 +122,7 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 		const Source* source = m_emitter->getSource();
 		if (source)
 		{
-			const uint32_t avail = (uint32_t)(m_points.capacity() - size);
+			const uint32_t avail = m_points.capacity() - size;
 			const Vector4 dm = (lastPosition - m_transform.translation()).xyz0();
 
 			if (!singleShot)
@@ -169,6 +169,13 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 		}
 	}
 
+	// Move emitted points into point buffer.
+	if (!m_emitPoints.empty())
+	{
+		m_points.append(m_emitPoints.c_ptr(), (uint32_t)m_emitPoints.size());
+		m_emitPoints.resize(0);
+	}
+
 	m_totalTime += context.deltaTime;
 
 	// Calculate bounding box; do this before modifiers as modifiers are executed
@@ -177,10 +184,18 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 	{
 		m_boundingBox = Aabb3();
 		const Scalar deltaTime16 = Scalar(context.deltaTime * 16.0f);
-		for (const auto& point : m_points)
+		const float* px = m_points[PointBuffer::PositionX];
+		const float* py = m_points[PointBuffer::PositionY];
+		const float* pz = m_points[PointBuffer::PositionZ];
+		const float* vx = m_points[PointBuffer::VelocityX];
+		const float* vy = m_points[PointBuffer::VelocityY];
+		const float* vz = m_points[PointBuffer::VelocityZ];
+		for (uint32_t i = 0; i < size; ++i)
 		{
-			m_boundingBox.contain(point.position);
-			m_boundingBox.contain(point.position + point.velocity * deltaTime16);
+			const Vector4 position(px[i], py[i], pz[i], 1.0f);
+			const Vector4 velocity(vx[i], vy[i], vz[i], 0.0f);
+			m_boundingBox.contain(position);
+			m_boundingBox.contain(position + velocity * deltaTime16);
 		}
 		m_boundingBox = m_boundingBox.expand(1.0_simd);
 		if (!m_emitter->worldSpace())
@@ -188,20 +203,24 @@ void EmitterInstanceCPU::update(Context& context, const Transform& transform, bo
 	}
 
 	// Update particles on CPU
+	const float deltaTime = context.deltaTime;
 	size = m_points.size();
 #if defined(T_USE_UPDATE_JOBS)
-	// Execute modifiers.
 	if (size >= 64)
 	{
-		JobManager& jobManager = JobManager::getInstance();
-		m_job = jobManager.add([=, this](){
-			updateTask(context.deltaTime);
+		m_job = JobManager::getInstance().add([=, this](){
+			updateModifiers(deltaTime);
+			updateRenderPoints(deltaTime);
 		});
 	}
 	else
-		updateTask(context.deltaTime);
+	{
+		updateModifiers(deltaTime);
+		updateRenderPoints(deltaTime);
+	}
 #else
-	updateTask(context.deltaTime);
+	updateModifiers(deltaTime);
+	updateRenderPoints(deltaTime);
 #endif
 }
 
@@ -315,10 +334,11 @@ EmitterInstanceCPU::EmitterInstanceCPU(const Emitter* emitter, float duration)
 ,	m_skip(1)
 {
 	m_points.reserve(c_maxAlive);
+	m_emitPoints.reserve(c_maxEmitSingleShot);
 	m_renderPoints.reserve(c_maxAlive);
 }
 
-void EmitterInstanceCPU::updateTask(float deltaTime)
+void EmitterInstanceCPU::updateModifiers(float deltaTime)
 {
 	const Transform updateTransform = m_emitter->worldSpace() ? m_transform : Transform::identity();
 	const Scalar deltaTimeScalar(deltaTime);
@@ -328,16 +348,17 @@ void EmitterInstanceCPU::updateTask(float deltaTime)
 		modifier->update(
 			deltaTimeScalar,
 			updateTransform,
-			m_points,
-			0,
-			m_points.size()
+			m_points
 		);
 	}
+}
 
+void EmitterInstanceCPU::updateRenderPoints(float deltaTime)
+{
 	m_renderPoints.resize(0);
 
 	for (uint32_t i = 0; i < m_points.size(); i += m_skip)
-		m_renderPoints.push_back(m_points[i]);
+		m_renderPoints.push_back(m_points.get(i));
 
 	if (!m_emitter->worldSpace())
 	{
@@ -14,6 +14,7 @@
 #include "Spray/IEmitterInstance.h"
 #include "Spray/Modifier.h"
 #include "Spray/Point.h"
+#include "Spray/PointBuffer.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -70,22 +71,24 @@ public:
 
 	float getTotalTime() const { return m_totalTime; }
 
-	void reservePoints(uint32_t npoints) { m_points.reserve(m_points.size() + npoints); }
+	void reservePoints(uint32_t npoints) { m_emitPoints.reserve(m_emitPoints.size() + npoints); }
 
-	const pointVector_t& getPoints() const { return m_points; }
+	const PointBuffer& getPoints() const { return m_points; }
 
+	/*! Add points, emitted points are moved into point buffer after source has emitted. */
 	Point* addPoints(uint32_t points)
 	{
-		const uint32_t offset = uint32_t(m_points.size());
-		m_points.resize(offset + points);
-		return &m_points[offset];
+		const uint32_t offset = uint32_t(m_emitPoints.size());
+		m_emitPoints.resize(offset + points);
+		return &m_emitPoints[offset];
 	}
 
 private:
 	Ref< const Emitter > m_emitter;
 	Transform m_transform;
 	Plane m_sortPlane;
-	pointVector_t m_points;
+	PointBuffer m_points;
+	pointVector_t m_emitPoints;
 	pointVector_t m_renderPoints;
 	RefArray< EffectInstance > m_effectInstances;
 	float m_totalTime;
@@ -98,7 +101,9 @@ private:
 
 	explicit EmitterInstanceCPU(const Emitter* emitter, float duration);
 
-	void updateTask(float deltaTime);
+	void updateModifiers(float deltaTime);
+
+	void updateRenderPoints(float deltaTime);
 };
 
 }
@@ -10,7 +10,7 @@
 
 #include "Core/Math/Transform.h"
 #include "Core/Object.h"
-#include "Spray/Point.h"
+#include "Spray/PointBuffer.h"
 
 namespace traktor::spray
 {
@@ -25,7 +25,13 @@ class Modifier : public Object
 public:
 	virtual void writeSequence(Vector4*& inoutSequence) const {};
 
-	virtual void update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const = 0;
+	/*! Update all points.
+	 *
+	 * Points are processed four at a time; the point buffer
+	 * is padded so the last, partial, group can be processed
+	 * as a whole.
+	 */
+	virtual void update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const = 0;
 };
 
 }
@@ -15,6 +15,7 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.spray.BrownianModifier", BrownianModifier, Modi
 
 BrownianModifier::BrownianModifier(float factor)
 :	m_factor(factor)
+,	m_seed(5489UL)
 {
 }
 
@@ -28,16 +29,36 @@ void BrownianModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void BrownianModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void BrownianModifier::update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const
 {
-	for (size_t i = first; i < last; ++i)
+	// Each call use it's own generator since emitters sharing this modifier can be updated
+	// concurrently; a xorshift is cheap enough to be seeded on every update.
+	uint32_t state = (m_seed++ * 2654435761U) | 1U;
+	auto nextRandom4 = [&]() {
+		float r[4];
+		for (int32_t i = 0; i < 4; ++i)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			r[i] = float(state >> 8) * (1.0f / 16777216.0f);
+		}
+		return Vector4(r[0], r[1], r[2], r[3]) * 2.0_simd - 1.0_simd;
+	};
+
+	const Vector4 factor(m_factor * deltaTime);
+
+	float* vx = points[PointBuffer::VelocityX];
+	float* vy = points[PointBuffer::VelocityY];
+	float* vz = points[PointBuffer::VelocityZ];
+	const float* im = points[PointBuffer::InverseMass];
+
+	for (size_t i = 0; i < points.size(); i += 4)
 	{
-		const Vector4 r(
-			m_random.nextFloat() * 2.0f - 1.0f,
-			m_random.nextFloat() * 2.0f - 1.0f,
-			m_random.nextFloat() * 2.0f - 1.0f
-		);
-		points[i].velocity += (r * m_factor * deltaTime) * Scalar(points[i].inverseMass);
+		const Vector4 k = Vector4::loadAligned(&im[i]) * factor;
+		(Vector4::loadAligned(&vx[i]) + nextRandom4() * k).storeAligned(&vx[i]);
+		(Vector4::loadAligned(&vy[i]) + nextRandom4() * k).storeAligned(&vy[i]);
+		(Vector4::loadAligned(&vz[i]) + nextRandom4() * k).storeAligned(&vz[i]);
 	}
 }
 
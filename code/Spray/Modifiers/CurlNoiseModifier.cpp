@@ -58,12 +58,24 @@ CurlNoiseModifier::CurlNoiseModifier(float factor)
 {
 }
 
-void CurlNoiseModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void CurlNoiseModifier::update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const
 {
-	for (size_t i = first; i < last; ++i)
+	const Scalar factor = m_factor * deltaTime;
+
+	const float* px = points[PointBuffer::PositionX];
+	const float* py = points[PointBuffer::PositionY];
+	const float* pz = points[PointBuffer::PositionZ];
+	float* vx = points[PointBuffer::VelocityX];
+	float* vy = points[PointBuffer::VelocityY];
+	float* vz = points[PointBuffer::VelocityZ];
+	const float* im = points[PointBuffer::InverseMass];
+
+	for (size_t i = 0; i < points.size(); ++i)
 	{
-		const Vector4 r = curlNoise(points[i].position);
-		points[i].velocity += (r * m_factor * deltaTime) * Scalar(points[i].inverseMass);
+		const Vector4 r = curlNoise(Vector4(px[i], py[i], pz[i], 1.0f)) * factor * Scalar(im[i]);
+		vx[i] += r.x();
+		vy[i] += r.y();
+		vz[i] += r.z();
 	}
 }
 
@@ -29,15 +29,22 @@ void DragModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void DragModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void DragModifier::update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const
 {
-	const Scalar dv = 1.0_simd - m_linearDrag * deltaTime;
-	const float da = 1.0f - m_angularDrag * deltaTime;
+	const Vector4 dv(1.0_simd - m_linearDrag * deltaTime);
+	const Vector4 da(Scalar(1.0f - m_angularDrag * deltaTime));
 
-	for (size_t i = first; i < last; ++i)
+	float* vx = points[PointBuffer::VelocityX];
+	float* vy = points[PointBuffer::VelocityY];
+	float* vz = points[PointBuffer::VelocityZ];
+	float* av = points[PointBuffer::AngularVelocity];
+
+	for (size_t i = 0; i < points.size(); i += 4)
 	{
-		points[i].velocity *= dv;
-		points[i].angularVelocity *= da;
+		(Vector4::loadAligned(&vx[i]) * dv).storeAligned(&vx[i]);
+		(Vector4::loadAligned(&vy[i]) * dv).storeAligned(&vy[i]);
+		(Vector4::loadAligned(&vz[i]) * dv).storeAligned(&vz[i]);
+		(Vector4::loadAligned(&av[i]) * da).storeAligned(&av[i]);
 	}
 }
 
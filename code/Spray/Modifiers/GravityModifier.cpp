@@ -29,11 +29,25 @@ void GravityModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void GravityModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void GravityModifier::update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const
 {
 	const Vector4 gravity = (m_world ? m_gravity : transform * m_gravity) * deltaTime;
-	for (size_t i = first; i < last; ++i)
-		points[i].velocity += gravity * Scalar(points[i].inverseMass);
+	const Vector4 gx(gravity.x());
+	const Vector4 gy(gravity.y());
+	const Vector4 gz(gravity.z());
+
+	float* vx = points[PointBuffer::VelocityX];
+	float* vy = points[PointBuffer::VelocityY];
+	float* vz = points[PointBuffer::VelocityZ];
+	const float* im = points[PointBuffer::InverseMass];
+
+	for (size_t i = 0; i < points.size(); i += 4)
+	{
+		const Vector4 m = Vector4::loadAligned(&im[i]);
+		(Vector4::loadAligned(&vx[i]) + gx * m).storeAligned(&vx[i]);
+		(Vector4::loadAligned(&vy[i]) + gy * m).storeAligned(&vy[i]);
+		(Vector4::loadAligned(&vz[i]) + gz * m).storeAligned(&vz[i]);
+	}
 }
 
 }
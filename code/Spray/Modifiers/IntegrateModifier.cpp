@@ -30,26 +30,36 @@ void IntegrateModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void IntegrateModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void IntegrateModifier::update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const
 {
-	const Scalar scaledDeltaTime = deltaTime * m_timeScale;
-	if (m_linear && m_angular)
+	const Vector4 scaledDeltaTime(deltaTime * m_timeScale);
+
+	if (m_linear)
 	{
-		for (size_t i = first; i < last; ++i)
+		float* px = points[PointBuffer::PositionX];
+		float* py = points[PointBuffer::PositionY];
+		float* pz = points[PointBuffer::PositionZ];
+		const float* vx = points[PointBuffer::VelocityX];
+		const float* vy = points[PointBuffer::VelocityY];
+		const float* vz = points[PointBuffer::VelocityZ];
+		const float* im = points[PointBuffer::InverseMass];
+
+		for (size_t i = 0; i < points.size(); i += 4)
 		{
-			points[i].position += points[i].velocity * Scalar(points[i].inverseMass) * scaledDeltaTime;
-			points[i].orientation += points[i].angularVelocity * scaledDeltaTime;
+			const Vector4 k = Vector4::loadAligned(&im[i]) * scaledDeltaTime;
+			(Vector4::loadAligned(&px[i]) + Vector4::loadAligned(&vx[i]) * k).storeAligned(&px[i]);
+			(Vector4::loadAligned(&py[i]) + Vector4::loadAligned(&vy[i]) * k).storeAligned(&py[i]);
+			(Vector4::loadAligned(&pz[i]) + Vector4::loadAligned(&vz[i]) * k).storeAligned(&pz[i]);
 		}
 	}
-	else if (m_linear)
-	{
-		for (size_t i = first; i < last; ++i)
-			points[i].position += points[i].velocity * Scalar(points[i].inverseMass) * scaledDeltaTime;
-	}
-	else if (m_angular)
+
+	if (m_angular)
 	{
-		for (size_t i = first; i < last; ++i)
-			points[i].orientation += points[i].angularVelocity * scaledDeltaTime;
+		float* o = points[PointBuffer::Orientation];
+		const float* av = points[PointBuffer::AngularVelocity];
+
+		for (size_t i = 0; i < points.size(); i += 4)
+			(Vector4::loadAligned(&o[i]) + Vector4::loadAligned(&av[i]) * scaledDeltaTime).storeAligned(&o[i]);
 	}
 }
 
@@ -20,25 +20,50 @@ PlaneCollisionModifier::PlaneCollisionModifier(const Plane& plane, float radius,
 {
 }
 
-void PlaneCollisionModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void PlaneCollisionModifier::update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const
 {
 	const Plane planeW = transform.toMatrix44() * m_plane;
 	const Vector4 center = transform.translation();
+	const Vector4 normal = m_plane.normal().normalized();
 
-	for (size_t i = first; i < last; ++i)
-	{
-		const Scalar rv = dot3(planeW.normal(), points[i].velocity);
-		if (rv >= 0.0_simd)
-			continue;
+	const Vector4 nwx(planeW.normal().x()), nwy(planeW.normal().y()), nwz(planeW.normal().z());
+	const Vector4 dw(planeW.distance());
+	const Vector4 nx(normal.x()), ny(normal.y()), nz(normal.z());
+	const Vector4 cx(center.x()), cy(center.y()), cz(center.z());
+	const Vector4 radius(m_radius);
+	const Vector4 restitution(m_restitution);
+	const Vector4 two(2.0_simd);
+
+	const float* px = points[PointBuffer::PositionX];
+	const float* py = points[PointBuffer::PositionY];
+	const float* pz = points[PointBuffer::PositionZ];
+	float* vx = points[PointBuffer::VelocityX];
+	float* vy = points[PointBuffer::VelocityY];
+	float* vz = points[PointBuffer::VelocityZ];
+	const float* sz = points[PointBuffer::Size];
 
-		const Scalar rd = planeW.distance(points[i].position);
-		if (rd >= points[i].size)
-			continue;
+	for (size_t i = 0; i < points.size(); i += 4)
+	{
+		const Vector4 x = Vector4::loadAligned(&px[i]);
+		const Vector4 y = Vector4::loadAligned(&py[i]);
+		const Vector4 z = Vector4::loadAligned(&pz[i]);
+		const Vector4 u = Vector4::loadAligned(&vx[i]);
+		const Vector4 v = Vector4::loadAligned(&vy[i]);
+		const Vector4 w = Vector4::loadAligned(&vz[i]);
 
-		if ((points[i].position - center).length2() >= m_radius)
-			continue;
+		// Collide only if moving towards plane, closer than size and within radius;
+		// each condition is negative when satisfied thus the max of all.
+		const Vector4 rv = nwx * u + nwy * v + nwz * w;
+		const Vector4 rd = nwx * x + nwy * y + nwz * z - dw - Vector4::loadAligned(&sz[i]);
+		const Vector4 dx = x - cx, dy = y - cy, dz = z - cz;
+		const Vector4 rc = dx * dx + dy * dy + dz * dz - radius;
+		const Vector4 collide = max(rv, max(rd, rc));
 
-		points[i].velocity = -reflect(points[i].velocity, m_plane.normal()) * m_restitution;
+		// Negated reflection of velocity.
+		const Vector4 d = (nx * u + ny * v + nz * w) * two;
+		select(collide, (u - nx * d) * restitution, u).storeAligned(&vx[i]);
+		select(collide, (v - ny * d) * restitution, v).storeAligned(&vy[i]);
+		select(collide, (w - nz * d) * restitution, w).storeAligned(&vz[i]);
 	}
 }
 
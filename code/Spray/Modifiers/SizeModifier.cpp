@@ -28,11 +28,13 @@ void SizeModifier::writeSequence(Vector4*& inoutSequence) const
 	);
 }
 
-void SizeModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void SizeModifier::update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const
 {
-	const float deltaSize = m_adjustRate * deltaTime;
-	for (size_t i = first; i < last; ++i)
-		points[i].size += deltaSize;
+	const Vector4 deltaSize(Scalar(m_adjustRate) * deltaTime);
+
+	float* sz = points[PointBuffer::Size];
+	for (size_t i = 0; i < points.size(); i += 4)
+		(Vector4::loadAligned(&sz[i]) + deltaSize).storeAligned(&sz[i]);
 }
 
 }
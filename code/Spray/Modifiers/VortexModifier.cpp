@@ -6,10 +6,27 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cmath>
 #include "Spray/Modifiers/VortexModifier.h"
 
 namespace traktor::spray
 {
+	namespace
+	{
+
+/*! Square root of each component. */
+T_FORCE_INLINE Vector4 squareRoot4(const Vector4& v)
+{
+#if defined(T_MATH_USE_SSE2)
+	return Vector4(_mm_sqrt_ps(v.m_data));
+#else
+	float T_MATH_ALIGN16 e[4];
+	v.storeAligned(e);
+	return Vector4(std::sqrt(e[0]), std::sqrt(e[1]), std::sqrt(e[2]), std::sqrt(e[3]));
+#endif
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.spray.VortexModifier", VortexModifier, Modifier)
 
@@ -30,29 +47,59 @@ VortexModifier::VortexModifier(
 {
 }
 
-void VortexModifier::update(const Scalar& deltaTime, const Transform& transform, pointVector_t& points, size_t first, size_t last) const
+void VortexModifier::update(const Scalar& deltaTime, const Transform& transform, PointBuffer& points) const
 {
 	const Vector4 axis = m_world ? m_axis : transform * m_axis;
 	const Vector4 center = m_world ? transform.translation() : Vector4::origo();
 
-	for (size_t i = first; i < last; ++i)
+	const Vector4 ax(axis.x()), ay(axis.y()), az(axis.z());
+	const Vector4 cx(center.x()), cy(center.y()), cz(center.z());
+	const Vector4 tangentForce(m_tangentForce);
+	const Vector4 normalConstantForce(m_normalConstantForce);
+	const Vector4 normalDistance(m_normalDistance);
+	const Vector4 normalDistanceForce(m_normalDistanceForce);
+	const Vector4 dt(deltaTime);
+
+	const float* px = points[PointBuffer::PositionX];
+	const float* py = points[PointBuffer::PositionY];
+	const float* pz = points[PointBuffer::PositionZ];
+	float* vx = points[PointBuffer::VelocityX];
+	float* vy = points[PointBuffer::VelocityY];
+	float* vz = points[PointBuffer::VelocityZ];
+	const float* im = points[PointBuffer::InverseMass];
+
+	for (size_t i = 0; i < points.size(); i += 4)
 	{
-		Vector4 pc = points[i].position - center;
+		Vector4 pcx = Vector4::loadAligned(&px[i]) - cx;
+		Vector4 pcy = Vector4::loadAligned(&py[i]) - cy;
+		Vector4 pcz = Vector4::loadAligned(&pz[i]) - cz;
 
 		// Project onto plane.
-		const Scalar d = dot3(pc, axis);
-		pc -= axis * d;
+		const Vector4 d = pcx * ax + pcy * ay + pcz * az;
+		pcx -= ax * d;
+		pcy -= ay * d;
+		pcz -= az * d;
+
+		// Calculate normal and tangent vectors.
+		const Vector4 distance = squareRoot4(pcx * pcx + pcy * pcy + pcz * pcz);
+		const Vector4 nx = pcx / distance;
+		const Vector4 ny = pcy / distance;
+		const Vector4 nz = pcz / distance;
 
-		// Calculate tangent vector.
-		const Scalar distance = pc.length();
-		const Vector4 n = pc / distance;
-		const Vector4 t = cross(axis, n).normalized();
+		Vector4 tx = ay * nz - az * ny;
+		Vector4 ty = az * nx - ax * nz;
+		Vector4 tz = ax * ny - ay * nx;
+		const Vector4 tl = squareRoot4(tx * tx + ty * ty + tz * tz);
+		tx /= tl;
+		ty /= tl;
+		tz /= tl;
 
 		// Adjust velocity from this tangent.
-		points[i].velocity += (
-			t * m_tangentForce +
-			n * (m_normalConstantForce + (distance - m_normalDistance) * m_normalDistanceForce)
-		) * Scalar(points[i].inverseMass) * deltaTime;
+		const Vector4 fn = normalConstantForce + (distance - normalDistance) * normalDistanceForce;
+		const Vector4 k = Vector4::loadAligned(&im[i]) * dt;
+		(Vector4::loadAligned(&vx[i]) + (tx * tangentForce + nx * fn) * k).storeAligned(&vx[i]);
+		(Vector4::loadAligned(&vy[i]) + (ty * tangentForce + ny * fn) * k).storeAligned(&vy[i]);
+		(Vector4::loadAligned(&vz[i]) + (tz * tangentForce + nz * fn) * k).storeAligned(&vz[i]);
 	}
 }
 
@@ -0,0 +1,84 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Math/MathUtils.h"
+#include "Core/Misc/Align.h"
+#include "Spray/PointBuffer.h"
+
+namespace traktor::spray
+{
+
+void PointBuffer::reserve(uint32_t capacity)
+{
+	if (capacity <= m_capacity)
+		return;
+
+	m_capacity = alignUp(capacity, 4);
+	for (auto& attribute : m_attributes)
+		attribute.resize(m_capacity, 0.0f);
+}
+
+void PointBuffer::resize(uint32_t size)
+{
+	if (size > m_capacity)
+		reserve(max(size, m_capacity * 2));
+	m_size = size;
+}
+
+void PointBuffer::append(const Point* points, uint32_t count)
+{
+	const uint32_t offset = m_size;
+	resize(m_size + count);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const Point& point = points[i];
+		const uint32_t j = offset + i;
+
+		m_attributes[PositionX][j] = point.position.x();
+		m_attributes[PositionY][j] = point.position.y();
+		m_attributes[PositionZ][j] = point.position.z();
+		m_attributes[VelocityX][j] = point.velocity.x();
+		m_attributes[VelocityY][j] = point.velocity.y();
+		m_attributes[VelocityZ][j] = point.velocity.z();
+		m_attributes[Orientation][j] = point.orientation;
+		m_attributes[AngularVelocity][j] = point.angularVelocity;
+		m_attributes[InverseMass][j] = point.inverseMass;
+		m_attributes[Age][j] = point.age;
+		m_attributes[MaxAge][j] = point.maxAge;
+		m_attributes[Size][j] = point.size;
+		m_attributes[Random][j] = point.random;
+		m_attributes[Alpha][j] = point.alpha;
+	}
+}
+
+Point PointBuffer::get(uint32_t index) const
+{
+	T_ASSERT(index < m_size);
+
+	Point point;
+	point.position = Vector4(m_attributes[PositionX][index], m_attributes[PositionY][index], m_attributes[PositionZ][index], 1.0f);
+	point.velocity = Vector4(m_attributes[VelocityX][index], m_attributes[VelocityY][index], m_attributes[VelocityZ][index], 0.0f);
+	point.orientation = m_attributes[Orientation][index];
+	point.angularVelocity = m_attributes[AngularVelocity][index];
+	point.inverseMass = m_attributes[InverseMass][index];
+	point.age = m_attributes[Age][index];
+	point.maxAge = m_attributes[MaxAge][index];
+	point.size = m_attributes[Size][index];
+	point.random = m_attributes[Random][index];
+	point.alpha = m_attributes[Alpha][index];
+	return point;
+}
+
+void PointBuffer::copy(uint32_t to, uint32_t from)
+{
+	for (auto& attribute : m_attributes)
+		attribute[to] = attribute[from];
+}
+
+}
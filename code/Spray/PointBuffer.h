@@ -0,0 +1,94 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Spray/Point.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_SPRAY_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::spray
+{
+
+/*! Particle points stored as structure of arrays.
+ * \ingroup Spray
+ *
+ * Each attribute of the points is stored in it's own
+ * array, positions and velocities as separate x, y and z
+ * arrays, so modifiers can update four points at a time.
+ *
+ * Arrays are padded to a multiple of four points thus
+ * the last, partial, group of four can be processed
+ * as a whole.
+ */
+class T_DLLCLASS PointBuffer
+{
+public:
+	enum Attribute
+	{
+		PositionX,
+		PositionY,
+		PositionZ,
+		VelocityX,
+		VelocityY,
+		VelocityZ,
+		Orientation,
+		AngularVelocity,
+		InverseMass,
+		Age,
+		MaxAge,
+		Size,
+		Random,
+		Alpha,
+		AttributeCount
+	};
+
+	void reserve(uint32_t capacity);
+
+	void resize(uint32_t size);
+
+	void clear() { resize(0); }
+
+	uint32_t size() const { return m_size; }
+
+	uint32_t capacity() const { return m_capacity; }
+
+	bool empty() const { return m_size == 0; }
+
+	/*! Append points.
+	 *
+	 * \param points Points in AoS layout.
+	 * \param count Number of points.
+	 */
+	void append(const Point* points, uint32_t count);
+
+	/*! Get point in AoS layout. */
+	Point get(uint32_t index) const;
+
+	/*! Copy all attributes of one point onto another. */
+	void copy(uint32_t to, uint32_t from);
+
+	/*! Get array of attribute. */
+	float* operator [] (Attribute attribute) { return m_attributes[attribute].ptr(); }
+
+	/*! Get array of attribute. */
+	const float* operator [] (Attribute attribute) const { return m_attributes[attribute].c_ptr(); }
+
+private:
+	AlignedVector< float > m_attributes[AttributeCount];
+	uint32_t m_size = 0;
+	uint32_t m_capacity = 0;
+};
+
+}
@@ -0,0 +1,201 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <functional>
+#include "Core/Log/Log.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+#include "Spray/PointBuffer.h"
+#include "Spray/Modifiers/BrownianModifier.h"
+#include "Spray/Modifiers/DragModifier.h"
+#include "Spray/Modifiers/GravityModifier.h"
+#include "Spray/Modifiers/IntegrateModifier.h"
+#include "Spray/Modifiers/PlaneCollisionModifier.h"
+#include "Spray/Modifiers/SizeModifier.h"
+#include "Spray/Modifiers/VortexModifier.h"
+#include "Spray/Test/CaseModifiers.h"
+
+namespace traktor::spray::test
+{
+	namespace
+	{
+
+const uint32_t c_pointCount = 10001;	//!< Not a multiple of four to exercise last, partial, group.
+const uint32_t c_iterations = 100;
+
+/*! Reference, one point at a time, implementations of modifiers. */
+typedef std::function< void(pointVector_t& points) > reference_t;
+
+void createPoints(pointVector_t& outPoints)
+{
+	Random random;
+	outPoints.resize(c_pointCount);
+	for (auto& point : outPoints)
+	{
+		point.position = Vector4(random.nextFloat() * 20.0f - 10.0f, random.nextFloat() * 20.0f - 10.0f, random.nextFloat() * 20.0f - 10.0f, 1.0f);
+		point.velocity = Vector4(random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f, random.nextFloat() * 2.0f - 1.0f, 0.0f);
+		point.orientation = random.nextFloat();
+		point.angularVelocity = random.nextFloat();
+		point.inverseMass = 0.5f + random.nextFloat();
+		point.age = 0.0f;
+		point.maxAge = 10.0f;
+		point.size = 0.5f + random.nextFloat() * 5.0f;
+		point.random = random.nextFloat();
+		point.alpha = 1.0f;
+	}
+}
+
+bool compare(const pointVector_t& expected, const PointBuffer& points)
+{
+	if (expected.size() != points.size())
+		return false;
+
+	for (uint32_t i = 0; i < points.size(); ++i)
+	{
+		const Point point = points.get(i);
+		if ((point.position - expected[i].position).xyz0().absolute().max() > 1e-4f)
+			return false;
+		if ((point.velocity - expected[i].velocity).xyz0().absolute().max() > 1e-4f)
+			return false;
+		if (std::abs(point.orientation - expected[i].orientation) > 1e-4f)
+			return false;
+		if (std::abs(point.angularVelocity - expected[i].angularVelocity) > 1e-4f)
+			return false;
+		if (std::abs(point.size - expected[i].size) > 1e-4f)
+			return false;
+	}
+
+	return true;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.spray.test.CaseModifiers", 0, CaseModifiers, traktor::test::Case)
+
+void CaseModifiers::run()
+{
+	const Scalar deltaTime(1.0f / 60.0f);
+	const Transform transform(Vector4(1.0f, 2.0f, 3.0f, 0.0f), Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), 0.3f));
+
+	const Vector4 gravity(0.0f, -9.81f, 0.0f, 0.0f);
+	const Vector4 axis(0.0f, 1.0f, 0.0f, 0.0f);
+	const Plane plane(Vector4(0.0f, 1.0f, 0.0f), 0.0_simd);
+
+	const struct
+	{
+		const wchar_t* name;
+		Ref< Modifier > modifier;
+		reference_t reference;
+	}
+	modifiers[] =
+	{
+		{ L"Gravity", new GravityModifier(gravity, true), [&](pointVector_t& points) {
+			const Vector4 g = gravity * deltaTime;
+			for (auto& point : points)
+				point.velocity += g * Scalar(point.inverseMass);
+		} },
+		{ L"Drag", new DragModifier(0.5f, 0.25f), [&](pointVector_t& points) {
+			const Scalar dv = 1.0_simd - 0.5_simd * deltaTime;
+			const float da = 1.0f - 0.25f * deltaTime;
+			for (auto& point : points)
+			{
+				point.velocity *= dv;
+				point.angularVelocity *= da;
+			}
+		} },
+		{ L"Integrate", new IntegrateModifier(1.5f, true, true), [&](pointVector_t& points) {
+			const Scalar scaledDeltaTime = deltaTime * 1.5_simd;
+			for (auto& point : points)
+			{
+				point.position += point.velocity * Scalar(point.inverseMass) * scaledDeltaTime;
+				point.orientation += point.angularVelocity * scaledDeltaTime;
+			}
+		} },
+		{ L"Vortex", new VortexModifier(axis, 2.0f, 0.5f, 4.0f, 0.25f, false), [&](pointVector_t& points) {
+			const Vector4 ta = transform * axis;
+			const Vector4 center = Vector4::origo();
+			for (auto& point : points)
+			{
+				Vector4 pc = point.position - center;
+				const Scalar d = dot3(pc, ta);
+				pc -= ta * d;
+				const Scalar distance = pc.length();
+				const Vector4 n = pc / distance;
+				const Vector4 t = cross(ta, n).normalized();
+				point.velocity += (t * 2.0_simd + n * (0.5_simd + (distance - 4.0_simd) * 0.25_simd)) * Scalar(point.inverseMass) * deltaTime;
+			}
+		} },
+		{ L"PlaneCollision", new PlaneCollisionModifier(plane, 40.0f, 0.8f), [&](pointVector_t& points) {
+			const Plane planeW = transform.toMatrix44() * plane;
+			const Vector4 center = transform.translation();
+			for (auto& point : points)
+			{
+				if (dot3(planeW.normal(), point.velocity) >= 0.0_simd)
+					continue;
+				if (planeW.distance(point.position) >= Scalar(point.size))
+					continue;
+				if ((point.position - center).xyz0().length2() >= 40.0_simd)
+					continue;
+				point.velocity = -reflect(point.velocity, plane.normal()) * 0.8_simd;
+			}
+		} },
+		{ L"Size", new SizeModifier(0.5f), [&](pointVector_t& points) {
+			const float deltaSize = 0.5f * deltaTime;
+			for (auto& point : points)
+				point.size += deltaSize;
+		} },
+		{ L"Brownian", new BrownianModifier(0.1f), nullptr }
+	};
+
+	pointVector_t source;
+	createPoints(source);
+
+	for (const auto& m : modifiers)
+	{
+		pointVector_t expected = source;
+		PointBuffer points;
+		points.append(source.c_ptr(), (uint32_t)source.size());
+
+		// Compare with reference.
+		if (m.reference)
+		{
+			m.reference(expected);
+			m.modifier->update(deltaTime, transform, points);
+			CASE_ASSERT(compare(expected, points));
+		}
+		else
+		{
+			m.modifier->update(deltaTime, transform, points);
+			CASE_ASSERT_EQUAL(points.size(), (uint32_t)c_pointCount);
+		}
+
+		// Throughput, reference one point at a time.
+		double referenceTime = 0.0;
+		if (m.reference)
+		{
+			Timer timer;
+			for (uint32_t i = 0; i < c_iterations; ++i)
+				m.reference(expected);
+			referenceTime = timer.getElapsedTime();
+		}
+
+		// Throughput, four points at a time.
+		Timer timer;
+		for (uint32_t i = 0; i < c_iterations; ++i)
+			m.modifier->update(deltaTime, transform, points);
+		const double soaTime = timer.getElapsedTime();
+
+		const double n = double(c_pointCount) * c_iterations;
+		log::info << m.name << L": ";
+		if (m.reference)
+			log::info << int32_t(n / referenceTime / 1e6) << L" Mpoints/s reference, ";
+		log::info << int32_t(n / soaTime / 1e6) << L" Mpoints/s SoA" << Endl;
+	}
+}
+
+}
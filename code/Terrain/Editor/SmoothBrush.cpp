@@ -38,6 +38,9 @@ void SmoothBrush::apply(float x, float y)
 	hf::Heightfield* hf = m_heightfield;
 
 	const hf::height_t* hm = hf->getHeights();
+	if (!hm)
+		return;
+
 	const int32_t size = hf->getSize();
 
 	for (int32_t iy = -m_radius; iy <= m_radius; ++iy)
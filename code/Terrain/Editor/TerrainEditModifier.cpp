@@ -217,6 +217,10 @@ bool TerrainEditModifier::activate()
 		return false;
 	}
 
+	// Runtime heightfield is tiled and read-only; read all tiles into memory
+	// so brushes can modify it.
+	m_heightfield->makeResident();
+
 	const int32_t size = m_heightfield->getSize();
 
 	m_terrainInstance = sourceDatabase->getInstance(m_terrainComponentData->getTerrain());
@@ -1143,12 +1147,15 @@ void TerrainEditModifier::end()
 		Ref< IStream > data = m_heightfieldInstance->writeData(L"Data");
 		if (data)
 		{
-			hf::HeightfieldFormat().write(data, m_heightfield);
+			const bool written = hf::HeightfieldFormat().write(data, m_heightfield);
 
 			data->close();
 			data = nullptr;
 
-			m_context->getDocument()->setModified();
+			if (written)
+				m_context->getDocument()->setModified();
+			else
+				log::error << L"Unable to write heights" << Endl;
 		}
 		else
 			log::error << L"Unable to write heights" << Endl;
@@ -269,6 +269,10 @@ void ForestComponent::updatePatches()
 	Random random;
 
 	m_trees.resize(0);
+
+	// Collect candidate positions first so heights and normals can be queried in batches.
+	AlignedVector< Vector4 > positions;
+	AlignedVector< float > gridX, gridZ;
 	for (float z = 0; z < size; z += densityInv)
 	{
 		for (float x = 0; x < size; x += densityInv)
@@ -278,36 +282,50 @@ void ForestComponent::updatePatches()
 				continue;
 
 			// Get world position.
-			float wx, wy, wz;
+			float wx, wz;
 			heightfield->gridToWorld(x, z, wx, wz);
 			wx += extentPerGrid.x() * densityInv * (random.nextFloat() - 0.5f);
 			wz += extentPerGrid.z() * densityInv * (random.nextFloat() - 0.5f);
-			wy = heightfield->getWorldHeight(wx, wz);
+			positions.push_back(Vector4(wx, 0.0f, wz, 1.0f));
 
-			// Get ground normal.
 			float gx, gz;
 			heightfield->worldToGrid(wx, wz, gx, gz);
-			Vector4 normal = heightfield->normalAt(gx, gz);
+			gridX.push_back(gx);
+			gridZ.push_back(gz);
+		}
+	}
 
-			// Check slope angle threshold.
-			const float slopeAngle = acos(normal.y());
-			if (slopeAngle > m_data.m_slopeAngleThreshold)
-				continue;
+	const uint32_t count = (uint32_t)positions.size();
+	AlignedVector< float > heights(count);
+	AlignedVector< Vector4 > normals(count);
+	heightfield->getWorldHeights(positions.c_ptr(), count, heights.ptr());
+	heightfield->normalsAt(gridX.c_ptr(), gridZ.c_ptr(), count, normals.ptr());
 
-			// Calculate rotation.
-			const float rx = (random.nextFloat() * 2.0f - 1.0f) * m_data.m_randomTilt;
-			const float rz = (random.nextFloat() * 2.0f - 1.0f) * m_data.m_randomTilt;
-			const float head = random.nextFloat() * TWO_PI;
-			const Quaternion Qu = slerp(Quaternion(Vector4(0.0f, 1.0f, 0.0f), normal), Quaternion::identity(), m_data.m_upness);
-			const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz);
-			const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head);
-
-			// Add tree on position.
-			auto& tree = m_trees.push_back();
-			tree.position = Vector4(wx, wy, wz, 1.0f);
-			tree.rotation = Qr * Qu * Qh;
-			tree.scale = random.nextFloat() * m_data.m_randomScale + (1.0f - m_data.m_randomScale);
-		}
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const float wx = positions[i].x();
+		const float wy = heights[i];
+		const float wz = positions[i].z();
+		const Vector4& normal = normals[i];
+
+		// Check slope angle threshold.
+		const float slopeAngle = acos(normal.y());
+		if (slopeAngle > m_data.m_slopeAngleThreshold)
+			continue;
+
+		// Calculate rotation.
+		const float rx = (random.nextFloat() * 2.0f - 1.0f) * m_data.m_randomTilt;
+		const float rz = (random.nextFloat() * 2.0f - 1.0f) * m_data.m_randomTilt;
+		const float head = random.nextFloat() * TWO_PI;
+		const Quaternion Qu = slerp(Quaternion(Vector4(0.0f, 1.0f, 0.0f), normal), Quaternion::identity(), m_data.m_upness);
+		const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz);
+		const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head);
+
+		// Add tree on position.
+		auto& tree = m_trees.push_back();
+		tree.position = Vector4(wx, wy, wz, 1.0f);
+		tree.rotation = Qr * Qu * Qh;
+		tree.scale = random.nextFloat() * m_data.m_randomScale + (1.0f - m_data.m_randomScale);
 	}
 }
 
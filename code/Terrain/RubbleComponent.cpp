@@ -25,6 +25,7 @@
 #include "World/WorldBuildContext.h"
 #include "World/WorldRenderView.h"
 
+#include <algorithm>
 #include <limits>
 
 namespace traktor::terrain
@@ -39,6 +40,7 @@ const render::Handle s_handleTerrain_WorldOrigin(L"Terrain_WorldOrigin");
 const render::Handle s_handleTerrain_WorldExtent(L"Terrain_WorldExtent");
 const render::Handle s_handleRubble_Eye(L"Rubble_Eye");
 const render::Handle s_handleRubble_MaxDistance(L"Rubble_MaxDistance");
+const int32_t c_batchSize = 64;	//!< Number of instances placed with a single batched height and normal query.
 
 }
 
@@ -135,33 +137,50 @@ void RubbleComponent::setup(const world::WorldRenderView& worldRenderView)
 			const float upness = cluster.rubbleDef->upness;
 
 			RandomGeometry random(cluster.seed);
-			for (int32_t j = cluster.from; j < cluster.to; ++j)
+			for (int32_t from = cluster.from; from < cluster.to; from += c_batchSize)
 			{
-				const float dx = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
-				const float dz = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
-
-				// Calculate world position.
-				const float px = cluster.center.x() + dx;
-				const float pz = cluster.center.z() + dz;
-				const float py = terrain->getHeightfield()->getWorldHeight(px, pz);
-
-				// Get ground normal.
-				float gx, gz;
-				heightfield->worldToGrid(px, pz, gx, gz);
-				const Vector4 normal = heightfield->normalAt(gx, gz);
-
-				// Calculate rotation.
-				const float rx = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
-				const float rz = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
-				const float head = random.nextFloat() * TWO_PI;
-				const Quaternion Qu = slerp(Quaternion(Vector4(0.0f, 1.0f, 0.0f), normal), Quaternion::identity(), upness);
-				const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz);
-				const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head);
-
-				// Update instance data.
-				m_instances[j].position = Vector4(px, py, pz, 0.0f);
-				m_instances[j].rotation = Qr * Qu * Qh;
-				m_instances[j].scale = random.nextFloat() * randomScaleAmount + (1.0f - randomScaleAmount);
+				const int32_t count = std::min(cluster.to - from, c_batchSize);
+
+				Vector4 positions[c_batchSize];
+				float gx[c_batchSize], gz[c_batchSize];
+				float rx[c_batchSize], rz[c_batchSize], head[c_batchSize], scale[c_batchSize];
+
+				// Calculate world positions, and draw random orientations in same sequence as before.
+				for (int32_t i = 0; i < count; ++i)
+				{
+					const float dx = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
+					const float dz = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
+
+					const float px = cluster.center.x() + dx;
+					const float pz = cluster.center.z() + dz;
+					positions[i] = Vector4(px, 0.0f, pz, 0.0f);
+					heightfield->worldToGrid(px, pz, gx[i], gz[i]);
+
+					rx[i] = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
+					rz[i] = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
+					head[i] = random.nextFloat() * TWO_PI;
+					scale[i] = random.nextFloat() * randomScaleAmount + (1.0f - randomScaleAmount);
+				}
+
+				// Get ground heights and normals.
+				float heights[c_batchSize];
+				Vector4 normals[c_batchSize];
+				heightfield->getWorldHeights(positions, count, heights);
+				heightfield->normalsAt(gx, gz, count, normals);
+
+				for (int32_t i = 0; i < count; ++i)
+				{
+					// Calculate rotation.
+					const Quaternion Qu = slerp(Quaternion(Vector4(0.0f, 1.0f, 0.0f), normals[i]), Quaternion::identity(), upness);
+					const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx[i]) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz[i]);
+					const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head[i]);
+
+					// Update instance data.
+					Instance& instance = m_instances[from + i];
+					instance.position = Vector4(positions[i].x(), heights[i], positions[i].z(), 0.0f);
+					instance.rotation = Qr * Qu * Qh;
+					instance.scale = scale[i];
+				}
 			}
 		}
 	}
@@ -286,7 +305,6 @@ void RubbleComponent::updatePatches()
 
 			float wx, wz;
 			heightfield->gridToWorld(x + 8, z + 8, wx, wz);
-			const float wy = heightfield->getWorldHeight(wx, wz);
 
 			for (uint32_t i = 0; i < maxMaterialIndex; ++i)
 			{
@@ -315,7 +333,7 @@ void RubbleComponent::updatePatches()
 
 					Cluster& c = m_clusters.push_back();
 					c.rubbleDef = &rubble;
-					c.center = Vector4(wx, wy, wz, 1.0f);
+					c.center = Vector4(wx, 0.0f, wz, 1.0f);
 					c.distance = std::numeric_limits< float >::max();
 					c.seed = (int32_t)random.next();
 					c.from = from;
@@ -326,6 +344,15 @@ void RubbleComponent::updatePatches()
 		}
 	}
 
+	// Place clusters on ground, heights of all clusters are queried at once.
+	AlignedVector< Vector4 > centers(m_clusters.size());
+	AlignedVector< float > heights(m_clusters.size());
+	for (uint32_t i = 0; i < m_clusters.size(); ++i)
+		centers[i] = m_clusters[i].center;
+	heightfield->getWorldHeights(centers.c_ptr(), (uint32_t)centers.size(), heights.ptr());
+	for (uint32_t i = 0; i < m_clusters.size(); ++i)
+		m_clusters[i].center = Vector4(centers[i].x(), heights[i], centers[i].z(), 1.0f);
+
 	// Move last eye position, forces rescatter of visible clusters.
 	m_eye = Vector4::zero();
 }
@@ -59,6 +59,7 @@ const render::Handle c_handleTerrain_DrawBuffer(L"Terrain_DrawBuffer");
 const render::Handle c_handleTerrain_CulledDrawBuffer(L"Terrain_CulledDrawBuffer");
 
 const int32_t c_patchLodSteps = 3;
+const float c_heightfieldPrefetchRadius = 256.0f;
 
 struct CullPatch
 {
@@ -143,6 +144,11 @@ void TerrainComponent::setup(
 	const Vector4 eyePosition = worldRenderView.getEyePosition();
 	const Vector4 eyeDirection = worldRenderView.getEyeDirection();
 
+	// Keep heightfield tiles around viewer resident, heights
+	// are queried by physics, undergrowth etc near the viewer.
+	if (!snapshot)
+		m_heightfield->prefetch(eyePosition, c_heightfieldPrefetchRadius);
+
 	const Vector4 patchExtent(worldExtent.x() / float(m_patchCount), worldExtent.y(), worldExtent.z() / float(m_patchCount), 0.0f);
 	const Vector4 patchDeltaHalf = patchExtent * Vector4(0.5f, 0.5f, 0.5f, 0.0f);
 	const Vector4 patchDeltaX = patchExtent * Vector4(1.0f, 0.0f, 0.0f, 0.0f);
@@ -854,6 +860,12 @@ bool TerrainComponent::createRayTracingPatches()
 	m_rtVertexBuffers.resize(m_patchCount * m_patchCount);
 	m_rtParts.resize(m_patchCount * m_patchCount);
 
+	AlignedVector< Vector4 > patchPositions(patchVertexCount);
+	AlignedVector< Vector4 > patchNormals(patchVertexCount);
+	AlignedVector< float > patchHeights(patchVertexCount);
+	AlignedVector< float > patchGridX(patchVertexCount);
+	AlignedVector< float > patchGridZ(patchVertexCount);
+
 	for (uint32_t pz = 0; pz < m_patchCount; ++pz)
 	{
 		Vector4 patchOrigin = patchTopLeft;
@@ -875,32 +887,38 @@ bool TerrainComponent::createRayTracingPatches()
 			if (!m_rtVertexBuffers[patchId])
 				return false;
 
-			// Shrink the RT terrain a bit to reduce self intersection due
-			// to mismatch between GBuffer and RT geometry.
-			const Scalar elevationOffset = -1.0_simd;
-
-			float* vertex = static_cast< float* >(m_rtVertexBuffers[patchId]->lock());
-			T_ASSERT_M(vertex, L"Unable to lock vertex buffer");
+			// Query heights and normals of all patch vertices at once.
 			for (uint32_t z = 0; z < patchDim; ++z)
 			{
 				for (uint32_t x = 0; x < patchDim; ++x)
 				{
+					const uint32_t index = x + z * patchDim;
+
 					const float fx = float(x) / (patchDim - 1);
 					const float fz = float(z) / (patchDim - 1);
 
 					const float worldX = lerp(patchAabb.mn.x(), patchAabb.mx.x(), fx);
 					const float worldZ = lerp(patchAabb.mn.z(), patchAabb.mx.z(), fz);
-					const float worldY = m_heightfield->getWorldHeight(worldX, worldZ);
 
-					float gridX, gridZ;
-					m_heightfield->worldToGrid(worldX, worldZ, gridX, gridZ);
+					patchPositions[index] = Vector4(worldX, 0.0f, worldZ, 1.0f);
+					m_heightfield->worldToGrid(worldX, worldZ, patchGridX[index], patchGridZ[index]);
+				}
+			}
+			m_heightfield->getWorldHeights(patchPositions.c_ptr(), patchVertexCount, patchHeights.ptr());
+			m_heightfield->normalsAt(patchGridX.c_ptr(), patchGridZ.c_ptr(), patchVertexCount, patchNormals.ptr());
 
-					const Vector4 normal = m_heightfield->normalAt(gridX, gridZ);
+			// Shrink the RT terrain a bit to reduce self intersection due
+			// to mismatch between GBuffer and RT geometry.
+			const Scalar elevationOffset = -1.0_simd;
 
-					*vertex++ = worldX + normal.x() * elevationOffset;
-					*vertex++ = worldY + normal.y() * elevationOffset;
-					*vertex++ = worldZ + normal.z() * elevationOffset;
-				}
+			float* vertex = static_cast< float* >(m_rtVertexBuffers[patchId]->lock());
+			T_ASSERT_M(vertex, L"Unable to lock vertex buffer");
+			for (uint32_t i = 0; i < patchVertexCount; ++i)
+			{
+				const Vector4& normal = patchNormals[i];
+				*vertex++ = patchPositions[i].x() + normal.x() * elevationOffset;
+				*vertex++ = patchHeights[i] + normal.y() * elevationOffset;
+				*vertex++ = patchPositions[i].z() + normal.z() * elevationOffset;
 			}
 			m_rtVertexBuffers[patchId]->unlock();
 
@@ -925,27 +943,13 @@ bool TerrainComponent::createRayTracingPatches()
 			{
 				const uint32_t index = m_indices[m_primitives[1].offset + i];
 
-				const int32_t ix = index % patchDim;
-				const int32_t iz = index / patchDim;
-
-				const float fx = float(ix) / (patchDim - 1);
-				const float fz = float(iz) / (patchDim - 1);
-
-				const float worldX = lerp(patchAabb.mn.x(), patchAabb.mx.x(), fx);
-				const float worldZ = lerp(patchAabb.mn.z(), patchAabb.mx.z(), fz);
-
-				float gridX, gridZ;
-				m_heightfield->worldToGrid(worldX, worldZ, gridX, gridZ);
-
-				const Vector4 normal = m_heightfield->normalAt(gridX, gridZ);
-
 				Vector4(0.2f, 0.4f, 0.1f, 0.0f).storeUnaligned3(va->albedo);
-				normal.storeUnaligned3(va->normal);
+				patchNormals[index].storeUnaligned3(va->normal);
 
 				va->emissive = 0.0f;
 
-				va->texCoord[0] = gridX / m_heightfield->getSize();
-				va->texCoord[1] = gridZ / m_heightfield->getSize();
+				va->texCoord[0] = patchGridX[index] / m_heightfield->getSize();
+				va->texCoord[1] = patchGridZ[index] / m_heightfield->getSize();
 				va->albedoMap = (m_surfaceCache != nullptr && m_surfaceCache->getBaseTexture() != nullptr) ? m_surfaceCache->getBaseTexture()->getBindlessIndex() : -1;
 
 				va++;
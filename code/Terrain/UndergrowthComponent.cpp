@@ -353,8 +353,6 @@ void UndergrowthComponent::updatePatches()
 			float wx, wz;
 			heightfield->gridToWorld(x + 8, z + 8, wx, wz);
 
-			const float wy = heightfield->getWorldHeight(wx, wz);
-
 			for (uint32_t i = 0; i < maxMaterialIndex; ++i)
 			{
 				if (cm[i] <= 0)
@@ -374,7 +372,7 @@ void UndergrowthComponent::updatePatches()
 						const int32_t to = from + density;
 
 						Cluster c;
-						c.center = Vector4(wx, wy, wz, 1.0f);
+						c.center = Vector4(wx, 0.0f, wz, 1.0f);
 						c.plant = plant.plant;
 						c.plantScale = plant.scale * (0.5f + 0.5f * densityFactor / (16.0f * 16.0f));
 						c.from = from;
@@ -387,6 +385,15 @@ void UndergrowthComponent::updatePatches()
 			}
 		}
 	}
+
+	// Place clusters on ground, heights of all clusters are queried at once.
+	AlignedVector< Vector4 > centers(m_clusters.size());
+	AlignedVector< float > heights(m_clusters.size());
+	for (uint32_t i = 0; i < m_clusters.size(); ++i)
+		centers[i] = m_clusters[i].center;
+	heightfield->getWorldHeights(centers.c_ptr(), (uint32_t)centers.size(), heights.ptr());
+	for (uint32_t i = 0; i < m_clusters.size(); ++i)
+		m_clusters[i].center = Vector4(centers[i].x(), heights[i], centers[i].z(), 1.0f);
 }
 
 }
@@ -54,6 +54,12 @@ bool TheaterEntityComponent::allowConcurrentUpdate() const
 	return false;
 }
 
+world::UpdatePhase TheaterEntityComponent::getUpdatePhase() const
+{
+	// Animated entities should be in place before they are updated.
+	return world::UpdatePhase::Early;
+}
+
 void TheaterEntityComponent::update(const world::UpdateParams& update)
 {
 	if (m_owner == nullptr)
@@ -51,6 +51,8 @@ public:
 
 	virtual bool allowConcurrentUpdate() const override final;
 
+	virtual world::UpdatePhase getUpdatePhase() const override final;
+
 	virtual void update(const world::UpdateParams& update) override final;
 
 	bool play(const std::wstring& actName);
@@ -9,6 +9,7 @@
 #include "World/Entity.h"
 
 #include "World/IEntityComponent.h"
+#include "World/World.h"
 
 namespace traktor::world
 {
@@ -79,6 +80,8 @@ void Entity::setTransform(const Transform& transform)
 	for (auto component : m_components)
 		if (component != m_updating)
 			component->setTransform(transform);
+
+	invalidateIndex();
 }
 
 Transform Entity::getTransform() const
@@ -104,18 +107,51 @@ bool Entity::needConcurrentUpdate() const
 	return false;
 }
 
+void Entity::getUpdatePhases(uint32_t& outConcurrent, uint32_t& outSerial) const
+{
+	outConcurrent = 0;
+	outSerial = 0;
+	for (auto component : m_components)
+	{
+		const uint32_t phase = 1 << (int32_t)component->getUpdatePhase();
+		if (component->allowConcurrentUpdate())
+			outConcurrent |= phase;
+		else
+			outSerial |= phase;
+	}
+}
+
 void Entity::update(const UpdateParams& update, bool concurrent)
+{
+	for (int32_t phase = 0; phase < (int32_t)UpdatePhase::Last; ++phase)
+		this->update(update, (UpdatePhase)phase, concurrent);
+}
+
+void Entity::update(const UpdateParams& update, UpdatePhase phase, bool concurrent)
 {
 	T_FATAL_ASSERT(m_world != nullptr);
 	for (auto component : m_components)
 	{
-		if (component->allowConcurrentUpdate() == concurrent)
+		if (component->allowConcurrentUpdate() == concurrent && component->getUpdatePhase() == phase)
 		{
 			m_updating = component;
 			component->update(update);
 		}
 	}
-	m_updating = nullptr;
+
+	// Updated components, such as animated meshes, might have changed bounds; moving
+	// entities have already invalidated index through setTransform.
+	if (m_updating)
+	{
+		m_updating = nullptr;
+
+		const Aabb3 boundingBox = getBoundingBox();
+		if (!(boundingBox.mn == m_updatedBoundingBox.mn && boundingBox.mx == m_updatedBoundingBox.mx))
+		{
+			m_updatedBoundingBox = boundingBox;
+			invalidateIndex();
+		}
+	}
 }
 
 void Entity::setComponent(IEntityComponent* component)
@@ -132,12 +168,14 @@ void Entity::setComponent(IEntityComponent* component)
 		if (is_type_of(type_of(m_components[i]), type_of(component)))
 		{
 			m_components[i] = component;
+			invalidateIndex();
 			return;
 		}
 	}
 
 	// No such component, add last.
 	m_components.push_back(component);
+	invalidateIndex();
 }
 
 IEntityComponent* Entity::getComponent(const TypeInfo& componentType) const
@@ -148,4 +186,10 @@ IEntityComponent* Entity::getComponent(const TypeInfo& componentType) const
 	return nullptr;
 }
 
+void Entity::invalidateIndex()
+{
+	if (m_world && m_indexProxy >= 0)
+		m_world->m_index.invalidate(this);
+}
+
 }
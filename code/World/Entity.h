@@ -118,19 +118,36 @@ public:
 	Aabb3 getBoundingBox() const;
 
 	/*! Check if this entity need to be updated
-	 * concurrently. All entities which can be updated
-	 * concurrently are updated before all who cannot.
+	 * concurrently. Within each phase all entities
+	 * which can be updated concurrently are updated
+	 * before all who cannot.
 	 * 
 	 * \return True if entity need to be updated concurrently.
 	 */
 	bool needConcurrentUpdate() const;
 
-	/*! Update entity.
+	/*! Get phases in which this entity need to be updated.
+	 *
+	 * \param outConcurrent Mask, bit (1 << phase), of phases with concurrent components.
+	 * \param outSerial Mask, bit (1 << phase), of phases with components which cannot be updated concurrently.
+	 */
+	void getUpdatePhases(uint32_t& outConcurrent, uint32_t& outSerial) const;
+
+	/*! Update entity, all phases in order.
 	 *
 	 * \param update Update parameters.
+	 * \param concurrent Update only components which allow, or disallow, concurrent update.
 	 */
 	void update(const UpdateParams& update, bool concurrent);
 
+	/*! Update entity components of a single phase.
+	 *
+	 * \param update Update parameters.
+	 * \param phase Update phase.
+	 * \param concurrent Update only components which allow, or disallow, concurrent update.
+	 */
+	void update(const UpdateParams& update, UpdatePhase phase, bool concurrent);
+
 	/*! Set component in entity.
 	 *
 	 * \param component Component instance.
@@ -165,6 +182,8 @@ public:
 	}
 
 private:
+	friend class EntityIndex;
+
 	World* m_world = nullptr;
 	Guid m_id;
 	std::wstring m_name;
@@ -172,6 +191,12 @@ private:
 	EntityState m_state;
 	RefArray< IEntityComponent > m_components;
 	const IEntityComponent* m_updating = nullptr;
+	Aabb3 m_updatedBoundingBox;		//!< Bounding box after last update, only accessed by update.
+	int32_t m_indexProxy = -1;		//!< Leaf in world's entity index, -1 if not indexed.
+	uint32_t m_indexInvalid = 0;	//!< Non-zero if moved, or bounds changed, since world's entity index was refreshed.
+	int32_t m_indexInvalidSlot = -1;	//!< Position in index's list of invalid entities, -1 if not listed.
+
+	void invalidateIndex();
 };
 
 }
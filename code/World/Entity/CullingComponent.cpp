@@ -39,6 +39,9 @@ static const render::Handle s_techniqueVelocityWrite(L"World_VelocityWrite");
  */
 constexpr uint32_t c_cullWorkGroupSize = 16;
 
+/*! Max number of culled instances still drawn, when culling on CPU, rather than splitting a run. */
+constexpr uint32_t c_cpuCullMaxGap = 4;
+
 /*! Order of instances in the instance buffer.
  *
  * Primarily sorted by ordinal so all instances of a single mesh form one run which
@@ -67,6 +70,7 @@ void CullingComponent::destroy()
 {
 	T_FATAL_ASSERT_M(m_instances.empty(), L"Culling instances not empty.");
 	safeDestroy(m_instanceBuffer);
+	safeDestroy(m_visibleBuffer);
 	for (auto visibilityBuffer : m_visibilityBuffers)
 		if (visibilityBuffer)
 			visibilityBuffer->destroy();
@@ -89,21 +93,34 @@ void CullingComponent::build(
 
 	render::RenderContext* renderContext = context.getRenderContext();
 	const uint32_t bufferItemCount = (uint32_t)alignUp(m_instances.size(), c_cullWorkGroupSize);
+	const bool cullOnCpu = m_cullOnCpu || !m_shaderCull;
 
 	// Lazy create the buffers if necessary.
 	if (!m_instanceBuffer || bufferItemCount > m_instanceAllocatedCount)
 	{
 		m_instanceBuffer = m_renderSystem->createBuffer(render::BufferUsage::BuStructured, bufferItemCount * sizeof(InstanceRenderData), true, T_FILE_LINE_W);
 		m_visibilityBuffers.resize(0);
+		m_visibleBuffer = nullptr;
 		m_instanceAllocatedCount = bufferItemCount;
 		m_instanceBufferDirty = true;
 	}
 
-	// Ensure we have visibility buffers for all cascades.
-	const int32_t peakShadowMapIndex = worldRenderView.getShadowMapIndex();
-	const uint32_t vbSize = (uint32_t)m_visibilityBuffers.size();
-	for (uint32_t i = vbSize; i < peakShadowMapIndex + 1; ++i)
-		m_visibilityBuffers.push_back(m_renderSystem->createBuffer(render::BufferUsage::BuStructured, bufferItemCount * sizeof(float), false, T_FILE_LINE_W));
+	// Ensure we have visibility buffers for all cascades; when culling on CPU
+	// all are drawn with a single buffer marking every instance as visible.
+	if (!cullOnCpu)
+	{
+		const int32_t peakShadowMapIndex = worldRenderView.getShadowMapIndex();
+		const uint32_t vbSize = (uint32_t)m_visibilityBuffers.size();
+		for (uint32_t i = vbSize; i < (uint32_t)(peakShadowMapIndex + 1); ++i)
+			m_visibilityBuffers.push_back(m_renderSystem->createBuffer(render::BufferUsage::BuStructured, bufferItemCount * sizeof(float), false, T_FILE_LINE_W));
+	}
+	else if (!m_visibleBuffer)
+	{
+		m_visibleBuffer = m_renderSystem->createBuffer(render::BufferUsage::BuStructured, m_instanceAllocatedCount * sizeof(int32_t), false, T_FILE_LINE_W);
+		auto ptr = (int32_t*)m_visibleBuffer->lock();
+		std::fill(ptr, ptr + m_instanceAllocatedCount, 1);
+		m_visibleBuffer->unlock();
+	}
 
 	// Update buffer is any instance has moved.
 	if (m_instanceBufferDirty)
@@ -132,6 +149,12 @@ void CullingComponent::build(
 		m_velocityDirty = false;
 	}
 
+	if (cullOnCpu)
+	{
+		buildCullOnCpu(context, worldRenderView, worldRenderPass);
+		return;
+	}
+
 	render::Buffer* visibilityBuffer = m_visibilityBuffers[worldRenderView.getShadowMapIndex()];
 
 	// Every pass which culls (g-buffer, shadow, velocity, ...) reuses the same set of
@@ -157,7 +180,7 @@ void CullingComponent::build(
 		T_FATAL_ASSERT(cf.planes.size() <= sizeof_array(cullFrustum));
 		for (int32_t i = 0; i < (int32_t)cf.planes.size(); ++i)
 			cullFrustum[i] = cf.planes[i].normal().xyz0() + Vector4(0.0f, 0.0f, 0.0f, cf.planes[i].distance());
-		for (int32_t i = (int32_t)cf.planes.size(); i < sizeof_array(cullFrustum); ++i)
+		for (int32_t i = (int32_t)cf.planes.size(); i < (int32_t)sizeof_array(cullFrustum); ++i)
 			cullFrustum[i] = Vector4::zero();
 
 		const Vector2 viewSize = worldRenderView.getViewSize();
@@ -239,6 +262,86 @@ void CullingComponent::build(
 	}
 }
 
+void CullingComponent::buildCullOnCpu(
+	const WorldBuildContext& context,
+	const WorldRenderView& worldRenderView,
+	const IWorldRenderPass& worldRenderPass)
+{
+	const uint32_t instanceCount = (uint32_t)m_instances.size();
+
+	if (m_boundsDirty)
+	{
+		m_cullingCpu.setInstanceCount(instanceCount);
+		for (uint32_t i = 0; i < instanceCount; ++i)
+			m_cullingCpu.setInstanceBounds(i, m_instances[i]->boundingBox);
+		m_boundsDirty = false;
+	}
+
+	m_cullingCpu.beginView(worldRenderView.getView(), worldRenderView.getProjection());
+	if (m_occlusionCulling)
+	{
+		for (auto occluder : m_occluders)
+			m_cullingCpu.rasterizeOccluder(occluder->occluder, occluder->transform);
+	}
+
+	m_visibility.resize(instanceCount);
+	if (m_cullingCpu.cull(worldRenderView.getCullFrustum(), m_visibility.ptr()) == 0)
+		return;
+
+	// Build visible ranges of each run; small gaps of culled instances are drawn
+	// rather than splitting run into more batches.
+	const bool staticOnly = worldRenderView.getStaticOnly();
+	for (uint32_t i = 0; i < instanceCount;)
+	{
+		uint32_t j = i + 1;
+		for (; j < instanceCount; ++j)
+			if (m_instances[i]->ordinal != m_instances[j]->ordinal)
+				break;
+
+		uint32_t k = j;
+		if (staticOnly)
+		{
+			for (k = i; k < j; ++k)
+				if (m_instances[k]->dynamic)
+					break;
+		}
+
+		for (uint32_t from = i; from < k;)
+		{
+			if (!m_visibility[from])
+			{
+				++from;
+				continue;
+			}
+
+			uint32_t to = from + 1;
+			for (uint32_t gap = 0; to + gap < k && gap <= c_cpuCullMaxGap;)
+			{
+				if (m_visibility[to + gap])
+				{
+					to += gap + 1;
+					gap = 0;
+				}
+				else
+					++gap;
+			}
+
+			m_instances[from]->cullable->cullableBuild(
+				context,
+				worldRenderView,
+				worldRenderPass,
+				m_instanceBuffer,
+				m_visibleBuffer,
+				from,
+				(to - from));
+
+			from = to;
+		}
+
+		i = j;
+	}
+}
+
 CullingComponent::Instance* CullingComponent::createInstance(ICullable* cullable, intptr_t ordinal, bool dynamic)
 {
 	Instance* instance = new Instance();
@@ -262,6 +365,9 @@ void CullingComponent::destroyInstance(Instance* instance)
 	{
 		m_instances.erase(it);
 		m_instanceBufferDirty = true;
+		m_boundsDirty = true;
+		if (!instance->occluder.empty())
+			m_occluders.erase(std::find(m_occluders.begin(), m_occluders.end(), instance));
 		delete instance;
 	}
 }
@@ -274,6 +380,7 @@ void CullingComponent::insertInstance(Instance* instance)
 
 	// All instances following the inserted one have shifted position in the buffer.
 	m_instanceBufferDirty = true;
+	m_boundsDirty = true;
 }
 
 void CullingComponent::Instance::destroy()
@@ -289,6 +396,7 @@ void CullingComponent::Instance::setTransform(const Transform& transform)
 	this->boundingBox = this->cullable->cullableGetBoundingBox().transform(transform);
 	this->owner->m_instanceBufferDirty = true;
 	this->owner->m_velocityDirty = true;
+	this->owner->m_boundsDirty = true;
 }
 
 void CullingComponent::Instance::setDynamic(bool dynamic)
@@ -306,4 +414,14 @@ void CullingComponent::Instance::setDynamic(bool dynamic)
 	this->owner->insertInstance(this);
 }
 
+void CullingComponent::Instance::setOccluder(const Aabb3& occluder)
+{
+	AlignedVector< Instance* >& occluders = this->owner->m_occluders;
+	if (!occluder.empty() && this->occluder.empty())
+		occluders.push_back(this);
+	else if (occluder.empty() && !this->occluder.empty())
+		occluders.erase(std::find(occluders.begin(), occluders.end(), this));
+	this->occluder = occluder;
+}
+
 }
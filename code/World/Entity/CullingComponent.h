@@ -13,6 +13,7 @@
 #include "Core/Math/Aabb3.h"
 #include "Resource/Proxy.h"
 #include "World/IWorldComponent.h"
+#include "World/Entity/CullingCpu.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -89,6 +90,7 @@ public:
 		Transform transform;
 		Transform lastTransform;
 		Aabb3 boundingBox;
+		Aabb3 occluder;
 
 		void destroy();
 
@@ -99,6 +101,15 @@ public:
 		 * Dynamic instances are not rendered in static only passes.
 		 */
 		void setDynamic(bool dynamic);
+
+		/*! Set occluder box, in instance space.
+		 *
+		 * Box must be fully inside of instance's geometry since
+		 * everything behind it is considered hidden. Only used
+		 * when culling on CPU with occlusion culling enabled;
+		 * empty box if not an occluder.
+		 */
+		void setOccluder(const Aabb3& occluder);
 	};
 
 	explicit CullingComponent(resource::IResourceManager* resourceManager, render::IRenderSystem* renderSystem);
@@ -115,15 +126,44 @@ public:
 
 	Instance* createInstance(ICullable* cullable, intptr_t ordinal, bool dynamic);
 
+	/*! Cull instances on CPU even if compute culling is available.
+	 *
+	 * Culling on CPU is always used when culling shader is not available.
+	 * Only visible ranges of instances are built thus culled instances
+	 * never reach render context.
+	 */
+	void setCullOnCpu(bool cullOnCpu) { m_cullOnCpu = cullOnCpu; }
+
+	/*! Rasterize occluders and reject hidden instances when culling on CPU.
+	 *
+	 * Off by default since rasterizing and testing depth
+	 * cost more than it saves unless occluders hide
+	 * a large portion of instances.
+	 */
+	void setOcclusionCulling(bool occlusionCulling) { m_occlusionCulling = occlusionCulling; }
+
 private:
 	Ref< render::IRenderSystem > m_renderSystem;
 	resource::Proxy< render::Shader > m_shaderCull;
 	AlignedVector< Instance* > m_instances;
 	Ref< render::Buffer > m_instanceBuffer;
 	RefArray< render::Buffer > m_visibilityBuffers;
+	Ref< render::Buffer > m_visibleBuffer;	//!< All instances visible, used when culling on CPU.
+	CullingCpu m_cullingCpu;
+	AlignedVector< Instance* > m_occluders;
+	AlignedVector< int32_t > m_visibility;
 	uint32_t m_instanceAllocatedCount = 0;
 	bool m_instanceBufferDirty = false;
 	bool m_velocityDirty = false;
+	bool m_boundsDirty = false;
+	bool m_cullOnCpu = false;
+	bool m_occlusionCulling = false;
+
+	void buildCullOnCpu(
+		const WorldBuildContext& context,
+		const WorldRenderView& worldRenderView,
+		const IWorldRenderPass& worldRenderPass
+	);
 
 	void destroyInstance(Instance* instance);
 
@@ -0,0 +1,334 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "World/Entity/CullingCpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Transform.h"
+#include "Core/Misc/Align.h"
+
+namespace traktor::world
+{
+namespace
+{
+
+const float c_farDepth = std::numeric_limits< float >::max();
+const float c_nearDepth = 1e-3f;	//!< Anything closer than this is never occluded nor occluding.
+const int32_t c_levels = 8;
+const int32_t c_maxTestSpan = 3;	//!< Max span, in texels, of rectangle when testing depth.
+
+enum
+{
+	CenterX,
+	CenterY,
+	CenterZ,
+	ExtentX,
+	ExtentY,
+	ExtentZ
+};
+
+}
+
+CullingCpu::CullingCpu()
+{
+	for (int32_t level = 0; level < c_levels; ++level)
+		m_depth[level].resize((DepthWidth >> level) * (DepthHeight >> level), c_farDepth);
+}
+
+void CullingCpu::setInstanceCount(uint32_t count)
+{
+	const uint32_t paddedCount = alignUp(count, 4);
+	for (auto& bounds : m_bounds)
+	{
+		bounds.resize(paddedCount);
+		for (uint32_t i = count; i < paddedCount; ++i)
+			bounds[i] = 0.0f;
+	}
+	m_instanceCount = count;
+}
+
+void CullingCpu::setInstanceBounds(uint32_t index, const Aabb3& bounds)
+{
+	T_ASSERT(index < m_instanceCount);
+	const Vector4 center = bounds.getCenter();
+	const Vector4 extent = bounds.getExtent();
+	m_bounds[CenterX][index] = center.x();
+	m_bounds[CenterY][index] = center.y();
+	m_bounds[CenterZ][index] = center.z();
+	m_bounds[ExtentX][index] = extent.x();
+	m_bounds[ExtentY][index] = extent.y();
+	m_bounds[ExtentZ][index] = extent.z();
+}
+
+void CullingCpu::beginView(const Matrix44& view, const Matrix44& projection)
+{
+	m_view = view;
+	m_viewProjection = projection * view;
+	m_viewZ = Vector4(view.get(2, 0), view.get(2, 1), view.get(2, 2), view.get(2, 3));
+	if (m_occluderCount > 0)
+	{
+		std::fill(m_depth[0].begin(), m_depth[0].end(), c_farDepth);
+		m_occluderCount = 0;
+	}
+	m_depthDirty = false;
+}
+
+void CullingCpu::rasterizeOccluder(const Aabb3& box, const Transform& transform)
+{
+	const int* faces = Aabb3::getFaces();
+
+	Vector4 extents[8];
+	box.getExtents(extents);
+	for (auto& extent : extents)
+		extent = transform * extent;
+
+	Vector4 vertices[6 * 2 * 3];
+	Vector4* ptr = vertices;
+	for (int32_t i = 0; i < 6; ++i, faces += 4)
+	{
+		*ptr++ = extents[faces[0]];
+		*ptr++ = extents[faces[1]];
+		*ptr++ = extents[faces[2]];
+		*ptr++ = extents[faces[0]];
+		*ptr++ = extents[faces[2]];
+		*ptr++ = extents[faces[3]];
+	}
+
+	rasterizeOccluder(vertices, 6 * 2);
+}
+
+void CullingCpu::rasterizeOccluder(const Vector4* vertices, uint32_t triangleCount)
+{
+	for (uint32_t i = 0; i < triangleCount; ++i, vertices += 3)
+		rasterizeTriangle(vertices[0], vertices[1], vertices[2]);
+	m_occluderCount += triangleCount;
+	m_depthDirty = true;
+}
+
+uint32_t CullingCpu::cull(const Frustum& viewFrustum, int32_t* outVisibility)
+{
+	// Transform frustum planes into world space so we don't have to transform bounds.
+	const Matrix44 viewInverse = m_view.inverse();
+
+	struct WorldPlane
+	{
+		Vector4 nx, ny, nz, ax, ay, az, d;
+	};
+
+	WorldPlane planes[12];
+	const uint32_t planeCount = (uint32_t)viewFrustum.planes.size();
+	for (uint32_t i = 0; i < planeCount; ++i)
+	{
+		const Plane plane = viewInverse * viewFrustum.planes[i];
+		const Vector4 n = plane.normal();
+		const Vector4 an = n.absolute();
+		planes[i] = { Vector4(n.x()), Vector4(n.y()), Vector4(n.z()), Vector4(an.x()), Vector4(an.y()), Vector4(an.z()), Vector4(plane.distance()) };
+	}
+
+	if (m_depthDirty)
+	{
+		buildDepthLevels();
+		m_depthDirty = false;
+	}
+
+	const float* cx = m_bounds[CenterX].c_ptr();
+	const float* cy = m_bounds[CenterY].c_ptr();
+	const float* cz = m_bounds[CenterZ].c_ptr();
+	const float* ex = m_bounds[ExtentX].c_ptr();
+	const float* ey = m_bounds[ExtentY].c_ptr();
+	const float* ez = m_bounds[ExtentZ].c_ptr();
+
+	T_MATH_ALIGN16 int32_t visible[4];
+	uint32_t visibleCount = 0;
+
+	m_occludedCount = 0;
+
+	for (uint32_t i = 0; i < m_instanceCount; i += 4)
+	{
+		const Vector4 x = Vector4::loadAligned(&cx[i]);
+		const Vector4 y = Vector4::loadAligned(&cy[i]);
+		const Vector4 z = Vector4::loadAligned(&cz[i]);
+		const Vector4 u = Vector4::loadAligned(&ex[i]);
+		const Vector4 v = Vector4::loadAligned(&ey[i]);
+		const Vector4 w = Vector4::loadAligned(&ez[i]);
+
+		// Distance of box corner farthest along each plane normal, negative if outside of any plane.
+		Vector4 distance = Vector4(Scalar(c_farDepth));
+		for (uint32_t j = 0; j < planeCount; ++j)
+		{
+			const WorldPlane& p = planes[j];
+			distance = min(distance, p.nx * x + p.ny * y + p.nz * z - p.d + p.ax * u + p.ay * v + p.az * w);
+		}
+		select(distance, Vector4::zero(), Vector4::one()).storeIntegersAligned(visible);
+
+		const uint32_t count = std::min< uint32_t >(m_instanceCount - i, 4);
+		for (uint32_t j = 0; j < count; ++j)
+		{
+			if (visible[j] && m_occluderCount > 0 && occluded(i + j))
+			{
+				visible[j] = 0;
+				++m_occludedCount;
+			}
+			outVisibility[i + j] = visible[j];
+			visibleCount += visible[j];
+		}
+	}
+
+	return visibleCount;
+}
+
+void CullingCpu::rasterizeTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2)
+{
+	const Vector4 wv[] = { v0.xyz1(), v1.xyz1(), v2.xyz1() };
+
+	float sx[3], sy[3];
+	float depth = 0.0f;
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		// Triangles crossing near plane are skipped, occluders are optional.
+		const float vz = (m_view * wv[i]).z();
+		if (vz <= c_nearDepth)
+			return;
+		depth = std::max(depth, vz);
+
+		const Vector4 clip = m_viewProjection * wv[i];
+		const float iw = 1.0f / clip.w();
+		sx[i] = (clip.x() * iw * 0.5f + 0.5f) * DepthWidth;
+		sy[i] = (0.5f - clip.y() * iw * 0.5f) * DepthHeight;
+	}
+
+	float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+	if (std::abs(area) <= 1e-6f)
+		return;
+
+	// Orient edges so covered pixels are positive regardless of winding.
+	const float sign = area > 0.0f ? 1.0f : -1.0f;
+
+	const int32_t x0 = std::max((int32_t)std::floor(std::min({ sx[0], sx[1], sx[2] })), 0);
+	const int32_t x1 = std::min((int32_t)std::ceil(std::max({ sx[0], sx[1], sx[2] })), DepthWidth - 1);
+	const int32_t y0 = std::max((int32_t)std::floor(std::min({ sy[0], sy[1], sy[2] })), 0);
+	const int32_t y1 = std::min((int32_t)std::ceil(std::max({ sy[0], sy[1], sy[2] })), DepthHeight - 1);
+	if (x0 > x1 || y0 > y1)
+		return;
+
+	// Inner conservative coverage; evaluate each edge at the pixel corner least inside of
+	// that edge so only pixels entirely covered by the triangle are written.
+	float dx[3], dy[3], e[3];
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		const int32_t j = (i + 1) % 3;
+		dx[i] = (sx[j] - sx[i]) * sign;
+		dy[i] = (sy[j] - sy[i]) * sign;
+		const float cx = dy[i] > 0.0f ? 1.0f : 0.0f;
+		const float cy = dx[i] < 0.0f ? 1.0f : 0.0f;
+		e[i] = dx[i] * (y0 + cy - sy[i]) - dy[i] * (x0 + cx - sx[i]);
+	}
+
+	float* row = m_depth[0].ptr() + y0 * DepthWidth;
+	for (int32_t y = y0; y <= y1; ++y, row += DepthWidth)
+	{
+		float e0 = e[0], e1 = e[1], e2 = e[2];
+		for (int32_t x = x0; x <= x1; ++x)
+		{
+			if (e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f)
+				row[x] = std::min(row[x], depth);
+			e0 -= dy[0];
+			e1 -= dy[1];
+			e2 -= dy[2];
+		}
+		e[0] += dx[0];
+		e[1] += dx[1];
+		e[2] += dx[2];
+	}
+}
+
+void CullingCpu::buildDepthLevels()
+{
+	for (int32_t level = 1; level < c_levels; ++level)
+	{
+		const int32_t width = DepthWidth >> level;
+		const int32_t height = DepthHeight >> level;
+		const int32_t fineWidth = width * 2;
+		const float* fine = m_depth[level - 1].c_ptr();
+		float* coarse = m_depth[level].ptr();
+
+		for (int32_t y = 0; y < height; ++y)
+		{
+			const float* r0 = fine + (y * 2) * fineWidth;
+			const float* r1 = r0 + fineWidth;
+			for (int32_t x = 0; x < width; ++x)
+				coarse[y * width + x] = std::max(std::max(r0[x * 2], r0[x * 2 + 1]), std::max(r1[x * 2], r1[x * 2 + 1]));
+		}
+	}
+}
+
+bool CullingCpu::occluded(uint32_t index) const
+{
+	const Vector4 center(m_bounds[CenterX][index], m_bounds[CenterY][index], m_bounds[CenterZ][index], 1.0f);
+	const Scalar ex(m_bounds[ExtentX][index]);
+	const Scalar ey(m_bounds[ExtentY][index]);
+	const Scalar ez(m_bounds[ExtentZ][index]);
+
+	// Nearest depth of box; bounds crossing near plane cannot be projected.
+	const float minZ = dot4(m_viewZ, center) - dot3(m_viewZ.absolute(), Vector4(ex, ey, ez, 0.0_simd));
+	if (minZ <= c_nearDepth)
+		return false;
+
+	// Project corners as center plus or minus projected axes, four corners in each lane.
+	const Vector4 pc = m_viewProjection * center;
+	const Vector4 px = m_viewProjection.axisX() * ex;
+	const Vector4 py = m_viewProjection.axisY() * ey;
+	const Vector4 pz = m_viewProjection.axisZ() * ez;
+
+	const Vector4 signX(-1.0f, 1.0f, -1.0f, 1.0f);
+	const Vector4 signY(-1.0f, -1.0f, 1.0f, 1.0f);
+
+	const Vector4 x = Vector4(pc.x()) + signX * px.x() + signY * py.x();
+	const Vector4 y = Vector4(pc.y()) + signX * px.y() + signY * py.y();
+	const Vector4 w = Vector4(pc.w()) + signX * px.w() + signY * py.w();
+
+	const Vector4 iw0 = Vector4::one() / (w - pz.w());
+	const Vector4 iw1 = Vector4::one() / (w + pz.w());
+	const Vector4 sx0 = (x - pz.x()) * iw0, sx1 = (x + pz.x()) * iw1;
+	const Vector4 sy0 = (y - pz.y()) * iw0, sy1 = (y + pz.y()) * iw1;
+
+	const float minX = (min(sx0, sx1).min() * 0.5f + 0.5f) * DepthWidth;
+	const float maxX = (max(sx0, sx1).max() * 0.5f + 0.5f) * DepthWidth;
+	const float minY = (0.5f - max(sy0, sy1).max() * 0.5f) * DepthHeight;
+	const float maxY = (0.5f - min(sy0, sy1).min() * 0.5f) * DepthHeight;
+
+	const int32_t x0 = std::max((int32_t)std::floor(minX), 0);
+	const int32_t x1 = std::min((int32_t)std::floor(maxX), DepthWidth - 1);
+	const int32_t y0 = std::max((int32_t)std::floor(minY), 0);
+	const int32_t y1 = std::min((int32_t)std::floor(maxY), DepthHeight - 1);
+	if (x0 > x1 || y0 > y1)
+		return false;
+
+	// Use coarse enough level so only a few texels need to be read.
+	int32_t level = 0;
+	while (level < c_levels - 1 && ((x1 >> level) - (x0 >> level) > c_maxTestSpan || (y1 >> level) - (y0 >> level) > c_maxTestSpan))
+		++level;
+
+	const int32_t width = DepthWidth >> level;
+	const float* depth = m_depth[level].c_ptr();
+	for (int32_t y = y0 >> level; y <= (y1 >> level); ++y)
+	{
+		for (int32_t x = x0 >> level; x <= (x1 >> level); ++x)
+		{
+			if (depth[y * width + x] >= minZ)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+}
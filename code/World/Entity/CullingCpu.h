@@ -0,0 +1,113 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Config.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Aabb3.h"
+#include "Core/Math/Matrix44.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_WORLD_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class Frustum;
+class Transform;
+
+}
+
+namespace traktor::world
+{
+
+/*! CPU culling of instance bounds.
+ * \ingroup World
+ *
+ * Bounds are kept as structure-of-arrays and tested
+ * against frustum four at a time. Instances passing
+ * frustum test are then tested against a low resolution
+ * depth buffer into which occluders has been rasterized.
+ *
+ * Occluders must be fully inside of solid geometry since
+ * everything behind them is considered hidden. Depth of
+ * each occluder triangle is it's farthest depth and only
+ * pixels entirely covered are written thus depth buffer
+ * is conservative.
+ */
+class T_DLLCLASS CullingCpu
+{
+public:
+	static constexpr int32_t DepthWidth = 256;
+	static constexpr int32_t DepthHeight = 128;
+
+	CullingCpu();
+
+	/*! Set number of instances. */
+	void setInstanceCount(uint32_t count);
+
+	/*! Set world space bounds of instance. */
+	void setInstanceBounds(uint32_t index, const Aabb3& bounds);
+
+	/*! Begin culling from view; clear depth buffer.
+	 *
+	 * \param view View transform.
+	 * \param projection Projection transform.
+	 */
+	void beginView(const Matrix44& view, const Matrix44& projection);
+
+	/*! Rasterize occluder box.
+	 *
+	 * \param box Occluder box.
+	 * \param transform Transform of box into world space.
+	 */
+	void rasterizeOccluder(const Aabb3& box, const Transform& transform);
+
+	/*! Rasterize occluder triangles.
+	 *
+	 * \param vertices World space vertices, three per triangle.
+	 * \param triangleCount Number of triangles.
+	 */
+	void rasterizeOccluder(const Vector4* vertices, uint32_t triangleCount);
+
+	/*! Cull instances.
+	 *
+	 * \param viewFrustum Frustum, in view space, of current view.
+	 * \param outVisibility One value per instance, 1 if visible else 0; same layout as GPU visibility buffer.
+	 * \return Number of visible instances.
+	 */
+	uint32_t cull(const Frustum& viewFrustum, int32_t* outVisibility);
+
+	/*! Number of instances rejected by depth test in last cull. */
+	uint32_t getOccludedCount() const { return m_occludedCount; }
+
+private:
+	AlignedVector< float > m_bounds[6];	//!< Center xyz and extent xyz, padded to multiple of four.
+	AlignedVector< float > m_depth[8];	//!< View space depth; level 0 is nearest occluder, rest max of finer level.
+	Matrix44 m_view;
+	Matrix44 m_viewProjection;
+	Vector4 m_viewZ;	//!< Row of view transform giving view space depth.
+	uint32_t m_instanceCount = 0;
+	uint32_t m_occluderCount = 0;
+	uint32_t m_occludedCount = 0;
+	bool m_depthDirty = false;
+
+	void rasterizeTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2);
+
+	void buildDepthLevels();
+
+	bool occluded(uint32_t index) const;
+};
+
+}
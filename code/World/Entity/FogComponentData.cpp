@@ -10,6 +10,7 @@
 #include "Core/Serialization/AttributeRange.h"
 #include "Core/Serialization/AttributeUnit.h"
 #include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/SerializationPlan.h"
 #include "World/Entity/FogComponent.h"
 #include "World/Entity/FogComponentData.h"
 
@@ -17,6 +18,7 @@ namespace traktor::world
 {
 
 T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.world.FogComponentData", 4, FogComponentData, IWorldComponentData)
+T_IMPLEMENT_SERIALIZATION_PLAN(FogComponentData)
 
 Ref< FogComponent > FogComponentData::createComponent() const
 {
@@ -9,12 +9,14 @@
 #include "Core/Serialization/AttributeDirection.h"
 #include "Core/Serialization/ISerializer.h"
 #include "Core/Serialization/Member.h"
+#include "Core/Serialization/SerializationPlan.h"
 #include "World/Entity/VolumeComponentData.h"
 
 namespace traktor::world
 {
 
 T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.world.VolumeComponentData", 0, VolumeComponentData, IEntityComponentData)
+T_IMPLEMENT_SERIALIZATION_PLAN(VolumeComponentData)
 
 int32_t VolumeComponentData::getOrdinal() const
 {
@@ -0,0 +1,670 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Core/Containers/StaticVector.h"
+#include "Core/Math/Frustum.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Atomic.h"
+#include "World/Entity.h"
+#include "World/EntityIndex.h"
+
+namespace traktor::world
+{
+	namespace
+	{
+
+const Scalar c_margin(1.0f);
+const int32_t c_maxStackDepth = 128;
+
+Aabb3 unionOf(const Aabb3& a, const Aabb3& b)
+{
+	return Aabb3(min(a.mn, b.mn), max(a.mx, b.mx));
+}
+
+float surfaceArea(const Aabb3& aabb)
+{
+	const Vector4 e = aabb.mx - aabb.mn;
+	return 2.0f * (e.x() * e.y() + e.y() * e.z() + e.z() * e.x());
+}
+
+bool enclose(const Aabb3& outer, const Aabb3& inner)
+{
+	return compareAllLessEqual(outer.mn, inner.mn) && compareAllGreaterEqual(outer.mx, inner.mx);
+}
+
+/*! World space bounds of entity, always including it's position. */
+Aabb3 calculateBounds(const Entity* entity)
+{
+	const Transform transform = entity->getTransform();
+	const Aabb3 boundingBox = entity->getBoundingBox();
+
+	Aabb3 bounds = !boundingBox.empty() ? boundingBox.transform(transform) : Aabb3();
+	bounds.contain(transform.translation().xyz1());
+	return bounds;
+}
+
+/*! Separating axis test; Aabb3::overlap only check corners thus miss crossing boxes. */
+bool overlapping(const Aabb3& a, const Aabb3& b)
+{
+	return compareAllLessEqual(a.mn.xyz0(), b.mx.xyz0()) && compareAllLessEqual(b.mn.xyz0(), a.mx.xyz0());
+}
+
+	}
+
+size_t EntityIndex::GuidHash::operator () (const Guid& id) const
+{
+	uint64_t h[2];
+	std::memcpy(h, (const uint8_t*)id, sizeof(h));
+	return size_t(h[0] ^ (h[1] * 0x9e3779b97f4a7c15ULL));
+}
+
+EntityIndex::EntityIndex()
+{
+}
+
+void EntityIndex::insert(Entity* entity)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	T_FATAL_ASSERT(entity->m_indexProxy < 0);
+
+	const int32_t leaf = allocateNode();
+	Node& node = m_nodes[leaf];
+	node.bounds = calculateBounds(entity);
+	node.aabb = node.bounds.expand(c_margin);
+	node.entity = entity;
+	node.serial = m_serial++;
+	insertLeaf(leaf);
+
+	entity->m_indexProxy = leaf;
+	if (entity->getId().isNotNull())
+		m_ids[entity->getId()].push_back(entity);
+	if (!entity->getName().empty())
+		m_names[entity->getName()].push_back(entity);
+	m_count++;
+}
+
+void EntityIndex::remove(Entity* entity)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	const int32_t leaf = entity->m_indexProxy;
+	if (leaf < 0)
+		return;
+
+	// Entity might be deleted as soon as it's removed, must not be left pending.
+	if (entity->m_indexInvalid != 0)
+	{
+		// Swap with last, order of invalid entities doesn't matter; slot might not yet be
+		// assigned if another thread is about to record entity, it will see entity has been
+		// removed once it has acquired lock.
+		const int32_t slot = entity->m_indexInvalidSlot;
+		if (slot >= 0)
+		{
+			Entity* last = m_invalid.back();
+			m_invalid[slot] = last;
+			last->m_indexInvalidSlot = slot;
+			m_invalid.pop_back();
+			entity->m_indexInvalidSlot = -1;
+		}
+		entity->m_indexInvalid = 0;
+	}
+
+	// Must be removed from buckets while leaf, which hold serial, is still valid.
+	if (entity->getId().isNotNull())
+	{
+		auto it = m_ids.find(entity->getId());
+		eraseFromBucket(it->second, entity);
+		if (it->second.empty())
+			m_ids.erase(it);
+	}
+
+	if (!entity->getName().empty())
+	{
+		auto it = m_names.find(entity->getName());
+		eraseFromBucket(it->second, entity);
+		if (it->second.empty())
+			m_names.erase(it);
+	}
+
+	removeLeaf(leaf);
+	freeNode(leaf);
+	entity->m_indexProxy = -1;
+
+	m_count--;
+}
+
+void EntityIndex::clear()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	for (const auto& node : m_nodes)
+	{
+		if (node.height == 0 && node.entity)
+			node.entity->m_indexProxy = -1;
+	}
+	for (auto entity : m_invalid)
+	{
+		entity->m_indexInvalid = 0;
+		entity->m_indexInvalidSlot = -1;
+	}
+
+	m_nodes.clear();
+	m_invalid.clear();
+	m_root = -1;
+	m_freeList = -1;
+	m_count = 0;
+	m_ids.clear();
+	m_names.clear();
+}
+
+bool EntityIndex::contains(const Entity* entity) const
+{
+	return entity->m_indexProxy >= 0;
+}
+
+void EntityIndex::invalidate(Entity* entity)
+{
+	// Only first change since last refresh need to be recorded.
+	if (Atomic::exchange(entity->m_indexInvalid, 1U) != 0)
+		return;
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	if (entity->m_indexProxy >= 0)
+	{
+		entity->m_indexInvalidSlot = (int32_t)m_invalid.size();
+		m_invalid.push_back(entity);
+	}
+	else
+		entity->m_indexInvalid = 0;
+}
+
+Entity* EntityIndex::find(const Guid& id) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	const auto it = m_ids.find(id);
+	return it != m_ids.end() ? it->second.front() : nullptr;
+}
+
+Entity* EntityIndex::find(const std::wstring& name, int32_t index) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	const auto it = m_names.find(name);
+	if (it == m_names.end())
+		return nullptr;
+
+	const auto& entities = it->second;
+	index = std::max(index, 0);
+	return index < (int32_t)entities.size() ? entities[index] : nullptr;
+}
+
+void EntityIndex::findAll(const std::wstring& name, RefArray< Entity >& outEntities) const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	const auto it = m_names.find(name);
+	if (it == m_names.end())
+		return;
+
+	outEntities.reserve(outEntities.size() + it->second.size());
+	for (auto entity : it->second)
+		outEntities.push_back(entity);
+}
+
+void EntityIndex::queryRange(const Vector4& position, float range, RefArray< Entity >& outEntities)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	refresh();
+
+	if (m_root < 0 || range < 0.0f)
+		return;
+
+	const Vector4 center = position.xyz1();
+	const Scalar radius(range);
+
+	AlignedVector< std::pair< uint32_t, Entity* > > found;
+	StaticVector< int32_t, c_maxStackDepth > stack;
+	stack.push_back(m_root);
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+
+		if (!node.aabb.queryIntersectionSphere(center, radius))
+			continue;
+
+		if (node.height == 0)
+		{
+			const Scalar distance = (node.entity->getTransform().translation() - center).xyz0().length();
+			if (distance <= radius)
+				found.push_back({ node.serial, node.entity });
+		}
+		else
+		{
+			stack.push_back(node.child[0]);
+			stack.push_back(node.child[1]);
+		}
+	}
+
+	collect(found, outEntities);
+}
+
+void EntityIndex::queryBox(const Aabb3& box, RefArray< Entity >& outEntities)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	refresh();
+
+	if (m_root < 0)
+		return;
+
+	AlignedVector< std::pair< uint32_t, Entity* > > found;
+	StaticVector< int32_t, c_maxStackDepth > stack;
+	stack.push_back(m_root);
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+
+		if (!overlapping(node.aabb, box))
+			continue;
+
+		if (node.height == 0)
+		{
+			if (overlapping(node.bounds, box))
+				found.push_back({ node.serial, node.entity });
+		}
+		else
+		{
+			stack.push_back(node.child[0]);
+			stack.push_back(node.child[1]);
+		}
+	}
+
+	collect(found, outEntities);
+}
+
+void EntityIndex::queryFrustum(const Frustum& frustum, RefArray< Entity >& outEntities)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	refresh();
+
+	if (m_root < 0)
+		return;
+
+	AlignedVector< std::pair< uint32_t, Entity* > > found;
+	StaticVector< std::pair< int32_t, bool >, c_maxStackDepth > stack;
+	stack.push_back({ m_root, false });
+	while (!stack.empty())
+	{
+		const auto [index, inside] = stack.back();
+		const Node& node = m_nodes[index];
+		stack.pop_back();
+
+		// Once a node is entirely inside frustum then so are all it's children.
+		bool nodeInside = inside;
+		if (!nodeInside)
+		{
+			const Frustum::Result result = frustum.inside(node.aabb);
+			if (result == Frustum::Result::Outside)
+				continue;
+			nodeInside = (result == Frustum::Result::Inside);
+		}
+
+		if (node.height == 0)
+		{
+			if (nodeInside || frustum.inside(node.bounds) != Frustum::Result::Outside)
+				found.push_back({ node.serial, node.entity });
+		}
+		else
+		{
+			stack.push_back({ node.child[0], nodeInside });
+			stack.push_back({ node.child[1], nodeInside });
+		}
+	}
+
+	collect(found, outEntities);
+}
+
+void EntityIndex::queryRay(const Vector4& origin, const Vector4& direction, float maxDistance, RefArray< Entity >& outEntities)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	refresh();
+
+	if (m_root < 0)
+		return;
+
+	const Vector4 p = origin.xyz1();
+	const Vector4 d = direction.xyz0();
+	const Scalar limit(maxDistance);
+
+	// Distance is scaled by ray direction length, same as Aabb3::intersectRay.
+	AlignedVector< std::pair< float, Entity* > > found;
+	StaticVector< int32_t, c_maxStackDepth > stack;
+	stack.push_back(m_root);
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+
+		Scalar enter, exit;
+		if (!node.aabb.intersectRay(p, d, enter, exit) || exit < 0.0_simd || enter > limit)
+			continue;
+
+		if (node.height == 0)
+		{
+			if (node.bounds.intersectRay(p, d, enter, exit) && exit >= 0.0_simd && enter <= limit)
+				found.push_back({ std::max< float >(enter, 0.0f), node.entity });
+		}
+		else
+		{
+			stack.push_back(node.child[0]);
+			stack.push_back(node.child[1]);
+		}
+	}
+
+	std::stable_sort(found.begin(), found.end(), [](const auto& lh, const auto& rh) {
+		return lh.first < rh.first;
+	});
+
+	outEntities.reserve(outEntities.size() + found.size());
+	for (const auto& f : found)
+		outEntities.push_back(f.second);
+}
+
+int32_t EntityIndex::getHeight()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	refresh();
+	return m_root >= 0 ? m_nodes[m_root].height : 0;
+}
+
+void EntityIndex::refresh()
+{
+	for (auto entity : m_invalid)
+	{
+		Atomic::exchange(entity->m_indexInvalid, 0U);
+		entity->m_indexInvalidSlot = -1;
+
+		const int32_t leaf = entity->m_indexProxy;
+		Node& node = m_nodes[leaf];
+		node.bounds = calculateBounds(entity);
+		if (enclose(node.aabb, node.bounds))
+			continue;
+
+		removeLeaf(leaf);
+		m_nodes[leaf].aabb = m_nodes[leaf].bounds.expand(c_margin);
+		insertLeaf(leaf);
+	}
+	m_invalid.resize(0);
+}
+
+int32_t EntityIndex::allocateNode()
+{
+	int32_t index;
+	if (m_freeList >= 0)
+	{
+		index = m_freeList;
+		m_freeList = m_nodes[index].parent;
+		m_nodes[index] = Node();
+	}
+	else
+	{
+		index = (int32_t)m_nodes.size();
+		m_nodes.push_back(Node());
+	}
+	return index;
+}
+
+void EntityIndex::freeNode(int32_t index)
+{
+	Node& node = m_nodes[index];
+	node.entity = nullptr;
+	node.parent = m_freeList;
+	node.height = -1;
+	m_freeList = index;
+}
+
+void EntityIndex::insertLeaf(int32_t leaf)
+{
+	if (m_root < 0)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = -1;
+		return;
+	}
+
+	// Find best sibling by descending into child which grow least in surface area.
+	const Aabb3 leafAabb = m_nodes[leaf].aabb;
+	int32_t index = m_root;
+	while (m_nodes[index].height > 0)
+	{
+		const Node& node = m_nodes[index];
+
+		const float area = surfaceArea(node.aabb);
+		const float combinedArea = surfaceArea(unionOf(node.aabb, leafAabb));
+
+		// Cost of creating a new parent for this node and the new leaf.
+		const float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree.
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCost[2];
+		for (int32_t i = 0; i < 2; ++i)
+		{
+			const Node& child = m_nodes[node.child[i]];
+			const float childArea = surfaceArea(unionOf(leafAabb, child.aabb));
+			childCost[i] = (child.height == 0 ? childArea : childArea - surfaceArea(child.aabb)) + inheritanceCost;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1])
+			break;
+
+		index = (childCost[0] < childCost[1]) ? node.child[0] : node.child[1];
+	}
+
+	// Create new parent of sibling and leaf.
+	const int32_t sibling = index;
+	const int32_t oldParent = m_nodes[sibling].parent;
+	const int32_t newParent = allocateNode();
+
+	Node& parent = m_nodes[newParent];
+	parent.parent = oldParent;
+	parent.aabb = unionOf(leafAabb, m_nodes[sibling].aabb);
+	parent.height = m_nodes[sibling].height + 1;
+	parent.child[0] = sibling;
+	parent.child[1] = leaf;
+
+	if (oldParent >= 0)
+	{
+		Node& op = m_nodes[oldParent];
+		op.child[op.child[0] == sibling ? 0 : 1] = newParent;
+	}
+	else
+		m_root = newParent;
+
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	// Walk back up the tree fixing heights and bounds.
+	for (index = newParent; index >= 0; index = m_nodes[index].parent)
+	{
+		index = balance(index);
+
+		Node& node = m_nodes[index];
+		const Node& child0 = m_nodes[node.child[0]];
+		const Node& child1 = m_nodes[node.child[1]];
+		node.height = 1 + std::max(child0.height, child1.height);
+		node.aabb = unionOf(child0.aabb, child1.aabb);
+	}
+}
+
+void EntityIndex::removeLeaf(int32_t leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = -1;
+		return;
+	}
+
+	const int32_t parent = m_nodes[leaf].parent;
+	const int32_t grandParent = m_nodes[parent].parent;
+	const int32_t sibling = (m_nodes[parent].child[0] == leaf) ? m_nodes[parent].child[1] : m_nodes[parent].child[0];
+
+	if (grandParent >= 0)
+	{
+		// Connect sibling to grand parent, then walk up fixing heights and bounds.
+		Node& gp = m_nodes[grandParent];
+		gp.child[gp.child[0] == parent ? 0 : 1] = sibling;
+		m_nodes[sibling].parent = grandParent;
+
+		for (int32_t index = grandParent; index >= 0; index = m_nodes[index].parent)
+		{
+			index = balance(index);
+
+			Node& node = m_nodes[index];
+			const Node& child0 = m_nodes[node.child[0]];
+			const Node& child1 = m_nodes[node.child[1]];
+			node.aabb = unionOf(child0.aabb, child1.aabb);
+			node.height = 1 + std::max(child0.height, child1.height);
+		}
+	}
+	else
+	{
+		m_root = sibling;
+		m_nodes[sibling].parent = -1;
+	}
+
+	freeNode(parent);
+}
+
+int32_t EntityIndex::balance(int32_t iA)
+{
+	Node& A = m_nodes[iA];
+	if (A.height < 2)
+		return iA;
+
+	const int32_t iB = A.child[0];
+	const int32_t iC = A.child[1];
+	Node& B = m_nodes[iB];
+	Node& C = m_nodes[iC];
+
+	const int32_t diff = C.height - B.height;
+
+	// Rotate C up.
+	if (diff > 1)
+	{
+		const int32_t iF = C.child[0];
+		const int32_t iG = C.child[1];
+		Node& F = m_nodes[iF];
+		Node& G = m_nodes[iG];
+
+		C.child[0] = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		if (C.parent >= 0)
+		{
+			Node& P = m_nodes[C.parent];
+			P.child[P.child[0] == iA ? 0 : 1] = iC;
+		}
+		else
+			m_root = iC;
+
+		if (F.height > G.height)
+		{
+			C.child[1] = iF;
+			A.child[1] = iG;
+			G.parent = iA;
+			A.aabb = unionOf(B.aabb, G.aabb);
+			C.aabb = unionOf(A.aabb, F.aabb);
+			A.height = 1 + std::max(B.height, G.height);
+			C.height = 1 + std::max(A.height, F.height);
+		}
+		else
+		{
+			C.child[1] = iG;
+			A.child[1] = iF;
+			F.parent = iA;
+			A.aabb = unionOf(B.aabb, F.aabb);
+			C.aabb = unionOf(A.aabb, G.aabb);
+			A.height = 1 + std::max(B.height, F.height);
+			C.height = 1 + std::max(A.height, G.height);
+		}
+		return iC;
+	}
+
+	// Rotate B up.
+	if (diff < -1)
+	{
+		const int32_t iD = B.child[0];
+		const int32_t iE = B.child[1];
+		Node& D = m_nodes[iD];
+		Node& E = m_nodes[iE];
+
+		B.child[0] = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		if (B.parent >= 0)
+		{
+			Node& P = m_nodes[B.parent];
+			P.child[P.child[0] == iA ? 0 : 1] = iB;
+		}
+		else
+			m_root = iB;
+
+		if (D.height > E.height)
+		{
+			B.child[1] = iD;
+			A.child[0] = iE;
+			E.parent = iA;
+			A.aabb = unionOf(C.aabb, E.aabb);
+			B.aabb = unionOf(A.aabb, D.aabb);
+			A.height = 1 + std::max(C.height, E.height);
+			B.height = 1 + std::max(A.height, D.height);
+		}
+		else
+		{
+			B.child[1] = iE;
+			A.child[0] = iD;
+			D.parent = iA;
+			A.aabb = unionOf(C.aabb, D.aabb);
+			B.aabb = unionOf(A.aabb, E.aabb);
+			A.height = 1 + std::max(C.height, D.height);
+			B.height = 1 + std::max(A.height, E.height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+void EntityIndex::eraseFromBucket(AlignedVector< Entity* >& bucket, const Entity* entity) const
+{
+	// Entities are appended in order they are added thus bucket is sorted by serial.
+	const uint32_t serial = m_nodes[entity->m_indexProxy].serial;
+	auto it = std::lower_bound(bucket.begin(), bucket.end(), serial, [&](const Entity* lh, uint32_t rh) {
+		return m_nodes[lh->m_indexProxy].serial < rh;
+	});
+	T_FATAL_ASSERT(it != bucket.end() && *it == entity);
+	bucket.erase(it);
+}
+
+void EntityIndex::collect(AlignedVector< std::pair< uint32_t, Entity* > >& found, RefArray< Entity >& outEntities)
+{
+	std::sort(found.begin(), found.end(), [](const auto& lh, const auto& rh) {
+		return lh.first < rh.first;
+	});
+
+	outEntities.reserve(outEntities.size() + found.size());
+	for (const auto& f : found)
+		outEntities.push_back(f.second);
+}
+
+}
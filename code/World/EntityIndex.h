@@ -0,0 +1,153 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include "Core/Guid.h"
+#include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Math/Aabb3.h"
+#include "Core/Thread/Semaphore.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_WORLD_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class Frustum;
+
+}
+
+namespace traktor::world
+{
+
+class Entity;
+
+/*! Entity lookup index.
+ * \ingroup World
+ *
+ * Entities are hashed by id and name, and their world space
+ * bounds are kept in a dynamic AABB tree. Tree leaves are
+ * enlarged by a margin so an entity only need to be reinserted
+ * when it has moved outside of it's enlarged bounds.
+ *
+ * Entities are recorded as invalid when their transform
+ * or bounds might have changed, which is safe from concurrent
+ * updates, and tree is brought up to date lazily before next
+ * spatial query; thus queries are not const.
+ *
+ * Entities without id or name are not hashed as such, thus
+ * cannot be found by null id or empty name.
+ *
+ * All queries return entities in the order they were added,
+ * except ray queries which return closest entity first.
+ */
+class T_DLLCLASS EntityIndex
+{
+public:
+	EntityIndex();
+
+	EntityIndex(const EntityIndex&) = delete;
+
+	EntityIndex& operator = (const EntityIndex&) = delete;
+
+	/*! Add entity to index. */
+	void insert(Entity* entity);
+
+	/*! Remove entity from index. */
+	void remove(Entity* entity);
+
+	/*! Remove all entities from index. */
+	void clear();
+
+	/*! Check if entity is in index. */
+	bool contains(const Entity* entity) const;
+
+	/*! Notify index that entity has moved or it's bounds changed, thread safe. */
+	void invalidate(Entity* entity);
+
+	/*! Get entity by id; first added if multiple entities share id. */
+	Entity* find(const Guid& id) const;
+
+	/*! Get entity by name, and index if multiple entities are named equally. */
+	Entity* find(const std::wstring& name, int32_t index) const;
+
+	/*! Get all entities by name. */
+	void findAll(const std::wstring& name, RefArray< Entity >& outEntities) const;
+
+	/*! Get all entities which position is within range. */
+	void queryRange(const Vector4& position, float range, RefArray< Entity >& outEntities);
+
+	/*! Get all entities which bounds overlap box. */
+	void queryBox(const Aabb3& box, RefArray< Entity >& outEntities);
+
+	/*! Get all entities which bounds are inside or intersect frustum. */
+	void queryFrustum(const Frustum& frustum, RefArray< Entity >& outEntities);
+
+	/*! Get all entities which bounds are intersected by ray. */
+	void queryRay(const Vector4& origin, const Vector4& direction, float maxDistance, RefArray< Entity >& outEntities);
+
+	/*! Number of entities in index. */
+	uint32_t size() const { return m_count; }
+
+	/*! Height of tree, mostly for diagnostics. */
+	int32_t getHeight();
+
+private:
+	struct Node
+	{
+		Aabb3 aabb;					//!< Enlarged bounds of leaf, or union of children.
+		Aabb3 bounds;				//!< Actual bounds of entity, only valid in leaves.
+		Entity* entity = nullptr;
+		uint32_t serial = 0;		//!< Order which entity was added.
+		int32_t parent = -1;		//!< Parent node, or next free node when node is free.
+		int32_t child[2] = { -1, -1 };
+		int32_t height = 0;			//!< Leaf is zero, free node is -1.
+	};
+
+	struct GuidHash
+	{
+		size_t operator () (const Guid& id) const;
+	};
+
+	mutable Semaphore m_lock;
+	AlignedVector< Node > m_nodes;
+	AlignedVector< Entity* > m_invalid;	//!< Entities moved since last refresh.
+	int32_t m_root = -1;
+	int32_t m_freeList = -1;
+	uint32_t m_count = 0;
+	uint32_t m_serial = 0;
+	std::unordered_map< Guid, AlignedVector< Entity* >, GuidHash > m_ids;
+	std::unordered_map< std::wstring, AlignedVector< Entity* > > m_names;
+
+	void refresh();
+
+	int32_t allocateNode();
+
+	void freeNode(int32_t node);
+
+	void insertLeaf(int32_t leaf);
+
+	void removeLeaf(int32_t leaf);
+
+	int32_t balance(int32_t a);
+
+	void eraseFromBucket(AlignedVector< Entity* >& bucket, const Entity* entity) const;
+
+	static void collect(AlignedVector< std::pair< uint32_t, Entity* > >& found, RefArray< Entity >& outEntities);
+};
+
+}
@@ -76,6 +76,16 @@ public:
 	 */
 	virtual bool allowConcurrentUpdate() const { return true; }
 
+	/*! Get phase in which this component is updated.
+	 *
+	 * Components which read state of other entities
+	 * should be updated in a later phase than
+	 * the components writing that state.
+	 *
+	 * \return Update phase.
+	 */
+	virtual UpdatePhase getUpdatePhase() const { return UpdatePhase::Default; }
+
 	/*! Update component
 	 * \param update Update information.
 	 */
@@ -0,0 +1,152 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Random.h"
+#include "Core/Math/Transform.h"
+#include "Core/Timer/Timer.h"
+#include "World/Entity/CullingCpu.h"
+#include "World/Test/CaseCullingCpu.h"
+
+namespace traktor::world::test
+{
+	namespace
+	{
+
+const uint32_t c_instanceCount = 100000;
+const uint32_t c_iterations = 10;
+const float c_fov = deg2rad(70.0f);
+const float c_aspect = 16.0f / 9.0f;
+const float c_nearZ = 0.1f;
+const float c_farZ = 300.0f;
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.world.test.CaseCullingCpu", 0, CaseCullingCpu, traktor::test::Case)
+
+void CaseCullingCpu::run()
+{
+	Random random;
+	AlignedVector< Aabb3 > bounds(c_instanceCount);
+	for (auto& box : bounds)
+	{
+		const Vector4 center(
+			(random.nextFloat() * 2.0f - 1.0f) * 200.0f,
+			(random.nextFloat() * 2.0f - 1.0f) * 50.0f,
+			random.nextFloat() * 450.0f - 50.0f,
+			1.0f
+		);
+		const Vector4 extent(0.5f + random.nextFloat() * 2.5f, 0.5f + random.nextFloat() * 2.5f, 0.5f + random.nextFloat() * 2.5f, 0.0f);
+		box = Aabb3(center - extent, center + extent);
+	}
+
+	const Matrix44 view = lookAt(Vector4(0.0f, 0.0f, -60.0f, 1.0f), Vector4(30.0f, 0.0f, 100.0f, 1.0f));
+	const Matrix44 projection = perspectiveLh(c_fov, c_aspect, c_nearZ, c_farZ);
+	const Matrix44 viewInverse = view.inverse();
+
+	Frustum viewFrustum;
+	viewFrustum.buildPerspective(c_fov, c_aspect, c_nearZ, c_farZ);
+
+	// Reference is same frustum in world space, testing one box at a time.
+	Frustum worldFrustum;
+	for (const auto& plane : viewFrustum.planes)
+		worldFrustum.planes.push_back(viewInverse * plane);
+
+	CullingCpu culling;
+	culling.setInstanceCount(c_instanceCount);
+	for (uint32_t i = 0; i < c_instanceCount; ++i)
+		culling.setInstanceBounds(i, bounds[i]);
+
+	AlignedVector< int32_t > visibility(c_instanceCount);
+	AlignedVector< int32_t > reference(c_instanceCount);
+
+	// Frustum only.
+	culling.beginView(view, projection);
+	const uint32_t visibleCount = culling.cull(viewFrustum, visibility.ptr());
+
+	uint32_t referenceCount = 0;
+	uint32_t frustumMismatches = 0;
+	for (uint32_t i = 0; i < c_instanceCount; ++i)
+	{
+		reference[i] = worldFrustum.inside(bounds[i]) != Frustum::Result::Outside ? 1 : 0;
+		referenceCount += reference[i];
+		if (reference[i] != visibility[i])
+			++frustumMismatches;
+	}
+	CASE_ASSERT_EQUAL(frustumMismatches, 0u);
+	CASE_ASSERT_EQUAL(visibleCount, referenceCount);
+	CASE_ASSERT_EQUAL(culling.getOccludedCount(), 0u);
+
+	// Wall in front of camera; nothing in front of wall, or outside of frustum, may become visible.
+	const float wallNearZ = 50.0f;
+	const float wallFarZ = 52.0f;
+	const Aabb3 wall(Vector4(-30.0f, -15.0f, wallNearZ, 1.0f), Vector4(30.0f, 15.0f, wallFarZ, 1.0f));
+
+	culling.beginView(view, projection);
+	culling.rasterizeOccluder(wall, Transform(viewInverse));
+	const uint32_t occludedVisibleCount = culling.cull(viewFrustum, visibility.ptr());
+	const uint32_t occludedCount = culling.getOccludedCount();
+
+	uint32_t wrongOccluded = 0;
+	for (uint32_t i = 0; i < c_instanceCount; ++i)
+	{
+		if (visibility[i] > reference[i])
+			++wrongOccluded;
+		else if (visibility[i] < reference[i])
+		{
+			// Must be entirely behind front of wall.
+			const Aabb3 viewBounds = bounds[i].transform(view);
+			if (viewBounds.mn.z() <= wallNearZ)
+				++wrongOccluded;
+		}
+	}
+	CASE_ASSERT_EQUAL(wrongOccluded, 0u);
+	CASE_ASSERT_EQUAL(occludedVisibleCount + occludedCount, referenceCount);
+	CASE_ASSERT(occludedCount > 0);
+
+	// Occluders are cleared by next view.
+	culling.beginView(view, projection);
+	CASE_ASSERT_EQUAL(culling.cull(viewFrustum, visibility.ptr()), referenceCount);
+	CASE_ASSERT_EQUAL(culling.getOccludedCount(), 0u);
+
+	// Benchmark, scalar frustum test as reference.
+	Timer timer;
+	uint32_t dummy = 0;
+	for (uint32_t j = 0; j < c_iterations; ++j)
+	{
+		for (uint32_t i = 0; i < c_instanceCount; ++i)
+			reference[i] = worldFrustum.inside(bounds[i]) != Frustum::Result::Outside ? 1 : 0;
+		dummy += reference[j];
+	}
+	const double scalarTime = timer.getElapsedTime() / c_iterations;
+
+	timer.reset();
+	for (uint32_t j = 0; j < c_iterations; ++j)
+	{
+		culling.beginView(view, projection);
+		dummy += culling.cull(viewFrustum, visibility.ptr());
+	}
+	const double simdTime = timer.getElapsedTime() / c_iterations;
+
+	timer.reset();
+	for (uint32_t j = 0; j < c_iterations; ++j)
+	{
+		culling.beginView(view, projection);
+		culling.rasterizeOccluder(wall, Transform(viewInverse));
+		dummy += culling.cull(viewFrustum, visibility.ptr());
+	}
+	const double occlusionTime = timer.getElapsedTime() / c_iterations;
+
+	log::info << L"CullingCpu, " << c_instanceCount << L" instances, " << referenceCount << L" in frustum, " << occludedCount << L" occluded (" << dummy << L")" << Endl;
+	log::info << L"  " << int32_t(scalarTime * 1e6) << L" us scalar frustum, " << int32_t(simdTime * 1e6) << L" us SIMD frustum, " << int32_t(occlusionTime * 1e6) << L" us SIMD frustum and occlusion" << Endl;
+}
+
+}
@@ -0,0 +1,353 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Random.h"
+#include "Core/Misc/String.h"
+#include "Core/Timer/Timer.h"
+#include "World/Entity.h"
+#include "World/EntityIndex.h"
+#include "World/IEntityComponent.h"
+#include "World/Test/CaseEntityIndex.h"
+
+namespace traktor::world::test
+{
+	namespace
+	{
+
+const uint32_t c_entityCount = 20000;
+const uint32_t c_nameCount = 500;
+const float c_extent = 1000.0f;
+const uint32_t c_queries = 200;
+
+class BoxComponent : public IEntityComponent
+{
+public:
+	explicit BoxComponent(const Aabb3& box)
+	:	m_box(box)
+	{
+	}
+
+	virtual void destroy() override final {}
+
+	virtual void setOwner(Entity* owner) override final {}
+
+	virtual void setTransform(const Transform& transform) override final {}
+
+	virtual Aabb3 getBoundingBox() const override final { return m_box; }
+
+	virtual void update(const UpdateParams& update) override final {}
+
+	void setBox(const Aabb3& box) { m_box = box; }
+
+private:
+	Aabb3 m_box;
+};
+
+Vector4 randomPosition(Random& random)
+{
+	return Vector4(
+		(random.nextFloat() * 2.0f - 1.0f) * c_extent,
+		random.nextFloat() * 20.0f,
+		(random.nextFloat() * 2.0f - 1.0f) * c_extent,
+		1.0f
+	);
+}
+
+Aabb3 entityBounds(const Entity* entity)
+{
+	const Transform transform = entity->getTransform();
+	Aabb3 bounds = entity->getBoundingBox().transform(transform);
+	bounds.contain(transform.translation().xyz1());
+	return bounds;
+}
+
+// Previous implementation of World queries, scanning all entities.
+RefArray< Entity > scanRange(const RefArray< Entity >& entities, const Vector4& position, float range)
+{
+	RefArray< Entity > found;
+	for (auto entity : entities)
+	{
+		const Scalar distance = (entity->getTransform().translation() - position).xyz0().length();
+		if (distance <= range)
+			found.push_back(entity);
+	}
+	return found;
+}
+
+Entity* scanName(const RefArray< Entity >& entities, const std::wstring& name, int32_t index)
+{
+	for (auto entity : entities)
+	{
+		if (entity->getName() == name)
+		{
+			if (index-- <= 0)
+				return entity;
+		}
+	}
+	return nullptr;
+}
+
+Entity* scanId(const RefArray< Entity >& entities, const Guid& id)
+{
+	for (auto entity : entities)
+		if (entity->getId() == id)
+			return entity;
+	return nullptr;
+}
+
+template < typename PredicateType >
+RefArray< Entity > scanBounds(const RefArray< Entity >& entities, PredicateType&& predicate)
+{
+	RefArray< Entity > found;
+	for (auto entity : entities)
+		if (predicate(entityBounds(entity)))
+			found.push_back(entity);
+	return found;
+}
+
+bool sameOrder(const RefArray< Entity >& a, const RefArray< Entity >& b)
+{
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const Entity* ea, const Entity* eb) { return ea == eb; });
+}
+
+bool sameSet(const RefArray< Entity >& a, const RefArray< Entity >& b)
+{
+	AlignedVector< const Entity* > sa(a.begin(), a.end());
+	AlignedVector< const Entity* > sb(b.begin(), b.end());
+	std::sort(sa.begin(), sa.end());
+	std::sort(sb.begin(), sb.end());
+	return sa.size() == sb.size() && std::equal(sa.begin(), sa.end(), sb.begin());
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.world.test.CaseEntityIndex", 0, CaseEntityIndex, traktor::test::Case)
+
+void CaseEntityIndex::run()
+{
+	Random random;
+	RefArray< Entity > entities;
+	RefArray< BoxComponent > boxes;
+	EntityIndex index;
+
+	for (uint32_t i = 0; i < c_entityCount; ++i)
+	{
+		const Vector4 halfExtent(0.5f + random.nextFloat() * 4.0f, 0.5f + random.nextFloat() * 4.0f, 0.5f + random.nextFloat() * 4.0f, 0.0f);
+
+		Ref< BoxComponent > box = new BoxComponent(Aabb3(-halfExtent, halfExtent));
+		boxes.push_back(box);
+
+		RefArray< IEntityComponent > components;
+		components.push_back(box);
+
+		Ref< Entity > entity = new Entity(
+			Guid::create(),
+			L"Entity" + toString(i % c_nameCount),
+			Transform(randomPosition(random)),
+			EntityState(),
+			components
+		);
+		entities.push_back(entity);
+		index.insert(entity);
+	}
+	CASE_ASSERT_EQUAL(index.size(), c_entityCount);
+
+	// Entities without id or name are indexed spatially but cannot be looked up.
+	for (uint32_t i = 0; i < 100; ++i)
+	{
+		Ref< Entity > entity = new Entity(Guid(), L"", Transform(randomPosition(random)), EntityState(), RefArray< IEntityComponent >());
+		entities.push_back(entity);
+		index.insert(entity);
+	}
+	CASE_ASSERT(index.find(Guid()) == nullptr);
+	CASE_ASSERT(index.find(L"", 0) == nullptr);
+
+	// Move some entities a little and some far away, as gameplay would, and
+	// change bounds of some without moving them.
+	for (uint32_t frame = 0; frame < 10; ++frame)
+	{
+		for (uint32_t i = 0; i < c_entityCount / 10; ++i)
+		{
+			const uint32_t j = random.next() % c_entityCount;
+			Entity* entity = entities[j];
+			if (random.nextFloat() < 0.2f)
+			{
+				const Vector4 halfExtent(random.nextFloat() * 40.0f, 1.0f, random.nextFloat() * 40.0f, 0.0f);
+				boxes[j]->setBox(Aabb3(-halfExtent, halfExtent));
+			}
+			else
+			{
+				const Vector4 position = (random.nextFloat() < 0.9f) ?
+					entity->getTransform().translation() + Vector4(random.nextFloat() - 0.5f, 0.0f, random.nextFloat() - 0.5f) :
+					randomPosition(random);
+				entity->setTransform(Transform(position));
+			}
+			index.invalidate(entity);
+		}
+	}
+
+	// Remove every seventh entity.
+	RefArray< Entity > remaining;
+	for (uint32_t i = 0; i < entities.size(); ++i)
+	{
+		if ((i % 7) == 0)
+			index.remove(entities[i]);
+		else
+			remaining.push_back(entities[i]);
+	}
+	entities = remaining;
+	CASE_ASSERT_EQUAL(index.size(), (uint32_t)entities.size());
+
+	// Queries must match scanning all entities; same order except for rays.
+	uint32_t rangeMismatches = 0;
+	uint32_t boxMismatches = 0;
+	uint32_t frustumMismatches = 0;
+	uint32_t rayMismatches = 0;
+	uint32_t lookupMismatches = 0;
+
+	for (uint32_t i = 0; i < c_queries; ++i)
+	{
+		const Vector4 position = randomPosition(random);
+		const float range = 5.0f + random.nextFloat() * 100.0f;
+
+		RefArray< Entity > found;
+		index.queryRange(position, range, found);
+		if (!sameOrder(found, scanRange(entities, position, range)))
+			++rangeMismatches;
+
+		const Vector4 extent(random.nextFloat() * 50.0f, 10.0f, random.nextFloat() * 50.0f, 0.0f);
+		const Aabb3 box(position - extent, position + extent);
+		found.resize(0);
+		index.queryBox(box, found);
+		if (!sameOrder(found, scanBounds(entities, [&](const Aabb3& bounds) { return compareAllLessEqual(bounds.mn.xyz0(), box.mx.xyz0()) && compareAllLessEqual(box.mn.xyz0(), bounds.mx.xyz0()); })))
+			++boxMismatches;
+
+		const Vector4 direction = Vector4(random.nextFloat() - 0.5f, (random.nextFloat() - 0.5f) * 0.01f, random.nextFloat() - 0.5f).normalized();
+		const float maxDistance = random.nextFloat() * 500.0f;
+		found.resize(0);
+		index.queryRay(position, direction, maxDistance, found);
+		const RefArray< Entity > scanned = scanBounds(entities, [&](const Aabb3& bounds) {
+			Scalar enter, exit;
+			return bounds.intersectRay(position, direction, enter, exit) && exit >= 0.0_simd && enter <= Scalar(maxDistance);
+		});
+		if (!sameSet(found, scanned))
+			++rayMismatches;
+
+		Entity* entity = entities[random.next() % entities.size()];
+		if (index.find(entity->getId()) != (entity->getId().isNotNull() ? entity : nullptr))
+			++lookupMismatches;
+
+		const std::wstring name = L"Entity" + toString(random.next() % c_nameCount);
+		const int32_t nameIndex = random.next() % 40;
+		if (index.find(name, nameIndex) != scanName(entities, name, nameIndex))
+			++lookupMismatches;
+	}
+
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		Frustum frustum;
+		frustum.buildPerspective(deg2rad(30.0f + i * 5.0f), 16.0f / 9.0f, 0.1f, 100.0f + i * 50.0f);
+
+		RefArray< Entity > found;
+		index.queryFrustum(frustum, found);
+		if (!sameOrder(found, scanBounds(entities, [&](const Aabb3& bounds) { return frustum.inside(bounds) != Frustum::Result::Outside; })))
+			++frustumMismatches;
+	}
+
+	CASE_ASSERT_EQUAL(rangeMismatches, 0u);
+	CASE_ASSERT_EQUAL(boxMismatches, 0u);
+	CASE_ASSERT_EQUAL(frustumMismatches, 0u);
+	CASE_ASSERT_EQUAL(rayMismatches, 0u);
+	CASE_ASSERT_EQUAL(lookupMismatches, 0u);
+
+	// Benchmark against scanning.
+	AlignedVector< Vector4 > positions(c_queries);
+	for (auto& position : positions)
+		position = randomPosition(random);
+
+	Timer timer;
+	uint32_t foundScan = 0;
+	for (const auto& position : positions)
+		foundScan += (uint32_t)scanRange(entities, position, 50.0f).size();
+	const double rangeScanTime = timer.getElapsedTime();
+
+	timer.reset();
+	uint32_t foundIndex = 0;
+	for (const auto& position : positions)
+	{
+		RefArray< Entity > found;
+		index.queryRange(position, 50.0f, found);
+		foundIndex += (uint32_t)found.size();
+	}
+	const double rangeIndexTime = timer.getElapsedTime();
+	CASE_ASSERT_EQUAL(foundScan, foundIndex);
+
+	AlignedVector< std::wstring > names(c_queries);
+	for (uint32_t i = 0; i < c_queries; ++i)
+		names[i] = L"Entity" + toString(random.next() % c_nameCount);
+
+	timer.reset();
+	uint32_t namesScan = 0;
+	for (const auto& name : names)
+		namesScan += scanName(entities, name, 10) != nullptr ? 1 : 0;
+	const double nameScanTime = timer.getElapsedTime();
+
+	timer.reset();
+	uint32_t namesIndex = 0;
+	for (const auto& name : names)
+		namesIndex += index.find(name, 10) != nullptr ? 1 : 0;
+	const double nameIndexTime = timer.getElapsedTime();
+	CASE_ASSERT_EQUAL(namesScan, namesIndex);
+
+	// Only entities with an id can be looked up.
+	AlignedVector< Guid > ids;
+	for (uint32_t i = 0; ids.size() < c_queries; ++i)
+	{
+		const Guid& id = entities[(i * 7919) % entities.size()]->getId();
+		if (id.isNotNull())
+			ids.push_back(id);
+	}
+
+	timer.reset();
+	uint32_t idsScan = 0;
+	for (const auto& id : ids)
+		idsScan += scanId(entities, id) != nullptr ? 1 : 0;
+	const double idScanTime = timer.getElapsedTime();
+
+	timer.reset();
+	uint32_t idsIndex = 0;
+	for (const auto& id : ids)
+		idsIndex += index.find(id) != nullptr ? 1 : 0;
+	const double idIndexTime = timer.getElapsedTime();
+	CASE_ASSERT_EQUAL(idsScan, idsIndex);
+
+	// Cost of keeping index up to date when a tenth of all entities moved.
+	for (uint32_t i = 0; i < entities.size(); i += 10)
+	{
+		Entity* entity = entities[i];
+		entity->setTransform(Transform(entity->getTransform().translation() + Vector4(0.5f, 0.0f, 0.0f)));
+		index.invalidate(entity);
+	}
+	timer.reset();
+	const int32_t height = index.getHeight();
+	const double refreshTime = timer.getElapsedTime();
+
+	log::info << L"EntityIndex, " << (uint32_t)entities.size() << L" entities, tree height " << height << Endl;
+	log::info << L"  range " << int32_t(rangeScanTime * 1e6 / c_queries) << L" us scan, " << int32_t(rangeIndexTime * 1e6 / c_queries) << L" us index" << Endl;
+	log::info << L"  name " << int32_t(nameScanTime * 1e9 / c_queries) << L" ns scan, " << int32_t(nameIndexTime * 1e9 / c_queries) << L" ns index" << Endl;
+	log::info << L"  id " << int32_t(idScanTime * 1e9 / c_queries) << L" ns scan, " << int32_t(idIndexTime * 1e9 / c_queries) << L" ns index" << Endl;
+	log::info << L"  refresh " << int32_t(refreshTime * 1e6) << L" us after " << (uint32_t)(entities.size() / 10) << L" entities moved" << Endl;
+
+	index.clear();
+}
+
+}
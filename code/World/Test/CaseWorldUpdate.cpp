@@ -0,0 +1,318 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2026 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <limits>
+#include "Core/Thread/Atomic.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Render/IRenderSystem.h"
+#include "Render/IRenderView.h"
+#include "Render/IRenderTargetSet.h"
+#include "Render/IVertexLayout.h"
+#include "Render/IAccelerationStructure.h"
+#include "Render/IProgram.h"
+#include "Render/IRenderPlugin.h"
+#include "Render/Buffer.h"
+#include "Resource/IResourceManager.h"
+#include "Resource/ResourceHandle.h"
+#include "World/Entity.h"
+#include "World/IEntityComponent.h"
+#include "World/World.h"
+#include "World/Test/CaseWorldUpdate.h"
+
+namespace traktor::world::test
+{
+	namespace
+	{
+
+const uint32_t c_entityCount = 1000;
+
+/*! Render system without device, world only ask for ray tracing support. */
+class NullRenderSystem : public render::IRenderSystem
+{
+public:
+	virtual bool create(const render::RenderSystemDesc& desc) override final { return true; }
+
+	virtual void destroy() override final {}
+
+	virtual bool reset(const render::RenderSystemDesc& desc) override final { return true; }
+
+	virtual void getInformation(render::RenderSystemInformation& outInfo) const override final {}
+
+	virtual bool supportRayTracing() const override final { return false; }
+
+	virtual uint32_t getDisplayCount() const override final { return 0; }
+
+	virtual uint32_t getDisplayModeCount(uint32_t display) const override final { return 0; }
+
+	virtual render::DisplayMode getDisplayMode(uint32_t display, uint32_t index) const override final { return render::DisplayMode(); }
+
+	virtual render::DisplayMode getCurrentDisplayMode(uint32_t display) const override final { return render::DisplayMode(); }
+
+	virtual float getDisplayAspectRatio(uint32_t display) const override final { return 0.0f; }
+
+	virtual Ref< render::IRenderView > createRenderView(const render::RenderViewDefaultDesc& desc) override final { return nullptr; }
+
+	virtual Ref< render::IRenderView > createRenderView(const render::RenderViewEmbeddedDesc& desc) override final { return nullptr; }
+
+	virtual Ref< render::Buffer > createBuffer(uint32_t usage, uint32_t bufferSize, bool dynamic, const wchar_t* const tag) override final { return nullptr; }
+
+	virtual Ref< const render::IVertexLayout > createVertexLayout(const AlignedVector< render::VertexElement >& vertexElements) override final { return nullptr; }
+
+	virtual Ref< render::ITexture > createSimpleTexture(const render::SimpleTextureCreateDesc& desc, const wchar_t* const tag) override final { return nullptr; }
+
+	virtual Ref< render::ITexture > createCubeTexture(const render::CubeTextureCreateDesc& desc, const wchar_t* const tag) override final { return nullptr; }
+
+	virtual Ref< render::ITexture > createVolumeTexture(const render::VolumeTextureCreateDesc& desc, const wchar_t* const tag) override final { return nullptr; }
+
+	virtual Ref< render::IRenderTargetSet > createRenderTargetSet(const render::RenderTargetSetCreateDesc& desc, render::IRenderTargetSet* sharedDepthStencil, const wchar_t* const tag) override final { return nullptr; }
+
+	virtual Ref< render::IAccelerationStructure > createTopLevelAccelerationStructure(uint32_t numInstances) override final { return nullptr; }
+
+	virtual Ref< render::IAccelerationStructure > createAccelerationStructure(const render::Buffer* vertexBuffer, const render::IVertexLayout* vertexLayout, const render::Buffer* indexBuffer, render::IndexType indexType, const AlignedVector< render::RaytracingPrimitives >& primitives, bool dynamic) override final { return nullptr; }
+
+	virtual Ref< render::IProgram > createProgram(const render::ProgramResource* programResource, const wchar_t* const tag) override final { return nullptr; }
+
+	virtual void purge() override final {}
+
+	virtual void getStatistics(render::RenderSystemStatistics& outStatistics) const override final {}
+
+	virtual void* getInternalHandle() const override final { return nullptr; }
+
+	virtual Ref< render::IRenderPlugin > createPlugin(const TypeInfo& pluginType) override final { return nullptr; }
+};
+
+/*! Resource manager without any resources. */
+class NullResourceManager : public resource::IResourceManager
+{
+public:
+	virtual void destroy() override final {}
+
+	virtual void addFactory(const resource::IResourceFactory* factory) override final {}
+
+	virtual void removeFactory(const resource::IResourceFactory* factory) override final {}
+
+	virtual void removeAllFactories() override final {}
+
+	virtual bool load(const resource::ResourceBundle* bundle) override final { return false; }
+
+	virtual Ref< resource::ResourceHandle > bind(const TypeInfo& productType, const Guid& guid) override final { return nullptr; }
+
+	virtual Ref< resource::ResourceHandle > bindAsync(const TypeInfo& productType, const Guid& guid, float priority) override final { return nullptr; }
+
+	virtual void setPriority(const Guid& guid, float priority) override final {}
+
+	virtual bool reload(const Guid& guid, bool flushedOnly) override final { return false; }
+
+	virtual void reload(const TypeInfo& productType, bool flushedOnly) override final {}
+
+	virtual void unload(const TypeInfo& productType) override final {}
+
+	virtual void unloadUnusedResident() override final {}
+
+	virtual void getStatistics(resource::ResourceManagerStatistics& outStatistics) const override final {}
+};
+
+/*! Record when, and from which thread, component was updated. */
+class RecordComponent : public IEntityComponent
+{
+public:
+	explicit RecordComponent(UpdatePhase phase, bool concurrent, int32_t& sequence)
+	:	m_phase(phase)
+	,	m_concurrent(concurrent)
+	,	m_sequence(sequence)
+	{
+	}
+
+	virtual void destroy() override final {}
+
+	virtual void setOwner(Entity* owner) override final {}
+
+	virtual void setTransform(const Transform& transform) override final {}
+
+	virtual Aabb3 getBoundingBox() const override final { return Aabb3(); }
+
+	virtual bool allowConcurrentUpdate() const override final { return m_concurrent; }
+
+	virtual UpdatePhase getUpdatePhase() const override final { return m_phase; }
+
+	virtual void update(const UpdateParams& update) override final
+	{
+		updated = Atomic::increment(m_sequence);
+		thread = ThreadManager::getInstance().getCurrentThread();
+		updateCount++;
+	}
+
+	int32_t updated = 0;
+	Thread* thread = nullptr;
+	int32_t updateCount = 0;
+
+private:
+	UpdatePhase m_phase;
+	bool m_concurrent;
+	int32_t& m_sequence;
+};
+
+/*! Remove and add an entity during update. */
+class SpawnComponent : public IEntityComponent
+{
+public:
+	explicit SpawnComponent(World* world, Entity* remove, Entity* add)
+	:	m_world(world)
+	,	m_remove(remove)
+	,	m_add(add)
+	{
+	}
+
+	virtual void destroy() override final {}
+
+	virtual void setOwner(Entity* owner) override final {}
+
+	virtual void setTransform(const Transform& transform) override final {}
+
+	virtual Aabb3 getBoundingBox() const override final { return Aabb3(); }
+
+	virtual bool allowConcurrentUpdate() const override final { return false; }
+
+	virtual UpdatePhase getUpdatePhase() const override final { return UpdatePhase::Early; }
+
+	virtual void update(const UpdateParams& update) override final
+	{
+		if (m_remove)
+			m_world->removeEntity(m_remove);
+		if (m_add)
+			m_world->addEntity(m_add);
+		m_remove = nullptr;
+		m_add = nullptr;
+	}
+
+private:
+	World* m_world;
+	Ref< Entity > m_remove;
+	Ref< Entity > m_add;
+};
+
+struct Span
+{
+	int32_t first = std::numeric_limits< int32_t >::max();
+	int32_t last = 0;
+};
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.world.test.CaseWorldUpdate", 0, CaseWorldUpdate, traktor::test::Case)
+
+void CaseWorldUpdate::run()
+{
+	Ref< NullResourceManager > resourceManager = new NullResourceManager();
+	Ref< NullRenderSystem > renderSystem = new NullRenderSystem();
+	Ref< World > world = new World(resourceManager, renderSystem);
+
+	// Entity added during update.
+	int32_t sequence = 0;
+	Ref< RecordComponent > added = new RecordComponent(UpdatePhase::Default, true, sequence);
+	RefArray< IEntityComponent > addedComponents;
+	addedComponents.push_back(added);
+	Ref< Entity > addedEntity = new Entity(Guid(), L"", Transform::identity(), EntityState(), addedComponents);
+
+	// Each entity has a concurrent and a serial component in each phase, last
+	// entity also removes first entity and add another in early phase.
+	RefArray< Entity > entities;
+	RefArray< RecordComponent > records[(int32_t)UpdatePhase::Last][2];
+	for (uint32_t i = 0; i < c_entityCount; ++i)
+	{
+		RefArray< IEntityComponent > components;
+		for (int32_t phase = 0; phase < (int32_t)UpdatePhase::Last; ++phase)
+		{
+			for (int32_t serial = 0; serial < 2; ++serial)
+			{
+				Ref< RecordComponent > record = new RecordComponent((UpdatePhase)phase, serial == 0, sequence);
+				records[phase][serial].push_back(record);
+				components.push_back(record);
+			}
+		}
+
+		if (i == c_entityCount - 1)
+			components.push_back(new SpawnComponent(world, entities.front(), addedEntity));
+
+		Ref< Entity > entity = new Entity(Guid(), L"", Transform::identity(), EntityState(), components);
+		entities.push_back(entity);
+		world->addEntity(entity);
+	}
+
+
+	Thread* const callingThread = ThreadManager::getInstance().getCurrentThread();
+
+	UpdateParams update;
+	world->update(update);
+
+	// Removed entity is skipped in phases after it was removed, added entity is
+	// not updated until next update.
+	CASE_ASSERT(!world->haveEntity(entities.front()));
+	CASE_ASSERT(world->haveEntity(addedEntity));
+	CASE_ASSERT_EQUAL(added->updateCount, 0);
+
+	Span spans[(int32_t)UpdatePhase::Last][2];
+	uint32_t notUpdated = 0;
+	uint32_t updatedTwice = 0;
+	uint32_t serialOnOtherThread = 0;
+	for (int32_t phase = 0; phase < (int32_t)UpdatePhase::Last; ++phase)
+	{
+		for (int32_t serial = 0; serial < 2; ++serial)
+		{
+			for (uint32_t i = 0; i < c_entityCount; ++i)
+			{
+				const RecordComponent* record = records[phase][serial][i];
+
+				// First entity is removed by last entity's serial component in early phase.
+				const bool removed = (i == 0 && phase > 0);
+				if (removed)
+				{
+					if (record->updateCount != 0)
+						++updatedTwice;
+					continue;
+				}
+
+				if (record->updateCount == 0)
+					++notUpdated;
+				else if (record->updateCount > 1)
+					++updatedTwice;
+
+				if (serial == 1 && record->thread != callingThread)
+					++serialOnOtherThread;
+
+				spans[phase][serial].first = std::min(spans[phase][serial].first, record->updated);
+				spans[phase][serial].last = std::max(spans[phase][serial].last, record->updated);
+			}
+		}
+	}
+
+	CASE_ASSERT_EQUAL(notUpdated, (uint32_t)0);
+	CASE_ASSERT_EQUAL(updatedTwice, (uint32_t)0);
+	CASE_ASSERT_EQUAL(serialOnOtherThread, (uint32_t)0);
+
+	// Within a phase concurrent components are updated before serial, and
+	// each phase is completed before next phase begin.
+	for (int32_t phase = 0; phase < (int32_t)UpdatePhase::Last; ++phase)
+	{
+		CASE_ASSERT(spans[phase][0].last < spans[phase][1].first);
+		if (phase > 0)
+			CASE_ASSERT(spans[phase - 1][1].last < spans[phase][0].first);
+	}
+
+	// Added entity is updated in next update.
+	world->update(update);
+	CASE_ASSERT_EQUAL(added->updateCount, 1);
+	CASE_ASSERT_EQUAL(records[0][0][1]->updateCount, 2);
+	CASE_ASSERT_EQUAL(records[0][0][0]->updateCount, 1);
+
+	world->destroy();
+	entities.front()->destroy();
+}
+
+}
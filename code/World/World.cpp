@@ -8,6 +8,8 @@
  */
 #include "World/World.h"
 
+#include "Core/System/OS.h"
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/Job.h"
 #include "Core/Thread/JobManager.h"
 #include "Render/IRenderSystem.h"
@@ -22,6 +24,12 @@
 
 namespace traktor::world
 {
+	namespace
+	{
+
+const uint32_t c_minEntitiesPerJob = 32;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.world.World", World, Object)
 
@@ -39,6 +47,7 @@ void World::destroy()
 	T_FATAL_ASSERT(m_deferredAdd.empty());
 	T_FATAL_ASSERT(m_deferredRemove.empty());
 
+	m_index.clear();
 	for (auto entity : m_entities)
 	{
 		entity->setWorld(nullptr);
@@ -87,9 +96,15 @@ void World::addEntity(Entity* entity)
 	if (entity->getWorld() != nullptr)
 		return;
 	if (m_update)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_deferredLock);
 		m_deferredAdd.push_back(entity);
+	}
 	else
+	{
 		m_entities.push_back(entity);
+		m_index.insert(entity);
+	}
 	entity->setWorld(this);
 }
 
@@ -98,9 +113,13 @@ void World::removeEntity(Entity* entity)
 	if (entity->getWorld() != this)
 		return;
 	if (m_update)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_deferredLock);
 		m_deferredRemove.push_back(entity);
+	}
 	else
 	{
+		m_index.remove(entity);
 		const bool removed = m_entities.remove(entity);
 		T_FATAL_ASSERT(removed);
 	}
@@ -109,46 +128,40 @@ void World::removeEntity(Entity* entity)
 
 bool World::haveEntity(const Entity* entity) const
 {
-	if (entity->getWorld() == this)
-		return std::find(m_entities.begin(), m_entities.end(), entity) != m_entities.end();
-	else
-		return false;
+	return entity->getWorld() == this && m_index.contains(entity);
 }
 
 Entity* World::getEntity(const Guid& id) const
 {
-	for (auto entity : m_entities)
-		if (entity->getId() == id)
-			return entity;
-	return nullptr;
+	return m_index.find(id);
 }
 
 Entity* World::getEntity(const std::wstring& name, int32_t index) const
 {
-	for (auto entity : m_entities)
-	{
-		if (entity->getName() == name)
-		{
-			if (index-- <= 0)
-				return entity;
-		}
-	}
-	return nullptr;
+	return m_index.find(name, index);
 }
 
 RefArray< Entity > World::getEntities(const std::wstring& name) const
 {
 	RefArray< Entity > entities;
-	for (auto entity : m_entities)
-		if (entity->getName() == name)
-			entities.push_back(entity);
+	m_index.findAll(name, entities);
 	return entities;
 }
 
 RefArray< Entity > World::getEntitiesWithinRange(const Vector4& position, float range) const
 {
 	RefArray< Entity > entities;
-	for (auto entity : m_entities)
+	m_index.queryRange(position, range, entities);
+	return entities;
+}
+
+RefArray< Entity > World::getEntitiesWithinRange(const std::wstring& name, const Vector4& position, float range) const
+{
+	RefArray< Entity > named;
+	m_index.findAll(name, named);
+
+	RefArray< Entity > entities;
+	for (auto entity : named)
 	{
 		const Scalar distance = (entity->getTransform().translation() - position).xyz0().length();
 		if (distance <= range)
@@ -157,18 +170,24 @@ RefArray< Entity > World::getEntitiesWithinRange(const Vector4& position, float
 	return entities;
 }
 
-RefArray< Entity > World::getEntitiesWithinRange(const std::wstring& name, const Vector4& position, float range) const
+RefArray< Entity > World::getEntitiesWithinBox(const Aabb3& box) const
 {
 	RefArray< Entity > entities;
-	for (auto entity : m_entities)
-	{
-		if (entity->getName() == name)
-		{
-			const Scalar distance = (entity->getTransform().translation() - position).xyz0().length();
-			if (distance <= range)
-				entities.push_back(entity);
-		}
-	}
+	m_index.queryBox(box, entities);
+	return entities;
+}
+
+RefArray< Entity > World::getEntitiesWithinFrustum(const Frustum& frustum) const
+{
+	RefArray< Entity > entities;
+	m_index.queryFrustum(frustum, entities);
+	return entities;
+}
+
+RefArray< Entity > World::getEntitiesAlongRay(const Vector4& origin, const Vector4& direction, float maxDistance) const
+{
+	RefArray< Entity > entities;
+	m_index.queryRay(origin, direction, maxDistance, entities);
 	return entities;
 }
 
@@ -181,41 +200,81 @@ void World::update(const UpdateParams& update)
 	// Update all entities.
 	m_update = true;
 
-#if defined(T_USE_UPDATE_JOBS)
-	AlignedVector< Job::task_t > jobs;
-	jobs.reserve(m_entities.size());
-
+	// Determine which entities need to be updated in each phase.
 	for (auto entity : m_entities)
 	{
-		if (entity->getWorld() != nullptr && entity->needConcurrentUpdate())
-			jobs.push_back([&, entity](){
-				entity->update(update, true);
-			});
+		uint32_t concurrent, serial;
+		entity->getUpdatePhases(concurrent, serial);
+		for (int32_t phase = 0; phase < (int32_t)UpdatePhase::Last; ++phase)
+		{
+			if ((concurrent & (1 << phase)) != 0)
+				m_phaseEntities[phase][0].push_back(entity);
+			if ((serial & (1 << phase)) != 0)
+				m_phaseEntities[phase][1].push_back(entity);
+		}
 	}
 
-	JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
-
-	for (auto entity : m_entities)
-	{
-		if (entity->getWorld() != nullptr)
-			entity->update(update, false);
-	}
+#if defined(T_USE_UPDATE_JOBS)
+	const uint32_t maxJobs = (uint32_t)std::max< int32_t >(OS::getInstance().getCPUCoreCount(), 1) * 4;
 #else
-	for (auto entity : m_entities)
+	const uint32_t maxJobs = 1;
+#endif
+	AlignedVector< Job::task_t > jobs;
+
+	// Entities removed during update, even by another entity in same phase, are skipped.
+	for (int32_t phase = 0; phase < (int32_t)UpdatePhase::Last; ++phase)
 	{
-		if (entity->getWorld() != nullptr)
+		auto& concurrentEntities = m_phaseEntities[phase][0];
+		auto& serialEntities = m_phaseEntities[phase][1];
+
+		// Update concurrent components in batches, each job updating a range of entities.
+		const uint32_t jobCount = std::min< uint32_t >((uint32_t)concurrentEntities.size() / c_minEntitiesPerJob, maxJobs);
+		if (jobCount > 1)
 		{
-			entity->update(update, true);
-			entity->update(update, false);
+			const uint32_t entityCount = (uint32_t)concurrentEntities.size();
+			const uint32_t entitiesPerJob = (entityCount + jobCount - 1) / jobCount;
+
+			jobs.resize(0);
+			for (uint32_t from = 0; from < entityCount; from += entitiesPerJob)
+			{
+				const uint32_t to = std::min< uint32_t >(from + entitiesPerJob, entityCount);
+				jobs.push_back([&, phase, from, to](){
+					for (uint32_t i = from; i < to; ++i)
+					{
+						Entity* entity = concurrentEntities[i];
+						if (entity->getWorld() != nullptr)
+							entity->update(update, (UpdatePhase)phase, true);
+					}
+				});
+			}
+			JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+		}
+		else
+		{
+			for (auto entity : concurrentEntities)
+			{
+				if (entity->getWorld() != nullptr)
+					entity->update(update, (UpdatePhase)phase, true);
+			}
+		}
+
+		for (auto entity : serialEntities)
+		{
+			if (entity->getWorld() != nullptr)
+				entity->update(update, (UpdatePhase)phase, false);
 		}
+
+		concurrentEntities.resize(0);
+		serialEntities.resize(0);
 	}
-#endif
 
 	m_update = false;
 
 	// Add entities which has been added during entity update.
 	if (!m_deferredAdd.empty())
 	{
+		for (auto entity : m_deferredAdd)
+			m_index.insert(entity);
 		m_entities.insert(m_entities.end(), m_deferredAdd.begin(), m_deferredAdd.end());
 		m_deferredAdd.resize(0);
 	}
@@ -225,6 +284,7 @@ void World::update(const UpdateParams& update)
 	{
 		for (auto entity : m_deferredRemove)
 		{
+			m_index.remove(entity);
 			const bool removed = m_entities.remove(entity);
 			T_FATAL_ASSERT(removed);
 		}
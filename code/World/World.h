@@ -11,7 +11,11 @@
 #include "Core/Guid.h"
 #include "Core/Object.h"
 #include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Vector4.h"
+#include "Core/Thread/Semaphore.h"
+#include "World/EntityIndex.h"
+#include "World/WorldTypes.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -21,6 +25,14 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class Aabb3;
+class Frustum;
+
+}
+
 namespace traktor::resource
 {
 
@@ -40,7 +52,6 @@ namespace traktor::world
 
 class Entity;
 class IWorldComponent;
-struct UpdateParams;
 
 /*! World container.
  * 
@@ -121,17 +132,38 @@ public:
 	/*! Get all named entities within distance. */
 	RefArray< Entity > getEntitiesWithinRange(const std::wstring& name, const Vector4& position, float range) const;
 
-	/*! Update all entities in this world. */
+	/*! Get all entities which bounds overlap box. */
+	RefArray< Entity > getEntitiesWithinBox(const Aabb3& box) const;
+
+	/*! Get all entities which bounds are inside or intersect frustum. */
+	RefArray< Entity > getEntitiesWithinFrustum(const Frustum& frustum) const;
+
+	/*! Get all entities which bounds are intersected by ray, closest first. */
+	RefArray< Entity > getEntitiesAlongRay(const Vector4& origin, const Vector4& direction, float maxDistance) const;
+
+	/*! Update all entities in this world.
+	 *
+	 * Entities are updated phase by phase; within a phase
+	 * components which allow concurrent update are updated
+	 * in batches on the job manager, followed by the rest
+	 * on the calling thread. Entities added or removed during
+	 * update are added or removed after all phases.
+	 */
 	void update(const UpdateParams& update);
 
 	/*! Get all entities of this world. */
 	const RefArray< Entity >& getEntities() const { return m_entities; }
 
 private:
+	friend class Entity;
+
 	RefArray< IWorldComponent > m_components;
 	RefArray< Entity > m_entities;
+	mutable EntityIndex m_index;
+	Semaphore m_deferredLock;
 	RefArray< Entity > m_deferredAdd;
 	RefArray< Entity > m_deferredRemove;
+	AlignedVector< Entity* > m_phaseEntities[(int32_t)UpdatePhase::Last][2];	//!< Entities to update per phase, concurrently and serially.
 	bool m_update = false;
 };
 
@@ -11,6 +11,7 @@
 #include "Core/Class/AutoRuntimeClass.h"
 #include "Core/Class/Boxes/BoxedAabb3.h"
 #include "Core/Class/Boxes/BoxedColor4f.h"
+#include "Core/Class/Boxes/BoxedFrustum.h"
 #include "Core/Class/Boxes/BoxedGuid.h"
 #include "Core/Class/Boxes/BoxedRefArray.h"
 #include "Core/Class/Boxes/BoxedTypeInfo.h"
@@ -197,6 +198,9 @@ void WorldClassFactory::createClasses(IRuntimeClassRegistrar* registrar) const
 	classWorld->addMethod("getEntities", &World_getEntities_2);
 	classWorld->addMethod("getEntitiesWithinRange", &World_getEntitiesWithinRange_1);
 	classWorld->addMethod("getEntitiesWithinRange", &World_getEntitiesWithinRange_2);
+	classWorld->addMethod("getEntitiesWithinBox", &World::getEntitiesWithinBox);
+	classWorld->addMethod("getEntitiesWithinFrustum", &World::getEntitiesWithinFrustum);
+	classWorld->addMethod("getEntitiesAlongRay", &World::getEntitiesAlongRay);
 	registrar->registerClass(classWorld);
 
 	auto classIEntityEventInstance = new AutoRuntimeClass< IEntityEventInstance >();
@@ -96,6 +96,19 @@ struct T_DLLCLASS EntityState
 	const static EntityState All;
 };
 
+/*! Entity component update phase.
+ *
+ * Phases are updated in order and all components of
+ * a phase have been updated before next phase begin.
+ */
+enum class UpdatePhase
+{
+	Early = 0,	 /*!< Components driving others, such as input and controllers. */
+	Default = 1, /*!< Most components, such as simulation and animation. */
+	Late = 2,	 /*!< Components following others, such as attachments and cameras. */
+	Last = 3
+};
+
 /*! Update parameters. */
 struct UpdateParams
 {